@@ -0,0 +1,25 @@
+find_path(LIBURING_ROOT_DIR
+    NAMES include/liburing.h
+)
+
+find_library(LIBURING_LIBRARIES
+    NAMES uring
+    HINTS ${LIBURING_ROOT_DIR}/lib
+)
+
+find_path(LIBURING_INCLUDE_DIR
+    NAMES liburing.h
+    HINTS ${LIBURING_ROOT_DIR}/include
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LibUring DEFAULT_MSG
+    LIBURING_LIBRARIES
+    LIBURING_INCLUDE_DIR
+)
+
+mark_as_advanced(
+    LIBURING_ROOT_DIR
+    LIBURING_LIBRARIES
+    LIBURING_INCLUDE_DIR
+)
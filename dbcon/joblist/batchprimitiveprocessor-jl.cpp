@@ -1063,6 +1063,9 @@ void BatchPrimitiveProcessorJL::createBPP(ByteStream& bs) const
   if (wideColumnsWidths)
     flags |= HAS_WIDE_COLUMNS;
 
+  if (!runtimeFilters.empty() && ot == ROW_GROUP)
+    flags |= HAS_RUNTIME_FILTERS;
+
   bs << flags;
 
   if (wideColumnsWidths)
@@ -1188,6 +1191,17 @@ void BatchPrimitiveProcessorJL::createBPP(ByteStream& bs) const
   for (i = 0; i < projectCount; ++i)
     projectSteps[i]->createCommand(bs);
 
+  if (flags & HAS_RUNTIME_FILTERS)
+  {
+    bs << (uint32_t)runtimeFilters.size();
+
+    for (i = 0; i < runtimeFilters.size(); i++)
+    {
+      bs << runtimeFilters[i].first;
+      runtimeFilters[i].second->serialize(bs);
+    }
+  }
+
   // aggregate step only when output is row group
   if (ot == ROW_GROUP)
   {
@@ -1683,6 +1697,13 @@ void BatchPrimitiveProcessorJL::addAggregateStep(const rowgroup::SP_ROWAGG_PM_t&
     sendTupleJoinRowGroupData = true;
 }
 
+void BatchPrimitiveProcessorJL::addRuntimeFilter(uint32_t stepIndex,
+                                                 const std::shared_ptr<joiner::JoinBloomFilter>& filter)
+{
+  idbassert(stepIndex < projectCount);
+  runtimeFilters.push_back(make_pair(stepIndex, filter));
+}
+
 /* OR hacks */
 void BatchPrimitiveProcessorJL::setBOP(uint32_t op)
 {
@@ -212,6 +212,10 @@ class BatchPrimitiveProcessorJL
   bool nextTupleJoinerMsg(messageqcpp::ByteStream&);
   // 	void setSmallSideKeyColumn(uint32_t col);
 
+  /* Runtime join filters.  The filter applies to the key column projected by projectSteps[stepIndex]
+     and drops the rows that can't match before the other columns are projected. */
+  void addRuntimeFilter(uint32_t stepIndex, const std::shared_ptr<joiner::JoinBloomFilter>& filter);
+
   /* OR hacks */
   void setBOP(uint32_t op);  // BOP_AND or BOP_OR, default is BOP_AND
   void setForHJ(bool b);     // default is false
@@ -360,6 +364,9 @@ class BatchPrimitiveProcessorJL
   bool sendTupleJoinRowGroupData;
   uint32_t PMJoinerCount;
 
+  /* runtime join filters, indexed by project step */
+  std::vector<std::pair<uint32_t, std::shared_ptr<joiner::JoinBloomFilter> > > runtimeFilters;
+
   /* OR hack */
   uint8_t bop;  // BOP_AND or BOP_OR
   bool forHJ;   // indicate if feeding a hashjoin, doJoin does not cover smallside
@@ -157,6 +157,7 @@ ColumnCommandJL::ColumnCommandJL(const ColumnCommandJL& prevCmd, const DictStepJ
     filterCount = dictWithFilters.getFilterCount();
     BOP = dictWithFilters.getBop();
     fContainsRanges = true;
+    fFilterHashes = dictWithFilters.filterHashes();
   }
   else
   {
@@ -70,6 +70,12 @@ class ColumnCommandJL : public CommandJL
   {
     return filterCount;
   }
+  // For a token column filtered by its dictionary's strings, the
+  // ExtentBloom::hash() of each filter's string; empty otherwise
+  const std::vector<uint64_t>& getFilterHashes() const
+  {
+    return fFilterHashes;
+  }
   const std::vector<struct BRM::EMEntry>& getExtents()
   {
     return extents;
@@ -129,6 +135,7 @@ class ColumnCommandJL : public CommandJL
 
   bool fIsDict;
   bool fContainsRanges = false;
+  std::vector<uint64_t> fFilterHashes;
 
   // @Bug 2889.  Added two members below for drop partition enhancement.
   // RJD: make sure that we keep enough significant digits around for partition math
@@ -0,0 +1,122 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace joblist
+{
+/** @brief Append only char buffer the GROUP_CONCAT and JSON_ARRAYAGG results are built in
+ *
+ * Numbers are formatted straight into the buffer with std::to_chars.  clear() keeps the
+ * memory, so a buffer reused for every group only allocates when a group's result is
+ * longer than all the ones before it.
+ */
+class ConcatBuffer
+{
+ public:
+  void clear()
+  {
+    fSize = 0;
+  }
+  size_t size() const
+  {
+    return fSize;
+  }
+  char* data()
+  {
+    return fBuf.get();
+  }
+
+  void append(char c)
+  {
+    reserve(1);
+    fBuf[fSize++] = c;
+  }
+  void append(const char* s, size_t len)
+  {
+    reserve(len);
+    memcpy(&fBuf[fSize], s, len);
+    fSize += len;
+  }
+  void append(const std::string& s)
+  {
+    append(s.data(), s.size());
+  }
+
+  // same text as ostream << v
+  template <typename T>
+  void appendInt(T v)
+  {
+    reserve(40);
+    fSize = std::to_chars(&fBuf[fSize], &fBuf[fCapacity], v).ptr - fBuf.get();
+  }
+
+  // same text as ostream << setprecision(precision) << v, without std::fixed
+  template <typename T>
+  void appendFloat(T v, int precision)
+  {
+    reserve(64);
+    auto res = std::to_chars(&fBuf[fSize], &fBuf[fCapacity], v, std::chars_format::general, precision);
+    fSize = res.ptr - fBuf.get();
+  }
+
+  // same text as ostream << std::quoted(s)
+  void appendQuoted(const char* s, size_t len)
+  {
+    reserve(len * 2 + 2);
+    fBuf[fSize++] = '"';
+    for (size_t i = 0; i < len; i++)
+    {
+      if (s[i] == '"' || s[i] == '\\')
+        fBuf[fSize++] = '\\';
+      fBuf[fSize++] = s[i];
+    }
+    fBuf[fSize++] = '"';
+  }
+  void appendQuoted(const std::string& s)
+  {
+    appendQuoted(s.data(), s.size());
+  }
+
+ private:
+  void reserve(size_t len)
+  {
+    if (fSize + len <= fCapacity)
+      return;
+
+    size_t newCapacity = std::max(std::max(fCapacity * 2, fSize + len), (size_t)4096);
+    std::unique_ptr<char[]> newBuf(new char[newCapacity]);
+    if (fSize)
+      memcpy(newBuf.get(), fBuf.get(), fSize);
+    fBuf.swap(newBuf);
+    fCapacity = newCapacity;
+  }
+
+  std::unique_ptr<char[]> fBuf;
+  size_t fSize = 0;
+  size_t fCapacity = 0;
+};
+
+}  // namespace joblist
@@ -30,6 +30,7 @@
 
 #include "bpp-jl.h"
 #include "string_prefixes.h"
+#include "extentbloom.h"
 
 using namespace std;
 using namespace messageqcpp;
@@ -182,4 +183,38 @@ messageqcpp::ByteStream DictStepJL::reencodedFilterString() const
   return bs;
 }
 
+vector<uint64_t> DictStepJL::filterHashes() const
+{
+  vector<uint64_t> hashes(filterCount, 0);
+  datatypes::Charset cset(charsetNumber);
+
+  if (hasEqFilter)
+  {
+    if (eqOp == COMPARE_EQ)
+    {
+      for (uint32_t i = 0; i < filterCount; i++)
+        hashes[i] = BRM::ExtentBloom::hash(&cset.getCharset(), eqFilter[i].c_str(), eqFilter[i].size());
+    }
+  }
+  else
+  {
+    messageqcpp::ByteStream filterStringCopy(filterString);
+
+    for (uint32_t i = 0; i < filterCount; i++)
+    {
+      uint8_t cop;
+      uint16_t size;
+      filterStringCopy >> cop;
+      filterStringCopy >> size;
+
+      if (cop == COMPARE_EQ)
+        hashes[i] = BRM::ExtentBloom::hash(&cset.getCharset(), filterStringCopy.buf(), size);
+
+      filterStringCopy.advance(size);
+    }
+  }
+
+  return hashes;
+}
+
 };  // namespace joblist
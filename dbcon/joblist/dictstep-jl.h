@@ -71,6 +71,10 @@ class DictStepJL : public CommandJL
   }
   messageqcpp::ByteStream reencodedFilterString() const;
 
+  // ExtentBloom::hash() of the value of each filter in reencodedFilterString(),
+  // 0 for the ones that aren't COMPARE_EQ
+  std::vector<uint64_t> filterHashes() const;
+
   uint8_t getBop() const
   {
     return BOP;
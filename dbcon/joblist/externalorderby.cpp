@@ -0,0 +1,708 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <boost/filesystem.hpp>
+using namespace std;
+
+#include "configcpp.h"
+#include "idbcompress.h"
+
+#include "errorids.h"
+#include "exceptclasses.h"
+using namespace logging;
+
+#include "bytestream.h"
+using namespace messageqcpp;
+
+#include "rowgroup.h"
+using namespace rowgroup;
+
+#include "jlf_common.h"
+#include "resourcemanager.h"
+#include "externalorderby.h"
+
+using namespace ordering;
+
+namespace
+{
+string errorString(int errNo)
+{
+  char tmp[1024];
+  auto* buf = strerror_r(errNo, tmp, sizeof(tmp));
+  return {buf};
+}
+
+void throwIOError(const string& what)
+{
+  throw IDBExcept(IDBErrorInfo::instance()->errorMsg(ERR_DISKORDERBY_FILEIO_ERROR, what),
+                  ERR_DISKORDERBY_FILEIO_ERROR);
+}
+
+void throwIOError(int errNo)
+{
+  throwIOError(errorString(errNo));
+}
+
+void throwOutOfMemory()
+{
+  const string msg = IDBErrorInfo::instance()->errorMsg(ERR_ORDERBY_OUT_OF_MEMORY);
+  cerr << msg << " @" << __FILE__ << ":" << __LINE__;
+  throw IDBExcept(msg, ERR_ORDERBY_OUT_OF_MEMORY);
+}
+
+void writeAll(int fd, const char* buf, size_t sz)
+{
+  while (sz > 0)
+  {
+    ssize_t r = ::write(fd, buf, sz);
+
+    if (r < 0)
+    {
+      if (errno == EAGAIN || errno == EINTR)
+        continue;
+
+      throwIOError(errno);
+    }
+
+    buf += r;
+    sz -= r;
+  }
+}
+
+// Returns false if the file ends before the first byte
+bool readAll(int fd, char* buf, size_t sz)
+{
+  size_t done = 0;
+
+  while (done < sz)
+  {
+    ssize_t r = ::read(fd, buf + done, sz - done);
+
+    if (r < 0)
+    {
+      if (errno == EAGAIN || errno == EINTR)
+        continue;
+
+      throwIOError(errno);
+    }
+
+    if (r == 0)
+    {
+      if (done == 0)
+        return false;
+
+      throwIOError(EIO);
+    }
+
+    done += r;
+  }
+
+  return true;
+}
+
+// A run file is a sequence of serialized RGData blocks, each one written as
+// [stored length][serialized length][bytes].  The lengths are the same
+// unless the block is compressed.
+void writeBlock(int fd, const ByteStream& bs, const compress::CompressInterface* compressor,
+                vector<char>& buf)
+{
+  uint64_t header[2] = {bs.length(), bs.length()};
+  const char* data = reinterpret_cast<const char*>(bs.buf());
+
+  if (compressor)
+  {
+    size_t len = compressor->maxCompressedSize(bs.length());
+    buf.resize(len);
+
+    if (compressor->compress(data, bs.length(), buf.data(), &len) != 0)
+      throwIOError("failed to compress a block");
+
+    header[0] = len;
+    data = buf.data();
+  }
+
+  writeAll(fd, reinterpret_cast<const char*>(header), sizeof(header));
+  writeAll(fd, data, header[0]);
+}
+
+}  // namespace
+
+namespace joblist
+{
+// A sorted run, the rows are either kept in memory or written to a file
+struct ExternalOrderBy::Run
+{
+  vector<RGData> data;
+  vector<Row::Pointer> rows;
+  string filename;
+};
+
+// The rows an input thread has collected since its last spill
+struct ExternalOrderBy::ThreadRun
+{
+  ThreadRun(const vector<IdbSortSpec>& spec, const RowGroup& rg) : compare(spec, rg), rowGroup(rg)
+  {
+    rowGroup.initRow(&row);
+  }
+
+  OrderByData compare;
+  RowGroup rowGroup;
+  Row row;
+  vector<RGData> data;
+  vector<Row::Pointer> rows;
+  uint64_t memUsage = 0;
+};
+
+// Returns the rows of a run in order, reading a file run one block at a time
+class ExternalOrderBy::RunReader
+{
+ public:
+  RunReader(ExternalOrderBy* owner, const Run* run) : fOwner(owner), fRun(run), fRowGroup(owner->fRowGroup)
+  {
+    fRowGroup.initRow(&fRow);
+
+    if (fRun->filename.empty())
+    {
+      fRowCount = fRun->rows.size();
+      fAtEnd = (fRowCount == 0);
+
+      if (!fAtEnd)
+        fCurrent = fRun->rows[0];
+
+      return;
+    }
+
+    fFd = open(fRun->filename.c_str(), O_RDONLY);
+
+    if (fFd < 0)
+      throwIOError(errno);
+
+    fAtEnd = !loadBlock();
+  }
+
+  ~RunReader()
+  {
+    if (fFd >= 0)
+      close(fFd);
+
+    fOwner->returnMemory(fMemUsage);
+  }
+
+  bool atEnd() const
+  {
+    return fAtEnd;
+  }
+  const Row::Pointer& current() const
+  {
+    return fCurrent;
+  }
+
+  void next()
+  {
+    if (++fRowIdx < fRowCount)
+    {
+      if (fFd < 0)
+      {
+        fCurrent = fRun->rows[fRowIdx];
+      }
+      else
+      {
+        fRow.nextRow();
+        fCurrent = fRow.getPointer();
+      }
+    }
+    else
+    {
+      fAtEnd = (fFd < 0) || !loadBlock();
+    }
+  }
+
+ private:
+  bool loadBlock()
+  {
+    uint64_t header[2];
+
+    do
+    {
+      if (!readAll(fFd, reinterpret_cast<char*>(header), sizeof(header)))
+        return false;
+
+      // the ByteStream and the RGData deserialized from it
+      int64_t memSize = header[1] * 2;
+
+      if (memSize > fMemUsage)
+      {
+        if (!fOwner->getMemory(memSize - fMemUsage, true))
+          throwOutOfMemory();
+
+        fMemUsage = memSize;
+      }
+
+      fBs.restart();
+      fBs.needAtLeast(header[1]);
+
+      if (fOwner->fCompressor)
+      {
+        fBuf.resize(header[0]);
+        size_t len = header[1];
+        char* out = reinterpret_cast<char*>(fBs.getInputPtr());
+
+        if (!readAll(fFd, fBuf.data(), header[0]) ||
+            fOwner->fCompressor->uncompress(fBuf.data(), header[0], out, &len) != 0 || len != header[1])
+          throwIOError(EIO);
+      }
+      else if (!readAll(fFd, reinterpret_cast<char*>(fBs.getInputPtr()), header[1]))
+      {
+        throwIOError(EIO);
+      }
+
+      fBs.advanceInputPtr(header[1]);
+      fBlock.deserialize(fBs);
+      fRowGroup.setData(&fBlock);
+      fRowCount = fRowGroup.getRowCount();
+    } while (fRowCount == 0);
+
+    fRowIdx = 0;
+    fRowGroup.getRow(0, &fRow);
+    fCurrent = fRow.getPointer();
+    return true;
+  }
+
+  ExternalOrderBy* fOwner;
+  const Run* fRun;
+  RowGroup fRowGroup;
+  Row fRow;
+  Row::Pointer fCurrent;
+  uint64_t fRowIdx = 0;
+  uint64_t fRowCount = 0;
+  bool fAtEnd = true;
+
+  // file runs only
+  int fFd = -1;
+  RGData fBlock;
+  ByteStream fBs;
+  vector<char> fBuf;
+  int64_t fMemUsage = 0;
+};
+
+ExternalOrderBy::ExternalOrderBy() : fAllowDisk(false), fSpilledRuns(0), fRm(NULL), fMemUsage(0)
+{
+}
+
+ExternalOrderBy::~ExternalOrderBy()
+{
+  fReaders.clear();
+  fRuns.clear();
+  fThreadRuns.clear();
+
+  if (!fTmpDir.empty())
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(fTmpDir, ec);
+  }
+
+  if (fRm && fMemUsage > 0)
+    fRm->returnMemory(fMemUsage, fSessionMemLimit);
+}
+
+void ExternalOrderBy::initialize(const RowGroup& rg, const JobInfo& jobInfo, uint32_t threadCount)
+{
+  fRm = jobInfo.rm;
+  fSessionMemLimit = jobInfo.umMemLimit;
+  fRowGroup = rg;
+
+  // locate column position in the rowgroup
+  map<uint32_t, uint32_t> keyToIndexMap;
+
+  for (uint64_t i = 0; i < rg.getKeys().size(); ++i)
+  {
+    if (keyToIndexMap.find(rg.getKeys()[i]) == keyToIndexMap.end())
+      keyToIndexMap.insert(make_pair(rg.getKeys()[i], i));
+  }
+
+  fOrderByCond.clear();
+
+  for (auto i = jobInfo.orderByColVec.begin(); i != jobInfo.orderByColVec.end(); i++)
+  {
+    map<uint32_t, uint32_t>::iterator j = keyToIndexMap.find(i->first);
+    idbassert(j != keyToIndexMap.end());
+
+    fOrderByCond.push_back(IdbSortSpec(j->second, i->second));
+  }
+
+  fCompare.reset(new OrderByData(fOrderByCond, fRowGroup));
+  fKeyEncoder.reset(new SortKeyEncoder(fOrderByCond, fRowGroup));
+
+  if (!fKeyEncoder->encodable())
+    fKeyEncoder.reset();
+
+  fRowGroup.initRow(&fRowIn);
+  fRowGroup.initRow(&fRowOut);
+
+  // each thread sorts with a comparator of its own, they aren't shared
+  fThreadRuns.clear();
+
+  for (uint32_t i = 0; i < max(threadCount, 1U); i++)
+    fThreadRuns.emplace_back(new ThreadRun(fOrderByCond, fRowGroup));
+
+  if (fAllowDisk)
+  {
+    config::Config* config = config::Config::makeConfig();
+    fTmpDir = config->getTempFileDir(config::Config::TempDirPurpose::Sorts);
+    char suffix[PATH_MAX];
+    snprintf(suffix, sizeof(suffix), "/p%u-t%p/", getpid(), this);
+    fTmpDir.append(suffix);
+
+    fCompressor.reset(compress::getCompressInterfaceByName(config->getConfig("OrderBy", "Compression")));
+  }
+}
+
+bool ExternalOrderBy::getMemory(uint64_t amount, bool patience)
+{
+  if (!fRm->getMemory(amount, fSessionMemLimit, patience))
+    return false;
+
+  fMemUsage += amount;
+  return true;
+}
+
+void ExternalOrderBy::returnMemory(uint64_t amount)
+{
+  if (amount == 0)
+    return;
+
+  fRm->returnMemory(amount, fSessionMemLimit);
+  fMemUsage -= amount;
+}
+
+string ExternalOrderBy::runFilename(uint64_t run) const
+{
+  char buf[PATH_MAX];
+  snprintf(buf, sizeof(buf), "%s/run-%lu", fTmpDir.c_str(), run);
+  return buf;
+}
+
+void ExternalOrderBy::addRGData(uint32_t thread, const RGData& rgData)
+{
+  ThreadRun& tr = *fThreadRuns[thread];
+  tr.data.push_back(rgData);
+  tr.rowGroup.setData(&tr.data.back());
+  uint64_t rowCount = tr.rowGroup.getRowCount();
+
+  if (rowCount == 0)
+  {
+    tr.data.pop_back();
+    return;
+  }
+
+  uint64_t memSize = tr.rowGroup.getSizeWithStrings() + rowCount * sizeof(Row::Pointer);
+
+  // Without disk this waits for memory like the other steps do.  With it,
+  // the run collected so far goes to disk first and the wait only happens
+  // if that didn't free enough.
+  if (!getMemory(memSize, !fAllowDisk))
+  {
+    if (!fAllowDisk)
+      throwOutOfMemory();
+
+    RGData last = tr.data.back();
+    tr.data.pop_back();
+
+    if (!tr.rows.empty())
+      spill(tr);
+
+    tr.data.push_back(last);
+    tr.rowGroup.setData(&tr.data.back());
+
+    if (!getMemory(memSize, true))
+      throwOutOfMemory();
+  }
+
+  tr.memUsage += memSize;
+  tr.rowGroup.getRow(0, &tr.row);
+
+  for (uint64_t i = 0; i < rowCount; i++)
+  {
+    tr.rows.push_back(tr.row.getPointer());
+    tr.row.nextRow();
+  }
+}
+
+void ExternalOrderBy::sortRun(ThreadRun& tr)
+{
+  uint64_t rowCount = tr.rows.size();
+
+  // With normalized keys the sort compares them with memcmp() instead of
+  // going through the Compare objects of every column.  The keys are only
+  // needed during the sort, without memory for them the rows are compared.
+  if (fKeyEncoder && rowCount > 1 && rowCount <= UINT32_MAX)
+  {
+    const uint32_t keyLength = fKeyEncoder->keyLength();
+    uint64_t memSize = rowCount * (keyLength + sizeof(uint32_t) + sizeof(Row::Pointer));
+
+    if (getMemory(memSize, false))
+    {
+      vector<uint8_t> keys(rowCount * keyLength);
+      vector<uint32_t> order(rowCount);
+
+      for (uint64_t i = 0; i < rowCount; i++)
+      {
+        tr.row.setPointer(tr.rows[i]);
+        fKeyEncoder->encode(tr.row, &keys[i * keyLength]);
+        order[i] = i;
+      }
+
+      const uint8_t* k = keys.data();
+      std::sort(order.begin(), order.end(), [k, keyLength](uint32_t a, uint32_t b)
+                { return memcmp(k + (uint64_t)a * keyLength, k + (uint64_t)b * keyLength, keyLength) < 0; });
+
+      vector<Row::Pointer> sorted(rowCount);
+
+      for (uint64_t i = 0; i < rowCount; i++)
+        sorted[i] = tr.rows[order[i]];
+
+      tr.rows.swap(sorted);
+      returnMemory(memSize);
+      return;
+    }
+  }
+
+  OrderByData& compare = tr.compare;
+  std::sort(tr.rows.begin(), tr.rows.end(),
+            [&compare](const Row::Pointer& a, const Row::Pointer& b) { return compare(a, b); });
+}
+
+void ExternalOrderBy::spill(ThreadRun& tr)
+{
+  sortRun(tr);
+
+  unique_ptr<Run> run(new Run);
+  {
+    boost::mutex::scoped_lock lk(fRunsLock);
+
+    if (fSpilledRuns == 0)
+    {
+      boost::system::error_code ec;
+      boost::filesystem::create_directories(fTmpDir, ec);
+
+      if (ec)
+        throwIOError(ec.value());
+    }
+
+    run->filename = runFilename(fSpilledRuns++);
+  }
+
+  int fd = open(run->filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  if (fd < 0)
+    throwIOError(errno);
+
+  try
+  {
+    RowGroup out(fRowGroup);
+    RGData block(out, rgCommonSize);
+    Row in, outRow;
+    out.initRow(&in);
+    out.initRow(&outRow);
+    ByteStream bs;
+    vector<char> buf;
+
+    for (size_t i = 0; i < tr.rows.size();)
+    {
+      block.reinit(out, rgCommonSize);
+      out.setData(&block);
+      out.resetRowGroup(0);
+      out.getRow(0, &outRow);
+
+      for (; i < tr.rows.size() && out.getRowCount() < rgCommonSize; i++)
+      {
+        in.setPointer(tr.rows[i]);
+        copyRow(in, &outRow);
+        out.incRowCount();
+        outRow.nextRow();
+      }
+
+      bs.restart();
+      out.serializeRGData(bs);
+      writeBlock(fd, bs, fCompressor.get(), buf);
+    }
+  }
+  catch (...)
+  {
+    close(fd);
+    throw;
+  }
+
+  close(fd);
+
+  vector<RGData>().swap(tr.data);
+  vector<Row::Pointer>().swap(tr.rows);
+  returnMemory(tr.memUsage);
+  tr.memUsage = 0;
+
+  boost::mutex::scoped_lock lk(fRunsLock);
+  fRuns.push_back(std::move(run));
+}
+
+void ExternalOrderBy::endOfInput(uint32_t thread)
+{
+  ThreadRun& tr = *fThreadRuns[thread];
+
+  if (tr.rows.empty())
+    return;
+
+  // Once memory has run out, the merge needs what is left for the blocks it
+  // reads back, so the last run goes to disk as well.
+  bool spilled;
+  {
+    boost::mutex::scoped_lock lk(fRunsLock);
+    spilled = (fSpilledRuns > 0);
+  }
+
+  if (spilled)
+  {
+    spill(tr);
+    return;
+  }
+
+  sortRun(tr);
+
+  // the memory stays charged until the ExternalOrderBy is destroyed
+  unique_ptr<Run> run(new Run);
+  run->data.swap(tr.data);
+  run->rows.swap(tr.rows);
+  tr.memUsage = 0;
+
+  boost::mutex::scoped_lock lk(fRunsLock);
+  fRuns.push_back(std::move(run));
+}
+
+bool ExternalOrderBy::beats(uint32_t a, uint32_t b)
+{
+  if (fReaders[a]->atEnd())
+    return false;
+
+  if (fReaders[b]->atEnd())
+    return true;
+
+  return (*fCompare)(fReaders[a]->current(), fReaders[b]->current());
+}
+
+// Plays the matches of the subtree under "node" and returns its winner.  The
+// leaves are the nodes from fReaders.size() on, leaf k + i being reader i.
+uint32_t ExternalOrderBy::buildTree(uint32_t node)
+{
+  uint32_t k = fReaders.size();
+
+  if (node >= k)
+    return node - k;
+
+  uint32_t a = buildTree(2 * node);
+  uint32_t b = buildTree(2 * node + 1);
+
+  if (beats(b, a))
+    std::swap(a, b);
+
+  fTree[node] = b;
+  return a;
+}
+
+// The winner has moved to its next row, replay its matches up to the root
+void ExternalOrderBy::replay(uint32_t winner)
+{
+  for (uint32_t node = (winner + fReaders.size()) / 2; node >= 1; node /= 2)
+  {
+    if (beats(fTree[node], winner))
+      std::swap(fTree[node], winner);
+  }
+
+  fTree[0] = winner;
+}
+
+void ExternalOrderBy::finalize()
+{
+  fReaders.clear();
+
+  for (auto& run : fRuns)
+    fReaders.emplace_back(new RunReader(this, run.get()));
+
+  if (fReaders.empty())
+    return;
+
+  fTree.assign(fReaders.size(), 0);
+  fTree[0] = buildTree(1);
+}
+
+bool ExternalOrderBy::getData(RGData& data)
+{
+  if (fReaders.empty() || fReaders[fTree[0]]->atEnd())
+    return false;
+
+  data.reinit(fRowGroup, rgCommonSize);
+  fRowGroup.setData(&data);
+  fRowGroup.resetRowGroup(0);
+  fRowGroup.getRow(0, &fRowOut);
+
+  while (fRowGroup.getRowCount() < rgCommonSize)
+  {
+    uint32_t winner = fTree[0];
+    RunReader& reader = *fReaders[winner];
+
+    if (reader.atEnd())
+      break;
+
+    fRowIn.setPointer(reader.current());
+    copyRow(fRowIn, &fRowOut);
+    fRowGroup.incRowCount();
+    fRowOut.nextRow();
+
+    reader.next();
+    replay(winner);
+  }
+
+  return true;
+}
+
+const string ExternalOrderBy::toString() const
+{
+  ostringstream oss;
+  oss << "ExternalOrderBy   cols: ";
+  vector<IdbSortSpec>::const_iterator i = fOrderByCond.begin();
+
+  for (; i != fOrderByCond.end(); i++)
+    oss << "(" << i->fIndex << "," << ((i->fAsc) ? "Asc" : "Desc") << ","
+        << ((i->fNf) ? "null first" : "null last") << ") ";
+
+  oss << " runs: " << fRuns.size() << " spilled: " << fSpilledRuns;
+
+  oss << endl;
+
+  return oss.str();
+}
+
+}  // namespace joblist
@@ -0,0 +1,123 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "rowgroup.h"
+#include "../../utils/windowfunction/idborderby.h"
+
+namespace compress
+{
+class CompressInterface;
+}
+
+namespace joblist
+{
+// forward reference
+struct JobInfo;
+class ResourceManager;
+
+// ORDER BY without LIMIT class
+// Every row is returned, so instead of keeping the top rows in a priority
+// queue like LimitedOrderBy, each input thread collects the RGData it reads
+// into a run of its own and sorts it.  When the ResourceManager has no memory
+// left for a run and disk-based ORDER BY is allowed, the run is sorted and
+// written to a temporary file.  getData() merges all the runs with a loser
+// tree, so the output is streamed instead of being built in memory.
+class ExternalOrderBy
+{
+ public:
+  ExternalOrderBy();
+  ~ExternalOrderBy();
+
+  void initialize(const rowgroup::RowGroup&, const JobInfo&, uint32_t threadCount = 1);
+
+  // allow sorted runs to be written to disk when there is no memory for them
+  void allowDisk(bool b)
+  {
+    fAllowDisk = b;
+  }
+
+  // Called by input thread "thread" (0 based) with each RGData it reads.
+  // The rows aren't copied, the run keeps a reference to the RGData.
+  void addRGData(uint32_t thread, const rowgroup::RGData& rgData);
+
+  // Sorts the rows "thread" still holds in memory, call it once its input is done
+  void endOfInput(uint32_t thread);
+
+  // Starts the merge.  Call it when endOfInput() has been called for every thread.
+  void finalize();
+
+  // The next RGData of sorted rows, in the input RowGroup layout
+  bool getData(rowgroup::RGData& data);
+
+  uint64_t getSpilledRunCount() const
+  {
+    return fSpilledRuns;
+  }
+  const std::string toString() const;
+
+ private:
+  struct Run;
+  struct ThreadRun;
+  class RunReader;
+
+  void spill(ThreadRun& tr);
+  void sortRun(ThreadRun& tr);
+  bool getMemory(uint64_t amount, bool patience);
+  void returnMemory(uint64_t amount);
+  std::string runFilename(uint64_t run) const;
+
+  // loser tree over fReaders
+  bool beats(uint32_t a, uint32_t b);
+  uint32_t buildTree(uint32_t node);
+  void replay(uint32_t winner);
+
+  rowgroup::RowGroup fRowGroup;
+  std::vector<ordering::IdbSortSpec> fOrderByCond;
+  bool fAllowDisk;
+
+  std::vector<std::unique_ptr<ThreadRun>> fThreadRuns;
+  std::vector<std::unique_ptr<Run>> fRuns;
+  boost::mutex fRunsLock;
+  uint64_t fSpilledRuns;
+
+  std::unique_ptr<ordering::OrderByData> fCompare;  // used by the merge
+  std::unique_ptr<ordering::SortKeyEncoder> fKeyEncoder;  // NULL if the keys can't be encoded
+  std::vector<std::unique_ptr<RunReader>> fReaders;
+  std::vector<uint32_t> fTree;  // fTree[0] is the winner, the inner nodes keep the losers
+  rowgroup::Row fRowIn;
+  rowgroup::Row fRowOut;
+
+  std::string fTmpDir;
+  std::unique_ptr<compress::CompressInterface> fCompressor;
+
+  ResourceManager* fRm;
+  boost::shared_ptr<int64_t> fSessionMemLimit;
+  std::atomic<int64_t> fMemUsage;  // memory taken from the ResourceManager, all threads
+};
+
+}  // namespace joblist
@@ -427,7 +427,7 @@ void GroupConcator::initialize(const rowgroup::SP_GroupConcat& gcc)
     fConstantLen += strlen(fConstCols[i].first.str());
 }
 
-void GroupConcator::outputRow(std::ostringstream& oss, const rowgroup::Row& row)
+void GroupConcator::outputRow(ConcatBuffer& buf, const rowgroup::Row& row)
 {
   const CalpontSystemCatalog::ColDataType* types = row.getColTypes();
   vector<uint32_t>::iterator i = fConcatColumns.begin();
@@ -439,7 +439,10 @@ void GroupConcator::outputRow(std::ostringstream& oss, const rowgroup::Row& row)
   {
     if (j != fConstCols.end() && k == j->second)
     {
-      oss << j->first.safeString();
+      if (j->first.isNull())
+        buf.append(j->first.safeString());
+      else
+        buf.append(j->first.unsafeStringRef());
       j++;
       continue;
     }
@@ -452,17 +455,14 @@ void GroupConcator::outputRow(std::ostringstream& oss, const rowgroup::Row& row)
       case CalpontSystemCatalog::INT:
       case CalpontSystemCatalog::BIGINT:
       {
-        int64_t intVal = row.getIntField(*i);
-
-        oss << intVal;
-
+        buf.appendInt(row.getIntField(*i));
         break;
       }
 
       case CalpontSystemCatalog::DECIMAL:
       case CalpontSystemCatalog::UDECIMAL:
       {
-        oss << fixed << row.getDecimalField(*i);
+        buf.append(row.getDecimalField(*i).toString());
         break;
       }
 
@@ -477,13 +477,13 @@ void GroupConcator::outputRow(std::ostringstream& oss, const rowgroup::Row& row)
 
         if (scale == 0)
         {
-          oss << uintVal;
+          buf.appendInt(uintVal);
         }
         else
         {
-          oss << fixed
-              << datatypes::Decimal(datatypes::TSInt128((int128_t)uintVal), scale,
-                                    datatypes::INT128MAXPRECISION);
+          buf.append(datatypes::Decimal(datatypes::TSInt128((int128_t)uintVal), scale,
+                                        datatypes::INT128MAXPRECISION)
+                         .toString());
         }
 
         break;
@@ -493,51 +493,54 @@ void GroupConcator::outputRow(std::ostringstream& oss, const rowgroup::Row& row)
       case CalpontSystemCatalog::VARCHAR:
       case CalpontSystemCatalog::TEXT:
       {
-        oss << row.getStringField(*i).str();
+        // up to the first '\0', like the char* it used to be
+        utils::ConstString str = row.getConstString(*i);
+        if (str.str())
+          buf.append(str.str(), strnlen(str.str(), str.length()));
         break;
       }
 
       case CalpontSystemCatalog::DOUBLE:
       case CalpontSystemCatalog::UDOUBLE:
       {
-        oss << setprecision(15) << row.getDoubleField(*i);
+        buf.appendFloat(row.getDoubleField(*i), 15);
         break;
       }
 
       case CalpontSystemCatalog::LONGDOUBLE:
       {
-        oss << setprecision(15) << row.getLongDoubleField(*i);
+        buf.appendFloat(row.getLongDoubleField(*i), 15);
         break;
       }
 
       case CalpontSystemCatalog::FLOAT:
       case CalpontSystemCatalog::UFLOAT:
       {
-        oss << row.getFloatField(*i);
+        buf.appendFloat(row.getFloatField(*i), 6);
         break;
       }
 
       case CalpontSystemCatalog::DATE:
       {
-        oss << DataConvert::dateToString(row.getUintField(*i));
+        buf.append(DataConvert::dateToString(row.getUintField(*i)));
         break;
       }
 
       case CalpontSystemCatalog::DATETIME:
       {
-        oss << DataConvert::datetimeToString(row.getUintField(*i));
+        buf.append(DataConvert::datetimeToString(row.getUintField(*i)));
         break;
       }
 
       case CalpontSystemCatalog::TIMESTAMP:
       {
-        oss << DataConvert::timestampToString(row.getUintField(*i), fTimeZone);
+        buf.append(DataConvert::timestampToString(row.getUintField(*i), fTimeZone));
         break;
       }
 
       case CalpontSystemCatalog::TIME:
       {
-        oss << DataConvert::timeToString(row.getUintField(*i));
+        buf.append(DataConvert::timeToString(row.getUintField(*i)));
         break;
       }
 
@@ -885,7 +888,8 @@ void GroupConcatOrderBy::merge(GroupConcator* gc)
 
 uint8_t* GroupConcatOrderBy::getResultImpl(const string& sep)
 {
-  ostringstream oss;
+  ConcatBuffer& buf = resultBuffer();
+  buf.clear();
   bool addSep = false;
 
   // need to reverse the order
@@ -896,58 +900,50 @@ uint8_t* GroupConcatOrderBy::getResultImpl(const string& sep)
     fOrderByQueue.pop();
   }
 
-  size_t prevResultSize = 0;
-  size_t rowsProcessed = 0;
-  bool isNull = true;
-  while (rowStack.size() > 0)
+  bool isNull = rowStack.empty();
+
+  // anything past group_concat_max_len is cut off anyway
+  while (rowStack.size() > 0 && (int64_t)buf.size() <= fGroupConcatLen)
   {
     if (addSep)
-      oss << sep;
+      buf.append(sep);
     else
       addSep = true;
 
     const OrderByRow& topRow = rowStack.top();
     fRow0.setData(topRow.fData);
-    outputRow(oss, fRow0);
-    isNull = false;
+    outputRow(buf, fRow0);
     rowStack.pop();
-    if (rowsProcessed >= fRowsPerRG)
-    {
-      size_t sizeDiff = oss.str().size() - prevResultSize;
-      prevResultSize = oss.str().size();
-      if (!fRm->getMemory(sizeDiff, fSessionMemLimit))
-      {
-        cerr << IDBErrorInfo::instance()->errorMsg(fErrorCode) << " @" << __FILE__ << ":" << __LINE__;
-        throw IDBExcept(fErrorCode);
-      }
-      fMemSize += sizeDiff;
-      rowsProcessed = 0;
-    }
   }
 
-  return swapStreamWithStringAndReturnBuf(oss, isNull);
+  return finishResult(buf, isNull);
 }
 
-uint8_t* GroupConcator::swapStreamWithStringAndReturnBuf(ostringstream& oss, bool isNull)
+uint8_t* GroupConcator::finishResult(ConcatBuffer& buf, bool isNull)
 {
-  if (isNull) {
-    outputBuf_.reset();
+  if (isNull)
     return nullptr;
-  }
-  int64_t resultSize = oss.str().size();
-  oss << '\0' << '\0';
-  outputBuf_.reset(new std::string(std::move(*oss.rdbuf()).str()));
+
+  int64_t resultSize = buf.size();
+  buf.append('\0');
+  buf.append('\0');
 
   if (resultSize >= fGroupConcatLen + 1)
   {
-    (*outputBuf_)[fGroupConcatLen] = '\0';
+    buf.data()[fGroupConcatLen] = '\0';
   }
   if (resultSize >= fGroupConcatLen + 2)
   {
-    (*outputBuf_)[fGroupConcatLen + 1] = '\0';
+    buf.data()[fGroupConcatLen + 1] = '\0';
   }
 
-  return reinterpret_cast<uint8_t*>(outputBuf_->data());
+  return reinterpret_cast<uint8_t*>(buf.data());
+}
+
+ConcatBuffer& GroupConcator::resultBuffer()
+{
+  static thread_local ConcatBuffer buf;
+  return buf;
 }
 
 uint8_t* GroupConcator::getResult(const string& sep)
@@ -977,7 +973,7 @@ const string GroupConcatOrderBy::toString() const
 
 // GroupConcatNoOrder class implementation
 GroupConcatNoOrder::GroupConcatNoOrder()
- : fRowsPerRG(128), fErrorCode(ERR_AGGREGATION_TOO_BIG), fMemSize(0), fRm(NULL)
+ : fRowsPerRG(128), fCurrentRowsPerRG(4), fErrorCode(ERR_AGGREGATION_TOO_BIG), fMemSize(0), fRm(NULL)
 {
 }
 
@@ -1002,7 +998,9 @@ void GroupConcatNoOrder::initialize(const rowgroup::SP_GroupConcat& gcc)
   while (i != gcc->fGroupCols.end())
     fConcatColumns.push_back((*(i++)).second);
 
-  uint64_t newSize = fRowsPerRG * fRowGroup.getRowSize();
+  // There's one of these per group, start small and grow the RGs as rows come.
+  fCurrentRowsPerRG = 4;
+  uint64_t newSize = fCurrentRowsPerRG * fRowGroup.getRowSize();
 
   if (!fRm->getMemory(newSize, fSessionMemLimit))
   {
@@ -1012,7 +1010,7 @@ void GroupConcatNoOrder::initialize(const rowgroup::SP_GroupConcat& gcc)
 
   fMemSize += newSize;
 
-  fData.reinit(fRowGroup, fRowsPerRG);
+  fData.reinit(fRowGroup, fCurrentRowsPerRG);
   fRowGroup.setData(&fData);
   fRowGroup.resetRowGroup(0);
   fRowGroup.initRow(&fRow);
@@ -1033,7 +1031,7 @@ void GroupConcatNoOrder::processRow(const rowgroup::Row& row)
     fRowGroup.incRowCount();
     fRow.nextRow();
 
-    if (fRowGroup.getRowCount() >= fRowsPerRG)
+    if (fRowGroup.getRowCount() >= fCurrentRowsPerRG)
     {
       // A "postfix" but accurate RAM accounting that sums up sizes of RGDatas.
       uint64_t newSize = fRowGroup.getSizeWithStrings();
@@ -1046,7 +1044,8 @@ void GroupConcatNoOrder::processRow(const rowgroup::Row& row)
       fMemSize += newSize;
 
       fDataQueue.push(fData);
-      fData.reinit(fRowGroup, fRowsPerRG);
+      fCurrentRowsPerRG = std::min(fCurrentRowsPerRG * 2, fRowsPerRG);
+      fData.reinit(fRowGroup, fCurrentRowsPerRG);
       fRowGroup.setData(&fData);
       fRowGroup.resetRowGroup(0);
       fRowGroup.getRow(0, &fRow);
@@ -1071,11 +1070,11 @@ void GroupConcatNoOrder::merge(GroupConcator* gc)
 
 uint8_t* GroupConcatNoOrder::getResultImpl(const string& sep)
 {
-  ostringstream oss;
+  ConcatBuffer& buf = resultBuffer();
+  buf.clear();
   bool addSep = false;
 
   fDataQueue.push(fData);
-  size_t prevResultSize = 0;
 
   bool isNull = true;
   while (fDataQueue.size() > 0)
@@ -1083,29 +1082,22 @@ uint8_t* GroupConcatNoOrder::getResultImpl(const string& sep)
     fRowGroup.setData(&fDataQueue.front());
     fRowGroup.getRow(0, &fRow);
 
-    for (uint64_t i = 0; i < fRowGroup.getRowCount(); i++)
+    // anything past group_concat_max_len is cut off anyway
+    for (uint64_t i = 0; i < fRowGroup.getRowCount() && (int64_t)buf.size() <= fGroupConcatLen; i++)
     {
       if (addSep)
-        oss << sep;
+        buf.append(sep);
       else
         addSep = true;
 
-      outputRow(oss, fRow);
+      outputRow(buf, fRow);
       isNull = false;
       fRow.nextRow();
     }
-    size_t sizeDiff = oss.str().size() - prevResultSize;
-    prevResultSize = oss.str().size();
-    if (!fRm->getMemory(sizeDiff, fSessionMemLimit))
-    {
-      cerr << IDBErrorInfo::instance()->errorMsg(fErrorCode) << " @" << __FILE__ << ":" << __LINE__;
-      throw IDBExcept(fErrorCode);
-    }
-    fMemSize += sizeDiff;
     fDataQueue.pop();
   }
 
-  return swapStreamWithStringAndReturnBuf(oss, isNull);
+  return finishResult(buf, isNull);
 }
 
 const string GroupConcatNoOrder::toString() const
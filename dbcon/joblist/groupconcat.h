@@ -31,6 +31,7 @@
 #include "rowgroup.h"        // RowGroup
 #include "rowaggregation.h"  // SP_GroupConcat
 #include "limitedorderby.h"  // IdbOrderBy
+#include "concatbuffer.h"    // ConcatBuffer
 
 #define EXPORT
 
@@ -110,21 +111,24 @@ class GroupConcator
   virtual void merge(GroupConcator*) = 0;
   virtual uint8_t* getResultImpl(const std::string& sep) = 0;
   virtual uint8_t* getResult(const std::string& sep);
-  uint8_t* swapStreamWithStringAndReturnBuf(ostringstream& oss, bool isNull);
+  // Terminates and truncates the result built in buf, returns null for a NULL result.
+  uint8_t* finishResult(ConcatBuffer& buf, bool isNull);
 
   virtual const std::string toString() const;
 
  protected:
   virtual bool concatColIsNull(const rowgroup::Row&);
-  virtual void outputRow(std::ostringstream&, const rowgroup::Row&);
+  virtual void outputRow(ConcatBuffer&, const rowgroup::Row&);
   virtual int64_t lengthEstimate(const rowgroup::Row&);
+  // The buffer the results are built in.  It's shared by all the groups a thread finishes, so
+  // the result getResult() returns is only valid until the thread's next getResult() call.
+  static ConcatBuffer& resultBuffer();
 
   std::vector<uint32_t> fConcatColumns;
   std::vector<std::pair<utils::NullString, uint32_t> > fConstCols;
   int64_t fCurrentLength;
   int64_t fGroupConcatLen;
   int64_t fConstantLen;
-  std::unique_ptr<std::string> outputBuf_;
   long fTimeZone;
 };
 
@@ -151,6 +155,7 @@ class GroupConcatNoOrder : public GroupConcator
   rowgroup::RGData fData;
   std::queue<rowgroup::RGData> fDataQueue;
   uint64_t fRowsPerRG;
+  uint64_t fCurrentRowsPerRG;  // grows to fRowsPerRG, most groups only have a few rows
   uint64_t fErrorCode;
   uint64_t fMemSize;
   ResourceManager* fRm;
@@ -56,6 +56,7 @@ using namespace dataconvert;
 #include "elementtype.h"
 #include "jlf_common.h"
 #include "limitedorderby.h"
+#include "externalorderby.h"
 #include "jobstep.h"
 #include "primitivestep.h"
 #include "expressionstep.h"
@@ -513,7 +514,18 @@ void adjustLastStep(JobStepVector& querySteps, DeliveredTableMap& deliverySteps,
 
   if (jobInfo.orderByColVec.size() > 0)
   {
-    tas->addOrderBy(new LimitedOrderBy());
+    // Without LIMIT every row is returned, sort it in runs that can go to disk
+    if (jobInfo.limitCount == (uint64_t)-1 && jobInfo.limitStart == 0 && !jobInfo.hasDistinct)
+    {
+      ExternalOrderBy* eob = new ExternalOrderBy();
+      eob->allowDisk(jobInfo.rm->getAllowDiskOrderBy());
+      tas->addExternalOrderBy(eob);
+    }
+    else
+    {
+      tas->addOrderBy(new LimitedOrderBy());
+    }
+
     if (jobInfo.orderByThreads > 1)
       tas->setParallelOp();
     tas->setMaxThreads(jobInfo.orderByThreads);
@@ -1638,6 +1650,9 @@ class CircularJoinGraphTransformer
   virtual void initializeJoinGraph();
   // Check if the given join edge has FK - FK relations.
   bool isForeignKeyForeignKeyLink(const JoinEdge& edge, statistics::StatisticsManager* statisticsManager);
+  // Estimates the number of rows the given join edge produces from the row counts and NDV of its keys.
+  bool estimateJoinCardinality(const JoinEdge& edge, statistics::StatisticsManager* statisticsManager,
+                               double& cardinality);
   // Based on column statistics tries to search `join edge` with maximum join cardinality.
   virtual void chooseEdgeToTransform(Cycle& cycle, std::pair<JoinEdge, int64_t>& resultEdge);
   // Removes given `tableId` from adjacent list.
@@ -1824,11 +1839,82 @@ bool CircularJoinGraphTransformer::isForeignKeyForeignKeyLink(
   return false;
 }
 
+bool CircularJoinGraphTransformer::estimateJoinCardinality(const JoinEdge& edge,
+                                                           statistics::StatisticsManager* statisticsManager,
+                                                           double& cardinality)
+{
+  const auto end = jobInfo.tableJoinMap.end();
+  auto it = jobInfo.tableJoinMap.find(edge);
+  if (it == end)
+  {
+    it = jobInfo.tableJoinMap.find(make_pair(edge.second, edge.first));
+    if (it == end)
+      return false;
+  }
+
+  const auto& leftKeys = it->second.fLeftKeys;
+  const auto& rightKeys = it->second.fRightKeys;
+  if (leftKeys.size() == 0 || leftKeys.size() != rightKeys.size())
+    return false;
+
+  // |L| * |R| / max(NDV(L.key), NDV(R.key)), the most selective key pair of a multi column join.
+  double leftRows = 0, rightRows = 0, distinct = 1;
+  for (uint32_t i = 0; i < leftKeys.size(); i++)
+  {
+    const auto lOid = jobInfo.keyInfo->tupleKeyVec[leftKeys[i]].fId;
+    const auto rOid = jobInfo.keyInfo->tupleKeyVec[rightKeys[i]].fId;
+    const auto* lHistogram = statisticsManager->getHistogram(lOid);
+    const auto* rHistogram = statisticsManager->getHistogram(rOid);
+    const auto lNDV = statisticsManager->getNDV(lOid);
+    const auto rNDV = statisticsManager->getNDV(rOid);
+    if (!lHistogram || !rHistogram || !lNDV || !rNDV)
+      return false;
+
+    leftRows = lHistogram->rowCount;
+    rightRows = rHistogram->rowCount;
+    distinct = std::max<double>(distinct, std::max(lNDV, rNDV));
+  }
+
+  cardinality = leftRows * rightRows / distinct;
+  if (jobInfo.trace)
+    std::cout << "Join edge " << edge.first << " <-> " << edge.second << " estimated rows " << cardinality
+              << std::endl;
+  return true;
+}
+
 void CircularJoinGraphTransformer::chooseEdgeToTransform(Cycle& cycle,
                                                          std::pair<JoinEdge, int64_t>& resultEdge)
 {
   // Use statistics if possible.
   auto* statisticsManager = statistics::StatisticsManager::instance();
+
+  // With row counts and NDV for all the edges of the cycle, remove the one producing the most rows.
+  std::vector<double> cardinalities(cycle.size());
+  bool haveCardinalities = true;
+  for (uint32_t i = 0; haveCardinalities && i < cycle.size(); i++)
+    haveCardinalities = estimateJoinCardinality(cycle[i], statisticsManager, cardinalities[i]);
+
+  if (haveCardinalities)
+  {
+    int64_t chosen = -1;
+    for (uint32_t i = 0; i < cycle.size(); i++)
+    {
+      const auto& edgeForward = cycle[i];
+      const auto edgeBackward = std::make_pair(edgeForward.second, edgeForward.first);
+      if (jobInfo.joinEdgesToRestore.count(edgeForward) || jobInfo.joinEdgesToRestore.count(edgeBackward))
+        continue;
+
+      if (chosen < 0 || cardinalities[i] > cardinalities[chosen])
+        chosen = i;
+    }
+
+    if (chosen >= 0)
+    {
+      resultEdge = std::make_pair(cycle[chosen], 0 /*Dummy weight*/);
+      return;
+    }
+  }
+
   for (auto& edgeForward : cycle)
   {
     // Check that `join edge` is aligned with our needs.
@@ -2675,6 +2761,10 @@ uint32_t getLargestTable(JobInfo& jobInfo, TableInfoMap& tableInfoMap, bool over
           estimatedRowCount = tupleBPS->getEstimatedRowCount();
           jobInfo.tableSize[jobInfo.tableList[i]] = estimatedRowCount;
 
+          if (jobInfo.trace)
+            cout << "Table " << jobInfo.keyInfo->tupleKeyToName[jobInfo.tableList[i]] << " estimated rows "
+                 << estimatedRowCount << endl;
+
           if (estimatedRowCount > largestCardinality)
           {
             ret = jobInfo.tableList[i];
@@ -416,7 +416,7 @@ void JsonArrayAggregator::initialize(const rowgroup::SP_GroupConcat& gcc)
     fConstantLen += fConstCols[i].first.length();
 }
 
-void JsonArrayAggregator::outputRow(std::ostringstream& oss, const rowgroup::Row& row)
+void JsonArrayAggregator::outputRow(ConcatBuffer& buf, const rowgroup::Row& row)
 {
   const CalpontSystemCatalog::ColDataType* types = row.getColTypes();
   vector<uint32_t>::iterator i = fConcatColumns.begin();
@@ -428,7 +428,8 @@ void JsonArrayAggregator::outputRow(std::ostringstream& oss, const rowgroup::Row
   {
     if (j != fConstCols.end() && k == j->second)
     {
-      oss << j->first.safeString(""); // XXX: NULLs???
+      if (!j->first.isNull()) // XXX: NULLs???
+        buf.append(j->first.unsafeStringRef());
       j++;
       continue;
     }
@@ -441,17 +442,14 @@ void JsonArrayAggregator::outputRow(std::ostringstream& oss, const rowgroup::Row
       case CalpontSystemCatalog::INT:
       case CalpontSystemCatalog::BIGINT:
       {
-        int64_t intVal = row.getIntField(*i);
-
-        oss << intVal;
-
+        buf.appendInt(row.getIntField(*i));
         break;
       }
 
       case CalpontSystemCatalog::DECIMAL:
       case CalpontSystemCatalog::UDECIMAL:
       {
-        oss << fixed << row.getDecimalField(*i);
+        buf.append(row.getDecimalField(*i).toString());
         break;
       }
 
@@ -466,13 +464,13 @@ void JsonArrayAggregator::outputRow(std::ostringstream& oss, const rowgroup::Row
 
         if (scale == 0)
         {
-          oss << uintVal;
+          buf.appendInt(uintVal);
         }
         else
         {
-          oss << fixed
-              << datatypes::Decimal(datatypes::TSInt128((int128_t)uintVal), scale,
-                                    datatypes::INT128MAXPRECISION);
+          buf.append(datatypes::Decimal(datatypes::TSInt128((int128_t)uintVal), scale,
+                                        datatypes::INT128MAXPRECISION)
+                         .toString());
         }
 
         break;
@@ -482,15 +480,19 @@ void JsonArrayAggregator::outputRow(std::ostringstream& oss, const rowgroup::Row
       case CalpontSystemCatalog::VARCHAR:
       case CalpontSystemCatalog::TEXT:
       {
-        std::string maybeJson = row.getStringField(*i).safeString(""); // XXX: NULL??? it is not checked anywhere.
-        [[maybe_unused]] const auto j = json::parse(maybeJson, nullptr, false);
+        // XXX: NULL??? it is not checked anywhere.
+        // up to the first '\0', like the char* it used to be
+        utils::ConstString str = row.getConstString(*i);
+        const char* maybeJson = str.str() ? str.str() : "";
+        size_t len = str.str() ? strnlen(maybeJson, str.length()) : 0;
+        [[maybe_unused]] const auto j = json::parse(maybeJson, maybeJson + len, nullptr, false);
         if (j.is_discarded())
         {
-          oss << std::quoted(maybeJson.c_str());
+          buf.appendQuoted(maybeJson, len);
         }
         else
         {
-          oss << maybeJson.c_str();
+          buf.append(maybeJson, len);
         }
         break;
       }
@@ -498,44 +500,44 @@ void JsonArrayAggregator::outputRow(std::ostringstream& oss, const rowgroup::Row
       case CalpontSystemCatalog::DOUBLE:
       case CalpontSystemCatalog::UDOUBLE:
       {
-        oss << setprecision(15) << row.getDoubleField(*i);
+        buf.appendFloat(row.getDoubleField(*i), 15);
         break;
       }
 
       case CalpontSystemCatalog::LONGDOUBLE:
       {
-        oss << setprecision(15) << row.getLongDoubleField(*i);
+        buf.appendFloat(row.getLongDoubleField(*i), 15);
         break;
       }
 
       case CalpontSystemCatalog::FLOAT:
       case CalpontSystemCatalog::UFLOAT:
       {
-        oss << row.getFloatField(*i);
+        buf.appendFloat(row.getFloatField(*i), 6);
         break;
       }
 
       case CalpontSystemCatalog::DATE:
       {
-        oss << std::quoted(DataConvert::dateToString(row.getUintField(*i)));
+        buf.appendQuoted(DataConvert::dateToString(row.getUintField(*i)));
         break;
       }
 
       case CalpontSystemCatalog::DATETIME:
       {
-        oss << std::quoted(DataConvert::datetimeToString(row.getUintField(*i)));
+        buf.appendQuoted(DataConvert::datetimeToString(row.getUintField(*i)));
         break;
       }
 
       case CalpontSystemCatalog::TIMESTAMP:
       {
-        oss << std::quoted(DataConvert::timestampToString(row.getUintField(*i), fTimeZone));
+        buf.appendQuoted(DataConvert::timestampToString(row.getUintField(*i), fTimeZone));
         break;
       }
 
       case CalpontSystemCatalog::TIME:
       {
-        oss << std::quoted(DataConvert::timeToString(row.getUintField(*i)));
+        buf.appendQuoted(DataConvert::timeToString(row.getUintField(*i)));
         break;
       }
 
@@ -879,7 +881,8 @@ void JsonArrayAggOrderBy::merge(GroupConcator* gc)
 
 uint8_t* JsonArrayAggOrderBy::getResultImpl(const string&)
 {
-  ostringstream oss;
+  ConcatBuffer& buf = resultBuffer();
+  buf.clear();
   bool addSep = false;
 
   // need to reverse the order
@@ -892,23 +895,24 @@ uint8_t* JsonArrayAggOrderBy::getResultImpl(const string&)
   }
   if (rowStack.size() > 0)
   {
-    oss << '[';
-    while (rowStack.size() > 0)
+    buf.append('[');
+    // anything past the max length is cut off anyway
+    while (rowStack.size() > 0 && (int64_t)buf.size() <= fGroupConcatLen)
     {
       if (addSep)
-        oss << ',';
+        buf.append(',');
       else
         addSep = true;
 
       const OrderByRow& topRow = rowStack.top();
       fRow0.setData(topRow.fData);
-      outputRow(oss, fRow0);
+      outputRow(buf, fRow0);
       rowStack.pop();
     }
-    oss << ']';
+    buf.append(']');
   }
 
-  return swapStreamWithStringAndReturnBuf(oss, false);
+  return finishResult(buf, false);
 }
 
 const string JsonArrayAggOrderBy::toString() const
@@ -932,7 +936,7 @@ const string JsonArrayAggOrderBy::toString() const
 }
 
 JsonArrayAggNoOrder::JsonArrayAggNoOrder()
- : fRowsPerRG(128), fErrorCode(ERR_AGGREGATION_TOO_BIG), fMemSize(0), fRm(NULL)
+ : fRowsPerRG(128), fCurrentRowsPerRG(4), fErrorCode(ERR_AGGREGATION_TOO_BIG), fMemSize(0), fRm(NULL)
 {
 }
 
@@ -957,7 +961,9 @@ void JsonArrayAggNoOrder::initialize(const rowgroup::SP_GroupConcat& gcc)
   while (i != gcc->fGroupCols.end())
     fConcatColumns.push_back((*(i++)).second);
 
-  uint64_t newSize = fRowsPerRG * fRowGroup.getRowSize();
+  // There's one of these per group, start small and grow the RGs as rows come.
+  fCurrentRowsPerRG = 4;
+  uint64_t newSize = fCurrentRowsPerRG * fRowGroup.getRowSize();
 
   if (!fRm->getMemory(newSize, fSessionMemLimit))
   {
@@ -966,7 +972,7 @@ void JsonArrayAggNoOrder::initialize(const rowgroup::SP_GroupConcat& gcc)
   }
   fMemSize += newSize;
 
-  fData.reinit(fRowGroup, fRowsPerRG);
+  fData.reinit(fRowGroup, fCurrentRowsPerRG);
   fRowGroup.setData(&fData);
   fRowGroup.resetRowGroup(0);
   fRowGroup.initRow(&fRow);
@@ -987,9 +993,11 @@ void JsonArrayAggNoOrder::processRow(const rowgroup::Row& row)
     fRowGroup.incRowCount();
     fRow.nextRow();
 
-    if (fRowGroup.getRowCount() >= fRowsPerRG)
+    if (fRowGroup.getRowCount() >= fCurrentRowsPerRG)
     {
-      uint64_t newSize = fRowsPerRG * fRowGroup.getRowSize();
+      fDataQueue.push(fData);
+      fCurrentRowsPerRG = std::min(fCurrentRowsPerRG * 2, fRowsPerRG);
+      uint64_t newSize = fCurrentRowsPerRG * fRowGroup.getRowSize();
 
       if (!fRm->getMemory(newSize, fSessionMemLimit))
       {
@@ -998,8 +1006,7 @@ void JsonArrayAggNoOrder::processRow(const rowgroup::Row& row)
       }
       fMemSize += newSize;
 
-      fDataQueue.push(fData);
-      fData.reinit(fRowGroup, fRowsPerRG);
+      fData.reinit(fRowGroup, fCurrentRowsPerRG);
       fRowGroup.setData(&fData);
       fRowGroup.resetRowGroup(0);
       fRowGroup.getRow(0, &fRow);
@@ -1024,34 +1031,35 @@ void JsonArrayAggNoOrder::merge(GroupConcator* gc)
 
 uint8_t* JsonArrayAggNoOrder::getResultImpl(const string&)
 {
-  ostringstream oss;
+  ConcatBuffer& buf = resultBuffer();
+  buf.clear();
   bool addSep = false;
-  if (fRowGroup.getRowCount() > 0)
+  fDataQueue.push(fData);
+
+  // The current RG can be empty while earlier or merged ones aren't, so the brackets
+  // go around the first and last rows found.
+  while (fDataQueue.size() > 0)
   {
-    oss << '[';
-    fDataQueue.push(fData);
+    fRowGroup.setData(&fDataQueue.front());
+    fRowGroup.getRow(0, &fRow);
 
-    while (fDataQueue.size() > 0)
+    // anything past the max length is cut off anyway
+    for (uint64_t i = 0; i < fRowGroup.getRowCount() && (int64_t)buf.size() <= fGroupConcatLen; i++)
     {
-      fRowGroup.setData(&fDataQueue.front());
-      fRowGroup.getRow(0, &fRow);
-
-      for (uint64_t i = 0; i < fRowGroup.getRowCount(); i++)
-      {
-        if (addSep)
-          oss << ',';
-        else
-          addSep = true;
+      buf.append(addSep ? ',' : '[');
+      addSep = true;
 
-        outputRow(oss, fRow);
-        fRow.nextRow();
-      }
-
-      fDataQueue.pop();
+      outputRow(buf, fRow);
+      fRow.nextRow();
     }
-    oss << ']';
+
+    fDataQueue.pop();
   }
-  return swapStreamWithStringAndReturnBuf(oss, false);
+
+  if (addSep)
+    buf.append(']');
+
+  return finishResult(buf, false);
 }
 
 const string JsonArrayAggNoOrder::toString() const
@@ -80,7 +80,7 @@ class JsonArrayAggregator : public GroupConcator
 
  protected:
   virtual bool concatColIsNull(const rowgroup::Row&);
-  virtual void outputRow(std::ostringstream&, const rowgroup::Row&);
+  virtual void outputRow(ConcatBuffer&, const rowgroup::Row&);
   virtual int64_t lengthEstimate(const rowgroup::Row&);
 };
 
@@ -107,6 +107,7 @@ class JsonArrayAggNoOrder : public JsonArrayAggregator
   rowgroup::RGData fData;
   std::queue<rowgroup::RGData> fDataQueue;
   uint64_t fRowsPerRG;
+  uint64_t fCurrentRowsPerRG;  // grows to fRowsPerRG, most groups only have a few rows
   uint64_t fErrorCode;
   uint64_t fMemSize;
   ResourceManager* fRm;
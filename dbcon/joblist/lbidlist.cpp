@@ -698,7 +698,8 @@ bool LBIDList::checkRangeOverlap(T min, T max, T tmin, T tmax,
 bool LBIDList::CasualPartitionPredicate(const BRM::EMCasualPartition_t& cpRange,
                                         const messageqcpp::ByteStream* bs, const uint16_t NOPS,
                                         const execplan::CalpontSystemCatalog::ColType& ct, const uint8_t BOP,
-                                        bool isDict)
+                                        bool isDict, const BRM::ExtentBloom* bloom,
+                                        const std::vector<uint64_t>* valueHashes)
 {
   int length = bs->length(), pos = 0;
   const char* MsgDataPtr = (const char*)bs->buf();
@@ -726,6 +727,7 @@ bool LBIDList::CasualPartitionPredicate(const BRM::EMCasualPartition_t& cpRange,
 
     char op = *MsgDataPtr++;
     uint8_t lcf = *(uint8_t*)MsgDataPtr++;
+    const char* valuePtr = MsgDataPtr;
 
     if (bIsUnsigned)
     {
@@ -814,7 +816,12 @@ bool LBIDList::CasualPartitionPredicate(const BRM::EMCasualPartition_t& cpRange,
       }
     }
 
-    if (bIsChar)
+    if (cpRange.isValid != BRM::CP_VALID)
+    {
+      // No range to check the value against, only the bloom filter can tell
+      scan = true;
+    }
+    else if (bIsChar)
     {
       datatypes::Charset cs(ct.charsetNumber);
       utils::ConstString sMin((const char*)&cpRange.loVal, ct.colWidth);
@@ -840,6 +847,21 @@ bool LBIDList::CasualPartitionPredicate(const BRM::EMCasualPartition_t& cpRange,
       }
     }
 
+    // The value is within the extent's range, but the extent may still not have it
+    if (scan && bloom && op == COMPARE_EQ && lcf == 0)
+    {
+      if (isDict)
+      {
+        if (valueHashes && (size_t)i < valueHashes->size())
+          scan = bloom->mayContain((*valueHashes)[i]);
+      }
+      else if (bIsChar)
+        scan = bloom->mayContain(BRM::ExtentBloom::hash(
+            const_cast<execplan::CalpontSystemCatalog::ColType&>(ct).getCharset(), valuePtr, ct.colWidth));
+      else
+        scan = bloom->mayContain(BRM::ExtentBloom::hash(valuePtr, ct.colWidth));
+    }
+
     if (BOP == BOP_AND && !scan)
     {
       break;
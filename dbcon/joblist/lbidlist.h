@@ -31,6 +31,7 @@
 #include "bytestream.h"
 #include <iostream>
 #include "brm.h"
+#include "extentbloom.h"
 #include <tr1/unordered_map>
 
 namespace joblist
@@ -101,10 +102,16 @@ class LBIDList
 
   bool IsRangeBoundary(uint64_t lbid);
 
+  // bloom, if not null, is the extent's bloom filter; it's checked for the
+  // equality predicates whose value is inside the extent's min/max range, or
+  // for all of them if the range isn't valid.  The filters of a token column
+  // only carry string prefixes, so for isDict it's checked with valueHashes,
+  // the ExtentBloom::hash() of each predicate's whole string.
   bool CasualPartitionPredicate(const BRM::EMCasualPartition_t& cpRange,
                                 const messageqcpp::ByteStream* MsgDataPtr, const uint16_t NOPS,
                                 const execplan::CalpontSystemCatalog::ColType& ct, const uint8_t BOP,
-                                bool isDict);
+                                bool isDict, const BRM::ExtentBloom* bloom = NULL,
+                                const std::vector<uint64_t>* valueHashes = NULL);
 
   template <typename T>
   bool checkSingleValue(T min, T max, T value, const execplan::CalpontSystemCatalog::ColType& type);
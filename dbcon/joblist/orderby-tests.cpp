@@ -29,6 +29,7 @@
 #include "funcexp.h"
 #include "jlf_common.h"
 #include "tupleannexstep.h"
+#include "externalorderby.h"
 #include "calpontsystemcatalog.h"
 #include "resourcemanager.h"
 #include <boost/any.hpp>
@@ -117,6 +118,7 @@ class FilterDriver : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE(FilterDriver);
 
   CPPUNIT_TEST(ORDERBY_TIME_TEST);
+  CPPUNIT_TEST(EXTERNAL_ORDERBY_TEST);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -330,6 +332,83 @@ class FilterDriver : public CppUnit::TestFixture
     orderByTest_nRGs(numRows * 14400, limit, maxThreads, woParallel, generateRandValues, hasDistinct);
     orderByTest_nRGs(numRows * 14400, limit, maxThreads, parallel, generateRandValues, hasDistinct);
   }
+  // ORDER BY without LIMIT with a session memory limit small enough
+  // to make the input threads spill their runs to disk
+  void EXTERNAL_ORDERBY_TEST()
+  {
+    const uint32_t threads = 2;
+    const uint32_t numberOfRGs = 100;
+    const uint64_t rowsPerRG = 8192;
+
+    ResourceManager* rm = ResourceManager::instance(true);
+    joblist::JobInfo jobInfo = joblist::JobInfo(rm);
+    jobInfo.orderByColVec.push_back(make_pair(1, true));
+    jobInfo.umMemLimit.reset(new int64_t);
+    *(jobInfo.umMemLimit) = 4 * 1024 * 1024;
+
+    std::vector<uint32_t> offsets{2, 10, 18}, roids{3001, 3001}, tkeys{1, 1}, cscale{0, 0};
+    std::vector<uint32_t> cprecision{20, 20}, charSetNumVec{8, 8};
+    std::vector<execplan::CalpontSystemCatalog::ColDataType> types{
+        execplan::CalpontSystemCatalog::UBIGINT, execplan::CalpontSystemCatalog::UBIGINT};
+    rowgroup::RowGroup rg(2, offsets, roids, tkeys, types, charSetNumVec, cscale, cprecision, 20, false);
+
+    joblist::ExternalOrderBy eob;
+    eob.allowDisk(true);
+    eob.initialize(rg, jobInfo, threads);
+
+    ::srand(42);
+    for (uint32_t i = 0; i < numberOfRGs; i++)
+    {
+      rowgroup::RGData rgD(rg);
+      rg.setData(&rgD);
+      rowgroup::Row r;
+      rg.initRow(&r);
+      rg.getRow(0, &r);
+
+      for (uint64_t j = 0; j < rowsPerRG; j++)
+      {
+        uint64_t value = ::rand();
+        r.setUintField<8>(value, 0);
+        r.setUintField<8>(value, 1);
+        r.nextRow();
+      }
+
+      rg.setRowCount(rowsPerRG);
+      eob.addRGData(i % threads, rgD);
+    }
+
+    for (uint32_t i = 0; i < threads; i++)
+      eob.endOfInput(i);
+
+    eob.finalize();
+    cout << eob.toString();
+    CPPUNIT_ASSERT(eob.getSpilledRunCount() > 0);
+
+    rowgroup::RGData outRGData;
+    rowgroup::Row r;
+    rg.initRow(&r);
+    uint64_t rows = 0;
+    uint64_t last = 0;
+
+    while (eob.getData(outRGData))
+    {
+      rg.setData(&outRGData);
+      rg.getRow(0, &r);
+
+      for (uint64_t i = 0; i < rg.getRowCount(); i++)
+      {
+        CPPUNIT_ASSERT(last <= r.getUintField(0));
+        CPPUNIT_ASSERT_EQUAL(r.getUintField(0), r.getUintField(1));
+        last = r.getUintField(0);
+        r.nextRow();
+      }
+
+      rows += rg.getRowCount();
+    }
+
+    CPPUNIT_ASSERT_EQUAL(numberOfRGs * rowsPerRG, rows);
+  }
+
   void QUICK_TEST()
   {
     float f = 1.1;
@@ -1087,6 +1087,10 @@ class TupleBPS : public BatchPrimitive, public TupleDeliveryStep
   {
     return fNumBlksSkipped;
   }
+  uint64_t extentsSkippedByBloom() const
+  {
+    return fNumExtentsSkippedByBloom;
+  }
 
   uint32_t getUniqueID()
   {
@@ -1176,6 +1180,12 @@ class TupleBPS : public BatchPrimitive, public TupleDeliveryStep
   void addCPPredicates(uint32_t OID, const std::vector<int128_t>& vals, bool isRange,
                        bool isSmallSideWideDecimal);
 
+  /* Runtime join filter from a UM join on the OID column.  PrimProc drops the rows
+   * the filter rejects before projecting the other columns.  Ignored if OID isn't
+   * a plain integer column projected by this step.
+   */
+  void addRuntimeFilter(uint32_t OID, const std::shared_ptr<joiner::JoinBloomFilter>& filter);
+
   /* semijoin adds */
   void setJoinFERG(const rowgroup::RowGroup& rg);
 
@@ -1272,6 +1282,7 @@ class TupleBPS : public BatchPrimitive, public TupleDeliveryStep
   uint64_t fPhysicalIO;              // total physical I/O count
   uint64_t fCacheIO;                 // total cache I/O count
   uint64_t fNumBlksSkipped;          // total number of block scans skipped due to CP
+  uint64_t fNumExtentsSkippedByBloom;  // extents CP min/max kept, but bloom filters eliminated
   uint64_t fMsgBytesIn;              // total byte count for incoming messages
   uint64_t fMsgBytesOut;             // total byte count for outcoming messages
   uint64_t fBlockTouched;            // total blocks touched
@@ -238,6 +238,7 @@ ResourceManager::ResourceManager(bool runningInExeMgr, config::Config* aConfig)
 
   fAllowedDiskAggregation =
       getBoolVal(fRowAggregationStr, "AllowDiskBasedAggregation", defaultAllowDiskAggregation);
+  fAllowedDiskOrderBy = getBoolVal(fOrderByStr, "AllowDiskBasedOrderBy", defaultAllowDiskOrderBy);
 
   if (!load_encryption_keys())
   {
@@ -106,6 +106,7 @@ const constexpr uint64_t defaultBPPSendThreadBytesThresh = 250000000;       // ~
 const constexpr uint64_t BPPSendThreadMsgThresh = 100;
 
 const bool defaultAllowDiskAggregation = false;
+const bool defaultAllowDiskOrderBy = false;
 
 /** @brief ResourceManager
  *	Returns requested values from Config
@@ -161,6 +162,11 @@ class ResourceManager
     return fAllowedDiskAggregation;
   }
 
+  bool getAllowDiskOrderBy() const
+  {
+    return fAllowedDiskOrderBy;
+  }
+
   uint64_t getDECConnectionsPerQuery() const
   {
     return fDECConnectionsPerQuery;
@@ -489,6 +495,7 @@ class ResourceManager
   /*static	const*/ std::string fDMLProcStr;
   /*static	const*/ std::string fBatchInsertStr;
   inline static const std::string fRowAggregationStr = "RowAggregation";
+  inline static const std::string fOrderByStr = "OrderBy";
   config::Config* fConfig;
   static ResourceManager* fInstance;
   uint32_t fTraceFlags;
@@ -519,6 +526,7 @@ class ResourceManager
   bool isExeMgr;
   bool fUseHdfs;
   bool fAllowedDiskAggregation{false};
+  bool fAllowedDiskOrderBy{false};
   uint64_t fDECConnectionsPerQuery;
 };
 
@@ -28,6 +28,7 @@
 #include "brmtypes.h"
 #include "dataconvert.h"
 #include "configcpp.h"
+#include "statistics.h"
 
 #define ROW_EST_DEBUG 0
 #if ROW_EST_DEBUG
@@ -257,14 +258,76 @@ float RowEstimator::estimateOpFactor(const T& min, const T& max, const T& value,
   return factor;
 }
 
+// Same as estimateOpFactor() but for integer columns that have been analyzed.  The histogram gives
+// the distribution of the whole column, conditioning it on the extent's min/max range gives the
+// distribution inside the extent.
+bool RowEstimator::estimateOpFactorFromStats(const statistics::Histogram& histogram,
+                                             const execplan::CalpontSystemCatalog::OID oid, int64_t min,
+                                             int64_t max, int64_t value, char op, float& factor)
+{
+  const double lo = histogram.fractionBelow(min);
+  const double hi = histogram.fractionAtMost(max);
+  const double inExtent = hi - lo;
+
+  // The stats are older than the extent, or the extent holds only NULLs.
+  if (inExtent <= 0)
+    return false;
+
+  auto clamp = [lo, hi](double x) { return std::min(hi, std::max(lo, x)); };
+  double ret;
+
+  switch (op)
+  {
+    case COMPARE_LT:
+    case COMPARE_NGE: ret = (clamp(histogram.fractionBelow(value)) - lo) / inExtent; break;
+
+    case COMPARE_LE:
+    case COMPARE_NGT: ret = (clamp(histogram.fractionAtMost(value)) - lo) / inExtent; break;
+
+    case COMPARE_GT:
+    case COMPARE_NLE: ret = (hi - clamp(histogram.fractionAtMost(value))) / inExtent; break;
+
+    case COMPARE_GE:
+    case COMPARE_NLT: ret = (hi - clamp(histogram.fractionBelow(value))) / inExtent; break;
+
+    case COMPARE_EQ:
+    case COMPARE_NE:
+    {
+      double equal;
+      if (!statistics::StatisticsManager::instance()->estimateEqualFraction(oid, value, equal))
+        return false;
+      // The rows of a value are assumed to be in the extents whose range covers it.
+      ret = std::min(1.0, equal / inExtent);
+      if (histogram.less(value, min) || histogram.less(max, value))
+        ret = 0;
+      if (op == COMPARE_NE)
+        ret = 1.0 - ret;
+      break;
+    }
+
+    default: return false;
+  }
+
+  // NULLs never qualify.
+  factor = std::min(1.0, std::max(0.0, ret)) * (1.0 - histogram.nullFraction);
+  return true;
+}
+
 // Estimate the percentage of rows that will be returned for a particular extent.
 // This function provides the estimate for entire filter such as "col 1 < 100 or col1 > 10000".
 float RowEstimator::estimateRowReturnFactor(const BRM::EMEntry& emEntry, const messageqcpp::ByteStream* bs,
                                             const uint16_t NOPS,
                                             const execplan::CalpontSystemCatalog::ColType& ct,
-                                            const uint8_t BOP, const uint32_t& rowsInExtent)
+                                            const uint8_t BOP, const uint32_t& rowsInExtent,
+                                            const execplan::CalpontSystemCatalog::OID oid)
 {
   bool bIsUnsigned = datatypes::isUnsigned(ct.colDataType);
+
+  // ANALYZE TABLE only collects histograms for integer columns.
+  const statistics::Histogram* histogram = nullptr;
+  if ((ct.isSignedInteger() || ct.isUnsignedInteger()) && emEntry.partition.cprange.isValid == BRM::CP_VALID)
+    histogram = statistics::StatisticsManager::instance()->getHistogram(oid);
+
   float factor = 1.0;
   float tempFactor = 1.0;
 
@@ -451,6 +514,11 @@ float RowEstimator::estimateRowReturnFactor(const BRM::EMEntry& emEntry, const m
       }
     }
 
+    // The column's statistics, if it has been analyzed, replace the uniform estimate.
+    if (histogram)
+      estimateOpFactorFromStats(*histogram, oid, emEntry.partition.cprange.loVal,
+                                emEntry.partition.cprange.hiVal, value, op, tempFactor);
+
 #if ROW_EST_DEBUG
     cout << ", OperatorFactor-" << tempFactor << ", DistinctValsEst-" << distinctValuesEstimate << endl;
 #endif
@@ -559,7 +627,7 @@ uint64_t RowEstimator::estimateRows(const vector<ColumnCommandJL*>& cpColVec,
         // tempFactor =  rowEstimator.estimateRowReturnFactor(
         tempFactor = estimateRowReturnFactor(colCmd->getExtents()[idx], &(colCmd->getFilterString()),
                                              colCmd->getFilterCount(), colCmd->getColType(), colCmd->getBOP(),
-                                             extentRows);
+                                             extentRows, colCmd->getOID());
 #if ROW_EST_DEBUG
         stopwatch.stop("estimateRowReturnFactor");
 #endif
@@ -34,6 +34,11 @@
 #include <vector>
 #include "brm.h"
 
+namespace statistics
+{
+struct Histogram;
+}
+
 namespace joblist
 {
 /** @brief estimates row counts for a TupleBPS.
@@ -124,11 +129,27 @@ class RowEstimator
    * @param ct	      The column type.
    * @param BOP	      The binary operator for the filter predicates (eg. OR for col1 = 5 or col1 = 10)
    * @param rowsInExtent The number of rows in the extent being evaluated.
+   * @param oid          The column the filter is on, used to look up its ANALYZE TABLE statistics.
    *
    */
   float estimateRowReturnFactor(const BRM::EMEntry& emEntry, const messageqcpp::ByteStream* msgDataPtr,
                                 const uint16_t NOPS, const execplan::CalpontSystemCatalog::ColType& ct,
-                                const uint8_t BOP, const uint32_t& rowsInExtent);
+                                const uint8_t BOP, const uint32_t& rowsInExtent,
+                                const execplan::CalpontSystemCatalog::OID oid);
+
+  /** @brief estimateOpFactor() using the histogram and NDV of the column instead of assuming the values
+   *          are spread uniformly over the extent's min/max range.
+   *
+   * The fraction of the column's values inside the extent's range is taken from the histogram, and the
+   * operation's share of it is the fraction of the values that qualify inside that range.  Equality
+   * uses the MCV list and the NDV.
+   *
+   * @return false if there are no usable statistics for the operation, the caller falls back to
+   *         estimateOpFactor().
+   */
+  bool estimateOpFactorFromStats(const statistics::Histogram& histogram,
+                                 const execplan::CalpontSystemCatalog::OID oid, int64_t min, int64_t max,
+                                 int64_t value, char op, float& factor);
 
   // Configurables read from Columnstore.xml - future.
   uint32_t fExtentsToSample;
@@ -488,6 +488,7 @@ TupleBPS::TupleBPS(const pColStep& rhs, const JobInfo& jobInfo)
   fBPP->setOutputType(ROW_GROUP);
   finishedSending = sendWaiting = false;
   fNumBlksSkipped = 0;
+  fNumExtentsSkippedByBloom = 0;
   fPhysicalIO = 0;
   fCacheIO = 0;
   BPPIsAllocated = false;
@@ -600,6 +601,7 @@ TupleBPS::TupleBPS(const pColScanStep& rhs, const JobInfo& jobInfo) : BatchPrimi
   ridsReturned = 0;
   ridsRequested = 0;
   fNumBlksSkipped = 0;
+  fNumExtentsSkippedByBloom = 0;
   fMsgBytesIn = 0;
   fMsgBytesOut = 0;
   fBlockTouched = 0;
@@ -694,6 +696,7 @@ TupleBPS::TupleBPS(const PassThruStep& rhs, const JobInfo& jobInfo) : BatchPrimi
   finishedSending = sendWaiting = false;
   fSwallowRows = false;
   fNumBlksSkipped = 0;
+  fNumExtentsSkippedByBloom = 0;
   fPhysicalIO = 0;
   fCacheIO = 0;
   BPPIsAllocated = false;
@@ -736,6 +739,7 @@ TupleBPS::TupleBPS(const pDictionaryStep& rhs, const JobInfo& jobInfo)
   ridsReturned = 0;
   ridsRequested = 0;
   fNumBlksSkipped = 0;
+  fNumExtentsSkippedByBloom = 0;
   fBlockTouched = 0;
   fMsgBytesIn = 0;
   fMsgBytesOut = 0;
@@ -1048,6 +1052,7 @@ void TupleBPS::storeCasualPartitionInfo(const bool estimateRowCounts)
   const vector<SCommand>& colCmdVec = fBPP->getFilterSteps();
   vector<ColumnCommandJL*> cpColVec;
   vector<SP_LBIDList> lbidListVec;
+  vector<std::shared_ptr<BRM::ExtentBlooms> > bloomVec;
   ColumnCommandJL* colCmd = 0;
   bool defaultScanFlag = true;
 
@@ -1078,6 +1083,18 @@ void TupleBPS::storeCasualPartitionInfo(const bool estimateRowCounts)
     {
       lbidListVec.push_back(tmplbidList);
       cpColVec.push_back(colCmd);
+
+      // bloom filters can only be used on values compared by their bytes, and
+      // on token columns only with the strings of their dictionary's = filters
+      const vector<uint64_t>& filterHashes = colCmd->getFilterHashes();
+
+      if (BRM::ExtentBloom::supported(colCmd->getColType().colDataType, colCmd->getColType().colWidth,
+                                      colCmd->getIsDict()) &&
+          (!colCmd->getIsDict() ||
+           std::any_of(filterHashes.begin(), filterHashes.end(), [](uint64_t h) { return h != 0; })))
+        bloomVec.push_back(std::make_shared<BRM::ExtentBlooms>(colCmd->getOID()));
+      else
+        bloomVec.push_back(std::shared_ptr<BRM::ExtentBlooms>());
     }
 
     // @Bug 3503. Use the total table size as the estimate for non CP columns.
@@ -1112,6 +1129,26 @@ void TupleBPS::storeCasualPartitionInfo(const bool estimateRowCounts)
            lbidListVec[i]->CasualPartitionPredicate(extent.partition.cprange, &(colCmd->getFilterString()),
                                                     colCmd->getFilterCount(), colCmd->getColType(),
                                                     colCmd->getBOP(), colCmd->getIsDict()));
+
+      // The min/max range keeps the extent; see if its bloom filter doesn't.
+      // A token extent's filter is current even if its range isn't valid,
+      // cpimport doesn't set one.
+      if (scanFlags[idx] && bloomVec[i] && !ignoreCP &&
+          (extent.partition.cprange.isValid == BRM::CP_VALID || colCmd->getIsDict()) &&
+          colCmd->getColType().colWidth == extent.colWid)
+      {
+        const BRM::ExtentBloom* bloom = bloomVec[i]->find(extent);
+
+        if (bloom &&
+            !lbidListVec[i]->CasualPartitionPredicate(extent.partition.cprange, &(colCmd->getFilterString()),
+                                                      colCmd->getFilterCount(), colCmd->getColType(),
+                                                      colCmd->getBOP(), colCmd->getIsDict(), bloom,
+                                                      &colCmd->getFilterHashes()))
+        {
+          scanFlags[idx] = false;
+          fNumExtentsSkippedByBloom++;
+        }
+      }
     }
   }
 
@@ -2238,6 +2275,15 @@ void TupleBPS::processByteStreamVector(vector<boost::shared_ptr<messageqcpp::Byt
         {
           uint32_t matchCount = 0;
 
+          if (k % joiner::TupleJoiner::PrefetchBatchSize == 0)
+          {
+            uint32_t batchSize = std::min<uint32_t>(joiner::TupleJoiner::PrefetchBatchSize,
+                                                    data->local_primRG.getRowCount() - k);
+
+            for (uint32_t j = 0; j < smallSideCount; j++)
+              tjoiners[j]->prefetchMatches(data->largeSideRow, batchSize);
+          }
+
           for (uint32_t j = 0; j < smallSideCount; j++)
           {
             tjoiners[j]->match(data->largeSideRow, k, threadID, &(data->joinerOutput[j]));
@@ -2774,9 +2820,15 @@ void TupleBPS::receiveMultiPrimitiveMessages()
       logStr << "ses:" << fSessionId << " st: " << fStepId << " finished at " << JSTimeStamp::format(tvbuf)
              << "; PhyI/O-" << fPhysicalIO << "; CacheI/O-" << fCacheIO << "; MsgsSent-" << msgsSent
              << "; MsgsRvcd-" << msgsRecvd << "; BlocksTouched-" << fBlockTouched << "; BlockedFifoIn/Out-"
-             << totalBlockedReadCount << "/" << totalBlockedWriteCount << "; output size-" << ridsReturned
-             << endl
-             << "\tPartitionBlocksEliminated-" << fNumBlksSkipped << "; MsgBytesIn-" << msgBytesInKB << "KB"
+             << totalBlockedReadCount << "/" << totalBlockedWriteCount << "; output size-" << ridsReturned;
+
+      // the estimate the large side was picked with, to compare with the actual size
+      if (fEstimatedRows > 0)
+        logStr << "; estimated size-" << fEstimatedRows;
+
+      logStr << endl
+             << "\tPartitionBlocksEliminated-" << fNumBlksSkipped << "; BloomExtentsEliminated-"
+             << fNumExtentsSkippedByBloom << "; MsgBytesIn-" << msgBytesInKB << "KB"
              << "; MsgBytesOut-" << msgBytesOutKB << "KB"
              << "; TotalMsgs-" << totalMsgs << endl
              << "\t1st read " << dlTimes.FirstReadTimeString() << "; EOI " << dlTimes.EndOfInputTimeString()
@@ -3222,6 +3274,27 @@ void TupleBPS::setJoinFERG(const RowGroup& rg)
   fBPP->setJoinFERG(rg);
 }
 
+void TupleBPS::addRuntimeFilter(uint32_t OID, const std::shared_ptr<joiner::JoinBloomFilter>& filter)
+{
+  if (fOid < 3000)
+    return;
+
+  vector<SCommand>& projectSteps = fBPP->getProjectSteps();
+
+  for (uint32_t i = 0; i < projectSteps.size(); i++)
+  {
+    ColumnCommandJL* cmd = dynamic_cast<ColumnCommandJL*>(projectSteps[i].get());
+
+    if (cmd == NULL || dynamic_cast<PseudoCCJL*>(cmd) != NULL || cmd->getOID() != OID)
+      continue;
+
+    if (!cmd->isDict() && cmd->getWidth() <= 8)
+      fBPP->addRuntimeFilter(i, filter);
+
+    return;
+  }
+}
+
 void TupleBPS::addCPPredicates(uint32_t OID, const vector<int128_t>& vals, bool isRange,
                                bool isSmallSideWideDecimal)
 {
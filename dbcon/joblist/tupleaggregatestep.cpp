@@ -78,6 +78,9 @@ namespace
 typedef vector<std::pair<Row::Pointer, uint64_t>> RowBucket;
 typedef vector<RowBucket> RowBucketVec;
 
+// groups a thread pre-aggregates on its own before it flushes them to the buckets
+const uint64_t LocalAggMaxGroups = 64 * 1024;
+
 inline RowAggFunctionType functionIdMap(int planFuncId)
 {
   switch (planFuncId)
@@ -337,6 +340,18 @@ void TupleAggregateStep::initializeMultiThread()
     fRowGroupOuts[i].setData(&fRowGroupDatas[i]);
     fRowGroupOuts[i].resetRowGroup(0);
   }
+
+  fLocalAggregators.resize(fNumOfThreads);
+  fLocalRowGroupOuts.resize(fNumOfThreads);
+  fLocalRowGroupDatas.resize(fNumOfThreads);
+
+  for (i = 0; i < fNumOfThreads; i++)
+  {
+    fLocalRowGroupOuts[i] = fRowGroupOut;
+    fLocalRowGroupDatas[i].reinit(fRowGroupOut);
+    fLocalRowGroupOuts[i].setData(&fLocalRowGroupDatas[i]);
+    fLocalRowGroupOuts[i].resetRowGroup(0);
+  }
 }
 
 void TupleAggregateStep::run()
@@ -405,7 +420,7 @@ void TupleAggregateStep::doThreadedSecondPhaseAggregate(uint32_t threadID)
             // uint8_t* hashMapKey = rowIn.getData() + 2;
             // bucketID = hash.operator()(hashMapKey) & fBucketMask;
             uint64_t hash = rowgroup::hashRow(rowIn, hashlen - 1);
-            bucketID = hash % fNumOfBuckets;
+            bucketID = rowgroup::hashToBucket(hash, fNumOfBuckets);
             rowBucketVecs[bucketID][j].emplace_back(rowIn.getPointer(), hash);
             rowIn.nextRow();
           }
@@ -429,7 +444,7 @@ void TupleAggregateStep::doThreadedSecondPhaseAggregate(uint32_t threadID)
           // uint8_t* hashMapKey = rowIn.getData() + 2;
           // bucketID = hash.operator()(hashMapKey) & fBucketMask;
           uint64_t hash = rowgroup::hashRow(rowIn, hashlen - 1);
-          bucketID = hash % fNumOfBuckets;
+          bucketID = rowgroup::hashToBucket(hash, fNumOfBuckets);
           rowBucketVecs[bucketID][0].emplace_back(rowIn.getPointer(), hash);
           rowIn.nextRow();
         }
@@ -568,6 +583,71 @@ uint32_t TupleAggregateStep::nextBand_singleThread(messageqcpp::ByteStream& bs)
   return rowCount;
 }
 
+void TupleAggregateStep::threadedAggregateOutput(uint32_t threadID, RowGroupDL* dlp)
+{
+  RowGroup rowGroupDelivered = fRowGroupDelivered;
+  uint64_t rowsReturned = 0;
+
+  try
+  {
+    while (!cancelled())
+    {
+      uint32_t bucketNum;
+      {
+        boost::mutex::scoped_lock lk(fMutex);
+        bucketNum = fBucketNum++;
+      }
+
+      if (bucketNum >= fNumOfBuckets)
+        break;
+
+      RowAggregationUM* aggregator = fAggregators[bucketNum].get();
+      RowGroup* rowGroupOut = aggregator->getOutputRowGroup();
+
+      // the clones share the post aggregation expressions, which keep their results in the
+      // expression tree, so every bucket evaluates its own copy
+      if (!aggregator->expression().empty())
+      {
+        vector<SRCP> expression;
+
+        for (const auto& exp : aggregator->expression())
+          expression.emplace_back(exp->clone());
+
+        aggregator->expression(expression);
+      }
+
+      while (!cancelled() && aggregator->nextOutputRowGroup())
+      {
+        aggregator->finalize();
+        uint64_t rowCount = rowGroupOut->getRowCount();
+
+        if (rowCount == 0)
+          continue;
+
+        rowsReturned += rowCount;
+        rowGroupDelivered.setData(rowGroupOut->getRGData());
+
+        if (rowGroupOut->getColumnCount() != rowGroupDelivered.getColumnCount())
+          pruneAuxColumns(*rowGroupOut, rowGroupDelivered);
+
+        RGData rgData = rowGroupDelivered.duplicate();
+        fDlMutex.lock();
+        dlp->insert(rgData);
+        fDlMutex.unlock();
+      }
+    }
+  }
+  catch (...)
+  {
+    handleException(std::current_exception(), logging::tupleAggregateStepErr,
+                    logging::ERR_AGGREGATION_TOO_BIG,
+                    "TupleAggregateStep::threadedAggregateOutput()[" + std::to_string(threadID) + "]");
+  }
+
+  boost::mutex::scoped_lock lk(fMutex);
+  fRowsReturned += rowsReturned;
+}
+
 bool TupleAggregateStep::nextDeliveredRowGroup()
 {
   for (; fBucketNum < fNumOfBuckets; fBucketNum++)
@@ -5346,8 +5426,105 @@ void TupleAggregateStep::threadedAggregateRowGroups(uint32_t threadID)
   bool more = true;
   RowGroupDL* dlIn = nullptr;
   uint32_t rgVecShift = float(fNumOfBuckets) / fNumOfThreads * threadID;
+  bool preAggregate = false;
+  uint64_t localRows = 0;  // input rows in the pre-aggregation table
 
   RowAggregationMultiDistinct* multiDist = nullptr;
+
+  // Inserts the rows of rowBucketVecs into the bucket aggregators. mergeRows is the output
+  // rowgroup of the thread's pre-aggregation table if the rows are groups of it.
+  auto insertIntoBuckets = [&](const RowGroup* mergeRows)
+  {
+    bool done = false;
+    fill(&bucketDone[0], &bucketDone[fNumOfBuckets], false);
+
+    while (!fEndOfResult && !done && !cancelled())
+    {
+      bool didWork = false;
+      done = true;
+
+      // each thread starts from its own bucket for better distribution
+      uint32_t shift = (rgVecShift++) % fNumOfBuckets;
+      for (uint32_t ci = 0; ci < fNumOfBuckets && !cancelled(); ci++)
+      {
+        uint32_t c = (ci + shift) % fNumOfBuckets;
+        if (!fEndOfResult && !bucketDone[c] && fAgg_mutex[c]->try_lock())
+        {
+          try
+          {
+            didWork = true;
+
+            if (multiDist)
+              dynamic_cast<RowAggregationMultiDistinct*>(fAggregators[c].get())
+                  ->addRowGroup(&fRowGroupIns[threadID], rowBucketVecs[c]);
+            else if (mergeRows)
+              fAggregators[c]->mergeRowGroup(mergeRows, rowBucketVecs[c][0]);
+            else
+            {
+              fAggregators[c]->addRowGroup(&fRowGroupIns[threadID], rowBucketVecs[c][0]);
+            }
+          }
+          catch (...)
+          {
+            fAgg_mutex[c]->unlock();
+            throw;
+          }
+
+          rowBucketVecs[c][0].clear();
+          bucketDone[c] = true;
+          fAgg_mutex[c]->unlock();
+        }
+        else if (!bucketDone[c])
+        {
+          done = false;
+        }
+      }
+
+      if (!didWork)
+        usleep(1000);  // avoid using all CPU during busy wait
+    }
+  };
+
+  // Moves the groups of the pre-aggregation table to the buckets, partitioned by the same hash
+  // prefix as the input rows, so every group still lands in one bucket. The thread stops
+  // pre-aggregating if the table didn't halve its input, the rows would only be copied twice.
+  auto flushLocalAggregate = [&]()
+  {
+    RowAggregationUM* localAgg = fLocalAggregators[threadID].get();
+    RowGroup* localOut = localAgg->getOutputRowGroup();
+    const uint64_t groups = localAgg->groupCount();
+    vector<std::unique_ptr<RGData>> flushed;  // keeps the groups in place until they are merged
+    Row row;
+    localOut->initRow(&row);
+
+    while (!cancelled() && localAgg->nextOutputRowGroup())
+    {
+      flushed.emplace_back(localAgg->moveCurrentRGData());
+      localOut->getRow(0, &row);
+
+      for (uint64_t i = 0; i < localOut->getRowCount(); ++i)
+      {
+        uint64_t hash = rowgroup::hashRow(row, hashLens[0] - 1);
+        rowBucketVecs[rowgroup::hashToBucket(hash, fNumOfBuckets)][0].emplace_back(row.getPointer(), hash);
+        row.nextRow();
+      }
+    }
+
+    insertIntoBuckets(localOut);
+
+    for (uint32_t i = 0; i < fNumOfBuckets; i++)
+      rowBucketVecs[i][0].clear();
+
+    // aggReset() initializes the first row of the current output data, which is a flushed one
+    localOut->setData(&fLocalRowGroupDatas[threadID]);
+    localAgg->aggReset();
+
+    if (groups * 2 > localRows)
+      preAggregate = false;
+
+    localRows = 0;
+  };
+
   if (!fDoneAggregate)
   {
     if (fInputJobStepAssociation.outSize() == 0)
@@ -5478,12 +5655,24 @@ void TupleAggregateStep::threadedAggregateRowGroups(uint32_t threadID)
             fAggregators[i].reset(fAggregator->clone());
             fAggregators[i]->setInputOutput(fRowGroupIn, &fRowGroupOuts[i]);
           }
+
+          // the buckets can merge groups the threads aggregated on their own
+          fPreAggregate = !dynamic_cast<RowAggregationDistinct*>(fAggregator.get()) &&
+                          fAggregators[0]->canMergeRows();
+        }
+
+        if (fPreAggregate && !fLocalAggregators[threadID])
+        {
+          fLocalAggregators[threadID].reset(fAggregator->clone());
+          fLocalAggregators[threadID]->setInputOutput(fRowGroupIn, &fLocalRowGroupOuts[threadID]);
+          preAggregate = true;
         }
 
         fMutex.unlock();
         locked = false;
 
         multiDist = dynamic_cast<RowAggregationMultiDistinct*>(fAggregator.get());
+        const bool scattered = multiDist || !preAggregate;
 
         // dispatch rows to row buckets
         if (multiDist)
@@ -5509,13 +5698,28 @@ void TupleAggregateStep::threadedAggregateRowGroups(uint32_t threadID)
                 // TBD This approach could potentiall
                 // put all values in on bucket.
                 uint64_t hash = rowgroup::hashRow(distRow[j], hashLens[j] - 1);
-                bucketID = hash % fNumOfBuckets;
+                bucketID = rowgroup::hashToBucket(hash, fNumOfBuckets);
                 rowBucketVecs[bucketID][j].emplace_back(rowIn.getPointer(), hash);
                 rowIn.nextRow();
               }
             }
           }
         }
+        else if (preAggregate)
+        {
+          // aggregate into the thread's own table, the buckets only see its groups
+          RowAggregationUM* localAgg = fLocalAggregators[threadID].get();
+
+          for (uint32_t c = 0; c < rgDatas.size(); c++)
+          {
+            fRowGroupIns[threadID].setData(&rgDatas[c]);
+            localAgg->addRowGroup(&fRowGroupIns[threadID]);
+            localRows += fRowGroupIns[threadID].getRowCount();
+          }
+
+          if (localAgg->groupCount() >= LocalAggMaxGroups)
+            flushLocalAggregate();
+        }
         else
         {
           for (uint32_t c = 0; c < rgDatas.size(); c++)
@@ -5542,7 +5746,7 @@ void TupleAggregateStep::threadedAggregateRowGroups(uint32_t threadID)
               // aggregation with and without subtotals) fAggregator->hasRollup() is false.
               // In these cases we have full parallel processing as expected.
               uint64_t hash = fAggregator->hasRollup() ? 0 : rowgroup::hashRow(rowIn, hashLens[0] - 1);
-              int bucketID = hash % fNumOfBuckets;
+              int bucketID = rowgroup::hashToBucket(hash, fNumOfBuckets);
               rowBucketVecs[bucketID][0].emplace_back(rowIn.getPointer(), hash);
               rowIn.nextRow();
             }
@@ -5550,52 +5754,8 @@ void TupleAggregateStep::threadedAggregateRowGroups(uint32_t threadID)
         }
 
         // insert to the hashmaps owned by each aggregator
-        bool done = false;
-        fill(&bucketDone[0], &bucketDone[fNumOfBuckets], false);
-
-        while (!fEndOfResult && !done && !cancelled())
-        {
-          bool didWork = false;
-          done = true;
-
-          // each thread starts from its own bucket for better distribution
-          uint32_t shift = (rgVecShift++) % fNumOfBuckets;
-          for (uint32_t ci = 0; ci < fNumOfBuckets && !cancelled(); ci++)
-          {
-            uint32_t c = (ci + shift) % fNumOfBuckets;
-            if (!fEndOfResult && !bucketDone[c] && fAgg_mutex[c]->try_lock())
-            {
-              try
-              {
-                didWork = true;
-
-                if (multiDist)
-                  dynamic_cast<RowAggregationMultiDistinct*>(fAggregators[c].get())
-                      ->addRowGroup(&fRowGroupIns[threadID], rowBucketVecs[c]);
-                else
-                {
-                  fAggregators[c]->addRowGroup(&fRowGroupIns[threadID], rowBucketVecs[c][0]);
-                }
-              }
-              catch (...)
-              {
-                fAgg_mutex[c]->unlock();
-                throw;
-              }
-
-              rowBucketVecs[c][0].clear();
-              bucketDone[c] = true;
-              fAgg_mutex[c]->unlock();
-            }
-            else if (!bucketDone[c])
-            {
-              done = false;
-            }
-          }
-
-          if (!didWork)
-            usleep(1000);  // avoid using all CPU during busy wait
-        }
+        if (scattered)
+          insertIntoBuckets(nullptr);
 
         rgDatas.clear();
         fRm->returnMemory(fMemUsage[threadID], fSessionMemLimit);
@@ -5612,6 +5772,10 @@ void TupleAggregateStep::threadedAggregateRowGroups(uint32_t threadID)
           fMutex.unlock();
         }
       }
+
+      // the groups left in the pre-aggregation table
+      if (preAggregate && !fEndOfResult && !cancelled())
+        flushLocalAggregate();
     }  // try
     catch (...)
     {
@@ -5621,6 +5785,8 @@ void TupleAggregateStep::threadedAggregateRowGroups(uint32_t threadID)
       fEndOfResult = true;
       fDoneAggregate = true;
     }
+
+    fLocalAggregators[threadID].reset();
   }
 
   if (!locked)
@@ -5728,6 +5894,8 @@ uint64_t TupleAggregateStep::doThreadedAggregate(ByteStream& bs, RowGroupDL* dlp
      * Phase 1: Distribute input rows to different buckets depending on the hash value of the group by columns
      * per row. Then distribute buckets equally on aggregators in fAggregators. (Number of fAggregators ==
      * fNumOfBuckets). Each previously created hash bucket is represented as one RowGroup in a fAggregator.
+     * If the buckets can merge aggregated groups, every thread first aggregates into a table of its own and
+     * flushes the groups to the buckets when the table is full.
      */
 
     if (!fDoneAggregate)
@@ -5876,28 +6044,36 @@ uint64_t TupleAggregateStep::doThreadedAggregate(ByteStream& bs, RowGroupDL* dlp
     }
     // CASE 3: Query contains no aggregation on a DISTINCT column, but at least one GROUP BY column
     // e.g. SELECT SUM(col1) FROM test GROUP BY col2;
-    // Do aggregation over all row groups. As all row groups need to be aggregated together there is no
-    // easy way of multi-threading this and it's done in a single thread for now.
+    // Every bucket holds a disjoint set of groups, so the buckets are finalized and delivered
+    // independently, in parallel when there is an output data list.
     else if (hasGroupByColumns)
     {
-      if (!fEndOfResult && !fDoneAggregate)
+      if (!fEndOfResult && !fDoneAggregate && dlp)
       {
-        for (uint32_t bucketNum = 0; bucketNum < fNumOfBuckets; ++bucketNum)
+        vector<uint64_t> runners;
+        uint32_t threads = std::min(fNumOfThreads, fNumOfBuckets);
+        runners.reserve(threads);
+        fBucketNum = 0;
+
+        for (uint32_t threadNum = 0; threadNum < threads; ++threadNum)
         {
-          fAggregator->append(fAggregators[bucketNum].get());
+          runners.push_back(jobstepThreadPool.invoke(ThreadedAggregateOutput(this, threadNum, dlp)));
         }
+
+        jobstepThreadPool.join(runners);
+        fBucketNum = 0;
+        fDoneAggregate = true;
+        fEndOfResult = true;
       }
 
       fDoneAggregate = true;
       bool done = true;
 
-      while (fAggregator->nextRowGroup() && !cancelled())
+      while (!fEndOfResult && nextDeliveredRowGroup() && !cancelled())
       {
         done = false;
-        fAggregator->finalize();
         rowCount = fRowGroupOut.getRowCount();
         fRowsReturned += rowCount;
-        fRowGroupDelivered.setData(fRowGroupOut.getRGData());
 
         if (rowCount != 0)
         {
@@ -5978,12 +6154,17 @@ bool TupleAggregateStep::cleanUpAndOutputRowGroup(ByteStream& bs, RowGroupDL* dl
 
 void TupleAggregateStep::pruneAuxColumns()
 {
-  uint64_t rowCount = fRowGroupOut.getRowCount();
+  pruneAuxColumns(fRowGroupOut, fRowGroupDelivered);
+}
+
+void TupleAggregateStep::pruneAuxColumns(RowGroup& rowGroupOut, RowGroup& rowGroupDelivered)
+{
+  uint64_t rowCount = rowGroupOut.getRowCount();
   Row row1, row2;
-  fRowGroupOut.initRow(&row1);
-  fRowGroupOut.getRow(0, &row1);
-  fRowGroupDelivered.initRow(&row2);
-  fRowGroupDelivered.getRow(0, &row2);
+  rowGroupOut.initRow(&row1);
+  rowGroupOut.getRow(0, &row1);
+  rowGroupDelivered.initRow(&row2);
+  rowGroupDelivered.getRow(0, &row2);
 
   for (uint64_t i = 1; i < rowCount; i++)
   {
@@ -159,8 +159,10 @@ class TupleAggregateStep : public JobStep, public TupleDeliveryStep
   void threadedAggregateRowGroups(uint32_t threadID);
   void threadedAggregateFinalize(uint32_t threadID);
   void doThreadedSecondPhaseAggregate(uint32_t threadID);
+  void threadedAggregateOutput(uint32_t threadID, RowGroupDL* dlp);
   bool nextDeliveredRowGroup();
   void pruneAuxColumns();
+  static void pruneAuxColumns(rowgroup::RowGroup& rowGroupOut, rowgroup::RowGroup& rowGroupDelivered);
   bool cleanUpAndOutputRowGroup(messageqcpp::ByteStream& bs, RowGroupDL* dlp);
   void formatMiniStats();
   void printCalTrace();
@@ -247,6 +249,27 @@ class TupleAggregateStep : public JobStep, public TupleDeliveryStep
     uint32_t fThreadID;
   };
 
+  class ThreadedAggregateOutput
+  {
+   public:
+    ThreadedAggregateOutput(TupleAggregateStep* step, uint32_t threadID, RowGroupDL* dlp)
+     : fStep(step), fThreadID(threadID), fDlp(dlp)
+    {
+    }
+
+    void operator()()
+    {
+      std::string t{"TASThrOut"};
+      t.append(std::to_string(fThreadID));
+      utils::setThreadName(t.c_str());
+      fStep->threadedAggregateOutput(fThreadID, fDlp);
+    }
+
+    TupleAggregateStep* fStep;
+    uint32_t fThreadID;
+    RowGroupDL* fDlp;
+  };
+
   class ThreadedSecondPhaseAggregator
   {
    public:
@@ -276,12 +299,18 @@ class TupleAggregateStep : public JobStep, public TupleDeliveryStep
   uint32_t fBucketNum;
 
   boost::mutex fMutex;
+  boost::mutex fDlMutex;  // the output threads share the output data list
   std::vector<boost::mutex*> fAgg_mutex;
   std::vector<rowgroup::RGData> fRowGroupDatas;
   std::vector<rowgroup::SP_ROWAGG_UM_t> fAggregators;
   std::vector<rowgroup::RowGroup> fRowGroupIns;
   std::vector<rowgroup::RowGroup> fRowGroupOuts;
   std::vector<std::vector<rowgroup::RGData> > fRowGroupsDeliveredData;
+  // per thread pre-aggregation tables, flushed to the buckets by hash prefix
+  bool fPreAggregate = false;
+  std::vector<rowgroup::SP_ROWAGG_UM_t> fLocalAggregators;
+  std::vector<rowgroup::RowGroup> fLocalRowGroupOuts;
+  std::vector<rowgroup::RGData> fLocalRowGroupDatas;
   bool fIsMultiThread;
   int fInputIter;  // iterator
   boost::scoped_array<uint64_t> fMemUsage;
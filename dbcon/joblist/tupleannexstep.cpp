@@ -58,6 +58,7 @@ using namespace querytele;
 #include "jlf_common.h"
 #include "tupleconstantstep.h"
 #include "limitedorderby.h"
+#include "externalorderby.h"
 
 #include "tupleannexstep.h"
 
@@ -120,6 +121,7 @@ TupleAnnexStep::TupleAnnexStep(const JobInfo& jobInfo)
  , fDistinct(false)
  , fParallelOp(false)
  , fOrderBy(NULL)
+ , fExternalOrderBy(NULL)
  , fConstant(NULL)
  , fFeInstance(funcexp::FuncExp::instance())
  , fJobList(jobInfo.jobListPtr)
@@ -152,6 +154,9 @@ TupleAnnexStep::~TupleAnnexStep()
 
   fOrderBy = NULL;
 
+  delete fExternalOrderBy;
+  fExternalOrderBy = NULL;
+
   if (fConstant)
     delete fConstant;
 
@@ -189,6 +194,9 @@ void TupleAnnexStep::initialize(const RowGroup& rgIn, const JobInfo& jobInfo)
     }
   }
 
+  if (fExternalOrderBy)
+    fExternalOrderBy->initialize(rgIn, jobInfo, fParallelOp ? fMaxThreads : 1);
+
   if (fConstant == NULL)
   {
     vector<uint32_t> oids, oidsIn = rgIn.getOIDs();
@@ -346,7 +354,9 @@ uint32_t TupleAnnexStep::nextBand(messageqcpp::ByteStream& bs)
 
 void TupleAnnexStep::execute()
 {
-  if (fOrderBy)
+  if (fExternalOrderBy)
+    executeWithExternalOrderBy();
+  else if (fOrderBy)
     executeWithOrderBy();
   else if (fDistinct)
     executeNoOrderByWithDistinct();
@@ -374,7 +384,9 @@ void TupleAnnexStep::execute()
 
 void TupleAnnexStep::execute(uint32_t id)
 {
-  if (fOrderByList[id])
+  if (fExternalOrderBy)
+    executeParallelExternalOrderBy(id);
+  else if (fOrderByList[id])
     executeParallelOrderBy(id);
 }
 
@@ -637,54 +649,107 @@ void TupleAnnexStep::executeWithOrderBy()
     if (!cancelled())
     {
       while (fOrderBy->getData(rgDataIn))
-      {
-        if (fConstant == NULL && fRowGroupOut.getColumnCount() == fRowGroupIn.getColumnCount())
-        {
-          rgDataOut = rgDataIn;
-          fRowGroupOut.setData(&rgDataOut);
-        }
-        else
-        {
-          fRowGroupIn.setData(&rgDataIn);
-          fRowGroupIn.getRow(0, &fRowIn);
+        outputOrderedRGData(rgDataIn, rgDataOut);
+    }
+  }
+  catch (...)
+  {
+    handleException(std::current_exception(), logging::ERR_IN_PROCESS, logging::ERR_ALWAYS_CRITICAL,
+                    "TupleAnnexStep::executeWithOrderBy()");
+  }
 
-          rgDataOut.reinit(fRowGroupOut, fRowGroupIn.getRowCount());
-          fRowGroupOut.setData(&rgDataOut);
-          fRowGroupOut.resetRowGroup(fRowGroupIn.getBaseRid());
-          fRowGroupOut.setDBRoot(fRowGroupIn.getDBRoot());
-          fRowGroupOut.getRow(0, &fRowOut);
+  while (more)
+    more = fInputDL->next(fInputIterator, &rgDataIn);
 
-          for (uint64_t i = 0; i < fRowGroupIn.getRowCount(); ++i)
-          {
-            if (fConstant)
-              fConstant->fillInConstants(fRowIn, fRowOut);
-            else
-              copyRow(fRowIn, &fRowOut);
-
-            fRowGroupOut.incRowCount();
-            fRowOut.nextRow();
-            fRowIn.nextRow();
-          }
-        }
+  // Bug 3136, let mini stats to be formatted if traceOn.
+  fOutputDL->endOfInput();
+}
 
-        if (fRowGroupOut.getRowCount() > 0)
-        {
-          fRowsReturned += fRowGroupOut.getRowCount();
-          fOutputDL->insert(rgDataOut);
-        }
-      }
+// Maps a sorted RGData from the order by to the output RowGroup and sends it
+void TupleAnnexStep::outputOrderedRGData(RGData& rgDataIn, RGData& rgDataOut)
+{
+  if (fConstant == NULL && fRowGroupOut.getColumnCount() == fRowGroupIn.getColumnCount())
+  {
+    rgDataOut = rgDataIn;
+    fRowGroupOut.setData(&rgDataOut);
+  }
+  else
+  {
+    fRowGroupIn.setData(&rgDataIn);
+    fRowGroupIn.getRow(0, &fRowIn);
+
+    rgDataOut.reinit(fRowGroupOut, fRowGroupIn.getRowCount());
+    fRowGroupOut.setData(&rgDataOut);
+    fRowGroupOut.resetRowGroup(fRowGroupIn.getBaseRid());
+    fRowGroupOut.setDBRoot(fRowGroupIn.getDBRoot());
+    fRowGroupOut.getRow(0, &fRowOut);
+
+    for (uint64_t i = 0; i < fRowGroupIn.getRowCount(); ++i)
+    {
+      if (fConstant)
+        fConstant->fillInConstants(fRowIn, fRowOut);
+      else
+        copyRow(fRowIn, &fRowOut);
+
+      fRowGroupOut.incRowCount();
+      fRowOut.nextRow();
+      fRowIn.nextRow();
+    }
+  }
+
+  if (fRowGroupOut.getRowCount() > 0)
+  {
+    fRowsReturned += fRowGroupOut.getRowCount();
+    fOutputDL->insert(rgDataOut);
+  }
+}
+
+void TupleAnnexStep::executeWithExternalOrderBy()
+{
+  utils::setThreadName("TASwExtOrd");
+  RGData rgDataIn;
+  RGData rgDataOut;
+  bool more = false;
+
+  try
+  {
+    more = fInputDL->next(fInputIterator, &rgDataIn);
+
+    if (traceOn())
+      dlTimes.setFirstReadTime();
+
+    StepTeleStats sts;
+    sts.query_uuid = fQueryUuid;
+    sts.step_uuid = fStepUuid;
+    sts.msg_type = StepTeleStats::ST_START;
+    sts.total_units_of_work = 1;
+    postStepStartTele(sts);
+
+    while (more && !cancelled())
+    {
+      fExternalOrderBy->addRGData(0, rgDataIn);
+      more = fInputDL->next(fInputIterator, &rgDataIn);
+    }
+
+    fExternalOrderBy->endOfInput(0);
+
+    if (!cancelled())
+    {
+      fExternalOrderBy->finalize();
+
+      while (!cancelled() && fExternalOrderBy->getData(rgDataIn))
+        outputOrderedRGData(rgDataIn, rgDataOut);
     }
   }
   catch (...)
   {
     handleException(std::current_exception(), logging::ERR_IN_PROCESS, logging::ERR_ALWAYS_CRITICAL,
-                    "TupleAnnexStep::executeWithOrderBy()");
+                    "TupleAnnexStep::executeWithExternalOrderBy()");
   }
 
   while (more)
     more = fInputDL->next(fInputIterator, &rgDataIn);
 
-  // Bug 3136, let mini stats to be formatted if traceOn.
   fOutputDL->endOfInput();
 }
 
@@ -1170,6 +1235,102 @@ void TupleAnnexStep::executeParallelOrderBy(uint64_t id)
   }
 }
 
+/*
+    Every thread adds the RGData it takes from the input DL to
+    its own run of the ExternalOrderBy, the last thread to finish
+    merges the runs.
+*/
+void TupleAnnexStep::executeParallelExternalOrderBy(uint64_t id)
+{
+  utils::setThreadName("TASwParExtOrd");
+  RGData rgDataIn;
+  bool more = false;
+  uint64_t dlOffset = 0;
+
+  try
+  {
+    more = fInputDL->next(fInputIteratorsList[id], &rgDataIn);
+    if (more)
+      dlOffset++;
+
+    while (more && !cancelled())
+    {
+      if (dlOffset % fMaxThreads == id - 1)
+        fExternalOrderBy->addRGData(id - 1, rgDataIn);
+
+      more = fInputDL->next(fInputIteratorsList[id], &rgDataIn);
+      if (more)
+        dlOffset++;
+    }
+
+    fExternalOrderBy->endOfInput(id - 1);
+  }
+  catch (...)
+  {
+    handleException(std::current_exception(), logging::ERR_IN_PROCESS, logging::ERR_ALWAYS_CRITICAL,
+                    "TupleAnnexStep::executeParallelExternalOrderBy()");
+  }
+
+  // read out the input DL
+  while (more)
+    more = fInputDL->next(fInputIteratorsList[id], &rgDataIn);
+
+  fParallelFinalizeMutex.lock();
+  fFinishedThreads++;
+  if (fFinishedThreads == fMaxThreads)
+  {
+    fParallelFinalizeMutex.unlock();
+    finalizeParallelExternalOrderBy();
+  }
+  else
+  {
+    fParallelFinalizeMutex.unlock();
+  }
+}
+
+void TupleAnnexStep::finalizeParallelExternalOrderBy()
+{
+  utils::setThreadName("TASwParExtMerge");
+  RGData rgDataIn;
+  RGData rgDataOut;
+
+  try
+  {
+    if (!cancelled())
+    {
+      fExternalOrderBy->finalize();
+
+      while (!cancelled() && fExternalOrderBy->getData(rgDataIn))
+        outputOrderedRGData(rgDataIn, rgDataOut);
+    }
+  }
+  catch (...)
+  {
+    handleException(std::current_exception(), logging::ERR_IN_PROCESS, logging::ERR_ALWAYS_CRITICAL,
+                    "TupleAnnexStep::finalizeParallelExternalOrderBy()");
+  }
+
+  fOutputDL->endOfInput();
+
+  StepTeleStats sts;
+  sts.query_uuid = fQueryUuid;
+  sts.step_uuid = fStepUuid;
+  sts.msg_type = StepTeleStats::ST_SUMMARY;
+  sts.total_units_of_work = sts.units_of_work_completed = 1;
+  sts.rows = fRowsReturned;
+  postStepSummaryTele(sts);
+
+  if (traceOn())
+  {
+    if (dlTimes.FirstReadTime().tv_sec == 0)
+      dlTimes.setFirstReadTime();
+
+    dlTimes.setLastReadTime();
+    dlTimes.setEndOfInputTime();
+    printCalTrace();
+  }
+}
+
 const RowGroup& TupleAnnexStep::getOutputRowGroup() const
 {
   return fRowGroupOut;
@@ -1211,6 +1372,9 @@ const string TupleAnnexStep::toString() const
   if (fOrderBy)
     oss << "    " << fOrderBy->toString();
 
+  if (fExternalOrderBy)
+    oss << "    " << fExternalOrderBy->toString();
+
   if (fConstant)
     oss << "    " << fConstant->toString();
 
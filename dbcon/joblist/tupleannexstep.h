@@ -25,11 +25,13 @@
 
 #include "jobstep.h"
 #include "limitedorderby.h"
+#include "externalorderby.h"
 
 namespace joblist
 {
 class TupleConstantStep;
 class LimitedOrderBy;
+class ExternalOrderBy;
 }  // namespace joblist
 
 namespace joblist
@@ -73,6 +75,11 @@ class TupleAnnexStep : public JobStep, public TupleDeliveryStep
   {
     fOrderBy = lob;
   }
+  // ORDER BY without LIMIT, used instead of addOrderBy()
+  void addExternalOrderBy(ExternalOrderBy* eob)
+  {
+    fExternalOrderBy = eob;
+  }
   void addConstant(TupleConstantStep* tcs)
   {
     fConstant = tcs;
@@ -108,11 +115,15 @@ class TupleAnnexStep : public JobStep, public TupleDeliveryStep
   void executeNoOrderBy();
   void executeWithOrderBy();
   void executeParallelOrderBy(uint64_t id);
+  void executeWithExternalOrderBy();
+  void executeParallelExternalOrderBy(uint64_t id);
+  void outputOrderedRGData(rowgroup::RGData& rgDataIn, rowgroup::RGData& rgDataOut);
   void executeNoOrderByWithDistinct();
   void formatMiniStats();
   void printCalTrace();
   void finalizeParallelOrderBy();
   void finalizeParallelOrderByDistinct();
+  void finalizeParallelExternalOrderBy();
 
   // input/output rowgroup and row
   rowgroup::RowGroup fRowGroupIn;
@@ -162,6 +173,7 @@ class TupleAnnexStep : public JobStep, public TupleDeliveryStep
   bool fParallelOp;
 
   LimitedOrderBy* fOrderBy;
+  ExternalOrderBy* fExternalOrderBy;
   TupleConstantStep* fConstant;
 
   funcexp::FuncExp* fFeInstance;
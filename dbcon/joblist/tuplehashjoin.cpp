@@ -522,6 +522,26 @@ void TupleHashJoinStep::forwardCPData()
   }
 }
 
+/* The PM only joins the small sides it has, the rows for the UM joins are all sent
+   back.  The bloom filters of the UM joins let the PM drop most of the rows without a match. */
+void TupleHashJoinStep::forwardRuntimeFilters()
+{
+  for (uint32_t i = 0; i < tbpsJoiners.size(); i++)
+  {
+    const auto& joiner = tbpsJoiners[i];
+
+    if (!joiner->inUM() || !joiner->getBloomFilter())
+      continue;
+
+    uint32_t largeKeyCol = joiner->getLargeKeyColumns()[0];
+
+    if (fFunctionJoinKeys.find(largeRG.getKeys()[largeKeyCol]) != fFunctionJoinKeys.end())
+      continue;
+
+    largeBPS->addRuntimeFilter(largeRG.getOIDs()[largeKeyCol], joiner->getBloomFilter());
+  }
+}
+
 void TupleHashJoinStep::djsRelayFcn()
 {
   /*
@@ -931,6 +951,9 @@ void TupleHashJoinStep::hjRunner()
   // there is an in-mem UM or PM join
   if (largeBPS && !tbpsJoiners.empty())
   {
+    if (djs.empty())
+      forwardRuntimeFilters();
+
     largeBPS->useJoiners(tbpsJoiners);
 
     if (djs.size())
@@ -1762,6 +1785,14 @@ void TupleHashJoinStep::joinOneRG(
     // cout << "THJS: Large side row: " << largeSideRow.toString() << endl;
     matchCount = 0;
 
+    if (k % TupleJoiner::PrefetchBatchSize == 0)
+    {
+      uint32_t batchSize = std::min<uint32_t>(TupleJoiner::PrefetchBatchSize, inputRG.getRowCount() - k);
+
+      for (j = 0; j < smallSideCount; j++)
+        (*tjoiners)[j]->prefetchMatches(largeSideRow, batchSize);
+    }
+
     for (j = 0; j < smallSideCount; j++)
     {
       (*tjoiners)[j]->match(largeSideRow, k, threadID, &joinMatches[j]);
@@ -516,6 +516,9 @@ class TupleHashJoinStep : public JobStep, public TupleDeliveryStep
 
   /* Casual Partitioning forwarding */
   void forwardCPData();
+
+  /* Runtime join filter forwarding */
+  void forwardRuntimeFilters();
   uint32_t uniqueLimit;
 
   /* UM Join support.  Most of this code is ported from the UM join code in tuple-bps.cpp.
@@ -49,6 +49,7 @@ using namespace rowgroup;
 using namespace querytele;
 
 #include "funcexp.h"
+#include "batchevaluator.h"
 
 #include "jlf_common.h"
 #include "tuplehavingstep.h"
@@ -117,6 +118,8 @@ void TupleHavingStep::initialize(const RowGroup& rgIn, const JobInfo& jobInfo)
   fRowGroupOut =
       RowGroup(oids.size(), pos, oids, keys, types, csNums, scale, precision, jobInfo.stringTableThreshold);
   fRowGroupOut.initRow(&fRowOut);
+
+  fHavingFilter.reset(new funcexp::BatchEvaluator(fExpressionFilter));
 }
 
 void TupleHavingStep::expressionFilter(const ParseTree* filter, JobInfo& jobInfo)
@@ -316,19 +319,19 @@ void TupleHavingStep::execute()
 
 void TupleHavingStep::doHavingFilters()
 {
+  fRowGroupOut.resetRowGroup(fRowGroupIn.getBaseRid());
+
+  // the filter runs column-at-a-time and leaves only the passing rows in the input
+  fFeInstance->evaluate(fRowGroupIn, *fHavingFilter);
+
   fRowGroupIn.getRow(0, &fRowIn);
   fRowGroupOut.getRow(0, &fRowOut);
-  fRowGroupOut.resetRowGroup(fRowGroupIn.getBaseRid());
 
   for (uint64_t i = 0; i < fRowGroupIn.getRowCount(); ++i)
   {
-    if (fFeInstance->evaluate(fRowIn, fExpressionFilter))
-    {
-      copyRow(fRowIn, &fRowOut);
-      fRowGroupOut.incRowCount();
-      fRowOut.nextRow();
-    }
-
+    copyRow(fRowIn, &fRowOut);
+    fRowGroupOut.incRowCount();
+    fRowOut.nextRow();
     fRowIn.nextRow();
   }
 
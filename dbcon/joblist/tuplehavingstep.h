@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "jobstep.h"
 #include "expressionstep.h"
 #include "threadnaming.h"
@@ -29,6 +31,11 @@ namespace fucexp
 class FuncExp;
 }
 
+namespace funcexp
+{
+class BatchEvaluator;
+}
+
 namespace joblist
 {
 /** @brief class TupleHavingStep
@@ -111,6 +118,8 @@ class TupleHavingStep : public ExpressionStep, public TupleDeliveryStep
   bool fEndOfResult;
 
   funcexp::FuncExp* fFeInstance;
+  // the having filter compiled once, after the input indexes are set in initialize()
+  std::unique_ptr<funcexp::BatchEvaluator> fHavingFilter;
 };
 
 }  // namespace joblist
@@ -239,6 +239,22 @@ uint32_t WindowFunctionStep::nextBand(messageqcpp::ByteStream& bs)
   return rowCount;
 }
 
+void WindowFunctionStep::setInputRows(const RowGroup& rg, const vector<RGData>& rgData)
+{
+  fRowGroupIn = rg;
+  fRowGroupIn.initRow(&fRowIn);
+  fInRowGroupData = rgData;
+  fRows.clear();
+
+  for (uint64_t i = 0; i < fInRowGroupData.size(); i++)
+  {
+    fRowGroupIn.setData(&fInRowGroupData[i]);
+
+    for (uint64_t j = 0; j < fRowGroupIn.getRowCount(); j++)
+      fRows.push_back(RowPosition(i, j));
+  }
+}
+
 void WindowFunctionStep::setOutputRowGroup(const RowGroup& rg)
 {
   idbassert(0);
@@ -845,7 +861,8 @@ void WindowFunctionStep::initialize(const RowGroup& rg, JobInfo& jobInfo)
   if (jobInfo.trace)
     cout << "delivered RG: " << fRowGroupDelivered.toString() << endl << endl;
 
-  if (wfsUpdateStringTable > 1)
+  // the partitions of a function may also be computed in parallel
+  if (wfsUpdateStringTable > 1 || (wfsUpdateStringTable > 0 && fTotalThreads > 1))
     fUseSSMutex = true;
 
   if (wfsUserFunctionCount > 1)
@@ -947,6 +964,13 @@ void WindowFunctionStep::execute()
   // got something to work on
   try
   {
+    // The threads not needed to run the functions concurrently are split between them, to
+    // sort and compute the partitions of each function in parallel.
+    uint64_t functionThreads = max<uint64_t>(min(fTotalThreads, fFunctionCount), 1);
+
+    for (uint64_t i = 0; i < fFunctionCount; i++)
+      fFunctions[i]->threadCount(max<uint64_t>(fTotalThreads / functionThreads, 1));
+
     if (fFunctionCount == 1)
     {
       doFunction();
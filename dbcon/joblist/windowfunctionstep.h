@@ -96,6 +96,11 @@ class WindowFunctionStep : public JobStep, public TupleDeliveryStep
   static void checkWindowFunction(execplan::CalpontSelectExecutionPlan*, JobInfo&);
   static SJSTEP makeWindowFunctionStep(SJSTEP&, JobInfo&);
 
+  /** @brief take the input rows as they are instead of reading the input datalist,
+   *  so a WindowFunction can be run without a job, e.g. by the unit tests
+   */
+  void setInputRows(const rowgroup::RowGroup& rg, const std::vector<rowgroup::RGData>& rgData);
+
   // for WindowFunction and WindowFunctionWrapper callback
   const std::vector<RowPosition>& getRowData() const
   {
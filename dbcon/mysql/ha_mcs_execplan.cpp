@@ -5367,7 +5367,7 @@ ReturnedColumn* buildAggregateColumn(Item* item, gp_walk_info& gwi)
         // stored as an int32_t (see calpontsystemcatalog.h). However,
         // Item_sum::max_length is an uint32_t. This means there will be an
         // integer overflow when Item_sum::max_length > colWidth. This ultimately
-        // causes an array index out of bound in GroupConcator::swapStreamWithStringAndReturnBuf()
+        // causes an array index out of bound in GroupConcator::finishResult()
         // in groupconcat.cpp when ExeMgr processes groupconcat. As a temporary
         // fix, we cap off the max groupconcat length to std::numeric_limits<int32_t>::max().
         // The proper fix would be to change colWidth type to uint32_t.
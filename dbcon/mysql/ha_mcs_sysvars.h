@@ -33,7 +33,10 @@ enum mcs_compression_type_t
   NO_COMPRESSION = 0,
   SNAPPY = 2,
 #ifdef HAVE_LZ4
-  LZ4 = 3
+  LZ4 = 3,
+#endif
+#ifdef HAVE_ZSTD
+  ZSTD = 4,
 #endif
 };
 
@@ -74,11 +74,6 @@ class blockCacheClient
     fBCCBrp->check(range, ver, txn, compType, rCount);
   }
 
-  inline FileBuffer* getBlockPtr(const BRM::LBID_t& lbid, const BRM::VER_t& ver, bool flg)
-  {
-    return fBCCBrp->getBlockPtr(lbid, ver, flg);
-  }
-
   /**
    * @brief retrieve the Disk Block at lbid, ver from the Disk Block Buffer Cache
    **/
@@ -104,9 +99,9 @@ class blockCacheClient
   }
 
   inline int getCachedBlocks(const BRM::LBID_t* lbids, const BRM::VER_t* vers, uint8_t** bufferPtrs,
-                             bool* wasCached, uint32_t blockCount)
+                             bool* wasCached, uint32_t blockCount, SPEncodedBlock** encoded = NULL)
   {
-    return fBCCBrp->getCachedBlocks(lbids, vers, bufferPtrs, wasCached, blockCount);
+    return fBCCBrp->getCachedBlocks(lbids, vers, bufferPtrs, wasCached, blockCount, encoded);
   }
 
   inline bool exists(BRM::LBID_t lbid, BRM::VER_t ver)
@@ -0,0 +1,269 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <cerrno>
+#include <vector>
+
+#include "mcsconfig.h"
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+#include "IDBLogger.h"
+#include "blockreader.h"
+
+using namespace std;
+using namespace idbdatafile;
+
+namespace
+{
+// Reads what is left of r after an io_uring completion, or all of it.
+void preadRest(IDBDataFile* fp, dbbc::BlockReader::Request& r)
+{
+  while ((size_t)r.result < r.count)
+  {
+    ssize_t i = fp->pread((char*)r.buf + r.result, r.offset + r.result, r.count - r.result);
+
+    if (i < 0 && errno == EINTR)
+      continue;
+
+    if (i < 0)
+    {
+      r.err = errno;
+      r.result = -1;
+      return;
+    }
+
+    if (i == 0)
+      return;  // EOF
+
+    r.result += i;
+  }
+}
+
+}  // namespace
+
+namespace dbbc
+{
+BlockReader::BlockReader(uint32_t queueDepth, bool useUring) : fQueueDepth(max(queueDepth, 1U)), fRing(0)
+{
+#ifdef HAVE_LIBURING
+
+  if (useUring)
+  {
+    fRing = new io_uring;
+
+    if (io_uring_queue_init(fQueueDepth, fRing, 0) < 0)
+    {
+      delete fRing;
+      fRing = 0;
+    }
+  }
+
+#endif
+}
+
+BlockReader::~BlockReader()
+{
+  closeRing();
+}
+
+void BlockReader::closeRing()
+{
+#ifdef HAVE_LIBURING
+
+  if (fRing)
+  {
+    io_uring_queue_exit(fRing);
+    delete fRing;
+    fRing = 0;
+  }
+
+#endif
+}
+
+bool BlockReader::uringSupported()
+{
+#ifdef HAVE_LIBURING
+  // a kernel without io_uring, or with it disabled by sysctl, fails the setup
+  io_uring ring;
+
+  if (io_uring_queue_init(1, &ring, 0) < 0)
+    return false;
+
+  io_uring_queue_exit(&ring);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void BlockReader::read(IDBDataFile* fp, Request* requests, uint32_t count)
+{
+  uint32_t i;
+
+  for (i = 0; i < count; i++)
+  {
+    requests[i].result = 0;
+    requests[i].err = 0;
+  }
+
+  const int fd = (fRing ? fp->handle() : -1);
+
+  for (i = 0; fRing && fd >= 0 && i < count; i += fQueueDepth)
+    uringRead(fp, fd, &requests[i], min(fQueueDepth, count - i));
+
+  // short reads, failed completions and everything io_uring didn't take go through pread,
+  // which also reports the real errno of a failing read
+  for (i = 0; i < count; i++)
+    preadRest(fp, requests[i]);
+}
+
+// count is at most the queue depth, so the whole batch fits into the submission queue
+void BlockReader::uringRead(IDBDataFile* fp, int fd, Request* requests, uint32_t count)
+{
+#ifdef HAVE_LIBURING
+  uint32_t i, accepted, pending;
+  int rc = 0;
+  io_uring_cqe* cqe;
+
+  for (i = 0; i < count; i++)
+  {
+    io_uring_sqe* sqe = io_uring_get_sqe(fRing);
+
+    if (!sqe)
+      break;
+
+    io_uring_prep_read(sqe, fd, requests[i].buf, requests[i].count, requests[i].offset);
+    io_uring_sqe_set_data(sqe, &requests[i]);
+  }
+
+  while (io_uring_sq_ready(fRing) > 0)
+  {
+    rc = io_uring_submit(fRing);
+
+    if (rc < 0 && rc != -EINTR)
+      break;
+  }
+
+  // Entries the kernel never took are abandoned together with the ring below. Without SQPOLL
+  // nothing reads the submission queue unless we enter the kernel, so they can't run later.
+  accepted = i - io_uring_sq_ready(fRing);
+  pending = accepted;
+  vector<bool> inFlight(count, false);
+
+  for (i = 0; i < accepted; i++)
+    inFlight[i] = true;
+
+  // cancel requests carry no data, their completions are only consumed
+  auto reap = [&](io_uring_cqe* c)
+  {
+    Request* r = static_cast<Request*>(io_uring_cqe_get_data(c));
+
+    if (r && inFlight[r - requests])
+    {
+      inFlight[r - requests] = false;
+      pending--;
+
+      // failed and cancelled completions are left at 0 bytes and retried by pread
+      if (c->res > 0)
+        r->result = c->res;
+
+      if (IDBLogger::isEnabled())
+        IDBLogger::logRW("uring_read", fp->name(), fp, r->offset, r->count, c->res);
+    }
+
+    io_uring_cqe_seen(fRing, c);
+  };
+
+  while (pending > 0)
+  {
+    rc = io_uring_wait_cqe(fRing, &cqe);
+
+    if (rc == -EINTR)
+      continue;
+
+    if (rc < 0)
+      break;
+
+    reap(cqe);
+  }
+
+  const bool broken = (pending > 0 || accepted < count);
+
+  if (pending > 0)
+  {
+    // The kernel may still be reading into the buffers of the requests we stopped waiting for.
+    // Cancel them and collect every one of their completions before pread reuses the buffers
+    // or the ring is torn down.
+    for (i = 0; i < count; i++)
+    {
+      if (!inFlight[i])
+        continue;
+
+      io_uring_sqe* sqe = io_uring_get_sqe(fRing);
+
+      if (!sqe)
+        break;
+
+      io_uring_prep_cancel(sqe, &requests[i], 0);
+      io_uring_sqe_set_data(sqe, 0);
+    }
+
+    while (io_uring_sq_ready(fRing) > 0)
+    {
+      rc = io_uring_submit(fRing);
+
+      if (rc < 0 && rc != -EINTR)
+        break;
+    }
+
+    while (pending > 0)
+    {
+      rc = io_uring_wait_cqe(fRing, &cqe);
+
+      if (rc == -EINTR || rc == -EAGAIN)
+        continue;
+
+      if (rc < 0)
+        break;
+
+      reap(cqe);
+    }
+
+    // Nothing tells us when the kernel is done with these buffers, so fail the requests
+    // rather than let pread write into them.
+    for (i = 0; pending > 0 && i < count; i++)
+    {
+      if (inFlight[i])
+      {
+        requests[i].result = -1;
+        requests[i].err = -rc;
+      }
+    }
+  }
+
+  // the ring is broken, this reader uses pread from now on
+  if (broken)
+    closeRing();
+
+#endif
+}
+
+}  // namespace dbbc
@@ -0,0 +1,91 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "IDBDataFile.h"
+
+struct io_uring;
+
+namespace dbbc
+{
+/**
+ * @brief Reads a batch of ranges of one file for an ioManager reader thread.
+ *
+ * When the engine is built with liburing, io_uring is asked for, and the kernel supports it, the
+ * whole batch goes to the kernel in one submission so the device sees all of it at once.
+ * Otherwise, for files without a kernel fd (see IDBDataFile::handle()), and for whatever
+ * io_uring could not finish, the ranges are read with IDBDataFile::pread().
+ *
+ * An instance owns its ring and must only be used by one thread.
+ **/
+class BlockReader
+{
+ public:
+  struct Request
+  {
+    void* buf;
+    off64_t offset;
+    size_t count;
+    ssize_t result;  // bytes read, less than count on EOF, -1 on error
+    int err;         // the errno when result is -1
+  };
+
+  /**
+   * @brief ctor. Falls back to pread if useUring is false or the ring can't be set up.
+   **/
+  BlockReader(uint32_t queueDepth, bool useUring);
+  ~BlockReader();
+
+  /**
+   * @brief read every request of the batch completely, retrying short reads
+   **/
+  void read(idbdatafile::IDBDataFile* fp, Request* requests, uint32_t count);
+
+  bool usingUring() const
+  {
+    return fRing != 0;
+  }
+
+  uint32_t queueDepth() const
+  {
+    return fQueueDepth;
+  }
+
+  /**
+   * @brief true if this build has io_uring support and the running kernel allows it
+   **/
+  static bool uringSupported();
+
+ private:
+  void uringRead(idbdatafile::IDBDataFile* fp, int fd, Request* requests, uint32_t count);
+  void closeRing();
+
+  uint32_t fQueueDepth;
+  io_uring* fRing;
+
+  // do not implement
+  BlockReader(const BlockReader&);
+  BlockReader& operator=(const BlockReader&);
+};
+
+}  // namespace dbbc
@@ -234,9 +234,9 @@ int BlockRequestProcessor::getBlock(const BRM::LBID_t& lbid, const BRM::QueryCon
 }
 
 int BlockRequestProcessor::getCachedBlocks(const BRM::LBID_t* lbids, const BRM::VER_t* vers, uint8_t** ptrs,
-                                           bool* wasCached, uint32_t count)
+                                           bool* wasCached, uint32_t count, SPEncodedBlock** encoded)
 {
-  return fbMgr.bulkFind(lbids, vers, ptrs, wasCached, count);
+  return fbMgr.bulkFind(lbids, vers, ptrs, wasCached, count, encoded);
 }
 
 }  // namespace dbbc
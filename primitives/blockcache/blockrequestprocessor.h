@@ -82,11 +82,6 @@ class BlockRequestProcessor
   /**
    * @brief retrieve the lbid@ver disk block from the block cache
    **/
-  inline FileBuffer* getBlockPtr(const BRM::LBID_t lbid, const BRM::VER_t ver, bool flg)
-  {
-    return fbMgr.findPtr(HashObject_t(lbid, ver, flg));
-  }
-
   inline int read(const BRM::LBID_t& lbid, const BRM::VER_t& ver, FileBuffer& fb)
   {
     return (fbMgr.find(HashObject_t(lbid, ver, 0), fb) ? 1 : 0);
@@ -105,7 +100,7 @@ class BlockRequestProcessor
                bool readFromCache);
 
   int getCachedBlocks(const BRM::LBID_t* lbids, const BRM::VER_t* vers, uint8_t** ptrs, bool* wasCached,
-                      uint32_t count);
+                      uint32_t count, SPEncodedBlock** encoded = NULL);
 
   inline bool exists(BRM::LBID_t lbid, BRM::VER_t ver)
   {
@@ -163,6 +158,16 @@ class BlockRequestProcessor
     return fbMgr.formatLRUList(os);
   }
 
+  /**
+   * @brief print the hit rate, hit latency and lock contention of every cache shard
+   **/
+  std::ostream& formatCacheStats(std::ostream& os) const
+  {
+    std::vector<CacheShardStats> stats;
+    fbMgr.getShardStats(stats);
+    return formatCacheShardStats(os, stats);
+  }
+
  private:
   FileBufferMgr fbMgr;
   fileBlockRequestQueue fBRPRequestQueue;
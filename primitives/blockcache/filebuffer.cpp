@@ -28,10 +28,28 @@
 #include <string>
 #include <iostream>
 
+#include "columnencoding.h"
+
 using namespace std;
 
 namespace dbbc
 {
+SPEncodedBlock encodeBlock(const uint8_t* data, uint32_t colWidth)
+{
+  shared_ptr<EncodedBlock> ret(new EncodedBlock());
+  ret->words.resize((compress::ColumnEncoding::maxEncodedSize(BLOCK_SIZE) + 7) / 8);
+  ret->len = compress::ColumnEncoding::encode(reinterpret_cast<const char*>(data), BLOCK_SIZE, colWidth,
+                                              reinterpret_cast<char*>(ret->words.data()),
+                                              ret->words.size() * 8);
+
+  if (ret->len == 0)
+    return SPEncodedBlock();
+
+  ret->words.resize((ret->len + 7) / 8);
+  ret->words.shrink_to_fit();
+  return ret;
+}
+
 FileBuffer::FileBuffer() : fDataLen(0), fLbid(-1), fVerid(0)
 {
 }
@@ -47,8 +65,8 @@ FileBuffer::FileBuffer(const FileBuffer& rhs)
   fLbid = rhs.fLbid;
   fVerid = rhs.fVerid;
   setData(rhs.fByteData, rhs.fDataLen);
-  fListLoc = rhs.listLoc();
   fDataLen = rhs.fDataLen;
+  fEncoded = rhs.fEncoded;
 }
 
 FileBuffer::FileBuffer(const BRM::LBID_t lbid, const BRM::VER_t ver, const uint8_t* data, const uint32_t len)
@@ -68,11 +86,14 @@ FileBuffer::FileBuffer(const BRM::LBID_t lbid, const BRM::VER_t ver)
 
 FileBuffer& FileBuffer::operator=(const FileBuffer& rhs)
 {
+  if (this == &rhs)
+    return *this;
+
   fLbid = rhs.fLbid;
   fVerid = rhs.fVerid;
   fDataLen = rhs.fDataLen;
   setData(rhs.fByteData, fDataLen);
-  fListLoc = rhs.listLoc();
+  fEncoded = rhs.fEncoded;
   return *this;
 }
 
@@ -83,12 +104,14 @@ void FileBuffer::setData(const uint8_t* d, const int len)
 
   fDataLen = len;
   memcpy(fByteData, d, len);
+  fEncoded.reset();
 }
 
 void FileBuffer::setData(const uint8_t* d)
 {
   fDataLen = 8192;
   memcpy(fByteData, d, 8192);
+  fEncoded.reset();
 }
 
 FileBuffer::~FileBuffer()
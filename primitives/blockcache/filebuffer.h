@@ -32,7 +32,7 @@
 #include <stdint.h>
 #include <time.h>
 #include "brmtypes.h"
-#include <list>
+#include <memory>
 #include <vector>
 #include "blocksize.h"
 
@@ -45,16 +45,29 @@
  **/
 namespace dbbc
 {
-typedef struct FBData
+/**
+ * @brief the ColumnEncoding form of a cached block
+ *
+ * Blocks read from a chunk cpimport stored encoded keep an encoded copy next to the
+ * decoded one, so a scan can evaluate its filter on the encoded values.
+ **/
+struct EncodedBlock
 {
-  BRM::LBID_t lbid;
-  BRM::VER_t ver;
-  uint8_t hits;
-} FBData_t;
+  std::vector<uint64_t> words;  // an encoded buffer must be 8 byte aligned
+  size_t len;
+
+  const char* data() const
+  {
+    return reinterpret_cast<const char*>(words.data());
+  }
+};
 
-//@bug 669 Change to list for least recently used cache
-typedef std::list<FBData_t> filebuffer_list_t;
-typedef std::list<FBData_t>::iterator filebuffer_list_iter_t;
+typedef std::shared_ptr<const EncodedBlock> SPEncodedBlock;
+
+/**
+ * @brief encodes a decoded block of colWidth wide values, null if the encoding doesn't pay
+ **/
+SPEncodedBlock encodeBlock(const uint8_t* data, uint32_t colWidth);
 
 class FileBuffer
 {
@@ -103,6 +116,18 @@ class FileBuffer
     return fDataLen;
   }
 
+  /**
+   * @brief the encoded copy of the data, null if there is none. setData() drops it.
+   **/
+  inline const SPEncodedBlock& encoded() const
+  {
+    return fEncoded;
+  }
+  inline void encoded(const SPEncodedBlock& e)
+  {
+    fEncoded = e;
+  }
+
   /**
    * @brief assignment operator
    **/
@@ -152,26 +177,12 @@ class FileBuffer
     fVerid = v;
   }
 
-  /**
-   * @brief return the number of bytes in this disk blockrequest
-   **/
-
-  inline void listLoc(const filebuffer_list_iter_t& loc)
-  {
-    fListLoc = loc;
-  }
-
-  inline const filebuffer_list_iter_t& listLoc() const
-  {
-    return fListLoc;
-  }
-
  private:
   uint8_t fByteData[BLOCK_SIZE];
   uint32_t fDataLen;
   BRM::LBID_t fLbid;
   BRM::VER_t fVerid;
-  filebuffer_list_iter_t fListLoc;
+  SPEncodedBlock fEncoded;
 };
 
 typedef std::vector<FileBuffer> FileBufferPool_t;
@@ -30,6 +30,7 @@
 **/
 
 //#define NDEBUG
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <boost/thread.hpp>
@@ -50,6 +51,17 @@ extern dbbc::Stats* gPMStatsPtr;
 extern bool gPMProfOn;
 extern uint32_t gSession;
 
+namespace
+{
+inline uint64_t nanosSince(const struct timespec& start)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start.tv_sec) * 1000000000ULL + now.tv_nsec - start.tv_nsec;
+}
+
+}  // namespace
+
 namespace dbbc
 {
 const uint32_t gReportingFrequencyMin(32768);
@@ -57,17 +69,51 @@ const uint32_t gReportingFrequencyMin(32768);
 FileBufferMgr::FileBufferMgr(const uint32_t numBlcks, const uint32_t blkSz, const uint32_t deleteBlocks)
  : fMaxNumBlocks(numBlcks)
  , fBlockSz(blkSz)
- , fWLock()
- , fbSet()
- , fbList()
- , fCacheSize(0)
- , fFBPool()
+ , fShardCount(1)
  , fDeleteBlocks(deleteBlocks)
- , fEmptyPoolSlots()
+ , fBlksLoaded(0)
+ , fBlksNotUsed(0)
  , fReportFrequency(0)
 {
-  fFBPool.reserve(numBlcks);
   fConfig = Config::makeConfig();
+
+  const string val = fConfig->getConfig("DBBC", "NumCacheShards");
+  uint32_t shards = 0;
+
+  if (val.length() > 0)
+    shards = static_cast<uint32_t>(Config::fromText(val));
+
+  if (shards == 0)
+    shards = boost::thread::hardware_concurrency();
+
+  while (fShardCount < shards && fShardCount < MaxShards &&
+         (uint64_t)fShardCount * 2 * MinShardBlocks <= numBlcks)
+    fShardCount <<= 1;
+
+  fShards.reset(new Shard[fShardCount]);
+
+  for (uint32_t i = 0; i < fShardCount; i++)
+  {
+    Shard& shard = fShards[i];
+
+    shard.capacity = numBlcks / fShardCount + (i < numBlcks % fShardCount ? 1 : 0);
+    shard.deleteBlocks = deleteBlocks / fShardCount + (i < deleteBlocks % fShardCount ? 1 : 0);
+    shard.hand = 0;
+    shard.fbPool.reserve(shard.capacity);
+    shard.slotState.reset(new std::atomic<uint8_t>[shard.capacity]);
+
+    for (uint32_t j = 0; j < shard.capacity; j++)
+      shard.slotState[j].store(0, std::memory_order_relaxed);
+
+    shard.hits = 0;
+    shard.misses = 0;
+    shard.inserts = 0;
+    shard.evictions = 0;
+    shard.lockWaits = 0;
+    shard.timedHits = 0;
+    shard.hitNanos = 0;
+  }
+
   setReportingFrequency(0);
   fLog.open(string(MCSLOGDIR) + "/trace/bc", ios_base::app | ios_base::ate);
 }
@@ -98,61 +144,107 @@ void FileBufferMgr::setReportingFrequency(const uint32_t d)
     fReportFrequency = temp;
 }
 
+// Count the lock acquisitions that had to wait, that's the contention a shard sees.
+boost::shared_lock<boost::shared_mutex> FileBufferMgr::readLock(const Shard& shard) const
+{
+  boost::shared_lock<boost::shared_mutex> lk(shard.lock, boost::try_to_lock);
+
+  if (!lk.owns_lock())
+  {
+    shard.lockWaits.fetch_add(1, std::memory_order_relaxed);
+    lk.lock();
+  }
+
+  return lk;
+}
+
+boost::unique_lock<boost::shared_mutex> FileBufferMgr::writeLock(Shard& shard)
+{
+  boost::unique_lock<boost::shared_mutex> lk(shard.lock, boost::try_to_lock);
+
+  if (!lk.owns_lock())
+  {
+    shard.lockWaits.fetch_add(1, std::memory_order_relaxed);
+    lk.lock();
+  }
+
+  return lk;
+}
+
+uint32_t FileBufferMgr::size() const
+{
+  uint32_t ret = 0;
+
+  for (uint32_t i = 0; i < fShardCount; i++)
+  {
+    boost::shared_lock<boost::shared_mutex> lk(fShards[i].lock);
+    ret += fShards[i].fbSet.size();
+  }
+
+  return ret;
+}
+
 void FileBufferMgr::flushCache()
 {
-  boost::mutex::scoped_lock lk(fWLock);
+  for (uint32_t i = 0; i < fShardCount; i++)
   {
-    filebuffer_uset_t sEmpty;
-    filebuffer_list_t lEmpty;
-    emptylist_t vEmpty;
+    Shard& shard = fShards[i];
+    boost::unique_lock<boost::shared_mutex> lk(writeLock(shard));
+    {
+      filebuffer_uset_t sEmpty;
+      emptylist_t vEmpty;
+
+      shard.fbSet.swap(sEmpty);
+      shard.emptyPoolSlots.swap(vEmpty);
+    }
+
+    for (uint32_t j = 0; j < shard.fbPool.size(); j++)
+      shard.slotState[j].store(0, std::memory_order_relaxed);
 
-    fbList.swap(lEmpty);
-    fbSet.swap(sEmpty);
-    fEmptyPoolSlots.swap(vEmpty);
+    shard.hand = 0;
+
+    // clear() keeps the reserved block pool memory, which allows us
+    // to continue doing concurrent unprotected-but-"safe" memcpys
+    // from that memory
+    shard.fbPool.clear();
   }
-  fCacheSize = 0;
 
-  // the block pool should not be freed in the above block to allow us
-  // to continue doing concurrent unprotected-but-"safe" memcpys
-  // from that memory
   if (fReportFrequency)
   {
+    boost::mutex::scoped_lock lk(fLogLock);
     fLog << "Clearing entire cache" << endl;
   }
-  fFBPool.clear();
-  //	fFBPool.reserve(fMaxNumBlocks);
+}
+
+void FileBufferMgr::removeBlock(Shard& shard, filebuffer_uset_iter_t iter)
+{
+  const uint32_t idx = iter->poolIdx;
+
+  shard.slotState[idx].store(0, std::memory_order_relaxed);
+  shard.fbPool[idx].encoded(SPEncodedBlock());
+  shard.emptyPoolSlots.push_back(idx);
+  shard.fbSet.erase(iter);
 }
 
 void FileBufferMgr::flushOne(const BRM::LBID_t lbid, const BRM::VER_t ver)
 {
-  // similar in function to depleteCache()
-  boost::mutex::scoped_lock lk(fWLock);
+  Shard& shard = shardOf(lbid);
+  boost::unique_lock<boost::shared_mutex> lk(writeLock(shard));
 
-  filebuffer_uset_iter_t iter = fbSet.find(HashObject_t(lbid, ver, 0));
+  filebuffer_uset_iter_t iter = shard.fbSet.find(HashObject_t(lbid, ver, 0));
 
-  if (iter != fbSet.end())
-  {
-    // remove it from fbList
-    uint32_t idx = iter->poolIdx;
-    fbList.erase(fFBPool[idx].listLoc());
-    // add to fEmptyPoolSlots
-    fEmptyPoolSlots.push_back(idx);
-    // remove it from fbSet
-    fbSet.erase(iter);
-    // adjust fCacheSize
-    fCacheSize--;
-  }
+  if (iter != shard.fbSet.end())
+    removeBlock(shard, iter);
 }
 
 void FileBufferMgr::flushMany(const LbidAtVer* laVptr, uint32_t cnt)
 {
-  boost::mutex::scoped_lock lk(fWLock);
-
   BRM::LBID_t lbid;
   BRM::VER_t ver;
   filebuffer_uset_iter_t iter;
   if (fReportFrequency)
   {
+    boost::mutex::scoped_lock lk(fLogLock);
     fLog << "flushMany " << cnt << " items: ";
     for (uint32_t j = 0; j < cnt; j++)
     {
@@ -164,23 +256,18 @@ void FileBufferMgr::flushMany(const LbidAtVer* laVptr, uint32_t cnt)
   {
     lbid = static_cast<BRM::LBID_t>(laVptr->LBID);
     ver = static_cast<BRM::VER_t>(laVptr->Ver);
-    iter = fbSet.find(HashObject_t(lbid, ver, 0));
+    Shard& shard = shardOf(lbid);
+    boost::unique_lock<boost::shared_mutex> lk(writeLock(shard));
+    iter = shard.fbSet.find(HashObject_t(lbid, ver, 0));
 
-    if (iter != fbSet.end())
+    if (iter != shard.fbSet.end())
     {
       if (fReportFrequency)
       {
+        boost::mutex::scoped_lock logLk(fLogLock);
         fLog << "flushMany hit, lbid: " << lbid << " index: " << iter->poolIdx << endl;
       }
-      // remove it from fbList
-      uint32_t idx = iter->poolIdx;
-      fbList.erase(fFBPool[idx].listLoc());
-      // add to fEmptyPoolSlots
-      fEmptyPoolSlots.push_back(idx);
-      // remove it from fbSet
-      fbSet.erase(iter);
-      // adjust fCacheSize
-      fCacheSize--;
+      removeBlock(shard, iter);
     }
 
     ++laVptr;
@@ -191,12 +278,10 @@ void FileBufferMgr::flushManyAllversion(const LBID_t* laVptr, uint32_t cnt)
 {
   filebuffer_uset_t::iterator it, tmpIt;
   tr1::unordered_set<LBID_t> uniquer;
-  tr1::unordered_set<LBID_t>::iterator uit;
-
-  boost::mutex::scoped_lock lk(fWLock);
 
   if (fReportFrequency)
   {
+    boost::mutex::scoped_lock lk(fLogLock);
     fLog << "flushManyAllversion " << cnt << " items: ";
     for (uint32_t i = 0; i < cnt; i++)
     {
@@ -205,30 +290,33 @@ void FileBufferMgr::flushManyAllversion(const LBID_t* laVptr, uint32_t cnt)
     fLog << endl;
   }
 
-  if (fCacheSize == 0 || cnt == 0)
+  if (cnt == 0)
     return;
 
   for (uint32_t i = 0; i < cnt; i++)
     uniquer.insert(laVptr[i]);
 
-  for (it = fbSet.begin(); it != fbSet.end();)
+  for (uint32_t i = 0; i < fShardCount; i++)
   {
-    if (uniquer.find(it->lbid) != uniquer.end())
+    Shard& shard = fShards[i];
+    boost::unique_lock<boost::shared_mutex> lk(writeLock(shard));
+
+    for (it = shard.fbSet.begin(); it != shard.fbSet.end();)
     {
-      if (fReportFrequency)
+      if (uniquer.find(it->lbid) != uniquer.end())
       {
-        fLog << "flushManyAllversion hit: " << it->lbid << " index: " << it->poolIdx << endl;
+        if (fReportFrequency)
+        {
+          boost::mutex::scoped_lock logLk(fLogLock);
+          fLog << "flushManyAllversion hit: " << it->lbid << " index: " << it->poolIdx << endl;
+        }
+        tmpIt = it;
+        ++it;
+        removeBlock(shard, tmpIt);
       }
-      const uint32_t idx = it->poolIdx;
-      fbList.erase(fFBPool[idx].listLoc());
-      fEmptyPoolSlots.push_back(idx);
-      tmpIt = it;
-      ++it;
-      fbSet.erase(tmpIt);
-      fCacheSize--;
+      else
+        ++it;
     }
-    else
-      ++it;
   }
 }
 
@@ -239,14 +327,11 @@ void FileBufferMgr::flushOIDs(const uint32_t* oids, uint32_t count)
   vector<EMEntry> extents;
   int err;
   uint32_t currentExtent;
-  LBID_t currentLBID;
-  typedef tr1::unordered_multimap<LBID_t, filebuffer_uset_t::iterator> byLBID_t;
-  byLBID_t byLBID;
-  pair<byLBID_t::iterator, byLBID_t::iterator> itList;
-  filebuffer_uset_t::iterator it;
+  lbid_ranges_t ranges;
 
   if (fReportFrequency)
   {
+    boost::mutex::scoped_lock lk(fLogLock);
     fLog << "flushOIDs " << count << " items: ";
     for (uint32_t i = 0; i < count; i++)
     {
@@ -258,15 +343,10 @@ void FileBufferMgr::flushOIDs(const uint32_t* oids, uint32_t count)
   // If there are more than this # of extents to drop, the whole cache will be cleared
   const uint32_t clearThreshold = 50000;
 
-  boost::mutex::scoped_lock lk(fWLock);
-
-  if (fCacheSize == 0 || count == 0)
+  if (count == 0 || size() == 0)
     return;
 
-  /* Index the cache by LBID */
-  for (it = fbSet.begin(); it != fbSet.end(); it++)
-    byLBID.insert(pair<LBID_t, filebuffer_uset_t::iterator>(it->lbid, it));
-
+  // The extent lookups are done before any shard is locked
   for (i = 0; i < count; i++)
   {
     extents.clear();
@@ -275,7 +355,6 @@ void FileBufferMgr::flushOIDs(const uint32_t* oids, uint32_t count)
     if (err < 0 || (i == 0 && (extents.size() * count) > clearThreshold))
     {
       // (The i == 0 should ensure it's not a dictionary column)
-      lk.unlock();
       flushCache();
       return;
     }
@@ -283,22 +362,11 @@ void FileBufferMgr::flushOIDs(const uint32_t* oids, uint32_t count)
     for (currentExtent = 0; currentExtent < extents.size(); currentExtent++)
     {
       EMEntry& range = extents[currentExtent];
-      LBID_t lastLBID = range.range.start + (range.range.size * 1024);
-
-      for (currentLBID = range.range.start; currentLBID < lastLBID; currentLBID++)
-      {
-        itList = byLBID.equal_range(currentLBID);
-
-        for (byLBID_t::iterator tmpIt = itList.first; tmpIt != itList.second; tmpIt++)
-        {
-          fbList.erase(fFBPool[tmpIt->second->poolIdx].listLoc());
-          fEmptyPoolSlots.push_back(tmpIt->second->poolIdx);
-          fbSet.erase(tmpIt->second);
-          fCacheSize--;
-        }
-      }
+      ranges.push_back(make_pair(range.range.start, range.range.start + (range.range.size * 1024)));
     }
   }
+
+  flushRanges(ranges);
 }
 
 void FileBufferMgr::flushPartition(const vector<OID_t>& oids, const set<BRM::LogicalPartition>& partitions)
@@ -308,17 +376,12 @@ void FileBufferMgr::flushPartition(const vector<OID_t>& oids, const set<BRM::Log
   vector<EMEntry> extents;
   int err;
   uint32_t currentExtent;
-  LBID_t currentLBID;
-  typedef tr1::unordered_multimap<LBID_t, filebuffer_uset_t::iterator> byLBID_t;
-  byLBID_t byLBID;
-  pair<byLBID_t::iterator, byLBID_t::iterator> itList;
-  filebuffer_uset_t::iterator it;
+  lbid_ranges_t ranges;
   uint32_t count = oids.size();
 
-  boost::mutex::scoped_lock lk(fWLock);
-
   if (fReportFrequency)
   {
+    boost::mutex::scoped_lock lk(fLogLock);
     std::set<BRM::LogicalPartition>::iterator sit;
     fLog << "flushPartition oids: ";
     for (uint32_t i = 0; i < count; i++)
@@ -333,13 +396,9 @@ void FileBufferMgr::flushPartition(const vector<OID_t>& oids, const set<BRM::Log
     fLog << endl;
   }
 
-  if (fCacheSize == 0 || oids.size() == 0 || partitions.size() == 0)
+  if (oids.size() == 0 || partitions.size() == 0 || size() == 0)
     return;
 
-  /* Index the cache by LBID */
-  for (it = fbSet.begin(); it != fbSet.end(); it++)
-    byLBID.insert(pair<LBID_t, filebuffer_uset_t::iterator>(it->lbid, it));
-
   for (i = 0; i < count; i++)
   {
     extents.clear();
@@ -347,7 +406,6 @@ void FileBufferMgr::flushPartition(const vector<OID_t>& oids, const set<BRM::Log
 
     if (err < 0)
     {
-      lk.unlock();
       flushCache();  // better than returning an error code to the user
       return;
     }
@@ -361,20 +419,53 @@ void FileBufferMgr::flushPartition(const vector<OID_t>& oids, const set<BRM::Log
       if (partitions.find(logicalPartNum) == partitions.end())
         continue;
 
-      LBID_t lastLBID = range.range.start + (range.range.size * 1024);
+      ranges.push_back(make_pair(range.range.start, range.range.start + (range.range.size * 1024)));
+    }
+  }
 
-      for (currentLBID = range.range.start; currentLBID < lastLBID; currentLBID++)
-      {
-        itList = byLBID.equal_range(currentLBID);
+  flushRanges(ranges);
+}
 
-        for (byLBID_t::iterator tmpIt = itList.first; tmpIt != itList.second; tmpIt++)
-        {
-          fbList.erase(fFBPool[tmpIt->second->poolIdx].listLoc());
-          fEmptyPoolSlots.push_back(tmpIt->second->poolIdx);
-          fbSet.erase(tmpIt->second);
-          fCacheSize--;
-        }
+// drops every cached version of the LBIDs in the [first, second) ranges
+void FileBufferMgr::flushRanges(lbid_ranges_t& ranges)
+{
+  filebuffer_uset_t::iterator it, tmpIt;
+  lbid_ranges_t::const_iterator rit;
+  uint32_t i, last = 0;
+
+  if (ranges.empty())
+    return;
+
+  // merge the overlapping ranges, then an LBID can only be in the last range starting at or before it
+  sort(ranges.begin(), ranges.end());
+
+  for (i = 1; i < ranges.size(); i++)
+  {
+    if (ranges[i].first <= ranges[last].second)
+      ranges[last].second = max(ranges[last].second, ranges[i].second);
+    else
+      ranges[++last] = ranges[i];
+  }
+
+  ranges.resize(last + 1);
+
+  for (i = 0; i < fShardCount; i++)
+  {
+    Shard& shard = fShards[i];
+    boost::unique_lock<boost::shared_mutex> lk(writeLock(shard));
+
+    for (it = shard.fbSet.begin(); it != shard.fbSet.end();)
+    {
+      rit = upper_bound(ranges.begin(), ranges.end(), make_pair(it->lbid, numeric_limits<LBID_t>::max()));
+
+      if (rit != ranges.begin() && it->lbid < (--rit)->second)
+      {
+        tmpIt = it;
+        ++it;
+        removeBlock(shard, tmpIt);
       }
+      else
+        ++it;
     }
   }
 }
@@ -386,78 +477,76 @@ bool FileBufferMgr::exists(const BRM::LBID_t& lbid, const BRM::VER_t& ver) const
   return b;
 }
 
-FileBuffer* FileBufferMgr::findPtr(const HashObject_t& keyFb)
-{
-  boost::mutex::scoped_lock lk(fWLock);
-
-  filebuffer_uset_iter_t it = fbSet.find(keyFb);
-
-  if (fbSet.end() != it)
-  {
-    FileBuffer* fb = &(fFBPool[it->poolIdx]);
-    fFBPool[it->poolIdx].listLoc()->hits++;
-    fbList.splice(fbList.begin(), fbList, (fFBPool[it->poolIdx]).listLoc());
-    return fb;
-  }
-
-  return NULL;
-}
-
 bool FileBufferMgr::find(const HashObject_t& keyFb, FileBuffer& fb)
 {
   bool ret = false;
+  Shard& shard = shardOf(keyFb.lbid);
+  boost::shared_lock<boost::shared_mutex> lk(readLock(shard));
 
-  boost::mutex::scoped_lock lk(fWLock);
-
-  filebuffer_uset_iter_t it = fbSet.find(keyFb);
+  filebuffer_uset_iter_t it = shard.fbSet.find(keyFb);
 
-  if (fbSet.end() != it)
+  if (shard.fbSet.end() != it)
   {
-    fFBPool[it->poolIdx].listLoc()->hits++;
-    fbList.splice(fbList.begin(), fbList, (fFBPool[it->poolIdx]).listLoc());
-    fb = fFBPool[it->poolIdx];
+    touch(shard, it->poolIdx);
+    fb = shard.fbPool[it->poolIdx];
     ret = true;
   }
 
+  (ret ? shard.hits : shard.misses).fetch_add(1, std::memory_order_relaxed);
   return ret;
 }
 
 bool FileBufferMgr::find(const HashObject_t& keyFb, void* bufferPtr)
 {
   bool ret = false;
+  struct timespec start;
+  Shard& shard = shardOf(keyFb.lbid);
 
   if (gPMProfOn && gPMStatsPtr)
     gPMStatsPtr->markEvent(keyFb.lbid, pthread_self(), gSession, 'L');
-  boost::mutex::scoped_lock lk(fWLock);
+
+  if (timing())
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+  boost::shared_lock<boost::shared_mutex> lk(readLock(shard));
 
   if (gPMProfOn && gPMStatsPtr)
     gPMStatsPtr->markEvent(keyFb.lbid, pthread_self(), gSession, 'M');
-  filebuffer_uset_iter_t it = fbSet.find(keyFb);
+  filebuffer_uset_iter_t it = shard.fbSet.find(keyFb);
 
-  if (fbSet.end() != it)
+  if (shard.fbSet.end() != it)
   {
     uint32_t idx = it->poolIdx;
 
-    //@bug 669 LRU cache, move block to front of list as last recently used.
-    fFBPool[idx].listLoc()->hits++;
-    fbList.splice(fbList.begin(), fbList, (fFBPool[idx]).listLoc());
+    // a hit only sets the reference bit, CLOCK does the rest at eviction time
+    touch(shard, idx);
+    // the copy stays under the shared lock, the slot may be reclaimed as soon as it is released
+    memcpy(bufferPtr, (shard.fbPool[idx]).getData(), 8192);
     lk.unlock();
-    memcpy(bufferPtr, (fFBPool[idx]).getData(), 8192);
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
+
+    if (timing())
+    {
+      shard.hitNanos.fetch_add(nanosSince(start), std::memory_order_relaxed);
+      shard.timedHits.fetch_add(1, std::memory_order_relaxed);
+    }
 
     if (gPMProfOn && gPMStatsPtr)
       gPMStatsPtr->markEvent(keyFb.lbid, pthread_self(), gSession, 'U');
     ret = true;
   }
+  else
+    shard.misses.fetch_add(1, std::memory_order_relaxed);
 
   return ret;
 }
 
 uint32_t FileBufferMgr::bulkFind(const BRM::LBID_t* lbids, const BRM::VER_t* vers, uint8_t** buffers,
-                                 bool* wasCached, uint32_t count)
+                                 bool* wasCached, uint32_t count, SPEncodedBlock** encoded)
 {
-  uint32_t i, ret = 0;
-  filebuffer_uset_iter_t* it = (filebuffer_uset_iter_t*)alloca(count * sizeof(filebuffer_uset_iter_t));
-  uint32_t* indexes = (uint32_t*)alloca(count * 4);
+  uint32_t i, j, ret = 0;
+  uint32_t* order = (uint32_t*)alloca(count * 4);
+  struct timespec start;
 
   if (gPMProfOn && gPMStatsPtr)
   {
@@ -467,42 +556,69 @@ uint32_t FileBufferMgr::bulkFind(const BRM::LBID_t* lbids, const BRM::VER_t* ver
     }
   }
 
-  boost::mutex::scoped_lock lk(fWLock);
+  // group the lookups by shard, so every shard lock is taken once
+  for (i = 0; i < count; i++)
+    order[i] = i;
 
-  if (gPMProfOn && gPMStatsPtr)
-  {
-    for (i = 0; i < count; i++)
-    {
-      gPMStatsPtr->markEvent(lbids[i], pthread_self(), gSession, 'M');
-    }
-  }
+  sort(order, order + count,
+       [&](uint32_t a, uint32_t b) { return shardNum(lbids[a]) < shardNum(lbids[b]); });
 
-  for (i = 0; i < count; i++)
+  for (i = 0; i < count;)
   {
-    new ((void*)&it[i]) filebuffer_uset_iter_t();
-    it[i] = fbSet.find(HashObject_t(lbids[i], vers[i], 0));
+    const uint32_t shardIdx = shardNum(lbids[order[i]]);
+    Shard& shard = fShards[shardIdx];
+    uint32_t hits = 0, lookups = 0;
+
+    if (timing())
+      clock_gettime(CLOCK_MONOTONIC, &start);
+
+    boost::shared_lock<boost::shared_mutex> lk(readLock(shard));
 
-    if (it[i] != fbSet.end())
+    for (; i < count && shardNum(lbids[order[i]]) == shardIdx; i++, lookups++)
     {
-      indexes[i] = it[i]->poolIdx;
-      wasCached[i] = true;
-      fFBPool[it[i]->poolIdx].listLoc()->hits++;
-      fbList.splice(fbList.begin(), fbList, (fFBPool[it[i]->poolIdx]).listLoc());
+      j = order[i];
+
+      if (gPMProfOn && gPMStatsPtr)
+        gPMStatsPtr->markEvent(lbids[j], pthread_self(), gSession, 'M');
+
+      filebuffer_uset_iter_t it = shard.fbSet.find(HashObject_t(lbids[j], vers[j], 0));
+
+      if (it != shard.fbSet.end())
+      {
+        touch(shard, it->poolIdx);
+        // copied under the shared lock, the slot may be reclaimed as soon as it is released
+        memcpy(buffers[j], shard.fbPool[it->poolIdx].getData(), 8192);
+
+        if (encoded)
+          *encoded[j] = shard.fbPool[it->poolIdx].encoded();
+
+        wasCached[j] = true;
+        hits++;
+      }
+      else
+      {
+        if (encoded)
+          encoded[j]->reset();
+
+        wasCached[j] = false;
+      }
     }
-    else
+
+    lk.unlock();
+    shard.hits.fetch_add(hits, std::memory_order_relaxed);
+    shard.misses.fetch_add(lookups - hits, std::memory_order_relaxed);
+
+    if (timing() && hits > 0)
     {
-      wasCached[i] = false;
-      indexes[i] = 0;
+      shard.hitNanos.fetch_add(nanosSince(start), std::memory_order_relaxed);
+      shard.timedHits.fetch_add(hits, std::memory_order_relaxed);
     }
   }
 
-  lk.unlock();
-
   for (i = 0; i < count; i++)
   {
     if (wasCached[i])
     {
-      memcpy(buffers[i], fFBPool[indexes[i]].getData(), 8192);
       ret++;
 
       if (gPMProfOn && gPMStatsPtr)
@@ -510,8 +626,6 @@ uint32_t FileBufferMgr::bulkFind(const BRM::LBID_t* lbids, const BRM::VER_t* ver
         gPMStatsPtr->markEvent(lbids[i], pthread_self(), gSession, 'U');
       }
     }
-
-    it[i].filebuffer_uset_iter_t::~filebuffer_uset_iter_t();
   }
 
   return ret;
@@ -520,275 +634,237 @@ uint32_t FileBufferMgr::bulkFind(const BRM::LBID_t* lbids, const BRM::VER_t* ver
 bool FileBufferMgr::exists(const HashObject_t& fb) const
 {
   bool find_bool = false;
-  boost::mutex::scoped_lock lk(fWLock);
+  const Shard& shard = shardOf(fb.lbid);
+  boost::shared_lock<boost::shared_mutex> lk(readLock(shard));
 
-  filebuffer_uset_iter_t it = fbSet.find(fb);
+  filebuffer_uset_iter_t it = shard.fbSet.find(fb);
 
-  if (it != fbSet.end())
+  if (it != shard.fbSet.end())
   {
     find_bool = true;
-    fFBPool[it->poolIdx].listLoc()->hits++;
-    fbList.splice(fbList.begin(), fbList, (fFBPool[it->poolIdx]).listLoc());
+    touch(shard, it->poolIdx);
   }
 
   return find_bool;
 }
 
-// default insert operation.
-// add a new fb into fbMgr and to fbList
-// add to the front and age out from the back
-// so add new fbs to the front of the list
-//@bug 665: keep filebuffer in a vector. HashObject keeps the index of the filebuffer
-
-int FileBufferMgr::insert(const BRM::LBID_t lbid, const BRM::VER_t ver, const uint8_t* data)
+// Returns the pool slot of the block the CLOCK hand evicts. A block that was hit since the hand
+// last passed it gets a second chance, so this takes at most two turns of the hand.
+uint32_t FileBufferMgr::evictBlock(Shard& shard)
 {
-  int ret = 0;
-
-  if (gPMProfOn && gPMStatsPtr)
-    gPMStatsPtr->markEvent(lbid, pthread_self(), gSession, 'I');
-
-  boost::mutex::scoped_lock lk(fWLock);
+  for (;;)
+  {
+    if (shard.hand >= shard.fbPool.size())
+      shard.hand = 0;
 
-  HashObject_t fbIndex(lbid, ver, 0);
-  filebuffer_pair_t pr = fbSet.insert(fbIndex);
+    const uint32_t idx = shard.hand++;
+    const uint8_t state = shard.slotState[idx].load(std::memory_order_relaxed);
 
-  if (pr.second)
-  {
-    // It was inserted (it wasn't there before)
-    // Right now we have an invalid cache: we have inserted an entry with a -1 index.
-    // We need to fix this quickly...
-    fCacheSize++;
-    FBData_t fbdata = {lbid, ver, 0};
-    fbList.push_front(fbdata);
-    fBlksLoaded++;
+    if (!(state & SLOT_VALID))
+      continue;
 
-    if (fReportFrequency && (fBlksLoaded % fReportFrequency) == 0)
+    if (state & SLOT_REFERENCED)
     {
-      struct timespec tm;
-      clock_gettime(CLOCK_MONOTONIC, &tm);
-      fLog << "insert: " << left << fixed << ((double)(tm.tv_sec + (1.e-9 * tm.tv_nsec))) << " " << right
-           << setw(12) << fBlksLoaded << " " << right << setw(12) << fBlksNotUsed << endl;
+      shard.slotState[idx].store(state & ~SLOT_REFERENCED, std::memory_order_relaxed);
+      continue;
     }
-  }
-  else
-  {
-    // if it's a duplicate there's nothing to do
-    if (gPMProfOn && gPMStatsPtr)
-      gPMStatsPtr->markEvent(lbid, pthread_self(), gSession, 'D');
-    return ret;
-  }
-
-  uint32_t pi = numeric_limits<int>::max();
-
-  if (fCacheSize > maxCacheSize())
-  {
-    // If the insert above caused the cache to exceed its max size, find the lru block in
-    // the cache and use its pool index to store the block data.
-    FBData_t& fbdata = fbList.back();  // the lru block
-    HashObject_t lastFB(fbdata.lbid, fbdata.ver, 0);
-    filebuffer_uset_iter_t iter = fbSet.find(lastFB);  // should be there
-
-    idbassert(iter != fbSet.end());
-    pi = iter->poolIdx;
-    idbassert(pi < maxCacheSize());
-    idbassert(pi < fFBPool.size());
-
-    // set iters are always const. We are not changing the hash here, and this gets us
-    // the pointer we need cheaply...
-    HashObject_t& ref = const_cast<HashObject_t&>(*pr.first);
-    ref.poolIdx = pi;
-
-    // replace the lru block with this block
-    FileBuffer fb(lbid, ver, NULL, 0);
-    fFBPool[pi] = fb;
-    fFBPool[pi].setData(data, 8192);
-    fbSet.erase(iter);
 
-    if (fbList.back().hits == 0)
+    if (!(state & SLOT_USED))
       fBlksNotUsed++;
 
-    fbList.pop_back();
-    fCacheSize--;
-    depleteCache();
-    ret = 1;
+    FileBuffer& fb = shard.fbPool[idx];
+    shard.fbSet.erase(HashObject_t(fb.Lbid(), fb.Verid(), 0));
+    fb.encoded(SPEncodedBlock());
+    shard.slotState[idx].store(0, std::memory_order_relaxed);
+    shard.evictions.fetch_add(1, std::memory_order_relaxed);
+    return idx;
   }
-  else
-  {
-    if (!fEmptyPoolSlots.empty())
-    {
-      pi = fEmptyPoolSlots.front();
-      fEmptyPoolSlots.pop_front();
-      FileBuffer fb(lbid, ver, NULL, 0);
-      fFBPool[pi] = fb;
-      fFBPool[pi].setData(data, 8192);
-    }
-    else
-    {
-      pi = fFBPool.size();
-      FileBuffer fb(lbid, ver, NULL, 0);
-      fFBPool.push_back(fb);
-      fFBPool[pi].setData(data, 8192);
-    }
-
-    // See comment above
-    HashObject_t& ref = const_cast<HashObject_t&>(*pr.first);
-    ref.poolIdx = pi;
-    ret = 1;
-  }
-
-  idbassert(pi < fFBPool.size());
-  fFBPool[pi].listLoc(fbList.begin());
-
-  if (gPMProfOn && gPMStatsPtr)
-    gPMStatsPtr->markEvent(lbid, pthread_self(), gSession, 'J');
-
-  idbassert(fCacheSize <= maxCacheSize());
-  // 	idbassert(fCacheSize == fbSet.size());
-  // 	idbassert(fCacheSize == fbList.size());
-  return ret;
 }
 
-void FileBufferMgr::depleteCache()
+void FileBufferMgr::depleteCache(Shard& shard)
 {
-  for (uint32_t i = 0; i < fDeleteBlocks && !fbList.empty(); ++i)
+  // the block just inserted is in the set but in no slot yet, leave it alone
+  for (uint32_t i = 0; i < shard.deleteBlocks && shard.fbSet.size() > 1; ++i)
   {
-    FBData_t fbdata(fbList.back());  // the lru block
-    HashObject_t lastFB(fbdata.lbid, fbdata.ver, 0);
-    filebuffer_uset_iter_t iter = fbSet.find(lastFB);
-
-    idbassert(iter != fbSet.end());
-    uint32_t idx = iter->poolIdx;
-    idbassert(idx < fFBPool.size());
     // Save position in FileBuffer pool for reuse.
-    fEmptyPoolSlots.push_back(idx);
-    fbSet.erase(iter);
-
-    if (fbList.back().hits == 0)
-      fBlksNotUsed++;
-
-    fbList.pop_back();
-    fCacheSize--;
+    shard.emptyPoolSlots.push_back(evictBlock(shard));
   }
 }
 
-ostream& FileBufferMgr::formatLRUList(ostream& os) const
+// add a new block to the shard, evicting one if the shard is full.
+//@bug 665: keep filebuffer in a vector. HashObject keeps the index of the filebuffer
+uint32_t FileBufferMgr::insertBlock(Shard& shard, const BRM::LBID_t lbid, const BRM::VER_t ver,
+                                    const uint8_t* data, const SPEncodedBlock& encoded)
 {
-  filebuffer_list_t::const_iterator iter = fbList.begin();
-  filebuffer_list_t::const_iterator end = fbList.end();
+  uint32_t pi;
 
-  while (iter != end)
-  {
-    os << iter->lbid << '\t' << iter->ver << endl;
-    ++iter;
-  }
+  if (shard.capacity == 0)
+    return 0;
 
-  return os;
-}
+  filebuffer_pair_t pr = shard.fbSet.insert(HashObject_t(lbid, ver, 0));
 
-// puts the new entry at the front of the list
-void FileBufferMgr::updateLRU(const FBData_t& f)
-{
-  if (fCacheSize > maxCacheSize())
+  if (!pr.second)
   {
-    list<FBData_t>::iterator last = fbList.end();
-    last--;
-    FBData_t& fbdata = *last;
-    HashObject_t lastFB(fbdata.lbid, fbdata.ver, 0);
-    filebuffer_uset_iter_t iter = fbSet.find(lastFB);
-    fEmptyPoolSlots.push_back(iter->poolIdx);
-
-    if (fbdata.hits == 0)
-      fBlksNotUsed++;
+    // if it's a duplicate there's nothing to do
+    if (gPMProfOn && gPMStatsPtr)
+      gPMStatsPtr->markEvent(lbid, pthread_self(), gSession, 'D');
+    return 0;
+  }
 
-    fbSet.erase(iter);
-    fbList.splice(fbList.begin(), fbList, last);
-    fbdata = f;
-    fCacheSize--;
-    // cout << "booted an entry\n";
+  if (!shard.emptyPoolSlots.empty())
+  {
+    pi = shard.emptyPoolSlots.front();
+    shard.emptyPoolSlots.pop_front();
+  }
+  else if (shard.fbPool.size() < shard.capacity)
+  {
+    pi = shard.fbPool.size();
+    shard.fbPool.resize(pi + 1);  // shouldn't trigger a 'real' resize b/c of the reserve call
   }
   else
   {
-    // cout << "new entry\n";
-    fbList.push_front(f);
+    pi = evictBlock(shard);
+    depleteCache(shard);
   }
+
+  idbassert(pi < shard.fbPool.size());
+  shard.fbPool[pi].Lbid(lbid);
+  shard.fbPool[pi].Verid(ver);
+  shard.fbPool[pi].setData(data);
+  shard.fbPool[pi].encoded(encoded);
+
+  // a new block starts with its reference bit set, it survives one turn of the hand unused
+  shard.slotState[pi].store(SLOT_VALID | SLOT_REFERENCED, std::memory_order_relaxed);
+
+  // set iters are always const. We are not changing the hash here, and this gets us
+  // the pointer we need cheaply...
+  HashObject_t& ref = const_cast<HashObject_t&>(*pr.first);
+  ref.poolIdx = pi;
+
+  shard.inserts.fetch_add(1, std::memory_order_relaxed);
+  fBlksLoaded++;
+  return 1;
 }
 
-uint32_t FileBufferMgr::doBlockCopy(const BRM::LBID_t& lbid, const BRM::VER_t& ver, const uint8_t* data)
+int FileBufferMgr::insert(const BRM::LBID_t lbid, const BRM::VER_t ver, const uint8_t* data)
 {
-  uint32_t poolIdx;
+  int ret = 0;
+  Shard& shard = shardOf(lbid);
 
-  if (!fEmptyPoolSlots.empty())
-  {
-    poolIdx = fEmptyPoolSlots.front();
-    fEmptyPoolSlots.pop_front();
-  }
-  else
+  if (gPMProfOn && gPMStatsPtr)
+    gPMStatsPtr->markEvent(lbid, pthread_self(), gSession, 'I');
+
+  boost::unique_lock<boost::shared_mutex> lk(writeLock(shard));
+  ret = insertBlock(shard, lbid, ver, data);
+  lk.unlock();
+
+  if (ret == 0)
+    return ret;
+
+  if (fReportFrequency && (fBlksLoaded % fReportFrequency) == 0)
   {
-    poolIdx = fFBPool.size();
-    fFBPool.resize(poolIdx + 1);  // shouldn't trigger a 'real' resize b/c of the reserve call
+    struct timespec tm;
+    clock_gettime(CLOCK_MONOTONIC, &tm);
+    boost::mutex::scoped_lock logLk(fLogLock);
+    fLog << "insert: " << left << fixed << ((double)(tm.tv_sec + (1.e-9 * tm.tv_nsec))) << " " << right
+         << setw(12) << fBlksLoaded.load() << " " << right << setw(12) << fBlksNotUsed.load() << endl;
   }
 
-  fFBPool[poolIdx].Lbid(lbid);
-  fFBPool[poolIdx].Verid(ver);
-  fFBPool[poolIdx].setData(data);
-  return poolIdx;
+  if (gPMProfOn && gPMStatsPtr)
+    gPMStatsPtr->markEvent(lbid, pthread_self(), gSession, 'J');
+
+  return ret;
 }
 
 int FileBufferMgr::bulkInsert(const vector<CacheInsert_t>& ops)
 {
   uint32_t i;
-  int32_t pi;
   int ret = 0;
+  vector<uint32_t> order(ops.size());
+  ostringstream logStr;
 
-  boost::mutex::scoped_lock lk(fWLock);
-
-  if (fReportFrequency)
-  {
-    fLog << "bulkInsert: ";
-  }
-
+  // group the blocks by shard, so every shard lock is taken once
   for (i = 0; i < ops.size(); i++)
-  {
-    const CacheInsert_t& op = ops[i];
+    order[i] = i;
 
-    if (gPMProfOn && gPMStatsPtr)
-      gPMStatsPtr->markEvent(op.lbid, pthread_self(), gSession, 'I');
+  sort(order.begin(), order.end(),
+       [&](uint32_t a, uint32_t b) { return shardNum(ops[a].lbid) < shardNum(ops[b].lbid); });
 
-    HashObject_t fbIndex(op.lbid, op.ver, 0);
-    filebuffer_pair_t pr = fbSet.insert(fbIndex);
+  for (i = 0; i < order.size();)
+  {
+    const uint32_t shardIdx = shardNum(ops[order[i]].lbid);
+    Shard& shard = fShards[shardIdx];
+    boost::unique_lock<boost::shared_mutex> lk(writeLock(shard));
 
-    if (!pr.second)
+    for (; i < order.size() && shardNum(ops[order[i]].lbid) == shardIdx; i++)
     {
+      const CacheInsert_t& op = ops[order[i]];
+
       if (gPMProfOn && gPMStatsPtr)
-        gPMStatsPtr->markEvent(op.lbid, pthread_self(), gSession, 'D');
-      continue;
-    }
+        gPMStatsPtr->markEvent(op.lbid, pthread_self(), gSession, 'I');
 
-    if (fReportFrequency)
-    {
-      fLog << op.lbid << " " << op.ver << ", ";
-    }
-    fCacheSize++;
-    fBlksLoaded++;
-    FBData_t fbdata = {op.lbid, op.ver, 0};
-    updateLRU(fbdata);
-    pi = doBlockCopy(op.lbid, op.ver, op.data);
+      if (insertBlock(shard, op.lbid, op.ver, op.data, op.encoded) == 0)
+        continue;
 
-    HashObject_t& ref = const_cast<HashObject_t&>(*pr.first);
-    ref.poolIdx = pi;
-    fFBPool[pi].listLoc(fbList.begin());
+      if (fReportFrequency)
+        logStr << op.lbid << " " << op.ver << ", ";
 
-    if (gPMProfOn && gPMStatsPtr)
-      gPMStatsPtr->markEvent(op.lbid, pthread_self(), gSession, 'J');
-    ret++;
+      if (gPMProfOn && gPMStatsPtr)
+        gPMStatsPtr->markEvent(op.lbid, pthread_self(), gSession, 'J');
+      ret++;
+    }
   }
+
   if (fReportFrequency)
   {
-    fLog << endl;
+    boost::mutex::scoped_lock lk(fLogLock);
+    fLog << "bulkInsert: " << logStr.str() << endl;
   }
-  idbassert(fCacheSize <= maxCacheSize());
 
   return ret;
 }
 
+ostream& FileBufferMgr::formatLRUList(ostream& os) const
+{
+  for (uint32_t i = 0; i < fShardCount; i++)
+  {
+    const Shard& shard = fShards[i];
+    boost::shared_lock<boost::shared_mutex> lk(shard.lock);
+    const uint32_t poolSize = shard.fbPool.size();
+
+    for (uint32_t j = 0; j < poolSize; j++)
+    {
+      const uint32_t idx = (shard.hand + j) % poolSize;
+
+      if (shard.slotState[idx].load(std::memory_order_relaxed) & SLOT_VALID)
+        os << shard.fbPool[idx].Lbid() << '\t' << shard.fbPool[idx].Verid() << endl;
+    }
+  }
+
+  return os;
+}
+
+void FileBufferMgr::getShardStats(vector<CacheShardStats>& stats) const
+{
+  stats.resize(fShardCount);
+
+  for (uint32_t i = 0; i < fShardCount; i++)
+  {
+    const Shard& shard = fShards[i];
+    CacheShardStats& s = stats[i];
+    {
+      boost::shared_lock<boost::shared_mutex> lk(shard.lock);
+      s.blocks = shard.fbSet.size();
+    }
+    s.capacity = shard.capacity;
+    s.hits = shard.hits.load(std::memory_order_relaxed);
+    s.misses = shard.misses.load(std::memory_order_relaxed);
+    s.inserts = shard.inserts.load(std::memory_order_relaxed);
+    s.evictions = shard.evictions.load(std::memory_order_relaxed);
+    s.lockWaits = shard.lockWaits.load(std::memory_order_relaxed);
+    s.timedHits = shard.timedHits.load(std::memory_order_relaxed);
+    s.hitNanos = shard.hitNanos.load(std::memory_order_relaxed);
+  }
+}
+
 }  // namespace dbbc
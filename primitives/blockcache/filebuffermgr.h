@@ -23,9 +23,11 @@
  ***************************************************************************/
 
 #pragma once
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <memory>
 #include <tr1/unordered_set>
 #include <boost/thread.hpp>
 #include <deque>
@@ -33,6 +35,7 @@
 #include "primitivemsg.h"
 #include "blocksize.h"
 #include "filebuffer.h"
+#include "stats.h"
 #include "rwlock_local.h"
 
 /**
@@ -40,9 +43,12 @@
 */
 
 /**
- * @brief manages storage of Disk Block Buffers via and LRU cache using the stl classes unordered_set and
- *list.
+ * @brief manages storage of Disk Block Buffers in a sharded cache with CLOCK eviction.
  *
+ * The blocks are spread over a power of 2 number of shards by a hash of the LBID, so all the versions
+ * of an LBID live in the same shard. Every shard has its own lock, hash set, block pool and CLOCK hand.
+ * A cache hit takes the shard lock in shared mode and only sets the block's reference bit, so
+ * concurrent hits don't serialize. Inserts, evictions and flushes take the shard lock exclusively.
  **/
 
 namespace dbbc
@@ -63,12 +69,15 @@ struct FileBufferIndex
 
 struct CacheInsert_t
 {
-  CacheInsert_t(const BRM::LBID_t& l, const BRM::VER_t& v, const uint8_t* d) : lbid(l), ver(v), data(d)
+  CacheInsert_t(const BRM::LBID_t& l, const BRM::VER_t& v, const uint8_t* d,
+                const SPEncodedBlock& e = SPEncodedBlock())
+   : lbid(l), ver(v), data(d), encoded(e)
   {
   }
   BRM::LBID_t lbid;
   BRM::VER_t ver;
   const uint8_t* data;
+  SPEncodedBlock encoded;  // the encoded copy of data, if there is one
 };
 
 typedef FileBufferIndex HashObject_t;
@@ -105,8 +114,15 @@ class FileBufferMgr
 
   typedef std::deque<uint32_t> emptylist_t;
 
+  /* Upper limit of the shard count, and the fewest blocks a shard is given. */
+  static constexpr uint32_t MaxShards = 64;
+  static constexpr uint32_t MinShardBlocks = 1024;
+
   /**
-   * @brief ctor. Set max buffer size to numBlcks and block buffer size to blckSz
+   * @brief ctor. Set max buffer size to numBlcks and block buffer size to blckSz.
+   *
+   * The shard count is DBBC.NumCacheShards if set, otherwise the number of cores, rounded up to a
+   * power of 2 and capped so every shard holds at least MinShardBlocks blocks.
    **/
 
   FileBufferMgr(uint32_t numBlcks, uint32_t blckSz = BLOCK_SIZE, uint32_t deleteBlocks = 0);
@@ -138,10 +154,7 @@ class FileBufferMgr
   /**
    * @brief returns the total number of Disk Blocks in the Cache
    **/
-  uint32_t size() const
-  {
-    return fbSet.size();
-  }
+  uint32_t size() const;
 
   /**
    * @brief
@@ -170,8 +183,6 @@ class FileBufferMgr
    * @brief return the disk Block referenced by fb
    **/
 
-  FileBuffer* findPtr(const HashObject_t& keyFb);
-
   bool find(const HashObject_t& keyFb, FileBuffer& fb);
 
   /**
@@ -179,22 +190,22 @@ class FileBufferMgr
    **/
 
   bool find(const HashObject_t& keyFb, void* bufferPtr);
+
+  /**
+   * @brief copy the cached blocks into buffers. If encoded is given, *encoded[i] is set to the
+   * encoded copy of block i, null if it has none or isn't cached.
+   **/
   uint32_t bulkFind(const BRM::LBID_t* lbids, const BRM::VER_t* vers, uint8_t** buffers, bool* wasCached,
-                    uint32_t blockCount);
+                    uint32_t blockCount, SPEncodedBlock** encoded = NULL);
 
   uint32_t maxCacheSize() const
   {
     return fMaxNumBlocks;
   }
 
-  uint32_t listSize() const
-  {
-    return fbList.size();
-  }
-
-  const filebuffer_uset_iter_t end() const
+  uint32_t shardCount() const
   {
-    return fbSet.end();
+    return fShardCount;
   }
 
   void setReportingFrequency(const uint32_t d);
@@ -203,36 +214,102 @@ class FileBufferMgr
     return fReportFrequency;
   }
 
+  /**
+   * @brief print the cached blocks, shard by shard in CLOCK order starting at the hand
+   **/
   std::ostream& formatLRUList(std::ostream& os) const;
 
+  /**
+   * @brief return the counters of every shard. Hit latency is only sampled while reporting is on.
+   **/
+  void getShardStats(std::vector<CacheShardStats>& stats) const;
+
  private:
+  /* The per block CLOCK state. Hits only ever set bits, the sweep and flushes run under the
+     exclusive shard lock, so relaxed atomics are enough. */
+  enum
+  {
+    SLOT_VALID = 0x1,       // the pool slot holds a cached block
+    SLOT_REFERENCED = 0x2,  // hit since the hand last passed, gets a second chance
+    SLOT_USED = 0x4         // hit at least once since it was loaded
+  };
+
+  struct alignas(64) Shard
+  {
+    mutable boost::shared_mutex lock;
+    filebuffer_uset_t fbSet;
+    FileBufferPool_t fbPool;  // reserved to capacity up front, never reallocated
+    std::unique_ptr<std::atomic<uint8_t>[]> slotState;
+    emptylist_t emptyPoolSlots;  // keep track of fbPool slots that can be reused
+    uint32_t capacity;
+    uint32_t deleteBlocks;  // extra blocks freed on every eviction
+    uint32_t hand;
+
+    mutable std::atomic<uint64_t> hits;
+    mutable std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> inserts;
+    std::atomic<uint64_t> evictions;
+    mutable std::atomic<uint64_t> lockWaits;
+    mutable std::atomic<uint64_t> timedHits;
+    mutable std::atomic<uint64_t> hitNanos;
+  };
+
+  typedef std::vector<std::pair<BRM::LBID_t, BRM::LBID_t> > lbid_ranges_t;
+
+  inline uint32_t shardNum(const BRM::LBID_t lbid) const
+  {
+    // Fibonacci hashing, neighbouring LBIDs of a scan land in different shards
+    return (((uint64_t)lbid * 0x9e3779b97f4a7c15ULL) >> 40) & (fShardCount - 1);
+  }
+  inline Shard& shardOf(const BRM::LBID_t lbid) const
+  {
+    return fShards[shardNum(lbid)];
+  }
+
+  boost::shared_lock<boost::shared_mutex> readLock(const Shard& shard) const;
+  boost::unique_lock<boost::shared_mutex> writeLock(Shard& shard);
+
+  inline void touch(const Shard& shard, uint32_t idx) const
+  {
+    const uint8_t hit = SLOT_VALID | SLOT_REFERENCED | SLOT_USED;
+
+    // skip the store if it's already set, so hot blocks don't bounce their cache line
+    if (shard.slotState[idx].load(std::memory_order_relaxed) != hit)
+      shard.slotState[idx].store(hit, std::memory_order_relaxed);
+  }
+
+  // all of these expect the exclusive shard lock
+  uint32_t insertBlock(Shard& shard, const BRM::LBID_t lbid, const BRM::VER_t ver, const uint8_t* data,
+                       const SPEncodedBlock& encoded = SPEncodedBlock());
+  uint32_t evictBlock(Shard& shard);
+  void removeBlock(Shard& shard, filebuffer_uset_iter_t iter);
+  void depleteCache(Shard& shard);
+
+  void flushRanges(lbid_ranges_t& ranges);
+
+  inline bool timing() const
+  {
+    return fReportFrequency != 0;
+  }
+
   uint32_t fMaxNumBlocks;  // the max number of blockSz blocks to keep in the Cache list
   uint32_t fBlockSz;       // size in bytes size of a data block - probably 8
 
-  mutable boost::mutex fWLock;
-  mutable filebuffer_uset_t fbSet;
+  uint32_t fShardCount;
+  std::unique_ptr<Shard[]> fShards;
 
-  mutable filebuffer_list_t fbList;  // rename this
-  uint32_t fCacheSize;
-
-  FileBufferPool_t fFBPool;  // vector<FileBuffer>
   uint32_t fDeleteBlocks;
-  emptylist_t fEmptyPoolSlots;  // keep track of FBPool slots that can be reused
 
-  void depleteCache();
-  uint64_t fBlksLoaded;       // number of blocks inserted into cache
-  uint64_t fBlksNotUsed;      // number of blocks inserted and not used
-  uint64_t fReportFrequency;  // how many blocks are read between reports
+  std::atomic<uint64_t> fBlksLoaded;   // number of blocks inserted into cache
+  std::atomic<uint64_t> fBlksNotUsed;  // number of blocks inserted and not used
+  uint64_t fReportFrequency;           // how many blocks are read between reports
+  boost::mutex fLogLock;
   std::ofstream fLog;
   config::Config* fConfig;
 
   // do not implement
   FileBufferMgr(const FileBufferMgr& fbm);
   const FileBufferMgr& operator=(const FileBufferMgr& fbm);
-
-  // used by bulkInsert
-  void updateLRU(const FBData_t& f);
-  uint32_t doBlockCopy(const BRM::LBID_t& lbid, const BRM::VER_t& ver, const uint8_t* data);
 };
 
 }  // namespace dbbc
@@ -82,6 +82,7 @@ using namespace logging;
 #include "rwlock_local.h"
 
 #include "iomanager.h"
+#include "blockreader.h"
 #include "liboamcpp.h"
 
 #include "idbcompress.h"
@@ -124,6 +125,7 @@ const std::string boldStop = "\033[0;39m";
 
 const uint32_t MAX_OPEN_FILES = 16384;
 const uint32_t DECREASE_OPEN_FILES = 4096;
+const uint32_t IO_QUEUE_DEPTH = 4;
 
 void timespec_sub(const struct timespec& tv1, const struct timespec& tv2, double& tm)
 {
@@ -172,6 +174,8 @@ class FdEntry
   int inUse;
 
   CompChunkPtrList ptrList;
+  // trained compression dictionary from the file header, empty if there is none
+  boost::shared_ptr<const std::string> dictionary;
 
   int compType;
   bool isCompressed() const
@@ -336,6 +340,11 @@ static int updateptrs(char* ptr, FdCacheType_t::iterator fdit)
   if (fdit->second->ptrList.size() == 0)
     return -6;  // go for a retry.
 
+  // Readers hold on to the dictionary they started with, so it is replaced rather than modified
+  size_t dictLen = 0;
+  const char* dict = compress::CompressInterface::getDictionary(ptr, dictLen);
+  fdit->second->dictionary.reset(new std::string(dict ? dict : "", dictLen));
+
   uint64_t numHdrs = fdit->second->ptrList[0].first / 4096ULL - 2ULL;
 
   if (numHdrs > 0)
@@ -448,6 +457,25 @@ void* thr_popper(ioManager* arg)
   uint8_t* uCmpBuf = 0;
   uCmpBuf = new uint8_t[4 * 1024 * 1024 + 4];
 
+  // With io_uring the chunks of a multi chunk request are read ahead, up to the queue depth
+  // at a time, into a staging buffer.  A slot holds either a read or a compressed chunk.
+  BlockReader reader(iom->ioQueueDepth(), iom->useUring());
+  boost::scoped_array<char> realStageBuff;
+  char* stageBuff = 0;
+  const uint32_t chunkSize = iom->blocksPerRead * BLOCK_SIZE;
+  const size_t stageSlotSize = (std::max<size_t>(chunkSize, maxCompSz) + pageSize - 1) / pageSize * pageSize;
+  vector<BlockReader::Request> stagedReads;
+  uint32_t stagedCount = 0;
+  char* readBuff = alignedbuff;
+  char* cmpBuff = alignedbuff;
+
+  if (reader.usingUring())
+  {
+    realStageBuff.reset(new char[reader.queueDepth() * stageSlotSize + pageSize]);
+    stageBuff = alignTo(realStageBuff.get(), pageSize);
+    stagedReads.resize(reader.queueDepth());
+  }
+
   for (;;)
   {
     if (copyLocked)
@@ -755,14 +783,47 @@ void* thr_popper(ioManager* arg)
     if (blocksRequested % iom->blocksPerRead)
       jend++;
 
+    readBuff = alignedbuff;
+    stagedCount = 0;
+
     for (j = 0; j < jend; j++)
     {
       int decompRetryCount = 0;
       int retryReadHeadersCount = 0;
+      boost::shared_ptr<const std::string> dictionary;
+      // the chunk of a compressed file this read falls in
+      cmpOffFact = lldiv(longSeekOffset, (4LL * 1024LL * 1024LL));
 
     decompRetry:
       blocksThisRead = std::min(dlen, iom->blocksPerRead);
       readSize = blocksThisRead * BLOCK_SIZE;
+      readBuff = alignedbuff;
+
+      if (stageBuff && jend > 1 && !fdit->second->isCompressed())
+      {
+        const uint32_t stageIdx = j % reader.queueDepth();
+
+        if (stageIdx == 0)
+        {
+          const uint32_t stageCount = std::min(reader.queueDepth(), jend - j);
+          uint32_t blocksLeft = dlen;
+
+          for (uint32_t k = 0; k < stageCount; k++)
+          {
+            BlockReader::Request& r = stagedReads[k];
+            r.buf = &stageBuff[k * stageSlotSize];
+            r.offset = longSeekOffset + (uint64_t)k * chunkSize;
+            r.count = std::min(blocksLeft, iom->blocksPerRead) * BLOCK_SIZE;
+            blocksLeft -= r.count / BLOCK_SIZE;
+          }
+
+          reader.read(fp, &stagedReads[0], stageCount);
+        }
+
+        // a chunk that didn't come in whole is read again below, that reports the error
+        if (stagedReads[stageIdx].result == (ssize_t)readSize)
+          readBuff = &stageBuff[stageIdx * stageSlotSize];
+      }
 
       acc = 0;
 
@@ -807,6 +868,7 @@ void* thr_popper(ioManager* arg)
           if (decompRetryCount > 0 || retryReadHeadersCount > 0 || cur_mtime > fdit->second->cmpMTime)
             updatePtrsRc = updateptrs(&alignedbuff[0], fdit);
 
+          dictionary = fdit->second->dictionary;
           fdMapMutex.unlock();
 
           int idx = cmpOffFact.quot;
@@ -854,7 +916,54 @@ void* thr_popper(ioManager* arg)
             break;
           }
 
-          i = fp->pread(&alignedbuff[0], fdit->second->ptrList[idx].first, fdit->second->ptrList[idx].second);
+          // With io_uring the chunks the rest of a multi chunk request falls in are read in one
+          // submission, then each one is decompressed from its staging slot.  A retry reads again.
+          cmpBuff = alignedbuff;
+
+          if (stageBuff && jend > 1 && decompRetryCount == 0 && retryReadHeadersCount == 0)
+          {
+            const CompChunkPtrList& ptrList = fdit->second->ptrList;
+            uint32_t k;
+
+            for (k = 0; k < stagedCount; k++)
+            {
+              if (stagedReads[k].offset == (off64_t)ptrList[idx].first)
+                break;
+            }
+
+            if (k == stagedCount)
+            {
+              const int64_t lastIdx = std::min<int64_t>(
+                  (longSeekOffset + (uint64_t)dlen * BLOCK_SIZE - 1) / (4LL * 1024LL * 1024LL),
+                  ptrList.size() - 1);
+
+              for (stagedCount = 0; stagedCount < reader.queueDepth() && idx + stagedCount <= lastIdx &&
+                                    ptrList[idx + stagedCount].second <= maxCompSz;
+                   stagedCount++)
+              {
+                BlockReader::Request& r = stagedReads[stagedCount];
+                r.buf = &stageBuff[stagedCount * stageSlotSize];
+                r.offset = ptrList[idx + stagedCount].first;
+                r.count = ptrList[idx + stagedCount].second;
+              }
+
+              if (stagedCount > 0)
+                reader.read(fp, &stagedReads[0], stagedCount);
+
+              k = 0;
+            }
+
+            // a chunk that didn't come in whole is read again below, that reports the error
+            if (k < stagedCount && stagedReads[k].count == ptrList[idx].second &&
+                stagedReads[k].result == (ssize_t)stagedReads[k].count)
+              cmpBuff = (char*)stagedReads[k].buf;
+          }
+
+          if (cmpBuff != alignedbuff)
+            i = fdit->second->ptrList[idx].second;
+          else
+            i = fp->pread(&alignedbuff[0], fdit->second->ptrList[idx].first,
+                          fdit->second->ptrList[idx].second);
 #ifdef IDB_COMP_POC_DEBUG
           {
             boost::mutex::scoped_lock lk(primitiveprocessor::compDebugMutex);
@@ -899,6 +1008,10 @@ void* thr_popper(ioManager* arg)
           compressedBytesRead += i;  // @Bug 3149.
           i = readSize;
         }
+        else if (readBuff != alignedbuff)
+        {
+          i = readSize;  // read ahead with io_uring
+        }
         else
         {
           i = fp->pread(&alignedbuff[acc], longSeekOffset, readSize - acc);
@@ -985,7 +1098,8 @@ void* thr_popper(ioManager* arg)
           isLocked.push_back(false);
         }
 
-        uint8_t* ptr = (uint8_t*)&alignedbuff[0];
+        uint8_t* ptr = (uint8_t*)&readBuff[0];
+        uint32_t encodedWidth = 0;
 
         if (blocksThisRead > 0 && fdit->second->isCompressed())
         {
@@ -1008,7 +1122,9 @@ void* thr_popper(ioManager* arg)
           }
 
           int dcrc = decompressor->uncompressBlock(
-              &alignedbuff[0], fdit->second->ptrList[cmpOffFact.quot].second, uCmpBuf, blen);
+              &cmpBuff[0], fdit->second->ptrList[cmpOffFact.quot].second, uCmpBuf, blen,
+              dictionary ? dictionary->data() : nullptr, dictionary ? dictionary->size() : 0,
+              &encodedWidth);
 
           if (dcrc != 0)
           {
@@ -1019,6 +1135,7 @@ void* thr_popper(ioManager* arg)
             if (++decompRetryCount < 30)
             {
               blocksRead -= blocksThisRead;
+              longSeekOffset -= readSize;
               waitForRetry(decompRetryCount);
 
               // log an info message every 10 retries
@@ -1115,8 +1232,11 @@ void* thr_popper(ioManager* arg)
               }
             }
 #endif
+            // the blocks of an encoded chunk keep an encoded copy for the scans to filter on
             cacheInsertOps.push_back(
-                CacheInsert_t(lbids[i], versions[i], (uint8_t*)&alignedbuff[i * BLOCK_SIZE]));
+                CacheInsert_t(lbids[i], versions[i], (uint8_t*)&readBuff[i * BLOCK_SIZE],
+                              encodedWidth ? encodeBlock((uint8_t*)&readBuff[i * BLOCK_SIZE], encodedWidth)
+                                           : SPEncodedBlock()));
           }
         }
 
@@ -1157,7 +1277,7 @@ void* thr_popper(ioManager* arg)
 
     // FIXME: This is why some code above doesn't work...
     if (fr->data != 0 && blocksRequested == 1)
-      memcpy(fr->data, alignedbuff, BLOCK_SIZE);
+      memcpy(fr->data, readBuff, BLOCK_SIZE);
 
     fr->frMutex().lock();
     fr->SetPredicate(fileRequest::COMPLETE);
@@ -1291,6 +1411,27 @@ ioManager::ioManager(FileBufferMgr& fbm, fileBlockRequestQueue& fbrq, int thrCou
     FDTraceFile().open(string(MCSLOGDIR) + "/trace/fdcache", ios_base::ate | ios_base::app);
   }
 
+  val = fConfig->getConfig("DBBC", "IOEngine");
+  fUseUring = (val == "uring" || val == "io_uring");
+
+  if (fUseUring && !BlockReader::uringSupported())
+  {
+    Message::Args args;
+    args.add("ioManager: io_uring is not available, using pread");
+    primitiveprocessor::mlp->logInfoMessage(logging::M0006, args);
+    fUseUring = false;
+  }
+
+  val = fConfig->getConfig("DBBC", "IOQueueDepth");
+  temp = 0;
+  fIOQueueDepth = IO_QUEUE_DEPTH;
+
+  if (val.length() > 0)
+    temp = static_cast<int>(Config::fromText(val));
+
+  if (temp > 0)
+    fIOQueueDepth = temp;
+
   fThreadCount = thrCount;
   go();
 }
@@ -101,6 +101,18 @@ class ioManager
     return fFDCacheTrace;
   }
 
+  // true if DBBC.IOEngine asks for io_uring and the kernel supports it
+  bool useUring() const
+  {
+    return fUseUring;
+  }
+
+  // the number of chunks a reader thread submits at once with io_uring
+  uint32_t ioQueueDepth() const
+  {
+    return fIOQueueDepth;
+  }
+
   void handleBlockReadError(fileRequest* fr, const std::string& errMsg, bool* copyLocked,
                             int errorCode = fileRequest::FAILED);
 
@@ -137,6 +149,8 @@ class ioManager
   uint32_t fDecreaseOpenFilesCount;
   bool fFDCacheTrace;
   std::ofstream fFDTraceFile;
+  bool fUseUring;
+  uint32_t fIOQueueDepth;
 };
 
 // @bug2631, for remount filesystem by loadBlock() in primitiveserver
@@ -273,4 +273,47 @@ void Stats::markEvent(const uint64_t lbid, const pthread_t thdid, const uint32_t
   iter->second.log(lbid2oid(lbid), lbid, thdid, event);
 }
 
+ostream& formatCacheShardStats(ostream& os, const vector<CacheShardStats>& shards)
+{
+  CacheShardStats total = {};
+
+  os << "shard      blocks    capacity        hits      misses   evictions   lockWaits  hit%   avg hit ns"
+     << endl;
+
+  for (uint32_t i = 0; i <= shards.size(); i++)
+  {
+    const CacheShardStats& s = (i < shards.size() ? shards[i] : total);
+
+    if (i < shards.size())
+    {
+      total.blocks += s.blocks;
+      total.capacity += s.capacity;
+      total.hits += s.hits;
+      total.misses += s.misses;
+      total.inserts += s.inserts;
+      total.evictions += s.evictions;
+      total.lockWaits += s.lockWaits;
+      total.timedHits += s.timedHits;
+      total.hitNanos += s.hitNanos;
+      os << setw(5) << i;
+    }
+    else
+      os << "total";
+
+    uint64_t lookups = s.hits + s.misses;
+    os << ' ' << setw(11) << s.blocks << ' ' << setw(11) << s.capacity << ' ' << setw(11) << s.hits << ' '
+       << setw(11) << s.misses << ' ' << setw(11) << s.evictions << ' ' << setw(11) << s.lockWaits << ' '
+       << setw(5) << fixed << setprecision(1) << (lookups ? 100.0 * s.hits / lookups : 0.0) << ' ' << setw(12);
+
+    if (s.timedHits)
+      os << s.hitNanos / s.timedHits;
+    else
+      os << '-';
+
+    os << endl;
+  }
+
+  return os;
+}
+
 }  // namespace dbbc
@@ -27,11 +27,33 @@
 #include <boost/thread.hpp>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 #include "brm.h"
 
 namespace dbbc
 {
+/**
+ * @brief counters of one FileBufferMgr shard
+ **/
+struct CacheShardStats
+{
+  uint64_t blocks;     // blocks currently cached
+  uint64_t capacity;   // max blocks of the shard
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t inserts;
+  uint64_t evictions;
+  uint64_t lockWaits;  // lock acquisitions that found the shard lock taken
+  uint64_t timedHits;  // hits timed while reporting was on
+  uint64_t hitNanos;   // total latency of the timed hits, lock wait included
+};
+
+/**
+ * @brief print one line of hit rate, hit latency and contention per shard plus a total line
+ **/
+std::ostream& formatCacheShardStats(std::ostream& os, const std::vector<CacheShardStats>& shards);
+
 class Stats
 {
  public:
@@ -20,6 +20,9 @@
 //
 // Description:  A simple Test driver for the Disk Block Buffer Cache
 //
+// Usage: tdriver [threads] [loops]     reads the blocks of the existing columns
+//        tdriver -b [threads] [loops]  benchmarks the cache alone on synthetic blocks
+//
 //
 // Author: Jason Rodriguez <jrodriguez@calpont.com>, (C) 2007
 //
@@ -245,9 +248,94 @@ void ReadLbid(const BRM::LBID_t lbid, const BRM::VER_t ver)
     cout << "found " << found << " notfound " << notfound << endl;
 }
 
+// Multi-threaded benchmark of the FileBufferMgr hit path, needs no DBRM or data files.
+// Every thread reads random blocks of a range 1/8 larger than the cache and inserts the misses.
+const uint32_t benchCacheBlocks = 131072;
+const uint32_t benchLookups = 1000000;
+FileBufferMgr* benchMgr = NULL;
+double benchSecs[1024];
+
+void* thr_bench(void* arg)
+{
+  const uint32_t thrIdx = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(arg));
+  const uint64_t lbidSpace = benchCacheBlocks + benchCacheBlocks / 8;
+  uint32_t randstate = thrIdx + 1;
+  uint8_t buf[8192] = {0};
+  struct timeval tv, tv2;
+
+  gettimeofday(&tv, NULL);
+
+  for (int idx = 0; idx < fLoops; idx++)
+  {
+    for (uint32_t i = 0; i < benchLookups; i++)
+    {
+      const LBID_t lbid = rand_r(&randstate) % lbidSpace;
+
+      if (!benchMgr->find(HashObject_t(lbid, ver, 0), buf))
+        benchMgr->insert(lbid, ver, buf);
+    }
+  }
+
+  gettimeofday(&tv2, NULL);
+  benchSecs[thrIdx] = (tv2.tv_sec - tv.tv_sec) + (tv2.tv_usec - tv.tv_usec) / 1000000.0;
+  return NULL;
+}
+
+int benchFileBufferMgr()
+{
+  FileBufferMgr fbm(benchCacheBlocks);
+  vector<uint8_t> block(8192, 0);
+  vector<CacheInsert_t> ops;
+  vector<CacheShardStats> stats;
+  pthread_t thr_id[thr_cnt];
+  double totalOps = 0;
+
+  for (uint32_t i = 0; i < benchCacheBlocks; i++)
+    ops.push_back(CacheInsert_t(i, ver, &block[0]));
+
+  fbm.bulkInsert(ops);
+  fbm.setReportingFrequency(1);  // turns on the hit latency sampling
+  benchMgr = &fbm;
+
+  cout << "FileBufferMgr benchmark: " << thr_cnt << " threads, " << fbm.shardCount() << " shards, "
+       << benchCacheBlocks << " blocks" << endl;
+
+  for (int i = 0; i < thr_cnt; i++)
+    pthread_create(&thr_id[i], NULL, thr_bench, reinterpret_cast<void*>(static_cast<uintptr_t>(i)));
+
+  for (int i = 0; i < thr_cnt; i++)
+  {
+    pthread_join(thr_id[i], NULL);
+    double ops = (double)benchLookups * fLoops / benchSecs[i];
+    totalOps += ops;
+    cout << "thr " << i << " " << benchSecs[i] << " sec " << (uint64_t)ops << " lookups/sec" << endl;
+  }
+
+  cout << "Summary " << (uint64_t)totalOps << " lookups/sec" << endl;
+  fbm.getShardStats(stats);
+  formatCacheShardStats(cout, stats);
+  return 0;
+}
+
 //
 int main(int argc, char* argv[])
 {
+  if (argc >= 2 && string(argv[1]) == "-b")
+  {
+    argc--;
+    argv++;
+
+    if (argc >= 2)
+      thr_cnt = atoi(argv[1]);
+
+    if (argc >= 3)
+      fLoops = atoi(argv[2]);
+
+    thr_cnt = max(1, min(thr_cnt, 1024));
+    fLoops = max(fLoops, 1);
+    return benchFileBufferMgr();
+  }
+
   if (argc >= 2)
     thr_cnt = atoi(argv[1]);
 
@@ -0,0 +1,71 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+// 512 bit vectorized filtering. Everything columnfiltering.h defines after its includes is built for
+// AVX-512 (F, BW, DQ) and must only be entered when simd::getSimdLevel() reports the support at runtime.
+
+#define MCS_SIMD_TARGET_AVX512
+#include "columnfiltering.h"
+
+#if defined(__x86_64__)
+namespace primitives
+{
+template <typename T, ENUM_KIND KIND>
+void vectorizedFiltering512(NewColRequestHeader* in, ColResultHeader* out, const T* srcArray,
+                            const uint32_t srcSize, uint16_t* ridArray, const uint16_t ridSize,
+                            ParsedColumnFilter* parsedColumnFilter, const bool validMinMax,
+                            const T emptyValue, const T nullValue, T Min, T Max,
+                            const bool isNullValueMatches, const uint8_t* blockAux)
+{
+  using FT = typename IntegralTypeToFilterType<T>::type;
+  using ST = typename IntegralTypeToFilterSetType<T>::type;
+  vectorizedFilteringDispatcher<T, KIND, FT, ST, simd::IntegralToSIMD512>(
+      in, out, srcArray, srcSize, ridArray, ridSize, parsedColumnFilter, validMinMax, emptyValue, nullValue,
+      Min, Max, isNullValueMatches, blockAux);
+}
+
+#define INSTANTIATE_VECTORIZED_FILTERING_512(T, KIND)                                                   \
+  template void vectorizedFiltering512<T, KIND>(                                                        \
+      NewColRequestHeader * in, ColResultHeader * out, const T* srcArray, const uint32_t srcSize,      \
+      uint16_t* ridArray, const uint16_t ridSize, ParsedColumnFilter* parsedColumnFilter,              \
+      const bool validMinMax, const T emptyValue, const T nullValue, T Min, T Max,                     \
+      const bool isNullValueMatches, const uint8_t* blockAux);
+
+INSTANTIATE_VECTORIZED_FILTERING_512(int8_t, KIND_DEFAULT)
+INSTANTIATE_VECTORIZED_FILTERING_512(int16_t, KIND_DEFAULT)
+INSTANTIATE_VECTORIZED_FILTERING_512(int32_t, KIND_DEFAULT)
+INSTANTIATE_VECTORIZED_FILTERING_512(int64_t, KIND_DEFAULT)
+INSTANTIATE_VECTORIZED_FILTERING_512(uint8_t, KIND_UNSIGNED)
+INSTANTIATE_VECTORIZED_FILTERING_512(uint16_t, KIND_UNSIGNED)
+INSTANTIATE_VECTORIZED_FILTERING_512(uint32_t, KIND_UNSIGNED)
+INSTANTIATE_VECTORIZED_FILTERING_512(uint64_t, KIND_UNSIGNED)
+INSTANTIATE_VECTORIZED_FILTERING_512(uint8_t, KIND_TEXT)
+INSTANTIATE_VECTORIZED_FILTERING_512(uint16_t, KIND_TEXT)
+INSTANTIATE_VECTORIZED_FILTERING_512(uint32_t, KIND_TEXT)
+INSTANTIATE_VECTORIZED_FILTERING_512(uint64_t, KIND_TEXT)
+INSTANTIATE_VECTORIZED_FILTERING_512(int32_t, KIND_FLOAT)
+INSTANTIATE_VECTORIZED_FILTERING_512(int64_t, KIND_FLOAT)
+
+#undef INSTANTIATE_VECTORIZED_FILTERING_512
+}  // namespace primitives
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+#endif
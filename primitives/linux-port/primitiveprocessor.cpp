@@ -32,7 +32,7 @@ using namespace std;
 namespace primitives
 {
 PrimitiveProcessor::PrimitiveProcessor(int debugLevel)
- : fDebugLevel(debugLevel), fStatsPtr(NULL), logicalBlockMode(false)
+ : encodedBlocks(NULL), fDebugLevel(debugLevel), fStatsPtr(NULL), logicalBlockMode(false)
 {
   // 	This does
   //	masks[11] = { 0, 1, 3, 7, 15, 31, 63, 127, 255, 511, 1023 };
@@ -43,6 +43,7 @@
 #include "primitivemsg.h"
 #include "calpontsystemcatalog.h"
 #include "stats.h"
+#include "filebuffer.h"
 #include "primproc.h"
 #include "hasher.h"
 
@@ -292,6 +293,17 @@ class PrimitiveProcessor
   {
     blockAux = data;
   }
+
+  /** @brief Sets the encoded copies of the physical blocks of the block to operate on
+   *
+   * One entry per 8K block, null where a block has no encoded copy.  columnScanAndFilter()
+   * evaluates the filter on the encoded values if every block has one.  Pass NULL if the
+   * block data didn't come from the block cache.
+   */
+  void setEncodedBlocks(const dbbc::SPEncodedBlock* blocks)
+  {
+    encodedBlocks = blocks;
+  }
   void setPMStatsPtr(dbbc::Stats* p)
   {
     fStatsPtr = p;
@@ -443,6 +455,7 @@ class PrimitiveProcessor
 
   int* block;
   int* blockAux;
+  const dbbc::SPEncodedBlock* encodedBlocks;
 
   bool compare(const datatypes::Charset& cs, uint8_t COP, const char* str1, size_t length1, const char* str2,
                size_t length2) throw();
@@ -129,6 +129,9 @@ BatchPrimitiveProcessor::BatchPrimitiveProcessor()
  , LBIDTrace(false)
  , fBusy(false)
  , doJoin(false)
+ , runtimeFiltersEnabled(true)
+ , runtimeFilterRowsIn(0)
+ , runtimeFilterRowsOut(0)
  , hasFilterStep(false)
  , filtOnString(false)
  , prefetchThreshold(0)
@@ -184,6 +187,9 @@ BatchPrimitiveProcessor::BatchPrimitiveProcessor(ByteStream& b, double prefetch,
  , LBIDTrace(false)
  , fBusy(false)
  , doJoin(false)
+ , runtimeFiltersEnabled(true)
+ , runtimeFilterRowsIn(0)
+ , runtimeFilterRowsOut(0)
  , hasFilterStep(false)
  , filtOnString(false)
  , prefetchThreshold(prefetch)
@@ -267,6 +273,7 @@ void BatchPrimitiveProcessor::initBPP(ByteStream& bs)
   hasRowGroup = tmp16 & HAS_ROWGROUP;
   getTupleJoinRowGroupData = tmp16 & JOIN_ROWGROUP_DATA;
   bool hasWideColumnsIn = tmp16 & HAS_WIDE_COLUMNS;
+  bool hasRuntimeFilters = tmp16 & HAS_RUNTIME_FILTERS;
 
   // This used to signify that there was input row data from previous jobsteps, and
   // it never quite worked right. No need to fix it or update it; all BPP's have started
@@ -487,6 +494,22 @@ void BatchPrimitiveProcessor::initBPP(ByteStream& bs)
       hasDictStep = true;
   }
 
+  if (hasRuntimeFilters)
+  {
+    uint32_t filterNum;
+    bs >> filterNum;
+    runtimeFilters.resize(filterNum);
+
+    for (i = 0; i < filterNum; ++i)
+    {
+      bs >> runtimeFilters[i].first;
+      runtimeFilters[i].second.reset(new joiner::JoinBloomFilter());
+      runtimeFilters[i].second->deserialize(bs);
+      idbassert(runtimeFilters[i].first < projectCount);
+      idbassert(dynamic_cast<ColumnCommand*>(projectSteps[runtimeFilters[i].first].get()) != NULL);
+    }
+  }
+
   if (ot == ROW_GROUP)
   {
     bs >> tmp8;
@@ -1131,6 +1154,29 @@ void BatchPrimitiveProcessor::initProcessor()
   asyncLoaded.reset(new bool[projectCount + 2]);
 }
 
+/* Drops the large side rows that can't find a match in a UM join before the rest of the
+ * columns are projected.  Each filter reads the key column for the rids that passed the
+ * filter steps.  If they don't drop at least 1 row out of 10 once there's some history, the
+ * extra pass over the key columns isn't worth it and they are turned off.
+ */
+void BatchPrimitiveProcessor::applyRuntimeFilters()
+{
+  const uint64_t minRowsToJudge = 64 * LOGICAL_BLOCK_RIDS;
+
+  runtimeFilterRowsIn += ridCount;
+
+  for (uint32_t i = 0; i < runtimeFilters.size() && ridCount > 0; i++)
+  {
+    ColumnCommand* cc = static_cast<ColumnCommand*>(projectSteps[runtimeFilters[i].first].get());
+    cc->applyRuntimeFilter(*runtimeFilters[i].second);
+  }
+
+  runtimeFilterRowsOut += ridCount;
+
+  if (runtimeFilterRowsIn >= minRowsToJudge && runtimeFilterRowsOut * 10 > runtimeFilterRowsIn * 9)
+    runtimeFiltersEnabled = false;
+}
+
 // This version does a join on projected rows
 // In order to prevent super size result sets in the case of near cartesian joins on three or more joins,
 // the startRid start at 0) is used to begin the rid loop and if we cut off processing early because of
@@ -1499,6 +1545,17 @@ void BatchPrimitiveProcessor::execute()
       }
     }
 
+    if (!runtimeFilters.empty() && runtimeFiltersEnabled && ot == ROW_GROUP)
+    {
+#ifdef PRIMPROC_STOPWATCH
+      stopwatch->start("- applyRuntimeFilters");
+      applyRuntimeFilters();
+      stopwatch->stop("- applyRuntimeFilters");
+#else
+      applyRuntimeFilters();
+#endif
+    }
+
 #ifdef PRIMPROC_STOPWATCH
     stopwatch->stop("BatchPrimitiveProcessor::execute second part");
     stopwatch->start("BatchPrimitiveProcessor::execute third part");
@@ -1565,14 +1622,16 @@ void BatchPrimitiveProcessor::execute()
           if (projectForFE1[j] != -1)
             projectSteps[j]->projectIntoRowGroup(fe1Input, projectForFE1[j]);
 
-        for (j = 0; j < ridCount; j++, fe1In.nextRow())
-          if (fe1->evaluate(&fe1In))
-          {
-            applyMapping(fe1ToProjection, fe1In, &fe1Out);
-            relRids[newRidCount] = relRids[j];
-            values[newRidCount++] = values[j];
-            fe1Out.nextRow();
-          }
+        fe1->evaluate(fe1Input, fePassed);
+
+        for (j = 0; j < fePassed.size(); j++)
+        {
+          fe1Input.getRow(fePassed[j], &fe1In);
+          applyMapping(fe1ToProjection, fe1In, &fe1Out);
+          relRids[newRidCount] = relRids[fePassed[j]];
+          values[newRidCount++] = values[fePassed[j]];
+          fe1Out.nextRow();
+        }
 
         ridCount = newRidCount;
       }
@@ -1622,19 +1681,15 @@ void BatchPrimitiveProcessor::execute()
           /* functionize this -> processFE2() */
           fe2Output.resetRowGroup(baseRid);
           fe2Output.getRow(0, &fe2Out);
-          fe2Input->getRow(0, &fe2In);
+          fe2->evaluate(*fe2Input, fePassed);
 
-          // cerr << "input row: " << fe2In.toString() << endl;
-          for (j = 0; j < outputRG.getRowCount(); j++, fe2In.nextRow())
+          for (j = 0; j < fePassed.size(); j++)
           {
-            if (fe2->evaluate(&fe2In))
-            {
-              applyMapping(fe2Mapping, fe2In, &fe2Out);
-              // cerr << "   passed. output row: " << fe2Out.toString() << endl;
-              fe2Out.setRid(fe2In.getRelRid());
-              fe2Output.incRowCount();
-              fe2Out.nextRow();
-            }
+            fe2Input->getRow(fePassed[j], &fe2In);
+            applyMapping(fe2Mapping, fe2In, &fe2Out);
+            fe2Out.setRid(fe2In.getRelRid());
+            fe2Output.incRowCount();
+            fe2Out.nextRow();
           }
 
           if (!fAggregator)
@@ -1700,14 +1755,24 @@ void BatchPrimitiveProcessor::execute()
         origRidCount = ridCount;  // ridCount can get modified by executeTupleJoin(). We need to keep track of
                                   // the original val.
         /* project the key columns.  If there's the filter IN the join, project everything.
-           Also need to project 'long' strings b/c executeTupleJoin may copy entire rows
-           using copyRow(), which will try to interpret the uninit'd string ptr.
-           Valgrind will legitimately complain about copying uninit'd values for the
-           other types but that is technically safe. */
+           'Long' strings of non-key columns are dictionary lookups, they are done after the
+           join only for the rows that survive it.  Until then they are set to NULL b/c
+           executeTupleJoin may copy entire rows using copyRow(), which will try to interpret
+           the uninit'd string ptr.  Valgrind will legitimately complain about copying uninit'd
+           values for the other types but that is technically safe.
+           This only moves the lookup within the BPP, the rows still go to ExeMgr with the
+           strings resolved, never with tokens. */
         for (j = 0; j < projectCount; j++)
         {
-          if (keyColumnProj[j] ||
-              (projectionMap[j] != -1 && (hasJoinFEFilters || oldRow.isLongString(projectionMap[j]))))
+          if (projectionMap[j] != -1 && !keyColumnProj[j] && !hasJoinFEFilters &&
+              oldRow.isLongString(projectionMap[j]))
+          {
+            outputRG.getRow(0, &newRow);
+
+            for (i = 0; i < ridCount; i++, newRow.nextRow())
+              newRow.setToNull(projectionMap[j]);
+          }
+          else if (keyColumnProj[j] || (projectionMap[j] != -1 && hasJoinFEFilters))
           {
 #ifdef PRIMPROC_STOPWATCH
             stopwatch->start("-- projectIntoRowGroup");
@@ -1740,8 +1805,7 @@ void BatchPrimitiveProcessor::execute()
           /* project the non-key columns */
           for (j = 0; j < projectCount; ++j)
           {
-            if (projectionMap[j] != -1 && !keyColumnProj[j] && !hasJoinFEFilters &&
-                !oldRow.isLongString(projectionMap[j]))
+            if (projectionMap[j] != -1 && !keyColumnProj[j] && !hasJoinFEFilters)
             {
 #ifdef PRIMPROC_STOPWATCH
               stopwatch->start("-- projectIntoRowGroup");
@@ -2452,6 +2516,9 @@ SBPP BatchPrimitiveProcessor::duplicate()
   for (i = 0; i < projectCount; ++i)
     bpp->projectSteps[i] = projectSteps[i]->duplicate();
 
+  // the filters are read-only, the copies share them
+  bpp->runtimeFilters = runtimeFilters;
+
   if (fAggregator.get() != NULL)
   {
     bpp->fAggregateRG = fAggregateRG;
@@ -53,6 +53,8 @@
 #include "stopwatch.h"
 #endif
 
+class DictStepTest;
+
 namespace primitiveprocessor
 {
 typedef std::tr1::unordered_map<int64_t, BRM::VSSData> VSSCache;
@@ -202,6 +204,7 @@ class BatchPrimitiveProcessor
   void serializeStrings();
 
   void asyncLoadProjectColumns();
+  void applyRuntimeFilters();
   void writeErrorMsg(const std::string& error, uint16_t errCode, bool logIt = true, bool critical = true);
 
   BPSOutputType ot;
@@ -230,6 +233,7 @@ class BatchPrimitiveProcessor
 
   /* Common space for primitive data */
   alignas(utils::MAXCOLUMNWIDTH) uint8_t blockData[BLOCK_SIZE * utils::MAXCOLUMNWIDTH];
+  dbbc::SPEncodedBlock encodedBlocks[utils::MAXCOLUMNWIDTH];  // the cache's encoded copies of blockData
   uint8_t blockDataAux[BLOCK_SIZE * execplan::AUX_COL_WIDTH];
   std::unique_ptr<uint8_t[], utils::AlignedDeleter>  outputMsg;
   uint32_t outMsgSize;
@@ -336,6 +340,12 @@ class BatchPrimitiveProcessor
   typedef std::vector<uint32_t> MatchedData[LOGICAL_BLOCK_RIDS];
   std::shared_ptr<MatchedData[]> tSmallSideMatches;
   uint32_t executeTupleJoin(uint32_t startRid, rowgroup::RowGroup& largeSideRowGroup);
+
+  /* Runtime join filters from the UM, the first field is the project step of the key column.
+     They are turned off if they don't drop enough rows to pay for the extra pass. */
+  std::vector<std::pair<uint32_t, std::shared_ptr<joiner::JoinBloomFilter>>> runtimeFilters;
+  bool runtimeFiltersEnabled;
+  uint64_t runtimeFilterRowsIn, runtimeFilterRowsOut;
   bool getTupleJoinRowGroupData;
   std::vector<rowgroup::RowGroup> smallSideRGs;
   rowgroup::RowGroup largeSideRG;
@@ -396,6 +406,7 @@ class BatchPrimitiveProcessor
   std::shared_ptr<int[]> fe1ToProjection, fe2Mapping;  // RG mappings
   boost::scoped_array<std::shared_ptr<int[]>> joinFEMappings;
   rowgroup::Row fe1In, fe1Out, fe2In, fe2Out, joinFERow;
+  std::vector<uint32_t> fePassed;  // rows of fe1Input or fe2Input that passed the filters
 
   bool hasDictStep;
 
@@ -447,6 +458,7 @@ class BatchPrimitiveProcessor
   friend class ScaledFilterCmd;
   friend class StrFilterCmd;
   friend class PseudoCC;
+  friend class ::DictStepTest;
 };
 
 }  // namespace primitiveprocessor
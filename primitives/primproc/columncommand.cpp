@@ -53,7 +53,8 @@ namespace primitiveprocessor
 {
 extern int noVB;
 
-ColumnCommand::ColumnCommand() : Command(COLUMN_COMMAND), blockCount(0), loadCount(0), suppressFilter(false)
+ColumnCommand::ColumnCommand()
+ : Command(COLUMN_COMMAND), blockCount(0), loadCount(0), suppressFilter(false), hasEncodedBlocks(false)
 {
 }
 
@@ -156,6 +157,7 @@ void ColumnCommand::_loadData()
   // iteratations of the first loop here.
   BRM::LBID_t* lbids = (BRM::LBID_t*)alloca(W * sizeof(BRM::LBID_t));
   uint8_t** blockPtrs = (uint8_t**)alloca(W * sizeof(uint8_t*));
+  dbbc::SPEncodedBlock** encodedPtrs = (dbbc::SPEncodedBlock**)alloca(W * sizeof(dbbc::SPEncodedBlock*));
   int i;
 
   _mask = mask;
@@ -169,6 +171,7 @@ void ColumnCommand::_loadData()
     {
       lbids[blocksToLoad] = primMsg->LBID + i;
       blockPtrs[blocksToLoad] = &bpp->blockData[i * BLOCK_SIZE];
+      encodedPtrs[blocksToLoad] = &bpp->encodedBlocks[i];
       blocksToLoad++;
       loadCount++;
     }
@@ -188,17 +191,24 @@ void ColumnCommand::_loadData()
     if ((primMsg->LBID + i) == oidLastLbid)
       lastBlockReached = true;
 
+    bpp->encodedBlocks[i].reset();
     blockCount++;
   }  // for
 
   /* Do the load */
   wasCached = primitiveprocessor::loadBlocks(lbids, bpp->versionInfo, bpp->txnID, colType.compressionType,
                                              blockPtrs, &blocksRead, bpp->LBIDTrace, bpp->sessionID,
-                                             blocksToLoad, &wasVersioned, willPrefetch(), &bpp->vssCache);
+                                             blocksToLoad, &wasVersioned, willPrefetch(), &bpp->vssCache,
+                                             encodedPtrs);
   bpp->cachedIO += wasCached;
   bpp->physIO += blocksRead;
   bpp->touchedBlocks += blocksToLoad;
 
+  hasEncodedBlocks = false;
+
+  for (i = 0; i < W; ++i)
+    hasEncodedBlocks = hasEncodedBlocks || bpp->encodedBlocks[i];
+
   if (hasAuxCol_)
   {
     BRM::LBID_t* lbidsAux = (BRM::LBID_t*)alloca(1 * sizeof(BRM::LBID_t));
@@ -285,6 +295,8 @@ void ColumnCommand::_issuePrimitive()
 {
   using IntegralType = typename datatypes::WidthToSIntegralType<W>::type;
   primMsg->hasAuxCol = hasAuxCol_;
+  // not every subclass loads its blocks through _loadData()
+  bpp->getPrimitiveProcessor().setEncodedBlocks(hasEncodedBlocks ? bpp->encodedBlocks : nullptr);
   // Down the call stack the code presumes outMsg buffer has enough space to store
   // ColRequestHeader + uint16_t Rids[8192] + IntegralType[8192].
   bpp->getPrimitiveProcessor().columnScanAndFilter<IntegralType>(primMsg, outMsg);
@@ -841,6 +853,74 @@ void ColumnCommand::projectIntoRowGroup(RowGroup& rg, uint32_t pos)
   projectResultRG(rg, pos);
 }
 
+template <int W>
+void ColumnCommand::_applyRuntimeFilter(const joiner::JoinBloomFilter& filter)
+{
+  using T = typename datatypes::WidthToSIntegralType<W>::type;
+  using UT = typename std::make_unsigned<T>::type;
+
+  makeStepMsg();
+  issuePrimitive();
+
+  // Versioned rows can make the output shorter than the rid list.  There is no way to line
+  // the values up with the rids then, projection sorts that out.
+  if (outMsg->NVALS != bpp->ridCount)
+    return;
+
+  const T* valuesArray =
+      primitives::getValuesArrayPosition<T>(primitives::getFirstValueArrayPosition(outMsg), 0);
+  const bool isUnsigned = filter.isUnsigned();
+  const bool hasAbsRids = (bpp->absRids.get() != nullptr);
+  const bool hasStrValues = (bpp->strValues.get() != nullptr);
+  const bool hasWideValues = (bpp->wideColumnsWidths != 0);
+  uint32_t newRidCount = 0;
+
+  bpp->ridMap = 0;
+
+  for (uint32_t i = 0; i < bpp->ridCount; i++)
+  {
+    int64_t key = (isUnsigned ? (int64_t)(UT)valuesArray[i] : (int64_t)valuesArray[i]);
+
+    if (!filter.mayContain(key))
+      continue;
+
+    // values & co. belong to the last filter step, they follow the rids
+    bpp->relRids[newRidCount] = bpp->relRids[i];
+    bpp->values[newRidCount] = bpp->values[i];
+
+    if (hasWideValues)
+      bpp->wide128Values[newRidCount] = bpp->wide128Values[i];
+
+    if (hasAbsRids)
+      bpp->absRids[newRidCount] = bpp->absRids[i];
+
+    if (hasStrValues)
+      bpp->strValues[newRidCount] = bpp->strValues[i];
+
+    bpp->ridMap |= 1 << (bpp->relRids[newRidCount] >> 9);
+    newRidCount++;
+  }
+
+  bpp->ridCount = newRidCount;
+}
+
+void ColumnCommand::applyRuntimeFilter(const joiner::JoinBloomFilter& filter)
+{
+  if (bpp->ridCount == 0)
+    return;
+
+  switch (colType.colWidth)
+  {
+    case 1: _applyRuntimeFilter<1>(filter); break;
+    case 2: _applyRuntimeFilter<2>(filter); break;
+    case 4: _applyRuntimeFilter<4>(filter); break;
+    case 8: _applyRuntimeFilter<8>(filter); break;
+    default:
+      throw NotImplementedExcept(std::string("ColumnCommand::applyRuntimeFilter does not support ") +
+                                 std::to_string(colType.colWidth) + std::string(" byte width."));
+  }
+}
+
 void ColumnCommand::nextLBID()
 {
   lbid += colType.colWidth;
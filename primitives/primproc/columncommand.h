@@ -35,6 +35,11 @@
 #include "command.h"
 #include "calpontsystemcatalog.h"
 
+namespace joiner
+{
+class JoinBloomFilter;
+}
+
 namespace primitiveprocessor
 {
 // Warning. As of 6.1.1 ColumnCommand has some code duplication.
@@ -73,6 +78,8 @@ class ColumnCommand : public Command
   virtual void prep(int8_t outputType, bool absRids);
   void project();
   void projectIntoRowGroup(rowgroup::RowGroup& rg, uint32_t pos);
+  // Drops the rids whose value can't be in the filter.  Used on project steps only.
+  void applyRuntimeFilter(const joiner::JoinBloomFilter& filter);
   void nextLBID();
   bool isScan()
   {
@@ -156,6 +163,8 @@ class ColumnCommand : public Command
   void _projectResultRGLoop(rowgroup::Row& r, const T* valuesArray, const uint32_t offset);
   template <int W>
   void _projectResultRG(rowgroup::RowGroup& rg, uint32_t pos);
+  template <int W>
+  void _applyRuntimeFilter(const joiner::JoinBloomFilter& filter);
   virtual void projectResultRG(rowgroup::RowGroup& rg, uint32_t pos);
   void removeRowsFromRowGroup(rowgroup::RowGroup&);
   void makeScanMsg();
@@ -203,6 +212,7 @@ class ColumnCommand : public Command
   uint32_t rowSize;
 
   bool wasVersioned;
+  bool hasEncodedBlocks;  // the last load got an encoded copy of some block
 
   friend class RTSCommand;
 };
@@ -40,6 +40,20 @@ using namespace std;
 using namespace messageqcpp;
 using namespace rowgroup;
 
+namespace
+{
+// The filter result cache is direct-mapped, 2^14 slots of 8 bytes each.  A
+// slot holds (token << 1) | passed, or 0 when empty; a valid token is never 0
+// since the offset index starts at 1.
+const uint32_t FILTER_CACHE_BITS = 14;
+const uint32_t FILTER_CACHE_SIZE = 1 << FILTER_CACHE_BITS;
+
+inline uint32_t filterCacheSlot(uint64_t token)
+{
+  return (token * 0x9E3779B97F4A7C15ULL) >> (64 - FILTER_CACHE_BITS);
+}
+}  // namespace
+
 namespace primitiveprocessor
 {
 extern uint32_t dictBufferSize;
@@ -133,22 +147,27 @@ void DictStep::prep(int8_t outputType, bool makeAbsRids)
   primMsg->NVALS = 0;
 }
 
-void DictStep::issuePrimitive(bool isFilter)
+void DictStep::loadDictBlock(uint64_t lbid, uint8_t* block)
 {
   bool wasCached;
   uint32_t blocksRead;
 
+  primitiveprocessor::loadBlock(lbid, bpp->versionInfo, bpp->txnID, compressionType, block, &wasCached,
+                                &blocksRead, bpp->LBIDTrace, bpp->sessionID);
+
+  if (wasCached)
+    bpp->cachedIO++;
+
+  bpp->physIO += blocksRead;
+  bpp->touchedBlocks++;
+}
+
+void DictStep::issuePrimitive(bool isFilter)
+{
   if (!(primMsg->LBID & 0x8000000000000000LL))
   {
     // std::cerr << "DS issuePrimitive lbid: " << (uint64_t)primMsg->LBID << endl;
-    primitiveprocessor::loadBlock(primMsg->LBID, bpp->versionInfo, bpp->txnID, compressionType,
-                                  bpp->blockData, &wasCached, &blocksRead, bpp->LBIDTrace, bpp->sessionID);
-
-    if (wasCached)
-      bpp->cachedIO++;
-
-    bpp->physIO += blocksRead;
-    bpp->touchedBlocks++;
+    loadDictBlock(primMsg->LBID, bpp->blockData);
   }
 #if !defined(XXX_PRIMITIVES_TOKEN_RANGES_XXX)
   bpp->pp.p_Dictionary(primMsg, &result, isFilter, charsetNumber, eqFilter, eqOp);
@@ -200,6 +219,22 @@ void DictStep::copyResultToTmpSpace(OrderedToken* ot)
   }
 }
 
+bool DictStep::getCachedFilterResult(uint64_t token, bool& passed) const
+{
+  uint64_t entry = filterCache[filterCacheSlot(token)];
+
+  if ((entry >> 1) != token)
+    return false;
+
+  passed = entry & 1;
+  return true;
+}
+
+void DictStep::cacheFilterResult(uint64_t token, bool passed)
+{
+  filterCache[filterCacheSlot(token)] = (token << 1) | passed;
+}
+
 void DictStep::copyResultToFinalPosition(OrderedToken* ot)
 {
   uint32_t i, resultPos = 0;
@@ -356,6 +391,22 @@ void DictStep::_execute()
   tmpResultCounter = 0;
   i = 0;
 
+  // A plain filter only needs to know which rows pass, so the outcome of each
+  // token can be cached.  A filter feeder needs the strings themselves.  The
+  // rows are then tracked by position, as for a feeder, so that the cached and
+  // the evaluated ones come out in the original order.
+#if !defined(XXX_PRIMITIVES_TOKEN_RANGES_XXX)
+  const bool useFilterCache = (fFilterFeeder == NOT_FEEDER);
+#else
+  const bool useFilterCache = false;  // the min/max need every string to be looked at
+#endif
+
+  if (useFilterCache && !filterCache)
+  {
+    filterCache.reset(new uint64_t[FILTER_CACHE_SIZE]);
+    memset(filterCache.get(), 0, FILTER_CACHE_SIZE * sizeof(uint64_t));
+  }
+
   while (i < bpp->ridCount)
   {
     l_lbid = ((int64_t)newRidList[i].token) >> 10;
@@ -371,10 +422,22 @@ void DictStep::_execute()
 
     while (i < bpp->ridCount && ((((int64_t)newRidList[i].token) >> 10) == l_lbid))
     {
+      bool passed;
+
+      if (useFilterCache && l_lbid >= 0 && getCachedFilterResult(newRidList[i].token, passed))
+      {
+        newRidList[i].inResult = passed;
+        tmpResultCounter += passed;
+        i++;
+        continue;
+      }
+
+      const bool byPosition = (useFilterCache || fFilterFeeder != NOT_FEEDER);
+
       if (UNLIKELY(l_lbid < 0))
-        pt[primMsg->NVALS].rid = (fFilterFeeder == NOT_FEEDER ? newRidList[i].rid : i) | 0x8000000000000000LL;
+        pt[primMsg->NVALS].rid = (byPosition ? i : newRidList[i].rid) | 0x8000000000000000LL;
       else
-        pt[primMsg->NVALS].rid = (fFilterFeeder == NOT_FEEDER ? newRidList[i].rid : i);
+        pt[primMsg->NVALS].rid = (byPosition ? i : newRidList[i].rid);
 
       pt[primMsg->NVALS].offsetIndex = newRidList[i].token & 0x3ff;
       idbassert(pt[primMsg->NVALS].offsetIndex != 0);
@@ -382,10 +445,27 @@ void DictStep::_execute()
       i++;
     }
 
+    // Every token of this block was in the cache, no need to read it
+    if (primMsg->NVALS == 0)
+      continue;
+
     memcpy(&pt[primMsg->NVALS], filterString.buf(), filterString.length());
     issuePrimitive(true);
 
-    if (fFilterFeeder == NOT_FEEDER)
+    if (useFilterCache)
+    {
+      copyResultToTmpSpace(newRidList.get());
+
+      if (l_lbid >= 0)
+      {
+        for (uint32_t j = 0; j < primMsg->NVALS; j++)
+        {
+          const OrderedToken& ot = newRidList[pt[j].rid];
+          cacheFilterResult(ot.token, ot.inResult);
+        }
+      }
+    }
+    else if (fFilterFeeder == NOT_FEEDER)
       processResult();
     else
       copyResultToTmpSpace(newRidList.get());
@@ -394,6 +474,9 @@ void DictStep::_execute()
   inputRidCount = bpp->ridCount;
   bpp->ridCount = tmpResultCounter;
 
+  if (useFilterCache)
+    copyResultToFinalPosition(newRidList.get());
+
   // check if feeding a filtercommand
   if (fFilterFeeder != NOT_FEEDER)
   {
@@ -478,6 +561,10 @@ void DictStep::_project()
   // cout << "DS: /_project() l: " << l_lbid << endl;
 }
 
+// Resolves the tokens of the current rows into strings in the rowgroup.  The
+// strings are always looked up here in PrimProc; tokens are never sent on to
+// ExeMgr.  Repeated values are stored once per rowgroup, see below.  When the
+// BPP joins, it calls this after the join so only the surviving rows pay for it.
 void DictStep::_projectToRG(RowGroup& rg, uint32_t col)
 {
   /* Need to loop over bpp->values, issuing a primitive for each LBID */
@@ -486,7 +573,7 @@ void DictStep::_projectToRG(RowGroup& rg, uint32_t col)
   int64_t o_lbid = 0;
   OldGetSigParams* pt;
   StringPtr* tmpStrings = new StringPtr[LOGICAL_BLOCK_RIDS];
-  rowgroup::Row r;
+  rowgroup::Row r, prevRow;
   boost::scoped_array<OrderedToken> newRidList;
 
   // make the OrderedToken list
@@ -502,6 +589,7 @@ void DictStep::_projectToRG(RowGroup& rg, uint32_t col)
   sort(&newRidList[0], &newRidList[bpp->ridCount], TokenSorter());
 
   rg.initRow(&r);
+  rg.initRow(&prevRow);
   uint32_t curResultCounter = 0;
   tmpResultCounter = 0;
   totalResultLength = 0;
@@ -574,8 +662,18 @@ void DictStep::_projectToRG(RowGroup& rg, uint32_t col)
       for (i = curResultCounter; i < tmpResultCounter; i++)
       {
         rg.getRow(newRidList[i].pos, &r);
+
+        // The tokens are sorted, so the rows holding the same value are next
+        // to each other.  Those share the string stored for the first one.
+        if (i > curResultCounter && newRidList[i].token == newRidList[i - 1].token)
+        {
+          r.shareField(prevRow, col);
+          continue;
+        }
+
         // std::cerr << "serializing " << tmpStrings[i] << endl;
         r.setStringField(tmpStrings[i].getConstString(), col);
+        rg.getRow(newRidList[i].pos, &prevRow);
       }
     }
     else
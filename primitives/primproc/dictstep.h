@@ -69,6 +69,10 @@ class DictStep : public Command
     compressionType = ct;
   }
 
+ protected:
+  // Reads the dictionary block into the BPP's block buffer
+  virtual void loadDictBlock(uint64_t lbid, uint8_t* block);
+
  private:
   DictStep(const DictStep&);
   DictStep& operator=(const DictStep&);
@@ -135,6 +139,12 @@ class DictStep : public Command
   void copyResultToTmpSpace(OrderedToken* ot);
   void copyResultToFinalPosition(OrderedToken* ot);
 
+  // Filter outcomes of recently seen tokens.  Dictionary tokens repeat a lot
+  // across rows and blocks, and a token always refers to the same string for
+  // the lifetime of the BPP, so the filter only has to run once per token.
+  bool getCachedFilterResult(uint64_t token, bool& passed) const;
+  void cacheFilterResult(uint64_t token, bool passed);
+
   // Worst case, 8192 tokens in the msg.  Each is 10 bytes. */
   boost::scoped_array<uint8_t> inputMsg;
   uint32_t tmpResultCounter;
@@ -159,6 +169,7 @@ class DictStep : public Command
   boost::shared_ptr<primitives::DictEqualityFilter> eqFilter;
   uint8_t eqOp;  // COMPARE_EQ or COMPARE_NE
   uint64_t fMinMax[2];
+  boost::scoped_array<uint64_t> filterCache;
 
   friend class RTSCommand;
 };
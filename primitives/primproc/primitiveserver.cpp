@@ -331,10 +331,12 @@ cleanup:
 
 }  // prefetchBlocks()
 
-// returns the # that were cached.
+// returns the # that were cached.  If encoded is given, *encoded[i] gets the encoded copy of
+// block i from the cache, blocks read by a single-block IO request don't have one.
 uint32_t loadBlocks(LBID_t* lbids, QueryContext qc, VER_t txn, int compType, uint8_t** bufferPtrs,
                     uint32_t* rCount, bool LBIDTrace, uint32_t sessionID, uint32_t blockCount,
-                    bool* blocksWereVersioned, bool doPrefetch, VSSCache* vssCache)
+                    bool* blocksWereVersioned, bool doPrefetch, VSSCache* vssCache,
+                    dbbc::SPEncodedBlock** encoded)
 {
   blockCacheClient bc(*BRPp[cacheNum(lbids[0])]);
   uint32_t blksRead = 0;
@@ -399,7 +401,7 @@ uint32_t loadBlocks(LBID_t* lbids, QueryContext qc, VER_t txn, int compType, uin
   cout << endl;
   */
 
-  ret = bc.getCachedBlocks(lbids, vers, bufferPtrs, wasCached, blockCount);
+  ret = bc.getCachedBlocks(lbids, vers, bufferPtrs, wasCached, blockCount, encoded);
 
   // Do we want to check any VB flags here?  Initial thought: no, because we have
   // no idea whether any other blocks in the prefetch range are versioned,
@@ -423,13 +425,17 @@ uint32_t loadBlocks(LBID_t* lbids, QueryContext qc, VER_t txn, int compType, uin
         lbids[l_blockCount] = lbids[i];
         vers[l_blockCount] = vers[i];
         bufferPtrs[l_blockCount] = bufferPtrs[i];
+
+        if (encoded)
+          encoded[l_blockCount] = encoded[i];
+
         vbFlags[l_blockCount] = vbFlags[i];
         cacheThisBlock[l_blockCount] = cacheThisBlock[i];
         ++l_blockCount;
       }
     }
 
-    ret += bc.getCachedBlocks(lbids, vers, bufferPtrs, wasCached, l_blockCount);
+    ret += bc.getCachedBlocks(lbids, vers, bufferPtrs, wasCached, l_blockCount, encoded);
 
     if (ret != blockCount)
     {
@@ -711,7 +717,9 @@ void loadBlock(uint64_t lbid, QueryContext v, uint32_t t, int compType, void* bu
 
           i = fp->pread(cmpBuf, cmpBufOff, cmpBufSz);
 
-          dcrc = decompressor->uncompressBlock(cmpBuf, cmpBufSz, uCmpBuf, blen);
+          size_t dictLen = 0;
+          const char* dict = compress::CompressInterface::getDictionary(&cmpHdrBuf[0], dictLen);
+          dcrc = decompressor->uncompressBlock(cmpBuf, cmpBufSz, uCmpBuf, blen, dict, dictLen);
 
           if (dcrc == 0)
           {
@@ -787,16 +795,8 @@ void loadBlock(uint64_t lbid, QueryContext v, uint32_t t, int compType, void* bu
     return;
   }
 
-  FileBuffer* fbPtr = 0;
-  bool wasBlockInCache = false;
-
-  fbPtr = bc.getBlockPtr(lbid, ver, flg);
-
-  if (fbPtr)
-  {
-    memcpy(bufferPtr, fbPtr->getData(), BLOCK_SIZE);
-    wasBlockInCache = true;
-  }
+  // the block is copied under the shard lock, its cache slot may be reused once that is released
+  bool wasBlockInCache = (bc.read(lbid, ver, bufferPtr) != 0);
 
   if (doPrefetch && !wasBlockInCache && !flg)
   {
@@ -96,7 +96,7 @@ void loadBlockAsync(uint64_t lbid, const BRM::QueryContext& q, uint32_t txn, int
 uint32_t loadBlocks(BRM::LBID_t* lbids, BRM::QueryContext q, BRM::VER_t txn, int compType,
                     uint8_t** bufferPtrs, uint32_t* rCount, bool LBIDTrace, uint32_t sessionID,
                     uint32_t blockCount, bool* wasVersioned, bool doPrefetch = true,
-                    VSSCache* vssCache = NULL);
+                    VSSCache* vssCache = NULL, dbbc::SPEncodedBlock** encoded = NULL);
 uint32_t cacheNum(uint64_t lbid);
 void buildFileName(BRM::OID_t oid, char* fileName);
 
@@ -60,6 +60,7 @@ using namespace logging;
 using namespace primitiveprocessor;
 
 #include "archcheck.h"
+#include "simd_dispatch.h"
 using namespace archcheck;
 
 #include "liboamcpp.h"
@@ -255,6 +256,7 @@ void* waitForSIGUSR1(void* p)
       for (int i = 0; i < cacheCount; i++)
       {
         BRPp[i]->formatLRUList(out);
+        BRPp[i]->formatCacheStats(out);
         cout << out.str() << "###" << endl;
       }
     }
@@ -647,6 +649,12 @@ int ServicePrimProc::Child()
   if ((strVal == "n") || (strVal == "N"))
     directIOFlag = 0;
 
+  // Caps the vector width the column filtering uses, e.g. 256 on hosts that downclock with AVX-512.
+  // The default is the widest one the CPU supports.
+  temp = toInt(cf->getConfig(primitiveServers, "MaxSimdWidth"));
+
+  if (temp > 0)
+    simd::setSimdLevel(simd::simdLevelFromBits(temp));
 
   IDBPolicy::configIDBPolicy();
 
@@ -658,7 +666,8 @@ int ServicePrimProc::Child()
        << ", pw = " << processorWeight << ", pq = " << processorQueueSize << ", nb = " << BRPBlocks
        << ", nt = " << BRPThreads << ", nc = " << cacheCount << ", ra = " << blocksReadAhead
        << ", db = " << deleteBlocks << ", mb = " << maxBlocksPerRead << ", rd = " << rotatingDestination
-       << ", tr = " << PTTrace << ", ss = " << PMSmallSide << ", bp = " << BPPCount << endl;
+       << ", tr = " << PTTrace << ", ss = " << PMSmallSide << ", bp = " << BPPCount
+       << ", sw = " << simd::simdLevelToBits(simd::getSimdLevel()) << endl;
 
   PrimitiveServer server(serverThreads, serverQueueSize, processorWeight, processorQueueSize,
                          rotatingDestination, BRPBlocks, BRPThreads, cacheCount, maxBlocksPerRead,
@@ -144,7 +144,8 @@ void cleanTempDir()
     TempDirPurpose purpose;
   };
   std::vector<Dirs> dirs{{"HashJoin", "AllowDiskBasedJoin", TempDirPurpose::Joins},
-                         {"RowAggregation", "AllowDiskBasedAggregation", TempDirPurpose::Aggregates}};
+                         {"RowAggregation", "AllowDiskBasedAggregation", TempDirPurpose::Aggregates},
+                         {"OrderBy", "AllowDiskBasedOrderBy", TempDirPurpose::Sorts}};
   const auto config = config::Config::makeConfig();
 
   for (const auto& dir : dirs)
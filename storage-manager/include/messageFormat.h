@@ -68,6 +68,10 @@ static const uint32_t SM_HEADER_LEN = sizeof(sm_msg_header);
 // the unix socket StorageManager is listening on
 __attribute__((unused)) static const char* socket_name = "\0storagemanager";
 
+// READ_SHM and WRITE_SHM only accept POSIX shared memory regions whose name begins with this.
+// The full name is <prefix><client pid>.<sequence #>
+__attribute__((unused)) static const char* shm_region_prefix = "/columnstore-sm.";
+
 #pragma GCC diagnostic pop
 
 // opcodes understood by StorageManager.  Cast these to
@@ -84,7 +88,9 @@ enum Opcodes
   LIST_DIRECTORY,
   PING,
   COPY,
-  SYNC
+  SYNC,
+  READ_SHM,
+  WRITE_SHM
 };
 
 /*
@@ -300,6 +306,51 @@ struct copy_cmd
   // use f_name as an overlay at the end of file1 to get file2.
 };
 
+/*
+    READ_SHM
+    --------
+    Like READ, but StorageManager puts the data directly into a shared memory region created by
+    the client instead of sending it back on the socket.  The client and StorageManager must be on the
+    same host, which is always the case today.
+
+    command format:
+    1-byte opcode|size_t count|off_t offset|8-byte offset in the region|
+    4-byte region name length|region name|4-byte filename length|filename
+
+    response format:
+    nothing; the return code is the number of bytes put in the region at the given offset
+*/
+struct read_shm_cmd
+{
+  uint8_t opcode;  // == READ_SHM
+  size_t count;
+  off_t offset;
+  uint64_t regionOffset;
+  f_name region;
+  // use f_name as an overlay at the end of region to get the filename
+};
+
+/*
+    WRITE_SHM
+    ---------
+    Like WRITE, but the data is taken from a shared memory region created by the client.
+
+    command format:
+    1-byte opcode|size_t count|off_t offset|8-byte offset in the region|
+    4-byte region name length|region name|4-byte filename length|filename
+
+    response format:
+*/
+struct write_shm_cmd
+{
+  uint8_t opcode;  // == WRITE_SHM
+  ssize_t count;
+  off_t offset;
+  uint64_t regionOffset;
+  f_name region;
+  // use f_name as an overlay at the end of region to get the filename
+};
+
 #pragma pack(pop)
 
 }  // namespace storagemanager
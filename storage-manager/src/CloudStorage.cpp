@@ -23,6 +23,7 @@
 #include <boost/thread/mutex.hpp>
 #include <string>
 #include <ctype.h>
+#include <errno.h>
 #include <iostream>
 
 using namespace std;
@@ -84,7 +85,18 @@ CloudStorage::CloudStorage()
   logger = SMLogging::get();
 
   bytesUploaded = bytesDownloaded = objectsDeleted = objectsCopied = objectsGotten = objectsPut =
-      existenceChecks = 0;
+      existenceChecks = rangesGotten = 0;
+}
+
+int CloudStorage::getObjectRange(const string&, off_t, size_t, std::shared_ptr<uint8_t[]>*, size_t*)
+{
+  errno = ENOTSUP;
+  return -1;
+}
+
+bool CloudStorage::supportsRangedGets() const
+{
+  return false;
 }
 
 void CloudStorage::printKPIs() const
@@ -95,6 +107,7 @@ void CloudStorage::printKPIs() const
   cout << "\tobjectsDeleted = " << objectsDeleted << endl;
   cout << "\tobjectsCopied = " << objectsCopied << endl;
   cout << "\tobjectsGotten = " << objectsGotten << endl;
+  cout << "\trangesGotten = " << rangesGotten << endl;
   cout << "\tobjectsPut = " << objectsPut << endl;
   cout << "\texistenceChecks = " << existenceChecks << endl;
 }
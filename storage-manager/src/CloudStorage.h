@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <sys/types.h>
 
 #include "SMLogging.h"
 
@@ -31,6 +33,12 @@ class CloudStorage
   virtual int getObject(const std::string& sourceKey, const std::string& destFile, size_t* size = NULL) = 0;
   virtual int getObject(const std::string& sourceKey, std::shared_ptr<uint8_t[]>* data,
                         size_t* size = NULL) = 0;
+  /* Ranged GET.  Puts up to length bytes of sourceKey starting at offset into data, and the number of bytes
+     in size.  length == 0 means through the end of the object.  Backends that can't do this return -1 with
+     errno = ENOTSUP, check supportsRangedGets() first. */
+  virtual int getObjectRange(const std::string& sourceKey, off_t offset, size_t length,
+                             std::shared_ptr<uint8_t[]>* data, size_t* size);
+  virtual bool supportsRangedGets() const;
   virtual int putObject(const std::string& sourceFile, const std::string& destKey) = 0;
   virtual int putObject(const std::shared_ptr<uint8_t[]> data, size_t len, const std::string& destKey) = 0;
   virtual int deleteObject(const std::string& key) = 0;
@@ -48,7 +56,7 @@ class CloudStorage
 
   // some KPIs
   size_t bytesUploaded, bytesDownloaded, objectsDeleted, objectsCopied, objectsGotten, objectsPut,
-      existenceChecks;
+      existenceChecks, rangesGotten;
 
  private:
 };
@@ -17,9 +17,13 @@
 
 #include "Downloader.h"
 #include "Config.h"
+#include "MetadataFile.h"
 #include "SMLogging.h"
+#include "Utilities.h"
 #include <string>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <iostream>
 #include <boost/filesystem.hpp>
 
@@ -27,15 +31,16 @@ using namespace std;
 namespace bf = boost::filesystem;
 namespace storagemanager
 {
-Downloader::Downloader() : maxDownloads(0)
+Downloader::Downloader() : maxDownloads(0), rangeSize(0)
 {
   storage = CloudStorage::get();
+  logger = SMLogging::get();
   configListener();
   Config::get()->addConfigListener(this);
   workers.setName("Downloader");
-  logger = SMLogging::get();
+  rangeWorkers.setName("Downloader ranges");
   tmpPath = "downloading";
-  bytesDownloaded = 0;
+  bytesDownloaded = rangedDownloads = 0;
 }
 
 Downloader::~Downloader()
@@ -117,6 +122,7 @@ void Downloader::download(const vector<const string*>& keys, vector<int>* errnos
 void Downloader::printKPIs() const
 {
   cout << "Downloader: bytesDownloaded = " << bytesDownloaded << endl;
+  cout << "Downloader: rangedDownloads = " << rangedDownloads << endl;
 }
 
 bool Downloader::inProgress(const string& key)
@@ -159,7 +165,12 @@ void Downloader::Download::operator()()
   if (!bf::exists(dlPath / dl->getTmpPath()))
     bf::create_directories(dlPath / dl->getTmpPath());
   bf::path tmpFile = dlPath / dl->getTmpPath() / key;
-  int err = storage->getObject(key, tmpFile.string(), &size);
+  int err;
+  size_t length = MetadataFile::getLengthFromKey(key);
+  if (dl->rangeSize != 0 && length > dl->rangeSize && storage->supportsRangedGets())
+    err = dl->rangedDownload(key, tmpFile, length, &size);
+  else
+    err = storage->getObject(key, tmpFile.string(), &size);
   if (err != 0)
   {
     dl_errno = errno;
@@ -184,6 +195,84 @@ void Downloader::Download::operator()()
   lock->unlock();
 }
 
+int Downloader::rangedDownload(const string& key, const bf::path& dest, size_t length, size_t* size)
+{
+  int fd = ::open(dest.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0)
+    return -1;
+  ScopedCloser closer(fd);
+
+  RangedDownload state;
+  uint parts = (length + rangeSize - 1) / rangeSize;
+  state.remaining = parts;
+  state.fd = fd;
+  state.dl_errno = 0;
+  state.sizes.resize(parts, 0);
+
+  // The last range goes to the end of the object rather than to the length in the key, so nothing is
+  // missed if the two disagree.
+  for (uint i = 1; i < parts; i++)
+    rangeWorkers.addJob(boost::shared_ptr<RangeGet>(
+        new RangeGet(key, i, (off_t)i * rangeSize, (i == parts - 1 ? 0 : rangeSize), &state)));
+  RangeGet(key, 0, 0, rangeSize, &state)();
+
+  boost::unique_lock<boost::mutex> s(state.mutex);
+  while (state.remaining > 0)
+    state.done.wait(s);
+
+  if (state.dl_errno)
+  {
+    errno = state.dl_errno;
+    return -1;
+  }
+
+  // A short range means the object ends there
+  *size = 0;
+  for (uint i = 0; i < parts; i++)
+  {
+    *size += state.sizes[i];
+    if (i < parts - 1 && state.sizes[i] < rangeSize)
+      break;
+  }
+  if (::ftruncate(fd, *size) < 0)
+    return -1;
+  ++rangedDownloads;
+  return 0;
+}
+
+Downloader::RangeGet::RangeGet(const string& _key, uint _part, off_t _offset, size_t _length,
+                               RangedDownload* _dl)
+ : key(_key), part(_part), offset(_offset), length(_length), dl(_dl)
+{
+}
+
+void Downloader::RangeGet::operator()()
+{
+  CloudStorage* storage = CloudStorage::get();
+  std::shared_ptr<uint8_t[]> data;
+  size_t got = 0;
+  int l_errno = 0;
+
+  if (storage->getObjectRange(key, offset, length, &data, &got))
+    l_errno = errno;
+  size_t count = 0;
+  while (l_errno == 0 && count < got)
+  {
+    ssize_t err = ::pwrite(dl->fd, &data[count], got - count, offset + count);
+    if (err < 0)
+      l_errno = errno;
+    else
+      count += err;
+  }
+
+  boost::unique_lock<boost::mutex> s(dl->mutex);
+  dl->sizes[part] = got;
+  if (l_errno && !dl->dl_errno)
+    dl->dl_errno = l_errno;
+  if (--dl->remaining == 0)
+    dl->done.notify_all();
+}
+
 Downloader::DownloadListener::DownloadListener(uint* _counter, boost::condition* condvar)
  : counter(_counter), cond(condvar)
 {
@@ -217,6 +306,7 @@ void Downloader::configListener()
   {
     maxDownloads = 20;
     workers.setMaxThreads(maxDownloads);
+    rangeWorkers.setMaxThreads(maxDownloads);
     logger->log(LOG_INFO, "max_concurrent_downloads = %u",maxDownloads);
   }
   if (stmp.empty())
@@ -230,6 +320,7 @@ void Downloader::configListener()
     {
       maxDownloads = newValue;
       workers.setMaxThreads(maxDownloads);
+      rangeWorkers.setMaxThreads(maxDownloads);
       logger->log(LOG_INFO, "max_concurrent_downloads = %u", maxDownloads);
     }
   }
@@ -237,5 +328,21 @@ void Downloader::configListener()
   {
     logger->log(LOG_CRIT, "max_concurrent_downloads is not a number. Using current value = %u", maxDownloads);
   }
+
+  // Ranged downloads
+  stmp = Config::get()->getValue("ObjectStorage", "download_range_size");
+  try
+  {
+    size_t newValue = (stmp.empty() ? 0 : stoul(stmp));
+    if (newValue != rangeSize)
+    {
+      rangeSize = newValue;
+      logger->log(LOG_INFO, "download_range_size = %zu", rangeSize);
+    }
+  }
+  catch (invalid_argument&)
+  {
+    logger->log(LOG_CRIT, "download_range_size is not a number. Using current value = %zu", rangeSize);
+  }
 }
 }  // namespace storagemanager
@@ -101,12 +101,40 @@ class Downloader : public ConfigListener
   Downloads_t downloads;
   boost::filesystem::path tmpPath;
 
+  /* Objects larger than rangeSize are fetched with concurrent ranged GETs of rangeSize bytes, if the
+     storage backend supports them.  The Download job does the first range itself and gives the rest
+     to rangeWorkers.  RangeGets never wait on anything, so they can't deadlock with the Downloads. */
+  struct RangedDownload
+  {
+    boost::mutex mutex;
+    boost::condition done;
+    uint remaining;
+    int fd;
+    int dl_errno;
+    std::vector<size_t> sizes;
+  };
+
+  struct RangeGet : public ThreadPool::Job
+  {
+    RangeGet(const std::string& key, uint part, off_t offset, size_t length, RangedDownload*);
+    void operator()();
+    const std::string key;
+    uint part;
+    off_t offset;
+    size_t length;
+    RangedDownload* dl;
+  };
+
+  int rangedDownload(const std::string& key, const boost::filesystem::path& dest, size_t length, size_t* size);
+  size_t rangeSize;
+
   ThreadPool workers;
+  ThreadPool rangeWorkers;
   CloudStorage* storage;
   SMLogging* logger;
 
   // KPIs
-  size_t bytesDownloaded;
+  size_t bytesDownloaded, rangedDownloads;
 };
 
 }  // namespace storagemanager
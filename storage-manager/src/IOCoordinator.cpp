@@ -80,6 +80,7 @@ IOCoordinator::IOCoordinator()
 
   cachePath = cache->getCachePath();
   journalPath = cache->getJournalPath();
+  prefetcher.reset(new Prefetcher());
 
   bytesRead = bytesWritten = filesOpened = filesCreated = filesCopied = filesDeleted = bytesCopied =
       filesTruncated = listingCount = callsToWrite = 0;
@@ -121,6 +122,7 @@ void IOCoordinator::printKPIs() const
   cout << "\t\tiocJournalsCreated = " << iocJournalsCreated << endl;
   cout << "\t\tiocBytesRead = " << iocBytesRead << endl;
   cout << "\t\tiocBytesWritten = " << iocBytesWritten << endl;
+  prefetcher->printKPIs();
 }
 
 int IOCoordinator::loadObject(int fd, uint8_t* data, off_t offset, size_t length)
@@ -145,19 +147,12 @@ int IOCoordinator::loadObject(int fd, uint8_t* data, off_t offset, size_t length
   return 0;
 }
 
-int IOCoordinator::loadObjectAndJournal(const char* objFilename, const char* journalFilename, uint8_t* data,
-                                        off_t offset, size_t length)
+int IOCoordinator::loadObjectAndJournal(int objFD, int journalFD, uint8_t* data, off_t offset, size_t length)
 {
-  std::shared_ptr<uint8_t[]> argh;
-
   size_t tmp = 0;
-  argh = mergeJournal(objFilename, journalFilename, offset, length, &tmp);
-  if (!argh)
-    return -1;
-  else
-    memcpy(data, argh.get(), length);
+  int err = mergeJournal(objFD, journalFD, data, offset, length, &tmp);
   iocBytesRead += tmp;
-  return 0;
+  return err;
 }
 
 ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset, size_t length)
@@ -190,7 +185,6 @@ ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset,
 
   vector<metadataObject> relevants = meta.metadataRead(offset, length);
   map<string, int> journalFDs, objectFDs;
-  map<string, string> keyToJournalName, keyToObjectName;
   utils::VLArray<ScopedCloser> fdMinders(relevants.size() * 2);
   int mindersIndex = 0;
   char buf[80];
@@ -215,7 +209,6 @@ ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset,
     int fd = ::open(jFilename.c_str(), O_RDONLY);
     if (fd >= 0)
     {
-      keyToJournalName[key] = jFilename;
       journalFDs[key] = fd;
       fdMinders[mindersIndex++].fd = fd;
       // fdMinders.push_back(SharedCloser(fd));
@@ -244,7 +237,6 @@ ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset,
       errno = l_errno;
       return -1;
     }
-    keyToObjectName[key] = oFilename;
     objectFDs[key] = fd;
     fdMinders[mindersIndex++].fd = fd;
     // fdMinders.push_back(SharedCloser(fd));
@@ -276,8 +268,7 @@ ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset,
     if (jit == journalFDs.end())
       err = loadObject(objectFDs[object.key], &data[count], thisOffset, thisLength);
     else
-      err = loadObjectAndJournal(keyToObjectName[object.key].c_str(), keyToJournalName[object.key].c_str(),
-                                 &data[count], thisOffset, thisLength);
+      err = loadObjectAndJournal(objectFDs[object.key], jit->second, &data[count], thisOffset, thisLength);
     if (err)
     {
       fileLock.unlock();
@@ -292,8 +283,19 @@ ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset,
   }
 
 out:
+  // if this file is being read sequentially, start loading the objects that follow
+  off_t prefetchOffset;
+  size_t prefetchLength;
+  vector<string> prefetchKeys;
+  prefetcher->readHappened(filename.string(), offset, count, objectSize, &prefetchOffset, &prefetchLength);
+  if (prefetchLength > 0)
+    for (const auto& object : meta.metadataRead(prefetchOffset, prefetchLength))
+      if (object.offset >= (uint64_t)offset + count)
+        prefetchKeys.push_back(object.key);
+
   fileLock.unlock();
   cache->doneReading(firstDir, keys);
+  prefetcher->prefetch(firstDir, prefetchKeys);
   // all done
   bytesRead += length;
   return count;
@@ -1192,9 +1194,97 @@ std::shared_ptr<char[]> seekToEndOfHeader1(int fd, size_t* _bytesRead)
   throw runtime_error("seekToEndOfHeader1: did not find the end of the header");
 }
 
-int IOCoordinator::mergeJournal(int objFD, int journalFD, uint8_t* buf, off_t offset, size_t* len) const
+int IOCoordinator::mergeJournal(int objFD, int journalFD, uint8_t* buf, off_t offset, size_t len,
+                                size_t* _bytesReadOut) const
 {
-  throw runtime_error("IOCoordinator::mergeJournal(int, int, etc) is not implemented yet.");
+  size_t l_bytesRead = 0;
+  *_bytesReadOut = 0;
+
+  // read the object into buf
+  size_t count = 0;
+  while (count < len)
+  {
+    ssize_t err = ::pread(objFD, &buf[count], len - count, offset + count);
+    if (err < 0)
+    {
+      int l_errno = errno;
+      char errbuf[80];
+      logger->log(LOG_CRIT, "IOC::mergeJournal(): failed to read the object, got '%s'",
+                  strerror_r(l_errno, errbuf, 80));
+      errno = l_errno;
+      *_bytesReadOut = count;
+      return -1;
+    }
+    else if (err == 0)
+      // at the EOF of the object.  The journal may contain entries that append to the data,
+      break;
+    count += err;
+  }
+  l_bytesRead += count;
+  if (count < len)
+    memset(&buf[count], 0, len - count);
+
+  ::lseek(journalFD, 0, SEEK_SET);
+  size_t headerLen = 0;
+  std::shared_ptr<char[]> headertxt = seekToEndOfHeader1(journalFD, &headerLen);
+  l_bytesRead += headerLen;
+  stringstream ss;
+  ss << headertxt.get();
+  boost::property_tree::ptree header;
+  boost::property_tree::json_parser::read_json(ss, header);
+  assert(header.get<int>("version") == 1);
+
+  // start processing the entries
+  uint64_t lastBufOffset = offset + len;
+  while (1)
+  {
+    uint64_t offlen[2];
+    ssize_t err = ::read(journalFD, &offlen, 16);
+    if (err == 0)  // got EOF
+      break;
+    else if (err < 16)
+    {
+      logger->log(LOG_ERR, "mergeJournal: failed to read a journal entry header");
+      errno = (err < 0 ? errno : ENODATA);
+      *_bytesReadOut = l_bytesRead;
+      return -1;
+    }
+    l_bytesRead += 16;
+
+    uint64_t lastJournalOffset = offlen[0] + offlen[1];
+    if (offlen[0] > lastBufOffset || lastJournalOffset < (uint64_t)offset)
+    {
+      // skip over this journal entry
+      ::lseek(journalFD, offlen[1], SEEK_CUR);
+      continue;
+    }
+
+    // this entry overlaps, read the overlapping section straight into buf
+    uint64_t startReadingAt = max(offlen[0], (uint64_t)offset);
+    uint64_t lengthOfRead = min(lastBufOffset, lastJournalOffset) - startReadingAt;
+    off_t entryPos = ::lseek(journalFD, 0, SEEK_CUR);
+
+    count = 0;
+    while (count < lengthOfRead)
+    {
+      err = ::pread(journalFD, &buf[startReadingAt - offset + count], lengthOfRead - count,
+                    entryPos + (startReadingAt - offlen[0]) + count);
+      if (err <= 0)
+      {
+        int l_errno = (err < 0 ? errno : ENODATA);
+        char errbuf[80];
+        logger->log(LOG_ERR, "mergeJournal: got %s", strerror_r(l_errno, errbuf, 80));
+        errno = l_errno;
+        *_bytesReadOut = l_bytesRead + count;
+        return -1;
+      }
+      count += err;
+    }
+    l_bytesRead += lengthOfRead;
+    ::lseek(journalFD, entryPos + offlen[1], SEEK_SET);
+  }
+  *_bytesReadOut = l_bytesRead;
+  return 0;
 }
 
 std::shared_ptr<uint8_t[]> IOCoordinator::mergeJournal(const char* object, const char* journal,
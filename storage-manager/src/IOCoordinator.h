@@ -34,6 +34,7 @@
 #include "Replicator.h"
 #include "Utilities.h"
 #include "Ownership.h"
+#include "Prefetcher.h"
 
 namespace storagemanager
 {
@@ -71,10 +72,10 @@ class IOCoordinator : public boost::noncopyable
 
   // this version takes already-open file descriptors, and an already-allocated buffer as input.
   // file descriptor are positioned, eh, best not to assume anything about their positions
-  // on return.
-  // Not implemented yet.  At the point of this writing, we will use the existing versions, even though
-  // it's wasteful, and will leave this as a likely future optimization.
-  int mergeJournal(int objFD, int journalFD, uint8_t* buf, off_t offset, size_t* len) const;
+  // on return.  It merges len bytes starting at offset directly into buf, so read() can put
+  // the data straight into the caller's buffer, which may be a client's shared memory region.
+  // Returns 0 on success, -1 and sets errno on error.
+  int mergeJournal(int objFD, int journalFD, uint8_t* buf, off_t offset, size_t len, size_t* sizeRead) const;
 
   /* Lock manipulation fcns.  They can lock on any param given to them.  For convention's sake,
      the parameter should mostly be the abs filename being accessed. */
@@ -97,6 +98,7 @@ class IOCoordinator : public boost::noncopyable
   SMLogging* logger;
   Replicator* replicator;
   Ownership ownership;  // ACK!  Need a new name for this!
+  boost::scoped_ptr<Prefetcher> prefetcher;
 
   size_t objectSize;
   boost::filesystem::path journalPath;
@@ -113,8 +115,7 @@ class IOCoordinator : public boost::noncopyable
   ssize_t _write(const boost::filesystem::path& filename, const uint8_t* data, off_t offset, size_t length,
                  const boost::filesystem::path& firstDir);
 
-  int loadObjectAndJournal(const char* objFilename, const char* journalFilename, uint8_t* data, off_t offset,
-                           size_t length);
+  int loadObjectAndJournal(int objFD, int journalFD, uint8_t* data, off_t offset, size_t length);
   int loadObject(int fd, uint8_t* data, off_t offset, size_t length);
 
   // some KPIs
@@ -23,6 +23,7 @@
 #include <time.h>
 #include "LocalStorage.h"
 #include "Config.h"
+#include "Utilities.h"
 
 using namespace std;
 namespace bf = boost::filesystem;
@@ -58,9 +59,17 @@ LocalStorage::LocalStorage()
     }
     r_seed = (uint)::time(NULL);
     logger->log(LOG_DEBUG, "LocalStorage:  Will simulate cloud latency of max %llu us", usecLatencyCap);
+    stmp = Config::get()->getValue("LocalStorage", "max_bandwidth");
+    bytesPerSec = strtoull(stmp.c_str(), NULL, 10);
+    if (bytesPerSec)
+      logger->log(LOG_DEBUG, "LocalStorage:  Will simulate cloud bandwidth of %llu bytes/s per request",
+                  bytesPerSec);
   }
   else
+  {
     fakeLatency = false;
+    bytesPerSec = 0;
+  }
 
   bytesRead = bytesWritten = 0;
 }
@@ -82,11 +91,13 @@ const bf::path& LocalStorage::getPrefix() const
   return prefix;
 }
 
-inline void LocalStorage::addLatency()
+inline void LocalStorage::addLatency(size_t bytesTransferred)
 {
   if (fakeLatency)
   {
     uint64_t usec_delay = ((double)rand_r(&r_seed) / (double)RAND_MAX) * usecLatencyCap;
+    if (bytesPerSec)
+      usec_delay += bytesTransferred * 1000000 / bytesPerSec;
     ::usleep(usec_delay);
   }
 }
@@ -113,7 +124,9 @@ bf::path operator+(const bf::path& p1, const bf::path& p2)
 
 int LocalStorage::getObject(const string& source, const string& dest, size_t* size)
 {
-  addLatency();
+  boost::system::error_code berr;
+  size_t srcSize = bf::file_size(prefix / source, berr);
+  addLatency(berr ? 0 : srcSize);
 
   int ret = copy(prefix / source, dest);
   if (ret)
@@ -129,7 +142,6 @@ int LocalStorage::getObject(const string& source, const string& dest, size_t* si
 
 int LocalStorage::getObject(const std::string& sourceKey, std::shared_ptr<uint8_t[]>* data, size_t* size)
 {
-  addLatency();
 
   bf::path source = prefix / sourceKey;
   const char* c_source = source.string().c_str();
@@ -140,6 +152,7 @@ int LocalStorage::getObject(const std::string& sourceKey, std::shared_ptr<uint8_
   if (fd < 0)
   {
     l_errno = errno;
+    addLatency();
     // logger->log(LOG_WARNING, "LocalStorage::getObject() failed to open %s, got '%s'", c_source,
     // strerror_r(errno, buf, 80));
     errno = l_errno;
@@ -147,6 +160,7 @@ int LocalStorage::getObject(const std::string& sourceKey, std::shared_ptr<uint8_
   }
 
   size_t l_size = bf::file_size(source);
+  addLatency(l_size);
   data->reset(new uint8_t[l_size]);
   size_t count = 0;
   while (count < l_size)
@@ -172,6 +186,53 @@ int LocalStorage::getObject(const std::string& sourceKey, std::shared_ptr<uint8_
   return 0;
 }
 
+int LocalStorage::getObjectRange(const std::string& sourceKey, off_t offset, size_t length,
+                                 std::shared_ptr<uint8_t[]>* data, size_t* size)
+{
+  bf::path source = prefix / sourceKey;
+  int fd = ::open(source.string().c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    int l_errno = errno;
+    addLatency();
+    errno = l_errno;
+    return fd;
+  }
+  ScopedCloser s(fd);
+
+  struct stat statbuf;
+  if (::fstat(fd, &statbuf) < 0)
+    return -1;
+  size_t l_size = (offset < statbuf.st_size ? statbuf.st_size - offset : 0);
+  if (length != 0 && length < l_size)
+    l_size = length;
+  addLatency(l_size);
+
+  data->reset(new uint8_t[l_size]);
+  size_t count = 0;
+  while (count < l_size)
+  {
+    ssize_t err = ::pread(fd, &(*data)[count], l_size - count, offset + count);
+    if (err < 0)
+    {
+      bytesRead += count;
+      return -1;
+    }
+    if (err == 0)
+      break;
+    count += err;
+  }
+  *size = count;
+  bytesRead += count;
+  ++rangesGotten;
+  return 0;
+}
+
+bool LocalStorage::supportsRangedGets() const
+{
+  return true;
+}
+
 int LocalStorage::putObject(const string& source, const string& dest)
 {
   addLatency();
@@ -33,6 +33,9 @@ class LocalStorage : public CloudStorage
 
   int getObject(const std::string& sourceKey, const std::string& destFile, size_t* size = NULL);
   int getObject(const std::string& sourceKey, std::shared_ptr<uint8_t[]>* data, size_t* size = NULL);
+  int getObjectRange(const std::string& sourceKey, off_t offset, size_t length, std::shared_ptr<uint8_t[]>* data,
+                     size_t* size);
+  bool supportsRangedGets() const;
   int putObject(const std::string& sourceFile, const std::string& destKey);
   int putObject(const std::shared_ptr<uint8_t[]> data, size_t len, const std::string& destKey);
   int deleteObject(const std::string& key);
@@ -49,11 +52,13 @@ class LocalStorage : public CloudStorage
   boost::filesystem::path prefix;
   int copy(const boost::filesystem::path& sourceKey, const boost::filesystem::path& destKey);
 
-  // stuff for faking the latency on cloud ops
+  // stuff for faking the latency on cloud ops.  bytesPerSec simulates the throughput of a single
+  // connection to cloud storage, it's applied to the data fetched by the get fcns.
   bool fakeLatency;
   uint64_t usecLatencyCap;
+  uint64_t bytesPerSec;
   uint r_seed;
-  void addLatency();
+  void addLatency(size_t bytesTransferred = 0);
 };
 
 }  // namespace storagemanager
@@ -37,6 +37,10 @@
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/uuid/random_generator.hpp>
+#include <atomic>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
 #define max(x, y) (x > y ? x : y)
@@ -51,6 +55,10 @@ namespace
 boost::mutex mdfLock;
 storagemanager::MetadataFile::MetadataConfig* inst = NULL;
 uint64_t metadataFilesAccessed = 0;
+std::atomic<uint64_t> tmpFileCounter(0);
+
+const char binaryMagic[4] = {'S', 'M', 'M', 'D'};
+const uint32_t binaryVersion = 2;  // the JSON format is version 1
 }  // namespace
 
 namespace storagemanager
@@ -105,6 +113,10 @@ MetadataFile::MetadataConfig::MetadataConfig()
     logger->log(LOG_CRIT, "Failed to create %s, got: %s", msMetadataPath.c_str(), e.what());
     throw e;
   }
+
+  // json keeps writing the old format, for tools that read metadata files directly
+  string format = config->getValue("ObjectStorage", "metadata_format");
+  mWriteJson = (format == "json" || format == "JSON");
 }
 
 MetadataFile::MetadataFile()
@@ -113,6 +125,7 @@ MetadataFile::MetadataFile()
   mpLogger = SMLogging::get();
   mVersion = 1;
   mRevision = 1;
+  mModified = false;
   _exists = false;
 }
 
@@ -120,28 +133,29 @@ MetadataFile::MetadataFile(const boost::filesystem::path& filename)
 {
   mpConfig = MetadataConfig::get();
   mpLogger = SMLogging::get();
+  mModified = false;
   _exists = true;
 
   mFilename = mpConfig->msMetadataPath / (filename.string() + ".meta");
 
-  boost::unique_lock<boost::mutex> s(jsonCache.getMutex());
-  jsontree = jsonCache.get(mFilename);
-  if (!jsontree)
+  boost::unique_lock<boost::mutex> s(metadataCache.getMutex());
+  image = metadataCache.get(mFilename);
+  if (!image)
   {
-    if (boost::filesystem::exists(mFilename))
+    image = MetadataImage::load(mFilename);
+    if (image)
     {
-      jsontree.reset(new bpt::ptree());
-      boost::property_tree::read_json(mFilename.string(), *jsontree);
-      jsonCache.put(mFilename, jsontree);
+      metadataCache.put(mFilename, image);
       s.unlock();
       mVersion = 1;
-      mRevision = jsontree->get<int>("revision");
+      mRevision = image->revision();
+      convertFromJson();
     }
     else
     {
       mVersion = 1;
       mRevision = 1;
-      makeEmptyJsonTree();
+      makeEmptyImage();
       s.unlock();
       writeMetadata();
     }
@@ -150,7 +164,7 @@ MetadataFile::MetadataFile(const boost::filesystem::path& filename)
   {
     s.unlock();
     mVersion = 1;
-    mRevision = jsontree->get<int>("revision");
+    mRevision = image->revision();
   }
   ++metadataFilesAccessed;
 }
@@ -159,32 +173,33 @@ MetadataFile::MetadataFile(const boost::filesystem::path& filename, no_create_t,
 {
   mpConfig = MetadataConfig::get();
   mpLogger = SMLogging::get();
+  mModified = false;
 
   mFilename = filename;
 
   if (appendExt)
     mFilename = mpConfig->msMetadataPath / (mFilename.string() + ".meta");
 
-  boost::unique_lock<boost::mutex> s(jsonCache.getMutex());
-  jsontree = jsonCache.get(mFilename);
-  if (!jsontree)
+  boost::unique_lock<boost::mutex> s(metadataCache.getMutex());
+  image = metadataCache.get(mFilename);
+  if (!image)
   {
-    if (boost::filesystem::exists(mFilename))
+    image = MetadataImage::load(mFilename);
+    if (image)
     {
       _exists = true;
-      jsontree.reset(new bpt::ptree());
-      boost::property_tree::read_json(mFilename.string(), *jsontree);
-      jsonCache.put(mFilename, jsontree);
+      metadataCache.put(mFilename, image);
       s.unlock();
       mVersion = 1;
-      mRevision = jsontree->get<int>("revision");
+      mRevision = image->revision();
+      convertFromJson();
     }
     else
     {
       mVersion = 1;
       mRevision = 1;
       _exists = false;
-      makeEmptyJsonTree();
+      makeEmptyImage();
     }
   }
   else
@@ -192,7 +207,7 @@ MetadataFile::MetadataFile(const boost::filesystem::path& filename, no_create_t,
     s.unlock();
     _exists = true;
     mVersion = 1;
-    mRevision = jsontree->get<int>("revision");
+    mRevision = image->revision();
   }
   ++metadataFilesAccessed;
 }
@@ -201,13 +216,28 @@ MetadataFile::~MetadataFile()
 {
 }
 
-void MetadataFile::makeEmptyJsonTree()
+void MetadataFile::makeEmptyImage()
 {
-  jsontree.reset(new bpt::ptree());
-  boost::property_tree::ptree objs;
-  jsontree->put("version", mVersion);
-  jsontree->put("revision", mRevision);
-  jsontree->add_child("objects", objs);
+  image = MetadataImage::create(mRevision, vector<metadataObject>());
+}
+
+// Rewrites a metadata file loaded from JSON in the binary format.  The caller holds at least a read
+// lock on the file, the worst a concurrent conversion can do is replace it with the same content.
+void MetadataFile::convertFromJson()
+{
+  if (!image->fromJson() || mpConfig->mWriteJson)
+    return;
+
+  try
+  {
+    writeMetadata();
+  }
+  catch (exception& e)
+  {
+    // the JSON file is still usable, try again next time it's loaded
+    mpLogger->log(LOG_WARNING, "MetadataFile: failed to convert %s to the binary format, got: %s",
+                  mFilename.string().c_str(), e.what());
+  }
 }
 
 void MetadataFile::printKPIs()
@@ -227,15 +257,11 @@ int MetadataFile::stat(struct stat* out) const
 
 size_t MetadataFile::getLength() const
 {
-  size_t totalSize = 0;
+  size_t count = objectCount();
 
-  auto& objects = jsontree->get_child("objects");
-  if (!objects.empty())
-  {
-    auto& lastObject = objects.back().second;
-    totalSize = lastObject.get<off_t>("offset") + lastObject.get<size_t>("length");
-  }
-  return totalSize;
+  if (count == 0)
+    return 0;
+  return objectOffset(count - 1) + objectLength(count - 1);
 }
 
 bool MetadataFile::exists() const
@@ -243,51 +269,111 @@ bool MetadataFile::exists() const
   return _exists;
 }
 
-vector<metadataObject> MetadataFile::metadataRead(off_t offset, size_t length) const
+size_t MetadataFile::objectCount() const
 {
-  // this version assumes mObjects is sorted by offset, and there are no gaps between objects
-  vector<metadataObject> ret;
-  size_t foundLen = 0;
+  return (mModified ? mObjects.size() : image->size());
+}
+
+uint64_t MetadataFile::objectOffset(size_t i) const
+{
+  return (mModified ? mObjects[i].offset : (*image)[i].offset);
+}
+
+uint64_t MetadataFile::objectLength(size_t i) const
+{
+  return (mModified ? mObjects[i].length : (*image)[i].length);
+}
+
+metadataObject MetadataFile::object(size_t i) const
+{
+  if (mModified)
+    return mObjects[i];
+  return metadataObject((*image)[i].offset, (*image)[i].length, image->key(i));
+}
+
+size_t MetadataFile::lowerBound(uint64_t offset) const
+{
+  size_t first = 0, count = objectCount();
+
+  while (count > 0)
+  {
+    size_t step = count / 2;
+    if (objectOffset(first + step) < offset)
+    {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else
+      count = step;
+  }
+  return first;
+}
+
+size_t MetadataFile::findObject(off_t offset) const
+{
+  size_t i = lowerBound(offset);
+
+  if (i < objectCount() && objectOffset(i) == (uint64_t)offset)
+    return i;
+  return objectCount();
+}
 
-  /* For first cut of optimizations, going to generate mObjects as it was to use the existing alg
-     rather than write a new alg.
-  */
-  set<metadataObject> mObjects;
-  BOOST_FOREACH (const boost::property_tree::ptree::value_type& v, jsontree->get_child("objects"))
+// copies the object list out of the shared image the first time this instance changes it
+vector<metadataObject>& MetadataFile::modifyObjects()
+{
+  if (!mModified)
   {
-    mObjects.insert(metadataObject(v.second.get<uint64_t>("offset"), v.second.get<uint64_t>("length"),
-                                   v.second.get<string>("key")));
+    size_t count = image->size();
+    mObjects.clear();
+    mObjects.reserve(count + 1);
+    for (size_t i = 0; i < count; i++)
+      mObjects.push_back(object(i));
+    mModified = true;
   }
+  return mObjects;
+}
+
+vector<metadataObject> MetadataFile::metadataRead(off_t offset, size_t length) const
+{
+  // this version assumes the objects are sorted by offset, and there are no gaps between objects
+  vector<metadataObject> ret;
+  size_t foundLen = 0;
+  size_t count = objectCount();
 
-  if (mObjects.size() == 0)
+  if (count == 0)
     return ret;
 
-  uint64_t lastOffset = mObjects.rbegin()->offset;
-  auto i = mObjects.begin();
+  uint64_t lastOffset = objectOffset(count - 1);
+  // start with the last object that begins at or before offset
+  size_t i = lowerBound(offset);
+  if (i == count || objectOffset(i) > (uint64_t)offset)
+    i = (i == 0 ? 0 : i - 1);
+
   // find the first object in range
-  // Note, the last object in mObjects may not be full, compare the last one against its maximum
+  // Note, the last object may not be full, compare the last one against its maximum
   // size rather than its current size.
-  while (i != mObjects.end())
+  while (i < count)
   {
-    if ((uint64_t)offset <= (i->offset + i->length - 1) ||
-        (i->offset == lastOffset && ((uint64_t)offset <= i->offset + mpConfig->mObjectSize - 1)))
+    uint64_t iOffset = objectOffset(i), iLength = objectLength(i);
+    if ((uint64_t)offset <= (iOffset + iLength - 1) ||
+        (iOffset == lastOffset && ((uint64_t)offset <= iOffset + mpConfig->mObjectSize - 1)))
     {
-      foundLen = (i->offset == lastOffset ? mpConfig->mObjectSize : i->length) - (offset - i->offset);
-      ret.push_back(*i);
+      foundLen = (iOffset == lastOffset ? mpConfig->mObjectSize : iLength) - (offset - iOffset);
+      ret.push_back(object(i));
       ++i;
       break;
     }
     ++i;
   }
 
-  while (i != mObjects.end() && foundLen < length)
+  while (i < count && foundLen < length)
   {
-    ret.push_back(*i);
-    foundLen += i->length;
+    ret.push_back(object(i));
+    foundLen += objectLength(i);
     ++i;
   }
 
-  assert(!(offset == 0 && length == getLength()) || (ret.size() == mObjects.size()));
+  assert(!(offset == 0 && length == getLength()) || (ret.size() == count));
   return ret;
 }
 
@@ -298,20 +384,13 @@ metadataObject MetadataFile::addMetadataObject(const boost::filesystem::path& fi
   //
 
   metadataObject addObject;
-  auto& objects = jsontree->get_child("objects");
+  vector<metadataObject>& objects = modifyObjects();
   if (!objects.empty())
-  {
-    auto& lastObject = objects.back().second;
-    addObject.offset = lastObject.get<off_t>("offset") + mpConfig->mObjectSize;
-  }
+    addObject.offset = objects.back().offset + mpConfig->mObjectSize;
 
   addObject.length = length;
   addObject.key = getNewKey(filename.string(), addObject.offset, addObject.length);
-  boost::property_tree::ptree object;
-  object.put("offset", addObject.offset);
-  object.put("length", addObject.length);
-  object.put("key", addObject.key);
-  objects.push_back(make_pair("", object));
+  objects.push_back(addObject);
 
   return addObject;
 }
@@ -322,53 +401,52 @@ int MetadataFile::writeMetadata()
   if (!boost::filesystem::exists(mFilename.parent_path()))
     boost::filesystem::create_directories(mFilename.parent_path());
 
-  write_json(mFilename.string(), *jsontree);
+  if (mModified)
+  {
+    image = MetadataImage::create(mRevision, mObjects);
+    mObjects.clear();
+    mModified = false;
+  }
+  image->write(mFilename, mpConfig->mWriteJson);
   _exists = true;
 
-  boost::unique_lock<boost::mutex> s(jsonCache.getMutex());
-  jsonCache.put(mFilename, jsontree);
+  boost::unique_lock<boost::mutex> s(metadataCache.getMutex());
+  metadataCache.put(mFilename, image);
 
   return 0;
 }
 
 bool MetadataFile::getEntry(off_t offset, metadataObject* out) const
 {
-  metadataObject addObject;
-  BOOST_FOREACH (const boost::property_tree::ptree::value_type& v, jsontree->get_child("objects"))
-  {
-    if (v.second.get<off_t>("offset") == offset)
-    {
-      out->offset = offset;
-      out->length = v.second.get<size_t>("length");
-      out->key = v.second.get<string>("key");
-      return true;
-    }
-  }
-  return false;
+  size_t i = findObject(offset);
+
+  if (i == objectCount())
+    return false;
+  *out = object(i);
+  return true;
 }
 
 void MetadataFile::removeEntry(off_t offset)
 {
-  bpt::ptree& objects = jsontree->get_child("objects");
-  for (bpt::ptree::iterator it = objects.begin(); it != objects.end(); ++it)
+  size_t i = findObject(offset);
+
+  if (i != objectCount())
   {
-    if (it->second.get<off_t>("offset") == offset)
-    {
-      objects.erase(it);
-      break;
-    }
+    vector<metadataObject>& objects = modifyObjects();
+    objects.erase(objects.begin() + i);
   }
 }
 
 void MetadataFile::removeAllEntries()
 {
-  jsontree->get_child("objects").clear();
+  mObjects.clear();
+  mModified = true;
 }
 
 void MetadataFile::deletedMeta(const bf::path& p)
 {
-  boost::unique_lock<boost::mutex> s(jsonCache.getMutex());
-  jsonCache.erase(p);
+  boost::unique_lock<boost::mutex> s(metadataCache.getMutex());
+  metadataCache.erase(p);
 }
 
 // There are more efficient ways to do it.  Optimize if necessary.
@@ -466,23 +544,22 @@ void MetadataFile::setLengthInKey(string& key, size_t newLength)
 
 void MetadataFile::printObjects() const
 {
-  BOOST_FOREACH (const boost::property_tree::ptree::value_type& v, jsontree->get_child("objects"))
+  for (size_t i = 0; i < objectCount(); i++)
   {
-    printf("Name: %s Length: %zu Offset: %lld\n", v.second.get<string>("key").c_str(),
-           v.second.get<size_t>("length"), (long long)v.second.get<off_t>("offset"));
+    metadataObject o = object(i);
+    printf("Name: %s Length: %zu Offset: %lld\n", o.key.c_str(), (size_t)o.length, (long long)o.offset);
   }
 }
 
 void MetadataFile::updateEntry(off_t offset, const string& newName, size_t newLength)
 {
-  for (auto& v : jsontree->get_child("objects"))
+  size_t i = findObject(offset);
+  if (i != objectCount())
   {
-    if (v.second.get<off_t>("offset") == offset)
-    {
-      v.second.put("key", newName);
-      v.second.put("length", newLength);
-      return;
-    }
+    vector<metadataObject>& objects = modifyObjects();
+    objects[i].key = newName;
+    objects[i].length = newLength;
+    return;
   }
   stringstream ss;
   ss << "MetadataFile::updateEntry(): failed to find object at offset " << offset;
@@ -492,13 +569,11 @@ void MetadataFile::updateEntry(off_t offset, const string& newName, size_t newLe
 
 void MetadataFile::updateEntryLength(off_t offset, size_t newLength)
 {
-  for (auto& v : jsontree->get_child("objects"))
+  size_t i = findObject(offset);
+  if (i != objectCount())
   {
-    if (v.second.get<off_t>("offset") == offset)
-    {
-      v.second.put("length", newLength);
-      return;
-    }
+    modifyObjects()[i].length = newLength;
+    return;
   }
   stringstream ss;
   ss << "MetadataFile::updateEntryLength(): failed to find object at offset " << offset;
@@ -508,11 +583,7 @@ void MetadataFile::updateEntryLength(off_t offset, size_t newLength)
 
 off_t MetadataFile::getMetadataNewObjectOffset()
 {
-  auto& objects = jsontree->get_child("objects");
-  if (objects.empty())
-    return 0;
-  auto& lastObject = jsontree->get_child("objects").back().second;
-  return lastObject.get<off_t>("offset") + lastObject.get<size_t>("length");
+  return getLength();
 }
 
 metadataObject::metadataObject() : offset(0), length(0)
@@ -538,7 +609,7 @@ inline boost::mutex& MetadataFile::MetadataCache::getMutex()
   return mutex;
 }
 
-MetadataFile::Jsontree_t MetadataFile::MetadataCache::get(const bf::path& p)
+MetadataFile::Image_t MetadataFile::MetadataCache::get(const bf::path& p)
 {
   auto it = lookup.find(p.string());
   if (it != lookup.end())
@@ -547,15 +618,20 @@ MetadataFile::Jsontree_t MetadataFile::MetadataCache::get(const bf::path& p)
     return it->second.first;
   }
 
-  return storagemanager::MetadataFile::Jsontree_t();
+  return storagemanager::MetadataFile::Image_t();
 }
 
-// note, does not change an existing jsontree.  This should be OK.
-void MetadataFile::MetadataCache::put(const bf::path& p, const Jsontree_t& j)
+// images are immutable, a new version of the file replaces the existing entry
+void MetadataFile::MetadataCache::put(const bf::path& p, const Image_t& j)
 {
   string sp = p.string();
   auto it = lookup.find(sp);
-  if (it == lookup.end())
+  if (it != lookup.end())
+  {
+    it->second.first = j;
+    lru.splice(lru.end(), lru, it->second.second);
+  }
+  else
   {
     while (lru.size() >= max_lru_size)
     {
@@ -578,6 +654,179 @@ void MetadataFile::MetadataCache::erase(const bf::path& p)
   }
 }
 
-MetadataFile::MetadataCache MetadataFile::jsonCache;
+MetadataFile::MetadataCache MetadataFile::metadataCache;
+
+MetadataImage::MetadataImage() : data(NULL), length(0), mapped(false), _fromJson(false)
+{
+}
+
+MetadataImage::~MetadataImage()
+{
+  if (mapped)
+    munmap(const_cast<char*>(data), length);
+}
+
+boost::shared_ptr<const MetadataImage> MetadataImage::load(const bf::path& filename)
+{
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    if (errno == ENOENT)
+      return boost::shared_ptr<const MetadataImage>();
+    throw runtime_error("MetadataImage: failed to open " + filename.string() + ": " + strerror(errno));
+  }
+
+  struct stat st;
+  if (fstat(fd, &st))
+  {
+    int l_errno = errno;
+    ::close(fd);
+    throw runtime_error("MetadataImage: failed to stat " + filename.string() + ": " + strerror(l_errno));
+  }
+
+  // anything that doesn't start with the magic number is the JSON format
+  char magic[sizeof(binaryMagic)];
+  if ((size_t)st.st_size < sizeof(Header) || ::pread(fd, magic, sizeof(magic), 0) != sizeof(magic) ||
+      memcmp(magic, binaryMagic, sizeof(magic)))
+  {
+    ::close(fd);
+    return loadJson(filename);
+  }
+
+  void* mem = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  int l_errno = errno;
+  ::close(fd);
+  if (mem == MAP_FAILED)
+    throw runtime_error("MetadataImage: failed to map " + filename.string() + ": " + strerror(l_errno));
+
+  boost::shared_ptr<MetadataImage> ret(new MetadataImage());
+  ret->data = (const char*)mem;
+  ret->length = st.st_size;
+  ret->mapped = true;
+  ret->validate(filename);
+  return ret;
+}
+
+boost::shared_ptr<const MetadataImage> MetadataImage::loadJson(const bf::path& filename)
+{
+  bpt::ptree jsontree;
+  boost::property_tree::read_json(filename.string(), jsontree);
+
+  vector<metadataObject> objects;
+  BOOST_FOREACH (const boost::property_tree::ptree::value_type& v, jsontree.get_child("objects"))
+  {
+    objects.push_back(metadataObject(v.second.get<uint64_t>("offset"), v.second.get<uint64_t>("length"),
+                                     v.second.get<string>("key")));
+  }
+  // they should already be in order, don't depend on it
+  stable_sort(objects.begin(), objects.end());
+
+  boost::shared_ptr<const MetadataImage> ret = create(jsontree.get<int>("revision"), objects);
+  const_cast<MetadataImage*>(ret.get())->_fromJson = true;
+  return ret;
+}
+
+boost::shared_ptr<const MetadataImage> MetadataImage::create(int revision, const vector<metadataObject>& objects)
+{
+  size_t keysLength = 0;
+  for (const metadataObject& o : objects)
+    keysLength += o.key.length();
+
+  boost::shared_ptr<MetadataImage> ret(new MetadataImage());
+  ret->buf.resize(sizeof(Header) + objects.size() * sizeof(Object) + keysLength);
+  ret->data = &ret->buf[0];
+  ret->length = ret->buf.size();
+
+  Header* header = reinterpret_cast<Header*>(&ret->buf[0]);
+  memcpy(header->magic, binaryMagic, sizeof(header->magic));
+  header->version = binaryVersion;
+  header->revision = revision;
+  header->objectCount = objects.size();
+  header->keysLength = keysLength;
+
+  Object* out = reinterpret_cast<Object*>(&ret->buf[sizeof(Header)]);
+  char* keys = &ret->buf[sizeof(Header) + objects.size() * sizeof(Object)];
+  uint32_t keyOffset = 0;
+  for (const metadataObject& o : objects)
+  {
+    out->offset = o.offset;
+    out->length = o.length;
+    out->keyOffset = keyOffset;
+    out->keyLength = o.key.length();
+    memcpy(&keys[keyOffset], o.key.data(), o.key.length());
+    keyOffset += o.key.length();
+    ++out;
+  }
+  return ret;
+}
+
+void MetadataImage::validate(const bf::path& filename) const
+{
+  const Header* h = header();
+  bool ok = (h->version == binaryVersion && h->objectCount <= (length - sizeof(Header)) / sizeof(Object) &&
+             sizeof(Header) + h->objectCount * sizeof(Object) + h->keysLength == length);
+
+  for (size_t i = 0; ok && i < h->objectCount; i++)
+    ok = ((uint64_t)objects()[i].keyOffset + objects()[i].keyLength <= h->keysLength);
+
+  if (!ok)
+    throw runtime_error("MetadataImage: " + filename.string() + " is corrupt");
+}
+
+void MetadataImage::write(const bf::path& filename, bool asJson) const
+{
+  string contents;
+
+  if (asJson)
+  {
+    bpt::ptree jsontree, objs;
+    jsontree.put("version", 1);
+    jsontree.put("revision", revision());
+    for (size_t i = 0; i < size(); i++)
+    {
+      bpt::ptree object;
+      object.put("offset", objects()[i].offset);
+      object.put("length", objects()[i].length);
+      object.put("key", key(i));
+      objs.push_back(make_pair("", object));
+    }
+    jsontree.add_child("objects", objs);
+    ostringstream os;
+    write_json(os, jsontree);
+    contents = os.str();
+  }
+
+  // write a new file and rename it over the old one.  Images mapping the old file keep seeing it.
+  string tmpFilename = filename.string() + ".tmp" + to_string(getpid()) + "_" + to_string(tmpFileCounter++);
+  int fd = ::open(tmpFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0)
+    throw runtime_error("MetadataImage: failed to create " + tmpFilename + ": " + strerror(errno));
+
+  const char* buf = (asJson ? contents.data() : data);
+  size_t count = (asJson ? contents.length() : length);
+  size_t written = 0;
+  while (written < count)
+  {
+    ssize_t err = ::write(fd, &buf[written], count - written);
+    if (err < 0 && errno == EINTR)
+      continue;
+    if (err < 0)
+    {
+      int l_errno = errno;
+      ::close(fd);
+      ::unlink(tmpFilename.c_str());
+      throw runtime_error("MetadataImage: failed to write " + tmpFilename + ": " + strerror(l_errno));
+    }
+    written += err;
+  }
+  ::close(fd);
+
+  if (::rename(tmpFilename.c_str(), filename.c_str()))
+  {
+    int l_errno = errno;
+    ::unlink(tmpFilename.c_str());
+    throw runtime_error("MetadataImage: failed to rename " + tmpFilename + ": " + strerror(l_errno));
+  }
+}
 
 }  // namespace storagemanager
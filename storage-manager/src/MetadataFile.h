@@ -27,6 +27,7 @@
 #include <iostream>
 #include <unordered_map>
 #include <boost/filesystem/path.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace storagemanager
 {
@@ -44,6 +45,89 @@ struct metadataObject
   }
 };
 
+/* The object list of one metadata file in the binary metadata format:  a Header, the Objects sorted
+   by offset, then the keys they refer to.  Loading a binary file maps it as is and lookups search it in
+   place, so opening a large file costs neither parsing nor allocating its keys.  The older JSON format is
+   still read; loading a JSON file converts it. Integers are stored in native byte order. */
+class MetadataImage
+{
+ public:
+  struct Header
+  {
+    char magic[4];
+    uint32_t version;
+    uint64_t revision;
+    uint64_t objectCount;
+    uint64_t keysLength;
+  };
+  struct Object
+  {
+    uint64_t offset;
+    uint64_t length;
+    uint32_t keyOffset;  // relative to the start of the keys
+    uint32_t keyLength;
+  };
+
+  ~MetadataImage();
+
+  // returns NULL if filename doesn't exist, throws runtime_error if it can't be loaded
+  static boost::shared_ptr<const MetadataImage> load(const boost::filesystem::path& filename);
+  // objects needs to be sorted by offset
+  static boost::shared_ptr<const MetadataImage> create(int revision, const std::vector<metadataObject>& objects);
+
+  // replaces filename with this image, throws runtime_error on failure
+  void write(const boost::filesystem::path& filename, bool asJson) const;
+
+  int revision() const
+  {
+    return header()->revision;
+  }
+  size_t size() const
+  {
+    return header()->objectCount;
+  }
+  const Object& operator[](size_t i) const
+  {
+    return objects()[i];
+  }
+  std::string key(size_t i) const
+  {
+    return std::string(keys() + objects()[i].keyOffset, objects()[i].keyLength);
+  }
+  // true if it was loaded from a JSON metadata file
+  bool fromJson() const
+  {
+    return _fromJson;
+  }
+
+ private:
+  MetadataImage();
+  MetadataImage(const MetadataImage&) = delete;
+  MetadataImage& operator=(const MetadataImage&) = delete;
+
+  static boost::shared_ptr<const MetadataImage> loadJson(const boost::filesystem::path& filename);
+  void validate(const boost::filesystem::path& filename) const;
+
+  const Header* header() const
+  {
+    return reinterpret_cast<const Header*>(data);
+  }
+  const Object* objects() const
+  {
+    return reinterpret_cast<const Object*>(data + sizeof(Header));
+  }
+  const char* keys() const
+  {
+    return data + sizeof(Header) + size() * sizeof(Object);
+  }
+
+  const char* data;
+  size_t length;
+  bool mapped;  // data is an mmap() of the file, otherwise it's buf
+  bool _fromJson;
+  std::vector<char> buf;
+};
+
 class MetadataFile
 {
  public:
@@ -103,6 +187,7 @@ class MetadataFile
     static MetadataConfig* get();
     size_t mObjectSize;
     boost::filesystem::path msMetadataPath;
+    bool mWriteJson;  // ObjectStorage/metadata_format = json
 
    private:
     MetadataConfig();
@@ -110,7 +195,7 @@ class MetadataFile
 
   static void printKPIs();
 
-  typedef boost::shared_ptr<boost::property_tree::ptree> Jsontree_t;
+  typedef boost::shared_ptr<const MetadataImage> Image_t;
 
  private:
   MetadataConfig* mpConfig;
@@ -118,30 +203,41 @@ class MetadataFile
   int mVersion;
   int mRevision;
   boost::filesystem::path mFilename;
-  Jsontree_t jsontree;
-  // std::set<metadataObject> mObjects;
+  Image_t image;  // the object list as it was loaded or last written, shared through metadataCache
+  // the object list is copied here to be modified.  mModified says whether image or mObjects is current.
+  std::vector<metadataObject> mObjects;
+  bool mModified;
   bool _exists;
-  void makeEmptyJsonTree();
+  void makeEmptyImage();
+  void convertFromJson();
+
+  size_t objectCount() const;
+  uint64_t objectOffset(size_t i) const;
+  uint64_t objectLength(size_t i) const;
+  metadataObject object(size_t i) const;
+  size_t lowerBound(uint64_t offset) const;  // the first object with an offset >= offset
+  size_t findObject(off_t offset) const;     // the object at offset, or objectCount()
+  std::vector<metadataObject>& modifyObjects();
 
   class MetadataCache
   {
    public:
     MetadataCache();
-    Jsontree_t get(const boost::filesystem::path&);
-    void put(const boost::filesystem::path&, const Jsontree_t&);
+    Image_t get(const boost::filesystem::path&);
+    void put(const boost::filesystem::path&, const Image_t&);
     void erase(const boost::filesystem::path&);
     boost::mutex& getMutex();
 
    private:
     // there's a more efficient way to do this, KISS for now.
     typedef std::list<std::string> Lru_t;
-    typedef std::unordered_map<std::string, std::pair<Jsontree_t, Lru_t::iterator> > Lookup_t;
+    typedef std::unordered_map<std::string, std::pair<Image_t, Lru_t::iterator> > Lookup_t;
     Lookup_t lookup;
     Lru_t lru;
     uint max_lru_size;
     boost::mutex mutex;
   };
-  static MetadataCache jsonCache;
+  static MetadataCache metadataCache;
 };
 
 }  // namespace storagemanager
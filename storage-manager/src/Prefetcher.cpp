@@ -0,0 +1,197 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include "Prefetcher.h"
+#include "MetadataFile.h"
+#include <iostream>
+
+using namespace std;
+namespace bf = boost::filesystem;
+
+namespace
+{
+// forget the access pattern of all files when there are more than this many
+const size_t maxTrackedFiles = 4096;
+
+// # of sequential reads in a row before prefetching starts
+const uint sequentialThreshold = 2;
+}  // namespace
+
+namespace storagemanager
+{
+Prefetcher::Prefetcher()
+ : bytesInProgress(0), depth(0), budget(0), workers(8), prefetchesStarted(0), objectsPrefetched(0), objectsSkipped(0)
+{
+  cache = Cache::get();
+  logger = SMLogging::get();
+  workers.setName("Prefetcher");
+  configListener();
+  Config::get()->addConfigListener(this);
+}
+
+Prefetcher::~Prefetcher()
+{
+  Config::get()->removeConfigListener(this);
+}
+
+void Prefetcher::readHappened(const string& filename, off_t offset, size_t count, size_t objectSize,
+                              off_t* nextOffset, size_t* length)
+{
+  *length = 0;
+  if (depth == 0 || count == 0)
+    return;
+
+  boost::unique_lock<boost::mutex> s(mutex);
+  if (files.size() >= maxTrackedFiles && files.find(filename) == files.end())
+    files.clear();
+  auto it = files.find(filename);
+  if (it == files.end())
+  {
+    FileState& st = files[filename];
+    st.nextOffset = offset + count;
+    st.prefetchedTo = 0;
+    st.sequentialReads = 0;
+    return;
+  }
+
+  FileState& st = it->second;
+  if (offset == st.nextOffset)
+    ++st.sequentialReads;
+  else
+  {
+    st.sequentialReads = 0;
+    st.prefetchedTo = 0;
+  }
+  st.nextOffset = offset + count;
+  if (st.sequentialReads < sequentialThreshold)
+    return;
+
+  // Wait until at least an object's worth of the window isn't prefetched yet, so this isn't done on every read
+  off_t windowEnd = st.nextOffset + (off_t)(depth * objectSize);
+  off_t start = max(st.nextOffset, st.prefetchedTo);
+  if (windowEnd - start < (off_t)objectSize)
+    return;
+  st.prefetchedTo = windowEnd;
+  *nextOffset = start;
+  *length = windowEnd - start;
+}
+
+void Prefetcher::prefetch(const bf::path& prefix, const vector<string>& keys)
+{
+  if (keys.empty())
+    return;
+
+  vector<bool> exists;
+  cache->exists(prefix, keys, &exists);
+
+  vector<string> toGet;
+  size_t bytes = 0;
+  boost::unique_lock<boost::mutex> s(mutex);
+  for (uint i = 0; i < keys.size(); i++)
+  {
+    if (exists[i] || inProgress.find(keys[i]) != inProgress.end())
+      continue;
+    size_t len = MetadataFile::getLengthFromKey(keys[i]);
+    if (bytesInProgress + bytes + len > budget)
+    {
+      objectsSkipped += keys.size() - i;
+      break;
+    }
+    toGet.push_back(keys[i]);
+    inProgress.insert(keys[i]);
+    bytes += len;
+  }
+  if (toGet.empty())
+    return;
+  bytesInProgress += bytes;
+  ++prefetchesStarted;
+  objectsPrefetched += toGet.size();
+  s.unlock();
+
+  workers.addJob(boost::shared_ptr<Job>(new Job(this, prefix, toGet, bytes)));
+}
+
+void Prefetcher::jobFinished(const Job& job)
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+  for (const string& key : job.keys)
+    inProgress.erase(key);
+  bytesInProgress -= job.bytes;
+}
+
+Prefetcher::Job::Job(Prefetcher* p, const bf::path& _prefix, vector<string>& _keys, size_t _bytes)
+ : prefetcher(p), prefix(_prefix), bytes(_bytes)
+{
+  keys.swap(_keys);
+}
+
+void Prefetcher::Job::operator()()
+{
+  // Cache::read() downloads what's missing.  Nothing needs the objects pinned after that.
+  try
+  {
+    prefetcher->cache->read(prefix, keys);
+    prefetcher->cache->doneReading(prefix, keys);
+  }
+  catch (exception& e)
+  {
+    prefetcher->logger->log(LOG_WARNING, "Prefetcher: caught '%s'", e.what());
+  }
+  prefetcher->jobFinished(*this);
+}
+
+void Prefetcher::printKPIs() const
+{
+  cout << "Prefetcher" << endl;
+  cout << "\tprefetchesStarted = " << prefetchesStarted << endl;
+  cout << "\tobjectsPrefetched = " << objectsPrefetched << endl;
+  cout << "\tobjectsSkipped = " << objectsSkipped << endl;
+}
+
+void Prefetcher::configListener()
+{
+  Config* config = Config::get();
+  uint newDepth = 0;
+  size_t newBudget = 0;
+
+  string stmp = config->getValue("Cache", "prefetch_depth");
+  try
+  {
+    if (!stmp.empty())
+      newDepth = stoul(stmp);
+    stmp = config->getValue("Cache", "prefetch_budget");
+    if (!stmp.empty())
+      newBudget = stoul(stmp);
+  }
+  catch (invalid_argument&)
+  {
+    logger->log(LOG_CRIT, "Cache/prefetch_depth and Cache/prefetch_budget must be numbers.  Using %u and %zu",
+                depth, budget);
+    return;
+  }
+
+  // prefetching shouldn't push out much of what's cached
+  newBudget = min(newBudget, cache->getMaxCacheSize() / 4);
+  if (newDepth != depth || newBudget != budget)
+  {
+    depth = newDepth;
+    budget = newBudget;
+    logger->log(LOG_INFO, "prefetch_depth = %u, prefetch_budget = %zu", depth, budget);
+  }
+}
+
+}  // namespace storagemanager
@@ -0,0 +1,93 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "Cache.h"
+#include "Config.h"
+#include "SMLogging.h"
+#include "ThreadPool.h"
+
+/* Prefetcher watches the reads IOCoordinator does on each file.  When a file is read sequentially, it
+   loads the next prefetch_depth objects of the file into the cache in the background, so a scan does
+   not wait for each object to download.  The objects being prefetched at any time are limited to
+   prefetch_budget bytes. */
+
+namespace storagemanager
+{
+class Prefetcher : public boost::noncopyable, public ConfigListener
+{
+ public:
+  Prefetcher();
+  virtual ~Prefetcher();
+
+  // Called by IOCoordinator::read() after each read.  Returns the range of the file to prefetch
+  // through nextOffset & length; length == 0 means there's nothing to do.
+  void readHappened(const std::string& filename, off_t offset, size_t count, size_t objectSize, off_t* nextOffset,
+                    size_t* length);
+
+  // Loads the given objects into the cache in the background.  Objects that are cached already or
+  // don't fit in the budget are skipped.
+  void prefetch(const boost::filesystem::path& prefix, const std::vector<std::string>& keys);
+
+  void printKPIs() const;
+
+  virtual void configListener() override;
+
+ private:
+  struct FileState
+  {
+    off_t nextOffset;    // where a sequential read would start
+    off_t prefetchedTo;  // where the prefetched range ends
+    uint sequentialReads;
+  };
+  std::unordered_map<std::string, FileState> files;
+  boost::mutex mutex;
+
+  struct Job : public ThreadPool::Job
+  {
+    Job(Prefetcher*, const boost::filesystem::path& prefix, std::vector<std::string>& keys, size_t bytes);
+    void operator()();
+    Prefetcher* prefetcher;
+    boost::filesystem::path prefix;
+    std::vector<std::string> keys;
+    size_t bytes;
+  };
+  void jobFinished(const Job&);
+
+  std::unordered_set<std::string> inProgress;
+  size_t bytesInProgress;
+
+  uint depth;
+  size_t budget;
+  Cache* cache;
+  ThreadPool workers;
+  SMLogging* logger;
+
+  // KPIs
+  size_t prefetchesStarted, objectsPrefetched, objectsSkipped;
+};
+
+}  // namespace storagemanager
@@ -20,6 +20,7 @@
 #include "Config.h"
 #include "Downloader.h"
 #include "Synchronizer.h"
+#include "MetadataFile.h"
 #include <iostream>
 #include <syslog.h>
 #include <boost/filesystem.hpp>
@@ -33,7 +34,7 @@ namespace bf = boost::filesystem;
 
 namespace storagemanager
 {
-PrefixCache::PrefixCache(const bf::path& prefix) : firstDir(prefix), currentCacheSize(0)
+PrefixCache::PrefixCache(const bf::path& prefix) : firstDir(prefix), currentCacheSize(0), clockHand(0)
 {
   Config* conf = Config::get();
   logger = SMLogging::get();
@@ -133,13 +134,19 @@ void PrefixCache::populate()
   vector<string> newObjects;
   while (dir != dend)
   {
-    // put everything in lru & m_lru
+    // put everything in the index
     const bf::path& p = dir->path();
     if (bf::is_regular_file(p))
     {
-      lru.push_back(p.filename().string());
-      auto last = lru.end();
-      m_lru.insert(--last);
+      IndexShard& shard = shardFor(p.filename().string());
+      boost::unique_lock<boost::mutex> ss(shard.lock);
+      Entry* e = findOrCreate(shard, p.filename().string());
+      if (!e->cached)
+      {
+        e->cached = true;
+        addToClock(e);
+      }
+      ss.unlock();
       currentCacheSize += bf::file_size(*dir);
       newObjects.push_back(p.filename().string());
     }
@@ -183,22 +190,32 @@ void PrefixCache::validateCacheSize()
 {
   boost::unique_lock<boost::mutex> s(lru_mutex);
 
-  if (!doNotEvict.empty() || !toBeDeleted.empty())
+  for (IndexShard& shard : indexShards)
   {
-    cout << "Not safe to use validateCacheSize() at the moment." << endl;
-    return;
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    for (auto& it : shard.entries)
+      if (it.second->refCount != 0 || it.second->toBeDeleted)
+      {
+        cout << "Not safe to use validateCacheSize() at the moment." << endl;
+        return;
+      }
   }
 
   size_t oldSize = currentCacheSize;
   currentCacheSize = 0;
-  m_lru.clear();
-  lru.clear();
+  for (IndexShard& shard : indexShards)
+  {
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    shard.entries.clear();
+  }
+  clock.clear();
+  clockHand = 0;
   populate();
 
   if (oldSize != currentCacheSize)
     logger->log(LOG_DEBUG,
                 "PrefixCache::validateCacheSize(): found a discrepancy.  Actual size is %lld, had %lld.",
-                currentCacheSize, oldSize);
+                currentCacheSize.load(), oldSize);
   else
     logger->log(LOG_DEBUG,
                 "PrefixCache::validateCacheSize(): Cache size accounting agrees with reality for now.");
@@ -206,37 +223,57 @@ void PrefixCache::validateCacheSize()
 
 void PrefixCache::read(const vector<string>& keys)
 {
-  /*  Move existing keys to the back of the LRU, start downloading nonexistant keys.
+  /*  Pin & reference existing keys, start downloading nonexistant keys.
    */
+  vector<const string*> missing;
   vector<const string*> keysToFetch;
   vector<int> dlErrnos;
   vector<size_t> dlSizes;
 
-  boost::unique_lock<boost::mutex> s(lru_mutex);
-
-  M_LRU_t::iterator mit;
+  // The common case is that everything is cached already, that only needs the index shards.
   for (const string& key : keys)
   {
-    mit = m_lru.find(key);
-    if (mit != m_lru.end())
+    IndexShard& shard = shardFor(key);
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end() && it->second->cached)
     {
-      addToDNE(mit->lit);
-      lru.splice(lru.end(), lru, mit->lit);  // move them to the back so they are last to pick for eviction
+      ++(it->second->refCount);
+      it->second->referenced = true;  // make it the last to pick for eviction
     }
     else
+      missing.push_back(&key);
+  }
+  if (missing.empty())
+    return;
+
+  boost::unique_lock<boost::mutex> s(lru_mutex);
+
+  for (const string* key : missing)
+  {
+    IndexShard& shard = shardFor(*key);
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    auto it = shard.entries.find(*key);
+    bool pinnedByOthers = (it != shard.entries.end());
+    Entry* e = findOrCreate(shard, *key);
+    ++(e->refCount);
+    if (e->cached)  // it got added after the check above
     {
-      // There's window where the file has been downloaded but is not yet
-      // added to the lru structs.  However it is in the DNE.  If it is in the DNE, then it is also
-      // in Downloader's map.  So, this thread needs to start the download if it's not in the
-      // DNE or if there's an existing download that hasn't finished yet.  Starting the download
-      // includes waiting for an existing download to finish, which from this class's pov is the
-      // same thing.
-      if (doNotEvict.find(key) == doNotEvict.end() || downloader->inProgress(key))
-        keysToFetch.push_back(&key);
-      else
-        cout << "Cache: detected and stopped a racey download" << endl;
-      addToDNE(key);
+      e->referenced = true;
+      continue;
     }
+    ss.unlock();
+
+    // There's window where the file has been downloaded but is not yet
+    // added to the cache.  However it is pinned.  If it is pinned, then it is also
+    // in Downloader's map.  So, this thread needs to start the download if it's not pinned
+    // or if there's an existing download that hasn't finished yet.  Starting the download
+    // includes waiting for an existing download to finish, which from this class's pov is the
+    // same thing.
+    if (!pinnedByOthers || downloader->inProgress(*key))
+      keysToFetch.push_back(key);
+    else
+      cout << "Cache: detected and stopped a racey download" << endl;
   }
   if (keysToFetch.empty())
     return;
@@ -250,32 +287,32 @@ void PrefixCache::read(const vector<string>& keys)
     // was a preexisting download (another read() call owns it), or because
     // there was an error downloading it.  Use size == 0 as an indication of
     // what to add to the cache.  Also needs to verify that the file was not deleted,
-    // indicated by existence in doNotEvict.
+    // indicated by the entry still existing.
     if (dlSizes[i] != 0)
     {
-      if (doNotEvict.find(*keysToFetch[i]) != doNotEvict.end())
+      IndexShard& shard = shardFor(*keysToFetch[i]);
+      boost::unique_lock<boost::mutex> ss(shard.lock);
+      auto it = shard.entries.find(*keysToFetch[i]);
+      if (it != shard.entries.end())
       {
-        sum_sizes += dlSizes[i];
-        lru.push_back(*keysToFetch[i]);
-        LRU_t::iterator lit = lru.end();
-        m_lru.insert(--lit);  // I dislike this way of grabbing the last iterator in a list.
+        Entry* e = it->second.get();
+        if (!e->cached)
+        {
+          sum_sizes += dlSizes[i];
+          e->cached = true;
+          e->referenced = true;
+          addToClock(e);
+        }
       }
       else  // it was downloaded, but a deletion happened so we have to toss it
       {
+        ss.unlock();
         cout << "removing a file that was deleted by another thread during download" << endl;
         bf::remove(cachePrefix / (*keysToFetch[i]));
       }
     }
   }
 
-  // move everything in keys to the back of the lru (yes, again)
-  for (const string& key : keys)
-  {
-    mit = m_lru.find(key);
-    if (mit != m_lru.end())  // all of the files exist, just not all of them are 'owned by' this thread.
-      lru.splice(lru.end(), lru, mit->lit);
-  }
-
   // fix cache size
   //_makeSpace(sum_sizes);
   currentCacheSize += sum_sizes;
@@ -283,19 +320,25 @@ void PrefixCache::read(const vector<string>& keys)
 
 void PrefixCache::doneReading(const vector<string>& keys)
 {
-  boost::unique_lock<boost::mutex> s(lru_mutex);
   for (const string& key : keys)
   {
-    removeFromDNE(key);
-    // most should be in the map.
-    // debateable whether it's faster to look up the list iterator and use it
-    // or whether it's faster to bypass that and use strings only.
-
-    // const auto &it = m_lru.find(key);
-    // if (it != m_lru.end())
-    //    removeFromDNE(it->lit);
+    IndexShard& shard = shardFor(key);
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end())
+      continue;
+    Entry* e = it->second.get();
+    if (e->refCount > 0)
+      --(e->refCount);
+    // an entry that only existed to pin a download that failed or never happened
+    if (e->refCount == 0 && !e->cached)
+      shard.entries.erase(it);
+  }
+  if (currentCacheSize > maxCacheSize)
+  {
+    boost::unique_lock<boost::mutex> s(lru_mutex);
+    _makeSpace(0);
   }
-  _makeSpace(0);
 }
 
 void PrefixCache::doneWriting()
@@ -303,33 +346,65 @@ void PrefixCache::doneWriting()
   makeSpace(0);
 }
 
-PrefixCache::DNEElement::DNEElement(const LRU_t::iterator& k) : key(k), refCount(1)
+inline PrefixCache::IndexShard& PrefixCache::shardFor(const string_view& key)
 {
+  return indexShards[(hash<string_view>()(key) * 0x9e3779b97f4a7c15ULL) >> 58];
 }
-PrefixCache::DNEElement::DNEElement(const string& k) : sKey(k), refCount(1)
+
+inline const PrefixCache::IndexShard& PrefixCache::shardFor(const string_view& key) const
 {
+  return indexShards[(hash<string_view>()(key) * 0x9e3779b97f4a7c15ULL) >> 58];
 }
 
-void PrefixCache::addToDNE(const DNEElement& key)
+PrefixCache::Entry* PrefixCache::findOrCreate(IndexShard& shard, const string& key)
 {
-  DNE_t::iterator it = doNotEvict.find(key);
-  if (it != doNotEvict.end())
-  {
-    DNEElement& dnee = const_cast<DNEElement&>(*it);
-    ++(dnee.refCount);
-  }
-  else
-    doNotEvict.insert(key);
+  auto it = shard.entries.find(key);
+  if (it != shard.entries.end())
+    return it->second.get();
+
+  Entry* e = new Entry(key);
+  shard.entries.emplace(string_view(e->key), unique_ptr<Entry>(e));
+  return e;
 }
 
-void PrefixCache::removeFromDNE(const DNEElement& key)
+// call these holding lru_mutex
+void PrefixCache::addToClock(Entry* e)
 {
-  DNE_t::iterator it = doNotEvict.find(key);
-  if (it == doNotEvict.end())
-    return;
-  DNEElement& dnee = const_cast<DNEElement&>(*it);
-  if (--(dnee.refCount) == 0)
-    doNotEvict.erase(it);
+  e->clockPos = clock.size();
+  clock.push_back(e);
+}
+
+void PrefixCache::removeFromClock(Entry* e)
+{
+  Entry* last = clock.back();
+  clock[e->clockPos] = last;
+  last->clockPos = e->clockPos;
+  clock.pop_back();
+}
+
+PrefixCache::Entry* PrefixCache::pickVictim()
+{
+  // Two turns of the hand clear every reference bit, so if nothing was found by then
+  // everything is pinned or being flushed already.
+  for (size_t i = 0; i < clock.size() * 2; ++i)
+  {
+    if (clockHand >= clock.size())
+      clockHand = 0;
+    Entry* e = clock[clockHand++];
+
+    IndexShard& shard = shardFor(e->key);
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    if (e->refCount != 0 || e->toBeDeleted)
+      continue;
+    if (e->referenced)
+    {
+      e->referenced = false;
+      continue;
+    }
+    e->toBeDeleted = true;
+    return e;
+  }
+  return NULL;
 }
 
 const bf::path& PrefixCache::getCachePath()
@@ -345,37 +420,48 @@ const bf::path& PrefixCache::getJournalPath()
 void PrefixCache::exists(const vector<string>& keys, vector<bool>* out) const
 {
   out->resize(keys.size());
-  boost::unique_lock<boost::mutex> s(lru_mutex);
   for (uint i = 0; i < keys.size(); i++)
-    (*out)[i] = (m_lru.find(keys[i]) != m_lru.end());
+  {
+    const IndexShard& shard = shardFor(keys[i]);
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    auto it = shard.entries.find(keys[i]);
+    (*out)[i] = (it != shard.entries.end() && it->second->cached);
+  }
 }
 
 bool PrefixCache::exists(const string& key) const
 {
-  boost::unique_lock<boost::mutex> s(lru_mutex);
-  return m_lru.find(key) != m_lru.end();
+  const IndexShard& shard = shardFor(key);
+  boost::unique_lock<boost::mutex> ss(shard.lock);
+  auto it = shard.entries.find(key);
+  return it != shard.entries.end() && it->second->cached;
 }
 
 void PrefixCache::newObject(const string& key, size_t size)
 {
   boost::unique_lock<boost::mutex> s(lru_mutex);
-  assert(m_lru.find(key) == m_lru.end());
-  if (m_lru.find(key) != m_lru.end())
+  IndexShard& shard = shardFor(key);
+  boost::unique_lock<boost::mutex> ss(shard.lock);
+  Entry* e = findOrCreate(shard, key);
+  assert(!e->cached);
+  if (e->cached)
   {
     // This should never happen but was in MCOL-3499
     // Remove this when PrefixCache ctor can call populate() synchronous with write calls
-    logger->log(LOG_ERR, "PrefixCache::newObject(): key exists in m_lru already %s", key.c_str());
+    logger->log(LOG_ERR, "PrefixCache::newObject(): key exists in the cache already %s", key.c_str());
+  }
+  else
+  {
+    e->cached = true;
+    addToClock(e);
   }
   //_makeSpace(size);
-  lru.push_back(key);
-  LRU_t::iterator back = lru.end();
-  m_lru.insert(--back);
+  e->referenced = true;
   currentCacheSize += size;
 }
 
 void PrefixCache::newJournalEntry(size_t size)
 {
-  boost::unique_lock<boost::mutex> s(lru_mutex);
   //_makeSpace(size);
   currentCacheSize += size;
 }
@@ -398,16 +484,19 @@ void PrefixCache::deletedJournal(size_t size)
 void PrefixCache::deletedObject(const string& key, size_t size)
 {
   boost::unique_lock<boost::mutex> s(lru_mutex);
+  IndexShard& shard = shardFor(key);
+  boost::unique_lock<boost::mutex> ss(shard.lock);
 
-  M_LRU_t::iterator mit = m_lru.find(key);
-  assert(mit != m_lru.end());
+  auto it = shard.entries.find(key);
+  assert(it != shard.entries.end() && it->second->cached);
+  if (it == shard.entries.end() || !it->second->cached)
+    return;
 
   // if it's being flushed, let makeSpace() do the deleting
-  if (toBeDeleted.find(mit->lit) == toBeDeleted.end())
+  if (!it->second->toBeDeleted)
   {
-    doNotEvict.erase(mit->lit);
-    lru.erase(mit->lit);
-    m_lru.erase(mit);
+    removeFromClock(it->second.get());
+    shard.entries.erase(it);
     if (currentCacheSize >= size)
       currentCacheSize -= size;
     else
@@ -439,6 +528,13 @@ size_t PrefixCache::getMaxCacheSize() const
   return maxCacheSize;
 }
 
+// call this holding the shard lock
+bool PrefixCache::isReplaced(const IndexShard& shard, const Entry* e) const
+{
+  auto it = shard.entries.find(e->key);
+  return (it == shard.entries.end() || it->second.get() != e);
+}
+
 // call this holding lru_mutex
 void PrefixCache::_makeSpace(size_t size)
 {
@@ -446,20 +542,13 @@ void PrefixCache::_makeSpace(size_t size)
   if (thisMuch <= 0)
     return;
 
-  LRU_t::iterator it;
-  while (thisMuch > 0 && !lru.empty())
+  while (thisMuch > 0 && !clock.empty())
   {
-    it = lru.begin();
-    // find the first element not being either read() right now or being processed by another
-    // makeSpace() call.
-    while (it != lru.end())
-    {
-      // make sure it's not currently being read or being flushed by another _makeSpace() call
-      if ((doNotEvict.find(it) == doNotEvict.end()) && (toBeDeleted.find(it) == toBeDeleted.end()))
-        break;
-      ++it;
-    }
-    if (it == lru.end())
+    // find the next element not being either read() right now or being processed by another
+    // makeSpace() call.  pickVictim() marks it toBeDeleted, which keeps the entry alive
+    // while lru_mutex is released below.
+    Entry* e = pickVictim();
+    if (e == NULL)
     {
       // nothing can be deleted right now
       return;
@@ -468,10 +557,10 @@ void PrefixCache::_makeSpace(size_t size)
     // ran into this a couple times, still happens as of commit 948ee1aa5
     // BT: made this more visable in logging.
     //     likely related to MCOL-3499 and lru containing double entries.
-    if (!bf::exists(cachePrefix / *it))
+    if (!bf::exists(cachePrefix / e->key))
       logger->log(LOG_WARNING, "PrefixCache::makeSpace(): doesn't exist, %s/%s", cachePrefix.string().c_str(),
-                  ((string)(*it)).c_str());
-    assert(bf::exists(cachePrefix / *it));
+                  e->key.c_str());
+    assert(bf::exists(cachePrefix / e->key));
     /*
         tell Synchronizer that this key will be evicted
         delete the file
@@ -480,9 +569,7 @@ void PrefixCache::_makeSpace(size_t size)
     */
 
     // logger->log(LOG_WARNING, "Cache:  flushing!");
-    toBeDeleted.insert(it);
-
-    string key = *it;  // need to make a copy; it could get changed after unlocking.
+    string key = e->key;  // need to make a copy; it could get changed after unlocking.
 
     lru_mutex.unlock();
     try
@@ -493,18 +580,31 @@ void PrefixCache::_makeSpace(size_t size)
     {
       // it gets logged by Sync
       lru_mutex.lock();
-      toBeDeleted.erase(it);
+      IndexShard& shard = shardFor(e->key);
+      boost::unique_lock<boost::mutex> ss(shard.lock);
+      if (isReplaced(shard, e))
+        delete e;
+      else
+        e->toBeDeleted = false;
       continue;
     }
     lru_mutex.lock();
 
-    // check doNotEvict again in case this object is now being read
-    if (doNotEvict.find(it) == doNotEvict.end())
+    // check the refCount again in case this object is now being read
+    IndexShard& shard = shardFor(e->key);
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    if (isReplaced(shard, e))
+    {
+      // rename() replaced it while it was being flushed; the file belongs to the new entry now
+      delete e;
+      continue;
+    }
+    if (e->refCount == 0)
     {
-      bf::path cachedFile = cachePrefix / *it;
-      m_lru.erase(*it);
-      toBeDeleted.erase(it);
-      lru.erase(it);
+      bf::path cachedFile = cachePrefix / e->key;
+      removeFromClock(e);
+      shard.entries.erase(shard.entries.find(e->key));  // deletes e
+      ss.unlock();
       size_t newSize = bf::file_size(cachedFile);
       replicator->remove(cachedFile, Replicator::LOCAL_ONLY);
       if (newSize < currentCacheSize)
@@ -521,46 +621,46 @@ void PrefixCache::_makeSpace(size_t size)
       }
     }
     else
-      toBeDeleted.erase(it);
+      e->toBeDeleted = false;
   }
 }
 
 void PrefixCache::rename(const string& oldKey, const string& newKey, ssize_t sizediff)
 {
-  // rename it in the LRU
-  // erase/insert to rehash it everywhere else
+  // rename it in the index; the entry moves to the shard of the new key
 
   boost::unique_lock<boost::mutex> s(lru_mutex);
-  auto it = m_lru.find(oldKey);
-  if (it == m_lru.end())
-    return;
-
-  auto lit = it->lit;
-  m_lru.erase(it);
-  int refCount = 0;
-  auto dne_it = doNotEvict.find(lit);
-  if (dne_it != doNotEvict.end())
+  unique_ptr<Entry> e;
   {
-    refCount = dne_it->refCount;
-    doNotEvict.erase(dne_it);
+    IndexShard& shard = shardFor(oldKey);
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    auto it = shard.entries.find(oldKey);
+    if (it == shard.entries.end() || !it->second->cached)
+      return;
+    e = std::move(it->second);
+    shard.entries.erase(it);
   }
 
-  auto tbd_it = toBeDeleted.find(lit);
-  bool hasTBDEntry = (tbd_it != toBeDeleted.end());
-  if (hasTBDEntry)
-    toBeDeleted.erase(tbd_it);
+  e->key = newKey;
 
-  *lit = newKey;
-
-  if (hasTBDEntry)
-    toBeDeleted.insert(lit);
-  if (refCount != 0)
+  IndexShard& shard = shardFor(newKey);
+  boost::unique_lock<boost::mutex> ss(shard.lock);
+  auto it = shard.entries.find(newKey);
+  if (it != shard.entries.end())
   {
-    pair<DNE_t::iterator, bool> dne_tmp = doNotEvict.insert(lit);
-    const_cast<DNEElement&>(*(dne_tmp.first)).refCount = refCount;
+    // readers may have pinned the new key already; they keep their pins on the renamed object
+    e->refCount += it->second->refCount;
+    if (it->second->cached)
+    {
+      removeFromClock(it->second.get());
+      currentCacheSize -= MetadataFile::getLengthFromKey(newKey);
+    }
+    // _makeSpace() holds on to an entry it is flushing; let it free that one once it sees it was replaced
+    if (it->second->toBeDeleted)
+      it->second.release();
+    shard.entries.erase(it);
   }
-
-  m_lru.insert(lit);
+  shard.entries.emplace(string_view(e->key), std::move(e));
   currentCacheSize += sizediff;
 }
 
@@ -572,18 +672,21 @@ int PrefixCache::ifExistsThenDelete(const string& key)
   boost::unique_lock<boost::mutex> s(lru_mutex);
   bool objectExists = false;
 
-  auto it = m_lru.find(key);
-  if (it != m_lru.end())
   {
-    if (toBeDeleted.find(it->lit) == toBeDeleted.end())
+    IndexShard& shard = shardFor(key);
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end() && it->second->cached)
     {
-      doNotEvict.erase(it->lit);
-      lru.erase(it->lit);
-      m_lru.erase(it);
-      objectExists = true;
+      if (!it->second->toBeDeleted)
+      {
+        removeFromClock(it->second.get());
+        shard.entries.erase(it);
+        objectExists = true;
+      }
+      else  // let makeSpace() delete it if it's already in progress
+        return 0;
     }
-    else  // let makeSpace() delete it if it's already in progress
-      return 0;
   }
   bool journalExists = bf::exists(journalPath);
   // assert(objectExists == bf::exists(cachedPath));
@@ -606,17 +709,19 @@ size_t PrefixCache::getCurrentCacheSize() const
 size_t PrefixCache::getCurrentCacheElementCount() const
 {
   boost::unique_lock<boost::mutex> s(lru_mutex);
-  assert(m_lru.size() == lru.size());
-  return m_lru.size();
+  return clock.size();
 }
 
 void PrefixCache::reset()
 {
   boost::unique_lock<boost::mutex> s(lru_mutex);
-  m_lru.clear();
-  lru.clear();
-  toBeDeleted.clear();
-  doNotEvict.clear();
+  for (IndexShard& shard : indexShards)
+  {
+    boost::unique_lock<boost::mutex> ss(shard.lock);
+    shard.entries.clear();
+  }
+  clock.clear();
+  clockHand = 0;
 
   bf::directory_iterator dir;
   bf::directory_iterator dend;
@@ -633,47 +738,4 @@ void PrefixCache::shutdown()
   /* Does this need to do something anymore? */
 }
 
-/* The helper classes */
-
-PrefixCache::M_LRU_element_t::M_LRU_element_t(const string* k) : key(k)
-{
-}
-
-PrefixCache::M_LRU_element_t::M_LRU_element_t(const string& k) : key(&k)
-{
-}
-
-PrefixCache::M_LRU_element_t::M_LRU_element_t(const LRU_t::iterator& i) : key(&(*i)), lit(i)
-{
-}
-
-inline size_t PrefixCache::KeyHasher::operator()(const M_LRU_element_t& l) const
-{
-  return hash<string>()(*(l.key));
-}
-
-inline bool PrefixCache::KeyEquals::operator()(const M_LRU_element_t& l1, const M_LRU_element_t& l2) const
-{
-  return (*(l1.key) == *(l2.key));
-}
-
-inline size_t PrefixCache::DNEHasher::operator()(const DNEElement& l) const
-{
-  return (l.sKey.empty() ? hash<string>()(*(l.key)) : hash<string>()(l.sKey));
-}
-
-inline bool PrefixCache::DNEEquals::operator()(const DNEElement& l1, const DNEElement& l2) const
-{
-  const string *s1, *s2;
-  s1 = l1.sKey.empty() ? &(*(l1.key)) : &(l1.sKey);
-  s2 = l2.sKey.empty() ? &(*(l2.key)) : &(l2.sKey);
-
-  return (*s1 == *s2);
-}
-
-inline bool PrefixCache::TBDLess::operator()(const LRU_t::iterator& i1, const LRU_t::iterator& i2) const
-{
-  return *i1 < *i2;
-}
-
 }  // namespace storagemanager
@@ -26,10 +26,12 @@
 #include "SMLogging.h"
 #include "Replicator.h"
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <list>
-#include <unordered_set>
+#include <unordered_map>
 #include <boost/utility.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/thread/mutex.hpp>
@@ -89,7 +91,7 @@ class PrefixCache : public boost::noncopyable
   boost::filesystem::path firstDir;
   size_t maxCacheSize;
   size_t objectSize;
-  size_t currentCacheSize;
+  std::atomic<size_t> currentCacheSize;
   Replicator* replicator;
   SMLogging* logger;
   Downloader* downloader;
@@ -98,68 +100,47 @@ class PrefixCache : public boost::noncopyable
   void _makeSpace(size_t size);
 
   /* The main PrefixCache structures */
-  // lru owns the string memory for the filenames it manages.  m_lru and DNE point to those strings.
-  typedef std::list<std::string> LRU_t;
-  LRU_t lru;
-
-  struct M_LRU_element_t
-  {
-    M_LRU_element_t(const std::string&);
-    M_LRU_element_t(const std::string*);
-    M_LRU_element_t(const LRU_t::iterator&);
-    const std::string* key;
-    LRU_t::iterator lit;
-  };
-  struct KeyHasher
-  {
-    size_t operator()(const M_LRU_element_t& l) const;
-  };
-
-  struct KeyEquals
-  {
-    bool operator()(const M_LRU_element_t& l1, const M_LRU_element_t& l2) const;
-  };
-
-  typedef std::unordered_set<M_LRU_element_t, KeyHasher, KeyEquals> M_LRU_t;
-  M_LRU_t m_lru;  // the LRU entries as a hash table
-
-  /* The do-not-evict list stuff. */
-  struct DNEElement
+  // Every cached object, and every key read() pinned while it downloads, has one Entry.  The entry
+  // owns the only copy of the key; the index maps views of it to the entry.
+  struct Entry
   {
-    DNEElement(const LRU_t::iterator&);
-    DNEElement(const std::string&);
-    LRU_t::iterator key;
-    std::string sKey;
-    uint refCount;
+    explicit Entry(const std::string& k) : key(k)
+    {
+    }
+    std::string key;
+    uint refCount = 0;         // read()s in progress, the object can't be evicted while it's > 0
+    size_t clockPos = 0;       // position in clock, valid while cached
+    bool cached = false;       // the object is in the cache dir & counted in currentCacheSize
+    bool referenced = false;   // CLOCK bit, set by read()
+    bool toBeDeleted = false;  // _makeSpace() is flushing it
   };
 
-  struct DNEHasher
+  // The index is split into shards by key hash, each with its own lock, so read(), doneReading()
+  // and exists() on cached objects don't need lru_mutex.
+  struct IndexShard
   {
-    size_t operator()(const DNEElement& d) const;
+    mutable boost::mutex lock;
+    std::unordered_map<std::string_view, std::unique_ptr<Entry>> entries;
   };
-
-  struct DNEEquals
-  {
-    bool operator()(const DNEElement& d1, const DNEElement& d2) const;
-  };
-
-  typedef std::unordered_set<DNEElement, DNEHasher, DNEEquals> DNE_t;
-  DNE_t doNotEvict;
-  void addToDNE(const DNEElement&);
-  void removeFromDNE(const DNEElement&);
-
-  // the to-be-deleted set.  Elements removed from the LRU but not yet deleted will be here.
-  // Elements are inserted and removed by makeSpace().  If read() references a file that is in this,
-  // it will remove it, signalling to makeSpace that it should not be deleted
-  struct TBDLess
-  {
-    bool operator()(const LRU_t::iterator&, const LRU_t::iterator&) const;
-  };
-
-  typedef std::set<LRU_t::iterator, TBDLess> TBD_t;
-  TBD_t toBeDeleted;
-
-  mutable boost::mutex lru_mutex;  // protects the main PrefixCache structures & the do-not-evict set
+  static const uint IndexShardCount = 64;
+  IndexShard indexShards[IndexShardCount];
+
+  IndexShard& shardFor(const std::string_view& key);
+  const IndexShard& shardFor(const std::string_view& key) const;
+  // returns the entry for key, creating an uncached one if there isn't any.  Call holding the shard lock.
+  Entry* findOrCreate(IndexShard& shard, const std::string& key);
+  // true if e is no longer the indexed entry for its key, ie rename() replaced it.  Call holding the shard lock.
+  bool isReplaced(const IndexShard& shard, const Entry* e) const;
+
+  // The CLOCK ring of the cached entries, an approximate LRU.  Changes only with lru_mutex held.
+  std::vector<Entry*> clock;
+  size_t clockHand;
+  void addToClock(Entry*);
+  void removeFromClock(Entry*);
+  // Picks the next object to evict and marks it toBeDeleted.  Returns NULL if everything is pinned.
+  Entry* pickVictim();
+
+  mutable boost::mutex lru_mutex;  // protects clock & the creation of cached entries
 };
 
 }  // namespace storagemanager
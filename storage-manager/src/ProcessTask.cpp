@@ -28,10 +28,12 @@
 #include "OpenTask.h"
 #include "PingTask.h"
 #include "ReadTask.h"
+#include "ReadShmTask.h"
 #include "StatTask.h"
 #include "TruncateTask.h"
 #include "UnlinkTask.h"
 #include "WriteTask.h"
+#include "WriteShmTask.h"
 #include "SyncTask.h"
 #include "SessionManager.h"
 #include "SMLogging.h"
@@ -93,6 +95,8 @@ void ProcessTask::operator()()
     case PING: task.reset(new PingTask(sock, length)); break;
     case SYNC: task.reset(new SyncTask(sock, length)); break;
     case COPY: task.reset(new CopyTask(sock, length)); break;
+    case READ_SHM: task.reset(new ReadShmTask(sock, length)); break;
+    case WRITE_SHM: task.reset(new WriteShmTask(sock, length)); break;
     default: throw runtime_error("ProcessTask: got an unknown opcode");
   }
   task->primeBuffer();
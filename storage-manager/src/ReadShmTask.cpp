@@ -0,0 +1,113 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include "ReadShmTask.h"
+#include "messageFormat.h"
+#include "SharedMemoryRegions.h"
+#include "SMLogging.h"
+#include <errno.h>
+
+using namespace std;
+
+namespace storagemanager
+{
+ReadShmTask::ReadShmTask(int sock, uint len) : PosixTask(sock, len)
+{
+}
+
+ReadShmTask::~ReadShmTask()
+{
+}
+
+#define check_error(msg, ret) \
+  if (success < 0)            \
+  {                           \
+    handleError(msg, errno);  \
+    return ret;               \
+  }
+
+bool ReadShmTask::run()
+{
+  SMLogging* logger = SMLogging::get();
+  uint8_t buf[2048] = {0};
+
+  if (getLength() > 2047)
+  {
+    handleError("ReadShmTask read", ENAMETOOLONG);
+    return true;
+  }
+
+  int success;
+  success = read(buf, getLength());
+  check_error("ReadShmTask read cmd", false);
+  read_shm_cmd* cmd = (read_shm_cmd*)buf;
+  string regionName(cmd->region.filename, cmd->region.flen);
+  f_name* filename = (f_name*)&buf[sizeof(read_shm_cmd) + cmd->region.flen];
+
+#ifdef SM_TRACE
+  logger->log(LOG_DEBUG, "read_shm %s count %i offset %i region %s.", filename->filename, cmd->count,
+              cmd->offset, regionName.c_str());
+#endif
+
+  SharedMemoryRegions::RegionPtr region = SharedMemoryRegions::get()->attach(regionName);
+  if (!region)
+  {
+    handleError("ReadShmTask attach", errno);
+    return true;
+  }
+  if (cmd->regionOffset > region->size || cmd->count > region->size - cmd->regionOffset)
+  {
+    handleError("ReadShmTask", EINVAL);
+    return true;
+  }
+
+  // read from IOC straight into the client's region
+  uint8_t* data = &region->mem[cmd->regionOffset];
+  ssize_t count = 0;
+  ssize_t err;
+  while ((size_t)count < cmd->count)
+  {
+    try
+    {
+      err = ioc->read(filename->filename, &data[count], cmd->offset + count, cmd->count - count);
+    }
+    catch (exception& e)
+    {
+      logger->log(LOG_ERR, "ReadShmTask: caught '%s'", e.what());
+      errno = EIO;
+      err = -1;
+    }
+    if (err < 0)
+    {
+      if (count == 0)
+      {
+        handleError("ReadShmTask", errno);
+        return true;
+      }
+      break;
+    }
+    if (err == 0)
+      break;
+    count += err;
+  }
+
+  sm_response* resp = (sm_response*)buf;
+  resp->returnCode = count;
+  return write(*resp, 0);
+}
+
+}  // namespace storagemanager
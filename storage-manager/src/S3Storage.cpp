@@ -38,6 +38,8 @@
 #pragma GCC diagnostic pop
 #endif
 #include <boost/property_tree/json_parser.hpp>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
 #include "Utilities.h"
 
 using namespace std;
@@ -58,6 +60,78 @@ static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* use
   return size * nmemb;
 }
 
+struct S3Storage::RangeBuffer
+{
+  std::shared_ptr<uint8_t[]> data;
+  size_t capacity;
+  size_t count;
+};
+
+size_t S3Storage::rangeWriteCallback(void* contents, size_t size, size_t nmemb, void* userp)
+{
+  RangeBuffer* buf = (RangeBuffer*)userp;
+  size_t len = size * nmemb;
+
+  if (buf->count + len > buf->capacity)
+  {
+    size_t newCapacity = max(buf->capacity * 2, buf->count + len);
+    std::shared_ptr<uint8_t[]> newData(new uint8_t[newCapacity]);
+    memcpy(newData.get(), buf->data.get(), buf->count);
+    buf->data = newData;
+    buf->capacity = newCapacity;
+  }
+  memcpy(&buf->data[buf->count], contents, len);
+  buf->count += len;
+  return len;
+}
+
+static string toHex(const unsigned char* in, size_t len)
+{
+  static const char digits[] = "0123456789abcdef";
+  string ret(len * 2, '0');
+  for (size_t i = 0; i < len; i++)
+  {
+    ret[i * 2] = digits[in[i] >> 4];
+    ret[i * 2 + 1] = digits[in[i] & 0xf];
+  }
+  return ret;
+}
+
+static string sha256Hex(const string& in)
+{
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned int mdLen = 0;
+  EVP_Digest(in.data(), in.length(), md, &mdLen, EVP_sha256(), NULL);
+  return toHex(md, mdLen);
+}
+
+static string hmacSha256(const string& key, const string& msg)
+{
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned int mdLen = 0;
+  HMAC(EVP_sha256(), key.data(), key.length(), (const unsigned char*)msg.data(), msg.length(), md, &mdLen);
+  return string((char*)md, mdLen);
+}
+
+// URI-encodes everything but the unreserved characters and '/'
+static string uriEncodePath(const string& in)
+{
+  static const char digits[] = "0123456789ABCDEF";
+  string ret;
+  for (unsigned char c : in)
+  {
+    if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == '/')
+      ret += c;
+    else
+    {
+      ret += '%';
+      ret += digits[c >> 4];
+      ret += digits[c & 0xf];
+    }
+  }
+  return ret;
+}
+
 inline bool retryable_error(uint8_t s3err)
 {
   return (s3err == MS3_ERR_RESPONSE_PARSE || s3err == MS3_ERR_REQUEST_ERROR || s3err == MS3_ERR_OOM ||
@@ -420,6 +494,178 @@ int S3Storage::getObject(const string& _sourceKey, std::shared_ptr<uint8_t[]>* d
   return 0;
 }
 
+bool S3Storage::supportsRangedGets() const
+{
+  // An assumed role's credentials stay inside libmarias3, so those can't sign a ranged GET
+  return IAMrole.empty() || isEC2Instance;
+}
+
+CURLcode S3Storage::rangedGet(const string& objectKey, const string& range, RangeBuffer* buf, long* httpCode)
+{
+  const string signingRegion = (region.empty() ? "us-east-1" : region);
+  string host, path;
+
+  // virtual-hosted style on AWS, path style on other endpoints
+  if (endpoint.empty())
+  {
+    host = bucket + ".s3." + signingRegion + ".amazonaws.com";
+    path = "/" + uriEncodePath(objectKey);
+  }
+  else
+  {
+    host = endpoint;
+    path = "/" + uriEncodePath(bucket) + "/" + uriEncodePath(objectKey);
+  }
+  // curl leaves the default port out of the Host header, so the signature has to as well
+  if (portNumber != 0 && portNumber != (useHTTP ? 80 : 443))
+    host += ":" + to_string(portNumber);
+
+  time_t now = time(NULL);
+  struct tm gmt;
+  gmtime_r(&now, &gmt);
+  char amzDate[17], dateStamp[9];
+  strftime(amzDate, sizeof(amzDate), "%Y%m%dT%H%M%SZ", &gmt);
+  strftime(dateStamp, sizeof(dateStamp), "%Y%m%d", &gmt);
+
+  const string payloadHash = sha256Hex("");
+  string canonicalHeaders = "host:" + host + "\nrange:" + range + "\nx-amz-content-sha256:" + payloadHash +
+                            "\nx-amz-date:" + amzDate + "\n";
+  string signedHeaders = "host;range;x-amz-content-sha256;x-amz-date";
+  if (!token.empty())
+  {
+    canonicalHeaders += "x-amz-security-token:" + token + "\n";
+    signedHeaders += ";x-amz-security-token";
+  }
+  string canonicalRequest =
+      "GET\n" + path + "\n\n" + canonicalHeaders + "\n" + signedHeaders + "\n" + payloadHash;
+  string scope = string(dateStamp) + "/" + signingRegion + "/s3/aws4_request";
+  string stringToSign = "AWS4-HMAC-SHA256\n" + string(amzDate) + "\n" + scope + "\n" + sha256Hex(canonicalRequest);
+  string signingKey =
+      hmacSha256(hmacSha256(hmacSha256(hmacSha256("AWS4" + secret, dateStamp), signingRegion), "s3"),
+                 "aws4_request");
+  string signature = hmacSha256(signingKey, stringToSign);
+
+  struct curl_slist* headers = NULL;
+  headers = curl_slist_append(headers, ("Range: " + range).c_str());
+  headers = curl_slist_append(headers, ("x-amz-content-sha256: " + payloadHash).c_str());
+  headers = curl_slist_append(headers, ("x-amz-date: " + string(amzDate)).c_str());
+  if (!token.empty())
+    headers = curl_slist_append(headers, ("x-amz-security-token: " + token).c_str());
+  headers = curl_slist_append(
+      headers, ("Authorization: AWS4-HMAC-SHA256 Credential=" + key + "/" + scope +
+                ", SignedHeaders=" + signedHeaders +
+                ", Signature=" + toHex((const unsigned char*)signature.data(), signature.length()))
+                   .c_str());
+
+  string url = string(useHTTP ? "http://" : "https://") + host + path;
+  CURL* curl = curl_easy_init();
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, rangeWriteCallback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, buf);
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+  if (!sslVerify)
+  {
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+  }
+  CURLcode curl_res = curl_easy_perform(curl);
+  *httpCode = 0;
+  if (curl_res == CURLE_OK)
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, httpCode);
+  curl_easy_cleanup(curl);
+  curl_slist_free_all(headers);
+  return curl_res;
+}
+
+int S3Storage::getObjectRange(const string& _sourceKey, off_t offset, size_t length,
+                              std::shared_ptr<uint8_t[]>* data, size_t* size)
+{
+  if (!supportsRangedGets())
+  {
+    errno = ENOTSUP;
+    return -1;
+  }
+
+  string sourceKey = prefix + _sourceKey;
+  string range = "bytes=" + to_string(offset) + "-" + (length != 0 ? to_string(offset + length - 1) : "");
+  RangeBuffer buf;
+  CURLcode curl_res;
+  long httpCode;
+  bool retry;
+
+  do
+  {
+    buf.capacity = (length != 0 ? length : 1 << 20);
+    buf.data.reset(new uint8_t[buf.capacity]);
+    buf.count = 0;
+    curl_res = rangedGet(sourceKey, range, &buf, &httpCode);
+    retry = !skipRetryableErrors && (curl_res != CURLE_OK || httpCode >= 500);
+    if (retry)
+    {
+      if (curl_res != CURLE_OK)
+        logger->log(LOG_WARNING,
+                    "S3Storage::getObjectRange(): failed to GET, got '%s'.  bucket = %s, key = %s.  Retrying...",
+                    curl_easy_strerror(curl_res), bucket.c_str(), sourceKey.c_str());
+      else
+        logger->log(LOG_WARNING,
+                    "S3Storage::getObjectRange(): failed to GET, server says %ld.  bucket = %s, key = %s.  "
+                    "Retrying...",
+                    httpCode, bucket.c_str(), sourceKey.c_str());
+      if (ec2iamEnabled)
+      {
+        getIAMRoleFromMetadataEC2();
+        getCredentialsFromMetadataEC2();
+      }
+      sleep(5);
+    }
+  } while (retry);
+
+  if (curl_res != CURLE_OK)
+  {
+    logger->log(LOG_ERR, "S3Storage::getObjectRange(): failed to GET, got '%s'.  bucket = %s, key = %s.",
+                curl_easy_strerror(curl_res), bucket.c_str(), sourceKey.c_str());
+    data->reset();
+    errno = ECOMM;
+    return -1;
+  }
+
+  switch (httpCode)
+  {
+    case 206: break;
+    case 200:
+      // the server ignored the Range header and sent the whole object
+      if ((size_t)offset >= buf.count)
+        buf.count = 0;
+      else
+      {
+        size_t l_size = buf.count - offset;
+        if (length != 0 && length < l_size)
+          l_size = length;
+        std::shared_ptr<uint8_t[]> slice(new uint8_t[l_size]);
+        memcpy(slice.get(), &buf.data[offset], l_size);
+        buf.data = slice;
+        buf.count = l_size;
+      }
+      break;
+    case 416:
+      // the range starts past the end of the object
+      buf.count = 0;
+      break;
+    default:
+      logger->log(LOG_ERR, "S3Storage::getObjectRange(): failed to GET, server says %ld.  bucket = %s, key = %s.",
+                  httpCode, bucket.c_str(), sourceKey.c_str());
+      data->reset();
+      errno = (httpCode == 404 ? ENOENT : (httpCode == 401 || httpCode == 403) ? EKEYREJECTED : EPROTO);
+      return -1;
+  }
+
+  *data = buf.data;
+  *size = buf.count;
+  ++rangesGotten;
+  return 0;
+}
+
 int S3Storage::putObject(const string& sourceFile, const string& destKey)
 {
   std::shared_ptr<uint8_t[]> data;
@@ -37,6 +37,9 @@ class S3Storage : public CloudStorage
 
   int getObject(const std::string& sourceKey, const std::string& destFile, size_t* size = NULL);
   int getObject(const std::string& sourceKey, std::shared_ptr<uint8_t[]>* data, size_t* size = NULL);
+  int getObjectRange(const std::string& sourceKey, off_t offset, size_t length, std::shared_ptr<uint8_t[]>* data,
+                     size_t* size);
+  bool supportsRangedGets() const;
   int putObject(const std::string& sourceFile, const std::string& destKey);
   int putObject(const std::shared_ptr<uint8_t[]> data, size_t len, const std::string& destKey);
   int deleteObject(const std::string& key);
@@ -50,6 +53,12 @@ class S3Storage : public CloudStorage
   ms3_st* getConnection();
   void returnConnection(ms3_st*);
 
+  // libmarias3 has no ranged GET, so these are sent with curl and signed here (AWS SigV4)
+  struct RangeBuffer;
+  static size_t rangeWriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
+  CURLcode rangedGet(const std::string& objectKey, const std::string& range, RangeBuffer* buf,
+                     long* httpCode);
+
   bool skipRetryableErrors;
 
   std::string bucket;  // might store this as a char *, since it's only used that way
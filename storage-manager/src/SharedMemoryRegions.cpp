@@ -0,0 +1,159 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include "SharedMemoryRegions.h"
+#include "messageFormat.h"
+#include "Utilities.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace
+{
+storagemanager::SharedMemoryRegions* inst = NULL;
+boost::mutex m;
+
+// with the default 30 sockets per client, this covers ~30 client processes
+const size_t defaultMaxRegions = 1024;
+}  // namespace
+
+namespace storagemanager
+{
+SharedMemoryRegions* SharedMemoryRegions::get()
+{
+  if (inst)
+    return inst;
+  boost::mutex::scoped_lock s(m);
+  if (inst)
+    return inst;
+  inst = new SharedMemoryRegions();
+  return inst;
+}
+
+SharedMemoryRegions::SharedMemoryRegions() : maxRegions(defaultMaxRegions)
+{
+  logger = SMLogging::get();
+  removeOrphans();
+}
+
+SharedMemoryRegions::~SharedMemoryRegions()
+{
+}
+
+SharedMemoryRegions::Region::Region(uint8_t* _mem, size_t _size) : mem(_mem), size(_size)
+{
+}
+
+SharedMemoryRegions::Region::~Region()
+{
+  ::munmap(mem, size);
+}
+
+SharedMemoryRegions::RegionPtr SharedMemoryRegions::attach(const string& name)
+{
+  boost::mutex::scoped_lock s(mutex);
+
+  auto it = regions.find(name);
+  if (it != regions.end())
+  {
+    lru.splice(lru.end(), lru, it->second.lruit);
+    return it->second.region;
+  }
+  s.unlock();
+
+  // only map what our clients create, and never anything with a path in it
+  size_t prefixLen = strlen(shm_region_prefix);
+  if (name.compare(0, prefixLen, shm_region_prefix) != 0 || name.find('/', 1) != string::npos)
+  {
+    errno = EINVAL;
+    return RegionPtr();
+  }
+
+  int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0)
+    return RegionPtr();
+  ScopedCloser closer(fd);
+
+  struct stat statbuf;
+  if (::fstat(fd, &statbuf))
+    return RegionPtr();
+  if (statbuf.st_size == 0)
+  {
+    errno = EINVAL;
+    return RegionPtr();
+  }
+  void* mem = ::mmap(NULL, statbuf.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mem == MAP_FAILED)
+    return RegionPtr();
+  RegionPtr ret(new Region((uint8_t*)mem, statbuf.st_size));
+
+  s.lock();
+  // another thread may have mapped it in the meantime, use theirs
+  it = regions.find(name);
+  if (it != regions.end())
+  {
+    lru.splice(lru.end(), lru, it->second.lruit);
+    return it->second.region;
+  }
+
+  // A region that isn't in the map can't be used by a new cmd.  Tasks still using it
+  // hold a ptr to it, and the last one unmaps it.
+  while (regions.size() >= maxRegions)
+  {
+    regions.erase(lru.front());
+    lru.pop_front();
+  }
+  Mapping& mapping = regions[name];
+  mapping.region = ret;
+  mapping.lruit = lru.insert(lru.end(), name);
+  return ret;
+}
+
+void SharedMemoryRegions::removeOrphans()
+{
+  // Clients unlink their regions when they exit normally.  Regions left behind by processes that
+  // crashed would otherwise accumulate in /dev/shm until the next reboot.
+  DIR* dir = ::opendir("/dev/shm");
+  if (!dir)
+    return;
+
+  const char* prefix = &shm_region_prefix[1];  // the entries in /dev/shm don't have the leading '/'
+  size_t prefixLen = strlen(prefix);
+  struct dirent* entry;
+  while ((entry = ::readdir(dir)) != NULL)
+  {
+    if (strncmp(entry->d_name, prefix, prefixLen) != 0)
+      continue;
+    pid_t pid = strtol(&entry->d_name[prefixLen], NULL, 10);
+    if (pid <= 0 || ::kill(pid, 0) == 0 || errno != ESRCH)
+      continue;
+    string name = string("/") + entry->d_name;
+    if (::shm_unlink(name.c_str()) == 0)
+      logger->log(LOG_INFO, "SharedMemoryRegions: removed %s, left behind by process %d", name.c_str(), pid);
+  }
+  ::closedir(dir);
+}
+
+}  // namespace storagemanager
@@ -0,0 +1,72 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include "SMLogging.h"
+
+/* Keeps the shared memory regions clients pass in READ_SHM and WRITE_SHM commands mapped, so
+   a region is only opened and mapped the first time a client uses it.  A client keeps a small
+   number of regions for its lifetime, so in practice this is a handful of mappings per client process. */
+
+namespace storagemanager
+{
+class SharedMemoryRegions : public boost::noncopyable
+{
+ public:
+  static SharedMemoryRegions* get();
+  ~SharedMemoryRegions();
+
+  struct Region
+  {
+    Region(uint8_t* _mem, size_t _size);
+    ~Region();
+    uint8_t* mem;
+    size_t size;
+  };
+  typedef std::shared_ptr<Region> RegionPtr;
+
+  // Returns the mapping of the named region, mapping it if necessary.  The mapping stays valid
+  // as long as the caller holds the returned ptr.  On error, returns a null ptr and sets errno.
+  RegionPtr attach(const std::string& name);
+
+ private:
+  SharedMemoryRegions();
+
+  // unlinks regions left behind by client processes that no longer exist
+  void removeOrphans();
+
+  typedef std::list<std::string> LRU_t;
+  struct Mapping
+  {
+    RegionPtr region;
+    LRU_t::iterator lruit;
+  };
+  std::unordered_map<std::string, Mapping> regions;
+  LRU_t lru;
+  size_t maxRegions;
+  SMLogging* logger;
+  boost::mutex mutex;
+};
+
+}  // namespace storagemanager
@@ -0,0 +1,111 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include "WriteShmTask.h"
+#include "messageFormat.h"
+#include "SharedMemoryRegions.h"
+#include "SMLogging.h"
+#include <errno.h>
+
+using namespace std;
+
+namespace storagemanager
+{
+WriteShmTask::WriteShmTask(int sock, uint len) : PosixTask(sock, len)
+{
+}
+
+WriteShmTask::~WriteShmTask()
+{
+}
+
+#define check_error(msg, ret) \
+  if (success < 0)            \
+  {                           \
+    handleError(msg, errno);  \
+    return ret;               \
+  }
+
+bool WriteShmTask::run()
+{
+  SMLogging* logger = SMLogging::get();
+  uint8_t buf[2048] = {0};
+
+  if (getLength() > 2047)
+  {
+    handleError("WriteShmTask read", ENAMETOOLONG);
+    return true;
+  }
+
+  int success;
+  success = read(buf, getLength());
+  check_error("WriteShmTask read cmd", false);
+  write_shm_cmd* cmd = (write_shm_cmd*)buf;
+  string regionName(cmd->region.filename, cmd->region.flen);
+  f_name* filename = (f_name*)&buf[sizeof(write_shm_cmd) + cmd->region.flen];
+
+#ifdef SM_TRACE
+  logger->log(LOG_DEBUG, "write_shm %s offset %i count %i region %s.", filename->filename, cmd->offset,
+              cmd->count, regionName.c_str());
+#endif
+
+  SharedMemoryRegions::RegionPtr region = SharedMemoryRegions::get()->attach(regionName);
+  if (!region)
+  {
+    handleError("WriteShmTask attach", errno);
+    return true;
+  }
+  if (cmd->count < 0 || cmd->regionOffset > region->size ||
+      (size_t)cmd->count > region->size - cmd->regionOffset)
+  {
+    handleError("WriteShmTask", EINVAL);
+    return true;
+  }
+
+  // write to IOC straight from the client's region
+  const uint8_t* data = &region->mem[cmd->regionOffset];
+  ssize_t writeCount = 0;
+  ssize_t err;
+  while (writeCount < cmd->count)
+  {
+    try
+    {
+      err = ioc->write(filename->filename, &data[writeCount], cmd->offset + writeCount,
+                       cmd->count - writeCount);
+    }
+    catch (exception& e)
+    {
+      logger->log(LOG_ERR, "WriteShmTask: caught '%s'", e.what());
+      errno = EIO;
+      err = -1;
+    }
+    if (err <= 0)
+      break;
+    writeCount += err;
+  }
+
+  if (cmd->count != 0 && writeCount == 0)
+  {
+    handleError("WriteShmTask", errno);
+    return true;
+  }
+  sm_response* resp = (sm_response*)buf;
+  resp->returnCode = writeCount;
+  return write(*resp, 0);
+}
+
+}  // namespace storagemanager
@@ -34,6 +34,7 @@
 #include "Utilities.h"
 #include "Synchronizer.h"
 #include "ProcessTask.h"
+#include "SharedMemoryRegions.h"
 
 #include <iostream>
 #include <stdlib.h>
@@ -44,12 +45,14 @@
 #include <sys/un.h>
 #include <string.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <boost/filesystem.hpp>
 #include <boost/thread.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include <algorithm>
 #include <random>
+#include <chrono>
 
 #undef NDEBUG
 #include <cassert>
@@ -1129,6 +1132,46 @@ bool localstorageTest1()
   return true;
 }
 
+bool localstorageRangeTest()
+{
+  CloudStorage* cs = CloudStorage::get();
+  LocalStorage* ls = dynamic_cast<LocalStorage*>(cs);
+  if (ls == NULL)
+  {
+    cout << "local storage range test requires using local storage" << endl;
+    return false;
+  }
+  assert(ls->supportsRangedGets());
+
+  bf::path storagePath = ls->getPrefix();
+  string key = "12345_0_8192_" + prefix + "~range-test";
+  makeTestObject((storagePath / key).string().c_str());
+
+  std::shared_ptr<uint8_t[]> data;
+  size_t size;
+  int err = ls->getObjectRange(key, 4000, 1000, &data, &size);
+  assert(!err);
+  assert(size == 1000);
+  int* data32 = (int*)data.get();
+  for (int i = 0; i < 250; i++)
+    assert(data32[i] == i + 1000);
+
+  // length 0 reads to the end, a range that runs off the end is cut short
+  err = ls->getObjectRange(key, 4096, 0, &data, &size);
+  assert(!err && size == 4096);
+  err = ls->getObjectRange(key, 8000, 1000, &data, &size);
+  assert(!err && size == 192);
+  err = ls->getObjectRange(key, 9000, 1000, &data, &size);
+  assert(!err && size == 0);
+
+  err = ls->getObjectRange("does-not-exist", 0, 1000, &data, &size);
+  assert(err && errno == ENOENT);
+
+  bf::remove(storagePath / key);
+  cout << "local storage range test OK" << endl;
+  return true;
+}
+
 bool cacheTest1()
 {
   Cache* cache = Cache::get();
@@ -1186,6 +1229,58 @@ bool cacheTest1()
   return true;
 }
 
+// Hammers the cache index from several threads with the pin / lookup / unpin pattern IOCoordinator
+// uses on reads of cached objects.  None of this needs lru_mutex.
+bool cacheIndexStressTest()
+{
+  Cache* cache = Cache::get();
+  const uint objectCount = 10000, threadCount = 16, batchSize = 8, batchesPerThread = 20000;
+
+  cache->reset();
+  vector<string> keys;
+  for (uint i = 0; i < objectCount; i++)
+  {
+    keys.push_back((boost::format("%s_cacheIndexStressTest_%u") % testObjKey % i).str());
+    cache->newObject(prefix, keys.back(), 1);
+  }
+  assert(cache->getCurrentCacheElementCount(prefix) == objectCount);
+
+  auto worker = [&](uint seed)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint> pick(0, objectCount - 1);
+    vector<string> batch(batchSize);
+    vector<bool> exists;
+    for (uint i = 0; i < batchesPerThread; i++)
+    {
+      for (uint j = 0; j < batchSize; j++)
+        batch[j] = keys[pick(gen)];
+      cache->read(prefix, batch);
+      cache->exists(prefix, batch, &exists);
+      assert(std::all_of(exists.begin(), exists.end(), [](bool b) { return b; }));
+      cache->doneReading(prefix, batch);
+    }
+  };
+
+  boost::thread_group threads;
+  auto start = std::chrono::steady_clock::now();
+  for (uint i = 0; i < threadCount; i++)
+    threads.create_thread(boost::bind<void>(worker, i));
+  threads.join_all();
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  cout << "cache index stress test: " << threadCount << " threads, "
+       << (uint64_t)(threadCount * batchesPerThread * batchSize * 3 / elapsed) << " key ops/s" << endl;
+
+  assert(cache->getCurrentCacheElementCount(prefix) == objectCount);
+  for (const string& key : keys)
+    cache->deletedObject(prefix, key, 1);
+  assert(cache->getCurrentCacheElementCount(prefix) == 0);
+  assert(cache->getCurrentCacheSize(prefix) == 0);
+  cout << "cache index stress test OK" << endl;
+  return true;
+}
+
 bool mergeJournalTest()
 {
   /*
@@ -1248,6 +1343,79 @@ bool mergeJournalTest()
   return true;
 }
 
+bool mergeJournalFDTest()
+{
+  /*
+      merge the test object and journal with the fd version of mergeJournal at
+      various offsets, and verify it matches what the original version returns
+  */
+  makeTestObject("test-object");
+  makeTestJournal("test-journal");
+
+  IOCoordinator* ioc = IOCoordinator::get();
+  int objFD = ::open("test-object", O_RDONLY);
+  int journalFD = ::open("test-journal", O_RDONLY);
+  assert(objFD >= 0 && journalFD >= 0);
+  ScopedCloser s1(objFD), s2(journalFD);
+
+  const pair<off_t, size_t> ranges[] = {{0, 8192}, {20, 40}, {8, 24}, {28, 20}, {100, 1000}, {4096, 8192}};
+  vector<uint8_t> buf;
+  for (const auto& range : ranges)
+  {
+    size_t tmp;
+    std::shared_ptr<uint8_t[]> expected = ioc->mergeJournal("test-object", "test-journal", range.first,
+                                                              range.second, &tmp);
+    assert(expected);
+    buf.assign(range.second, 0xff);
+    int err = ioc->mergeJournal(objFD, journalFD, buf.data(), range.first, range.second, &tmp);
+    assert(err == 0);
+    // the original version leaves whatever was in its buffer past the end of the object
+    size_t objBytes = min<size_t>(range.second, max<off_t>(0, 8192 - range.first));
+    assert(memcmp(buf.data(), expected.get(), objBytes) == 0);
+    for (size_t i = objBytes; i < range.second; i++)
+      assert(buf[i] == 0);
+  }
+
+  bf::remove("test-object");
+  bf::remove("test-journal");
+  cout << "mergeJournalFDTest OK" << endl;
+  return true;
+}
+
+bool sharedMemoryRegionsTest()
+{
+  SharedMemoryRegions* regions = SharedMemoryRegions::get();
+
+  // names that don't belong to a client are refused
+  assert(!regions->attach("/some-other-region"));
+  assert(errno == EINVAL);
+  assert(!regions->attach(string(shm_region_prefix) + "1/../../etc"));
+  assert(errno == EINVAL);
+  assert(!regions->attach(string(shm_region_prefix) + "0.0.doesnotexist"));
+  assert(errno == ENOENT);
+
+  string name = string(shm_region_prefix) + to_string(getpid()) + ".0.unittest";
+  const size_t size = 1 << 16;
+  int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  assert(fd >= 0);
+  int err = ::ftruncate(fd, size);
+  assert(err == 0);
+  uint8_t* mem = (uint8_t*)::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  assert(mem != MAP_FAILED);
+  ::close(fd);
+
+  SharedMemoryRegions::RegionPtr region = regions->attach(name);
+  assert(region && region->size == size);
+  assert(regions->attach(name) == region);
+  region->mem[100] = 42;
+  assert(mem[100] == 42);
+
+  ::munmap(mem, size);
+  ::shm_unlink(name.c_str());
+  cout << "sharedMemoryRegionsTest OK" << endl;
+  return true;
+}
+
 bool syncTest1()
 {
   IOCoordinator* ioc = IOCoordinator::get();
@@ -1388,6 +1556,45 @@ void metadataUpdateTest()
   ::unlink(metaFilePath.c_str());
 }
 
+// a JSON metadata file gets converted to the binary format the first time it's loaded
+void metadataConversionTest()
+{
+  Config* config = Config::get();
+  bf::path metaPath = config->getValue("ObjectStorage", "metadata_path");
+  bf::path metaFilePath = metaPath / "metadataConversionTest.meta";
+  string key = testObjKey;
+
+  makeTestMetadata(metaFilePath.string().c_str(), key);
+  MetadataFile::deletedMeta(metaFilePath);
+  {
+    MetadataFile meta("metadataConversionTest", MetadataFile::no_create_t(), true);
+    assert(meta.exists());
+    assert(meta.getLength() == 8192);
+  }
+
+  char magic[4];
+  int fd = ::open(metaFilePath.string().c_str(), O_RDONLY);
+  assert(fd >= 0);
+  scoped_closer s1(fd);
+  assert(::read(fd, magic, 4) == 4);
+  assert(memcmp(magic, "SMMD", 4) == 0);
+
+  // load the converted file instead of the cached image
+  MetadataFile::deletedMeta(metaFilePath);
+  {
+    MetadataFile meta("metadataConversionTest", MetadataFile::no_create_t(), true);
+    metadataObject obj;
+    assert(meta.getEntry(0, &obj));
+    assert(obj.key == key && obj.length == 8192);
+    assert(!meta.getEntry(100, &obj));
+    vector<metadataObject> objs = meta.metadataRead(100, 1000);
+    assert(objs.size() == 1 && objs[0].key == key);
+  }
+  MetadataFile::deletedMeta(metaFilePath);
+  ::unlink(metaFilePath.string().c_str());
+  cout << "metadata conversion test OK" << endl;
+}
+
 void s3storageTest1()
 {
   try
@@ -1472,6 +1679,66 @@ void s3storageTest1()
   }
 }
 
+void s3storageRangeTest()
+{
+  try
+  {
+    S3Storage s3;
+    if (!s3.supportsRangedGets())
+    {
+      cout << "s3storageRangeTest() needs credentials that can sign a request, skipping it" << endl;
+      return;
+    }
+
+    string key = "12345_0_8192_" + prefix + "~s3-range-test";
+    std::shared_ptr<uint8_t[]> obj(new uint8_t[8192]);
+    int* obj32 = (int*)obj.get();
+    for (int i = 0; i < 2048; i++)
+      obj32[i] = i;
+    int err = s3.putObject(obj, 8192, key);
+    assert(!err);
+
+    std::shared_ptr<uint8_t[]> data;
+    size_t size;
+    err = s3.getObjectRange(key, 4000, 1000, &data, &size);
+    assert(!err);
+    assert(size == 1000);
+    assert(!memcmp(data.get(), &obj[4000], 1000));
+
+    // length 0 reads to the end, a range that runs off the end is cut short
+    err = s3.getObjectRange(key, 4096, 0, &data, &size);
+    assert(!err && size == 4096);
+    assert(!memcmp(data.get(), &obj[4096], 4096));
+    err = s3.getObjectRange(key, 8000, 1000, &data, &size);
+    assert(!err && size == 192);
+    assert(!memcmp(data.get(), &obj[8000], 192));
+    err = s3.getObjectRange(key, 9000, 1000, &data, &size);
+    assert(!err && size == 0);
+
+    // the ranges put together are the object
+    std::shared_ptr<uint8_t[]> whole;
+    err = s3.getObject(key, &whole, &size);
+    assert(!err && size == 8192);
+    for (off_t offset = 0; offset < 8192; offset += 3000)
+    {
+      err = s3.getObjectRange(key, offset, 3000, &data, &size);
+      assert(!err && size == min<size_t>(3000, 8192 - offset));
+      assert(!memcmp(data.get(), &whole[offset], size));
+    }
+
+    err = s3.getObjectRange("does-not-exist", 0, 1000, &data, &size);
+    assert(err && errno == ENOENT);
+
+    s3.deleteObject(key);
+    cout << "S3Storage range test OK" << endl;
+  }
+  catch (exception& e)
+  {
+    cout << __FUNCTION__ << " caught " << e.what() << endl;
+    assert(0);
+  }
+}
+
 void IOCReadTest1()
 {
   /*  Generate the test object & metadata
@@ -1553,6 +1820,66 @@ void IOCReadTest1()
   cout << "IOC read test 1 OK" << endl;
 }
 
+// Reads a 6-object file sequentially, and checks that the objects after the read position
+// get prefetched.  Requires prefetch_depth = 2 in the test config.
+void IOCPrefetchTest()
+{
+  Cache* cache = Cache::get();
+  CloudStorage* cs = CloudStorage::get();
+  IOCoordinator* ioc = IOCoordinator::get();
+  LocalStorage* ls = dynamic_cast<LocalStorage*>(cs);
+  if (!ls)
+  {
+    cout << "IOC prefetch test requires LocalStorage for now." << endl;
+    return;
+  }
+  cache->reset();
+
+  bf::path storagePath = ls->getPrefix();
+  bf::path prefetchFile = homepath / prefix / "prefetch-file";
+  vector<string> keys;
+  {
+    MetadataFile meta(prefix + "/prefetch-file");
+    for (int i = 0; i < 6; i++)
+    {
+      keys.push_back(meta.addMetadataObject(prefetchFile, 8192).key);
+      makeTestObject((storagePath / keys.back()).string().c_str());
+    }
+    meta.writeMetadata();
+  }
+
+  // the 3rd sequential read should start the prefetch of objects 3 & 4
+  uint8_t buf[8192];
+  for (int i = 0; i < 3; i++)
+  {
+    int err = ioc->read(prefetchFile.string().c_str(), buf, i * 8192, 8192);
+    assert(err == 8192);
+    assert(((int*)buf)[2047] == 2047);
+  }
+
+  vector<string> prefetched(keys.begin() + 3, keys.end());
+  vector<bool> exists;
+  for (int i = 0; i < 100; i++)
+  {
+    cache->exists(prefix, prefetched, &exists);
+    if (exists[0] && exists[1])
+      break;
+    usleep(50000);
+  }
+  assert(exists[0] && exists[1]);
+  assert(!exists[2]);
+
+  int err = ioc->read(prefetchFile.string().c_str(), buf, 3 * 8192, 8192);
+  assert(err == 8192);
+  for (int i = 0; i < 2048; i++)
+    assert(((int*)buf)[i] == i);
+
+  cache->reset();
+  err = ioc->unlink(prefetchFile.string().c_str());
+  assert(err >= 0);
+  cout << "IOC prefetch test OK" << endl;
+}
+
 void IOCUnlink()
 {
   IOCoordinator* ioc = IOCoordinator::get();
@@ -1916,6 +2243,7 @@ int main(int argc, char* argv[])
 
   opentask();
   metadataUpdateTest();
+  metadataConversionTest();
 
   // create the metadatafile to use
   // requires 8K object size to test boundries
@@ -1958,8 +2286,12 @@ int main(int argc, char* argv[])
   copytask();
 
   localstorageTest1();
+  localstorageRangeTest();
   cacheTest1();
+  cacheIndexStressTest();
   mergeJournalTest();
+  mergeJournalFDTest();
+  sharedMemoryRegionsTest();
 
   replicatorTest();
   syncTest1();
@@ -1967,6 +2299,7 @@ int main(int argc, char* argv[])
 
 
   IOCReadTest1();
+  IOCPrefetchTest();
 
   // broken
   //IOCTruncate();
@@ -1982,6 +2315,7 @@ int main(int argc, char* argv[])
   if (config->getValue("S3", "region") != "")
   {
     s3storageTest1();
+    s3storageRangeTest();
   }
   else
     cout << "To run the S3Storage unit tests, configure the S3 section of test-data/storagemanager.cnf"
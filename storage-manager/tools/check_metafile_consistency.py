@@ -6,6 +6,7 @@ from pathlib import Path
 import os
 import configparser
 import re
+import struct
 import traceback
 
 
@@ -51,9 +52,27 @@ def parseArgs():
 def key_breakout(key):
     return key.split("_", 3)
 
+# Metadata files are either JSON or the binary format written by MetadataImage:
+# a header (magic, version, revision, object count, keys length), then
+# (offset, length, key offset, key length) per object, then the keys.
+def loadMetadata(metafile):
+    with open(metafile, "rb") as f:
+        data = f.read()
+    if data[:4] != b"SMMD":
+        return json.loads(data)
+
+    version, revision, count, keysLength = struct.unpack_from("=IQQQ", data, 4)
+    keysStart = 32 + count * 24
+    objects = []
+    for i in range(count):
+        offset, length, keyOffset, keyLength = struct.unpack_from("=QQII", data, 32 + i * 24)
+        key = data[keysStart + keyOffset:keysStart + keyOffset + keyLength].decode()
+        objects.append({"offset": offset, "length": length, "key": key})
+    return {"version": version, "revision": revision, "objects": objects}
+
 def validateMetadata(metafile):
     try:
-        metadata = json.load(open(metafile))
+        metadata = loadMetadata(metafile)
 
         for obj in metadata["objects"]:
             bigObjectSet.add(obj["key"])
@@ -0,0 +1,316 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>  // googletest header file
+#include <memory>
+#include <vector>
+
+#include "rowgroup.h"
+#include "joblisttypes.h"
+#include "arithmeticcolumn.h"
+#include "arithmeticoperator.h"
+#include "constantcolumn.h"
+#include "functioncolumn.h"
+#include "logicoperator.h"
+#include "predicateoperator.h"
+#include "simplecolumn.h"
+#include "simplefilter.h"
+#include "funcexp.h"
+#include "batchevaluator.h"
+
+using namespace execplan;
+using CSCDataType = execplan::CalpontSystemCatalog::ColDataType;
+
+// The batch results must match the row based FuncExp::evaluate() on the same rows.
+class BatchEvaluatorTest : public ::testing::Test
+{
+ protected:
+  enum
+  {
+    A,     // BIGINT, every 7th row null
+    B,     // DOUBLE, every 11th row null
+    D,     // DATE
+    OUT,   // BIGINT
+    OUTD,  // DOUBLE
+  };
+
+  static constexpr uint32_t RowCount = 1000;
+
+  void SetUp() override
+  {
+    std::vector<CSCDataType> types = {CalpontSystemCatalog::BIGINT, CalpontSystemCatalog::DOUBLE,
+                                      CalpontSystemCatalog::DATE, CalpontSystemCatalog::BIGINT,
+                                      CalpontSystemCatalog::DOUBLE};
+    std::vector<uint32_t> widths = {8, 8, 4, 8, 8};
+    std::vector<uint32_t> offsets, oids, keys, scale, precision, charsets;
+    uint32_t offset = 2;
+
+    for (uint32_t i = 0; i < types.size(); i++)
+    {
+      offsets.push_back(offset);
+      offset += widths[i];
+      oids.push_back(3000 + i);
+      keys.push_back(i);
+      scale.push_back(0);
+      precision.push_back(18);
+      charsets.push_back(8);
+    }
+
+    offsets.push_back(offset);
+    rg = rowgroup::RowGroup(types.size(), offsets, oids, keys, types, charsets, scale, precision, 20, false);
+    rgData.reinit(rg);
+    rg.setData(&rgData);
+    rg.resetRowGroup(0);
+    rg.initRow(&row);
+    rg.getRow(0, &row);
+
+    for (uint32_t i = 0; i < RowCount; i++, row.nextRow())
+    {
+      row.setIntField<8>((i % 7 == 0) ? joblist::BIGINTNULL : (int64_t)i - 500, A);
+
+      if (i % 11 == 0)
+        row.setIntField<8>(joblist::DOUBLENULL, B);
+      else
+        row.setDoubleField((double)i / 8 - 60, B);
+
+      // year 2000 + i % 30, month i % 12 + 1, day i % 28 + 1
+      row.setUintField<4>(((2000 + i % 30) << 16) | ((i % 12 + 1) << 12) | ((i % 28 + 1) << 6) | 0x3e, D);
+      row.setIntField<8>(0, OUT);
+      row.setDoubleField(0, OUTD);
+    }
+
+    rg.setRowCount(RowCount);
+  }
+
+  static CalpontSystemCatalog::ColType colType(CSCDataType type, uint32_t width = 8)
+  {
+    CalpontSystemCatalog::ColType ct;
+    ct.colDataType = type;
+    ct.colWidth = width;
+    return ct;
+  }
+
+  static SimpleColumn* column(uint32_t index, CSCDataType type, uint32_t width = 8)
+  {
+    SimpleColumn* sc = new SimpleColumn();
+    sc->resultType(colType(type, width));
+    sc->inputIndex(index);
+    return sc;
+  }
+
+  static ParseTree* leaf(TreeNode* node)
+  {
+    return new ParseTree(node);
+  }
+
+  static ParseTree* arithmetic(const std::string& op, ParseTree* lhs, ParseTree* rhs, CSCDataType type)
+  {
+    ArithmeticOperator* o = new ArithmeticOperator(op);
+    o->operationType(colType(type));
+    o->resultType(colType(type));
+    return new ParseTree(o, lhs, rhs);
+  }
+
+  static ArithmeticColumn* arithmeticColumn(ParseTree* expression, CSCDataType type)
+  {
+    ArithmeticColumn* ac = new ArithmeticColumn();
+    ac->expression(expression);
+    ac->resultType(colType(type));
+    return ac;
+  }
+
+  static ParseTree* compare(const std::string& op, ReturnedColumn* lhs, ReturnedColumn* rhs, CSCDataType type)
+  {
+    SOP o(new PredicateOperator(op));
+    o->operationType(colType(type));
+    return new ParseTree(new SimpleFilter(o, lhs, rhs));
+  }
+
+  static ParseTree* logic(const std::string& op, ParseTree* lhs, ParseTree* rhs)
+  {
+    return new ParseTree(new LogicOperator(op), lhs, rhs);
+  }
+
+  static FunctionColumn* function(std::string name, std::vector<ParseTree*> parms, CSCDataType type,
+                                  CSCDataType operationType = CalpontSystemCatalog::BIGINT)
+  {
+    FunctionColumn* fc = new FunctionColumn();
+    funcexp::FunctionParm fp;
+
+    for (ParseTree* p : parms)
+      fp.push_back(SPTP(p));
+
+    fc->functionName(name);
+    fc->functionParms(fp);
+    fc->setFunctor(funcexp::FuncExp::instance()->getFunctor(name));
+    fc->resultType(colType(type));
+    fc->operationType(colType(operationType));
+    return fc;
+  }
+
+  void checkFilter(ParseTree* filter)
+  {
+    std::unique_ptr<ParseTree> owner(filter);
+    std::vector<uint32_t> expected, sel(RowCount);
+
+    rg.getRow(0, &row);
+
+    for (uint32_t i = 0; i < RowCount; i++, row.nextRow())
+    {
+      sel[i] = i;
+
+      if (funcexp::FuncExp::instance()->evaluate(row, filter))
+        expected.push_back(i);
+    }
+
+    funcexp::BatchEvaluator(filter).filter(rg, sel);
+    EXPECT_EQ(expected, sel);
+    EXPECT_FALSE(sel.empty());
+    EXPECT_LT(sel.size(), RowCount);
+  }
+
+  void checkExpression(ReturnedColumn* expression, uint32_t out)
+  {
+    std::unique_ptr<ReturnedColumn> owner(expression);
+    std::vector<uint64_t> expected;
+    std::vector<uint32_t> sel(RowCount);
+
+    expression->outputIndex(out);
+    rg.getRow(0, &row);
+
+    for (uint32_t i = 0; i < RowCount; i++, row.nextRow())
+    {
+      sel[i] = i;
+      funcexp::FuncExp::instance()->evaluate(row, *expression);
+      expected.push_back(row.getUintField<8>(out));
+      row.setUintField<8>(0x5a5a5a5a, out);
+    }
+
+    funcexp::BatchEvaluator(expression).project(rg, sel);
+    rg.getRow(0, &row);
+
+    for (uint32_t i = 0; i < RowCount; i++, row.nextRow())
+      EXPECT_EQ(expected[i], row.getUintField<8>(out)) << "row " << i;
+  }
+
+  rowgroup::RowGroup rg;
+  rowgroup::RGData rgData;
+  rowgroup::Row row;
+};
+
+TEST_F(BatchEvaluatorTest, IntAndDoubleComparisons)
+{
+  checkFilter(logic("and",
+                    compare(">", column(A, CalpontSystemCatalog::BIGINT), new ConstantColumn("-100", (int64_t)-100),
+                            CalpontSystemCatalog::BIGINT),
+                    compare("<", column(B, CalpontSystemCatalog::DOUBLE), new ConstantColumn("20.5", 20.5),
+                            CalpontSystemCatalog::DOUBLE)));
+}
+
+TEST_F(BatchEvaluatorTest, NullsAndShortCircuits)
+{
+  ParseTree* a3 = arithmetic("-",
+                             arithmetic("*", leaf(column(A, CalpontSystemCatalog::BIGINT)),
+                                        leaf(new ConstantColumn("3", (int64_t)3)), CalpontSystemCatalog::BIGINT),
+                             leaf(new ConstantColumn("7", (int64_t)7)), CalpontSystemCatalog::BIGINT);
+
+  checkFilter(logic(
+      "or",
+      compare("isnull", column(B, CalpontSystemCatalog::DOUBLE), new ConstantColumnNull(),
+              CalpontSystemCatalog::DOUBLE),
+      logic("xor",
+            compare(">=", arithmeticColumn(a3, CalpontSystemCatalog::BIGINT), new ConstantColumn("8", (int64_t)8),
+                    CalpontSystemCatalog::BIGINT),
+            compare("<>", column(B, CalpontSystemCatalog::DOUBLE), new ConstantColumn("0", 0.0),
+                    CalpontSystemCatalog::DOUBLE))));
+}
+
+TEST_F(BatchEvaluatorTest, Arithmetic)
+{
+  checkExpression(
+      arithmeticColumn(arithmetic("+",
+                                  arithmetic("*", leaf(column(A, CalpontSystemCatalog::BIGINT)),
+                                             leaf(new ConstantColumn("2", (int64_t)2)), CalpontSystemCatalog::BIGINT),
+                                  leaf(new ConstantColumn("1", (int64_t)1)), CalpontSystemCatalog::BIGINT),
+                       CalpontSystemCatalog::BIGINT),
+      OUT);
+
+  // a zero divisor gives null
+  checkExpression(arithmeticColumn(arithmetic("/", leaf(column(B, CalpontSystemCatalog::DOUBLE)),
+                                              leaf(column(A, CalpontSystemCatalog::BIGINT)),
+                                              CalpontSystemCatalog::DOUBLE),
+                                   CalpontSystemCatalog::DOUBLE),
+                  OUTD);
+}
+
+TEST_F(BatchEvaluatorTest, ConditionalFunctions)
+{
+  checkExpression(function("coalesce", {leaf(column(A, CalpontSystemCatalog::BIGINT)), leaf(new ConstantColumn("-1", (int64_t)-1))},
+                           CalpontSystemCatalog::BIGINT),
+                  OUT);
+
+  checkExpression(function("if",
+                           {compare(">", column(B, CalpontSystemCatalog::DOUBLE), new ConstantColumn("1.5", 1.5),
+                                    CalpontSystemCatalog::DOUBLE),
+                            leaf(column(A, CalpontSystemCatalog::BIGINT)), leaf(new ConstantColumn("7", (int64_t)7))},
+                           CalpontSystemCatalog::BIGINT),
+                  OUT);
+
+  checkExpression(function("case_searched",
+                           {compare("<", column(A, CalpontSystemCatalog::BIGINT), new ConstantColumn("0", (int64_t)0),
+                                    CalpontSystemCatalog::BIGINT),
+                            compare(">", column(B, CalpontSystemCatalog::DOUBLE), new ConstantColumn("10", 10.0),
+                                    CalpontSystemCatalog::DOUBLE),
+                            leaf(new ConstantColumn("1", (int64_t)1)), leaf(new ConstantColumn("2", (int64_t)2)),
+                            leaf(new ConstantColumn("3", (int64_t)3))},
+                           CalpontSystemCatalog::BIGINT),
+                  OUT);
+
+  checkExpression(function("case_simple",
+                           {leaf(column(A, CalpontSystemCatalog::BIGINT)), leaf(new ConstantColumn("-1", (int64_t)-1)),
+                            leaf(new ConstantColumn("5", (int64_t)5)), leaf(new ConstantColumn("10", (int64_t)10)),
+                            leaf(new ConstantColumn("20", (int64_t)20))},
+                           CalpontSystemCatalog::BIGINT),
+                  OUT);
+}
+
+TEST_F(BatchEvaluatorTest, DateParts)
+{
+  for (std::string name : {"year", "month", "day"})
+    checkExpression(function(name, {leaf(column(D, CalpontSystemCatalog::DATE, 4))}, CalpontSystemCatalog::BIGINT),
+                    OUT);
+}
+
+TEST_F(BatchEvaluatorTest, RowGroupFilter)
+{
+  std::unique_ptr<ParseTree> filter(compare("<=", column(A, CalpontSystemCatalog::BIGINT),
+                                            new ConstantColumn("0", (int64_t)0), CalpontSystemCatalog::BIGINT));
+  std::vector<int64_t> expected;
+
+  rg.getRow(0, &row);
+
+  for (uint32_t i = 0; i < RowCount; i++, row.nextRow())
+    if (funcexp::FuncExp::instance()->evaluate(row, filter.get()))
+      expected.push_back(row.getIntField<8>(A));
+
+  funcexp::FuncExp::instance()->evaluate(rg, filter.get());
+  ASSERT_EQ(expected.size(), rg.getRowCount());
+  rg.getRow(0, &row);
+
+  for (uint32_t i = 0; i < rg.getRowCount(); i++, row.nextRow())
+    EXPECT_EQ(expected[i], row.getIntField<8>(A));
+}
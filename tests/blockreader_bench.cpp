@@ -0,0 +1,164 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "blockreader.h"
+#include "UnbufferedFile.h"
+
+using namespace std;
+using namespace dbbc;
+using namespace idbdatafile;
+
+// fio style comparison of the ioManager read paths: reads of one 8KB block * BlocksPerRequest at
+// sequential or random offsets of a scratch file, pread against io_uring at several queue depths.
+// The file is opened with O_DIRECT where the filesystem allows it so the device is measured rather
+// than the page cache. Set BLOCKREADER_BENCH_DIR to put the file on the device to test.
+
+namespace
+{
+const size_t BlockSize = 8192;
+const size_t BlocksPerRequest = 16;
+const size_t RequestSize = BlockSize * BlocksPerRequest;
+const size_t FileSize = 256UL << 20;
+
+string makeFile()
+{
+  const char* dir = getenv("BLOCKREADER_BENCH_DIR");
+  string name = string(dir ? dir : "/tmp") + "/blockreader_bench.XXXXXX";
+  vector<char> buf(1 << 20, 'x');
+  int fd = mkstemp(&name[0]);
+
+  for (size_t i = 0; fd >= 0 && i < FileSize / buf.size(); i++)
+    if (write(fd, buf.data(), buf.size()) != (ssize_t)buf.size())
+      break;
+
+  if (fd >= 0)
+  {
+    fsync(fd);
+    close(fd);
+  }
+
+  return name;
+}
+
+struct ScratchFile
+{
+  ScratchFile() : name(makeFile())
+  {
+    try
+    {
+      file.reset(new UnbufferedFile(name.c_str(), "r", IDBDataFile::USE_ODIRECT));
+    }
+    catch (std::exception&)
+    {
+      file.reset(new UnbufferedFile(name.c_str(), "r", 0));
+    }
+  }
+  ~ScratchFile()
+  {
+    file.reset();
+    unlink(name.c_str());
+  }
+
+  string name;
+  unique_ptr<IDBDataFile> file;
+};
+
+ScratchFile& scratch()
+{
+  static ScratchFile f;
+  return f;
+}
+
+vector<off64_t> makeOffsets(bool random)
+{
+  vector<off64_t> offsets(FileSize / RequestSize);
+  mt19937 gen(42);
+
+  for (size_t i = 0; i < offsets.size(); i++)
+    offsets[i] = i * RequestSize;
+
+  if (random)
+    shuffle(offsets.begin(), offsets.end(), gen);
+
+  return offsets;
+}
+
+// range(0): queue depth, range(1): 1 for random offsets, range(2): 1 for io_uring
+void BM_BlockRead(benchmark::State& state)
+{
+  const uint32_t depth = state.range(0);
+  const bool useUring = state.range(2);
+  const vector<off64_t> offsets = makeOffsets(state.range(1));
+  IDBDataFile* fp = scratch().file.get();
+  BlockReader reader(depth, useUring);
+
+  if (useUring && !reader.usingUring())
+  {
+    state.SkipWithError("io_uring is not available");
+    return;
+  }
+
+  void* mem = 0;
+
+  if (posix_memalign(&mem, 4096, depth * RequestSize))
+  {
+    state.SkipWithError("out of memory");
+    return;
+  }
+
+  unique_ptr<char, decltype(&free)> buf((char*)mem, &free);
+  vector<BlockReader::Request> reqs(depth);
+  size_t next = 0;
+
+  for (auto _ : state)
+  {
+    for (uint32_t i = 0; i < depth; i++, next = (next + 1) % offsets.size())
+    {
+      reqs[i].buf = buf.get() + i * RequestSize;
+      reqs[i].offset = offsets[next];
+      reqs[i].count = RequestSize;
+    }
+
+    reader.read(fp, reqs.data(), depth);
+
+    for (uint32_t i = 0; i < depth; i++)
+      if (reqs[i].result != (ssize_t)RequestSize)
+        state.SkipWithError("short read");
+  }
+
+  state.SetBytesProcessed(state.iterations() * depth * RequestSize);
+  state.SetItemsProcessed(state.iterations() * depth);
+}
+
+}  // namespace
+
+BENCHMARK(BM_BlockRead)
+    ->ArgNames({"depth", "random", "uring"})
+    ->ArgsProduct({{1, 4, 16, 64}, {0, 1}, {0, 1}})
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "idbcompress.h"
+#include "columnencoding.h"
 
 class CompressionTest : public ::testing::Test
 {
@@ -106,3 +107,196 @@ TEST_F(CompressionTest, LZvsSnappyUnique)
     std::cout << "Snappy ratio: " << (float)((float)generatedSize / (float)compressedSizeSnappy) << std::endl;
   }
 }
+
+TEST_F(CompressionTest, ZSTDBlockRoundTrip)
+{
+  if (!compress::CompressInterface::isCompressionAvail(4))
+    GTEST_SKIP() << "built without zstd";
+
+  std::unique_ptr<compress::CompressInterface> compressor(compress::getCompressInterfaceByType(4));
+  std::string data = "abcdefghi";
+  auto generated = genPermutations(data);
+
+  size_t compressedSize = compressor->maxCompressedSize(generated.size());
+  std::unique_ptr<unsigned char[]> compressedData(new unsigned char[compressedSize]);
+  auto rc =
+      compressor->compressBlock(generated.data(), generated.size(), compressedData.get(), compressedSize);
+  ASSERT_EQ(rc, 0);
+  EXPECT_LT(compressedSize, generated.size());
+
+  std::string result(generated.size(), '\0');
+  size_t resultSize = result.size();
+  rc = compressor->uncompressBlock((char*)compressedData.get(), compressedSize, (unsigned char*)&result[0],
+                                   resultSize);
+  ASSERT_EQ(rc, 0);
+  EXPECT_EQ(resultSize, generated.size());
+  EXPECT_EQ(generated, result);
+
+  // chunks of another algorithm are rejected by the magic number
+  std::unique_ptr<compress::CompressInterface> lz4Compressor(new compress::CompressInterfaceLZ4());
+  const int badInput = compress::CompressInterface::ERR_BADINPUT;
+  resultSize = result.size();
+  EXPECT_EQ(lz4Compressor->uncompressBlock((char*)compressedData.get(), compressedSize,
+                                           (unsigned char*)&result[0], resultSize),
+            badInput);
+}
+
+TEST_F(CompressionTest, ZSTDDictionary)
+{
+  if (!compress::CompressInterface::isCompressionAvail(4))
+    GTEST_SKIP() << "built without zstd";
+
+  std::unique_ptr<compress::CompressInterface> compressor(compress::getCompressInterfaceByType(4));
+  ASSERT_TRUE(compressor->supportsDictionary());
+
+  std::string data = "aaadefghi";
+  auto generated = genPermutations(data);
+
+  // Train on 8K samples of the data, the way cpimport does with the first chunk of a file
+  const size_t sampleLen = 8192;
+  const size_t maxDictLen = compress::CompressInterface::MAX_DICTIONARY_LEN;
+  std::vector<size_t> sampleSizes(generated.size() / sampleLen, sampleLen);
+  std::string dict(maxDictLen, '\0');
+  size_t dictLen = compressor->trainDictionary(generated.data(), sampleSizes.data(), sampleSizes.size(),
+                                               &dict[0], dict.size());
+  ASSERT_GT(dictLen, 0U);
+  ASSERT_LE(dictLen, maxDictLen);
+  dict.resize(dictLen);
+
+  size_t compressedSize = compressor->maxCompressedSize(generated.size());
+  std::unique_ptr<unsigned char[]> compressedData(new unsigned char[compressedSize]);
+  auto rc = compressor->compressBlock(generated.data(), generated.size(), compressedData.get(),
+                                      compressedSize, dict.data(), dict.size());
+  ASSERT_EQ(rc, 0);
+
+  std::string result(generated.size(), '\0');
+  size_t resultSize = result.size();
+  const int badInput = compress::CompressInterface::ERR_BADINPUT;
+  EXPECT_EQ(compressor->uncompressBlock((char*)compressedData.get(), compressedSize,
+                                        (unsigned char*)&result[0], resultSize),
+            badInput);
+
+  resultSize = result.size();
+  rc = compressor->uncompressBlock((char*)compressedData.get(), compressedSize, (unsigned char*)&result[0],
+                                   resultSize, dict.data(), dict.size());
+  ASSERT_EQ(rc, 0);
+  EXPECT_EQ(generated, result);
+
+  // The dictionary travels in the file header, headers written before have none
+  std::unique_ptr<char[]> hdrs(new char[compress::CompressInterface::HDR_BUF_LEN * 2]);
+  compress::CompressInterface::initHdr(hdrs.get(), 8, execplan::CalpontSystemCatalog::BIGINT, 4);
+  size_t hdrDictLen = 1;
+  EXPECT_EQ(compress::CompressInterface::getDictionary(hdrs.get(), hdrDictLen), nullptr);
+  EXPECT_EQ(hdrDictLen, 0U);
+
+  compress::CompressInterface::setDictionary(hdrs.get(), dict.data(), dict.size());
+  compress::CompressInterface::setBlockCount(hdrs.get(), 1024);
+  const char* hdrDict = compress::CompressInterface::getDictionary(hdrs.get(), hdrDictLen);
+  ASSERT_NE(hdrDict, nullptr);
+  EXPECT_EQ(std::string(hdrDict, hdrDictLen), dict);
+  EXPECT_EQ(compress::CompressInterface::verifyHdr(hdrs.get()), 0);
+  EXPECT_EQ(compress::CompressInterface::getBlockCount(hdrs.get()), 1024U);
+}
+
+TEST_F(CompressionTest, ColumnEncodingRoundTrip)
+{
+  // A sorted date-like column, a low cardinality one and one that doesn't encode, each with the
+  // trailing empty values of a partly filled chunk
+  const size_t n = 8192;
+  std::vector<int32_t> sorted(n), lowCard(n), random(n);
+  uint32_t x = 2463534242U;
+
+  for (size_t i = 0; i < n; i++)
+  {
+    sorted[i] = 2000000 + i * 3;
+    lowCard[i] = -1 + (i / 100) % 3;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    random[i] = (int32_t)x;
+  }
+
+  std::fill(sorted.begin() + n / 2, sorted.end(), (int32_t)0x80000001);
+  std::fill(lowCard.begin() + n / 2, lowCard.end(), (int32_t)0x80000001);
+
+  std::vector<std::pair<std::vector<int32_t>*, compress::ColumnEncoding::Type>> cases = {
+      {&sorted, compress::ColumnEncoding::DELTA},
+      {&lowCard, compress::ColumnEncoding::RLE},
+      {&random, compress::ColumnEncoding::NONE}};
+
+  for (auto& c : cases)
+  {
+    const size_t inLen = c.first->size() * sizeof(int32_t);
+    std::vector<uint64_t> encoded(compress::ColumnEncoding::maxEncodedSize(inLen) / 8 + 1);
+    size_t encodedLen = compress::ColumnEncoding::encode((const char*)c.first->data(), inLen, 4,
+                                                         (char*)encoded.data(), encoded.size() * 8);
+
+    if (c.second == compress::ColumnEncoding::NONE)
+    {
+      EXPECT_EQ(encodedLen, 0U);
+      continue;
+    }
+
+    ASSERT_GT(encodedLen, 0U);
+    EXPECT_LT(encodedLen * 4, inLen);
+    EXPECT_EQ(compress::ColumnEncoding::getType((const char*)encoded.data(), encodedLen), c.second);
+
+    std::vector<int32_t> decoded(n);
+    size_t decodedLen = inLen;
+    ASSERT_EQ(compress::ColumnEncoding::decode((const char*)encoded.data(), encodedLen, (char*)decoded.data(),
+                                               &decodedLen),
+              0);
+    EXPECT_EQ(decodedLen, inLen);
+    EXPECT_EQ(decoded, *c.first);
+  }
+
+  // Encoded chunks go through uncompressBlock() like any other
+  std::unique_ptr<compress::CompressInterface> compressor(new compress::CompressInterfaceSnappy());
+  const size_t inLen = n * sizeof(int32_t);
+  size_t compressedSize = compressor->maxCompressedSize(inLen);
+  std::unique_ptr<unsigned char[]> compressedData(new unsigned char[compressedSize]);
+  ASSERT_EQ(compressor->compressEncodedBlock((const char*)lowCard.data(), inLen, 4, compressedData.get(),
+                                             compressedSize),
+            0);
+
+  std::vector<int32_t> result(n);
+  size_t resultSize = inLen;
+  uint32_t encodedWidth = 0;
+  ASSERT_EQ(compressor->uncompressBlock((char*)compressedData.get(), compressedSize,
+                                        (unsigned char*)result.data(), resultSize, nullptr, 0, &encodedWidth),
+            0);
+  EXPECT_EQ(resultSize, inLen);
+  EXPECT_EQ(result, lowCard);
+  // the block cache keeps an encoded copy of the blocks of such a chunk
+  EXPECT_EQ(encodedWidth, 4U);
+}
+
+TEST_F(CompressionTest, ColumnEncodingFrameOfReference)
+{
+  const size_t n = 4000;
+  std::vector<int16_t> values(n);
+
+  for (size_t i = 0; i < n; i++)
+    values[i] = -300 + (i * 7919) % 600;
+
+  std::vector<uint64_t> encoded(compress::ColumnEncoding::maxEncodedSize(n * 2) / 8 + 1);
+  size_t encodedLen = compress::ColumnEncoding::encode((const char*)values.data(), n * 2, 2,
+                                                       (char*)encoded.data(), encoded.size() * 8);
+  ASSERT_GT(encodedLen, 0U);
+  ASSERT_EQ(compress::ColumnEncoding::getType((const char*)encoded.data(), encodedLen),
+            compress::ColumnEncoding::FOR);
+
+  std::vector<int16_t> decoded(n);
+  size_t decodedLen = n * 2;
+  ASSERT_EQ(compress::ColumnEncoding::decode((const char*)encoded.data(), encodedLen, (char*)decoded.data(),
+                                             &decodedLen),
+            0);
+  EXPECT_EQ(decodedLen, n * 2);
+  EXPECT_EQ(decoded, values);
+
+  // a truncated buffer is rejected
+  decodedLen = n * 2;
+  EXPECT_EQ(compress::ColumnEncoding::decode((const char*)encoded.data(), encodedLen / 2, (char*)decoded.data(),
+                                             &decodedLen),
+            -1);
+}
@@ -0,0 +1,144 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "idbcompress.h"
+
+using namespace std;
+using namespace compress;
+
+// Compression ratio and chunk decompression throughput of LZ4 against ZSTD, with and without a
+// dictionary trained the way cpimport does it, on the permutation data of compression-tests.cpp.
+// The ratio counter is uncompressed / compressed size of the whole chunk, header included.
+
+namespace
+{
+const vector<string> DataPool{"abcdefghi", "aaadefghi", "aaaaafghi", "aaaaaaahi", "aaaaaaaaj"};
+
+enum Codec
+{
+  LZ4 = 0,
+  ZSTD = 1,
+  ZSTD_DICT = 2
+};
+
+void generate(string& data, uint32_t i, string& generated)
+{
+  if (i == data.size())
+  {
+    generated.append(data);
+    return;
+  }
+
+  for (uint32_t k = i, e = data.size(); k < e; ++k)
+  {
+    swap(data[i], data[k]);
+    generate(data, i + 1, generated);
+    swap(data[i], data[k]);
+  }
+}
+
+// 9! * 9 bytes, close to a 4MB chunk
+const string& chunkData(size_t idx)
+{
+  static vector<string> chunks(DataPool.size());
+
+  if (chunks[idx].empty())
+  {
+    string data = DataPool[idx];
+    generate(data, 0, chunks[idx]);
+  }
+
+  return chunks[idx];
+}
+
+string trainDictionary(const CompressInterface& compressor, const string& data)
+{
+  const size_t sampleLen = 8192;
+  vector<size_t> sampleSizes(min<size_t>(data.size(), 1024 * 1024) / sampleLen, sampleLen);
+  string dict(CompressInterface::MAX_DICTIONARY_LEN, '\0');
+  dict.resize(
+      compressor.trainDictionary(data.data(), sampleSizes.data(), sampleSizes.size(), &dict[0], dict.size()));
+  return dict;
+}
+
+// range(0): index into DataPool, range(1): Codec
+void BM_UncompressChunk(benchmark::State& state)
+{
+  const string& data = chunkData(state.range(0));
+  const Codec codec = static_cast<Codec>(state.range(1));
+  unique_ptr<CompressInterface> compressor(getCompressInterfaceByType(codec == LZ4 ? 3 : 4));
+
+  if (!CompressInterface::isCompressionAvail(codec == LZ4 ? 3 : 4))
+  {
+    state.SkipWithError("compression type is not available");
+    return;
+  }
+
+  string dict;
+
+  if (codec == ZSTD_DICT)
+  {
+    dict = trainDictionary(*compressor, data);
+
+    if (dict.empty())
+    {
+      state.SkipWithError("dictionary training failed");
+      return;
+    }
+  }
+
+  size_t compressedLen = compressor->maxCompressedSize(data.size());
+  unique_ptr<unsigned char[]> compressed(new unsigned char[compressedLen]);
+
+  if (compressor->compressBlock(data.data(), data.size(), compressed.get(), compressedLen, dict.data(),
+                                dict.size()) != 0)
+  {
+    state.SkipWithError("compression failed");
+    return;
+  }
+
+  unique_ptr<unsigned char[]> uncompressed(new unsigned char[CompressInterface::UNCOMPRESSED_INBUF_LEN]);
+
+  for (auto _ : state)
+  {
+    size_t outLen = CompressInterface::UNCOMPRESSED_INBUF_LEN;
+
+    if (compressor->uncompressBlock((char*)compressed.get(), compressedLen, uncompressed.get(), outLen,
+                                    dict.data(), dict.size()) != 0)
+      state.SkipWithError("decompression failed");
+
+    benchmark::DoNotOptimize(uncompressed.get());
+  }
+
+  state.SetBytesProcessed(state.iterations() * data.size());
+  state.counters["ratio"] = (double)data.size() / compressedLen;
+}
+
+}  // namespace
+
+BENCHMARK(BM_UncompressChunk)
+    ->ArgNames({"data", "codec"})
+    ->ArgsProduct({{0, 1, 2, 3, 4}, {LZ4, ZSTD, ZSTD_DICT}})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
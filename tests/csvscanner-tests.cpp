@@ -0,0 +1,135 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "simd_dispatch.h"
+#include "we_csvscanner.h"
+
+using WriteEngine::CsvScanner;
+
+class CsvScannerTest : public testing::TestWithParam<uint32_t>
+{
+ protected:
+  void SetUp() override
+  {
+    simd::setSimdLevel(simd::simdLevelFromBits(GetParam()));
+  }
+  void TearDown() override
+  {
+    simd::setSimdLevel(simd::detectSimdLevel());
+  }
+
+  // Offsets of the record ends findRecordEnd() finds, going one record at a time
+  std::vector<size_t> recordEnds(const CsvScanner& scanner, const std::string& s)
+  {
+    std::vector<size_t> ends;
+    const char* end = s.data() + s.size();
+    for (const char* p = s.data(); p < end;)
+    {
+      p = scanner.findRecordEnd(p, p, end);
+      ends.push_back(p - s.data());
+    }
+    return ends;
+  }
+};
+
+TEST_P(CsvScannerTest, FindMatchesScalar)
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> byte(0, 255);
+  const CsvScanner scanner('|', '"', '\\');
+
+  for (int round = 0; round < 200; round++)
+  {
+    // Sparse structural chars, at every position relative to the vector width
+    std::string s(rng() % 300, 'x');
+    for (char& c : s)
+    {
+      int b = byte(rng);
+      if (b < 4)
+        c = "|\n\"\\"[b];
+      else if (b < 8)
+        c = b;
+    }
+
+    const char* end = s.data() + s.size();
+    for (size_t from = 0; from < s.size(); from++)
+    {
+      const char* p = s.data() + from;
+      ASSERT_EQ(scanner.findFieldEnd(p, end), CsvScanner::findScalar(p, end, '|', '\n'));
+      ASSERT_EQ(scanner.findEnclosedSpecial(p, end), CsvScanner::findScalar(p, end, '"', '\\'));
+    }
+  }
+}
+
+TEST_P(CsvScannerTest, RecordEndsNotEnclosed)
+{
+  const CsvScanner scanner('|', '\0', '\\');
+  const std::string s = "1|\"a\n2|b\"\n3|c";
+
+  // Quotes mean nothing without an enclosed by char
+  EXPECT_EQ(recordEnds(scanner, s), (std::vector<size_t>{5, 10, 13}));
+
+  // The first record that ends at or after "from"
+  const char* end = s.data() + s.size();
+  EXPECT_EQ(scanner.findRecordEnd(s.data(), s.data() + 5, end) - s.data(), 10);
+  EXPECT_EQ(scanner.findRecordEnd(s.data(), s.data() + 11, end), end);
+}
+
+TEST_P(CsvScannerTest, RecordEndsEnclosed)
+{
+  const CsvScanner scanner('|', '"', '\\');
+
+  // Newline inside an enclosed field
+  EXPECT_EQ(recordEnds(scanner, "1|\"a\nb\"\n2|c\n"), (std::vector<size_t>{8, 12}));
+  // Escaped and doubled enclosing chars don't end the field
+  EXPECT_EQ(recordEnds(scanner, "\"a\\\"\n\"\"b\"\n2\n"), (std::vector<size_t>{10, 12}));
+  // Escaped escape char before the closing one
+  EXPECT_EQ(recordEnds(scanner, "\"a\\\\\"\n2\n"), (std::vector<size_t>{6, 8}));
+  // An escaped newline stays in the field
+  EXPECT_EQ(recordEnds(scanner, "\"a\\\nb\"\n"), (std::vector<size_t>{7}));
+  // Only a field that starts with the enclosing char is enclosed
+  EXPECT_EQ(recordEnds(scanner, "a\"b\n\"c\n"), (std::vector<size_t>{4, 7}));
+  // Bytes after the closing enclosing char are skipped up to the delimiter
+  EXPECT_EQ(recordEnds(scanner, "\"a\"x\"|b\n\"c\n\"\n"), (std::vector<size_t>{8, 13}));
+  // Unterminated enclosed field
+  EXPECT_EQ(recordEnds(scanner, "1|\"a\nb\n"), (std::vector<size_t>{7}));
+
+  // Enclosed newlines are skipped when looking for the record end after "from"
+  const std::string s = "1|\"a\nb\nc\"\n2|d\n";
+  const char* end = s.data() + s.size();
+  EXPECT_EQ(scanner.findRecordEnd(s.data(), s.data() + 3, end) - s.data(), 10);
+}
+
+TEST_P(CsvScannerTest, RecordEndsLongFields)
+{
+  // Fields longer than the vector width, with the structural chars at every offset
+  const CsvScanner scanner('|', '"', '\\');
+
+  for (size_t len = 0; len < 100; len++)
+  {
+    std::string field(len, 'x');
+    std::string s = "\"" + field + "\n" + field + "\"|" + field + "\n" + field + "\n";
+    EXPECT_EQ(recordEnds(scanner, s), (std::vector<size_t>{3 * len + 5, 4 * len + 6})) << len;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Widths, CsvScannerTest, testing::Values(128u, 256u));
@@ -0,0 +1,295 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+#include "simd_dispatch.h"
+#include "we_bulkloadbuffer.h"
+#include "we_columninfo.h"
+#include "we_csvscanner.h"
+#include "we_log.h"
+
+using namespace std;
+using namespace WriteEngine;
+
+// Throughput of cpimport's tokenizer, reported as bytes_per_second.  range(0) picks the
+// input: 0 is short numeric fields, 1 is longer text fields, 2 is text with enclosed fields
+// that hold delimiters, escaped quotes and newlines, 3 is the file named by $CSV_BENCH_FILE,
+// for real world data.  range(1) is the search width: 0 for the byte at a time loop, 128
+// for SSE2 and 256 for AVX2.
+//
+// BM_FieldEnds and BM_RecordBoundaries time the CsvScanner passes alone, BM_Tokenize the
+// whole BulkLoadBuffer::tokenize() of every read buffer.  BM_Tokenize needs the Columnstore
+// config, as ColumnInfo asks BRM for the extent size.
+
+namespace
+{
+const size_t BENCH_DATA_SIZE = 64 * 1024 * 1024;
+
+string makeNumeric()
+{
+  mt19937_64 rng(42);
+  uniform_int_distribution<int64_t> dist(-1000000, 1000000);
+  string s;
+  while (s.size() < BENCH_DATA_SIZE)
+  {
+    for (int i = 0; i < 8; i++)
+      s += to_string(dist(rng)) + (i < 7 ? '|' : '\n');
+  }
+  return s;
+}
+
+string makeText(bool enclosed)
+{
+  mt19937_64 rng(42);
+  uniform_int_distribution<int> len(10, 80);
+  uniform_int_distribution<int> letter(0, 25);
+  string s;
+  while (s.size() < BENCH_DATA_SIZE)
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      string field;
+      for (int k = len(rng); k > 0; k--)
+        field += 'a' + letter(rng);
+      if (enclosed)
+      {
+        field.insert(field.size() / 3, "|\\\"");
+        field.insert(field.size() / 2, "\n");
+        field = '"' + field + '"';
+      }
+      s += field + (i < 3 ? '|' : '\n');
+    }
+  }
+  return s;
+}
+
+const string* input(int64_t which)
+{
+  static string numeric = makeNumeric();
+  static string text = makeText(false);
+  static string enclosed = makeText(true);
+  static string file;
+
+  switch (which)
+  {
+    case 0: return &numeric;
+    case 1: return &text;
+    case 2: return &enclosed;
+    default:
+    {
+      const char* name = getenv("CSV_BENCH_FILE");
+      if (!name)
+        return nullptr;
+      if (file.empty())
+      {
+        ifstream in(name, ios::binary);
+        file.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+      }
+      return file.empty() ? nullptr : &file;
+    }
+  }
+}
+
+// Number of fields of the first record; enclosed delimiters are skipped, enclosed newlines
+// in the first record are not supported
+unsigned fieldCount(const string& data, bool enclosed)
+{
+  unsigned fields = 1;
+  bool inQuotes = false;
+
+  for (size_t i = 0; i < data.size() && (inQuotes || data[i] != '\n'); i++)
+  {
+    if (enclosed && data[i] == '"')
+      inQuotes = !inQuotes;
+    else if (data[i] == '|' && !inQuotes)
+      fields++;
+  }
+
+  return fields;
+}
+
+// The columns of a table that loads every field of the input, as INT for the numeric input
+// and as VARCHAR(100) dictionary columns for the others
+void makeColumns(int64_t which, unsigned fields, Log* log, boost::ptr_vector<ColumnInfo>& columns,
+                 JobFieldRefList& fieldList)
+{
+  for (unsigned i = 0; i < fields; i++)
+  {
+    JobColumn column;
+    column.colName = "c" + to_string(i);
+    column.mapOid = 3000 + i;
+
+    if (which != 0)
+    {
+      column.dataType = execplan::CalpontSystemCatalog::VARCHAR;
+      column.weType = WR_CHAR;
+      column.typeName = "varchar";
+      column.colType = COL_TYPE_DICT;
+      column.width = 8;
+      column.definedWidth = 100;
+      column.dctnryWidth = 100;
+    }
+    else
+    {
+      column.width = 4;
+      column.definedWidth = 4;
+    }
+
+    columns.push_back(new ColumnInfo(log, i, column, nullptr, nullptr));
+    fieldList.push_back(JobFieldRef(BULK_FLDCOL_COLUMN_FIELD, i));
+  }
+}
+}  // namespace
+
+// Stops at every field delimiter and newline, like tokenize() does outside of enclosed fields
+static void BM_FieldEnds(benchmark::State& state)
+{
+  const string* data = input(state.range(0));
+  if (!data)
+  {
+    state.SkipWithError("CSV_BENCH_FILE isn't set");
+    return;
+  }
+
+  simd::setSimdLevel(simd::simdLevelFromBits(state.range(1)));
+  const CsvScanner scanner('|', '\0', '\\');
+  const char* end = data->data() + data->size();
+
+  for (auto _ : state)
+  {
+    size_t fields = 0;
+    const char* p = data->data();
+    while (true)
+    {
+      p = (state.range(1) == 0) ? CsvScanner::findScalar(p, end, '|', '\n') : scanner.findFieldEnd(p, end);
+      if (p == end)
+        break;
+      fields++;
+      p++;
+    }
+    benchmark::DoNotOptimize(fields);
+  }
+  state.SetBytesProcessed(state.iterations() * data->size());
+}
+
+// Splits the input into 1MB read buffers of whole records, as cpimport does for each buffer
+// it tokenizes in parallel
+static void BM_RecordBoundaries(benchmark::State& state)
+{
+  const string* data = input(state.range(0));
+  if (!data)
+  {
+    state.SkipWithError("CSV_BENCH_FILE isn't set");
+    return;
+  }
+
+  simd::setSimdLevel(simd::simdLevelFromBits(state.range(1)));
+  const CsvScanner scanner('|', '"', '\\');
+  const char* end = data->data() + data->size();
+
+  for (auto _ : state)
+  {
+    size_t buffers = 0;
+    for (const char* p = data->data(); p < end; buffers++)
+      p = scanner.findRecordEnd(p, p + min<size_t>(1 << 20, end - p), end);
+    benchmark::DoNotOptimize(buffers);
+  }
+  state.SetBytesProcessed(state.iterations() * data->size());
+}
+
+// Fills and tokenizes 1MB read buffers one after the other, carrying each incomplete last
+// record over to the next buffer, as a cpimport read thread does.  range(2) is the number of
+// tokenize threads (see -r): with 1 every buffer goes through tokenizeRange() in one go,
+// otherwise through tokenizeParallel().
+static void BM_Tokenize(benchmark::State& state)
+{
+  const string* data = input(state.range(0));
+  if (!data)
+  {
+    state.SkipWithError("CSV_BENCH_FILE isn't set");
+    return;
+  }
+
+  simd::setSimdLevel(simd::simdLevelFromBits(state.range(1)));
+  const bool enclosed = (state.range(0) >= 2);
+  const unsigned bufferSize = 1 << 20;
+
+  Log log;
+  boost::ptr_vector<ColumnInfo> columns;
+  JobFieldRefList fieldList;
+  makeColumns(state.range(0), fieldCount(*data, enclosed), &log, columns, fieldList);
+
+  // an empty buffer to take the overflow of before the first one
+  BulkLoadBuffer start(columns.size(), bufferSize, &log, 0, "bench", fieldList);
+  boost::ptr_vector<BulkLoadBuffer> buffers;
+
+  for (int i = 0; i < 2; i++)
+  {
+    buffers.push_back(new BulkLoadBuffer(columns.size(), bufferSize, &log, i + 1, "bench", fieldList));
+    buffers[i].setColDelimiter('|');
+    buffers[i].setTokenizeThreads(state.range(2));
+
+    if (enclosed)
+      buffers[i].setEnclosedByChar('"');
+  }
+
+  for (auto _ : state)
+  {
+    size_t parsed = 0;
+    RID totalRows = 0;
+    RID validRows = 0;
+    const BulkLoadBuffer* previous = &start;
+
+    for (unsigned i = 0; parsed < data->size(); i ^= 1)
+    {
+      int rc = buffers[i].fillFromMemory(*previous, data->data(), data->size(), &parsed, totalRows,
+                                         validRows, columns, numeric_limits<unsigned>::max());
+
+      if (rc != NO_ERROR)
+      {
+        state.SkipWithError("fillFromMemory failed");
+        return;
+      }
+
+      previous = &buffers[i];
+    }
+
+    benchmark::DoNotOptimize(validRows);
+  }
+  state.SetBytesProcessed(state.iterations() * data->size());
+}
+
+BENCHMARK(BM_FieldEnds)
+    ->ArgsProduct({{0, 1, 3}, {0, 128, 256}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RecordBoundaries)
+    ->ArgsProduct({{1, 2, 3}, {128, 256}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Tokenize)
+    ->ArgsProduct({{0, 1, 2, 3}, {128, 256}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
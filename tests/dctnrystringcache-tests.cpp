@@ -0,0 +1,103 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <map>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "../writeengine/dictionary/we_dctnrystringcache.h"
+
+using namespace std;
+using WriteEngine::DctnryStringCache;
+
+static WriteEngine::Token makeToken(uint64_t fbo, uint64_t op)
+{
+  WriteEngine::Token token;
+  token.fbo = fbo;
+  token.op = op;
+  token.bc = 0;
+  return token;
+}
+
+static bool lookup(const DctnryStringCache& cache, const string& s, WriteEngine::Token& token)
+{
+  return cache.find(reinterpret_cast<const unsigned char*>(s.data()), s.size(), token);
+}
+
+static bool add(DctnryStringCache& cache, const string& s, const WriteEngine::Token& token)
+{
+  return cache.insert(reinterpret_cast<const unsigned char*>(s.data()), s.size(), token);
+}
+
+TEST(DctnryStringCache, FindsWhatWasInserted)
+{
+  DctnryStringCache cache;
+  map<string, uint64_t> inserted;
+
+  // enough strings to grow the table a few times, including the empty string
+  for (uint64_t i = 0; i < 20000; i++)
+  {
+    const string s = (i == 0) ? string() : "value-" + to_string(i * 7919 % 100003);
+    ASSERT_TRUE(add(cache, s, makeToken(i, i % 1023 + 1)));
+    inserted[s] = i;
+  }
+
+  EXPECT_EQ(cache.size(), inserted.size());
+
+  for (const auto& kv : inserted)
+  {
+    WriteEngine::Token token;
+    ASSERT_TRUE(lookup(cache, kv.first, token)) << kv.first;
+    EXPECT_EQ(token.fbo, kv.second);
+    EXPECT_EQ(token.op, kv.second % 1023 + 1);
+  }
+
+  // same length and prefix, different bytes
+  WriteEngine::Token token;
+  EXPECT_FALSE(lookup(cache, "value-x", token));
+  EXPECT_FALSE(lookup(cache, string("value-1\0", 8), token));
+}
+
+TEST(DctnryStringCache, StaysWithinBudget)
+{
+  const size_t budget = 512 * 1024;
+  DctnryStringCache cache(budget);
+  const string padding(100, 'p');
+  size_t accepted = 0;
+
+  for (uint64_t i = 0; i < 100000; i++)
+  {
+    if (add(cache, padding + to_string(i), makeToken(i, 1)))
+      accepted++;
+
+    ASSERT_LE(cache.bytesUsed(), budget);
+  }
+
+  EXPECT_GT(accepted, 0U);
+  EXPECT_LT(accepted, 100000U);
+  EXPECT_EQ(cache.size(), accepted);
+
+  // a refused string is not half inserted
+  WriteEngine::Token token;
+  EXPECT_FALSE(lookup(cache, padding + to_string(99999), token));
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0U);
+  EXPECT_EQ(cache.bytesUsed(), 0U);
+  EXPECT_FALSE(lookup(cache, padding + "0", token));
+  EXPECT_TRUE(add(cache, padding + "0", makeToken(0, 1)));
+}
@@ -0,0 +1,318 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <boost/uuid/nil_generator.hpp>
+#include <gtest/gtest.h>
+
+#include "bpp.h"
+#include "primproc.h"
+#include "bytestream.h"
+
+using namespace std;
+using namespace primitiveprocessor;
+using messageqcpp::ByteStream;
+
+// primproc.cpp is not part of the library, these are what the commands need from it
+namespace primitiveprocessor
+{
+DebugLevel gDebugLevel;
+Logger* mlp;
+}  // namespace primitiveprocessor
+
+ServicePrimProc* ServicePrimProc::instance()
+{
+  return nullptr;
+}
+
+// Runs DictStep filters over tokens of two in-memory dictionary blocks, with the
+// per token filter cache cold and warm, and checks both against the rows the
+// filter should let through.
+
+namespace
+{
+// A NULL token, its LBID part is -1
+const uint64_t NULL_TOKEN = 0xFFFFFFFFFFFFFFFEULL;
+const uint32_t CHARSET = 8;  // latin1_swedish_ci
+const uint64_t BASE_RID = 8192;
+
+// DictStep taking its blocks from the test instead of the block cache
+class MemDictStep : public DictStep
+{
+ public:
+  explicit MemDictStep(const map<uint64_t, vector<uint8_t> >& b) : blocks(b), blockLoads(0)
+  {
+  }
+
+  const map<uint64_t, vector<uint8_t> >& blocks;
+  uint32_t blockLoads;
+
+ protected:
+  void loadDictBlock(uint64_t lbid, uint8_t* block) override
+  {
+    memcpy(block, blocks.at(lbid).data(), BLOCK_SIZE);
+    blockLoads++;
+  }
+};
+
+struct Filter
+{
+  uint8_t BOP;
+  bool hasEqFilter;
+  uint8_t eqOp;
+  vector<pair<uint8_t, string> > ops;  // COP and value
+};
+}  // namespace
+
+class DictStepTest : public ::testing::Test
+{
+ protected:
+  boost::scoped_ptr<BatchPrimitiveProcessor> bpp;
+  map<uint64_t, vector<uint8_t> > blocks;
+  map<uint64_t, string> strings;  // token -> string
+  vector<uint64_t> tokens;
+
+  void SetUp() override
+  {
+    bpp.reset(new BatchPrimitiveProcessor());
+    bpp->absRids.reset(new uint64_t[LOGICAL_BLOCK_RIDS]);
+    bpp->strValues.reset(new utils::NullString[LOGICAL_BLOCK_RIDS]);
+
+    addBlock(100, {"apple", "banana", "cherry", "blueberry", "date"});
+    addBlock(101, {"fig", "grape", "banana split", "kiwi", "lemon", "bilberry"});
+
+    // The tokens repeat and the blocks alternate, the way they come out of a token column
+    vector<uint64_t> all;
+
+    for (auto& s : strings)
+      all.push_back(s.first);
+
+    mt19937 rng(7);
+    uniform_int_distribution<size_t> pick(0, all.size() - 1);
+
+    for (uint32_t i = 0; i < 3000; i++)
+      tokens.push_back(i % 7 == 3 ? NULL_TOKEN : all[pick(rng)]);
+  }
+
+  // Dictionary block layout: the offset array starts at byte 10, offsets[0] is
+  // the end of the block and string i takes [offsets[i], offsets[i - 1]).
+  void addBlock(uint64_t lbid, const vector<string>& values)
+  {
+    vector<uint8_t>& b = blocks[lbid];
+    b.assign(BLOCK_SIZE, 0);
+    uint16_t* offsets = reinterpret_cast<uint16_t*>(&b[10]);
+    offsets[0] = BLOCK_SIZE;
+
+    for (uint32_t i = 0; i < values.size(); i++)
+    {
+      offsets[i + 1] = offsets[i] - values[i].size();
+      memcpy(&b[offsets[i + 1]], values[i].data(), values[i].size());
+      strings[(lbid << 10) | (i + 1)] = values[i];
+    }
+
+    offsets[values.size() + 1] = 0xffff;
+  }
+
+  void makeStep(MemDictStep& step, const Filter& f)
+  {
+    ByteStream bs;
+    bs << (uint8_t)Command::DICT_STEP;
+    bs << f.BOP;
+    bs << (uint8_t)0;  // compression type
+    bs << CHARSET;
+    bs << (uint32_t)f.ops.size();
+    bs << (uint8_t)f.hasEqFilter;
+
+    if (f.hasEqFilter)
+    {
+      bs << f.eqOp;
+
+      for (auto& op : f.ops)
+        bs << op.second;
+    }
+    else
+    {
+      ByteStream filterString;
+
+      for (auto& op : f.ops)
+      {
+        filterString << op.first;
+        filterString << (uint16_t)op.second.size();
+        filterString.append((const uint8_t*)op.second.data(), op.second.size());
+      }
+
+      bs << filterString;
+    }
+
+    bs << (uint32_t)3001;  // OID
+    bs << (uint32_t)1;     // tuple key
+    bs << boost::uuids::nil_uuid();
+    bs << boost::uuids::nil_uuid();
+
+    step.createCommand(bs);
+    step.setBatchPrimitiveProcessor(bpp.get());
+    step.prep(OT_RID, false);
+  }
+
+  // The rids that come out of the step, in order
+  vector<uint64_t> run(MemDictStep& step, const vector<uint64_t>& in)
+  {
+    bpp->baseRid = BASE_RID;
+    bpp->ridCount = in.size();
+
+    for (uint32_t i = 0; i < in.size(); i++)
+    {
+      bpp->absRids[i] = BASE_RID + i;
+      bpp->relRids[i] = i;
+      bpp->values[i] = in[i];
+    }
+
+    step.execute();
+
+    vector<uint64_t> out(&bpp->absRids[0], &bpp->absRids[bpp->ridCount]);
+
+    for (uint32_t i = 0; i < bpp->ridCount; i++)
+      EXPECT_EQ(bpp->relRids[i], bpp->absRids[i] - BASE_RID);
+
+    return out;
+  }
+
+  vector<uint64_t> expected(const vector<uint64_t>& in, const function<bool(const string&)>& pred)
+  {
+    vector<uint64_t> out;
+
+    for (uint32_t i = 0; i < in.size(); i++)
+      if (in[i] != NULL_TOKEN && pred(strings.at(in[i])))
+        out.push_back(BASE_RID + i);
+
+    return out;
+  }
+
+  // Cold, then warm on the same step: same rows in the same order, and the warm
+  // run does not need to read a block
+  void checkColdWarm(const Filter& f, const function<bool(const string&)>& pred)
+  {
+    MemDictStep step(blocks);
+    makeStep(step, f);
+    vector<uint64_t> want = expected(tokens, pred);
+    ASSERT_FALSE(want.empty());
+    ASSERT_LT(want.size(), tokens.size() - count(tokens.begin(), tokens.end(), NULL_TOKEN));
+
+    vector<uint64_t> cold = run(step, tokens);
+    EXPECT_EQ(cold, want);
+    EXPECT_GT(step.blockLoads, 0U);
+
+    uint32_t coldLoads = step.blockLoads;
+    vector<uint64_t> warm = run(step, tokens);
+    EXPECT_EQ(warm, want);
+    EXPECT_EQ(step.blockLoads, coldLoads);
+
+    // a different order of the same tokens, all of them cached
+    vector<uint64_t> reversed(tokens.rbegin(), tokens.rend());
+    EXPECT_EQ(run(step, reversed), expected(reversed, pred));
+    EXPECT_EQ(step.blockLoads, coldLoads);
+  }
+};
+
+TEST_F(DictStepTest, EqColdWarm)
+{
+  Filter f{BOP_AND, false, 0, {{COMPARE_EQ, "banana"}}};
+  checkColdWarm(f, [](const string& s) { return s == "banana"; });
+}
+
+TEST_F(DictStepTest, NeColdWarm)
+{
+  Filter f{BOP_AND, false, 0, {{COMPARE_NE, "banana"}}};
+  checkColdWarm(f, [](const string& s) { return s != "banana"; });
+}
+
+TEST_F(DictStepTest, LikeColdWarm)
+{
+  Filter f{BOP_AND, false, 0, {{COMPARE_LIKE, "b%rry"}}};
+  checkColdWarm(f, [](const string& s) { return s == "blueberry" || s == "bilberry"; });
+}
+
+TEST_F(DictStepTest, OrColdWarm)
+{
+  Filter f{BOP_OR, false, 0, {{COMPARE_EQ, "fig"}, {COMPARE_LIKE, "%an%"}}};
+  checkColdWarm(f, [](const string& s) { return s == "fig" || s.find("an") != string::npos; });
+}
+
+TEST_F(DictStepTest, InColdWarm)
+{
+  Filter f{BOP_OR, true, COMPARE_EQ, {{COMPARE_EQ, "apple"}, {COMPARE_EQ, "kiwi"}, {COMPARE_EQ, "date"}}};
+  checkColdWarm(f, [](const string& s) { return s == "apple" || s == "kiwi" || s == "date"; });
+}
+
+TEST_F(DictStepTest, NotInColdWarm)
+{
+  Filter f{BOP_AND, true, COMPARE_NE, {{COMPARE_EQ, "apple"}}};
+  checkColdWarm(f, [](const string& s) { return s != "apple"; });
+}
+
+// NULL tokens never pass a filter and never go into the cache
+TEST_F(DictStepTest, NullTokens)
+{
+  MemDictStep step(blocks);
+  makeStep(step, Filter{BOP_AND, false, 0, {{COMPARE_NE, "banana"}}});
+
+  vector<uint64_t> nulls(100, NULL_TOKEN);
+  EXPECT_TRUE(run(step, nulls).empty());
+  EXPECT_TRUE(run(step, nulls).empty());
+  EXPECT_EQ(step.blockLoads, 0U);
+
+  vector<uint64_t> mixed{NULL_TOKEN, (100 << 10) | 1, NULL_TOKEN, (100 << 10) | 1, NULL_TOKEN};
+  vector<uint64_t> want{BASE_RID + 1, BASE_RID + 3};
+  EXPECT_EQ(run(step, mixed), want);
+  EXPECT_EQ(run(step, mixed), want);
+  EXPECT_EQ(step.blockLoads, 1U);
+}
+
+// Each DictStep, and so each query, starts with an empty cache
+TEST_F(DictStepTest, NoStaleEntries)
+{
+  auto isBanana = [](const string& s) { return s == "banana"; };
+  auto isCherry = [](const string& s) { return s == "cherry"; };
+
+  MemDictStep first(blocks);
+  makeStep(first, Filter{BOP_AND, false, 0, {{COMPARE_EQ, "banana"}}});
+  EXPECT_EQ(run(first, tokens), expected(tokens, isBanana));
+  EXPECT_EQ(run(first, tokens), expected(tokens, isBanana));
+
+  // another filter on the same BPP and the same tokens
+  MemDictStep second(blocks);
+  makeStep(second, Filter{BOP_AND, false, 0, {{COMPARE_EQ, "cherry"}}});
+  EXPECT_EQ(run(second, tokens), expected(tokens, isCherry));
+  EXPECT_GT(second.blockLoads, 0U);
+
+  // a later query sees other strings behind the same tokens
+  blocks.clear();
+  strings.clear();
+  addBlock(100, {"cherry", "banana", "apple", "cherry", "date"});
+  addBlock(101, {"fig", "banana", "cherry", "kiwi", "lemon", "bilberry"});
+
+  MemDictStep third(blocks);
+  makeStep(third, Filter{BOP_AND, false, 0, {{COMPARE_EQ, "banana"}}});
+  EXPECT_EQ(run(third, tokens), expected(tokens, isBanana));
+  EXPECT_EQ(run(third, tokens), expected(tokens, isBanana));
+}
@@ -0,0 +1,522 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "bytestream.h"
+#include "collation.h"
+#include "primitivemsg.h"
+#include "extentmap.h"
+#include "extentbloom.h"
+#include "lbidlist.h"
+
+using namespace std;
+using namespace BRM;
+using messageqcpp::ByteStream;
+using execplan::CalpontSystemCatalog;
+
+// The per extent bloom filters: hashing, folding, merging, serialization, when
+// a filter is current for an extent, and extent elimination with them in
+// LBIDList::CasualPartitionPredicate.
+
+namespace
+{
+const uint32_t CHARSET = 8;  // latin1_swedish_ci
+
+const struct charset_info_st* charset()
+{
+  return &datatypes::Charset(CHARSET).getCharset();
+}
+
+uint64_t hashInt(int64_t v)
+{
+  return ExtentBloom::hash(&v, sizeof(v));
+}
+
+uint64_t hashStr(const string& s)
+{
+  return ExtentBloom::hash(charset(), s.data(), s.size());
+}
+
+// Multiples of 10 in [0, 1000]
+ExtentBloom tens(uint32_t bits)
+{
+  ExtentBloom bloom(bits);
+
+  for (int64_t v = 0; v <= 1000; v += 10)
+    bloom.add(hashInt(v));
+
+  return bloom;
+}
+
+struct Op
+{
+  uint8_t cop;
+  int64_t value;
+};
+
+// Filter string of a column command: COP, rounding flag and the value at the column width
+ByteStream filterString(const vector<Op>& ops)
+{
+  ByteStream bs;
+
+  for (const Op& op : ops)
+  {
+    bs << op.cop;
+    bs << (uint8_t)0;
+    bs << (uint64_t)op.value;
+  }
+
+  return bs;
+}
+
+int64_t prefix(const string& s)
+{
+  int64_t v = 0;
+  memcpy(&v, s.data(), min<size_t>(s.size(), sizeof(v)));
+  return v;
+}
+}  // namespace
+
+TEST(ExtentBloom, HashIsStable)
+{
+  EXPECT_EQ(hashInt(42), hashInt(42));
+  EXPECT_NE(hashInt(42), hashInt(43));
+  EXPECT_EQ(hashStr("banana"), hashStr("banana"));
+  EXPECT_NE(hashStr("banana"), hashStr("bananas"));
+}
+
+// Strings the collation finds equal hash the same, whatever their padding
+TEST(ExtentBloom, StringHashFollowsCollation)
+{
+  EXPECT_EQ(hashStr("Banana"), hashStr("banana"));
+  EXPECT_EQ(hashStr("banana "), hashStr("banana"));
+
+  char padded[16] = "banana";
+  EXPECT_EQ(ExtentBloom::hash(charset(), padded, sizeof(padded)), hashStr("banana"));
+}
+
+TEST(ExtentBloom, Supported)
+{
+  EXPECT_TRUE(ExtentBloom::supported(CalpontSystemCatalog::BIGINT, 8, false));
+  EXPECT_TRUE(ExtentBloom::supported(CalpontSystemCatalog::DECIMAL, 16, false));
+  EXPECT_TRUE(ExtentBloom::supported(CalpontSystemCatalog::CHAR, 4, false));
+  EXPECT_FALSE(ExtentBloom::supported(CalpontSystemCatalog::DOUBLE, 8, false));
+  EXPECT_FALSE(ExtentBloom::supported(CalpontSystemCatalog::TEXT, 8, false));
+  EXPECT_TRUE(ExtentBloom::supported(CalpontSystemCatalog::VARCHAR, 8, true));
+  EXPECT_TRUE(ExtentBloom::supported(CalpontSystemCatalog::TEXT, 8, true));
+  EXPECT_FALSE(ExtentBloom::supported(CalpontSystemCatalog::VARBINARY, 8, true));
+  EXPECT_FALSE(ExtentBloom::supported(CalpontSystemCatalog::BLOB, 8, true));
+}
+
+TEST(ExtentBloom, NoFalseNegatives)
+{
+  ExtentBloom bloom = tens(1 << 16);
+
+  for (int64_t v = 0; v <= 1000; v += 10)
+    EXPECT_TRUE(bloom.mayContain(hashInt(v)));
+
+  uint32_t falsePositives = 0;
+
+  for (int64_t v = 5; v <= 1000; v += 10)
+    falsePositives += bloom.mayContain(hashInt(v));
+
+  EXPECT_LT(falsePositives, 3U);
+}
+
+// An empty filter is no filter, it can't rule anything out
+TEST(ExtentBloom, EmptyMayContainAll)
+{
+  ExtentBloom none;
+  EXPECT_TRUE(none.empty());
+  EXPECT_TRUE(none.mayContain(hashInt(1)));
+}
+
+TEST(ExtentBloom, SizeIsPowerOf2)
+{
+  EXPECT_EQ(ExtentBloom(1).bits(), (uint32_t)ExtentBloom::minBits);
+  EXPECT_EQ(ExtentBloom(1000).bits(), 1024U);
+  EXPECT_EQ(ExtentBloom(1024).bits(), 1024U);
+}
+
+// Folding keeps every value, and stops before the filter gets too full
+TEST(ExtentBloom, ShrinkKeepsValues)
+{
+  ExtentBloom bloom = tens(1 << 20);
+  double fill = bloom.fill();
+  bloom.shrink(0.4);
+
+  EXPECT_LT(bloom.bits(), 1U << 20);
+  EXPECT_GE(bloom.bits(), (uint32_t)ExtentBloom::minBits);
+  EXPECT_GT(bloom.fill(), fill);
+  EXPECT_LE(bloom.fill(), 0.4);
+
+  for (int64_t v = 0; v <= 1000; v += 10)
+    EXPECT_TRUE(bloom.mayContain(hashInt(v)));
+
+  // Too full to fold at all
+  ExtentBloom full(ExtentBloom::minBits * 2);
+
+  for (int64_t v = 0; v < 10000; v++)
+    full.add(hashInt(v));
+
+  full.shrink(0.4);
+  EXPECT_EQ(full.bits(), ExtentBloom::minBits * 2);
+}
+
+// Merging filters of different sizes folds the larger one down, neither loses a value
+TEST(ExtentBloom, MergeKeepsBoth)
+{
+  ExtentBloom small(4096), large(1 << 16);
+
+  for (int64_t v = 0; v < 100; v++)
+    small.add(hashInt(v));
+
+  for (int64_t v = 1000; v < 1100; v++)
+    large.add(hashInt(v));
+
+  ExtentBloom a = small;
+  a.merge(large);
+  EXPECT_EQ(a.bits(), 4096U);
+
+  ExtentBloom b = large;
+  b.merge(small);
+  EXPECT_EQ(b.bits(), 4096U);
+
+  for (int64_t v = 0; v < 100; v++)
+  {
+    EXPECT_TRUE(a.mayContain(hashInt(v)));
+    EXPECT_TRUE(b.mayContain(hashInt(v)));
+    EXPECT_TRUE(a.mayContain(hashInt(v + 1000)));
+    EXPECT_TRUE(b.mayContain(hashInt(v + 1000)));
+  }
+
+  // Into an empty filter, the other one is copied as is
+  ExtentBloom none;
+  none.merge(large);
+  EXPECT_EQ(none.bits(), large.bits());
+  EXPECT_TRUE(none.mayContain(hashInt(1050)));
+}
+
+TEST(ExtentBloom, SerializeRoundTrip)
+{
+  ExtentBloom bloom = tens(8192), back;
+  ByteStream bs;
+  bloom.serialize(bs);
+  back.deserialize(bs);
+
+  EXPECT_EQ(bs.length(), 0U);
+  EXPECT_EQ(back.bits(), bloom.bits());
+  EXPECT_EQ(back.fill(), bloom.fill());
+
+  for (int64_t v = 0; v <= 1000; v++)
+    EXPECT_EQ(back.mayContain(hashInt(v)), bloom.mayContain(hashInt(v)));
+
+  // an empty filter stays empty
+  ExtentBloom none, noneBack = tens(512);
+  none.serialize(bs);
+  noneBack.deserialize(bs);
+  EXPECT_TRUE(noneBack.empty());
+}
+
+TEST(ExtentBloom, DeserializeTruncated)
+{
+  ByteStream bs;
+  tens(8192).serialize(bs);
+
+  ByteStream truncated;
+  truncated.load(bs.buf(), bs.length() / 2);
+
+  ExtentBloom back;
+  EXPECT_THROW(back.deserialize(truncated), std::exception);
+}
+
+TEST(ExtentBloomEntry, SerializeRoundTrip)
+{
+  ExtentBloomEntry entry, back;
+  entry.oid = 3001;
+  entry.startLbid = 0x123456789LL;
+  entry.partitionNum = 7;
+  entry.segmentNum = 2;
+  entry.lastBlock = 4095;
+  entry.full = true;
+  entry.seqNum = 12;
+  entry.cpValid = true;
+  entry.bloom = tens(4096);
+
+  ByteStream bs;
+  bs << entry;
+  bs >> back;
+
+  EXPECT_EQ(back.oid, entry.oid);
+  EXPECT_EQ(back.startLbid, entry.startLbid);
+  EXPECT_EQ(back.partitionNum, entry.partitionNum);
+  EXPECT_EQ(back.segmentNum, entry.segmentNum);
+  EXPECT_EQ(back.lastBlock, entry.lastBlock);
+  EXPECT_EQ(back.full, entry.full);
+  EXPECT_EQ(back.seqNum, entry.seqNum);
+  EXPECT_EQ(back.cpValid, entry.cpValid);
+  EXPECT_EQ(back.bloom.bits(), entry.bloom.bits());
+  EXPECT_TRUE(back.bloom.mayContain(hashInt(500)));
+}
+
+TEST(ExtentBloomColumn, SerializeRoundTrip)
+{
+  ExtentBloomColumn column, back;
+  column.generation = 0xabcdef01;
+
+  for (LBID_t lbid = 0; lbid < 4 * 8192; lbid += 8192)
+  {
+    ExtentBloomEntry& entry = column.entries[lbid];
+    entry.oid = 3001;
+    entry.startLbid = lbid;
+    entry.partitionNum = lbid / 8192;
+    entry.seqNum = 1;
+    entry.bloom = ExtentBloom(1024);
+    entry.bloom.add(hashInt(lbid));
+  }
+
+  back.entries[99].oid = 1;  // replaced, not added to
+  ByteStream bs;
+  column.serialize(bs);
+  back.deserialize(bs);
+
+  EXPECT_EQ(back.generation, column.generation);
+  ASSERT_EQ(back.entries.size(), column.entries.size());
+
+  for (const auto& it : column.entries)
+  {
+    ASSERT_EQ(back.entries.count(it.first), 1U);
+    const ExtentBloomEntry& entry = back.entries[it.first];
+    EXPECT_EQ(entry.startLbid, it.first);
+    EXPECT_EQ(entry.partitionNum, it.second.partitionNum);
+    EXPECT_TRUE(entry.bloom.mayContain(hashInt(it.first)));
+  }
+}
+
+class ExtentBloomDescribes : public ::testing::Test
+{
+ protected:
+  ExtentBloomEntry entry;
+  EMEntry extent;
+
+  void SetUp() override
+  {
+    entry.oid = 3001;
+    entry.startLbid = 8192;
+    entry.partitionNum = 1;
+    entry.segmentNum = 2;
+    entry.seqNum = 5;
+    entry.cpValid = true;
+    entry.bloom = tens(1024);
+
+    extent.range.start = 8192;
+    extent.partitionNum = 1;
+    extent.segmentNum = 2;
+    extent.partition.cprange.sequenceNum = 5;
+    extent.partition.cprange.isValid = CP_VALID;
+  }
+};
+
+TEST_F(ExtentBloomDescribes, SameSeqNum)
+{
+  EXPECT_TRUE(entry.describes(extent));
+
+  extent.partition.cprange.isValid = CP_INVALID;
+  EXPECT_FALSE(entry.describes(extent));
+
+  entry.cpValid = false;
+  EXPECT_TRUE(entry.describes(extent));
+
+  extent.partition.cprange.isValid = CP_UPDATING;
+  EXPECT_FALSE(entry.describes(extent));
+}
+
+// DML moves the sequence number on
+TEST_F(ExtentBloomDescribes, ChangedSinceStamped)
+{
+  extent.partition.cprange.sequenceNum = 6;
+  EXPECT_FALSE(entry.describes(extent));
+
+  extent.partition.cprange.isValid = CP_UPDATING;
+  EXPECT_FALSE(entry.describes(extent));
+
+  extent.partition.cprange.sequenceNum = 7;
+  extent.partition.cprange.isValid = CP_INVALID;
+  EXPECT_FALSE(entry.describes(extent));
+}
+
+// A scan setting the min/max of an invalid extent takes it to the next
+// sequence number without changing its rows
+TEST_F(ExtentBloomDescribes, ScanSetRange)
+{
+  entry.cpValid = false;
+  extent.partition.cprange.sequenceNum = 6;
+  EXPECT_TRUE(entry.describes(extent));
+
+  extent.partition.cprange.isValid = CP_INVALID;
+  EXPECT_FALSE(entry.describes(extent));
+
+  extent.partition.cprange.isValid = CP_VALID;
+  extent.partition.cprange.sequenceNum = 7;
+  EXPECT_FALSE(entry.describes(extent));
+
+  // the sequence number wraps around
+  entry.seqNum = EM_MAX_SEQNUM;
+  extent.partition.cprange.sequenceNum = 0;
+  EXPECT_TRUE(entry.describes(extent));
+}
+
+TEST_F(ExtentBloomDescribes, OtherExtent)
+{
+  extent.partitionNum = 0;
+  EXPECT_FALSE(entry.describes(extent));
+
+  extent.partitionNum = 1;
+  extent.segmentNum = 0;
+  EXPECT_FALSE(entry.describes(extent));
+
+  extent.segmentNum = 2;
+  entry.bloom = ExtentBloom();
+  EXPECT_FALSE(entry.describes(extent));
+}
+
+// An extent whose min/max range [0, 1000] keeps the value can still be
+// eliminated by its bloom filter, which only has the multiples of 10
+class CasualPartitionBloom : public ::testing::Test
+{
+ protected:
+  joblist::LBIDList lbidList{0};
+  EMCasualPartition_t cpRange;
+  CalpontSystemCatalog::ColType ct;
+  ExtentBloom bloom;
+
+  void SetUp() override
+  {
+    cpRange.isValid = CP_VALID;
+    cpRange.sequenceNum = 1;
+    cpRange.loVal = 0;
+    cpRange.hiVal = 1000;
+    ct.colDataType = CalpontSystemCatalog::BIGINT;
+    ct.colWidth = 8;
+    bloom = tens(1 << 16);
+  }
+
+  bool scan(const vector<Op>& ops, uint8_t BOP, const ExtentBloom* b)
+  {
+    ByteStream bs = filterString(ops);
+    return lbidList.CasualPartitionPredicate(cpRange, &bs, ops.size(), ct, BOP, false, b);
+  }
+};
+
+TEST_F(CasualPartitionBloom, Eq)
+{
+  EXPECT_TRUE(scan({{COMPARE_EQ, 505}}, BOP_AND, NULL));
+  EXPECT_FALSE(scan({{COMPARE_EQ, 505}}, BOP_AND, &bloom));
+  EXPECT_TRUE(scan({{COMPARE_EQ, 500}}, BOP_AND, &bloom));
+
+  // out of the range, eliminated without the filter
+  EXPECT_FALSE(scan({{COMPARE_EQ, 5000}}, BOP_AND, NULL));
+}
+
+TEST_F(CasualPartitionBloom, In)
+{
+  EXPECT_TRUE(scan({{COMPARE_EQ, 505}, {COMPARE_EQ, 707}}, BOP_OR, NULL));
+  EXPECT_FALSE(scan({{COMPARE_EQ, 505}, {COMPARE_EQ, 707}}, BOP_OR, &bloom));
+  EXPECT_TRUE(scan({{COMPARE_EQ, 505}, {COMPARE_EQ, 700}}, BOP_OR, &bloom));
+  EXPECT_TRUE(scan({{COMPARE_EQ, 700}, {COMPARE_EQ, 505}}, BOP_OR, &bloom));
+}
+
+// The filter only knows about equality
+TEST_F(CasualPartitionBloom, OtherOps)
+{
+  EXPECT_TRUE(scan({{COMPARE_NE, 505}}, BOP_AND, &bloom));
+  EXPECT_TRUE(scan({{COMPARE_GE, 505}, {COMPARE_LE, 509}}, BOP_AND, &bloom));
+  EXPECT_TRUE(scan({{COMPARE_EQ, 505}, {COMPARE_GT, 900}}, BOP_OR, &bloom));
+  EXPECT_FALSE(scan({{COMPARE_EQ, 505}, {COMPARE_GT, 900}}, BOP_AND, &bloom));
+}
+
+// A token column's filters carry 8 byte prefixes, its extents' filters are
+// checked with the hashes of the whole strings
+class CasualPartitionDictBloom : public ::testing::Test
+{
+ protected:
+  joblist::LBIDList lbidList{0};
+  EMCasualPartition_t cpRange;
+  CalpontSystemCatalog::ColType ct;
+  ExtentBloom bloom{1 << 16};
+
+  void SetUp() override
+  {
+    // cpimport leaves the range of token extents invalid
+    cpRange.isValid = CP_INVALID;
+    cpRange.sequenceNum = 0;
+    cpRange.loVal = 0;
+    cpRange.hiVal = 0;
+    ct.colDataType = CalpontSystemCatalog::VARCHAR;
+    ct.colWidth = 8;
+    ct.charsetNumber = CHARSET;
+
+    for (const char* s : {"apple", "banana", "customer#000001", "customer#000002"})
+      bloom.add(hashStr(s));
+  }
+
+  bool scan(uint8_t cop, const vector<string>& values, uint8_t BOP, const ExtentBloom* b, bool withHashes = true)
+  {
+    vector<Op> ops;
+    vector<uint64_t> hashes;
+
+    for (const string& v : values)
+    {
+      ops.push_back({cop, prefix(v)});
+      hashes.push_back(cop == COMPARE_EQ ? hashStr(v) : 0);
+    }
+
+    ByteStream bs = filterString(ops);
+    return lbidList.CasualPartitionPredicate(cpRange, &bs, ops.size(), ct, BOP, true, b,
+                                             withHashes ? &hashes : NULL);
+  }
+};
+
+TEST_F(CasualPartitionDictBloom, Eq)
+{
+  EXPECT_FALSE(scan(COMPARE_EQ, {"cherry"}, BOP_AND, &bloom));
+  EXPECT_TRUE(scan(COMPARE_EQ, {"banana"}, BOP_AND, &bloom));
+  EXPECT_TRUE(scan(COMPARE_EQ, {"Banana"}, BOP_AND, &bloom));
+  EXPECT_TRUE(scan(COMPARE_EQ, {"cherry"}, BOP_AND, &bloom, false));
+
+  // same prefix as values in the extent
+  EXPECT_FALSE(scan(COMPARE_EQ, {"customer#000003"}, BOP_AND, &bloom));
+  EXPECT_TRUE(scan(COMPARE_EQ, {"customer#000002"}, BOP_AND, &bloom));
+}
+
+TEST_F(CasualPartitionDictBloom, In)
+{
+  EXPECT_FALSE(scan(COMPARE_EQ, {"cherry", "date"}, BOP_OR, &bloom));
+  EXPECT_TRUE(scan(COMPARE_EQ, {"cherry", "apple"}, BOP_OR, &bloom));
+}
+
+// Without a valid range, nothing but an equality filter can eliminate the extent
+TEST_F(CasualPartitionDictBloom, OtherOps)
+{
+  EXPECT_TRUE(scan(COMPARE_NE, {"cherry"}, BOP_AND, &bloom));
+  EXPECT_TRUE(scan(COMPARE_GE, {"zzz"}, BOP_AND, &bloom));
+  EXPECT_TRUE(scan(COMPARE_EQ, {"cherry"}, BOP_AND, NULL));
+}
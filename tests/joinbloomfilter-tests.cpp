@@ -0,0 +1,110 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <limits>
+#include <gtest/gtest.h>
+
+#include "bytestream.h"
+#include "joinbloomfilter.h"
+
+using joiner::JoinBloomFilter;
+
+TEST(JoinBloomFilter, EmptyRejectsEverything)
+{
+  JoinBloomFilter f(0, false);
+  EXPECT_TRUE(f.empty());
+  EXPECT_FALSE(f.mayContain(0));
+  EXPECT_FALSE(f.mayContain(std::numeric_limits<int64_t>::min()));
+}
+
+TEST(JoinBloomFilter, NoFalseNegatives)
+{
+  const int64_t n = 100000;
+  JoinBloomFilter f(n, false);
+
+  for (int64_t i = 0; i < n; i++)
+    f.insert(i * 1000003 - 50000000000LL);
+
+  for (int64_t i = 0; i < n; i++)
+    EXPECT_TRUE(f.mayContain(i * 1000003 - 50000000000LL));
+
+  EXPECT_EQ(f.getMin(), -50000000000LL);
+  EXPECT_EQ(f.getMax(), (n - 1) * 1000003 - 50000000000LL);
+}
+
+TEST(JoinBloomFilter, FalsePositiveRate)
+{
+  const int64_t n = 100000;
+  JoinBloomFilter f(n, false);
+
+  // even keys in, odd keys out, all inside the min/max range
+  for (int64_t i = 0; i < n; i++)
+    f.insert(i * 2);
+
+  int64_t falsePositives = 0;
+
+  for (int64_t i = 0; i < n - 1; i++)
+    falsePositives += f.mayContain(i * 2 + 1);
+
+  EXPECT_LT(falsePositives, n / 50);
+}
+
+TEST(JoinBloomFilter, RangeFollowsSignedness)
+{
+  JoinBloomFilter s(4, false);
+  s.insert(-1);
+  s.insert(10);
+  EXPECT_TRUE(s.mayContain(-1));
+  EXPECT_FALSE(s.mayContain(-2));
+  EXPECT_FALSE(s.mayContain(11));
+
+  // -1 is the largest unsigned value, 10 is the smallest
+  JoinBloomFilter u(4, true);
+  u.insert(-1);
+  u.insert(10);
+  EXPECT_EQ(u.getMin(), 10);
+  EXPECT_EQ(u.getMax(), -1);
+  EXPECT_TRUE(u.mayContain(-1));
+  EXPECT_FALSE(u.mayContain(9));
+}
+
+TEST(JoinBloomFilter, Serialization)
+{
+  const int64_t n = 5000;
+  JoinBloomFilter f(n, true);
+
+  for (int64_t i = 0; i < n; i++)
+    f.insert(i * 3);
+
+  messageqcpp::ByteStream bs;
+  f.serialize(bs);
+  bs << (uint32_t)0xdeadbeef;
+
+  JoinBloomFilter g;
+  g.deserialize(bs);
+  uint32_t trailer;
+  bs >> trailer;
+  EXPECT_EQ(trailer, 0xdeadbeef);
+
+  EXPECT_EQ(g.isUnsigned(), f.isUnsigned());
+  EXPECT_EQ(g.getMin(), f.getMin());
+  EXPECT_EQ(g.getMax(), f.getMax());
+  EXPECT_EQ(g.sizeInBytes(), f.sizeInBytes());
+
+  for (int64_t i = 0; i < 3 * n; i++)
+    EXPECT_EQ(g.mayContain(i), f.mayContain(i));
+}
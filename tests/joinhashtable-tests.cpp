@@ -0,0 +1,138 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <gtest/gtest.h>
+
+#include "joinhashtable.h"
+
+using namespace std;
+
+// Maps every key to a handful of hash values to force long probe sequences.
+struct CollidingHash
+{
+  size_t operator()(int64_t k) const
+  {
+    return k % 3;
+  }
+};
+
+using Table = joiner::JoinHashTable<int64_t, int64_t, std::hash<int64_t>, std::equal_to<int64_t>>;
+using CollidingTable = joiner::JoinHashTable<int64_t, int64_t, CollidingHash, std::equal_to<int64_t>>;
+
+template <typename T>
+static vector<int64_t> valuesOf(const T& t, int64_t key)
+{
+  auto range = t.equal_range(key);
+  return vector<int64_t>(range.first, range.second);
+}
+
+TEST(JoinHashTable, Empty)
+{
+  Table t;
+  EXPECT_EQ(t.size(), 0U);
+  EXPECT_TRUE(t.empty());
+  auto range = t.equal_range(42);
+  EXPECT_EQ(range.first, range.second);
+  EXPECT_TRUE(t.begin() == t.end());
+}
+
+TEST(JoinHashTable, UniqueKeys)
+{
+  Table t;
+  const int64_t n = 100000;
+  for (int64_t i = 0; i < n; ++i)
+    t.insert(i * 7, i);
+
+  EXPECT_EQ(t.size(), (size_t)n);
+  EXPECT_EQ(t.keyCount(), (size_t)n);
+  for (int64_t i = 0; i < n; ++i)
+    ASSERT_EQ(valuesOf(t, i * 7), vector<int64_t>{i});
+
+  EXPECT_TRUE(valuesOf(t, 1).empty());
+  EXPECT_TRUE(valuesOf(t, -7).empty());
+}
+
+TEST(JoinHashTable, DuplicatesAreContiguous)
+{
+  Table t;
+  map<int64_t, vector<int64_t>> expected;
+  // Interleave the keys so the runs of different keys get relocated in between each other.
+  for (int64_t i = 0; i < 5000; ++i)
+  {
+    int64_t key = i % 37;
+    t.insert(key, i);
+    expected[key].push_back(i);
+  }
+  t.insert(1000, -1);
+  expected[1000].push_back(-1);
+
+  EXPECT_EQ(t.size(), 5001U);
+  EXPECT_EQ(t.keyCount(), 38U);
+  for (auto& e : expected)
+    EXPECT_EQ(valuesOf(t, e.first), e.second);
+}
+
+TEST(JoinHashTable, CollidingHashes)
+{
+  CollidingTable t;
+  for (int64_t i = 0; i < 1000; ++i)
+  {
+    t.insert(i, i);
+    t.insert(i, -i);
+  }
+
+  for (int64_t i = 0; i < 1000; ++i)
+    ASSERT_EQ(valuesOf(t, i), (vector<int64_t>{i, -i}));
+  EXPECT_TRUE(valuesOf(t, 1000).empty());
+}
+
+TEST(JoinHashTable, IterationVisitsEveryValue)
+{
+  Table t;
+  vector<int64_t> inserted;
+  for (int64_t i = 0; i < 3000; ++i)
+  {
+    t.insert(i % 1000, i);
+    inserted.push_back(i);
+  }
+
+  vector<int64_t> visited;
+  for (auto it = t.begin(); it != t.end(); ++it)
+    visited.push_back(*it);
+
+  sort(visited.begin(), visited.end());
+  EXPECT_EQ(visited, inserted);
+}
+
+TEST(JoinHashTable, InsertWithPrecomputedHash)
+{
+  Table t;
+  for (int64_t i = 0; i < 1000; ++i)
+    t.insert(make_pair(i, i + 1));
+  for (int64_t i = 0; i < 1000; ++i)
+  {
+    size_t h = t.hash(i);
+    t.prefetch(h);
+    auto range = t.equal_range(i, h);
+    ASSERT_EQ(range.second - range.first, 1);
+    EXPECT_EQ(*range.first, i + 1);
+  }
+  EXPECT_GE(t.getMemUsage(), 1000 * (sizeof(int64_t) * 2));
+}
@@ -0,0 +1,158 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <tr1/unordered_map>
+#include <benchmark/benchmark.h>
+
+#include "hasher.h"
+#include "joinhashtable.h"
+
+using namespace std;
+
+// Build and probe cost of the UM join hash table on int64 keys. The old table is the node
+// based tr1 multimap TupleJoiner used before. range(0) is the number of small side rows,
+// range(1) the number of rows per key. The large side has 4x the small side rows and half of
+// them match.
+
+namespace
+{
+struct Hasher
+{
+  size_t operator()(int64_t val) const
+  {
+    return fHasher((char*)&val, 8);
+  }
+  utils::Hasher fHasher;
+};
+
+using OldTable = std::tr1::unordered_multimap<int64_t, uint8_t*, Hasher>;
+using NewTable = joiner::JoinHashTable<int64_t, uint8_t*, Hasher, std::equal_to<int64_t>>;
+
+struct Data
+{
+  vector<int64_t> smallKeys;
+  vector<int64_t> largeKeys;
+};
+
+Data makeData(size_t smallRows, size_t dupsPerKey)
+{
+  Data d;
+  mt19937_64 rng(42);
+  size_t keys = max<size_t>(1, smallRows / dupsPerKey);
+  for (size_t i = 0; i < smallRows; ++i)
+    d.smallKeys.push_back((int64_t)(i % keys) * 2);
+  shuffle(d.smallKeys.begin(), d.smallKeys.end(), rng);
+
+  uniform_int_distribution<int64_t> dist(0, keys * 2 - 1);
+  for (size_t i = 0; i < smallRows * 4; ++i)
+    d.largeKeys.push_back(dist(rng) & ~int64_t(i & 1));  // odd keys never match
+  return d;
+}
+
+uint8_t* rowPtr(size_t i)
+{
+  return reinterpret_cast<uint8_t*>(i << 4);
+}
+}  // namespace
+
+static void BM_JoinHashTableBuildOld(benchmark::State& state)
+{
+  Data d = makeData(state.range(0), state.range(1));
+  for (auto _ : state)
+  {
+    OldTable t(10);
+    for (size_t i = 0; i < d.smallKeys.size(); ++i)
+      t.insert(make_pair(d.smallKeys[i], rowPtr(i)));
+    benchmark::DoNotOptimize(t.size());
+  }
+  state.SetItemsProcessed(state.iterations() * d.smallKeys.size());
+}
+BENCHMARK(BM_JoinHashTableBuildOld)->Args({1 << 16, 1})->Args({1 << 20, 1})->Args({1 << 20, 8});
+
+static void BM_JoinHashTableBuildNew(benchmark::State& state)
+{
+  Data d = makeData(state.range(0), state.range(1));
+  for (auto _ : state)
+  {
+    NewTable t;
+    for (size_t i = 0; i < d.smallKeys.size(); ++i)
+      t.insert(d.smallKeys[i], rowPtr(i));
+    benchmark::DoNotOptimize(t.size());
+  }
+  state.SetItemsProcessed(state.iterations() * d.smallKeys.size());
+}
+BENCHMARK(BM_JoinHashTableBuildNew)->Args({1 << 16, 1})->Args({1 << 20, 1})->Args({1 << 20, 8});
+
+static void BM_JoinHashTableProbeOld(benchmark::State& state)
+{
+  Data d = makeData(state.range(0), state.range(1));
+  OldTable t(10);
+  for (size_t i = 0; i < d.smallKeys.size(); ++i)
+    t.insert(make_pair(d.smallKeys[i], rowPtr(i)));
+
+  vector<uint8_t*> matches;
+  for (auto _ : state)
+  {
+    for (int64_t key : d.largeKeys)
+    {
+      matches.clear();
+      for (auto range = t.equal_range(key); range.first != range.second; ++range.first)
+        matches.push_back(range.first->second);
+      benchmark::DoNotOptimize(matches.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * d.largeKeys.size());
+}
+BENCHMARK(BM_JoinHashTableProbeOld)->Args({1 << 16, 1})->Args({1 << 20, 1})->Args({1 << 20, 8});
+
+// range(2) is the prefetch batch size, 0 disables prefetching.
+static void BM_JoinHashTableProbeNew(benchmark::State& state)
+{
+  Data d = makeData(state.range(0), state.range(1));
+  size_t batch = state.range(2);
+  NewTable t;
+  for (size_t i = 0; i < d.smallKeys.size(); ++i)
+    t.insert(d.smallKeys[i], rowPtr(i));
+
+  vector<uint8_t*> matches;
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < d.largeKeys.size(); ++i)
+    {
+      if (batch && i % batch == 0)
+        for (size_t j = i; j < min(i + batch, d.largeKeys.size()); ++j)
+          t.prefetch(t.hash(d.largeKeys[j]));
+
+      matches.clear();
+      auto range = t.equal_range(d.largeKeys[i]);
+      matches.insert(matches.end(), range.first, range.second);
+      benchmark::DoNotOptimize(matches.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * d.largeKeys.size());
+}
+BENCHMARK(BM_JoinHashTableProbeNew)
+    ->Args({1 << 16, 1, 0})
+    ->Args({1 << 20, 1, 0})
+    ->Args({1 << 20, 1, 16})
+    ->Args({1 << 20, 8, 0})
+    ->Args({1 << 20, 8, 16});
+
+BENCHMARK_MAIN();
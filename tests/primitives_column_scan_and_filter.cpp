@@ -25,6 +25,9 @@
 #include "datatypes/mcs_int128.h"
 #include "stats.h"
 #include "primitives/linux-port/primitiveprocessor.h"
+#include "simd_dispatch.h"
+#include "filebuffer.h"
+#include "columnencoding.h"
 #include "col1block.h"
 #include "col2block.h"
 #include "col4block.h"
@@ -414,6 +417,58 @@ TEST_F(ColumnScanFilterTest, ColumnScan4BytesUsingMultipleRIDs)
   ASSERT_EQ(results[126], 1020);
 }
 
+// The AUX column marks the empty rows. The RID count isn't a multiple of any vector size so the
+// scalar tail must look the AUX flags up by RID too. Runs with every SIMD width the CPU has.
+TEST_F(ColumnScanFilterTest, ColumnScan4BytesAuxColumnUsingMultipleRIDs)
+{
+  constexpr const uint8_t W = 4;
+  using IntegralType = datatypes::WidthToSIntegralType<W>::type;
+  using UT = datatypes::make_unsigned<IntegralType>::type;
+  UT* results;
+  const size_t ridsNumber = 127;
+  uint8_t blockAux[BLOCK_SIZE];
+
+  for (i = 0; i < BLOCK_SIZE; ++i)
+    blockAux[i] = (i % 3 == 0) ? execplan::AUX_COL_EMPTYVALUE : 0;
+
+  const simd::SimdLevel detected = simd::detectSimdLevel();
+  for (auto level : {simd::SimdLevel::SIMD128, simd::SimdLevel::SIMD256, simd::SimdLevel::SIMD512})
+  {
+    if (level > detected)
+      break;
+    simd::setSimdLevel(level);
+    SetUp();
+    in->colType.DataSize = W;
+    in->colType.DataType = SystemCatalog::INT;
+    in->OutputType = OT_DATAVALUE;
+    in->NOPS = 0;
+    in->NVALS = ridsNumber;
+    in->hasAuxCol = true;
+    for (i = 0; i < ridsNumber; ++i)
+      rids[i] = i;
+    rids[0] = 20;
+    rids[1] = 17;
+    rids[126] = 1021;
+
+    pp.setBlockPtr((int*)readBlockFromLiteralArray("col4block.cdf", block));
+    pp.setBlockPtrAux((int*)blockAux);
+    pp.columnScanAndFilter<IntegralType>(in, out);
+
+    results = getValuesArrayPosition<UT>(getFirstValueArrayPosition(out), 0);
+
+    size_t expected = 0;
+    for (i = 0; i < ridsNumber; ++i)
+    {
+      if (blockAux[rids[i]] == execplan::AUX_COL_EMPTYVALUE)
+        continue;
+      ASSERT_EQ(results[expected], rids[i]) << "SIMD width " << simd::simdLevelToBits(level);
+      ++expected;
+    }
+    ASSERT_EQ(out->NVALS, expected);
+  }
+  simd::setSimdLevel(detected);
+}
+
 TEST_F(ColumnScanFilterTest, ColumnScan4Bytes2Filters)
 {
   constexpr const uint8_t W = 4;
@@ -1006,3 +1061,223 @@ TEST_F(ColumnScanFilterTest, ColumnScan16Bytes2CompFilters)
   EXPECT_EQ(expectedMax.getValue(), __col16block_cdf_umax);
   EXPECT_EQ(expectedMin.getValue(), __col16block_cdf_umin);
 }
+
+// A block scanned on the block cache's encoded copy of it must give what the scan of the
+// decoded block gives: the same values and RIDs in the same order, and the same Min/Max.
+class ColumnScanEncodedTest : public ColumnScanFilterTest
+{
+ protected:
+  struct Op
+  {
+    uint8_t cop;
+    int64_t value;
+  };
+
+  enum Shape
+  {
+    FRAME,  // small values around 0, FOR
+    RUNS,   // long runs of a few values, RLE
+    RAMP    // an increasing sequence, DELTA, RLE for 1 byte values that can't hold a long one
+  };
+
+  alignas(utils::MAXCOLUMNWIDTH) uint8_t decodedOutput[4 * BLOCK_SIZE];
+
+  // The last 100 values are EMPTY like the end of a partly filled extent, RUNS blocks have NULLs.
+  // A NULL would widen a frame past the point where FOR pays.
+  template <typename T>
+  void makeBlock(Shape shape, uint8_t dataType)
+  {
+    const uint32_t n = BLOCK_SIZE / sizeof(T);
+    T* values = reinterpret_cast<T*>(block);
+    T nullValue = getNullValue<T>(dataType);
+    T emptyValue = std::is_signed<T>::value ? nullValue + 1 : std::numeric_limits<T>::max();
+    uint64_t x = 88172645463325252ULL;
+
+    for (uint32_t j = 0; j < n; j++)
+    {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+
+      if (shape == FRAME)
+        values[j] = (T)(x % 40) - (std::is_signed<T>::value ? 20 : 0);
+      else if (shape == RUNS)
+        values[j] = (T)((j / 37) % 5);
+      else
+        values[j] = (T)(sizeof(T) == 1 ? j / 80 : j * 3 + 7);
+
+      if (shape == RUNS && x % 97 == 0)
+        values[j] = nullValue;
+    }
+
+    for (uint32_t j = n - 100; j < n; j++)
+      values[j] = emptyValue;
+  }
+
+  template <typename T>
+  void setFilter(uint8_t dataType, uint8_t outputType, uint8_t bop, const std::vector<Op>& ops)
+  {
+    memset(input, 0, BLOCK_SIZE);
+    in->colType = ColRequestHeaderDataType();
+    in->colType.DataSize = sizeof(T);
+    in->colType.DataType = dataType;
+    in->OutputType = outputType;
+    in->BOP = bop;
+    in->NOPS = ops.size();
+    in->NVALS = 0;
+
+    for (uint32_t j = 0; j < ops.size(); j++)
+    {
+      ColArgs* arg = reinterpret_cast<ColArgs*>(&input[sizeof(NewColRequestHeader) +
+                                                       j * (sizeof(ColArgs) + sizeof(T))]);
+      T value = (T)ops[j].value;
+      arg->COP = ops[j].cop;
+      memcpy(arg->val, &value, sizeof(T));
+    }
+  }
+
+  template <typename T>
+  void compare(uint8_t dataType, uint8_t outputType, uint8_t bop, const std::vector<Op>& ops,
+               const dbbc::SPEncodedBlock& encoded)
+  {
+    using IntegralType = typename datatypes::WidthToSIntegralType<sizeof(T)>::type;
+    ColResultHeader* decodedOut = reinterpret_cast<ColResultHeader*>(decodedOutput);
+    setFilter<T>(dataType, outputType, bop, ops);
+
+    memset(decodedOutput, 0, sizeof(decodedOutput));
+    pp.setEncodedBlocks(nullptr);
+    pp.columnScanAndFilter<IntegralType>(in, decodedOut);
+
+    memset(output, 0, sizeof(output));
+    pp.setEncodedBlocks(&encoded);
+    pp.columnScanAndFilter<IntegralType>(in, out);
+    pp.setEncodedBlocks(nullptr);
+
+    ASSERT_EQ(out->NVALS, decodedOut->NVALS);
+
+    if (outputType & OT_RID)
+      EXPECT_EQ(memcmp(getFirstRIDArrayPosition(out), getFirstRIDArrayPosition(decodedOut),
+                       out->NVALS * sizeof(primitives::RIDType)),
+                0);
+
+    if (outputType & OT_DATAVALUE)
+      EXPECT_EQ(memcmp(getFirstValueArrayPosition(out), getFirstValueArrayPosition(decodedOut),
+                       out->NVALS * sizeof(T)),
+                0);
+
+    ASSERT_EQ(out->ValidMinMax, decodedOut->ValidMinMax);
+
+    if (out->ValidMinMax)
+    {
+      EXPECT_EQ(out->Min, decodedOut->Min);
+      EXPECT_EQ(out->Max, decodedOut->Max);
+    }
+  }
+
+  template <typename T>
+  void compareAll(uint8_t dataType)
+  {
+    const int64_t nullValue = (int64_t)getNullValue<T>(dataType);
+
+    for (Shape shape : {FRAME, RUNS, RAMP})
+    {
+      makeBlock<T>(shape, dataType);
+      dbbc::SPEncodedBlock encoded = dbbc::encodeBlock(block, sizeof(T));
+      ASSERT_TRUE(encoded) << "width " << sizeof(T) << " shape " << shape;
+      compress::ColumnEncoding::Type type = shape == FRAME ? compress::ColumnEncoding::FOR
+                                            : shape == RAMP && sizeof(T) > 1 ? compress::ColumnEncoding::DELTA
+                                                                             : compress::ColumnEncoding::RLE;
+      ASSERT_EQ(compress::ColumnEncoding::getType(encoded->data(), encoded->len), type)
+          << "width " << sizeof(T) << " shape " << shape;
+      pp.setBlockPtr(reinterpret_cast<int*>(block));
+
+      for (uint8_t cop : {COMPARE_LT, COMPARE_EQ, COMPARE_LE, COMPARE_GT, COMPARE_NE, COMPARE_GE})
+        for (int64_t value : {-30, -1, 0, 3, 25, 1000})
+        {
+          SCOPED_TRACE(::testing::Message() << "width " << sizeof(T) << " shape " << shape << " cop "
+                                            << (int)cop << " value " << value);
+          compare<T>(dataType, OT_DATAVALUE, BOP_NONE, {{cop, value}}, encoded);
+        }
+
+      SCOPED_TRACE(::testing::Message() << "width " << sizeof(T) << " shape " << shape);
+      // no filter, every value but the EMPTY ones
+      compare<T>(dataType, OT_BOTH, BOP_NONE, {}, encoded);
+      compare<T>(dataType, OT_RID, BOP_AND, {{COMPARE_GT, 1}, {COMPARE_LE, 30}}, encoded);
+      compare<T>(dataType, OT_BOTH, BOP_OR, {{COMPARE_LT, 2}, {COMPARE_EQ, 700}, {COMPARE_GE, 90}}, encoded);
+      compare<T>(dataType, OT_DATAVALUE, BOP_OR, {{COMPARE_EQ, 1}, {COMPARE_EQ, 3}}, encoded);
+      compare<T>(dataType, OT_DATAVALUE, BOP_AND, {{COMPARE_NE, 1}, {COMPARE_NE, 3}}, encoded);
+      // IS NULL, IS NOT NULL and IS NULL OR a value
+      compare<T>(dataType, OT_BOTH, BOP_NONE, {{COMPARE_EQ, nullValue}}, encoded);
+      compare<T>(dataType, OT_RID, BOP_NONE, {{COMPARE_NE, nullValue}}, encoded);
+      compare<T>(dataType, OT_BOTH, BOP_OR, {{COMPARE_EQ, nullValue}, {COMPARE_EQ, 2}}, encoded);
+      compare<T>(dataType, OT_DATAVALUE, BOP_AND, {{COMPARE_NIL, 0}}, encoded);
+    }
+  }
+};
+
+TEST_F(ColumnScanEncodedTest, Signed)
+{
+  compareAll<int8_t>(SystemCatalog::TINYINT);
+  compareAll<int16_t>(SystemCatalog::SMALLINT);
+  compareAll<int32_t>(SystemCatalog::INT);
+  compareAll<int64_t>(SystemCatalog::BIGINT);
+}
+
+TEST_F(ColumnScanEncodedTest, Unsigned)
+{
+  compareAll<uint8_t>(SystemCatalog::UTINYINT);
+  compareAll<uint16_t>(SystemCatalog::USMALLINT);
+  compareAll<uint32_t>(SystemCatalog::UINT);
+  compareAll<uint64_t>(SystemCatalog::UBIGINT);
+}
+
+// The filter runs on the encoded copy, the values come from the decoded block
+TEST_F(ColumnScanEncodedTest, FiltersTheCopy)
+{
+  makeBlock<int32_t>(RUNS, SystemCatalog::INT);
+  dbbc::SPEncodedBlock encoded = dbbc::encodeBlock(block, 4);
+  ASSERT_TRUE(encoded);
+  int32_t* values = reinterpret_cast<int32_t*>(block);
+  pp.setBlockPtr(values);
+
+  setFilter<int32_t>(SystemCatalog::INT, OT_BOTH, BOP_NONE, {{COMPARE_EQ, 2}});
+  pp.setEncodedBlocks(&encoded);
+  pp.columnScanAndFilter<int32_t>(in, out);
+  const uint32_t matches = out->NVALS;
+  ASSERT_GT(matches, 0U);
+
+  // a decoded block that no longer matches the copy
+  for (uint32_t j = 0; j < BLOCK_SIZE / 4; j++)
+    values[j] = values[j] == 2 ? 1000 : values[j];
+
+  memset(output, 0, sizeof(output));
+  pp.columnScanAndFilter<int32_t>(in, out);
+  pp.setEncodedBlocks(nullptr);
+  ASSERT_EQ(out->NVALS, matches);
+  EXPECT_EQ(getValuesArrayPosition<int32_t>(getFirstValueArrayPosition(out), 0)[0], 1000);
+}
+
+// A block without an encoded copy, or a request the encoded scan can't answer, takes the
+// decoded path
+TEST_F(ColumnScanEncodedTest, Fallback)
+{
+  makeBlock<int32_t>(RUNS, SystemCatalog::INT);
+  dbbc::SPEncodedBlock encoded = dbbc::encodeBlock(block, 4);
+  ASSERT_TRUE(encoded);
+  pp.setBlockPtr(reinterpret_cast<int*>(block));
+
+  compare<int32_t>(SystemCatalog::INT, OT_BOTH, BOP_AND, {{COMPARE_GT, 1}}, dbbc::SPEncodedBlock());
+  compare<int32_t>(SystemCatalog::INT, OT_BOTH, BOP_XOR, {{COMPARE_GT, 1}, {COMPARE_LT, 3}}, encoded);
+
+  // input RIDs
+  setFilter<int32_t>(SystemCatalog::INT, OT_BOTH, BOP_NONE, {});
+  in->NVALS = 3;
+  rids[0] = 1;
+  rids[1] = 100;
+  rids[2] = 2000;
+  pp.setEncodedBlocks(&encoded);
+  pp.columnScanAndFilter<int32_t>(in, out);
+  pp.setEncodedBlocks(nullptr);
+  EXPECT_LE(out->NVALS, 3);
+  EXPECT_FALSE(out->ValidMinMax);
+}
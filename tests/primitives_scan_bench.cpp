@@ -22,6 +22,7 @@
 #include "datatypes/mcs_datatype.h"
 #include "stats.h"
 #include "primitives/linux-port/primitiveprocessor.h"
+#include "simd_dispatch.h"
 #include "col1block.h"
 #include "col2block.h"
 #include "col4block.h"
@@ -101,6 +102,18 @@ class FilterBenchFixture : public benchmark::Fixture
     pp.setBlockPtr((int*)readBlockFromLiteralArray(dataName, block));
   }
 
+  // The vectorized benchmarks take the SIMD width in bits as the argument.
+  bool setUpSimdWidth(benchmark::State& state)
+  {
+    simd::SimdLevel level = simd::simdLevelFromBits(state.range(0));
+    if (simd::setSimdLevel(level) != level)
+    {
+      state.SkipWithError("The SIMD width isn't supported by the CPU");
+      return false;
+    }
+    return true;
+  }
+
   template <int W>
   void runFilterBenchTemplated()
   {
@@ -151,6 +164,9 @@ BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan1Byte1FilterTemplatedCode)
 
 BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan1ByteVectorizedCode)(benchmark::State& state)
 {
+  if (!setUpSimdWidth(state))
+    return;
+
   for (auto _ : state)
   {
     constexpr const uint8_t W = 1;
@@ -161,10 +177,13 @@ BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan1ByteVectorizedCode)(benchma
   }
 }
 
-BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan1ByteVectorizedCode);
+BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan1ByteVectorizedCode)->Arg(128)->Arg(256)->Arg(512);
 
 BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan1Byte1FilterVectorizedCode)(benchmark::State& state)
 {
+  if (!setUpSimdWidth(state))
+    return;
+
   for (auto _ : state)
   {
     state.PauseTiming();
@@ -176,7 +195,10 @@ BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan1Byte1FilterVectorizedCode)(
   }
 }
 
-BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan1Byte1FilterVectorizedCode);
+BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan1Byte1FilterVectorizedCode)
+    ->Arg(128)
+    ->Arg(256)
+    ->Arg(512);
 
 BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan2ByteTemplatedCode)(benchmark::State& state)
 {
@@ -209,6 +231,9 @@ BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan2Byte1FilterTemplatedCode)
 
 BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan2Byte1FilterVectorizedCode)(benchmark::State& state)
 {
+  if (!setUpSimdWidth(state))
+    return;
+
   for (auto _ : state)
   {
     state.PauseTiming();
@@ -220,7 +245,10 @@ BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan2Byte1FilterVectorizedCode)(
   }
 }
 
-BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan2Byte1FilterVectorizedCode);
+BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan2Byte1FilterVectorizedCode)
+    ->Arg(128)
+    ->Arg(256)
+    ->Arg(512);
 
 
 BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan4ByteTemplatedCode)(benchmark::State& state)
@@ -239,6 +267,9 @@ BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan4ByteTemplatedCode);
 
 BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan4ByteVectorizedCode)(benchmark::State& state)
 {
+  if (!setUpSimdWidth(state))
+    return;
+
   for (auto _ : state)
   {
     state.PauseTiming();
@@ -250,7 +281,7 @@ BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan4ByteVectorizedCode)(benchma
   }
 }
 
-BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan4ByteVectorizedCode);
+BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan4ByteVectorizedCode)->Arg(128)->Arg(256)->Arg(512);
 
 BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan8ByteTemplatedCode)(benchmark::State& state)
 {
@@ -283,6 +314,9 @@ BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan8Byte1FilterTemplatedCode)
 
 BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan8ByteVectorizedCode)(benchmark::State& state)
 {
+  if (!setUpSimdWidth(state))
+    return;
+
   for (auto _ : state)
   {
     constexpr const uint8_t W = 8;
@@ -293,10 +327,13 @@ BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan8ByteVectorizedCode)(benchma
   }
 }
 
-BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan8ByteVectorizedCode);
+BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan8ByteVectorizedCode)->Arg(128)->Arg(256)->Arg(512);
 
 BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan8Byte1FilterVectorizedCode)(benchmark::State& state)
 {
+  if (!setUpSimdWidth(state))
+    return;
+
   for (auto _ : state)
   {
     constexpr const uint8_t W = 8;
@@ -308,6 +345,9 @@ BENCHMARK_DEFINE_F(FilterBenchFixture, BM_ColumnScan8Byte1FilterVectorizedCode)(
   }
 }
 
-BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan8Byte1FilterVectorizedCode);
+BENCHMARK_REGISTER_F(FilterBenchFixture, BM_ColumnScan8Byte1FilterVectorizedCode)
+    ->Arg(128)
+    ->Arg(256)
+    ->Arg(512);
 
 BENCHMARK_MAIN();
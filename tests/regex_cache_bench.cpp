@@ -0,0 +1,99 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "utils/funcexp/regexcache.h"
+
+using namespace std;
+
+// Compares the per row cost of REGEXP with the pattern compiled for every row (the old
+// Func_regexp behaviour) against the per thread RegexCache. Rows/s is reported as items_per_second.
+
+using jp = jpcre2::select<char>;
+
+namespace
+{
+const jpcre2::Uint Flags = PCRE2_UTF | PCRE2_UCP | PCRE2_CASELESS;
+const string ConstPattern = "^[a-z]+_(error|warn)[0-9]{2,4}$";
+
+vector<string> makeRows()
+{
+  vector<string> rows;
+  const char* samples[] = {"service_error042", "service_info0042", "worker_warn1234", "Worker_Debug7",
+                           "node_error99",     "proxy_warn0",      "db_error2024",    "cache_ok"};
+  for (size_t i = 0; i < 1024; ++i)
+    rows.push_back(samples[i % (sizeof(samples) / sizeof(samples[0]))]);
+  return rows;
+}
+
+const vector<string> Rows = makeRows();
+}  // namespace
+
+static void BM_RegexpCompileEveryRow(benchmark::State& state)
+{
+  size_t matches = 0;
+  for (auto _ : state)
+  {
+    for (const auto& row : Rows)
+    {
+      jp::Regex re(ConstPattern, Flags);
+      matches += re.match(row);
+    }
+  }
+  benchmark::DoNotOptimize(matches);
+  state.SetItemsProcessed(state.iterations() * Rows.size());
+}
+BENCHMARK(BM_RegexpCompileEveryRow);
+
+static void BM_RegexpCachedConstPattern(benchmark::State& state)
+{
+  funcexp::RegexCache cache;
+  size_t matches = 0;
+  for (auto _ : state)
+  {
+    for (const auto& row : Rows)
+      matches += cache.get(ConstPattern, Flags).match(row);
+  }
+  benchmark::DoNotOptimize(matches);
+  state.SetItemsProcessed(state.iterations() * Rows.size());
+}
+BENCHMARK(BM_RegexpCachedConstPattern);
+
+// The pattern comes from a column that has range(0) distinct values. Above the cache capacity
+// every row is a miss, so this also shows the cost of LRU eviction.
+static void BM_RegexpCachedColumnPattern(benchmark::State& state)
+{
+  vector<string> patterns;
+  for (int64_t i = 0; i < state.range(0); ++i)
+    patterns.push_back("_(error|warn)" + to_string(i) + "|^[a-z]+_error[0-9]{2}$");
+
+  funcexp::RegexCache cache;
+  size_t matches = 0;
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < Rows.size(); ++i)
+      matches += cache.get(patterns[i % patterns.size()], Flags).match(Rows[i]);
+  }
+  benchmark::DoNotOptimize(matches);
+  state.SetItemsProcessed(state.iterations() * Rows.size());
+}
+BENCHMARK(BM_RegexpCachedColumnPattern)->Arg(4)->Arg(funcexp::RegexCache::DefaultCapacity)->Arg(64);
+
+BENCHMARK_MAIN();
@@ -320,3 +320,38 @@ TEST_F(RowDecimalTest, RowEqualsCheck)
     }
   }
 }
+
+TEST(RowStringTest, ShareFieldCheck)
+{
+  std::vector<uint32_t> offsets{2, 102, 110};
+  std::vector<uint32_t> roids{3001, 3002}, tkeys{1, 2}, cscale{0, 0}, precision{0, 10}, charsets{8, 8};
+  std::vector<CSCDataType> types{execplan::CalpontSystemCatalog::VARCHAR,
+                                 execplan::CalpontSystemCatalog::BIGINT};
+
+  rowgroup::RowGroup rg(roids.size(), offsets, roids, tkeys, types, charsets, cscale, precision, 20, true);
+  rowgroup::RGData rgD(rg);
+  rowgroup::Row first, r;
+  rg.setData(&rgD);
+  rg.initRow(&first);
+  rg.initRow(&r);
+
+  const std::string value(60, 'x');
+  rg.getRow(0, &first);
+  first.setStringField(utils::ConstString(value.data(), value.size()), 0);
+  first.setIntField(1, 1);
+
+  rg.getRow(1, &r);
+  r.shareField(first, 0);
+  r.setIntField(2, 1);
+  rg.setRowCount(2);
+
+  // The second row refers to the same stored string
+  EXPECT_EQ(r.getConstString(0).str(), first.getConstString(0).str());
+  EXPECT_EQ(r.getStringField(0).safeString(), value);
+  EXPECT_EQ(r.getIntField(1), 2);
+
+  rg.getRow(2, &r);
+  first.setStringField(utils::ConstString(nullptr, 0), 0);
+  r.shareField(first, 0);
+  EXPECT_TRUE(r.isNullValue(0));
+}
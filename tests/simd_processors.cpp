@@ -24,6 +24,8 @@
 #include "datatypes/mcs_int128.h"
 #include "simd_sse.h"
 #include "simd_arm.h"
+#include "simd_dispatch.h"
+#include "simd_processors_wide.h"
 #if defined(__x86_64__)
 #define TESTS_USING_SSE 1
 using float64_t = double;
@@ -517,4 +519,49 @@ TEST(SimdProcessorTest, Float32)
   EXPECT_TRUE(cmpEqFunctor(proc.cmpLt(lhs, rhs), expectLt));
   EXPECT_TRUE(cmpEqFunctor(proc.cmpGe(lhs, rhs), ~expectLt));
 }
-#endif
\ No newline at end of file
+#endif
+
+#if defined(__x86_64__)
+// The wide processors are checked lane by lane against the scalar comparison in
+// simd_processors_avx2.cpp/simd_processors_avx512.cpp. Only those kernels are built for the wide
+// ISA, this harness stays at the baseline one and skips the kernels the CPU can't run.
+template <typename T>
+class SimdProcessorWideTypedTest : public testing::Test
+{
+ public:
+  void expectAllPassed(const SimdWideCheck& res)
+  {
+    EXPECT_TRUE(res.cmpEq);
+    EXPECT_TRUE(res.cmpNe);
+    EXPECT_TRUE(res.cmpGt);
+    EXPECT_TRUE(res.cmpGe);
+    EXPECT_TRUE(res.cmpLt);
+    EXPECT_TRUE(res.cmpLe);
+    EXPECT_TRUE(res.cmpAlwaysTrue);
+    EXPECT_TRUE(res.cmpAlwaysFalse);
+    EXPECT_TRUE(res.cmpEqLoadValue);
+    EXPECT_TRUE(res.min);
+    EXPECT_TRUE(res.max);
+    EXPECT_TRUE(res.maskCtor);
+    EXPECT_TRUE(res.blend);
+  }
+};
+
+using SimdProcessorWideTypedTestTypes =
+    ::testing::Types<uint64_t, uint32_t, uint16_t, uint8_t, int64_t, int32_t, int16_t, int8_t, double, float>;
+TYPED_TEST_SUITE(SimdProcessorWideTypedTest, SimdProcessorWideTypedTestTypes);
+
+TYPED_TEST(SimdProcessorWideTypedTest, SimdFilterProcessor_simd256)
+{
+  if (simd::detectSimdLevel() < simd::SimdLevel::SIMD256)
+    GTEST_SKIP() << "The CPU doesn't support AVX2";
+  this->expectAllPassed(checkSimd256Processor<TypeParam>());
+}
+
+TYPED_TEST(SimdProcessorWideTypedTest, SimdFilterProcessor_simd512)
+{
+  if (simd::detectSimdLevel() < simd::SimdLevel::SIMD512)
+    GTEST_SKIP() << "The CPU doesn't support AVX-512";
+  this->expectAllPassed(checkSimd512Processor<TypeParam>());
+}
+#endif
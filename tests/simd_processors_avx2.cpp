@@ -0,0 +1,64 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+// The 256 bit processor checks. Like primitives/linux-port/column_avx2.cpp this TU is not built
+// with -m flags, only the code after the includes is generated for AVX2.
+
+#define MCS_SIMD_TARGET_AVX2
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include "datatypes/mcs_datatype.h"
+#include "simd_sse.h"
+#include "simd_processors_wide.h"
+
+#if defined(__x86_64__)
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "simd_avx2.h"
+#include "simd_processors_wide_kernel.h"
+
+template <typename T>
+SimdWideCheck checkSimd256Processor()
+{
+  using Wrapper = typename simd::IntegralToSIMD256<T, wideKind<T>()>::type;
+  return checkWideProcessor<simd::SimdFilterProcessor<Wrapper, T>, T>();
+}
+
+template SimdWideCheck checkSimd256Processor<uint64_t>();
+template SimdWideCheck checkSimd256Processor<uint32_t>();
+template SimdWideCheck checkSimd256Processor<uint16_t>();
+template SimdWideCheck checkSimd256Processor<uint8_t>();
+template SimdWideCheck checkSimd256Processor<int64_t>();
+template SimdWideCheck checkSimd256Processor<int32_t>();
+template SimdWideCheck checkSimd256Processor<int16_t>();
+template SimdWideCheck checkSimd256Processor<int8_t>();
+template SimdWideCheck checkSimd256Processor<double>();
+template SimdWideCheck checkSimd256Processor<float>();
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+#endif
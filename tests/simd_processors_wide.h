@@ -0,0 +1,50 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+// Interface between the simd_processors test harness, built for the baseline ISA, and the
+// kernels in simd_processors_avx2.cpp/simd_processors_avx512.cpp, built inside AVX target
+// regions. The harness only calls a kernel after it checked the CPU supports its ISA.
+
+#pragma once
+
+#include <cstdint>
+
+// Which of the checks of one vector width passed
+struct SimdWideCheck
+{
+  bool cmpEq = false;
+  bool cmpNe = false;
+  bool cmpGt = false;
+  bool cmpGe = false;
+  bool cmpLt = false;
+  bool cmpLe = false;
+  bool cmpAlwaysTrue = false;
+  bool cmpAlwaysFalse = false;
+  bool cmpEqLoadValue = false;
+  bool min = false;
+  bool max = false;
+  bool maskCtor = false;
+  bool blend = false;
+};
+
+// Instantiated for uint64_t, uint32_t, uint16_t, uint8_t, int64_t, int32_t, int16_t, int8_t,
+// double and float.
+template <typename T>
+SimdWideCheck checkSimd256Processor();
+
+template <typename T>
+SimdWideCheck checkSimd512Processor();
@@ -0,0 +1,108 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+// The lane by lane check of a wide SimdFilterProcessor. It is included by the kernel TUs
+// after they opened their target region, so it is built for the wide ISA only there. The
+// anonymous namespace keeps each TU's copy private.
+
+#pragma once
+
+namespace
+{
+template <typename T>
+constexpr ENUM_KIND wideKind()
+{
+  return std::is_floating_point<T>::value ? KIND_FLOAT : KIND_DEFAULT;
+}
+
+template <typename Proc, typename T>
+SimdWideCheck checkWideProcessor()
+{
+  constexpr const size_t VecSize = Proc::vecByteSize / sizeof(T);
+  using SimdType = typename Proc::SimdType;
+  using MaskType = typename Proc::MaskType;
+  T l[VecSize];
+  T r[VecSize];
+  char laneMask[VecSize];
+  for (size_t i = 0; i < VecSize; ++i)
+  {
+    // Every third lane is equal, the rest alternates between greater and less.
+    l[i] = static_cast<T>((i * 37) % 101) - static_cast<T>(50 * std::is_signed<T>::value);
+    r[i] = (i % 3 == 0) ? l[i] : (i % 2) ? static_cast<T>(l[i] + 1) : static_cast<T>(l[i] - 1);
+    laneMask[i] = (i % 3 == 1) ? -1 : 0;
+  }
+  // The lanes with the type limits catch signed/unsigned comparison mix-ups.
+  l[1] = std::numeric_limits<T>::max();
+  r[1] = std::numeric_limits<T>::lowest();
+  l[VecSize - 1] = std::numeric_limits<T>::lowest();
+  r[VecSize - 1] = static_cast<T>(1);
+
+  auto expectedMask = [&](auto cmp)
+  {
+    MaskType mask;
+    auto* maskBytes = reinterpret_cast<uint8_t*>(&mask);
+    for (size_t i = 0; i < VecSize; ++i)
+      memset(maskBytes + i * sizeof(T), cmp(l[i], r[i]) ? 0xFF : 0x00, sizeof(T));
+    return mask;
+  };
+  auto sameMask = [](MaskType left, MaskType right)
+  { return !memcmp((void*)(&left), (void*)(&right), sizeof(MaskType)); };
+
+  SimdWideCheck res;
+  Proc proc;
+  SimdType lhs = proc.loadFrom(reinterpret_cast<char*>(l));
+  SimdType rhs = proc.loadFrom(reinterpret_cast<char*>(r));
+  res.cmpEq = sameMask(proc.cmpEq(lhs, rhs), expectedMask([](T x, T y) { return x == y; }));
+  res.cmpNe = sameMask(proc.cmpNe(lhs, rhs), expectedMask([](T x, T y) { return x != y; }));
+  res.cmpGt = sameMask(proc.cmpGt(lhs, rhs), expectedMask([](T x, T y) { return x > y; }));
+  res.cmpGe = sameMask(proc.cmpGe(lhs, rhs), expectedMask([](T x, T y) { return x >= y; }));
+  res.cmpLt = sameMask(proc.cmpLt(lhs, rhs), expectedMask([](T x, T y) { return x < y; }));
+  res.cmpLe = sameMask(proc.cmpLe(lhs, rhs), expectedMask([](T x, T y) { return x <= y; }));
+  res.cmpAlwaysTrue = sameMask(proc.cmpAlwaysTrue(lhs, rhs), proc.trueMask());
+  res.cmpAlwaysFalse = sameMask(proc.cmpAlwaysFalse(lhs, rhs), proc.falseMask());
+  T first = l[0];
+  res.cmpEqLoadValue = sameMask(proc.cmpEq(lhs, proc.loadValue(first)),
+                                expectedMask([first](T x, T) { return x == first; }));
+
+  T minlr[VecSize];
+  T maxlr[VecSize];
+  T lanes[VecSize];
+  for (size_t i = 0; i < VecSize; ++i)
+  {
+    minlr[i] = l[i] < r[i] ? l[i] : r[i];
+    maxlr[i] = l[i] < r[i] ? r[i] : l[i];
+  }
+  proc.store(reinterpret_cast<char*>(lanes), proc.min(lhs, rhs));
+  res.min = !memcmp(lanes, minlr, sizeof(lanes));
+  proc.store(reinterpret_cast<char*>(lanes), proc.max(lhs, rhs));
+  res.max = !memcmp(lanes, maxlr, sizeof(lanes));
+
+  // maskCtor widens a byte per lane mask, e.g. the AUX column flags, to the lane width.
+  MaskType auxMask = proc.maskCtor(laneMask);
+  MaskType expectedAuxMask;
+  auto* expectedAuxMaskBytes = reinterpret_cast<char*>(&expectedAuxMask);
+  for (size_t i = 0; i < VecSize; ++i)
+    memset(expectedAuxMaskBytes + i * sizeof(T), laneMask[i], sizeof(T));
+  res.maskCtor = sameMask(auxMask, expectedAuxMask);
+  proc.store(reinterpret_cast<char*>(lanes), proc.blend(lhs, rhs, (SimdType)auxMask));
+  res.blend = true;
+  for (size_t i = 0; i < VecSize; ++i)
+    res.blend = res.blend && (lanes[i] == (laneMask[i] ? r[i] : l[i]));
+
+  return res;
+}
+}  // namespace
@@ -0,0 +1,115 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "SMComm.h"
+#include "SMDataFile.h"
+
+using namespace std;
+using namespace idbdatafile;
+
+// SMDataFile::pread() throughput through StorageManager, the socket data path against the shared memory
+// one.  Needs a running StorageManager.  The file is written once and removed at exit; set
+// SMDATAFILE_BENCH_FILE to put it somewhere other than dbroot 1.
+
+namespace
+{
+const size_t FileSize = 256UL << 20;
+
+struct BenchFile
+{
+  BenchFile()
+  {
+    const char* env = getenv("SMDATAFILE_BENCH_FILE");
+    name = env ? env : "/var/lib/columnstore/data1/smdatafile_bench.dat";
+    SMComm* comm = SMComm::get();
+    struct stat statbuf;
+
+    if (comm->ping() || comm->open(name, O_CREAT | O_RDWR | O_TRUNC, &statbuf))
+      return;
+
+    vector<uint8_t> buf(4 << 20);
+    mt19937 gen(42);
+    for (auto& b : buf)
+      b = gen();
+    for (size_t offset = 0; offset < FileSize; offset += buf.size())
+      if (comm->pwrite(name, buf.data(), buf.size(), offset) != (ssize_t)buf.size())
+        return;
+    file.reset(new SMDataFile(name.c_str(), O_RDONLY, statbuf));
+  }
+  ~BenchFile()
+  {
+    if (file)
+      SMComm::get()->unlink(name);
+  }
+
+  string name;
+  unique_ptr<SMDataFile> file;
+};
+
+BenchFile& benchFile()
+{
+  static BenchFile f;
+  return f;
+}
+
+// range(0): request size, range(1): 1 for the shared memory path
+void BM_SMDataFileRead(benchmark::State& state)
+{
+  const size_t requestSize = state.range(0);
+  SMDataFile* fp = benchFile().file.get();
+
+  if (!fp)
+  {
+    state.SkipWithError("StorageManager is not running");
+    return;
+  }
+  SMComm::get()->setSharedMemoryIO(state.range(1));
+
+  vector<uint8_t> buf(requestSize);
+  off64_t offset = state.thread_index() * (FileSize / state.threads());
+
+  for (auto _ : state)
+  {
+    if (fp->pread(buf.data(), offset, requestSize) != (ssize_t)requestSize)
+    {
+      state.SkipWithError("short read");
+      break;
+    }
+    offset = (offset + requestSize) % FileSize;
+  }
+
+  state.SetBytesProcessed(state.iterations() * requestSize);
+}
+
+}  // namespace
+
+BENCHMARK(BM_SMDataFileRead)
+    ->ArgNames({"size", "shm"})
+    ->ArgsProduct({{8 << 10, 64 << 10, 1 << 20, 4 << 20}, {0, 1}})
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
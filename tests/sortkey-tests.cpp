@@ -0,0 +1,168 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "rowgroup.h"
+#include "idborderby.h"
+
+using CSCDataType = execplan::CalpontSystemCatalog::ColDataType;
+using ordering::IdbSortSpec;
+using ordering::OrderByData;
+using ordering::SortKeyEncoder;
+
+class SortKeyTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    // INT, BIGINT UNSIGNED, DOUBLE, TIME, VARCHAR(16), DECIMAL(38), FLOAT
+    std::vector<uint32_t> offsets{2, 6, 14, 22, 30, 46, 62, 66};
+    std::vector<uint32_t> roids, tkeys, cscale, charsets;
+    std::vector<uint32_t> precision{10, 20, 0, 0, 0, 38, 0};
+    std::vector<CSCDataType> types{execplan::CalpontSystemCatalog::INT,
+                                   execplan::CalpontSystemCatalog::UBIGINT,
+                                   execplan::CalpontSystemCatalog::DOUBLE,
+                                   execplan::CalpontSystemCatalog::TIME,
+                                   execplan::CalpontSystemCatalog::VARCHAR,
+                                   execplan::CalpontSystemCatalog::DECIMAL,
+                                   execplan::CalpontSystemCatalog::FLOAT};
+
+    for (uint32_t i = 0; i < types.size(); i++)
+    {
+      roids.push_back(3001 + i);
+      tkeys.push_back(i + 1);
+      cscale.push_back(0);
+      charsets.push_back(8);
+    }
+
+    rg = rowgroup::RowGroup(types.size(), offsets, roids, tkeys, types, charsets, cscale, precision, 20, true);
+    rgD.reinit(rg, ROWS);
+    rg.setData(&rgD);
+    rg.resetRowGroup(0);
+
+    // Few distinct values, so there are ties to break on the next column
+    std::mt19937_64 rng(42);
+    const int64_t ints[] = {-100, -1, 0, 1, 100};
+    const double doubles[] = {-1e300, -1.5, -0.0, 0.0, 2.5, 1e300};
+    const uint64_t negTime = 1ULL << 63;
+    const uint64_t times[] = {negTime | 26, negTime | 25, 0, 25, 26};
+    const std::string strings[] = {"", "a", "A", "a ", "ab", "Ab", "b", "\xe5"};
+    const int128_t decimals[] = {-(static_cast<int128_t>(1) << 100), -1, 0, 1, static_cast<int128_t>(1) << 100};
+    const float floats[] = {-2.5f, -0.0f, 0.0f, 1.0f};
+
+    rowgroup::Row r;
+    rg.initRow(&r);
+    rg.getRow(0, &r);
+
+    for (uint32_t i = 0; i < ROWS; i++)
+    {
+      r.setIntField(ints[rng() % 5], 0);
+      r.setUintField(rng() % 3, 1);
+      r.setDoubleField(doubles[rng() % 6], 2);
+      r.setIntField(times[rng() % 5], 3);
+      const std::string& s = strings[rng() % 8];
+      r.setStringField(utils::ConstString(s.data(), s.size()), 4);
+      r.setInt128Field(decimals[rng() % 5], 5);
+      r.setFloatField(floats[rng() % 4], 6);
+
+      for (uint32_t col = 0; col < 7; col++)
+      {
+        if (rng() % 8 == 0)
+          r.setToNull(col);
+      }
+
+      rows.push_back(r.getPointer());
+      rg.incRowCount();
+      r.nextRow();
+    }
+  }
+
+  static const uint32_t ROWS = 300;
+  rowgroup::RowGroup rg;
+  rowgroup::RGData rgD;
+  std::vector<rowgroup::Row::Pointer> rows;
+};
+
+// memcmp() of the keys has to agree with CompareRule for every pair of rows
+TEST_F(SortKeyTest, KeysOrderLikeCompareRule)
+{
+  std::mt19937_64 rng(7);
+
+  for (int round = 0; round < 20; round++)
+  {
+    // A random column order, direction and NULL placement
+    std::vector<int> columns{0, 1, 2, 3, 4, 5, 6};
+    std::shuffle(columns.begin(), columns.end(), rng);
+    std::vector<IdbSortSpec> spec;
+    const uint32_t count = 1 + rng() % 7;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+      if (rng() % 2)
+        spec.push_back(IdbSortSpec(columns[i], rng() % 2));
+      else
+        spec.push_back(IdbSortSpec(columns[i], rng() % 2, rng() % 2));
+    }
+
+    OrderByData compare(spec, rg);
+    SortKeyEncoder encoder(spec, rg);
+    ASSERT_TRUE(encoder.encodable());
+
+    const uint32_t keyLength = encoder.keyLength();
+    std::vector<uint8_t> keys(ROWS * keyLength);
+    rowgroup::Row r;
+    rg.initRow(&r);
+
+    for (uint32_t i = 0; i < ROWS; i++)
+    {
+      r.setPointer(rows[i]);
+      encoder.encode(r, &keys[i * keyLength]);
+    }
+
+    for (uint32_t i = 0; i < ROWS; i++)
+    {
+      for (uint32_t j = 0; j < ROWS; j++)
+      {
+        int expected = compare(rows[i], rows[j]) ? -1 : (compare(rows[j], rows[i]) ? 1 : 0);
+        int actual = memcmp(&keys[i * keyLength], &keys[j * keyLength], keyLength);
+        actual = (actual > 0) - (actual < 0);
+        ASSERT_EQ(actual, expected) << "round " << round << " rows " << i << "," << j;
+      }
+    }
+  }
+}
+
+TEST_F(SortKeyTest, NotEncodable)
+{
+  std::vector<uint32_t> offsets{2, 18, 1042};
+  std::vector<uint32_t> roids{3001, 3002}, tkeys{1, 2}, cscale{0, 0}, precision{0, 0}, charsets{8, 8};
+  std::vector<CSCDataType> types{execplan::CalpontSystemCatalog::LONGDOUBLE,
+                                 execplan::CalpontSystemCatalog::VARCHAR};
+  rowgroup::RowGroup other(2, offsets, roids, tkeys, types, charsets, cscale, precision, 20, true);
+
+  // no binary form for LONG DOUBLE
+  EXPECT_FALSE(SortKeyEncoder({IdbSortSpec(0, true)}, other).encodable());
+  // the weights of a VARCHAR(1024) don't fit in a key
+  EXPECT_FALSE(SortKeyEncoder({IdbSortSpec(1, true)}, other).encodable());
+  EXPECT_TRUE(SortKeyEncoder({IdbSortSpec(4, false)}, rg).encodable());
+}
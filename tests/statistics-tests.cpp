@@ -0,0 +1,150 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "statistics.h"
+
+using statistics::Histogram;
+using statistics::HyperLogLog;
+
+TEST(HyperLogLog, Empty)
+{
+  HyperLogLog hll;
+  EXPECT_EQ(hll.estimate(), 0u);
+}
+
+TEST(HyperLogLog, SmallCountsAreExact)
+{
+  HyperLogLog hll;
+  for (int rep = 0; rep < 3; rep++)
+    for (uint64_t i = 0; i < 100; i++)
+      hll.add(i);
+
+  EXPECT_NEAR(hll.estimate(), 100, 2);
+}
+
+TEST(HyperLogLog, LargeCounts)
+{
+  for (uint64_t n : {10000ULL, 1000000ULL, 10000000ULL})
+  {
+    HyperLogLog hll;
+    for (uint64_t i = 0; i < n; i++)
+      hll.add(i * 7919);
+
+    // ~1.6% standard error, allow for 3 of them
+    EXPECT_NEAR(hll.estimate(), n, n * 0.05) << n;
+  }
+}
+
+TEST(HyperLogLog, Merge)
+{
+  HyperLogLog a, b, all;
+  for (uint64_t i = 0; i < 200000; i++)
+  {
+    (i % 2 ? a : b).add(i);
+    all.add(i);
+  }
+
+  a.merge(b);
+  EXPECT_EQ(a.estimate(), all.estimate());
+}
+
+TEST(Histogram, Uniform)
+{
+  std::vector<uint64_t> values;
+  for (int64_t i = 0; i < 10000; i++)
+    values.push_back(i);
+
+  Histogram h;
+  h.build(values, 100);
+  EXPECT_EQ(h.bounds.size(), 101u);
+  EXPECT_EQ(h.sampleSize, 10000u);
+
+  EXPECT_DOUBLE_EQ(h.rangeFraction(0, 9999), 1.0);
+  EXPECT_DOUBLE_EQ(h.rangeFraction(-100, -1), 0.0);
+  EXPECT_DOUBLE_EQ(h.rangeFraction(10000, 20000), 0.0);
+  EXPECT_NEAR(h.rangeFraction(0, 4999), 0.5, 0.01);
+  EXPECT_NEAR(h.rangeFraction(2500, 7499), 0.5, 0.01);
+  EXPECT_NEAR(h.fractionBelow(1000), 0.1, 0.01);
+  EXPECT_NEAR(h.fractionAtMost(8999), 0.9, 0.01);
+  EXPECT_DOUBLE_EQ(h.rangeFraction(10, 5), 0.0);
+}
+
+TEST(Histogram, Skewed)
+{
+  // 90% of the values are 0, the rest are spread over [1, 1000]
+  std::vector<uint64_t> values(9000, 0);
+  for (int64_t i = 1; i <= 1000; i++)
+    values.push_back(i);
+
+  Histogram h;
+  h.build(values, 100);
+
+  EXPECT_NEAR(h.rangeFraction(0, 0), 0.9, 0.02);
+  EXPECT_NEAR(h.rangeFraction(1, 1000), 0.1, 0.02);
+  EXPECT_NEAR(h.rangeFraction(501, 1000), 0.05, 0.02);
+}
+
+TEST(Histogram, Signed)
+{
+  std::vector<int64_t> signedValues;
+  for (int64_t i = -5000; i < 5000; i++)
+    signedValues.push_back(i);
+  std::vector<uint64_t> values(signedValues.begin(), signedValues.end());
+
+  Histogram h;
+  h.build(values, 100);
+
+  EXPECT_NEAR(h.rangeFraction(-5000, -1), 0.5, 0.01);
+  EXPECT_NEAR(h.rangeFraction(std::numeric_limits<int64_t>::min(), 0), 0.5, 0.01);
+  EXPECT_DOUBLE_EQ(h.rangeFraction(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()),
+                   1.0);
+}
+
+TEST(Histogram, Unsigned)
+{
+  // the upper half doesn't fit an int64_t
+  std::vector<uint64_t> values;
+  const uint64_t step = std::numeric_limits<uint64_t>::max() / 1000;
+  for (uint64_t i = 0; i < 1000; i++)
+    values.push_back(i * step);
+
+  Histogram h;
+  h.isUnsigned = true;
+  h.build(values, 100);
+
+  const int64_t middle = static_cast<int64_t>(500 * step);
+  EXPECT_NEAR(h.rangeFraction(0, middle), 0.5, 0.01);
+  EXPECT_NEAR(h.rangeFraction(middle, -1), 0.5, 0.01);
+  EXPECT_DOUBLE_EQ(h.fractionBelow(0), 0.0);
+}
+
+TEST(Histogram, Empty)
+{
+  Histogram h;
+  h.build({}, 100);
+  EXPECT_DOUBLE_EQ(h.rangeFraction(0, 100), 0.0);
+
+  h.build({42}, 100);
+  EXPECT_DOUBLE_EQ(h.rangeFraction(42, 42), 1.0);
+  EXPECT_DOUBLE_EQ(h.rangeFraction(0, 41), 0.0);
+}
@@ -0,0 +1,204 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "rowgroup.h"
+#include "idborderby.h"
+#include "jlf_common.h"
+#include "resourcemanager.h"
+#include "windowfunctionstep.h"
+#include "framebound.h"
+#include "frameboundrow.h"
+#include "windowframe.h"
+#include "windowfunction.h"
+#include "windowfunctiontype.h"
+#include "wf_min_max.h"
+#include "wf_sum_avg.h"
+
+using namespace std;
+using namespace windowfunction;
+
+// Cost of MIN and SUM over ROWS BETWEEN <frame> PRECEDING AND CURRENT ROW on one partition,
+// through WindowFunction::operator() as WindowFunctionStep runs it.  The rescan versions have
+// dropValues() disabled, so every frame is computed from scratch, as before the functions
+// could slide.  The sliding versions drop the row leaving the frame and add the one entering.
+// range(0) is the partition size, range(1) the frame size.  The rescan versions only run on the
+// 1M row partition, they would take hours on the larger one.  Needs the Columnstore config for
+// the ResourceManager.
+
+namespace
+{
+template <typename F>
+class Rescan : public F
+{
+ public:
+  Rescan(int id, const string& name) : F(id, name)
+  {
+  }
+
+  bool dropValues(int64_t, int64_t) override
+  {
+    return false;
+  }
+};
+
+// BIGINT value, BIGINT output for MIN, LONG DOUBLE output for SUM
+struct Partition
+{
+  rowgroup::RowGroup rg;
+  vector<rowgroup::RGData> data;
+};
+
+const Partition& partition(size_t rows)
+{
+  static Partition p;
+
+  if (p.rg.getColumnCount() == 0 || p.data.size() != (rows + 8191) / 8192)
+  {
+    vector<uint32_t> offsets{2, 10, 18, 34};
+    vector<uint32_t> roids{3001, 3002, 3003}, tkeys{1, 2, 3}, cscale{0, 0, 0}, charsets{8, 8, 8};
+    vector<uint32_t> precision{19, 19, 0};
+    vector<execplan::CalpontSystemCatalog::ColDataType> types{execplan::CalpontSystemCatalog::BIGINT,
+                                                              execplan::CalpontSystemCatalog::BIGINT,
+                                                              execplan::CalpontSystemCatalog::LONGDOUBLE};
+    p.rg = rowgroup::RowGroup(3, offsets, roids, tkeys, types, charsets, cscale, precision, 20, false);
+    p.data.clear();
+
+    mt19937_64 rng(42);
+    uniform_int_distribution<int64_t> dist(-1000000, 1000000);
+    rowgroup::Row r;
+    p.rg.initRow(&r);
+
+    for (size_t done = 0; done < rows;)
+    {
+      p.data.emplace_back(p.rg, 8192);
+      p.rg.setData(&p.data.back());
+      p.rg.resetRowGroup(0);
+      p.rg.getRow(0, &r);
+
+      for (uint32_t i = 0; i < 8192 && done < rows; i++, done++, r.nextRow())
+      {
+        r.setIntField(dist(rng), 0);
+        p.rg.incRowCount();
+      }
+    }
+  }
+
+  return p;
+}
+
+// the rows stay in their order, there is no ORDER BY to sort them by
+void run(benchmark::State& state, boost::shared_ptr<WindowFunctionType> func, int64_t out)
+{
+  const Partition& p = partition(state.range(0));
+  rowgroup::RowGroup rg = p.rg;
+  joblist::JobInfo jobInfo(joblist::ResourceManager::instance());
+  jobInfo.errorInfo.reset(new joblist::ErrorInfo());
+
+  vector<uint64_t> noColumns;
+  vector<ordering::IdbSortSpec> noSorts;
+  boost::shared_ptr<ordering::EqualCompData> parts(new ordering::EqualCompData(noColumns, rg));
+  boost::shared_ptr<ordering::OrderByData> orderBy(new ordering::OrderByData(noSorts, rg));
+  boost::shared_ptr<ordering::EqualCompData> peers(new ordering::EqualCompData(noColumns, rg));
+
+  func->peer(peers);
+  func->fieldIndex(vector<int64_t>{out, 0});
+  func->frameUnit(WF__FRAME_ROWS);
+
+  for (auto _ : state)
+  {
+    joblist::WindowFunctionStep step(jobInfo);
+    step.setInputRows(rg, p.data);
+
+    boost::shared_ptr<FrameBound> upper(new FrameBoundConstantRow(WF__CONSTANT_PRECEDING, state.range(1)));
+    boost::shared_ptr<FrameBound> lower(new FrameBoundRow(WF__CURRENT_ROW));
+    upper->peer(peers);
+    lower->peer(peers);
+    lower->start(false);
+    boost::shared_ptr<WindowFrame> frame(new WindowFrame(WF__FRAME_ROWS, upper, lower));
+
+    rowgroup::Row row;
+    rg.initRow(&row);
+    WindowFunction wf(func, parts, orderBy, frame, rg, row);
+    wf.setCallback(&step, 0);
+    wf();
+
+    if (step.cancelled())
+    {
+      state.SkipWithError(step.errorInfo()->errMsg.c_str());
+      return;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+static void BM_FrameMinRescan(benchmark::State& state)
+{
+  run(state, boost::shared_ptr<WindowFunctionType>(new Rescan<WF_min_max<int64_t> >(WF__MIN, "MIN")), 1);
+}
+BENCHMARK(BM_FrameMinRescan)
+    ->Args({1 << 20, 10})
+    ->Args({1 << 20, 100})
+    ->Args({1 << 20, 1000})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_FrameMinSliding(benchmark::State& state)
+{
+  run(state, boost::shared_ptr<WindowFunctionType>(new WF_min_max<int64_t>(WF__MIN, "MIN")), 1);
+}
+BENCHMARK(BM_FrameMinSliding)
+    ->Args({1 << 20, 10})
+    ->Args({1 << 20, 100})
+    ->Args({1 << 20, 1000})
+    ->Args({16 << 20, 10})
+    ->Args({16 << 20, 1000})
+    ->Args({16 << 20, 100000})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_FrameSumRescan(benchmark::State& state)
+{
+  run(state,
+      boost::shared_ptr<WindowFunctionType>(new Rescan<WF_sum_avg<int64_t, long double> >(WF__SUM, "SUM")),
+      2);
+}
+BENCHMARK(BM_FrameSumRescan)
+    ->Args({1 << 20, 10})
+    ->Args({1 << 20, 100})
+    ->Args({1 << 20, 1000})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_FrameSumSliding(benchmark::State& state)
+{
+  run(state, boost::shared_ptr<WindowFunctionType>(new WF_sum_avg<int64_t, long double>(WF__SUM, "SUM")),
+      2);
+}
+BENCHMARK(BM_FrameSumSliding)
+    ->Args({1 << 20, 10})
+    ->Args({1 << 20, 100})
+    ->Args({1 << 20, 1000})
+    ->Args({16 << 20, 10})
+    ->Args({16 << 20, 1000})
+    ->Args({16 << 20, 100000})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,394 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "rowgroup.h"
+#include "idborderby.h"
+#include "jlf_common.h"
+#include "resourcemanager.h"
+#include "windowfunctionstep.h"
+#include "framebound.h"
+#include "frameboundrange.h"
+#include "frameboundrow.h"
+#include "windowframe.h"
+#include "windowfunction.h"
+#include "windowfunctiontype.h"
+#include "wf_count.h"
+#include "wf_min_max.h"
+#include "wf_stats.h"
+#include "wf_sum_avg.h"
+
+using namespace windowfunction;
+using CSCDataType = execplan::CalpontSystemCatalog::ColDataType;
+using ordering::EqualCompData;
+using ordering::IdbSortSpec;
+using ordering::OrderByData;
+
+// The moving frames are computed by dropping the rows that leave the frame and adding those
+// entering it.  These tests run each function through WindowFunction::operator() once like
+// that, and once with dropValues() disabled, which makes the driver recompute every frame,
+// and compare the results row by row.
+
+namespace
+{
+// The same function, but every frame is computed from scratch
+template <typename F>
+class Rescan : public F
+{
+ public:
+  Rescan(int id, const std::string& name) : F(id, name)
+  {
+  }
+
+  bool dropValues(int64_t, int64_t) override
+  {
+    return false;
+  }
+};
+
+template <typename F>
+boost::shared_ptr<WindowFunctionType> makeFunction(int id, const std::string& name, bool sliding)
+{
+  if (sliding)
+    return boost::shared_ptr<WindowFunctionType>(new F(id, name));
+
+  return boost::shared_ptr<WindowFunctionType>(new Rescan<F>(id, name));
+}
+
+// column indexes
+enum
+{
+  PART,
+  ORD,
+  IVAL,
+  DVAL,
+  ORD_MINUS_3,
+  ORD_MINUS_2,
+  ORD_PLUS_2,
+  ORD_PLUS_5,
+  OUT_LD,
+  OUT_INT,
+  OUT_DBL,
+  COLUMNS
+};
+
+struct Bound
+{
+  int type;
+  int offset;
+  int column;  // holds ORD -/+ offset, for the RANGE bounds
+};
+
+struct Frame
+{
+  const char* name;
+  int64_t unit;
+  Bound upper;
+  Bound lower;
+};
+
+const Frame frames[] = {
+    {"ROWS 3 PRECEDING - CURRENT ROW", WF__FRAME_ROWS, {WF__CONSTANT_PRECEDING, 3, -1}, {WF__CURRENT_ROW, 0, -1}},
+    {"ROWS 2 PRECEDING - 2 FOLLOWING",
+     WF__FRAME_ROWS,
+     {WF__CONSTANT_PRECEDING, 2, -1},
+     {WF__CONSTANT_FOLLOWING, 2, -1}},
+    // empty at the start of the partition
+    {"ROWS 4 PRECEDING - 2 PRECEDING",
+     WF__FRAME_ROWS,
+     {WF__CONSTANT_PRECEDING, 4, -1},
+     {WF__CONSTANT_PRECEDING, 2, -1}},
+    // leaves the partition at its end
+    {"ROWS 5 FOLLOWING - 8 FOLLOWING",
+     WF__FRAME_ROWS,
+     {WF__CONSTANT_FOLLOWING, 5, -1},
+     {WF__CONSTANT_FOLLOWING, 8, -1}},
+    {"ROWS UNBOUNDED PRECEDING - 2 FOLLOWING",
+     WF__FRAME_ROWS,
+     {WF__UNBOUNDED_PRECEDING, 0, -1},
+     {WF__CONSTANT_FOLLOWING, 2, -1}},
+    {"RANGE 3 PRECEDING - CURRENT ROW",
+     WF__FRAME_RANGE,
+     {WF__CONSTANT_PRECEDING, 3, ORD_MINUS_3},
+     {WF__CURRENT_ROW, 0, -1}},
+    {"RANGE 2 PRECEDING - 2 FOLLOWING",
+     WF__FRAME_RANGE,
+     {WF__CONSTANT_PRECEDING, 2, ORD_MINUS_2},
+     {WF__CONSTANT_FOLLOWING, 2, ORD_PLUS_2}},
+    // the peers only
+    {"RANGE CURRENT ROW - CURRENT ROW", WF__FRAME_RANGE, {WF__CURRENT_ROW, 0, -1}, {WF__CURRENT_ROW, 0, -1}},
+    // empty for the rows without a peer that far ahead, and leaves the partition
+    {"RANGE 2 FOLLOWING - 5 FOLLOWING",
+     WF__FRAME_RANGE,
+     {WF__CONSTANT_FOLLOWING, 2, ORD_PLUS_2},
+     {WF__CONSTANT_FOLLOWING, 5, ORD_PLUS_5}},
+};
+
+boost::shared_ptr<FrameBound> makeBound(int64_t unit, const Bound& b, bool start,
+                                        const boost::shared_ptr<EqualCompData>& peers)
+{
+  boost::shared_ptr<FrameBound> fb;
+
+  if (b.type == WF__UNBOUNDED_PRECEDING || b.type == WF__UNBOUNDED_FOLLOWING)
+  {
+    fb.reset(new FrameBound(b.type));
+  }
+  else if (unit == WF__FRAME_ROWS)
+  {
+    if (b.type == WF__CURRENT_ROW)
+      fb.reset(new FrameBoundRow(b.type));
+    else
+      fb.reset(new FrameBoundConstantRow(b.type, b.offset));
+  }
+  else if (b.type == WF__CURRENT_ROW)
+  {
+    fb.reset(new FrameBoundRange(b.type));
+  }
+  else
+  {
+    int64_t v = b.offset;
+    FrameBoundConstantRange<int64_t>* fbr = new FrameBoundConstantRange<int64_t>(b.type, true, true, &v);
+    fbr->setIndex(std::vector<int>{ORD, -1, b.column});
+    fbr->isZero(v == 0);
+    fb.reset(fbr);
+  }
+
+  fb->peer(peers);
+  fb->start(start);
+  return fb;
+}
+}  // namespace
+
+class WindowFrameTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    std::vector<uint32_t> offsets{2};
+    std::vector<uint32_t> roids, tkeys, cscale, charsets, precision;
+    std::vector<CSCDataType> types;
+
+    for (uint32_t i = 0; i < COLUMNS; i++)
+    {
+      CSCDataType t = execplan::CalpontSystemCatalog::BIGINT;
+
+      if (i == DVAL || i == OUT_DBL)
+        t = execplan::CalpontSystemCatalog::DOUBLE;
+      else if (i == OUT_LD)
+        t = execplan::CalpontSystemCatalog::LONGDOUBLE;
+
+      types.push_back(t);
+      offsets.push_back(offsets.back() + (t == execplan::CalpontSystemCatalog::LONGDOUBLE ? 16 : 8));
+      roids.push_back(3001 + i);
+      tkeys.push_back(i + 1);
+      cscale.push_back(0);
+      charsets.push_back(8);
+      precision.push_back(t == execplan::CalpontSystemCatalog::BIGINT ? 19 : 0);
+    }
+
+    rg = rowgroup::RowGroup(COLUMNS, offsets, roids, tkeys, types, charsets, cscale, precision, 20, false);
+    rgD.reinit(rg, ROWS);
+    rg.setData(&rgD);
+    rg.resetRowGroup(0);
+
+    // Partitions of 1, 2, 7, 40 and 150 rows.  Few distinct ORD values, so there are many
+    // peers, and NULLs in ORD and in the values, also in runs.
+    const uint32_t partSizes[] = {1, 2, 7, 40, 150};
+    std::mt19937_64 rng(42);
+    rowgroup::Row r;
+    rg.initRow(&r);
+    rg.getRow(0, &r);
+
+    for (uint32_t p = 0; p < 5; p++)
+    {
+      for (uint32_t i = 0; i < partSizes[p]; i++)
+      {
+        r.setIntField(p, PART);
+        bool ordNull = (rng() % 10 == 0);
+        int64_t ord = rng() % 20;
+
+        if (ordNull)
+        {
+          for (int c : {ORD, ORD_MINUS_3, ORD_MINUS_2, ORD_PLUS_2, ORD_PLUS_5})
+            r.setToNull(c);
+        }
+        else
+        {
+          r.setIntField(ord, ORD);
+          r.setIntField(ord - 3, ORD_MINUS_3);
+          r.setIntField(ord - 2, ORD_MINUS_2);
+          r.setIntField(ord + 2, ORD_PLUS_2);
+          r.setIntField(ord + 5, ORD_PLUS_5);
+        }
+
+        // the last rows of the big partition are all NULL
+        if (rng() % 6 == 0 || (p == 4 && i >= 140))
+        {
+          r.setToNull(IVAL);
+          r.setToNull(DVAL);
+        }
+        else
+        {
+          r.setIntField((int64_t)(rng() % 2001) - 1000, IVAL);
+          // very different magnitudes, where dropping values again would lose precision
+          r.setDoubleField((rng() % 2 ? 1e16 : 1e-3) * ((double)(rng() % 2001) - 1000), DVAL);
+        }
+
+        r.setToNull(OUT_LD);
+        r.setToNull(OUT_INT);
+        r.setToNull(OUT_DBL);
+        rg.incRowCount();
+        r.nextRow();
+      }
+    }
+  }
+
+  // Runs func over the rows, PARTITION BY PART ORDER BY ORD
+  void run(const boost::shared_ptr<WindowFunctionType>& func, int64_t in, int64_t out, const Frame& f)
+  {
+    joblist::JobInfo jobInfo(joblist::ResourceManager::instance());
+    jobInfo.errorInfo.reset(new joblist::ErrorInfo());
+    joblist::WindowFunctionStep step(jobInfo);
+    step.setInputRows(rg, std::vector<rowgroup::RGData>(1, rgD));
+
+    std::vector<uint64_t> partIdx{PART};
+    std::vector<uint64_t> peerIdx{ORD};
+    std::vector<IdbSortSpec> sorts{IdbSortSpec(PART, true, true), IdbSortSpec(ORD, true, true)};
+    boost::shared_ptr<EqualCompData> parts(new EqualCompData(partIdx, rg));
+    boost::shared_ptr<OrderByData> orderBy(new OrderByData(sorts, rg));
+    boost::shared_ptr<EqualCompData> peers(new EqualCompData(peerIdx, rg));
+
+    boost::shared_ptr<WindowFunctionType> fn(func);
+    fn->peer(peers);
+    fn->fieldIndex(std::vector<int64_t>{out, in});
+    fn->frameUnit(f.unit);
+
+    boost::shared_ptr<FrameBound> upper = makeBound(f.unit, f.upper, true, peers);
+    boost::shared_ptr<FrameBound> lower = makeBound(f.unit, f.lower, false, peers);
+    boost::shared_ptr<WindowFrame> frame(new WindowFrame(f.unit, upper, lower));
+
+    rowgroup::Row row;
+    rg.initRow(&row);
+    WindowFunction wf(fn, parts, orderBy, frame, rg, row);
+    wf.setCallback(&step, 0);
+    wf();
+
+    ASSERT_FALSE(step.cancelled()) << step.errorInfo()->errMsg;
+  }
+
+  // The output column of every row, NULL as NaN
+  std::vector<long double> results(int64_t out)
+  {
+    std::vector<long double> v;
+    rowgroup::Row r;
+    rg.setData(&rgD);
+    rg.initRow(&r);
+    rg.getRow(0, &r);
+
+    for (uint32_t i = 0; i < rg.getRowCount(); i++, r.nextRow())
+    {
+      if (r.isNullValue(out))
+        v.push_back(NAN);
+      else if (out == OUT_LD)
+        v.push_back(r.getLongDoubleField(out));
+      else if (out == OUT_DBL)
+        v.push_back(r.getDoubleField(out));
+      else
+        v.push_back(r.getIntField(out));
+    }
+
+    return v;
+  }
+
+  // Runs the function sliding and rescanning over every frame and compares the results.
+  // A tolerance of 0 asks for the same bits.
+  template <typename F>
+  void compare(int id, const std::string& name, int64_t in, int64_t out, long double tolerance = 0)
+  {
+    for (const Frame& f : frames)
+    {
+      SCOPED_TRACE(name + " " + f.name);
+      run(makeFunction<F>(id, name, true), in, out, f);
+      std::vector<long double> sliding = results(out);
+      run(makeFunction<F>(id, name, false), in, out, f);
+      std::vector<long double> rescan = results(out);
+
+      for (size_t i = 0; i < rescan.size(); i++)
+      {
+        if (std::isnan(rescan[i]))
+          EXPECT_TRUE(std::isnan(sliding[i])) << "row " << i;
+        else if (tolerance == 0)
+          EXPECT_EQ(sliding[i], rescan[i]) << "row " << i;
+        else
+          EXPECT_NEAR((double)sliding[i], (double)rescan[i], (double)(tolerance * (1 + fabsl(rescan[i]))))
+              << "row " << i;
+      }
+    }
+  }
+
+  static const uint32_t ROWS = 200;
+  rowgroup::RowGroup rg;
+  rowgroup::RGData rgD;
+};
+
+TEST_F(WindowFrameTest, Sum)
+{
+  compare<WF_sum_avg<int64_t, long double> >(WF__SUM, "SUM", IVAL, OUT_LD);
+}
+
+TEST_F(WindowFrameTest, Avg)
+{
+  compare<WF_sum_avg<int64_t, long double> >(WF__AVG, "AVG", IVAL, OUT_LD);
+}
+
+// dropValues() declines floating point input, so these recompute and must match exactly
+TEST_F(WindowFrameTest, SumDouble)
+{
+  compare<WF_sum_avg<double, long double> >(WF__SUM, "SUM", DVAL, OUT_LD);
+}
+
+TEST_F(WindowFrameTest, Count)
+{
+  compare<WF_count<int64_t> >(WF__COUNT, "COUNT", IVAL, OUT_INT);
+}
+
+TEST_F(WindowFrameTest, Min)
+{
+  compare<WF_min_max<int64_t> >(WF__MIN, "MIN", IVAL, OUT_INT);
+}
+
+TEST_F(WindowFrameTest, Max)
+{
+  compare<WF_min_max<int64_t> >(WF__MAX, "MAX", IVAL, OUT_INT);
+}
+
+TEST_F(WindowFrameTest, Stddev)
+{
+  // Welford's update run backwards rounds differently than running it forward
+  compare<WF_stats<int64_t> >(WF__STDDEV_POP, "STDDEV_POP", IVAL, OUT_DBL, 1e-9);
+}
+
+TEST_F(WindowFrameTest, VarianceDouble)
+{
+  compare<WF_stats<double> >(WF__VAR_SAMP, "VAR_SAMP", DVAL, OUT_DBL);
+}
@@ -15,6 +15,8 @@
    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
    MA 02110-1301, USA. */
 
+#include <algorithm>
+
 #include "SMComm.h"
 #include "messageFormat.h"
 
@@ -105,13 +107,72 @@ int SMComm::open(const string& filename, const int mode, struct stat* statbuf)
   common_exit(command, response, err);
 }
 
-ssize_t SMComm::pread(const string& filename, void* buf, const size_t count, const off_t offset)
+void SMComm::setSharedMemoryIO(bool enabled)
+{
+  shm.setEnabled(enabled);
+}
+
+ssize_t SMComm::preadShm(const string& absfilename, SharedMemoryPool::Region* region, uint8_t* buf,
+                         const size_t count, const off_t offset)
 {
   ByteStream* command = buffers.getByteStream();
   ByteStream* response = buffers.getByteStream();
   ssize_t err;
+  size_t done = 0;
+
+  // StorageManager reads the object & journal data straight into the region.  A request larger than
+  // the region is done a region at a time.
+  while (done < count)
+  {
+    size_t chunk = min(count - done, region->size);
+    command->restart();
+    *command << (uint8_t)storagemanager::READ_SHM << chunk << (off_t)(offset + done) << (uint64_t)0
+             << region->name << absfilename;
+    err = sockets.send_recv(*command, response);
+    if (err)
+    {
+      if (done > 0)
+        break;
+      common_exit(command, response, err);
+    }
+    *response >> err;
+    if (err < 0)
+    {
+      int l_errno;
+      *response >> l_errno;
+      if (done > 0)
+        break;
+      errno = l_errno;
+      common_exit(command, response, err);
+    }
+    memcpy(&buf[done], region->mem, err);
+    done += err;
+    if ((size_t)err < chunk)  // EOF
+      break;
+  }
+  errno = 0;
+  common_exit(command, response, (ssize_t)done);
+}
+
+ssize_t SMComm::pread(const string& filename, void* buf, const size_t count, const off_t offset)
+{
   string absfilename(getAbsFilename(filename));
 
+  if (shm.enabled())
+  {
+    SharedMemoryPool::Region* region = shm.getRegion();
+    if (region)
+    {
+      ssize_t ret = preadShm(absfilename, region, (uint8_t*)buf, count, offset);
+      shm.returnRegion(region);
+      return ret;
+    }
+  }
+
+  ByteStream* command = buffers.getByteStream();
+  ByteStream* response = buffers.getByteStream();
+  ssize_t err;
+
   *command << (uint8_t)storagemanager::READ << count << offset << absfilename;
   err = sockets.send_recv(*command, response);
   if (err)
@@ -122,13 +183,67 @@ ssize_t SMComm::pread(const string& filename, void* buf, const size_t count, con
   common_exit(command, response, err);
 }
 
-ssize_t SMComm::pwrite(const string& filename, const void* buf, const size_t count, const off_t offset)
+ssize_t SMComm::pwriteShm(const string& absfilename, SharedMemoryPool::Region* region, const uint8_t* buf,
+                          const size_t count, const off_t offset)
 {
   ByteStream* command = buffers.getByteStream();
   ByteStream* response = buffers.getByteStream();
   ssize_t err;
+  size_t done = 0;
+
+  // StorageManager writes the data straight from the region.  A request larger than the region is
+  // done a region at a time.
+  while (done < count)
+  {
+    size_t chunk = min(count - done, region->size);
+    memcpy(region->mem, &buf[done], chunk);
+    command->restart();
+    *command << (uint8_t)storagemanager::WRITE_SHM << chunk << (off_t)(offset + done) << (uint64_t)0
+             << region->name << absfilename;
+    err = sockets.send_recv(*command, response);
+    if (err)
+    {
+      if (done > 0)
+        break;
+      common_exit(command, response, err);
+    }
+    *response >> err;
+    if (err < 0)
+    {
+      int l_errno;
+      *response >> l_errno;
+      if (done > 0)
+        break;
+      errno = l_errno;
+      common_exit(command, response, err);
+    }
+    done += err;
+    if ((size_t)err < chunk)
+      break;
+  }
+  errno = 0;
+  common_exit(command, response, (ssize_t)done);
+}
+
+ssize_t SMComm::pwrite(const string& filename, const void* buf, const size_t count, const off_t offset)
+{
   string absfilename(getAbsFilename(filename));
 
+  if (shm.enabled())
+  {
+    SharedMemoryPool::Region* region = shm.getRegion();
+    if (region)
+    {
+      ssize_t ret = pwriteShm(absfilename, region, (const uint8_t*)buf, count, offset);
+      shm.returnRegion(region);
+      return ret;
+    }
+  }
+
+  ByteStream* command = buffers.getByteStream();
+  ByteStream* response = buffers.getByteStream();
+  ssize_t err;
+
   *command << (uint8_t)storagemanager::WRITE << count << offset << absfilename;
   command->needAtLeast(count);
   uint8_t* cmdBuf = command->getInputPtr();
@@ -19,6 +19,7 @@
 
 #include <sys/stat.h>
 #include <string>
+#include "SharedMemoryPool.h"
 #include "SocketPool.h"
 #include "bytestream.h"
 #include "bytestreampool.h"
@@ -61,6 +62,10 @@ class SMComm : public boost::noncopyable
 
   int copyFile(const std::string& file1, const std::string& file2);
 
+  // Turns the shared memory data path for pread() and pwrite() on or off.  It's on by default unless
+  // StorageManager/SharedMemoryIO = N; this is mostly for comparing the two in tests and benchmarks.
+  void setSharedMemoryIO(bool enabled);
+
   virtual ~SMComm();
 
  private:
@@ -68,7 +73,14 @@ class SMComm : public boost::noncopyable
 
   std::string getAbsFilename(const std::string& filename);
 
+  // pread() and pwrite() through a shared memory region instead of the socket
+  ssize_t preadShm(const std::string& absfilename, SharedMemoryPool::Region* region, uint8_t* buf,
+                   const size_t count, const off_t offset);
+  ssize_t pwriteShm(const std::string& absfilename, SharedMemoryPool::Region* region, const uint8_t* buf,
+                    const size_t count, const off_t offset);
+
   SocketPool sockets;
+  SharedMemoryPool shm;
   messageqcpp::ByteStreamPool buffers;
   std::string cwd;
 };
@@ -0,0 +1,171 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include "SharedMemoryPool.h"
+#include "configcpp.h"
+#include "logger.h"
+#include "messageFormat.h"
+
+#include <fcntl.h>
+#include <random>
+#include <sstream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace
+{
+void log(logging::LOG_TYPE whichLogFile, const string& msg)
+{
+  logging::Logger logger(12);  // 12 = configcpp
+  logger.logMessage(whichLogFile, msg, logging::LoggingID(12));
+}
+
+}  // namespace
+
+namespace idbdatafile
+{
+SharedMemoryPool::SharedMemoryPool() : regionSize(defaultRegionSize), maxRegions(defaultRegions), useShm(true)
+{
+  config::Config* config = config::Config::makeConfig();
+  string stmp;
+
+  try
+  {
+    stmp = config->getConfig("StorageManager", "SharedMemoryIO");
+    if (stmp == "N" || stmp == "n")
+      useShm = false;
+
+    stmp = config->getConfig("StorageManager", "SharedMemoryBufferSize");
+    if (!stmp.empty())
+    {
+      int64_t itmp = config::Config::fromText(stmp);
+      if (itmp < 64 * 1024 || itmp > (1 << 30))
+        log(logging::LOG_TYPE_WARNING, "SharedMemoryPool(): Got a bad value '" + stmp +
+                                           "' for StorageManager/SharedMemoryBufferSize.  Range is 64K-1G.");
+      else
+        regionSize = itmp;
+    }
+
+    // a request holds a socket and a region at the same time, there's no use for more regions than sockets
+    stmp = config->getConfig("StorageManager", "MaxSockets");
+    int64_t itmp = strtol(stmp.c_str(), NULL, 10);
+    if (itmp >= 1 && itmp <= 500)
+      maxRegions = itmp;
+  }
+  catch (exception& e)
+  {
+    ostringstream os;
+    os << "SharedMemoryPool(): Using default of " << defaultRegions << " regions of " << defaultRegionSize
+       << " bytes.";
+    log(logging::LOG_TYPE_WARNING, os.str());
+  }
+
+  // The pid lets StorageManager find regions left behind by a process that crashed.  The random part keeps
+  // a later process with the same pid from reusing a name StorageManager still has mapped.
+  random_device rd;
+  ostringstream os;
+  os << storagemanager::shm_region_prefix << getpid() << "." << hex << ((uint64_t)rd() << 32 | rd()) << ".";
+  namePrefix = os.str();
+}
+
+SharedMemoryPool::~SharedMemoryPool()
+{
+  boost::mutex::scoped_lock lock(mutex);
+
+  for (Region* region : allRegions)
+  {
+    ::munmap(region->mem, region->size);
+    ::shm_unlink(region->name.c_str());
+    delete region;
+  }
+}
+
+void SharedMemoryPool::setEnabled(bool enabled)
+{
+  useShm = enabled;
+}
+
+SharedMemoryPool::Region* SharedMemoryPool::makeRegion()
+{
+  ostringstream os;
+  os << namePrefix << allRegions.size();
+  string name = os.str();
+
+  int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0)
+    goto error;
+  if (::ftruncate(fd, regionSize) < 0)
+  {
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    goto error;
+  }
+
+  void* mem;
+  mem = ::mmap(NULL, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mem == MAP_FAILED)
+  {
+    ::shm_unlink(name.c_str());
+    goto error;
+  }
+
+  Region* ret;
+  ret = new Region();
+  ret->name = name;
+  ret->mem = (uint8_t*)mem;
+  ret->size = regionSize;
+  allRegions.push_back(ret);
+  return ret;
+
+error:
+  int saved_errno = errno;
+  char buf[80];
+  log(logging::LOG_TYPE_WARNING, "SharedMemoryPool: failed to create " + name + ", got '" +
+                                     strerror_r(saved_errno, buf, 80) +
+                                     "'.  Sending data to StorageManager over the socket instead.");
+  useShm = false;
+  errno = saved_errno;
+  return NULL;
+}
+
+SharedMemoryPool::Region* SharedMemoryPool::getRegion()
+{
+  boost::mutex::scoped_lock lock(mutex);
+
+  if (freeRegions.empty() && allRegions.size() < maxRegions)
+    return makeRegion();
+
+  // wait for a region to become free
+  while (freeRegions.empty())
+    regionAvailable.wait(lock);
+
+  Region* ret = freeRegions.front();
+  freeRegions.pop_front();
+  return ret;
+}
+
+void SharedMemoryPool::returnRegion(Region* region)
+{
+  boost::mutex::scoped_lock lock(mutex);
+  freeRegions.push_back(region);
+  regionAvailable.notify_one();
+}
+
+}  // namespace idbdatafile
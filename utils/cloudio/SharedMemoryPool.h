@@ -0,0 +1,78 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace idbdatafile
+{
+/* SharedMemoryPool owns the POSIX shared memory regions SMComm uses for READ_SHM and WRITE_SHM.
+   StorageManager maps a region the first time it sees it and reads and writes file data directly
+   in it, so the data doesn't go through the socket.  Like SocketPool, a region is used by one
+   request at a time. */
+class SharedMemoryPool : public boost::noncopyable
+{
+ public:
+  SharedMemoryPool();
+
+  // the dtor unmaps and unlinks all regions
+  virtual ~SharedMemoryPool();
+
+  struct Region
+  {
+    std::string name;
+    uint8_t* mem;
+    size_t size;
+  };
+
+  // false if StorageManager/SharedMemoryIO is disabled, or creating a region failed
+  bool enabled() const;
+  void setEnabled(bool);
+
+  // Returns a free region, creating or waiting for one as necessary.  Returns NULL if a new
+  // region could not be created, in which case the pool disables itself.
+  Region* getRegion();
+  void returnRegion(Region*);
+
+ private:
+  Region* makeRegion();
+
+  std::vector<Region*> allRegions;
+  std::deque<Region*> freeRegions;
+  boost::mutex mutex;
+  boost::condition_variable regionAvailable;
+  std::string namePrefix;
+  size_t regionSize;
+  uint maxRegions;
+  volatile bool useShm;
+  static const size_t defaultRegionSize = 4 << 20;
+  static const uint defaultRegions = 20;
+};
+
+inline bool SharedMemoryPool::enabled() const
+{
+  return useShm;
+}
+
+}  // namespace idbdatafile
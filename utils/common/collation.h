@@ -213,6 +213,12 @@ class Charset
     assert(mCharset->coll);
     return mCharset->coll->strnxfrm(mCharset, dst, dstlen, nweights, src, srclen, flags);
   }
+  // The buffer size strnxfrm() needs for the weights of srclen bytes
+  size_t strnxfrmlen(size_t srclen) const
+  {
+    assert(mCharset->coll);
+    return mCharset->coll->strnxfrmlen(mCharset, srclen);
+  }
   // The magic check that tells that bytes are mapped to weights as 1:1
   bool strnxfrmIsValid() const
   {
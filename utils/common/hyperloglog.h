@@ -0,0 +1,94 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+
+#include "hasher.h"
+
+namespace statistics
+{
+/** @brief HyperLogLog count of the distinct values of a column
+ *
+ *  2^precision one byte registers, each keeping the longest run of leading zeros seen in the
+ *  hashes that land in it.  With the default precision of 12 that's 4KB per column and a
+ *  standard error of about 1.6%, independent of the number of rows.  Small counts use linear
+ *  counting, as in the original paper.
+ */
+class HyperLogLog
+{
+ public:
+  explicit HyperLogLog(uint32_t precision = 12) : fPrecision(precision), fRegisters(1U << precision, 0)
+  {
+  }
+
+  void add(uint64_t value)
+  {
+    addHash(utils::fmix(value));
+  }
+
+  void addHash(uint64_t hash)
+  {
+    const uint32_t index = hash >> (64 - fPrecision);
+    const uint64_t rest = hash << fPrecision;
+    // rest has 64 - precision significant bits, the rank of all zeros is one past them
+    const uint8_t rank = rest ? __builtin_clzll(rest) + 1 : 64 - fPrecision + 1;
+    if (rank > fRegisters[index])
+      fRegisters[index] = rank;
+  }
+
+  void merge(const HyperLogLog& other)
+  {
+    if (other.fRegisters.size() != fRegisters.size())
+      return;
+    for (size_t i = 0; i < fRegisters.size(); i++)
+      if (other.fRegisters[i] > fRegisters[i])
+        fRegisters[i] = other.fRegisters[i];
+  }
+
+  uint64_t estimate() const
+  {
+    const double m = fRegisters.size();
+    double sum = 0;
+    uint32_t zeros = 0;
+    for (uint8_t r : fRegisters)
+    {
+      sum += std::ldexp(1.0, -r);
+      zeros += (r == 0);
+    }
+
+    const double alpha = 0.7213 / (1 + 1.079 / m);
+    double e = alpha * m * m / sum;
+    if (e <= 2.5 * m && zeros)
+      e = m * std::log(m / zeros);
+    return std::llround(e);
+  }
+
+  void clear()
+  {
+    fRegisters.assign(fRegisters.size(), 0);
+  }
+
+ private:
+  uint32_t fPrecision;
+  std::vector<uint8_t> fRegisters;
+};
+
+}  // namespace statistics
@@ -0,0 +1,469 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+// 256-bit SimdFilterProcessor family. The header is a no-op unless the translation unit
+// is compiled with -mavx2 or includes it inside an AVX2 target region (MCS_SIMD_TARGET_AVX2, see
+// primitives/linux-port/columnfiltering.h), so only the translation units that are dispatched to
+// at runtime (see simd_dispatch.h) get these classes. The processors follow the 128-bit contract:
+// MaskType is a byte mask vector where every lane is either all zeros or all ones.
+
+#include "simd_sse.h"
+
+#if defined(__x86_64__) && \
+    (defined(__AVX2__) || defined(MCS_SIMD_TARGET_AVX2) || defined(MCS_SIMD_TARGET_AVX512))
+
+#define MCS_HAVE_SIMD256 1
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <immintrin.h>
+
+#include <mcs_datatype.h>
+
+namespace simd
+{
+using vi256_t = __m256i;
+using vi256f_t = __m256;
+using vi256d_t = __m256d;
+using MT256 = uint32_t;
+
+// These ugly wrappers are used to allow to use __m256* as template class parameter argument
+struct vi256_wr
+{
+  __m256i v;
+};
+
+struct vi256f_wr
+{
+  __m256 v;
+};
+
+struct vi256d_wr
+{
+  __m256d v;
+};
+
+// Maps float/double to the vector type. std::conditional would drop the may_alias attribute.
+template <typename T>
+struct FloatToVi256;
+
+template <>
+struct FloatToVi256<double>
+{
+  using type = vi256d_t;
+};
+
+template <>
+struct FloatToVi256<float>
+{
+  using type = vi256f_t;
+};
+
+template <typename T, ENUM_KIND KIND, typename ENABLE = void>
+struct IntegralToSIMD256;
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD256<T, KIND,
+                         typename std::enable_if<KIND == KIND_FLOAT && sizeof(double) == sizeof(T)>::type>
+{
+  using type = vi256d_wr;
+};
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD256<T, KIND,
+                         typename std::enable_if<KIND == KIND_FLOAT && sizeof(float) == sizeof(T)>::type>
+{
+  using type = vi256f_wr;
+};
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD256<T, KIND, typename std::enable_if<KIND != KIND_FLOAT>::type>
+{
+  using type = vi256_wr;
+};
+
+// Integral types of all widths up to 8 bytes share one class. AVX2 has no unsigned
+// comparisons so unsigned lanes are compared as signed after the sign bit is flipped.
+template <typename VT, typename CHECK_T>
+class SimdFilterProcessor<
+    VT, CHECK_T,
+    typename std::enable_if<std::is_same<VT, vi256_wr>::value && std::is_integral<CHECK_T>::value &&
+                            sizeof(CHECK_T) <= sizeof(int64_t)>::type>
+{
+ public:
+  constexpr static const uint16_t vecByteSize = 32U;
+  constexpr static const uint16_t vecBitSize = 256U;
+  using T = typename datatypes::WidthToSIntegralType<sizeof(CHECK_T)>::type;
+  using SimdWrapperType = vi256_wr;
+  using SimdType = vi256_t;
+  using FilterType = T;
+  using StorageType = T;
+  using MaskType = vi256_t;
+  constexpr static const uint16_t FilterMaskStep = sizeof(T);
+  constexpr static const bool isUnsigned = std::is_unsigned<CHECK_T>::value;
+
+  // Expands a byte mask, e.g. AUX column empty flags, to the lanes of T width.
+  MCS_FORCE_INLINE MaskType maskCtor(const char* inputArray)
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm256_loadu_si256(reinterpret_cast<const SimdType*>(inputArray));
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(inputArray)));
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(inputArray)));
+    else
+      return _mm256_cvtepi8_epi64(_mm_cvtsi32_si128(*reinterpret_cast<const int32_t*>(inputArray)));
+  }
+
+  // Load value
+  MCS_FORCE_INLINE SimdType emptyNullLoadValue(const T fill)
+  {
+    return loadValue(fill);
+  }
+
+  MCS_FORCE_INLINE SimdType loadValue(const T fill) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm256_set1_epi8(fill);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm256_set1_epi16(fill);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm256_set1_epi32(fill);
+    else
+      return _mm256_set1_epi64x(fill);
+  }
+
+  // Load from
+  MCS_FORCE_INLINE SimdType loadFrom(const char* from)
+  {
+    return _mm256_loadu_si256(reinterpret_cast<const SimdType*>(from));
+  }
+
+  // Compare
+  MCS_FORCE_INLINE MaskType cmpEq(SimdType x, SimdType y) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm256_cmpeq_epi8(x, y);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm256_cmpeq_epi16(x, y);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm256_cmpeq_epi32(x, y);
+    else
+      return _mm256_cmpeq_epi64(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGt(SimdType x, SimdType y) const
+  {
+    if constexpr (isUnsigned)
+    {
+      const SimdType signVec = loadValue(std::numeric_limits<T>::min());
+      x = _mm256_xor_si256(x, signVec);
+      y = _mm256_xor_si256(y, signVec);
+    }
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm256_cmpgt_epi8(x, y);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm256_cmpgt_epi16(x, y);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm256_cmpgt_epi32(x, y);
+    else
+      return _mm256_cmpgt_epi64(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGe(SimdType x, SimdType y) const
+  {
+    return cmpGt(y, x) ^ trueMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLe(SimdType x, SimdType y) const
+  {
+    return cmpGt(x, y) ^ trueMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLt(SimdType x, SimdType y) const
+  {
+    return cmpGt(y, x);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpNe(SimdType x, SimdType y) const
+  {
+    return cmpEq(x, y) ^ trueMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysFalse(SimdType x, SimdType y) const
+  {
+    return falseMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysTrue(SimdType x, SimdType y) const
+  {
+    return trueMask();
+  }
+
+  // misc
+  MCS_FORCE_INLINE MT256 convertVectorToBitMask(SimdType vmask) const
+  {
+    return _mm256_movemask_epi8(vmask);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(SimdType x, SimdType y) const
+  {
+    return cmpNe(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpEq(SimdType x, SimdType y) const
+  {
+    return cmpEq(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType setToZero() const
+  {
+    return _mm256_setzero_si256();
+  }
+
+  // store
+  MCS_FORCE_INLINE void store(char* dst, SimdType x)
+  {
+    _mm256_storeu_si256(reinterpret_cast<SimdType*>(dst), x);
+  }
+
+  MCS_FORCE_INLINE SimdType blend(SimdType x, SimdType y, SimdType mask) const
+  {
+    return _mm256_blendv_epi8(x, y, mask);
+  }
+
+  MCS_FORCE_INLINE SimdType bwAnd(SimdType x, SimdType y) const
+  {
+    return _mm256_and_si256(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType cmpGtSimdType(SimdType x, SimdType y) const
+  {
+    return cmpGt(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType min(SimdType x, SimdType y) const
+  {
+    return blend(x, y, cmpGt(x, y));
+  }
+
+  MCS_FORCE_INLINE SimdType max(SimdType x, SimdType y) const
+  {
+    return blend(x, y, cmpGt(y, x));
+  }
+
+  MCS_FORCE_INLINE MaskType falseMask() const
+  {
+    return _mm256_setzero_si256();
+  }
+
+  MCS_FORCE_INLINE MaskType trueMask() const
+  {
+    return _mm256_set1_epi64x(0xFFFFFFFFFFFFFFFFLL);
+  }
+};
+
+// float and double lanes. The predicates match the 128-bit SSE ones, e.g. cmpNe is unordered.
+template <typename VT, typename T>
+class SimdFilterProcessor<
+    VT, T,
+    typename std::enable_if<(std::is_same<VT, vi256d_wr>::value && std::is_same<T, double>::value) ||
+                            (std::is_same<VT, vi256f_wr>::value && std::is_same<T, float>::value)>::type>
+{
+ public:
+  constexpr static const uint16_t vecByteSize = 32U;
+  constexpr static const uint16_t vecBitSize = 256U;
+  constexpr static const bool isDouble = std::is_same<T, double>::value;
+  using FilterType = T;
+  using NullEmptySimdType = vi256_t;
+  using SimdWrapperType = VT;
+  using SimdType = typename FloatToVi256<T>::type;
+  using StorageSimdType = vi256_t;
+  using StorageType = typename datatypes::WidthToSIntegralType<sizeof(T)>::type;
+  using MaskType = vi256_t;
+  using StorageVecProcType = SimdFilterProcessor<vi256_wr, StorageType>;
+  constexpr static const uint16_t FilterMaskStep = sizeof(T);
+
+  MCS_FORCE_INLINE MaskType maskCtor(const char* inputArray)
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.maskCtor(inputArray);
+  }
+
+  // Load value
+  MCS_FORCE_INLINE SimdType emptyNullLoadValue(const T fill)
+  {
+    StorageVecProcType nullEmptyProcessor;
+    // This spec borrows the expr from the integral processor of the same width.
+    return (SimdType)nullEmptyProcessor.loadValue(*reinterpret_cast<const StorageType*>(&fill));
+  }
+
+  MCS_FORCE_INLINE SimdType loadValue(const T fill) const
+  {
+    if constexpr (isDouble)
+      return _mm256_set1_pd(fill);
+    else
+      return _mm256_set1_ps(fill);
+  }
+
+  // Load from
+  MCS_FORCE_INLINE SimdType loadFrom(const char* from)
+  {
+    if constexpr (isDouble)
+      return _mm256_loadu_pd(reinterpret_cast<const T*>(from));
+    else
+      return _mm256_loadu_ps(reinterpret_cast<const T*>(from));
+  }
+
+  template <int PREDICATE>
+  MCS_FORCE_INLINE MaskType cmp(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return (MaskType)_mm256_cmp_pd(x, y, PREDICATE);
+    else
+      return (MaskType)_mm256_cmp_ps(x, y, PREDICATE);
+  }
+
+  // Compare
+  MCS_FORCE_INLINE MaskType cmpEq(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_EQ_OQ>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_GE_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGt(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_GT_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_LE_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLt(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_LT_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpNe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_NEQ_UQ>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysFalse(SimdType x, SimdType y) const
+  {
+    return falseMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysTrue(SimdType x, SimdType y) const
+  {
+    return trueMask();
+  }
+
+  // misc
+  MCS_FORCE_INLINE MT256 convertVectorToBitMask(SimdType vmask) const
+  {
+    if constexpr (isDouble)
+      return _mm256_movemask_pd(vmask);
+    else
+      return _mm256_movemask_ps(vmask);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(SimdType x, SimdType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.cmpNe((NullEmptySimdType)x, (NullEmptySimdType)y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(MaskType x, MaskType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.cmpNe(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpEq(SimdType x, SimdType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.cmpEq((NullEmptySimdType)x, (NullEmptySimdType)y);
+  }
+
+  MCS_FORCE_INLINE SimdType setToZero() const
+  {
+    return (SimdType)_mm256_setzero_si256();
+  }
+
+  MCS_FORCE_INLINE void store(char* dst, SimdType x)
+  {
+    _mm256_storeu_si256(reinterpret_cast<vi256_t*>(dst), (vi256_t)x);
+  }
+
+  MCS_FORCE_INLINE SimdType min(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm256_min_pd(x, y);
+    else
+      return _mm256_min_ps(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType max(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm256_max_pd(x, y);
+    else
+      return _mm256_max_ps(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType blend(SimdType x, SimdType y, SimdType mask) const
+  {
+    if constexpr (isDouble)
+      return _mm256_blendv_pd(x, y, mask);
+    else
+      return _mm256_blendv_ps(x, y, mask);
+  }
+
+  MCS_FORCE_INLINE SimdType cmpGtSimdType(SimdType x, SimdType y) const
+  {
+    return (SimdType)cmpGt(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType bwAnd(SimdType x, SimdType y) const
+  {
+    return (SimdType)_mm256_and_si256((vi256_t)x, (vi256_t)y);
+  }
+
+  MCS_FORCE_INLINE MaskType falseMask() const
+  {
+    return _mm256_setzero_si256();
+  }
+
+  MCS_FORCE_INLINE MaskType trueMask() const
+  {
+    return _mm256_set1_epi64x(0xFFFFFFFFFFFFFFFFLL);
+  }
+};
+
+}  // namespace simd
+
+#endif  // AVX2
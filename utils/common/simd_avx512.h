@@ -0,0 +1,503 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+// 512-bit SimdFilterProcessor family that needs AVX-512 F, BW and DQ. The header is a no-op
+// unless the translation unit is compiled with the corresponding -mavx512* flags or includes it
+// inside an AVX-512 target region (MCS_SIMD_TARGET_AVX512).
+// AVX-512 compares natively produce k-masks for every predicate, signed and unsigned. The masks
+// are widened back into byte mask vectors with vpmovm2* to keep the 128-bit processor contract
+// that column.cpp relies on.
+
+#include "simd_sse.h"
+
+#if defined(__x86_64__) && \
+    ((defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__)) || defined(MCS_SIMD_TARGET_AVX512))
+
+#define MCS_HAVE_SIMD512 1
+
+#include <cstdint>
+#include <type_traits>
+#include <immintrin.h>
+
+#include <mcs_datatype.h>
+
+namespace simd
+{
+using vi512_t = __m512i;
+using vi512f_t = __m512;
+using vi512d_t = __m512d;
+using MT512 = uint64_t;
+
+// These ugly wrappers are used to allow to use __m512* as template class parameter argument
+struct vi512_wr
+{
+  __m512i v;
+};
+
+struct vi512f_wr
+{
+  __m512 v;
+};
+
+struct vi512d_wr
+{
+  __m512d v;
+};
+
+// Maps float/double to the vector type. std::conditional would drop the may_alias attribute.
+template <typename T>
+struct FloatToVi512;
+
+template <>
+struct FloatToVi512<double>
+{
+  using type = vi512d_t;
+};
+
+template <>
+struct FloatToVi512<float>
+{
+  using type = vi512f_t;
+};
+
+template <typename T, ENUM_KIND KIND, typename ENABLE = void>
+struct IntegralToSIMD512;
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD512<T, KIND,
+                         typename std::enable_if<KIND == KIND_FLOAT && sizeof(double) == sizeof(T)>::type>
+{
+  using type = vi512d_wr;
+};
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD512<T, KIND,
+                         typename std::enable_if<KIND == KIND_FLOAT && sizeof(float) == sizeof(T)>::type>
+{
+  using type = vi512f_wr;
+};
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD512<T, KIND, typename std::enable_if<KIND != KIND_FLOAT>::type>
+{
+  using type = vi512_wr;
+};
+
+// k-mask <-> byte mask vector conversions for the lane width W.
+template <int W>
+MCS_FORCE_INLINE vi512_t kMaskToVector(uint64_t k)
+{
+  if constexpr (W == 1)
+    return _mm512_movm_epi8(k);
+  else if constexpr (W == 2)
+    return _mm512_movm_epi16(static_cast<__mmask32>(k));
+  else if constexpr (W == 4)
+    return _mm512_movm_epi32(static_cast<__mmask16>(k));
+  else
+    return _mm512_movm_epi64(static_cast<__mmask8>(k));
+}
+
+template <int W>
+MCS_FORCE_INLINE uint64_t vectorToKMask(vi512_t v)
+{
+  if constexpr (W == 1)
+    return _mm512_movepi8_mask(v);
+  else if constexpr (W == 2)
+    return _mm512_movepi16_mask(v);
+  else if constexpr (W == 4)
+    return _mm512_movepi32_mask(v);
+  else
+    return _mm512_movepi64_mask(v);
+}
+
+// Integral types of all widths up to 8 bytes share one class.
+template <typename VT, typename CHECK_T>
+class SimdFilterProcessor<
+    VT, CHECK_T,
+    typename std::enable_if<std::is_same<VT, vi512_wr>::value && std::is_integral<CHECK_T>::value &&
+                            sizeof(CHECK_T) <= sizeof(int64_t)>::type>
+{
+ public:
+  constexpr static const uint16_t vecByteSize = 64U;
+  constexpr static const uint16_t vecBitSize = 512U;
+  using T = typename datatypes::WidthToSIntegralType<sizeof(CHECK_T)>::type;
+  using SimdWrapperType = vi512_wr;
+  using SimdType = vi512_t;
+  using FilterType = T;
+  using StorageType = T;
+  using MaskType = vi512_t;
+  constexpr static const uint16_t FilterMaskStep = sizeof(T);
+  constexpr static const bool isUnsigned = std::is_unsigned<CHECK_T>::value;
+
+  // Expands a byte mask, e.g. AUX column empty flags, to the lanes of T width.
+  MCS_FORCE_INLINE MaskType maskCtor(const char* inputArray)
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm512_loadu_si512(inputArray);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputArray)));
+    // The zero-masking forms avoid the _mm512_undefined_epi32() passthrough that GCC reports
+    // as -Wmaybe-uninitialized once inlined.
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm512_maskz_cvtepi8_epi32(0xFFFF,
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(inputArray)));
+    else
+      return _mm512_maskz_cvtepi8_epi64(0xFF, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(inputArray)));
+  }
+
+  // Load value
+  MCS_FORCE_INLINE SimdType emptyNullLoadValue(const T fill)
+  {
+    return loadValue(fill);
+  }
+
+  MCS_FORCE_INLINE SimdType loadValue(const T fill) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm512_set1_epi8(fill);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm512_set1_epi16(fill);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm512_set1_epi32(fill);
+    else
+      return _mm512_set1_epi64(fill);
+  }
+
+  // Load from
+  MCS_FORCE_INLINE SimdType loadFrom(const char* from)
+  {
+    return _mm512_loadu_si512(from);
+  }
+
+  template <int PREDICATE>
+  MCS_FORCE_INLINE uint64_t cmpToKMask(SimdType x, SimdType y) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return isUnsigned ? _mm512_cmp_epu8_mask(x, y, PREDICATE) : _mm512_cmp_epi8_mask(x, y, PREDICATE);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return isUnsigned ? _mm512_cmp_epu16_mask(x, y, PREDICATE) : _mm512_cmp_epi16_mask(x, y, PREDICATE);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return isUnsigned ? _mm512_cmp_epu32_mask(x, y, PREDICATE) : _mm512_cmp_epi32_mask(x, y, PREDICATE);
+    else
+      return isUnsigned ? _mm512_cmp_epu64_mask(x, y, PREDICATE) : _mm512_cmp_epi64_mask(x, y, PREDICATE);
+  }
+
+  template <int PREDICATE>
+  MCS_FORCE_INLINE MaskType cmp(SimdType x, SimdType y) const
+  {
+    return kMaskToVector<sizeof(T)>(cmpToKMask<PREDICATE>(x, y));
+  }
+
+  // Compare
+  MCS_FORCE_INLINE MaskType cmpEq(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_EQ>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGe(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_NLT>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGt(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_NLE>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLe(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_LE>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLt(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_LT>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpNe(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_NE>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysFalse(SimdType x, SimdType y) const
+  {
+    return falseMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysTrue(SimdType x, SimdType y) const
+  {
+    return trueMask();
+  }
+
+  // permute
+  // _mm512_permutexvar_epi8 needs AVX512VBMI that isn't a part of the baseline for this family.
+
+  // misc
+  MCS_FORCE_INLINE MT512 convertVectorToBitMask(SimdType vmask) const
+  {
+    return _mm512_movepi8_mask(vmask);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(SimdType x, SimdType y) const
+  {
+    return cmpNe(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpEq(SimdType x, SimdType y) const
+  {
+    return cmpEq(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType setToZero() const
+  {
+    return _mm512_setzero_si512();
+  }
+
+  // store
+  MCS_FORCE_INLINE void storeWMask(SimdType x, SimdType vmask, char* dst)
+  {
+    _mm512_mask_storeu_epi8(dst, _mm512_movepi8_mask(vmask), x);
+  }
+
+  MCS_FORCE_INLINE void store(char* dst, SimdType x)
+  {
+    _mm512_storeu_si512(dst, x);
+  }
+
+  MCS_FORCE_INLINE SimdType blend(SimdType x, SimdType y, SimdType mask) const
+  {
+    return _mm512_mask_blend_epi8(_mm512_movepi8_mask(mask), x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType bwAnd(SimdType x, SimdType y) const
+  {
+    return _mm512_and_si512(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType cmpGtSimdType(SimdType x, SimdType y) const
+  {
+    return cmpGt(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType min(SimdType x, SimdType y) const
+  {
+    return blend(x, y, cmpGt(x, y));
+  }
+
+  MCS_FORCE_INLINE SimdType max(SimdType x, SimdType y) const
+  {
+    return blend(x, y, cmpGt(y, x));
+  }
+
+  MCS_FORCE_INLINE MaskType falseMask() const
+  {
+    return _mm512_setzero_si512();
+  }
+
+  MCS_FORCE_INLINE MaskType trueMask() const
+  {
+    return _mm512_set1_epi64(0xFFFFFFFFFFFFFFFFLL);
+  }
+};
+
+// float and double lanes. The predicates match the 128-bit SSE ones, e.g. cmpNe is unordered.
+template <typename VT, typename T>
+class SimdFilterProcessor<
+    VT, T,
+    typename std::enable_if<(std::is_same<VT, vi512d_wr>::value && std::is_same<T, double>::value) ||
+                            (std::is_same<VT, vi512f_wr>::value && std::is_same<T, float>::value)>::type>
+{
+ public:
+  constexpr static const uint16_t vecByteSize = 64U;
+  constexpr static const uint16_t vecBitSize = 512U;
+  constexpr static const bool isDouble = std::is_same<T, double>::value;
+  using FilterType = T;
+  using NullEmptySimdType = vi512_t;
+  using SimdWrapperType = VT;
+  using SimdType = typename FloatToVi512<T>::type;
+  using StorageSimdType = vi512_t;
+  using StorageType = typename datatypes::WidthToSIntegralType<sizeof(T)>::type;
+  using MaskType = vi512_t;
+  using StorageVecProcType = SimdFilterProcessor<vi512_wr, StorageType>;
+  constexpr static const uint16_t FilterMaskStep = sizeof(T);
+
+  MCS_FORCE_INLINE MaskType maskCtor(const char* inputArray)
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.maskCtor(inputArray);
+  }
+
+  // Load value
+  MCS_FORCE_INLINE SimdType emptyNullLoadValue(const T fill)
+  {
+    StorageVecProcType nullEmptyProcessor;
+    // This spec borrows the expr from the integral processor of the same width.
+    return (SimdType)nullEmptyProcessor.loadValue(*reinterpret_cast<const StorageType*>(&fill));
+  }
+
+  MCS_FORCE_INLINE SimdType loadValue(const T fill) const
+  {
+    if constexpr (isDouble)
+      return _mm512_set1_pd(fill);
+    else
+      return _mm512_set1_ps(fill);
+  }
+
+  // Load from
+  MCS_FORCE_INLINE SimdType loadFrom(const char* from)
+  {
+    if constexpr (isDouble)
+      return _mm512_loadu_pd(from);
+    else
+      return _mm512_loadu_ps(from);
+  }
+
+  template <int PREDICATE>
+  MCS_FORCE_INLINE MaskType cmp(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return kMaskToVector<sizeof(T)>(_mm512_cmp_pd_mask(x, y, PREDICATE));
+    else
+      return kMaskToVector<sizeof(T)>(_mm512_cmp_ps_mask(x, y, PREDICATE));
+  }
+
+  // Compare
+  MCS_FORCE_INLINE MaskType cmpEq(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_EQ_OQ>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_GE_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGt(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_GT_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_LE_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLt(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_LT_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpNe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_NEQ_UQ>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysFalse(SimdType x, SimdType y) const
+  {
+    return falseMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysTrue(SimdType x, SimdType y) const
+  {
+    return trueMask();
+  }
+
+  // misc
+  MCS_FORCE_INLINE MT512 convertVectorToBitMask(SimdType vmask) const
+  {
+    return vectorToKMask<sizeof(T)>((vi512_t)vmask);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(SimdType x, SimdType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.cmpNe((NullEmptySimdType)x, (NullEmptySimdType)y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(MaskType x, MaskType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.cmpNe(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpEq(SimdType x, SimdType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.cmpEq((NullEmptySimdType)x, (NullEmptySimdType)y);
+  }
+
+  MCS_FORCE_INLINE SimdType setToZero() const
+  {
+    return (SimdType)_mm512_setzero_si512();
+  }
+
+  MCS_FORCE_INLINE void store(char* dst, SimdType x)
+  {
+    _mm512_storeu_si512(dst, (vi512_t)x);
+  }
+
+  MCS_FORCE_INLINE SimdType min(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm512_min_pd(x, y);
+    else
+      return _mm512_min_ps(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType max(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm512_max_pd(x, y);
+    else
+      return _mm512_max_ps(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType blend(SimdType x, SimdType y, SimdType mask) const
+  {
+    const uint64_t k = vectorToKMask<sizeof(T)>((vi512_t)mask);
+    if constexpr (isDouble)
+      return _mm512_mask_blend_pd(static_cast<__mmask8>(k), x, y);
+    else
+      return _mm512_mask_blend_ps(static_cast<__mmask16>(k), x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType cmpGtSimdType(SimdType x, SimdType y) const
+  {
+    return (SimdType)cmpGt(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType bwAnd(SimdType x, SimdType y) const
+  {
+    return (SimdType)_mm512_and_si512((vi512_t)x, (vi512_t)y);
+  }
+
+  MCS_FORCE_INLINE MaskType falseMask() const
+  {
+    return _mm512_setzero_si512();
+  }
+
+  MCS_FORCE_INLINE MaskType trueMask() const
+  {
+    return _mm512_set1_epi64(0xFFFFFFFFFFFFFFFFLL);
+  }
+};
+
+}  // namespace simd
+
+#endif  // AVX-512 F+BW+DQ
@@ -0,0 +1,81 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <atomic>
+#include "simd_dispatch.h"
+
+namespace
+{
+simd::SimdLevel probeSimdLevel()
+{
+#if defined(__x86_64__)
+  // libgcc checks XCR0 along with the CPUID bits so the OS must have enabled
+  // the AVX/AVX-512 register state for these to return true.
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512dq"))
+    return simd::SimdLevel::SIMD512;
+  if (__builtin_cpu_supports("avx2"))
+    return simd::SimdLevel::SIMD256;
+#endif
+  return simd::SimdLevel::SIMD128;
+}
+
+std::atomic<simd::SimdLevel> currentSimdLevel{simd::detectSimdLevel()};
+}  // namespace
+
+namespace simd
+{
+SimdLevel detectSimdLevel()
+{
+  static const SimdLevel detected = probeSimdLevel();
+  return detected;
+}
+
+SimdLevel getSimdLevel()
+{
+  return currentSimdLevel.load(std::memory_order_relaxed);
+}
+
+SimdLevel setSimdLevel(SimdLevel level)
+{
+  if (level > detectSimdLevel())
+    level = detectSimdLevel();
+  currentSimdLevel.store(level, std::memory_order_relaxed);
+  return level;
+}
+
+SimdLevel simdLevelFromBits(uint32_t bits)
+{
+  switch (bits)
+  {
+    case 512: return SimdLevel::SIMD512;
+    case 256: return SimdLevel::SIMD256;
+    default: return SimdLevel::SIMD128;
+  }
+}
+
+uint32_t simdLevelToBits(SimdLevel level)
+{
+  switch (level)
+  {
+    case SimdLevel::SIMD512: return 512;
+    case SimdLevel::SIMD256: return 256;
+    default: return 128;
+  }
+}
+}  // namespace simd
@@ -0,0 +1,47 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <cstdint>
+
+namespace simd
+{
+// The widest SimdFilterProcessor family the vectorized code paths are allowed to use.
+// SIMD128 is SSE4.2 on x86_64 and Advanced SIMD on aarch64, SIMD256 needs AVX2 and
+// SIMD512 needs AVX-512 F, BW and DQ.
+enum class SimdLevel : uint8_t
+{
+  SIMD128 = 0,
+  SIMD256 = 1,
+  SIMD512 = 2
+};
+
+// Probes CPUID (and the OS support for the extended register state) once.
+SimdLevel detectSimdLevel();
+
+// The level that is currently in effect. It defaults to the detected one.
+SimdLevel getSimdLevel();
+
+// Caps the level, e.g. from the config at PrimProc startup. Levels the CPU doesn't support
+// are clamped to the detected one. Returns the level that is in effect after the call.
+SimdLevel setSimdLevel(SimdLevel level);
+
+// 128, 256 or 512. Any other value of bits maps onto SIMD128.
+SimdLevel simdLevelFromBits(uint32_t bits);
+uint32_t simdLevelToBits(SimdLevel level);
+}  // namespace simd
@@ -15,8 +15,10 @@
    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
    MA 02110-1301, USA. */
 
+#include <algorithm>
 #include <iostream>
 #include <atomic>
+#include <limits>
 #include <boost/filesystem.hpp>
 
 #include "IDBPolicy.h"
@@ -46,11 +48,18 @@ void StatisticsManager::collectSample(const rowgroup::RowGroup& rowGroup)
     return;
 
   const auto& oids = rowGroup.getOIDs();
-  for (const auto oid : oids)
+  const auto& colTypes = rowGroup.getColTypes();
+  for (uint32_t j = 0; j < columnCount; ++j)
   {
+    const auto oid = oids[j];
     // Initialize a column data with 0.
     if (!columnGroups.count(oid))
+    {
       columnGroups[oid] = std::vector<uint64_t>(maxSampleSize, 0);
+      sampleNulls[oid] = std::vector<uint8_t>(maxSampleSize, 1);
+    }
+    if (datatypes::isUnsigned(colTypes[j]))
+      unsignedColumns.insert(oid);
   }
 
   // Initialize a first row from the given `rowGroup`.
@@ -58,28 +67,44 @@ void StatisticsManager::collectSample(const rowgroup::RowGroup& rowGroup)
   rowGroup.initRow(&r);
   rowGroup.getRow(0, &r);
 
+  // Unsigned values are kept zero extended, so they sort and compare like the filter values do.
+  auto getValue = [&](uint32_t j) -> uint64_t
+  { return datatypes::isUnsigned(colTypes[j]) ? r.getUintField(j) : r.getIntField(j); };
+
   // Generate a uniform distribution.
   for (uint32_t i = 0; i < rowCount; ++i)
   {
+    int64_t index = -1;
     if (currentSampleSize < maxSampleSize)
+      index = currentSampleSize++;
+    else
     {
-      for (uint32_t j = 0; j < columnCount; ++j)
-      {
-        if (!r.isNullValue(j))
-          columnGroups[oids[j]][currentSampleSize] = r.getIntField(j);
-      }
-      ++currentSampleSize;
+      const uint32_t candidate = uniformDistribution(gen32);
+      if (candidate < maxSampleSize)
+        index = candidate;
     }
-    else
+
+    for (uint32_t j = 0; j < columnCount; ++j)
     {
-      const uint32_t index = uniformDistribution(gen32);
-      if (index < maxSampleSize)
+      const auto oid = oids[j];
+      if (r.isNullValue(j))
+      {
+        ++nullCounts[oid];
+        if (index >= 0)
+          sampleNulls[oid][index] = 1;
+        continue;
+      }
+
+      const uint64_t value = getValue(j);
+      // The distinct values are counted over all the rows, not only the sampled ones.
+      ndvSketches[oid].add(value);
+      if (index >= 0)
       {
-        for (uint32_t j = 0; j < columnCount; ++j)
-          if (!r.isNullValue(j))
-            columnGroups[oids[j]][index] = r.getIntField(j);
+        columnGroups[oid][index] = value;
+        sampleNulls[oid][index] = 0;
       }
     }
+    ++rowsSeen;
     r.nextRow();
   }
 }
@@ -95,11 +120,18 @@ void StatisticsManager::analyzeSample(bool traceOn)
 
   for (const auto& [oid, sample] : columnGroups)
   {
+    const auto& nulls = sampleNulls[oid];
     std::unordered_set<uint32_t> columnsCache;
     std::unordered_map<uint64_t, uint32_t> columnMCV;
+    std::vector<uint64_t> values;
+    values.reserve(currentSampleSize);
     for (uint32_t i = 0; i < currentSampleSize; ++i)
     {
+      if (nulls[i])
+        continue;
+
       const auto value = sample[i];
+      values.push_back(value);
       // PK_FK statistics.
       if (columnsCache.count(value) && keyTypes[oid] == KeyType::PK)
         keyTypes[oid] = KeyType::FK;
@@ -123,6 +155,23 @@ void StatisticsManager::analyzeSample(bool traceOn)
     // 200 buckets as Microsoft does.
     const auto mcvSize = std::min(columnMCV.size(), static_cast<uint64_t>(200));
     mcv[oid] = std::unordered_map<uint64_t, uint32_t>(mcvList.begin(), mcvList.begin() + mcvSize);
+
+    // HISTOGRAM statistics.
+    Histogram& histogram = histograms[oid];
+    histogram.isUnsigned = unsignedColumns.count(oid) > 0;
+    if (histogram.isUnsigned)
+      std::sort(values.begin(), values.end());
+    else
+      std::sort(values.begin(), values.end(),
+                [](uint64_t a, uint64_t b) { return static_cast<int64_t>(a) < static_cast<int64_t>(b); });
+    histogram.build(values, maxHistogramBuckets);
+    histogram.rowCount = rowsSeen;
+    histogram.nullFraction = rowsSeen ? static_cast<double>(nullCounts[oid]) / rowsSeen : 0;
+
+    // NDV statistics.  The sketch is an estimate, it can't be less than what the sample has.
+    auto sketch = ndvSketches.find(oid);
+    const uint64_t sketchNDV = sketch != ndvSketches.end() ? sketch->second.estimate() : 0;
+    ndv[oid] = std::max<uint64_t>(sketchNDV, columnMCV.size());
   }
 
   if (traceOn)
@@ -130,7 +179,12 @@ void StatisticsManager::analyzeSample(bool traceOn)
 
   // Clear sample.
   columnGroups.clear();
+  sampleNulls.clear();
+  ndvSketches.clear();
+  nullCounts.clear();
+  unsignedColumns.clear();
   currentSampleSize = 0;
+  rowsSeen = 0;
 }
 
 void StatisticsManager::output()
@@ -155,6 +209,26 @@ void StatisticsManager::output()
       std::cout << value << ": " << count << ", ";
     cout << "]" << endl;
   }
+
+  std::cout << "Statistics type [HISTOGRAM]: " << std::endl;
+  for (const auto& [oid, histogram] : histograms)
+  {
+    std::cout << "[OID: " << oid << ", rows: " << histogram.rowCount << ", nulls: " << histogram.nullFraction
+              << std::endl;
+    for (const auto bound : histogram.bounds)
+    {
+      if (histogram.isUnsigned)
+        std::cout << static_cast<uint64_t>(bound) << ", ";
+      else
+        std::cout << bound << ", ";
+    }
+    cout << "]" << endl;
+  }
+
+  std::cout << "Statistics type [NDV]: " << std::endl;
+  for (const auto& [oid, columnNDV] : ndv)
+    std::cout << "[OID: " << oid << ": " << columnNDV << "] ";
+  std::cout << std::endl;
 }
 
 // Someday it will be a virtual method, based on statistics type we processing.
@@ -173,6 +247,17 @@ std::unique_ptr<char[]> StatisticsManager::convertStatsToDataStream(uint64_t& da
         (sizeof(uint32_t) + sizeof(uint32_t) + ((sizeof(uint64_t) + sizeof(uint32_t)) * mcvColumn.size()));
   }
 
+  // count, [oid, is unsigned, row count, null fraction, sample size, bounds count, bounds], ...
+  dataStreamSize += sizeof(uint64_t);
+  for (const auto& [oid, histogram] : histograms)
+  {
+    dataStreamSize += sizeof(uint32_t) * 2 + sizeof(uint64_t) + sizeof(double) + sizeof(uint32_t) * 2 +
+                      sizeof(int64_t) * histogram.bounds.size();
+  }
+
+  // count, [[oid, ndv], ... ]
+  dataStreamSize += sizeof(uint64_t) + ndv.size() * (sizeof(uint32_t) + sizeof(uint64_t));
+
   // Allocate memory for data stream.
   std::unique_ptr<char[]> dataStreamSmartPtr(new char[dataStreamSize]);
   auto* dataStream = dataStreamSmartPtr.get();
@@ -217,10 +302,39 @@ std::unique_ptr<char[]> StatisticsManager::convertStatsToDataStream(uint64_t& da
       offset += sizeof(uint32_t);
     }
   }
+
+  auto put = [&](const auto& field)
+  {
+    std::memcpy(&dataStream[offset], reinterpret_cast<const char*>(&field), sizeof(field));
+    offset += sizeof(field);
+  };
+
+  // For each [oid, is unsigned, row count, null fraction, sample size, bounds count, bounds].
+  put(static_cast<uint64_t>(histograms.size()));
+  for (const auto& [oid, histogram] : histograms)
+  {
+    put(oid);
+    put(static_cast<uint32_t>(histogram.isUnsigned));
+    put(histogram.rowCount);
+    put(histogram.nullFraction);
+    put(histogram.sampleSize);
+    put(static_cast<uint32_t>(histogram.bounds.size()));
+    for (const auto bound : histogram.bounds)
+      put(bound);
+  }
+
+  // For each pair [oid, ndv].
+  put(static_cast<uint64_t>(ndv.size()));
+  for (const auto& [oid, columnNDV] : ndv)
+  {
+    put(oid);
+    put(columnNDV);
+  }
   return dataStreamSmartPtr;
 }
 
-void StatisticsManager::convertStatsFromDataStream(std::unique_ptr<char[]> dataStreamSmartPtr)
+void StatisticsManager::convertStatsFromDataStream(std::unique_ptr<char[]> dataStreamSmartPtr,
+                                                   uint64_t dataStreamSize, uint64_t dataVersion)
 {
   auto* dataStream = dataStreamSmartPtr.get();
   uint64_t count = 0;
@@ -262,6 +376,48 @@ void StatisticsManager::convertStatsFromDataStream(std::unique_ptr<char[]> dataS
     }
     mcv[oid] = std::move(columnMCV);
   }
+
+  // The histograms and NDV came with version 2.
+  if (dataVersion < 2)
+    return;
+
+  auto get = [&](auto& field)
+  {
+    if (offset + sizeof(field) > dataStreamSize)
+      throw ios_base::failure("StatisticsManager::loadFromFile(): truncated data. ");
+    std::memcpy(reinterpret_cast<char*>(&field), &dataStream[offset], sizeof(field));
+    offset += sizeof(field);
+  };
+
+  uint64_t histogramsCount;
+  get(histogramsCount);
+  for (uint64_t i = 0; i < histogramsCount; ++i)
+  {
+    uint32_t oid, isUnsigned, boundsCount;
+    Histogram histogram;
+    get(oid);
+    get(isUnsigned);
+    histogram.isUnsigned = isUnsigned;
+    get(histogram.rowCount);
+    get(histogram.nullFraction);
+    get(histogram.sampleSize);
+    get(boundsCount);
+    histogram.bounds.resize(boundsCount);
+    for (auto& bound : histogram.bounds)
+      get(bound);
+    histograms[oid] = std::move(histogram);
+  }
+
+  uint64_t ndvCount;
+  get(ndvCount);
+  for (uint64_t i = 0; i < ndvCount; ++i)
+  {
+    uint32_t oid;
+    uint64_t columnNDV;
+    get(oid);
+    get(columnNDV);
+    ndv[oid] = columnNDV;
+  }
 }
 
 void StatisticsManager::saveToFile()
@@ -340,8 +496,8 @@ void StatisticsManager::loadFromFile()
   if (size != headerSize)
     throw ios_base::failure("StatisticsManager::loadFromFile(): read failed. ");
 
-  // Initialize fields from the file header.
-  version = fileHeader.version;
+  // Initialize fields from the file header.  The file is rewritten in the current version.
+  const auto dataVersion = fileHeader.version;
   epoch = fileHeader.epoch;
   const auto dataHash = fileHeader.dataHash;
   const auto dataStreamSize = fileHeader.dataSize;
@@ -372,7 +528,7 @@ void StatisticsManager::loadFromFile()
   if (dataHash != computedDataHash)
     throw ios_base::failure("StatisticsManager::loadFromFile(): invalid file hash. ");
 
-  convertStatsFromDataStream(std::move(dataStreamSmartPtr));
+  convertStatsFromDataStream(std::move(dataStreamSmartPtr), dataStreamSize, dataVersion);
 }
 
 uint64_t StatisticsManager::computeHashFromStats()
@@ -409,12 +565,35 @@ void StatisticsManager::serialize(messageqcpp::ByteStream& bs)
       bs << mcvPair.second;
     }
   }
+
+  // HISTOGRAM
+  bs << static_cast<uint64_t>(histograms.size());
+  for (const auto& [oid, histogram] : histograms)
+  {
+    bs << oid;
+    bs << static_cast<uint32_t>(histogram.isUnsigned);
+    bs << histogram.rowCount;
+    bs << histogram.nullFraction;
+    bs << histogram.sampleSize;
+    bs << static_cast<uint32_t>(histogram.bounds.size());
+    for (const auto bound : histogram.bounds)
+      bs << bound;
+  }
+
+  // NDV
+  bs << static_cast<uint64_t>(ndv.size());
+  for (const auto& [oid, columnNDV] : ndv)
+  {
+    bs << oid;
+    bs << columnNDV;
+  }
 }
 
 void StatisticsManager::unserialize(messageqcpp::ByteStream& bs)
 {
   uint64_t count;
-  bs >> version;
+  uint32_t streamVersion;
+  bs >> streamVersion;
   bs >> epoch;
   bs >> count;
 
@@ -446,6 +625,42 @@ void StatisticsManager::unserialize(messageqcpp::ByteStream& bs)
 
     mcv[oid] = std::move(mcvColumn);
   }
+
+  // The histograms and NDV came with version 2.
+  if (streamVersion < 2)
+    return;
+
+  // HISTOGRAM
+  uint64_t histogramsCount;
+  bs >> histogramsCount;
+  for (uint64_t i = 0; i < histogramsCount; ++i)
+  {
+    uint32_t oid, isUnsigned, boundsCount;
+    Histogram histogram;
+    bs >> oid;
+    bs >> isUnsigned;
+    histogram.isUnsigned = isUnsigned;
+    bs >> histogram.rowCount;
+    bs >> histogram.nullFraction;
+    bs >> histogram.sampleSize;
+    bs >> boundsCount;
+    histogram.bounds.resize(boundsCount);
+    for (auto& bound : histogram.bounds)
+      bs >> bound;
+    histograms[oid] = std::move(histogram);
+  }
+
+  // NDV
+  uint64_t ndvCount;
+  bs >> ndvCount;
+  for (uint64_t i = 0; i < ndvCount; ++i)
+  {
+    uint32_t oid;
+    uint64_t columnNDV;
+    bs >> oid;
+    bs >> columnNDV;
+    ndv[oid] = columnNDV;
+  }
 }
 
 bool StatisticsManager::hasKey(uint32_t oid)
@@ -458,6 +673,93 @@ KeyType StatisticsManager::getKeyType(uint32_t oid)
   return keyTypes[oid];
 }
 
+const Histogram* StatisticsManager::getHistogram(uint32_t oid)
+{
+  auto it = histograms.find(oid);
+  return it != histograms.end() ? &it->second : nullptr;
+}
+
+uint64_t StatisticsManager::getNDV(uint32_t oid)
+{
+  auto it = ndv.find(oid);
+  return it != ndv.end() ? it->second : 0;
+}
+
+bool StatisticsManager::estimateEqualFraction(uint32_t oid, int64_t value, double& fraction)
+{
+  const Histogram* histogram = getHistogram(oid);
+  const uint64_t columnNDV = getNDV(oid);
+  if (!histogram || !histogram->sampleSize || !columnNDV)
+    return false;
+
+  static const std::unordered_map<uint64_t, uint32_t> noMCV;
+  auto mcvIt = mcv.find(oid);
+  const auto& columnMCV = mcvIt != mcv.end() ? mcvIt->second : noMCV;
+  auto it = columnMCV.find(value);
+  if (it != columnMCV.end())
+  {
+    fraction = static_cast<double>(it->second) / histogram->sampleSize;
+    return true;
+  }
+
+  // The values not in the MCV list share what the list doesn't cover evenly.
+  uint64_t mcvTotal = 0;
+  for (const auto& mcvPair : columnMCV)
+    mcvTotal += mcvPair.second;
+  const double rest = std::max(0.0, 1.0 - static_cast<double>(mcvTotal) / histogram->sampleSize);
+  const uint64_t others = columnNDV > columnMCV.size() ? columnNDV - columnMCV.size() : 1;
+  fraction = rest / others;
+  return true;
+}
+
+void Histogram::build(const std::vector<uint64_t>& sortedValues, uint32_t maxBuckets)
+{
+  bounds.clear();
+  sampleSize = sortedValues.size();
+  if (sortedValues.empty())
+    return;
+
+  const uint64_t buckets = std::min<uint64_t>(maxBuckets, sortedValues.size());
+  bounds.reserve(buckets + 1);
+  for (uint64_t i = 0; i < buckets; ++i)
+    bounds.push_back(sortedValues[i * sortedValues.size() / buckets]);
+  bounds.push_back(sortedValues.back());
+}
+
+double Histogram::fractionAtMost(int64_t value) const
+{
+  if (bounds.empty() || less(value, bounds.front()))
+    return 0;
+  if (!less(value, bounds.back()))
+    return 1;
+
+  // bounds[i] <= value < bounds[i + 1], a run of equal bounds counts as full buckets.
+  const auto it = std::upper_bound(bounds.begin(), bounds.end(), value,
+                                   [this](int64_t a, int64_t b) { return less(a, b); });
+  const size_t i = (it - bounds.begin()) - 1;
+  auto toDouble = [this](int64_t v)
+  { return isUnsigned ? static_cast<double>(static_cast<uint64_t>(v)) : static_cast<double>(v); };
+  // Values are spread uniformly inside a bucket.
+  const double inBucket =
+      (toDouble(value) - toDouble(bounds[i])) / (toDouble(bounds[i + 1]) - toDouble(bounds[i]));
+  return (i + inBucket) / (bounds.size() - 1);
+}
+
+double Histogram::fractionBelow(int64_t value) const
+{
+  const int64_t domainMin = isUnsigned ? 0 : std::numeric_limits<int64_t>::min();
+  if (value == domainMin)
+    return 0;
+  return fractionAtMost(static_cast<int64_t>(static_cast<uint64_t>(value) - 1));
+}
+
+double Histogram::rangeFraction(int64_t lo, int64_t hi) const
+{
+  if (less(hi, lo))
+    return 0;
+  return std::max(0.0, fractionAtMost(hi) - fractionBelow(lo));
+}
+
 StatisticsDistributor* StatisticsDistributor::instance()
 {
   static StatisticsDistributor* sd = new StatisticsDistributor();
@@ -20,6 +20,7 @@
 #include "rowgroup.h"
 #include "logger.h"
 #include "hasher.h"
+#include "hyperloglog.h"
 #include "IDBPolicy.h"
 
 #include <map>
@@ -53,7 +54,11 @@ enum class StatisticsType : uint32_t
   // A special statistics type, specifies whether a column a primary key or foreign key.
   PK_FK,
   // Most common values.
-  MCV
+  MCV,
+  // Equi-depth histogram.
+  HISTOGRAM,
+  // Number of distinct values.
+  NDV
 };
 
 // Represetns a header for the statistics file.
@@ -66,10 +71,44 @@ struct StatisticsFileHeader
   uint8_t offset[1024];
 };
 
+// Equi-depth histogram of the non null values of a column.
+// The buckets hold the same number of sampled values each, bucket `i` covers the values
+// in (bounds[i], bounds[i + 1]].  Values are compared as unsigned for unsigned columns.
+struct Histogram
+{
+  Histogram() : sampleSize(0), rowCount(0), nullFraction(0), isUnsigned(false)
+  {
+  }
+
+  // Builds the histogram from the sorted sample values.
+  void build(const std::vector<uint64_t>& sortedValues, uint32_t maxBuckets);
+  // Fraction of the non null values that are <= `value`.
+  double fractionAtMost(int64_t value) const;
+  // Fraction of the non null values that are < `value`.
+  double fractionBelow(int64_t value) const;
+  // Fraction of the non null values in [lo, hi].
+  double rangeFraction(int64_t lo, int64_t hi) const;
+  bool less(int64_t a, int64_t b) const
+  {
+    return isUnsigned ? static_cast<uint64_t>(a) < static_cast<uint64_t>(b) : a < b;
+  }
+
+  std::vector<int64_t> bounds;
+  // Number of non null values in the sample.
+  uint32_t sampleSize;
+  // Number of rows of the column when it was analyzed.
+  uint64_t rowCount;
+  // Fraction of the column's rows that are NULL.
+  double nullFraction;
+  bool isUnsigned;
+};
+
 using ColumnsCache = std::unordered_map<uint32_t, std::unordered_set<uint64_t>>;
 using ColumnGroup = std::unordered_map<uint32_t, std::vector<uint64_t>>;
 using KeyTypes = std::unordered_map<uint32_t, KeyType>;
 using MCVList = std::unordered_map<uint32_t, std::unordered_map<uint64_t, uint32_t>>;
+using Histograms = std::unordered_map<uint32_t, Histogram>;
+using NDVList = std::unordered_map<uint32_t, uint64_t>;
 
 // This class is responsible for processing and storing statistics.
 // On each `analyze table` iteration it increases an epoch and stores
@@ -103,9 +142,16 @@ class StatisticsManager
   bool hasKey(uint32_t oid);
   // Returns a KeyType for the given `oid`.
   KeyType getKeyType(uint32_t oid);
+  // Returns the histogram for the given `oid` or nullptr if there is none.
+  const Histogram* getHistogram(uint32_t oid);
+  // Returns the number of distinct values for the given `oid`, 0 if unknown.
+  uint64_t getNDV(uint32_t oid);
+  // Estimates the fraction of the non null values of `oid` equal to `value`, using the MCV list
+  // for the common values and the NDV for the rest.  Returns false if there are no stats for `oid`.
+  bool estimateEqualFraction(uint32_t oid, int64_t value, double& fraction);
 
  private:
-  StatisticsManager() : currentSampleSize(0), epoch(0), version(1)
+  StatisticsManager() : currentSampleSize(0), rowsSeen(0), epoch(0), version(2)
   {
     // Initialize plugins.
     IDBPolicy::configIDBPolicy();
@@ -115,7 +161,8 @@ class StatisticsManager
   }
 
   std::unique_ptr<char[]> convertStatsToDataStream(uint64_t& dataStreamSize);
-  void convertStatsFromDataStream(std::unique_ptr<char[]> dataStreamSmartPtr);
+  void convertStatsFromDataStream(std::unique_ptr<char[]> dataStreamSmartPtr, uint64_t dataStreamSize,
+                                  uint64_t dataVersion);
 
   std::random_device randomDevice;
   std::mt19937 gen32;
@@ -127,10 +174,24 @@ class StatisticsManager
   KeyTypes keyTypes;
   // Internal data for MCV list [OID, list[value, count]]
   MCVList mcv;
+  // Internal data for the histograms [OID, histogram].
+  Histograms histograms;
+  // Internal data for the number of distinct values [OID, NDV].
+  NDVList ndv;
+
+  // Which sampled values are NULL [OID, vector of flags].
+  std::unordered_map<uint32_t, std::vector<uint8_t>> sampleNulls;
+  // Distinct values of all the rows seen, not just the sampled ones [OID, sketch].
+  std::unordered_map<uint32_t, HyperLogLog> ndvSketches;
+  // NULLs among all the rows seen [OID, count].
+  std::unordered_map<uint32_t, uint64_t> nullCounts;
+  std::unordered_set<uint32_t> unsignedColumns;
 
   // TODO: Think about sample size.
   const uint32_t maxSampleSize = 64000;
+  const uint32_t maxHistogramBuckets = 100;
   uint32_t currentSampleSize;
+  uint64_t rowsSeen;
   uint32_t epoch;
   uint32_t version;
 
@@ -0,0 +1,621 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+using namespace std;
+
+#include "columnencoding.h"
+
+namespace
+{
+using compress::ColumnEncoding;
+using execplan::CalpontSystemCatalog;
+
+const uint8_t ENCODED_MAGIC = 0xe7;
+const uint8_t FLAG_SIGNED = 0x01;
+const uint8_t FLAG_ANY_ORDER = 0x02;  // the payload values sort the same signed and unsigned
+const uint32_t GROUP_SIZE = 64;
+
+// the COMPARE_* bits of primitivemsg.h
+const uint8_t COP_LT = 0x01;
+const uint8_t COP_EQ = 0x02;
+const uint8_t COP_GT = 0x04;
+
+struct EncodedHeader
+{
+  uint8_t fMagic;
+  uint8_t fEncoding;
+  uint8_t fWidth;
+  uint8_t fBits;
+  uint8_t fFlags;
+  uint8_t fUnused[3];
+  uint32_t fCount;      // values in the payload
+  uint32_t fTailCount;  // trailing copies of fTailValue
+  uint64_t fTailValue;
+  uint64_t fReference;  // FOR and RLE: the frame minimum, DELTA: the first value
+  uint64_t fExtra;      // DELTA: the smallest difference, RLE: the number of runs
+};
+
+static_assert(sizeof(EncodedHeader) % sizeof(uint64_t) == 0, "the packed words must stay aligned");
+
+uint32_t bitsFor(uint64_t range)
+{
+  return range ? 64 - __builtin_clzll(range) : 0;
+}
+
+uint64_t bitMask(uint32_t bits)
+{
+  return bits == 64 ? numeric_limits<uint64_t>::max() : (1ULL << bits) - 1;
+}
+
+// Words for n values, whole groups so unpackGroup() never reads past the end,
+// plus one for the second word a value straddling the last boundary reads.
+size_t packedWords(size_t n, uint32_t bits)
+{
+  return ((n + GROUP_SIZE - 1) / GROUP_SIZE) * bits + 1;
+}
+
+size_t runEndsBytes(size_t runs)
+{
+  return (runs * sizeof(uint32_t) + 7) & ~(size_t)7;
+}
+
+void pack(uint64_t* words, size_t i, uint64_t v, uint32_t bits)
+{
+  if (bits == 0)
+    return;
+
+  const size_t bitPos = i * bits;
+  const size_t w = bitPos >> 6;
+  const uint32_t s = bitPos & 63;
+  words[w] |= v << s;
+
+  if (s + bits > 64)
+    words[w + 1] |= v >> (64 - s);
+}
+
+// Unpacks the 64 values of the group that starts at words. Branch free so the
+// compiler can vectorize it, the high part of a value that doesn't straddle a
+// word boundary is cut off by the mask.
+void unpackGroup(const uint64_t* words, uint32_t bits, uint64_t* out)
+{
+  if (bits == 0)
+  {
+    std::fill(out, out + GROUP_SIZE, 0);
+    return;
+  }
+
+  const uint64_t mask = bitMask(bits);
+
+  for (uint32_t j = 0; j < GROUP_SIZE; j++)
+  {
+    const uint32_t bitPos = j * bits;
+    const uint32_t w = bitPos >> 6;
+    const uint32_t s = bitPos & 63;
+    out[j] = ((words[w] >> s) | ((words[w + 1] << 1) << (63 - s))) & mask;
+  }
+}
+
+// Extends a value of width bytes held in the low bits of x.
+uint64_t extend(uint64_t x, uint32_t width, bool isSigned)
+{
+  if (width == 8)
+    return x;
+
+  const uint32_t shift = 64 - width * 8;
+  return isSigned ? (uint64_t)((int64_t)(x << shift) >> shift) : (x << shift) >> shift;
+}
+
+// Maps the signed order onto the unsigned one so every comparison is unsigned.
+uint64_t orderKey(uint64_t x, bool isUnsigned)
+{
+  return isUnsigned ? x : x ^ (1ULL << 63);
+}
+
+bool evaluate(uint8_t cop, uint64_t key, uint64_t constantKey)
+{
+  return ((cop & COP_LT) && key < constantKey) || ((cop & COP_EQ) && key == constantKey) ||
+         ((cop & COP_GT) && key > constantKey);
+}
+
+void setBits(uint64_t* matches, size_t from, size_t to)
+{
+  for (; from < to && (from & 63); from++)
+    matches[from >> 6] |= 1ULL << (from & 63);
+
+  for (; from + 64 <= to; from += 64)
+    matches[from >> 6] = numeric_limits<uint64_t>::max();
+
+  for (; from < to; from++)
+    matches[from >> 6] |= 1ULL << (from & 63);
+}
+
+const EncodedHeader* parseHeader(const char* in, size_t inLen)
+{
+  if (inLen < sizeof(EncodedHeader))
+    return nullptr;
+
+  const EncodedHeader* hdr = reinterpret_cast<const EncodedHeader*>(in);
+
+  if (hdr->fMagic != ENCODED_MAGIC || hdr->fBits > 64 ||
+      (hdr->fWidth != 1 && hdr->fWidth != 2 && hdr->fWidth != 4 && hdr->fWidth != 8))
+    return nullptr;
+
+  size_t payload;
+
+  switch (hdr->fEncoding)
+  {
+    case ColumnEncoding::FOR:
+    case ColumnEncoding::DELTA: payload = packedWords(hdr->fCount, hdr->fBits) * sizeof(uint64_t); break;
+
+    case ColumnEncoding::RLE:
+      if (hdr->fExtra > hdr->fCount)
+        return nullptr;
+
+      payload = runEndsBytes(hdr->fExtra) + packedWords(hdr->fExtra, hdr->fBits) * sizeof(uint64_t);
+      break;
+
+    default: return nullptr;
+  }
+
+  return (inLen < sizeof(EncodedHeader) + payload) ? nullptr : hdr;
+}
+
+const uint64_t* packedData(const EncodedHeader* hdr)
+{
+  const char* payload = reinterpret_cast<const char*>(hdr + 1);
+
+  if (hdr->fEncoding == ColumnEncoding::RLE)
+    payload += runEndsBytes(hdr->fExtra);
+
+  return reinterpret_cast<const uint64_t*>(payload);
+}
+
+const uint32_t* runEnds(const EncodedHeader* hdr)
+{
+  return reinterpret_cast<const uint32_t*>(hdr + 1);
+}
+
+template <typename T>
+size_t encodeT(const T* v, size_t n, char* out, size_t outCapacity)
+{
+  using ST = typename make_signed<T>::type;
+  using UT = typename make_unsigned<T>::type;
+
+  // a trailing run of one value, typically the empty values, is kept aside
+  size_t count = n;
+
+  while (count > 0 && v[count - 1] == v[n - 1])
+    count--;
+
+  int64_t sMin = numeric_limits<int64_t>::max(), sMax = numeric_limits<int64_t>::min();
+  uint64_t uMin = numeric_limits<uint64_t>::max(), uMax = 0;
+  size_t runs = 0;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    sMin = min<int64_t>(sMin, (ST)v[i]);
+    sMax = max<int64_t>(sMax, (ST)v[i]);
+    uMin = min<uint64_t>(uMin, (UT)v[i]);
+    uMax = max<uint64_t>(uMax, (UT)v[i]);
+    runs += (i == 0 || v[i] != v[i - 1]);
+  }
+
+  // frame the values in whichever order gives the narrower range
+  const uint64_t sRange = count ? (uint64_t)sMax - (uint64_t)sMin : 0;
+  const uint64_t uRange = count ? uMax - uMin : 0;
+  const bool isSigned = (sRange <= uRange);
+  const uint64_t reference = count ? (isSigned ? (uint64_t)sMin : uMin) : 0;
+  const uint32_t frameBits = bitsFor(isSigned ? sRange : uRange);
+  auto ext = [isSigned](T x) { return isSigned ? (uint64_t)(int64_t)(ST)x : (uint64_t)(UT)x; };
+
+  int64_t dMin = numeric_limits<int64_t>::max(), dMax = numeric_limits<int64_t>::min();
+
+  for (size_t i = 1; i < count; i++)
+  {
+    const int64_t d = (int64_t)(ext(v[i]) - ext(v[i - 1]));
+    dMin = min(dMin, d);
+    dMax = max(dMax, d);
+  }
+
+  const uint32_t deltaBits = (count > 1) ? bitsFor((uint64_t)dMax - (uint64_t)dMin) : 0;
+
+  const size_t forLen = sizeof(EncodedHeader) + packedWords(count, frameBits) * sizeof(uint64_t);
+  const size_t deltaLen = (count > 1)
+                              ? sizeof(EncodedHeader) + packedWords(count, deltaBits) * sizeof(uint64_t)
+                              : numeric_limits<size_t>::max();
+  const size_t rleLen =
+      sizeof(EncodedHeader) + runEndsBytes(runs) + packedWords(runs, frameBits) * sizeof(uint64_t);
+  const size_t encodedLen = min({forLen, deltaLen, rleLen});
+  const size_t inLen = n * sizeof(T);
+
+  if (encodedLen > outCapacity || encodedLen * 4 > inLen * 3)
+    return 0;
+
+  memset(out, 0, encodedLen);
+  EncodedHeader* hdr = reinterpret_cast<EncodedHeader*>(out);
+  hdr->fMagic = ENCODED_MAGIC;
+  hdr->fWidth = sizeof(T);
+  hdr->fFlags = (isSigned ? FLAG_SIGNED : 0) | ((sMin >= 0 || sMax < 0) ? FLAG_ANY_ORDER : 0);
+  hdr->fCount = count;
+  hdr->fTailCount = n - count;
+  hdr->fTailValue = ext(v[n - 1]);
+  hdr->fReference = reference;
+
+  if (encodedLen == forLen)
+  {
+    uint64_t* words = reinterpret_cast<uint64_t*>(hdr + 1);
+    hdr->fEncoding = ColumnEncoding::FOR;
+    hdr->fBits = frameBits;
+
+    for (size_t i = 0; i < count; i++)
+      pack(words, i, ext(v[i]) - reference, frameBits);
+  }
+  else if (encodedLen == rleLen)
+  {
+    uint32_t* ends = reinterpret_cast<uint32_t*>(hdr + 1);
+    uint64_t* words = reinterpret_cast<uint64_t*>(out + sizeof(EncodedHeader) + runEndsBytes(runs));
+    size_t run = 0;
+    hdr->fEncoding = ColumnEncoding::RLE;
+    hdr->fBits = frameBits;
+    hdr->fExtra = runs;
+
+    for (size_t i = 0; i < count; i++)
+    {
+      if (i > 0 && v[i] != v[i - 1])
+        run++;
+
+      ends[run] = i + 1;
+
+      if (i == 0 || v[i] != v[i - 1])
+        pack(words, run, ext(v[i]) - reference, frameBits);
+    }
+  }
+  else
+  {
+    uint64_t* words = reinterpret_cast<uint64_t*>(hdr + 1);
+    hdr->fEncoding = ColumnEncoding::DELTA;
+    hdr->fBits = deltaBits;
+    hdr->fReference = ext(v[0]);
+    hdr->fExtra = (uint64_t)dMin;
+
+    for (size_t i = 1; i < count; i++)
+      pack(words, i, ext(v[i]) - ext(v[i - 1]) - (uint64_t)dMin, deltaBits);
+  }
+
+  return encodedLen;
+}
+
+// Calls f(index, value) for every payload value, in order, value as extended by the encoder.
+template <typename F>
+void forEachValue(const EncodedHeader* hdr, F f)
+{
+  const uint64_t* words = packedData(hdr);
+  uint64_t p[GROUP_SIZE];
+
+  if (hdr->fEncoding == ColumnEncoding::RLE)
+  {
+    const uint32_t* ends = runEnds(hdr);
+    size_t i = 0;
+
+    for (size_t g = 0; g < hdr->fExtra; g += GROUP_SIZE)
+    {
+      unpackGroup(words + (g / GROUP_SIZE) * hdr->fBits, hdr->fBits, p);
+
+      for (size_t r = g; r < min<size_t>(g + GROUP_SIZE, hdr->fExtra); r++)
+        for (const uint64_t value = hdr->fReference + p[r - g]; i < ends[r] && i < hdr->fCount; i++)
+          f(i, value);
+    }
+
+    return;
+  }
+
+  uint64_t prev = hdr->fReference - hdr->fExtra;
+
+  for (size_t g = 0; g < hdr->fCount; g += GROUP_SIZE)
+  {
+    const size_t groupLen = min<size_t>(GROUP_SIZE, hdr->fCount - g);
+    unpackGroup(words + (g / GROUP_SIZE) * hdr->fBits, hdr->fBits, p);
+
+    if (hdr->fEncoding == ColumnEncoding::FOR)
+    {
+      for (size_t j = 0; j < groupLen; j++)
+        f(g + j, hdr->fReference + p[j]);
+    }
+    else
+    {
+      // the first value has no difference, its packed offset is 0
+      for (size_t j = 0; j < groupLen; j++)
+      {
+        prev += hdr->fExtra + p[j];
+        f(g + j, prev);
+      }
+    }
+  }
+}
+
+template <typename T>
+void decodeT(const EncodedHeader* hdr, T* out)
+{
+  forEachValue(hdr, [out](size_t i, uint64_t value) { out[i] = (T)value; });
+  std::fill(out + hdr->fCount, out + hdr->fCount + hdr->fTailCount, (T)hdr->fTailValue);
+}
+
+// Frame of reference values compared in the packed domain: value = reference + p
+// and both are in the frame's order, so value COP constant is p COP (constant - reference).
+void filterFrame(const EncodedHeader* hdr, uint8_t cop, uint64_t referenceKey, uint64_t constantKey,
+                 uint64_t* matches)
+{
+  const uint64_t* words = packedData(hdr);
+  const uint64_t maxOffset = bitMask(hdr->fBits);
+
+  // the constant is outside the frame, every value compares the same
+  if (constantKey < referenceKey || constantKey - referenceKey > maxOffset)
+  {
+    if (evaluate(cop, referenceKey, constantKey))
+      setBits(matches, 0, hdr->fCount);
+
+    return;
+  }
+
+  const uint64_t k = constantKey - referenceKey;
+  const uint64_t lt = (cop & COP_LT) ? 1 : 0;
+  const uint64_t eq = (cop & COP_EQ) ? 1 : 0;
+  const uint64_t gt = (cop & COP_GT) ? 1 : 0;
+  uint64_t p[GROUP_SIZE];
+  uint64_t r[GROUP_SIZE];
+
+  for (size_t g = 0; g < hdr->fCount; g += GROUP_SIZE)
+  {
+    unpackGroup(words + (g / GROUP_SIZE) * hdr->fBits, hdr->fBits, p);
+
+    for (uint32_t j = 0; j < GROUP_SIZE; j++)
+      r[j] = ((p[j] < k) & lt) | ((p[j] == k) & eq) | ((p[j] > k) & gt);
+
+    uint64_t m = 0;
+
+    for (uint32_t j = 0; j < GROUP_SIZE; j++)
+      m |= r[j] << j;
+
+    if (hdr->fCount - g < GROUP_SIZE)
+      m &= bitMask(hdr->fCount - g);
+
+    matches[g / GROUP_SIZE] = m;
+  }
+}
+
+}  // namespace
+
+namespace compress
+{
+bool ColumnEncoding::isEncodable(CalpontSystemCatalog::ColDataType colDataType, uint32_t colWidth)
+{
+  if (colWidth != 1 && colWidth != 2 && colWidth != 4 && colWidth != 8)
+    return false;
+
+  switch (colDataType)
+  {
+    case CalpontSystemCatalog::TINYINT:
+    case CalpontSystemCatalog::SMALLINT:
+    case CalpontSystemCatalog::MEDINT:
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::BIGINT:
+    case CalpontSystemCatalog::UTINYINT:
+    case CalpontSystemCatalog::USMALLINT:
+    case CalpontSystemCatalog::UMEDINT:
+    case CalpontSystemCatalog::UINT:
+    case CalpontSystemCatalog::UBIGINT:
+    case CalpontSystemCatalog::DECIMAL:
+    case CalpontSystemCatalog::UDECIMAL:
+    case CalpontSystemCatalog::DATE:
+    case CalpontSystemCatalog::DATETIME:
+    case CalpontSystemCatalog::TIMESTAMP:
+    case CalpontSystemCatalog::TIME: return true;
+
+    default: return false;
+  }
+}
+
+size_t ColumnEncoding::maxEncodedSize(size_t inLen)
+{
+  // encode() gives up on anything larger than 3/4 of the input
+  return sizeof(EncodedHeader) + inLen;
+}
+
+size_t ColumnEncoding::encode(const char* in, size_t inLen, uint32_t colWidth, char* out, size_t outCapacity)
+{
+  if (inLen == 0 || colWidth == 0 || inLen % colWidth != 0 ||
+      inLen / colWidth > numeric_limits<uint32_t>::max())
+    return 0;
+
+  switch (colWidth)
+  {
+    case 1: return encodeT(reinterpret_cast<const int8_t*>(in), inLen, out, outCapacity);
+    case 2: return encodeT(reinterpret_cast<const int16_t*>(in), inLen / 2, out, outCapacity);
+    case 4: return encodeT(reinterpret_cast<const int32_t*>(in), inLen / 4, out, outCapacity);
+    case 8: return encodeT(reinterpret_cast<const int64_t*>(in), inLen / 8, out, outCapacity);
+    default: return 0;
+  }
+}
+
+int ColumnEncoding::decode(const char* in, size_t inLen, char* out, size_t* outLen)
+{
+  const EncodedHeader* hdr = parseHeader(in, inLen);
+
+  if (!hdr)
+    return -1;
+
+  const size_t len = ((size_t)hdr->fCount + hdr->fTailCount) * hdr->fWidth;
+
+  if (len > *outLen)
+    return -1;
+
+  switch (hdr->fWidth)
+  {
+    case 1: decodeT(hdr, reinterpret_cast<int8_t*>(out)); break;
+    case 2: decodeT(hdr, reinterpret_cast<int16_t*>(out)); break;
+    case 4: decodeT(hdr, reinterpret_cast<int32_t*>(out)); break;
+    default: decodeT(hdr, reinterpret_cast<int64_t*>(out)); break;
+  }
+
+  *outLen = len;
+  return 0;
+}
+
+ColumnEncoding::Type ColumnEncoding::getType(const char* in, size_t inLen)
+{
+  const EncodedHeader* hdr = parseHeader(in, inLen);
+  return hdr ? static_cast<Type>(hdr->fEncoding) : NONE;
+}
+
+uint32_t ColumnEncoding::getWidth(const char* in, size_t inLen)
+{
+  const EncodedHeader* hdr = parseHeader(in, inLen);
+  return hdr ? hdr->fWidth : 0;
+}
+
+bool ColumnEncoding::isSigned(const char* in, size_t inLen)
+{
+  const EncodedHeader* hdr = parseHeader(in, inLen);
+  return hdr && (hdr->fFlags & FLAG_SIGNED);
+}
+
+ssize_t ColumnEncoding::filter(const char* in, size_t inLen, uint8_t cop, int64_t constant, bool isUnsigned,
+                               uint64_t* matches, size_t matchesLen)
+{
+  const EncodedHeader* hdr = parseHeader(in, inLen);
+
+  if (!hdr || cop == 0 || cop > (COP_LT | COP_EQ | COP_GT) || cop == (COP_LT | COP_EQ | COP_GT))
+    return -1;
+
+  const size_t total = (size_t)hdr->fCount + hdr->fTailCount;
+
+  if (matchesLen * 64 < total)
+    return -1;
+
+  std::fill(matches, matches + (total + 63) / 64, 0);
+
+  const uint32_t width = hdr->fWidth;
+  const uint64_t constantKey = orderKey(constant, isUnsigned);
+  const bool sameOrder =
+      (hdr->fFlags & FLAG_ANY_ORDER) || ((hdr->fFlags & FLAG_SIGNED) != 0) == !isUnsigned;
+  auto key = [=](uint64_t value) { return orderKey(extend(value, width, !isUnsigned), isUnsigned); };
+
+  if (hdr->fEncoding == FOR && sameOrder)
+  {
+    filterFrame(hdr, cop, key(hdr->fReference), constantKey, matches);
+  }
+  else if (hdr->fEncoding == RLE)
+  {
+    // one comparison per run
+    const uint32_t* ends = runEnds(hdr);
+    const uint64_t* words = packedData(hdr);
+    uint64_t p[GROUP_SIZE];
+    size_t start = 0;
+
+    for (size_t g = 0; g < hdr->fExtra; g += GROUP_SIZE)
+    {
+      unpackGroup(words + (g / GROUP_SIZE) * hdr->fBits, hdr->fBits, p);
+
+      for (size_t r = g; r < min<size_t>(g + GROUP_SIZE, hdr->fExtra); start = ends[r++])
+      {
+        if (evaluate(cop, key(hdr->fReference + p[r - g]), constantKey))
+          setBits(matches, start, min<size_t>(ends[r], hdr->fCount));
+      }
+    }
+  }
+  else
+  {
+    forEachValue(hdr,
+                 [&](size_t i, uint64_t value)
+                 {
+                   if (evaluate(cop, key(value), constantKey))
+                     matches[i >> 6] |= 1ULL << (i & 63);
+                 });
+  }
+
+  if (hdr->fTailCount && evaluate(cop, key(hdr->fTailValue), constantKey))
+    setBits(matches, hdr->fCount, total);
+
+  return total;
+}
+
+ssize_t ColumnEncoding::minMax(const char* in, size_t inLen, bool isUnsigned, int64_t skip1, int64_t skip2,
+                               int64_t* minValue, int64_t* maxValue)
+{
+  const EncodedHeader* hdr = parseHeader(in, inLen);
+
+  if (!hdr)
+    return -1;
+
+  const uint32_t width = hdr->fWidth;
+  const uint64_t skipKey1 = orderKey(skip1, isUnsigned);
+  const uint64_t skipKey2 = orderKey(skip2, isUnsigned);
+  auto key = [=](uint64_t value) { return orderKey(extend(value, width, !isUnsigned), isUnsigned); };
+  uint64_t minKey = numeric_limits<uint64_t>::max();
+  uint64_t maxKey = 0;
+  ssize_t count = 0;
+
+  auto add = [&](uint64_t k, size_t n)
+  {
+    if (n == 0 || k == skipKey1 || k == skipKey2)
+      return;
+
+    minKey = min(minKey, k);
+    maxKey = max(maxKey, k);
+    count += n;
+  };
+
+  if (hdr->fEncoding == RLE)
+  {
+    const uint32_t* ends = runEnds(hdr);
+    const uint64_t* words = packedData(hdr);
+    uint64_t p[GROUP_SIZE];
+    size_t start = 0;
+
+    for (size_t g = 0; g < hdr->fExtra; g += GROUP_SIZE)
+    {
+      unpackGroup(words + (g / GROUP_SIZE) * hdr->fBits, hdr->fBits, p);
+
+      for (size_t r = g; r < min<size_t>(g + GROUP_SIZE, hdr->fExtra); start = ends[r++])
+      {
+        const size_t end = min<size_t>(ends[r], hdr->fCount);
+        add(key(hdr->fReference + p[r - g]), end - min(start, end));
+      }
+    }
+  }
+  else
+  {
+    forEachValue(hdr, [&](size_t, uint64_t value) { add(key(value), 1); });
+  }
+
+  add(key(hdr->fTailValue), hdr->fTailCount);
+
+  // orderKey() is its own inverse
+  if (count > 0)
+  {
+    *minValue = (int64_t)orderKey(minKey, isUnsigned);
+    *maxValue = (int64_t)orderKey(maxKey, isUnsigned);
+  }
+
+  return count;
+}
+
+}  // namespace compress
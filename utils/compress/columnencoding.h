@@ -0,0 +1,120 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "calpontsystemcatalog.h"
+
+#define EXPORT
+
+namespace compress
+{
+/**
+ * @brief Lightweight encodings of a chunk of fixed width integer values.
+ *
+ * A chunk of 1, 2, 4 or 8 byte values is stored as one of
+ *  - FOR: frame of reference, every value is bit-packed as its offset from the chunk minimum
+ *  - DELTA: the bit-packed differences between neighbours, offset by the smallest difference
+ *  - RLE: run ends and the bit-packed run values
+ * whichever is smallest. The trailing run of one value, usually the empty values that fill the
+ * last chunk of an extent, is kept aside as a count so it doesn't widen the frame.
+ *
+ * Values are bit-packed into 64 bit words, value i at bit i * bits, so every group of 64 values
+ * starts on a word boundary and is unpacked on its own. The encoded buffer must be 8 byte aligned.
+ *
+ * The encoding is lossless for any bytes, the order it chose (signed or unsigned, see isSigned())
+ * only matters to filter() and minMax().
+ **/
+class ColumnEncoding
+{
+ public:
+  enum Type
+  {
+    NONE = 0,
+    FOR = 1,
+    DELTA = 2,
+    RLE = 3
+  };
+
+  /**
+   * Does cpimport encode columns of this type and width.
+   */
+  EXPORT static bool isEncodable(execplan::CalpontSystemCatalog::ColDataType colDataType, uint32_t colWidth);
+
+  /**
+   * Size of the out buffer encode() needs for inLen bytes of input.
+   */
+  EXPORT static size_t maxEncodedSize(size_t inLen);
+
+  /**
+   * Encodes inLen bytes of colWidth wide values into out. Returns the encoded length, 0 if the
+   * values can't be encoded or the encoding would save less than a quarter of the input.
+   */
+  EXPORT static size_t encode(const char* in, size_t inLen, uint32_t colWidth, char* out, size_t outCapacity);
+
+  /**
+   * Decodes an encoded buffer. outLen must be initialized with the size of the out buffer,
+   * on return it has the number of bytes used in out. Returns 0 if success.
+   */
+  EXPORT static int decode(const char* in, size_t inLen, char* out, size_t* outLen);
+
+  /**
+   * Returns the encoding of an encoded buffer, NONE if it isn't one.
+   */
+  EXPORT static Type getType(const char* in, size_t inLen);
+
+  /**
+   * Returns the width of the values of an encoded buffer, 0 if it isn't one.
+   */
+  EXPORT static uint32_t getWidth(const char* in, size_t inLen);
+
+  /**
+   * Returns true if the values of an encoded buffer are framed in signed order.
+   */
+  EXPORT static bool isSigned(const char* in, size_t inLen);
+
+  /**
+   * Evaluates "value COP constant" for every value of an encoded buffer without decoding it
+   * where the encoding allows, and sets bit i of matches for every value i that qualifies.
+   * cop is one of COMPARE_LT, COMPARE_EQ, COMPARE_LE, COMPARE_GT, COMPARE_NE, COMPARE_GE of
+   * primitivemsg.h, constant is sign extended for signed columns and zero extended otherwise.
+   * NULL and empty values are compared like any other value, they are the caller's business.
+   * matchesLen is the number of words in matches.
+   * Returns the number of values evaluated, -1 for an unsupported cop or a bad buffer.
+   */
+  EXPORT static ssize_t filter(const char* in, size_t inLen, uint8_t cop, int64_t constant, bool isUnsigned,
+                               uint64_t* matches, size_t matchesLen);
+
+  /**
+   * Finds the smallest and the largest value of an encoded buffer in the order filter() uses,
+   * leaving out the values equal to skip1 or skip2, e.g. the NULL and empty values of the column.
+   * RLE buffers are read one run at a time. Values come back extended like filter()'s constant,
+   * min and max are not set if every value is left out.
+   * Returns the number of values left in, -1 for a bad buffer.
+   */
+  EXPORT static ssize_t minMax(const char* in, size_t inLen, bool isUnsigned, int64_t skip1, int64_t skip2,
+                               int64_t* min, int64_t* max);
+};
+
+}  // namespace compress
+
+#undef EXPORT
@@ -19,10 +19,14 @@
  * $Id: idbcompress.cpp 3907 2013-06-18 13:32:46Z dcathey $
  *
  ******************************************************************************************/
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <unordered_map>
+#include <vector>
 using namespace std;
 
 #include "blocksize.h"
@@ -38,10 +42,19 @@ using namespace std;
 #define LZ4_COMPRESSBOUND(isize) \
   ((unsigned)(isize) > (unsigned)LZ4_MAX_INPUT_SIZE ? 0 : (isize) + ((isize) / 255) + 16)
 #endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#else
+// Taken from zstd.h.
+#define ZSTD_COMPRESSBOUND(srcSize) \
+  ((srcSize) + ((srcSize) >> 8) + (((srcSize) < (128 << 10)) ? (((128 << 10) - (srcSize)) >> 11) : 0))
+#endif
 
 #define IDBCOMP_DLLEXPORT
 #include "idbcompress.h"
 #undef IDBCOMP_DLLEXPORT
+#include "columnencoding.h"
 
 namespace
 {
@@ -55,6 +68,12 @@ const int CHECKSUM_OFFSET = 1;
 const int LEN_OFFSET = 5;
 const unsigned HEADER_SIZE = 9;
 
+// A chunk of ColumnEncoding encoded values, the encoded values are a regular
+// compressed chunk that follows the magic and its length.
+const uint8_t CHUNK_MAGIC_ENCODED = 0xf9;
+const int ENCODED_LEN_OFFSET = 1;
+const unsigned ENCODED_HEADER_SIZE = 5;
+
 // The max number of lbids to be stored in segment file.
 const uint32_t LBID_MAX_SIZE = 48;
 
@@ -69,8 +88,14 @@ struct CompressedDBFileHeader
   execplan::CalpontSystemCatalog::ColDataType fColDataType;
   uint64_t fLBIDCount;
   uint64_t fLBIDS[LBID_MAX_SIZE];
+  // Trained compression dictionary, 0 length in files written without one
+  uint64_t fDictionaryLen;
+  char fDictionary[compress::CompressInterface::MAX_DICTIONARY_LEN];
 };
 
+static_assert(sizeof(CompressedDBFileHeader) <= compress::CompressInterface::HDR_BUF_LEN,
+              "compressed file header must fit into the first header block");
+
 // Make the header to be 4K, regardless number of fields being defined/used in header.
 union CompressedDBFileHeaderBlock
 {
@@ -92,6 +117,49 @@ void initCompressedDBFileHeader(void* hdrBuf, uint32_t columnWidth,
   hdr->fHeader.fColDataType = colDataType;
   hdr->fHeader.fLBIDCount = 0;
   std::memset(hdr->fHeader.fLBIDS, 0, sizeof(hdr->fHeader.fLBIDS));
+  hdr->fHeader.fDictionaryLen = 0;
+}
+
+#ifdef HAVE_ZSTD
+struct ZSTDContextDeleter
+{
+  void operator()(ZSTD_CCtx* ctx) const
+  {
+    ZSTD_freeCCtx(ctx);
+  }
+  void operator()(ZSTD_DCtx* ctx) const
+  {
+    ZSTD_freeDCtx(ctx);
+  }
+};
+
+// A context keeps the library's working memory between chunks, one per thread
+// because the compressors are shared by the threads of a pool.
+ZSTD_CCtx* zstdCompressContext()
+{
+  thread_local std::unique_ptr<ZSTD_CCtx, ZSTDContextDeleter> ctx(ZSTD_createCCtx());
+  return ctx.get();
+}
+
+ZSTD_DCtx* zstdDecompressContext()
+{
+  thread_local std::unique_ptr<ZSTD_DCtx, ZSTDContextDeleter> ctx(ZSTD_createDCtx());
+  return ctx.get();
+}
+#endif
+
+std::atomic<int> zstdCompressionLevel(compress::CompressInterfaceZSTD::DEFAULT_COMPRESSION_LEVEL);
+
+// Scratch for the ColumnEncoding form of a chunk, one per thread like the ZSTD contexts.
+// Words because an encoded buffer must be 8 byte aligned.
+char* encodedChunkBuffer(size_t len)
+{
+  thread_local std::vector<uint64_t> buf;
+
+  if (buf.size() * sizeof(uint64_t) < len)
+    buf.resize((len + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+
+  return reinterpret_cast<char*>(buf.data());
 }
 
 }  // namespace
@@ -112,20 +180,27 @@ CompressInterface::CompressInterface(unsigned int numUserPaddingBytes)
 /*static*/
 bool CompressInterface::isCompressionAvail(int compressionType)
 {
+#ifdef HAVE_ZSTD
+  if (compressionType == 4)
+    return true;
+#endif
+
   return ((compressionType == 0) || (compressionType == 1) || (compressionType == 2) ||
           (compressionType == 3));
 }
 
 size_t CompressInterface::getMaxCompressedSizeGeneric(size_t inLen)
 {
-  return std::max(snappy::MaxCompressedLength(inLen), LZ4_COMPRESSBOUND(inLen)) + HEADER_SIZE;
+  return std::max({snappy::MaxCompressedLength(inLen), (size_t)LZ4_COMPRESSBOUND(inLen),
+                   (size_t)ZSTD_COMPRESSBOUND(inLen)}) +
+         HEADER_SIZE;
 }
 
 //------------------------------------------------------------------------------
 // Compress a block of data
 //------------------------------------------------------------------------------
 int CompressInterface::compressBlock(const char* in, const size_t inLen, unsigned char* out,
-                                     size_t& outLen) const
+                                     size_t& outLen, const char* dict, size_t dictLen) const
 {
   size_t snaplen = 0;
   utils::Hasher128 hasher;
@@ -138,7 +213,11 @@ int CompressInterface::compressBlock(const char* in, const size_t inLen, unsigne
     return ERR_BADOUTSIZE;
   }
 
-  auto rc = compress(in, inLen, reinterpret_cast<char*>(&out[HEADER_SIZE]), &outLen);
+  const bool useDict = (dictLen > 0 && getDictChunkMagicNumber() != 0);
+  outLen -= HEADER_SIZE;
+  auto rc = useDict ? compressWithDictionary(in, inLen, reinterpret_cast<char*>(&out[HEADER_SIZE]), &outLen,
+                                             dict, dictLen)
+                    : compress(in, inLen, reinterpret_cast<char*>(&out[HEADER_SIZE]), &outLen);
   if (rc != ERR_OK)
   {
     return rc;
@@ -148,7 +227,7 @@ int CompressInterface::compressBlock(const char* in, const size_t inLen, unsigne
   uint8_t* signature = (uint8_t*)&out[SIG_OFFSET];
   uint32_t* checksum = (uint32_t*)&out[CHECKSUM_OFFSET];
   uint32_t* len = (uint32_t*)&out[LEN_OFFSET];
-  *signature = getChunkMagicNumber();
+  *signature = useDict ? getDictChunkMagicNumber() : getChunkMagicNumber();
   *checksum = hasher((char*)&out[HEADER_SIZE], snaplen);
   *len = snaplen;
 
@@ -160,11 +239,39 @@ int CompressInterface::compressBlock(const char* in, const size_t inLen, unsigne
   return ERR_OK;
 }
 
+//------------------------------------------------------------------------------
+// Encode and compress a block of column values
+//------------------------------------------------------------------------------
+int CompressInterface::compressEncodedBlock(const char* in, const size_t inLen, uint32_t colWidth,
+                                            unsigned char* out, size_t& outLen, const char* dict,
+                                            size_t dictLen) const
+{
+  const size_t encodedCapacity = ColumnEncoding::maxEncodedSize(inLen);
+  char* encoded = encodedChunkBuffer(encodedCapacity);
+  const size_t encodedLen = ColumnEncoding::encode(in, inLen, colWidth, encoded, encodedCapacity);
+
+  if (encodedLen == 0 || outLen < maxCompressedSize(encodedLen) + ENCODED_HEADER_SIZE)
+    return compressBlock(in, inLen, out, outLen, dict, dictLen);
+
+  size_t innerLen = outLen - ENCODED_HEADER_SIZE;
+  auto rc = compressBlock(encoded, encodedLen, &out[ENCODED_HEADER_SIZE], innerLen, dict, dictLen);
+
+  if (rc != ERR_OK)
+    return rc;
+
+  out[SIG_OFFSET] = CHUNK_MAGIC_ENCODED;
+  *((uint32_t*)&out[ENCODED_LEN_OFFSET]) = innerLen;
+  outLen = innerLen + ENCODED_HEADER_SIZE;
+
+  return ERR_OK;
+}
+
 //------------------------------------------------------------------------------
 // Decompress a block of data
 //------------------------------------------------------------------------------
 int CompressInterface::uncompressBlock(const char* in, const size_t inLen, unsigned char* out,
-                                       size_t& outLen) const
+                                       size_t& outLen, const char* dict, size_t dictLen,
+                                       uint32_t* encodedWidth) const
 {
   uint32_t realChecksum;
   uint32_t storedChecksum;
@@ -174,12 +281,53 @@ int CompressInterface::uncompressBlock(const char* in, const size_t inLen, unsig
   auto tmpOutLen = outLen;
   outLen = 0;
 
+  if (encodedWidth)
+    *encodedWidth = 0;
+
   if (inLen < 1)
     return ERR_BADINPUT;
 
   storedMagic = *((uint8_t*)&in[SIG_OFFSET]);
 
-  if (storedMagic == getChunkMagicNumber())
+  if (storedMagic == CHUNK_MAGIC_ENCODED)
+  {
+    if (inLen < ENCODED_HEADER_SIZE + 1)
+      return ERR_BADINPUT;
+
+    storedLen = *((uint32_t*)(&in[ENCODED_LEN_OFFSET]));
+
+    if (inLen < storedLen + ENCODED_HEADER_SIZE || (uint8_t)in[ENCODED_HEADER_SIZE] == CHUNK_MAGIC_ENCODED)
+      return ERR_BADINPUT;
+
+    // the encoded values are smaller than the decoded ones, so out's size is enough for them
+    char* encoded = encodedChunkBuffer(tmpOutLen);
+    size_t encodedLen = tmpOutLen;
+    auto rc = uncompressBlock(&in[ENCODED_HEADER_SIZE], storedLen, reinterpret_cast<unsigned char*>(encoded),
+                              encodedLen, dict, dictLen);
+
+    if (rc != ERR_OK)
+      return rc;
+
+    if (ColumnEncoding::decode(encoded, encodedLen, reinterpret_cast<char*>(out), &tmpOutLen) != 0)
+    {
+      cerr << "uncompressBlock failed to decode an encoded chunk!" << endl;
+      return ERR_DECOMPRESS;
+    }
+
+    if (encodedWidth)
+      *encodedWidth = ColumnEncoding::getWidth(encoded, encodedLen);
+
+    outLen = tmpOutLen;
+    return ERR_OK;
+  }
+
+  const bool withDict = (getDictChunkMagicNumber() != 0 && storedMagic == getDictChunkMagicNumber());
+
+  // a chunk compressed with a dictionary is garbage without it
+  if (withDict && dictLen == 0)
+    return ERR_BADINPUT;
+
+  if (storedMagic == getChunkMagicNumber() || withDict)
   {
     if (inLen < HEADER_SIZE)
       return ERR_BADINPUT;
@@ -195,7 +343,9 @@ int CompressInterface::uncompressBlock(const char* in, const size_t inLen, unsig
     if (storedChecksum != realChecksum)
       return ERR_CHECKSUM;
 
-    auto rc = uncompress(&in[HEADER_SIZE], storedLen, reinterpret_cast<char*>(out), &tmpOutLen);
+    auto rc = withDict ? uncompressWithDictionary(&in[HEADER_SIZE], storedLen, reinterpret_cast<char*>(out),
+                                                  &tmpOutLen, dict, dictLen)
+                       : uncompress(&in[HEADER_SIZE], storedLen, reinterpret_cast<char*>(out), &tmpOutLen);
     if (rc != ERR_OK)
     {
       cerr << "uncompressBlock failed!" << endl;
@@ -215,6 +365,35 @@ int CompressInterface::uncompressBlock(const char* in, const size_t inLen, unsig
   return ERR_OK;
 }
 
+//------------------------------------------------------------------------------
+// Dictionary support, algorithms without it compress every chunk on its own.
+//------------------------------------------------------------------------------
+bool CompressInterface::supportsDictionary() const
+{
+  return false;
+}
+
+size_t CompressInterface::trainDictionary(const char*, const size_t*, unsigned, char*, size_t) const
+{
+  return 0;
+}
+
+uint8_t CompressInterface::getDictChunkMagicNumber() const
+{
+  return 0;
+}
+
+int CompressInterface::compressWithDictionary(const char*, size_t, char*, size_t*, const char*, size_t) const
+{
+  return ERR_COMPRESS;
+}
+
+int CompressInterface::uncompressWithDictionary(const char*, size_t, char*, size_t*, const char*,
+                                                size_t) const
+{
+  return ERR_DECOMPRESS;
+}
+
 //------------------------------------------------------------------------------
 // Verify the passed in buffer contains a valid compression file header.
 //------------------------------------------------------------------------------
@@ -439,6 +618,41 @@ uint64_t CompressInterface::getLBIDCount(void* hdrBuf)
   return reinterpret_cast<const CompressedDBFileHeader*>(hdrBuf)->fLBIDCount;
 }
 
+//------------------------------------------------------------------------------
+// Set the compression dictionary
+//------------------------------------------------------------------------------
+void CompressInterface::setDictionary(void* hdrBuf, const char* dict, size_t dictLen)
+{
+  CompressedDBFileHeader* hdr = reinterpret_cast<CompressedDBFileHeader*>(hdrBuf);
+
+  if (dictLen > MAX_DICTIONARY_LEN)
+    dictLen = 0;
+
+  std::memset(hdr->fDictionary, 0, sizeof(hdr->fDictionary));
+
+  if (dictLen)
+    std::memcpy(hdr->fDictionary, dict, dictLen);
+
+  hdr->fDictionaryLen = dictLen;
+}
+
+//------------------------------------------------------------------------------
+// Get the compression dictionary
+//------------------------------------------------------------------------------
+const char* CompressInterface::getDictionary(const void* hdrBuf, size_t& dictLen)
+{
+  const CompressedDBFileHeader* hdr = reinterpret_cast<const CompressedDBFileHeader*>(hdrBuf);
+  dictLen = hdr->fDictionaryLen;
+
+  if (dictLen == 0 || dictLen > MAX_DICTIONARY_LEN)
+  {
+    dictLen = 0;
+    return nullptr;
+  }
+
+  return hdr->fDictionary;
+}
+
 //------------------------------------------------------------------------------
 // Calculates the chunk and block offset within the chunk for the specified
 // block number.
@@ -614,6 +828,142 @@ uint8_t CompressInterfaceLZ4::getChunkMagicNumber() const
   return CHUNK_MAGIC_LZ4;
 }
 
+// ZSTD
+CompressInterfaceZSTD::CompressInterfaceZSTD(uint32_t numUserPaddingBytes)
+ : CompressInterface(numUserPaddingBytes)
+{
+}
+
+int32_t CompressInterfaceZSTD::compress(const char* in, size_t inLen, char* out, size_t* outLen) const
+{
+  return compressWithDictionary(in, inLen, out, outLen, nullptr, 0);
+}
+
+int32_t CompressInterfaceZSTD::uncompress(const char* in, size_t inLen, char* out, size_t* outLen) const
+{
+  return uncompressWithDictionary(in, inLen, out, outLen, nullptr, 0);
+}
+
+int CompressInterfaceZSTD::compressWithDictionary(const char* in, size_t inLen, char* out, size_t* outLen,
+                                                  const char* dict, size_t dictLen) const
+{
+#ifdef HAVE_ZSTD
+  auto compressedLen = ZSTD_compress_usingDict(zstdCompressContext(), out, *outLen, in, inLen, dict, dictLen,
+                                               getCompressionLevel());
+
+  if (ZSTD_isError(compressedLen))
+  {
+    cerr << "ZSTD_compress_usingDict failed: " << ZSTD_getErrorName(compressedLen) << ". InLen: " << inLen
+         << ", outLen: " << *outLen << endl;
+    return ERR_COMPRESS;
+  }
+
+#ifdef DEBUG_COMPRESSION
+  std::cout << "ZSTD::compress: inLen " << inLen << ", compressedLen " << compressedLen << std::endl;
+#endif
+
+  *outLen = compressedLen;
+  return ERR_OK;
+#else
+  return ERR_COMPRESS;
+#endif
+}
+
+int CompressInterfaceZSTD::uncompressWithDictionary(const char* in, size_t inLen, char* out, size_t* outLen,
+                                                    const char* dict, size_t dictLen) const
+{
+#ifdef HAVE_ZSTD
+  auto decompressedLen =
+      ZSTD_decompress_usingDict(zstdDecompressContext(), out, *outLen, in, inLen, dict, dictLen);
+
+  if (ZSTD_isError(decompressedLen))
+  {
+    cerr << "ZSTD_decompress_usingDict failed: " << ZSTD_getErrorName(decompressedLen) << endl;
+    cerr << "InLen: " << inLen << ", outLen: " << *outLen << endl;
+    return ERR_DECOMPRESS;
+  }
+
+  *outLen = decompressedLen;
+
+#ifdef DEBUG_COMPRESSION
+  std::cout << "ZSTD::uncompress: inLen " << inLen << ", outLen " << *outLen << std::endl;
+#endif
+
+  return ERR_OK;
+#else
+  return ERR_DECOMPRESS;
+#endif
+}
+
+size_t CompressInterfaceZSTD::maxCompressedSize(size_t uncompSize) const
+{
+  return (ZSTD_COMPRESSBOUND(uncompSize) + HEADER_SIZE);
+}
+
+bool CompressInterfaceZSTD::getUncompressedSize(char* in, size_t inLen, size_t* outLen) const
+{
+#ifdef HAVE_ZSTD
+  auto size = ZSTD_getFrameContentSize(in, inLen);
+
+  if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR)
+    return false;
+
+  *outLen = size;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool CompressInterfaceZSTD::supportsDictionary() const
+{
+#ifdef HAVE_ZSTD
+  return true;
+#else
+  return false;
+#endif
+}
+
+size_t CompressInterfaceZSTD::trainDictionary(const char* samples, const size_t* sampleSizes,
+                                              unsigned nbSamples, char* dict, size_t dictCapacity) const
+{
+#ifdef HAVE_ZSTD
+  auto dictLen = ZDICT_trainFromBuffer(dict, dictCapacity, samples, sampleSizes, nbSamples);
+
+  // Too few or too uniform samples fail the training. The chunks are then
+  // compressed without a dictionary, which is not an error.
+  if (ZDICT_isError(dictLen))
+    return 0;
+
+  return dictLen;
+#else
+  return 0;
+#endif
+}
+
+void CompressInterfaceZSTD::setCompressionLevel(int level)
+{
+#ifdef HAVE_ZSTD
+  level = std::min(std::max(level, ZSTD_minCLevel()), ZSTD_maxCLevel());
+#endif
+  zstdCompressionLevel = level;
+}
+
+int CompressInterfaceZSTD::getCompressionLevel()
+{
+  return zstdCompressionLevel;
+}
+
+uint8_t CompressInterfaceZSTD::getChunkMagicNumber() const
+{
+  return CHUNK_MAGIC_ZSTD;
+}
+
+uint8_t CompressInterfaceZSTD::getDictChunkMagicNumber() const
+{
+  return CHUNK_MAGIC_ZSTD_DICT;
+}
+
 CompressInterface* getCompressInterfaceByType(uint32_t compressionType, uint32_t numUserPaddingBytes)
 {
   switch (compressionType)
@@ -621,6 +971,7 @@ CompressInterface* getCompressInterfaceByType(uint32_t compressionType, uint32_t
     case 1:
     case 2: return new CompressInterfaceSnappy(numUserPaddingBytes);
     case 3: return new CompressInterfaceLZ4(numUserPaddingBytes);
+    case 4: return new CompressInterfaceZSTD(numUserPaddingBytes);
   }
 
   return nullptr;
@@ -633,6 +984,8 @@ CompressInterface* getCompressInterfaceByName(const std::string& compressionName
     return new CompressInterfaceSnappy(numUserPaddingBytes);
   else if (compressionName == "LZ4")
     return new CompressInterfaceLZ4(numUserPaddingBytes);
+  else if (compressionName == "ZSTD")
+    return new CompressInterfaceZSTD(numUserPaddingBytes);
   return nullptr;
 }
 
@@ -642,7 +995,8 @@ void initializeCompressorPool(
 {
   compressorPool = {
       make_pair(2, std::shared_ptr<CompressInterface>(new CompressInterfaceSnappy(numUserPaddingBytes))),
-      make_pair(3, std::shared_ptr<CompressInterface>(new CompressInterfaceLZ4(numUserPaddingBytes)))};
+      make_pair(3, std::shared_ptr<CompressInterface>(new CompressInterfaceLZ4(numUserPaddingBytes))),
+      make_pair(4, std::shared_ptr<CompressInterface>(new CompressInterfaceZSTD(numUserPaddingBytes)))};
 }
 
 std::shared_ptr<CompressInterface> getCompressorByType(
@@ -664,6 +1018,12 @@ std::shared_ptr<CompressInterface> getCompressorByType(
         return nullptr;
       }
       return compressorPool[3];
+    case 4:
+      if (!compressorPool.count(4))
+      {
+        return nullptr;
+      }
+      return compressorPool[4];
   }
 
   return nullptr;
@@ -40,6 +40,8 @@ class CompressInterface
   static const unsigned int HDR_BUF_LEN = 4096;
   static const unsigned int UNCOMPRESSED_INBUF_LEN = 512 * 1024 * 8;
   static const uint32_t COMPRESSED_CHUNK_INCREMENT_SIZE = 8192;
+  // room for a trained dictionary in the 4K file header, see setDictionary()
+  static const unsigned int MAX_DICTIONARY_LEN = 3584;
 
   // error codes from uncompressBlock()
   static const int ERR_OK = 0;
@@ -75,16 +77,31 @@ class CompressInterface
    * Compresses specified "in" buffer of length "inLen" bytes.
    * Compressed data and size are returned in "out" and "outLen".
    * "out" should be sized using maxCompressedSize() to allow for incompressible data.
+   * If "dict" is given and the algorithm supportsDictionary(), the chunk is compressed
+   * against it and can only be uncompressed with the same dictionary.
    * Returns 0 if success.
    */
 
-  EXPORT int compressBlock(const char* in, const size_t inLen, unsigned char* out, size_t& outLen) const;
+  EXPORT int compressBlock(const char* in, const size_t inLen, unsigned char* out, size_t& outLen,
+                           const char* dict = nullptr, size_t dictLen = 0) const;
+
+  /**
+   * Same as compressBlock() for a chunk of colWidth wide column values, but the values are first
+   * stored as a ColumnEncoding if that saves enough. uncompressBlock() decodes such chunks.
+   */
+  EXPORT int compressEncodedBlock(const char* in, const size_t inLen, uint32_t colWidth, unsigned char* out,
+                                  size_t& outLen, const char* dict = nullptr, size_t dictLen = 0) const;
 
   /**
    * outLen must be initialized with the size of the out buffer before calling uncompressBlock.
    * On return, outLen will have the number of bytes used in out.
+   * "dict" is the dictionary from the file header, chunks compressed without one ignore it.
+   * If "encodedWidth" is given it is set to the value width of a chunk compressEncodedBlock()
+   * stored as a ColumnEncoding, 0 for any other chunk.
    */
-  EXPORT int uncompressBlock(const char* in, const size_t inLen, unsigned char* out, size_t& outLen) const;
+  EXPORT int uncompressBlock(const char* in, const size_t inLen, unsigned char* out, size_t& outLen,
+                             const char* dict = nullptr, size_t dictLen = 0,
+                             uint32_t* encodedWidth = nullptr) const;
 
   /**
    * This fcn wraps whatever compression algorithm we're using at the time, and
@@ -99,6 +116,19 @@ class CompressInterface
    */
   EXPORT virtual int uncompress(const char* in, size_t inLen, char* out, size_t* outLen) const = 0;
 
+  /**
+   * Does the algorithm compress against a trained dictionary.
+   */
+  EXPORT virtual bool supportsDictionary() const;
+
+  /**
+   * Trains a dictionary of at most dictCapacity bytes from nbSamples samples stored back to back
+   * in "samples". Returns the dictionary length, 0 if the algorithm has no dictionaries or the
+   * samples were not good enough to train one.
+   */
+  EXPORT virtual size_t trainDictionary(const char* samples, const size_t* sampleSizes, unsigned nbSamples,
+                                        char* dict, size_t dictCapacity) const;
+
   /**
    * Initialize header buffer at start of compressed db file.
    *
@@ -240,6 +270,17 @@ class CompressInterface
    */
   EXPORT static uint64_t getLBIDCount(void* hdrBuf);
 
+  /**
+   * Store a dictionary of at most MAX_DICTIONARY_LEN bytes in the file header, dictLen 0 removes it.
+   * The dictionary must not change while the file has chunks compressed with it.
+   */
+  EXPORT static void setDictionary(void* hdrBuf, const char* dict, size_t dictLen);
+
+  /**
+   * Returns the dictionary stored in the file header and its length, or nullptr if there is none.
+   */
+  EXPORT static const char* getDictionary(const void* hdrBuf, size_t& dictLen);
+
   /**
    * Mutator methods for the user padding bytes
    */
@@ -274,6 +315,16 @@ class CompressInterface
  protected:
   virtual uint8_t getChunkMagicNumber() const = 0;
 
+  /**
+   * Magic number of chunks compressed with a dictionary, 0 if the algorithm has no dictionaries.
+   */
+  virtual uint8_t getDictChunkMagicNumber() const;
+
+  virtual int compressWithDictionary(const char* in, size_t inLen, char* out, size_t* outLen,
+                                     const char* dict, size_t dictLen) const;
+  virtual int uncompressWithDictionary(const char* in, size_t inLen, char* out, size_t* outLen,
+                                       const char* dict, size_t dictLen) const;
+
  private:
   // defaults okay
   // CompressInterface(const CompressInterface& rhs);
@@ -348,6 +399,61 @@ class CompressInterfaceLZ4 : public CompressInterface
   const uint8_t CHUNK_MAGIC_LZ4 = 0xfc;
 };
 
+class CompressInterfaceZSTD : public CompressInterface
+{
+ public:
+  EXPORT CompressInterfaceZSTD(uint32_t numUserPaddingBytes = 0);
+  EXPORT ~CompressInterfaceZSTD() = default;
+  /**
+   * Compress the given block using zstd compression API at the configured level.
+   */
+  EXPORT int32_t compress(const char* in, size_t inLen, char* out, size_t* outLen) const override;
+  /**
+   * Uncompress the given block using zstd compression API.
+   */
+  EXPORT int32_t uncompress(const char* in, size_t inLen, char* out, size_t* outLen) const override;
+  /**
+   * Get max compressed size for the given `uncompSize` value using zstd
+   * compression API.
+   */
+  EXPORT size_t maxCompressedSize(size_t uncompSize) const override;
+
+  /**
+   * Get uncompressed size for the given block from the zstd frame header.
+   */
+  EXPORT
+  bool getUncompressedSize(char* in, size_t inLen, size_t* outLen) const override;
+
+  EXPORT bool supportsDictionary() const override;
+
+  /**
+   * Train a dictionary with ZDICT_trainFromBuffer().
+   */
+  EXPORT size_t trainDictionary(const char* samples, const size_t* sampleSizes, unsigned nbSamples,
+                                char* dict, size_t dictCapacity) const override;
+
+  /**
+   * Mutator methods for the compression level used by all ZSTD compressors of the process.
+   * Out of range levels are clamped to what the library supports.
+   */
+  EXPORT static void setCompressionLevel(int level);
+  EXPORT static int getCompressionLevel();
+
+  static const int DEFAULT_COMPRESSION_LEVEL = 3;
+
+ protected:
+  uint8_t getChunkMagicNumber() const override;
+  uint8_t getDictChunkMagicNumber() const override;
+  int compressWithDictionary(const char* in, size_t inLen, char* out, size_t* outLen, const char* dict,
+                             size_t dictLen) const override;
+  int uncompressWithDictionary(const char* in, size_t inLen, char* out, size_t* outLen, const char* dict,
+                               size_t dictLen) const override;
+
+ private:
+  const uint8_t CHUNK_MAGIC_ZSTD = 0xfb;
+  const uint8_t CHUNK_MAGIC_ZSTD_DICT = 0xfa;
+};
+
 using CompressorPool = std::unordered_map<uint32_t, std::shared_ptr<CompressInterface>>;
 
 /**
@@ -386,12 +492,13 @@ inline bool CompressInterface::isCompressionAvail(int c)
 {
   return (c == 0);
 }
-inline int CompressInterface::compressBlock(const char*, const size_t, unsigned char*, size_t&) const
+inline int CompressInterface::compressBlock(const char*, const size_t, unsigned char*, size_t&, const char*,
+                                            size_t) const
 {
   return -1;
 }
 inline int CompressInterface::uncompressBlock(const char* in, const size_t inLen, unsigned char* out,
-                                              size_t& outLen) const
+                                              size_t& outLen, const char*, size_t) const
 {
   return -1;
 }
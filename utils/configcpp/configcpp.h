@@ -205,8 +205,9 @@ class Config
 
   enum class TempDirPurpose
   {
-    Joins,      ///< disk joins
-    Aggregates  ///< disk-based aggregation
+    Joins,       ///< disk joins
+    Aggregates,  ///< disk-based aggregation
+    Sorts        ///< disk-based ORDER BY
   };
   /** @brief Return temporaru directory path for the specified purpose */
   std::string getTempFileDir(TempDirPurpose what);
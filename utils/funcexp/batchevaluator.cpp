@@ -0,0 +1,1232 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+using namespace std;
+
+#include "batchevaluator.h"
+#include "funcexp.h"
+
+#include "arithmeticcolumn.h"
+#include "arithmeticoperator.h"
+#include "constantcolumn.h"
+#include "functioncolumn.h"
+#include "logicoperator.h"
+#include "predicateoperator.h"
+#include "simplecolumn.h"
+#include "simplefilter.h"
+using namespace execplan;
+
+#include "rowgroup.h"
+using namespace rowgroup;
+
+#include "joblisttypes.h"
+using namespace joblist;
+
+namespace funcexp
+{
+enum class BatchKind
+{
+  Int,
+  Double
+};
+
+/* Dense results of a node, one entry per row of the selection it was evaluated on.
+   Booleans are kept in ints as 0/1. The value of a null entry is unspecified, the row
+   based path doesn't define it either. */
+struct BatchVector
+{
+  vector<int64_t> ints;
+  vector<double> doubles;
+  vector<uint8_t> nulls;
+
+  void resize(BatchKind kind, size_t n)
+  {
+    if (kind == BatchKind::Int)
+      ints.resize(n);
+    else
+      doubles.resize(n);
+
+    nulls.assign(n, 0);
+  }
+};
+
+struct BatchContext
+{
+  RowGroup* rg;
+  Row row;
+
+  inline Row& getRow(uint32_t rowNum)
+  {
+    rg->getRow(rowNum, &row);
+    return row;
+  }
+};
+
+class BatchNode
+{
+ public:
+  BatchNode(BatchKind kind, bool native) : fKind(kind), fNative(native)
+  {
+  }
+  virtual ~BatchNode() = default;
+
+  /* Evaluates the node on the rows listed in sel. A node is evaluated at most once per
+     top level call, so the result lives in the node until the parent is done with it. */
+  virtual const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) = 0;
+
+  BatchKind kind() const
+  {
+    return fKind;
+  }
+  // false if some part of the subtree is evaluated row by row
+  bool isNative() const
+  {
+    return fNative;
+  }
+
+ protected:
+  BatchKind fKind;
+  bool fNative;
+  BatchVector fOut;
+};
+
+typedef unique_ptr<BatchNode> SBN;
+
+namespace
+{
+bool isSignedInt(CalpontSystemCatalog::ColDataType t)
+{
+  switch (t)
+  {
+    case CalpontSystemCatalog::BIGINT:
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::MEDINT:
+    case CalpontSystemCatalog::SMALLINT:
+    case CalpontSystemCatalog::TINYINT: return true;
+    default: return false;
+  }
+}
+
+bool isFloatingPoint(CalpontSystemCatalog::ColDataType t)
+{
+  switch (t)
+  {
+    case CalpontSystemCatalog::DOUBLE:
+    case CalpontSystemCatalog::UDOUBLE:
+    case CalpontSystemCatalog::FLOAT:
+    case CalpontSystemCatalog::UFLOAT: return true;
+    default: return false;
+  }
+}
+
+bool isDouble(CalpontSystemCatalog::ColDataType t)
+{
+  return t == CalpontSystemCatalog::DOUBLE || t == CalpontSystemCatalog::UDOUBLE;
+}
+
+// the entries of sel for which pred(k) holds, and their positions k in sel
+template <typename F>
+inline void subSelect(const vector<uint32_t>& sel, F pred, vector<uint32_t>& subSel, vector<uint32_t>& pos)
+{
+  subSel.clear();
+  pos.clear();
+
+  for (uint32_t k = 0; k < sel.size(); k++)
+    if (pred(k))
+    {
+      subSel.push_back(sel[k]);
+      pos.push_back(k);
+    }
+}
+
+inline void scatter(BatchKind kind, const BatchVector& from, const vector<uint32_t>& pos, BatchVector& to)
+{
+  if (kind == BatchKind::Int)
+    for (uint32_t j = 0; j < pos.size(); j++)
+      to.ints[pos[j]] = from.ints[j];
+  else
+    for (uint32_t j = 0; j < pos.size(); j++)
+      to.doubles[pos[j]] = from.doubles[j];
+
+  for (uint32_t j = 0; j < pos.size(); j++)
+    to.nulls[pos[j]] = from.nulls[j];
+}
+
+/* Row based evaluation of a subtree the batch nodes don't cover. T is a ParseTree or a TreeNode. */
+template <typename T>
+class ValueFallback : public BatchNode
+{
+ public:
+  ValueFallback(T* node, BatchKind kind) : BatchNode(kind, false), fNode(node)
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    fOut.resize(fKind, sel.size());
+
+    for (uint32_t k = 0; k < sel.size(); k++)
+    {
+      bool isNull = false;
+
+      if (fKind == BatchKind::Int)
+        fOut.ints[k] = fNode->getIntVal(ctx.getRow(sel[k]), isNull);
+      else
+        fOut.doubles[k] = fNode->getDoubleVal(ctx.getRow(sel[k]), isNull);
+
+      fOut.nulls[k] = isNull;
+    }
+
+    return fOut;
+  }
+
+ private:
+  T* fNode;
+};
+
+class BoolFallback : public BatchNode
+{
+ public:
+  explicit BoolFallback(ParseTree* node) : BatchNode(BatchKind::Int, false), fNode(node)
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    fOut.resize(fKind, sel.size());
+
+    for (uint32_t k = 0; k < sel.size(); k++)
+    {
+      bool isNull = false;
+      fOut.ints[k] = fNode->getBoolVal(ctx.getRow(sel[k]), isNull);
+      fOut.nulls[k] = isNull;
+    }
+
+    return fOut;
+  }
+
+ private:
+  ParseTree* fNode;
+};
+
+/* A SimpleColumn. Reads the field straight from the row, converting to the requested kind
+   the same way TreeNode::getIntVal()/getDoubleVal() do. */
+class ColumnNode : public BatchNode
+{
+ public:
+  ColumnNode(SimpleColumn* sc, BatchKind kind)
+   : BatchNode(kind, true), fIndex(sc->inputIndex()), fType(sc->resultType().colDataType)
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    fOut.resize(fKind, sel.size());
+
+    switch (fType)
+    {
+      case CalpontSystemCatalog::DATE: read<uint32_t>(ctx, sel, [&](Row& r) { return r.getUintField<4>(fIndex); }); break;
+
+      case CalpontSystemCatalog::DATETIME:
+      case CalpontSystemCatalog::TIMESTAMP:
+      case CalpontSystemCatalog::TIME:
+        read<uint64_t>(ctx, sel, [&](Row& r) { return r.getUintField<8>(fIndex); });
+        break;
+
+      case CalpontSystemCatalog::FLOAT:
+      case CalpontSystemCatalog::UFLOAT:
+        read<float>(ctx, sel, [&](Row& r) { return r.getFloatField(fIndex); });
+        break;
+
+      case CalpontSystemCatalog::DOUBLE:
+      case CalpontSystemCatalog::UDOUBLE:
+        read<double>(ctx, sel, [&](Row& r) { return r.getDoubleField(fIndex); });
+        break;
+
+      default:
+        switch (ctx.row.getColumnWidth(fIndex))
+        {
+          case 1: read<int64_t>(ctx, sel, [&](Row& r) { return r.getIntField<1>(fIndex); }); break;
+          case 2: read<int64_t>(ctx, sel, [&](Row& r) { return r.getIntField<2>(fIndex); }); break;
+          case 4: read<int64_t>(ctx, sel, [&](Row& r) { return r.getIntField<4>(fIndex); }); break;
+          default: read<int64_t>(ctx, sel, [&](Row& r) { return r.getIntField<8>(fIndex); }); break;
+        }
+
+        break;
+    }
+
+    return fOut;
+  }
+
+  static bool supports(SimpleColumn* sc, BatchKind kind)
+  {
+    CalpontSystemCatalog::ColDataType t = sc->resultType().colDataType;
+
+    if (isSignedInt(t) || isFloatingPoint(t))
+      return true;
+
+    // the raw date values only make sense as integers
+    switch (t)
+    {
+      case CalpontSystemCatalog::DATE:
+      case CalpontSystemCatalog::DATETIME:
+      case CalpontSystemCatalog::TIMESTAMP:
+      case CalpontSystemCatalog::TIME: return kind == BatchKind::Int;
+      default: return false;
+    }
+  }
+
+ private:
+  template <typename T, typename F>
+  inline void read(BatchContext& ctx, const vector<uint32_t>& sel, F get)
+  {
+    for (uint32_t k = 0; k < sel.size(); k++)
+    {
+      Row& r = ctx.getRow(sel[k]);
+
+      if (r.isNullValue(fIndex))
+      {
+        fOut.nulls[k] = 1;
+        continue;
+      }
+
+      T val = get(r);
+
+      if (fKind == BatchKind::Int)
+        fOut.ints[k] = (int64_t)val;
+      else
+        fOut.doubles[k] = (double)val;
+    }
+  }
+
+  uint32_t fIndex;
+  CalpontSystemCatalog::ColDataType fType;
+};
+
+/* A ConstantColumn. Evaluated once per call and broadcast. */
+class ConstantNode : public BatchNode
+{
+ public:
+  ConstantNode(ConstantColumn* cc, BatchKind kind) : BatchNode(kind, true), fConst(cc)
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    fOut.resize(fKind, sel.size());
+
+    if (sel.empty())
+      return fOut;
+
+    bool isNull = false;
+    Row& r = ctx.getRow(sel[0]);
+
+    if (fKind == BatchKind::Int)
+      fOut.ints.assign(sel.size(), fConst->getIntVal(r, isNull));
+    else
+      fOut.doubles.assign(sel.size(), fConst->getDoubleVal(r, isNull));
+
+    fOut.nulls.assign(sel.size(), isNull);
+    return fOut;
+  }
+
+ private:
+  ConstantColumn* fConst;
+};
+
+/* Converts between the kinds for nodes whose result type is a signed integer or a double,
+   where TreeNode's conversions are plain casts. */
+class CastNode : public BatchNode
+{
+ public:
+  CastNode(SBN child, BatchKind kind) : BatchNode(kind, child->isNative()), fChild(std::move(child))
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    const BatchVector& in = fChild->eval(ctx, sel);
+    fOut.resize(fKind, sel.size());
+
+    if (fKind == BatchKind::Int)
+      for (uint32_t k = 0; k < sel.size(); k++)
+        fOut.ints[k] = (int64_t)in.doubles[k];
+    else
+      for (uint32_t k = 0; k < sel.size(); k++)
+        fOut.doubles[k] = (double)in.ints[k];
+
+    fOut.nulls = in.nulls;
+    return fOut;
+  }
+
+ private:
+  SBN fChild;
+};
+
+/* ArithmeticOperator on integer or double operands. Both sides are always evaluated, a zero
+   divisor gives null, see ArithmeticOperator::execute(). */
+class ArithmeticNode : public BatchNode
+{
+ public:
+  ArithmeticNode(OpType op, BatchKind kind, SBN lhs, SBN rhs)
+   : BatchNode(kind, lhs->isNative() && rhs->isNative())
+   , fOp(op)
+   , fLhs(std::move(lhs))
+   , fRhs(std::move(rhs))
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    const BatchVector& l = fLhs->eval(ctx, sel);
+    const BatchVector& r = fRhs->eval(ctx, sel);
+    size_t n = sel.size();
+    fOut.resize(fKind, n);
+
+    for (uint32_t k = 0; k < n; k++)
+      fOut.nulls[k] = l.nulls[k] | r.nulls[k];
+
+    if (fKind == BatchKind::Int)
+      apply(l.ints.data(), r.ints.data(), fOut.ints.data(), n);
+    else
+      apply(l.doubles.data(), r.doubles.data(), fOut.doubles.data(), n);
+
+    return fOut;
+  }
+
+ private:
+  template <typename T>
+  inline void apply(const T* l, const T* r, T* out, size_t n)
+  {
+    // integer math wraps around like the row based path does on every platform we build on
+    typedef typename std::conditional<std::is_integral<T>::value, uint64_t, T>::type W;
+
+    switch (fOp)
+    {
+      case OP_ADD:
+        for (size_t k = 0; k < n; k++)
+          out[k] = (T)((W)l[k] + (W)r[k]);
+
+        break;
+
+      case OP_SUB:
+        for (size_t k = 0; k < n; k++)
+          out[k] = (T)((W)l[k] - (W)r[k]);
+
+        break;
+
+      case OP_MUL:
+        for (size_t k = 0; k < n; k++)
+          out[k] = (T)((W)l[k] * (W)r[k]);
+
+        break;
+
+      default:
+        for (size_t k = 0; k < n; k++)
+        {
+          if (r[k] == 0)
+          {
+            out[k] = 0;
+            fOut.nulls[k] = 1;
+          }
+          else if (std::is_integral<T>::value && r[k] == (T)-1)
+            out[k] = (T)(-(W)l[k]);
+          else
+            out[k] = l[k] / r[k];
+        }
+
+        break;
+    }
+  }
+
+  OpType fOp;
+  SBN fLhs, fRhs;
+};
+
+/* =, <>, <, <=, >, >= of a SimpleFilter. Like PredicateOperator::getBoolVal() the right side is
+   only evaluated where the left side is not null. */
+class CompareNode : public BatchNode
+{
+ public:
+  CompareNode(OpType op, SBN lhs, SBN rhs)
+   : BatchNode(BatchKind::Int, lhs->isNative() && rhs->isNative())
+   , fOp(op)
+   , fLhs(std::move(lhs))
+   , fRhs(std::move(rhs))
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    const BatchVector& l = fLhs->eval(ctx, sel);
+    fOut.resize(fKind, sel.size());
+    subSelect(
+        sel, [&](uint32_t k) { return !l.nulls[k]; }, fSubSel, fPos);
+
+    for (uint32_t k = 0; k < sel.size(); k++)
+    {
+      fOut.ints[k] = 0;
+      fOut.nulls[k] = l.nulls[k];
+    }
+
+    const BatchVector& r = fRhs->eval(ctx, fSubSel);
+
+    if (fLhs->kind() == BatchKind::Int)
+      compare(l.ints, r.ints, r.nulls);
+    else
+      compare(l.doubles, r.doubles, r.nulls);
+
+    return fOut;
+  }
+
+ private:
+  template <typename T>
+  inline void compare(const vector<T>& l, const vector<T>& r, const vector<uint8_t>& rnulls)
+  {
+    for (uint32_t j = 0; j < fPos.size(); j++)
+    {
+      uint32_t k = fPos[j];
+      bool ret;
+
+      switch (fOp)
+      {
+        case OP_EQ: ret = l[k] == r[j]; break;
+        case OP_NE: ret = l[k] != r[j]; break;
+        case OP_GT: ret = l[k] > r[j]; break;
+        case OP_GE: ret = l[k] >= r[j]; break;
+        case OP_LT: ret = l[k] < r[j]; break;
+        default: ret = l[k] <= r[j]; break;
+      }
+
+      fOut.ints[k] = ret && !rnulls[j];
+      fOut.nulls[k] = rnulls[j];
+    }
+  }
+
+  OpType fOp;
+  SBN fLhs, fRhs;
+  vector<uint32_t> fSubSel, fPos;
+};
+
+class NullTestNode : public BatchNode
+{
+ public:
+  NullTestNode(SBN arg, bool notNull) : BatchNode(BatchKind::Int, arg->isNative()), fArg(std::move(arg)), fNotNull(notNull)
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    const BatchVector& a = fArg->eval(ctx, sel);
+    fOut.resize(fKind, sel.size());
+
+    for (uint32_t k = 0; k < sel.size(); k++)
+      fOut.ints[k] = (a.nulls[k] != 0) != fNotNull;
+
+    return fOut;
+  }
+
+ private:
+  SBN fArg;
+  bool fNotNull;
+};
+
+/* AND/OR/XOR, with the same short circuits as LogicOperator::getBoolVal(). The right side of an
+   AND sees the null flag the left side left behind, so rows where the left side is true but
+   null are handed to the row based path with that flag set. */
+class LogicNode : public BatchNode
+{
+ public:
+  LogicNode(OpType op, SBN lhs, SBN rhs, ParseTree* rhsTree)
+   : BatchNode(BatchKind::Int, lhs->isNative() && rhs->isNative())
+   , fOp(op)
+   , fLhs(std::move(lhs))
+   , fRhs(std::move(rhs))
+   , fRhsTree(rhsTree)
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    const BatchVector& l = fLhs->eval(ctx, sel);
+    fOut.resize(fKind, sel.size());
+
+    switch (fOp)
+    {
+      case OP_AND:
+      {
+        for (uint32_t k = 0; k < sel.size(); k++)
+        {
+          fOut.ints[k] = 0;
+          fOut.nulls[k] = l.nulls[k];
+
+          if (l.ints[k] && l.nulls[k])
+          {
+            bool isNull = true;
+            fOut.ints[k] = fRhsTree->getBoolVal(ctx.getRow(sel[k]), isNull);
+            fOut.nulls[k] = isNull;
+          }
+        }
+
+        subSelect(
+            sel, [&](uint32_t k) { return l.ints[k] && !l.nulls[k]; }, fSubSel, fPos);
+        scatter(fKind, fRhs->eval(ctx, fSubSel), fPos, fOut);
+        break;
+      }
+
+      case OP_OR:
+      {
+        for (uint32_t k = 0; k < sel.size(); k++)
+        {
+          fOut.ints[k] = 1;
+          fOut.nulls[k] = l.nulls[k];
+        }
+
+        subSelect(
+            sel, [&](uint32_t k) { return !l.ints[k]; }, fSubSel, fPos);
+        scatter(fKind, fRhs->eval(ctx, fSubSel), fPos, fOut);
+        break;
+      }
+
+      default:  // OP_XOR
+      {
+        for (uint32_t k = 0; k < sel.size(); k++)
+        {
+          fOut.ints[k] = 0;
+          fOut.nulls[k] = 1;
+        }
+
+        subSelect(
+            sel, [&](uint32_t k) { return !l.nulls[k]; }, fSubSel, fPos);
+        const BatchVector& r = fRhs->eval(ctx, fSubSel);
+
+        for (uint32_t j = 0; j < fPos.size(); j++)
+        {
+          uint32_t k = fPos[j];
+          fOut.nulls[k] = r.nulls[j];
+          fOut.ints[k] = !r.nulls[j] && ((l.ints[k] != 0) != (r.ints[j] != 0));
+        }
+
+        break;
+      }
+    }
+
+    return fOut;
+  }
+
+ private:
+  OpType fOp;
+  SBN fLhs, fRhs;
+  ParseTree* fRhsTree;
+  vector<uint32_t> fSubSel, fPos;
+};
+
+/* Evaluates each branch on the rows that picked it. Used by the conditional functions. */
+class BranchNode : public BatchNode
+{
+ public:
+  BranchNode(BatchKind kind, bool native) : BatchNode(kind, native)
+  {
+  }
+
+ protected:
+  // fBranch[k] is the index into fBranches of the branch of row k, or -1 for null
+  void evalBranches(BatchContext& ctx, const vector<uint32_t>& sel)
+  {
+    fOut.resize(fKind, sel.size());
+
+    for (uint32_t k = 0; k < sel.size(); k++)
+      fOut.nulls[k] = (fBranch[k] < 0);
+
+    for (int32_t b = 0; b < (int32_t)fBranches.size(); b++)
+    {
+      subSelect(
+          sel, [&](uint32_t k) { return fBranch[k] == b; }, fSubSel, fPos);
+
+      if (!fSubSel.empty())
+        scatter(fKind, fBranches[b]->eval(ctx, fSubSel), fPos, fOut);
+    }
+  }
+
+  static bool allNative(const vector<SBN>& nodes)
+  {
+    for (const auto& n : nodes)
+      if (!n->isNative())
+        return false;
+
+    return true;
+  }
+
+  vector<SBN> fBranches;
+  vector<int32_t> fBranch;
+  vector<uint32_t> fSubSel, fPos;
+};
+
+/* IF(cond, a, b), see Func_if. */
+class IfNode : public BranchNode
+{
+ public:
+  IfNode(BatchKind kind, SBN cond, SBN a, SBN b)
+   : BranchNode(kind, cond->isNative() && a->isNative() && b->isNative()), fCond(std::move(cond))
+  {
+    fBranches.push_back(std::move(a));
+    fBranches.push_back(std::move(b));
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    const BatchVector& c = fCond->eval(ctx, sel);
+    fBranch.resize(sel.size());
+
+    for (uint32_t k = 0; k < sel.size(); k++)
+      fBranch[k] = (c.ints[k] && !c.nulls[k]) ? 0 : 1;
+
+    evalBranches(ctx, sel);
+    return fOut;
+  }
+
+ private:
+  SBN fCond;
+};
+
+/* COALESCE(a, b, ...) and IFNULL(a, b), see Func_coalesce and Func_ifnull. Each argument is only
+   evaluated on the rows the previous ones left null. */
+class CoalesceNode : public BatchNode
+{
+ public:
+  CoalesceNode(BatchKind kind, vector<SBN> args) : BatchNode(kind, true), fArgs(std::move(args))
+  {
+    for (const auto& a : fArgs)
+      fNative = fNative && a->isNative();
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    fOut.resize(fKind, sel.size());
+    fOut.nulls.assign(sel.size(), 1);
+    fPending = sel;
+    fPendingPos.resize(sel.size());
+
+    for (uint32_t k = 0; k < sel.size(); k++)
+      fPendingPos[k] = k;
+
+    for (uint32_t i = 0; i < fArgs.size() && !fPending.empty(); i++)
+    {
+      const BatchVector& a = fArgs[i]->eval(ctx, fPending);
+      uint32_t left = 0;
+
+      for (uint32_t j = 0; j < fPending.size(); j++)
+      {
+        uint32_t k = fPendingPos[j];
+
+        if (a.nulls[j])
+        {
+          fPending[left] = fPending[j];
+          fPendingPos[left++] = k;
+          continue;
+        }
+
+        if (fKind == BatchKind::Int)
+          fOut.ints[k] = a.ints[j];
+        else
+          fOut.doubles[k] = a.doubles[j];
+
+        fOut.nulls[k] = 0;
+      }
+
+      fPending.resize(left);
+      fPendingPos.resize(left);
+    }
+
+    return fOut;
+  }
+
+ private:
+  vector<SBN> fArgs;
+  vector<uint32_t> fPending, fPendingPos;
+};
+
+/* CASE WHEN c1 THEN r1 ... [ELSE e] END, see searched_case_cmp(). The conditions share one null
+   flag, so once a condition came out null the later ones of that row run on the row based
+   path with the flag set. */
+class SearchedCaseNode : public BranchNode
+{
+ public:
+  SearchedCaseNode(BatchKind kind, vector<SBN> whens, vector<ParseTree*> whenTrees, vector<SBN> results)
+   : BranchNode(kind, allNative(whens) && allNative(results))
+   , fWhens(std::move(whens))
+   , fWhenTrees(std::move(whenTrees))
+  {
+    fBranches = std::move(results);
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    bool hasElse = fBranches.size() > fWhens.size();
+    fBranch.assign(sel.size(), -1);
+    fDirty.assign(sel.size(), 0);
+
+    for (uint32_t i = 0; i < fWhens.size(); i++)
+    {
+      subSelect(
+          sel, [&](uint32_t k) { return fBranch[k] < 0 && !fDirty[k]; }, fWhenSel, fWhenPos);
+
+      for (uint32_t k = 0; k < sel.size(); k++)
+      {
+        if (fBranch[k] >= 0 || !fDirty[k])
+          continue;
+
+        bool isNull = true;
+
+        if (fWhenTrees[i]->getBoolVal(ctx.getRow(sel[k]), isNull))
+          fBranch[k] = i;
+      }
+
+      const BatchVector& c = fWhens[i]->eval(ctx, fWhenSel);
+
+      for (uint32_t j = 0; j < fWhenPos.size(); j++)
+      {
+        uint32_t k = fWhenPos[j];
+
+        if (c.ints[j])
+          fBranch[k] = i;
+        else if (c.nulls[j])
+          fDirty[k] = 1;
+      }
+    }
+
+    if (hasElse)
+      for (uint32_t k = 0; k < sel.size(); k++)
+        if (fBranch[k] < 0)
+          fBranch[k] = fWhens.size();
+
+    evalBranches(ctx, sel);
+    return fOut;
+  }
+
+ private:
+  vector<SBN> fWhens;
+  vector<ParseTree*> fWhenTrees;
+  vector<uint8_t> fDirty;
+  vector<uint32_t> fWhenSel, fWhenPos;
+};
+
+/* CASE e WHEN v1 THEN r1 ... [ELSE x] END on an integer operation type, see simple_case_cmp(). */
+class SimpleCaseNode : public BranchNode
+{
+ public:
+  SimpleCaseNode(BatchKind kind, SBN expr, vector<SBN> whens, vector<SBN> results)
+   : BranchNode(kind, expr->isNative() && allNative(whens) && allNative(results))
+   , fExpr(std::move(expr))
+   , fWhens(std::move(whens))
+  {
+    fBranches = std::move(results);
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    bool hasElse = fBranches.size() > fWhens.size();
+    const BatchVector& e = fExpr->eval(ctx, sel);
+    fBranch.assign(sel.size(), -1);
+
+    for (uint32_t i = 0; i < fWhens.size(); i++)
+    {
+      subSelect(
+          sel, [&](uint32_t k) { return fBranch[k] < 0 && !e.nulls[k]; }, fWhenSel, fWhenPos);
+
+      if (fWhenSel.empty())
+        break;
+
+      const BatchVector& w = fWhens[i]->eval(ctx, fWhenSel);
+
+      for (uint32_t j = 0; j < fWhenPos.size(); j++)
+        if (!w.nulls[j] && w.ints[j] == e.ints[fWhenPos[j]])
+          fBranch[fWhenPos[j]] = i;
+    }
+
+    // a null expression takes the ELSE branch, BUG 5110
+    if (hasElse)
+      for (uint32_t k = 0; k < sel.size(); k++)
+        if (fBranch[k] < 0)
+          fBranch[k] = fWhens.size();
+
+    evalBranches(ctx, sel);
+    return fOut;
+  }
+
+ private:
+  SBN fExpr;
+  vector<SBN> fWhens;
+  vector<uint32_t> fWhenSel, fWhenPos;
+};
+
+/* YEAR/MONTH/DAY of a DATE or DATETIME, see Func_year, Func_month and Func_day. */
+class DatePartNode : public BatchNode
+{
+ public:
+  DatePartNode(SBN arg, uint32_t shift, uint64_t mask)
+   : BatchNode(BatchKind::Int, arg->isNative()), fArg(std::move(arg)), fShift(shift), fMask(mask)
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    const BatchVector& a = fArg->eval(ctx, sel);
+    fOut.resize(fKind, sel.size());
+
+    for (uint32_t k = 0; k < sel.size(); k++)
+      fOut.ints[k] = ((uint64_t)a.ints[k] >> fShift) & fMask;
+
+    fOut.nulls = a.nulls;
+    return fOut;
+  }
+
+ private:
+  SBN fArg;
+  uint32_t fShift;
+  uint64_t fMask;
+};
+
+/* LENGTH of a CHAR or VARCHAR column, see Func_length. */
+class LengthNode : public BatchNode
+{
+ public:
+  explicit LengthNode(SimpleColumn* sc) : BatchNode(BatchKind::Int, true), fIndex(sc->inputIndex())
+  {
+  }
+
+  const BatchVector& eval(BatchContext& ctx, const vector<uint32_t>& sel) override
+  {
+    fOut.resize(fKind, sel.size());
+
+    for (uint32_t k = 0; k < sel.size(); k++)
+    {
+      Row& r = ctx.getRow(sel[k]);
+
+      if (r.isNullValue(fIndex))
+      {
+        fOut.ints[k] = 0;
+        fOut.nulls[k] = 1;
+        continue;
+      }
+
+      utils::ConstString str = r.getConstString(fIndex);
+      fOut.ints[k] = str.str() ? strnlen(str.str(), str.length()) : 0;
+    }
+
+    return fOut;
+  }
+
+ private:
+  uint32_t fIndex;
+};
+
+SBN compileValue(TreeNode* node, BatchKind kind);
+
+SBN compileValue(ParseTree* pt, BatchKind kind)
+{
+  if (!pt->left() || !pt->right())
+    return compileValue(pt->data(), kind);
+
+  ArithmeticOperator* op = dynamic_cast<ArithmeticOperator*>(pt->data());
+
+  if (op && op->op() >= OP_ADD && op->op() <= OP_DIV)
+  {
+    CalpontSystemCatalog::ColDataType opType = op->operationType().colDataType;
+    CalpontSystemCatalog::ColDataType resType = op->resultType().colDataType;
+    BatchKind native;
+
+    if (isSignedInt(opType) && isSignedInt(resType))
+      native = BatchKind::Int;
+    else if (isFloatingPoint(opType) && isDouble(resType))
+      native = BatchKind::Double;
+    else
+      return SBN(new ValueFallback<ParseTree>(pt, kind));
+
+    SBN node(new ArithmeticNode(op->op(), native, compileValue(pt->left(), native),
+                                compileValue(pt->right(), native)));
+
+    if (native != kind)
+      node.reset(new CastNode(std::move(node), kind));
+
+    return node;
+  }
+
+  return SBN(new ValueFallback<ParseTree>(pt, kind));
+}
+
+SBN compileBool(ParseTree* pt);
+
+SBN compileFunction(FunctionColumn* fc, BatchKind kind)
+{
+  const string& name = fc->functionName();
+  const FunctionParm& parms = fc->functionParms();
+
+  if (name == "if" && parms.size() == 3)
+  {
+    // Func_if tests non boolean conditions by type, only take over real predicates
+    SBN cond = compileBool(parms[0].get());
+
+    if (cond->isNative())
+      return SBN(new IfNode(kind, std::move(cond), compileValue(parms[1]->data(), kind),
+                            compileValue(parms[2]->data(), kind)));
+  }
+  else if ((name == "coalesce" && !parms.empty()) || (name == "ifnull" && parms.size() == 2))
+  {
+    vector<SBN> args;
+
+    for (const auto& p : parms)
+      args.push_back(compileValue(p->data(), kind));
+
+    return SBN(new CoalesceNode(kind, std::move(args)));
+  }
+  else if (name == "case_searched" && parms.size() >= 2)
+  {
+    uint32_t whereCount = parms.size() / 2;
+    vector<SBN> whens, results;
+    vector<ParseTree*> whenTrees;
+
+    for (uint32_t i = 0; i < whereCount; i++)
+    {
+      whens.push_back(compileBool(parms[i].get()));
+      whenTrees.push_back(parms[i].get());
+    }
+
+    for (uint32_t i = whereCount; i < parms.size(); i++)
+      results.push_back(compileValue(parms[i]->data(), kind));
+
+    return SBN(new SearchedCaseNode(kind, std::move(whens), std::move(whenTrees), std::move(results)));
+  }
+  else if (name == "case_simple" && parms.size() >= 3 &&
+           (isSignedInt(fc->operationType().colDataType) ||
+            fc->operationType().colDataType == CalpontSystemCatalog::DATE))
+  {
+    uint32_t whereCount = (parms.size() - 1) / 2;
+    vector<SBN> whens, results;
+
+    for (uint32_t i = 1; i <= whereCount; i++)
+      whens.push_back(compileValue(parms[i]->data(), BatchKind::Int));
+
+    for (uint32_t i = whereCount + 1; i < parms.size(); i++)
+      results.push_back(compileValue(parms[i]->data(), kind));
+
+    return SBN(new SimpleCaseNode(kind, compileValue(parms[0]->data(), BatchKind::Int), std::move(whens),
+                                  std::move(results)));
+  }
+  else if (kind == BatchKind::Int && parms.size() == 1 &&
+           (name == "year" || name == "month" || name == "day" || name == "dayofmonth"))
+  {
+    CalpontSystemCatalog::ColDataType argType = parms[0]->data()->resultType().colDataType;
+    bool isDate = (argType == CalpontSystemCatalog::DATE);
+
+    if (isDate || argType == CalpontSystemCatalog::DATETIME)
+    {
+      SBN arg = compileValue(parms[0]->data(), BatchKind::Int);
+
+      if (name == "year")
+        return SBN(new DatePartNode(std::move(arg), isDate ? 16 : 48, 0xffff));
+      else if (name == "month")
+        return SBN(new DatePartNode(std::move(arg), isDate ? 12 : 44, 0xf));
+      else
+        return SBN(new DatePartNode(std::move(arg), isDate ? 6 : 38, 0x3f));
+    }
+  }
+  else if (kind == BatchKind::Int && parms.size() == 1 && (name == "length" || name == "octet_length"))
+  {
+    SimpleColumn* sc = dynamic_cast<SimpleColumn*>(parms[0]->data());
+
+    if (sc && (sc->resultType().colDataType == CalpontSystemCatalog::CHAR ||
+               sc->resultType().colDataType == CalpontSystemCatalog::VARCHAR))
+      return SBN(new LengthNode(sc));
+  }
+
+  return SBN(new ValueFallback<TreeNode>(fc, kind));
+}
+
+SBN compileValue(TreeNode* node, BatchKind kind)
+{
+  if (SimpleColumn* sc = dynamic_cast<SimpleColumn*>(node))
+  {
+    if (ColumnNode::supports(sc, kind))
+      return SBN(new ColumnNode(sc, kind));
+  }
+  else if (ConstantColumn* cc = dynamic_cast<ConstantColumn*>(node))
+  {
+    return SBN(new ConstantNode(cc, kind));
+  }
+  else if (ArithmeticColumn* ac = dynamic_cast<ArithmeticColumn*>(node))
+  {
+    // ArithmeticColumn hands every getter straight to its expression
+    if (ac->expression())
+      return compileValue(ac->expression(), kind);
+  }
+  else if (FunctionColumn* fc = dynamic_cast<FunctionColumn*>(node))
+  {
+    return compileFunction(fc, kind);
+  }
+
+  return SBN(new ValueFallback<TreeNode>(node, kind));
+}
+
+SBN compileBool(ParseTree* pt)
+{
+  if (pt->left() && pt->right())
+  {
+    LogicOperator* lo = dynamic_cast<LogicOperator*>(pt->data());
+
+    if (lo && (lo->op() == OP_AND || lo->op() == OP_OR || lo->op() == OP_XOR))
+      return SBN(new LogicNode(lo->op(), compileBool(pt->left()), compileBool(pt->right()), pt->right()));
+
+    return SBN(new BoolFallback(pt));
+  }
+
+  SimpleFilter* sf = dynamic_cast<SimpleFilter*>(pt->data());
+  PredicateOperator* po = (sf ? dynamic_cast<PredicateOperator*>(sf->op().get()) : NULL);
+
+  if (!po)
+    return SBN(new BoolFallback(pt));
+
+  CalpontSystemCatalog::ColDataType opType = po->operationType().colDataType;
+  BatchKind kind;
+
+  if (isSignedInt(opType))
+    kind = BatchKind::Int;
+  else if (isFloatingPoint(opType))
+    kind = BatchKind::Double;
+  else
+    return SBN(new BoolFallback(pt));
+
+  switch (po->op())
+  {
+    case OP_ISNULL:
+    case OP_ISNOTNULL:
+      return SBN(new NullTestNode(compileValue(sf->lhs(), kind), po->op() == OP_ISNOTNULL));
+
+    case OP_EQ:
+    case OP_NE:
+    case OP_GT:
+    case OP_GE:
+    case OP_LT:
+    case OP_LE:
+      return SBN(new CompareNode(po->op(), compileValue(sf->lhs(), kind), compileValue(sf->rhs(), kind)));
+
+    default: return SBN(new BoolFallback(pt));
+  }
+}
+
+}  // namespace
+
+BatchEvaluator::BatchEvaluator(ParseTree* filter) : fRoot(compileBool(filter)), fExpression(NULL)
+{
+}
+
+BatchEvaluator::BatchEvaluator(ReturnedColumn* expression) : fExpression(expression)
+{
+  CalpontSystemCatalog::ColDataType t = expression->resultType().colDataType;
+
+  // the other result types are stored by FuncExp::evaluate() row by row
+  if (isSignedInt(t))
+    fRoot = compileValue(expression, BatchKind::Int);
+  else if (isDouble(t))
+    fRoot = compileValue(expression, BatchKind::Double);
+}
+
+BatchEvaluator::~BatchEvaluator()
+{
+}
+
+void BatchEvaluator::filter(RowGroup& rg, vector<uint32_t>& sel)
+{
+  BatchContext ctx;
+  ctx.rg = &rg;
+  rg.initRow(&ctx.row);
+
+  const BatchVector& result = fRoot->eval(ctx, sel);
+  uint32_t passed = 0;
+
+  for (uint32_t k = 0; k < sel.size(); k++)
+    if (result.ints[k])
+      sel[passed++] = sel[k];
+
+  sel.resize(passed);
+}
+
+void BatchEvaluator::project(RowGroup& rg, const vector<uint32_t>& sel)
+{
+  BatchContext ctx;
+  ctx.rg = &rg;
+  rg.initRow(&ctx.row);
+
+  if (!fRoot)
+  {
+    FuncExp* fe = FuncExp::instance();
+
+    for (uint32_t k = 0; k < sel.size(); k++)
+      fe->evaluate(ctx.getRow(sel[k]), *fExpression);
+
+    return;
+  }
+
+  const BatchVector& result = fRoot->eval(ctx, sel);
+  uint32_t col = fExpression->outputIndex();
+
+  switch (fExpression->resultType().colDataType)
+  {
+    case CalpontSystemCatalog::BIGINT:
+      for (uint32_t k = 0; k < sel.size(); k++)
+        ctx.getRow(sel[k]).setIntField<8>(result.nulls[k] ? BIGINTNULL : result.ints[k], col);
+
+      break;
+
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::MEDINT:
+      for (uint32_t k = 0; k < sel.size(); k++)
+        ctx.getRow(sel[k]).setIntField<4>(result.nulls[k] ? INTNULL : result.ints[k], col);
+
+      break;
+
+    case CalpontSystemCatalog::SMALLINT:
+      for (uint32_t k = 0; k < sel.size(); k++)
+        ctx.getRow(sel[k]).setIntField<2>(result.nulls[k] ? SMALLINTNULL : result.ints[k], col);
+
+      break;
+
+    case CalpontSystemCatalog::TINYINT:
+      for (uint32_t k = 0; k < sel.size(); k++)
+        ctx.getRow(sel[k]).setIntField<1>(result.nulls[k] ? TINYINTNULL : result.ints[k], col);
+
+      break;
+
+    default:  // DOUBLE, UDOUBLE
+      for (uint32_t k = 0; k < sel.size(); k++)
+      {
+        Row& r = ctx.getRow(sel[k]);
+
+        if (result.nulls[k])
+          r.setIntField<8>(DOUBLENULL, col);
+        else
+          r.setDoubleField(result.doubles[k], col);
+      }
+
+      break;
+  }
+}
+
+}  // namespace funcexp
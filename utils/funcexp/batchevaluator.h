@@ -0,0 +1,78 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "rowgroup.h"
+#include "parsetree.h"
+#include "returnedcolumn.h"
+
+namespace funcexp
+{
+class BatchNode;
+
+/** @brief Column-at-a-time evaluation of a filter or an expression over a RowGroup
+ *
+ *  The tree is compiled once into typed batch nodes, each of which evaluates one operation
+ *  over a whole selection of rows into an int64_t or double vector plus a null vector.
+ *  Covered are column references, constants, integer and double arithmetic, numeric
+ *  comparisons, AND/OR/XOR, IF, IFNULL, COALESCE, both CASE forms, YEAR/MONTH/DAY and
+ *  LENGTH. Every other node falls back to the row based F&E calls for its own subtree only,
+ *  so the results are the same as the row based FuncExp::evaluate() path.
+ *
+ *  The evaluator keeps pointers into the tree it was built from and reuses the tree's
+ *  result buffers on fallback, so like the tree itself it must not be shared between threads.
+ */
+class BatchEvaluator
+{
+ public:
+  /** @brief build an evaluator for a filter */
+  explicit BatchEvaluator(execplan::ParseTree* filter);
+
+  /** @brief build an evaluator for an expression that is stored at its outputIndex() */
+  explicit BatchEvaluator(execplan::ReturnedColumn* expression);
+
+  ~BatchEvaluator();
+
+  /** @brief evaluate the filter on the rows of rg listed in sel
+   *
+   * @param rg the rowgroup with the input columns of the filter
+   * @param sel indexes of the rows to evaluate. The rows that fail are removed from it.
+   */
+  void filter(rowgroup::RowGroup& rg, std::vector<uint32_t>& sel);
+
+  /** @brief evaluate the expression on the rows of rg listed in sel
+   *
+   * @param rg the rowgroup with the input columns and the output column of the expression
+   * @param sel indexes of the rows to evaluate
+   */
+  void project(rowgroup::RowGroup& rg, const std::vector<uint32_t>& sel);
+
+ private:
+  BatchEvaluator(const BatchEvaluator&) = delete;
+  BatchEvaluator& operator=(const BatchEvaluator&) = delete;
+
+  std::unique_ptr<BatchNode> fRoot;
+  execplan::ReturnedColumn* fExpression;
+};
+
+}  // namespace funcexp
@@ -26,6 +26,7 @@
 using namespace std;
 
 #include "utils/pcre2/jpcre2.hpp"
+#include "regexcache.h"
 
 #include "functor_bool.h"
 #include "functor_str.h"
@@ -308,7 +309,7 @@ std::string Func_regexp_replace::getStrVal(rowgroup::Row& row, FunctionParm& fp,
 
   PCREOptions options(ct);
   param.CharsetFix(options);
-  jp::Regex re(param.pattern, options.flags);
+  jp::Regex& re = threadRegexCache().get(param.pattern, options.flags);
 
   const auto& replaceWithStr = replaceWith.unsafeStringRef();
   if (options.conversionIsNeeded)
@@ -336,7 +337,7 @@ std::string Func_regexp_substr::getStrVal(rowgroup::Row& row, FunctionParm& fp,
   PCREOptions options(ct);
   param.CharsetFix(options);
 
-  jp::Regex re(param.pattern, options.flags);
+  jp::Regex& re = threadRegexCache().get(param.pattern, options.flags);
   jp::RegexMatch rm(&re);
   jp::VecNum vec_num;
 
@@ -364,7 +365,7 @@ std::string Func_regexp_instr::getStrVal(rowgroup::Row& row, FunctionParm& fp, b
   PCREOptions options(ct);
   param.CharsetFix(options);
 
-  jp::Regex re(param.pattern, options.flags);
+  jp::Regex& re = threadRegexCache().get(param.pattern, options.flags);
   jp::RegexMatch rm(&re);
   jpcre2::VecOff vec_soff;
 
@@ -394,7 +395,7 @@ bool Func_regexp::getBoolVal(rowgroup::Row& row, FunctionParm& fp, bool& isNull,
   PCREOptions options(ct);
   param.CharsetFix(options);
 
-  jp::Regex re(param.pattern, options.flags);
+  jp::Regex& re = threadRegexCache().get(param.pattern, options.flags);
   return re.match(param.expression);
 }
 
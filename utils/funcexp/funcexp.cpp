@@ -25,6 +25,7 @@
 #include <boost/thread/mutex.hpp>
 
 #include "funcexp.h"
+#include "batchevaluator.h"
 #include "functor_all.h"
 #include "functor_bool.h"
 #include "functor_dtm.h"
@@ -295,261 +296,303 @@ Func* FuncExp::getFunctor(std::string& funcName)
     return (*iter).second;
 }
 
-void FuncExp::evaluate(rowgroup::Row& row, std::vector<execplan::SRCP>& expression)
+void FuncExp::evaluate(rowgroup::RowGroup& rowgroup, BatchEvaluator& filter)
 {
-  bool isNull;
+  std::vector<uint32_t> sel(rowgroup.getRowCount());
 
-  for (uint32_t i = 0; i < expression.size(); i++)
+  for (uint32_t i = 0; i < sel.size(); i++)
+    sel[i] = i;
+
+  filter.filter(rowgroup, sel);
+
+  if (sel.size() == rowgroup.getRowCount())
+    return;
+
+  // the rows move within one RGData, so the string table offsets stay valid
+  rowgroup::Row in, out;
+  rowgroup.initRow(&in);
+  rowgroup.initRow(&out);
+
+  for (uint32_t i = 0; i < sel.size(); i++)
   {
-    isNull = false;
+    if (sel[i] == i)
+      continue;
+
+    rowgroup.getRow(sel[i], &in);
+    rowgroup.getRow(i, &out);
+    memcpy(out.getData(), in.getData(), in.getSize());
+  }
 
-    switch (expression[i]->resultType().colDataType)
+  rowgroup.setRowCount(sel.size());
+}
+
+void FuncExp::evaluate(rowgroup::RowGroup& rowgroup, std::vector<std::unique_ptr<BatchEvaluator> >& expressions)
+{
+  std::vector<uint32_t> sel(rowgroup.getRowCount());
+
+  for (uint32_t i = 0; i < sel.size(); i++)
+    sel[i] = i;
+
+  for (uint32_t i = 0; i < expressions.size(); i++)
+    expressions[i]->project(rowgroup, sel);
+}
+
+void FuncExp::evaluate(rowgroup::Row& row, std::vector<execplan::SRCP>& expression)
+{
+  for (uint32_t i = 0; i < expression.size(); i++)
+    evaluate(row, *expression[i]);
+}
+
+void FuncExp::evaluate(rowgroup::Row& row, execplan::ReturnedColumn& expression)
+{
+  bool isNull = false;
+
+  switch (expression.resultType().colDataType)
+  {
+    case CalpontSystemCatalog::DATE:
     {
-      case CalpontSystemCatalog::DATE:
-      {
-        int64_t val = expression[i]->getIntVal(row, isNull);
+      int64_t val = expression.getIntVal(row, isNull);
 
-        // @bug6061, workaround date_add always return datetime for both date and datetime
-        if (val & 0xFFFFFFFF00000000)
-          val = (((val >> 32) & 0xFFFFFFC0) | 0x3E);
+      // @bug6061, workaround date_add always return datetime for both date and datetime
+      if (val & 0xFFFFFFFF00000000)
+        val = (((val >> 32) & 0xFFFFFFC0) | 0x3E);
 
-        if (isNull)
-          row.setUintField<4>(DATENULL, expression[i]->outputIndex());
-        else
-          row.setUintField<4>(val, expression[i]->outputIndex());
+      if (isNull)
+        row.setUintField<4>(DATENULL, expression.outputIndex());
+      else
+        row.setUintField<4>(val, expression.outputIndex());
 
-        break;
-      }
+      break;
+    }
 
-      case CalpontSystemCatalog::DATETIME:
-      {
-        int64_t val = expression[i]->getDatetimeIntVal(row, isNull);
+    case CalpontSystemCatalog::DATETIME:
+    {
+      int64_t val = expression.getDatetimeIntVal(row, isNull);
 
-        if (isNull)
-          row.setUintField<8>(DATETIMENULL, expression[i]->outputIndex());
-        else
-          row.setUintField<8>(val, expression[i]->outputIndex());
+      if (isNull)
+        row.setUintField<8>(DATETIMENULL, expression.outputIndex());
+      else
+        row.setUintField<8>(val, expression.outputIndex());
 
-        break;
-      }
+      break;
+    }
 
-      case CalpontSystemCatalog::TIMESTAMP:
-      {
-        int64_t val = expression[i]->getTimestampIntVal(row, isNull);
+    case CalpontSystemCatalog::TIMESTAMP:
+    {
+      int64_t val = expression.getTimestampIntVal(row, isNull);
 
-        if (isNull)
-          row.setUintField<8>(TIMESTAMPNULL, expression[i]->outputIndex());
-        else
-          row.setUintField<8>(val, expression[i]->outputIndex());
+      if (isNull)
+        row.setUintField<8>(TIMESTAMPNULL, expression.outputIndex());
+      else
+        row.setUintField<8>(val, expression.outputIndex());
 
-        break;
-      }
+      break;
+    }
 
-      case CalpontSystemCatalog::TIME:
-      {
-        int64_t val = expression[i]->getTimeIntVal(row, isNull);
+    case CalpontSystemCatalog::TIME:
+    {
+      int64_t val = expression.getTimeIntVal(row, isNull);
 
-        if (isNull)
-          row.setIntField<8>(TIMENULL, expression[i]->outputIndex());
-        else
-          row.setIntField<8>(val, expression[i]->outputIndex());
+      if (isNull)
+        row.setIntField<8>(TIMENULL, expression.outputIndex());
+      else
+        row.setIntField<8>(val, expression.outputIndex());
 
-        break;
-      }
+      break;
+    }
 
-      case CalpontSystemCatalog::CHAR:
-      case CalpontSystemCatalog::VARCHAR:
+    case CalpontSystemCatalog::CHAR:
+    case CalpontSystemCatalog::VARCHAR:
 
-      // TODO: might not be right thing for BLOB
-      case CalpontSystemCatalog::BLOB:
-      case CalpontSystemCatalog::TEXT:
+    // TODO: might not be right thing for BLOB
+    case CalpontSystemCatalog::BLOB:
+    case CalpontSystemCatalog::TEXT:
+    {
+      const utils::NullString& val = expression.getStrVal(row, isNull);
+
+      // XXX: TODO: we may as well set the string field directly.
+      if (isNull)
       {
-        const utils::NullString& val = expression[i]->getStrVal(row, isNull);
+        utils::NullString nullstr;
+        row.setStringField(nullstr, expression.outputIndex());
+      }
+      else
+        row.setStringField(val, expression.outputIndex());
 
-        // XXX: TODO: we may as well set the string field directly.
-        if (isNull)
-        {
-          utils::NullString nullstr;
-          row.setStringField(nullstr, expression[i]->outputIndex());
-        }
-        else
-          row.setStringField(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::BIGINT:
+    {
+      int64_t val = expression.getIntVal(row, isNull);
 
-      case CalpontSystemCatalog::BIGINT:
-      {
-        int64_t val = expression[i]->getIntVal(row, isNull);
+      if (isNull)
+        row.setIntField<8>(BIGINTNULL, expression.outputIndex());
+      else
+        row.setIntField<8>(val, expression.outputIndex());
 
-        if (isNull)
-          row.setIntField<8>(BIGINTNULL, expression[i]->outputIndex());
-        else
-          row.setIntField<8>(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::UBIGINT:
+    {
+      uint64_t val = expression.getUintVal(row, isNull);
 
-      case CalpontSystemCatalog::UBIGINT:
-      {
-        uint64_t val = expression[i]->getUintVal(row, isNull);
+      if (isNull)
+        row.setUintField<8>(UBIGINTNULL, expression.outputIndex());
+      else
+        row.setUintField<8>(val, expression.outputIndex());
 
-        if (isNull)
-          row.setUintField<8>(UBIGINTNULL, expression[i]->outputIndex());
-        else
-          row.setUintField<8>(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::MEDINT:
+    {
+      int64_t val = expression.getIntVal(row, isNull);
 
-      case CalpontSystemCatalog::INT:
-      case CalpontSystemCatalog::MEDINT:
-      {
-        int64_t val = expression[i]->getIntVal(row, isNull);
+      if (isNull)
+        row.setIntField<4>(INTNULL, expression.outputIndex());
+      else
+        row.setIntField<4>(val, expression.outputIndex());
 
-        if (isNull)
-          row.setIntField<4>(INTNULL, expression[i]->outputIndex());
-        else
-          row.setIntField<4>(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::UINT:
+    case CalpontSystemCatalog::UMEDINT:
+    {
+      uint64_t val = expression.getUintVal(row, isNull);
 
-      case CalpontSystemCatalog::UINT:
-      case CalpontSystemCatalog::UMEDINT:
-      {
-        uint64_t val = expression[i]->getUintVal(row, isNull);
+      if (isNull)
+        row.setUintField<4>(UINTNULL, expression.outputIndex());
+      else
+        row.setUintField<4>(val, expression.outputIndex());
 
-        if (isNull)
-          row.setUintField<4>(UINTNULL, expression[i]->outputIndex());
-        else
-          row.setUintField<4>(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::SMALLINT:
+    {
+      int64_t val = expression.getIntVal(row, isNull);
 
-      case CalpontSystemCatalog::SMALLINT:
-      {
-        int64_t val = expression[i]->getIntVal(row, isNull);
+      if (isNull)
+        row.setIntField<2>(SMALLINTNULL, expression.outputIndex());
+      else
+        row.setIntField<2>(val, expression.outputIndex());
 
-        if (isNull)
-          row.setIntField<2>(SMALLINTNULL, expression[i]->outputIndex());
-        else
-          row.setIntField<2>(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::USMALLINT:
+    {
+      uint64_t val = expression.getUintVal(row, isNull);
 
-      case CalpontSystemCatalog::USMALLINT:
-      {
-        uint64_t val = expression[i]->getUintVal(row, isNull);
+      if (isNull)
+        row.setUintField<2>(USMALLINTNULL, expression.outputIndex());
+      else
+        row.setUintField<2>(val, expression.outputIndex());
 
-        if (isNull)
-          row.setUintField<2>(USMALLINTNULL, expression[i]->outputIndex());
-        else
-          row.setUintField<2>(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::TINYINT:
+    {
+      int64_t val = expression.getIntVal(row, isNull);
 
-      case CalpontSystemCatalog::TINYINT:
-      {
-        int64_t val = expression[i]->getIntVal(row, isNull);
+      if (isNull)
+        row.setIntField<1>(TINYINTNULL, expression.outputIndex());
+      else
+        row.setIntField<1>(val, expression.outputIndex());
 
-        if (isNull)
-          row.setIntField<1>(TINYINTNULL, expression[i]->outputIndex());
-        else
-          row.setIntField<1>(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::UTINYINT:
+    {
+      uint64_t val = expression.getUintVal(row, isNull);
 
-      case CalpontSystemCatalog::UTINYINT:
-      {
-        uint64_t val = expression[i]->getUintVal(row, isNull);
+      if (isNull)
+        row.setUintField<1>(UTINYINTNULL, expression.outputIndex());
+      else
+        row.setUintField<1>(val, expression.outputIndex());
 
-        if (isNull)
-          row.setUintField<1>(UTINYINTNULL, expression[i]->outputIndex());
-        else
-          row.setUintField<1>(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    // In this case, we're trying to load a double output column with float data. This is the
+    // case when you do sum(floatcol), e.g.
+    case CalpontSystemCatalog::DOUBLE:
+    case CalpontSystemCatalog::UDOUBLE:
+    {
+      double val = expression.getDoubleVal(row, isNull);
 
-      // In this case, we're trying to load a double output column with float data. This is the
-      // case when you do sum(floatcol), e.g.
-      case CalpontSystemCatalog::DOUBLE:
-      case CalpontSystemCatalog::UDOUBLE:
-      {
-        double val = expression[i]->getDoubleVal(row, isNull);
+      if (isNull)
+        row.setIntField<8>(DOUBLENULL, expression.outputIndex());
+      else
+        row.setDoubleField(val, expression.outputIndex());
 
-        if (isNull)
-          row.setIntField<8>(DOUBLENULL, expression[i]->outputIndex());
-        else
-          row.setDoubleField(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::FLOAT:
+    case CalpontSystemCatalog::UFLOAT:
+    {
+      float val = expression.getFloatVal(row, isNull);
 
-      case CalpontSystemCatalog::FLOAT:
-      case CalpontSystemCatalog::UFLOAT:
-      {
-        float val = expression[i]->getFloatVal(row, isNull);
+      if (isNull)
+        row.setIntField<4>(FLOATNULL, expression.outputIndex());
+      else
+        row.setFloatField(val, expression.outputIndex());
 
-        if (isNull)
-          row.setIntField<4>(FLOATNULL, expression[i]->outputIndex());
-        else
-          row.setFloatField(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::LONGDOUBLE:
+    {
+      long double val = expression.getLongDoubleVal(row, isNull);
 
-      case CalpontSystemCatalog::LONGDOUBLE:
-      {
-        long double val = expression[i]->getLongDoubleVal(row, isNull);
+      if (isNull)
+        row.setLongDoubleField(LONGDOUBLENULL, expression.outputIndex());
+      else
+        row.setLongDoubleField(val, expression.outputIndex());
 
-        if (isNull)
-          row.setLongDoubleField(LONGDOUBLENULL, expression[i]->outputIndex());
-        else
-          row.setLongDoubleField(val, expression[i]->outputIndex());
+      break;
+    }
 
-        break;
-      }
+    case CalpontSystemCatalog::DECIMAL:
+    case CalpontSystemCatalog::UDECIMAL:
+    {
+      IDB_Decimal val = expression.getDecimalVal(row, isNull);
 
-      case CalpontSystemCatalog::DECIMAL:
-      case CalpontSystemCatalog::UDECIMAL:
+      if (expression.resultType().colWidth == datatypes::MAXDECIMALWIDTH)
       {
-        IDB_Decimal val = expression[i]->getDecimalVal(row, isNull);
-
-        if (expression[i]->resultType().colWidth == datatypes::MAXDECIMALWIDTH)
+        if (isNull)
         {
-          if (isNull)
-          {
-            row.setBinaryField_offset(const_cast<int128_t*>(&datatypes::Decimal128Null),
-                                      expression[i]->resultType().colWidth,
-                                      row.getOffset(expression[i]->outputIndex()));
-          }
-          else
-          {
-            row.setBinaryField_offset(&val.s128Value, expression[i]->resultType().colWidth,
-                                      row.getOffset(expression[i]->outputIndex()));
-          }
+          row.setBinaryField_offset(const_cast<int128_t*>(&datatypes::Decimal128Null),
+                                    expression.resultType().colWidth,
+                                    row.getOffset(expression.outputIndex()));
         }
         else
         {
-          if (isNull)
-            row.setIntField<8>(BIGINTNULL, expression[i]->outputIndex());
-          else
-            row.setIntField<8>(val.value, expression[i]->outputIndex());
+          row.setBinaryField_offset(&val.s128Value, expression.resultType().colWidth,
+                                    row.getOffset(expression.outputIndex()));
         }
-
-        break;
       }
-
-      default:  // treat as int64
+      else
       {
-        throw std::runtime_error("funcexp::evaluate(): non support datatype to set field.");
+        if (isNull)
+          row.setIntField<8>(BIGINTNULL, expression.outputIndex());
+        else
+          row.setIntField<8>(val.value, expression.outputIndex());
       }
+
+      break;
+    }
+
+    default:  // treat as int64
+    {
+      throw std::runtime_error("funcexp::evaluate(): non support datatype to set field.");
     }
   }
 }
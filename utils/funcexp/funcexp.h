@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <tr1/unordered_map>
@@ -42,6 +43,7 @@ class ArithmeticColumn;
 namespace funcexp
 {
 class Func;
+class BatchEvaluator;
 
 typedef std::tr1::unordered_map<std::string, Func*> FuncMap;
 
@@ -67,10 +69,12 @@ class FuncExp
 
   /** @brief evaluate a filter stack on rowgroup
    *
+   * The filter is evaluated column-at-a-time.  The BatchEvaluator is built once by the caller
+   * and reused for every rowgroup.
    * @param row input rowgroup that contains all the columns in the filter stack
-   * @param filters parse tree of filters to evaluate. The failed rows are removed from the rowgroup
+   * @param filter the compiled filter to evaluate. The failed rows are removed from the rowgroup
    */
-  inline void evaluate(rowgroup::RowGroup& rowgroup, execplan::ParseTree* filters);
+  void evaluate(rowgroup::RowGroup& rowgroup, BatchEvaluator& filter);
 
   /** @brief evaluate a F&E column on row. used for F&E on the select and group by clause
    *
@@ -79,12 +83,21 @@ class FuncExp
    */
   void evaluate(rowgroup::Row& row, std::vector<execplan::SRCP>& expressions);
 
+  /** @brief evaluate one F&E column on row
+   *
+   * @param row input row that contains all the columns in the expression
+   * @param expression the F&E that needs evaluation. The result is filled on the row.
+   */
+  void evaluate(rowgroup::Row& row, execplan::ReturnedColumn& expression);
+
   /** @brief evaluate a F&E column on rowgroup. used for F&E on the select and group by clause
    *
+   * The expressions are evaluated column-at-a-time.  The BatchEvaluators are built once by the
+   * caller and reused for every rowgroup.
    * @param row input rowgroup that contains all the columns in all the expressions
-   * @param expressions vector of F&Es that needs evaluation. The results are filled on each row.
+   * @param expressions the compiled F&Es that need evaluation. The results are filled on each row.
    */
-  inline void evaluate(rowgroup::RowGroup& rowgroup, std::vector<execplan::SRCP>& expressions);
+  void evaluate(rowgroup::RowGroup& rowgroup, std::vector<std::unique_ptr<BatchEvaluator> >& expressions);
 
   /** @brief get functor from functor map
    *
@@ -106,8 +119,4 @@ inline bool FuncExp::evaluate(rowgroup::Row& row, execplan::ParseTree* filters)
   return (filters->getBoolVal(row, isNull));
 }
 
-inline void FuncExp::evaluate(rowgroup::RowGroup& rowgroup, execplan::ParseTree* filters)
-{
-}
-
 }  // namespace funcexp
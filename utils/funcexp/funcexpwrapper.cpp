@@ -68,6 +68,9 @@ void FuncExpWrapper::operator=(const FuncExpWrapper& f)
 {
   uint32_t i;
 
+  batchFilters.clear();
+  batchRcs.clear();
+
   filters.resize(f.filters.size());
 
   for (i = 0; i < f.filters.size(); i++)
@@ -100,6 +103,9 @@ void FuncExpWrapper::deserialize(ByteStream& bs)
   bs >> fCount;
   bs >> rcsCount;
 
+  batchFilters.clear();
+  batchRcs.clear();
+
   for (i = 0; i < fCount; i++)
     filters.push_back(boost::shared_ptr<ParseTree>(ObjectReader::createParseTree(bs)));
 
@@ -123,14 +129,44 @@ bool FuncExpWrapper::evaluate(Row* r)
   return true;
 }
 
+void FuncExpWrapper::evaluate(RowGroup& rg, std::vector<uint32_t>& passed)
+{
+  uint32_t i;
+
+  if (batchFilters.size() != filters.size() || batchRcs.size() != rcs.size())
+  {
+    batchFilters.clear();
+    batchRcs.clear();
+
+    for (i = 0; i < filters.size(); i++)
+      batchFilters.emplace_back(new BatchEvaluator(filters[i].get()));
+
+    for (i = 0; i < rcs.size(); i++)
+      batchRcs.emplace_back(new BatchEvaluator(rcs[i].get()));
+  }
+
+  passed.resize(rg.getRowCount());
+
+  for (i = 0; i < passed.size(); i++)
+    passed[i] = i;
+
+  for (i = 0; i < batchFilters.size() && !passed.empty(); i++)
+    batchFilters[i]->filter(rg, passed);
+
+  for (i = 0; i < batchRcs.size(); i++)
+    batchRcs[i]->project(rg, passed);
+}
+
 void FuncExpWrapper::addFilter(const boost::shared_ptr<ParseTree>& f)
 {
   filters.push_back(f);
+  batchFilters.clear();
 }
 
 void FuncExpWrapper::addReturnedColumn(const boost::shared_ptr<ReturnedColumn>& rc)
 {
   rcs.push_back(rc);
+  batchRcs.clear();
 }
 
 };  // namespace funcexp
@@ -34,9 +34,11 @@
 
 #pragma once
 
+#include <memory>
 #include <parsetree.h>
 #include <returnedcolumn.h>
 #include "funcexp.h"
+#include "batchevaluator.h"
 
 namespace funcexp
 {
@@ -55,6 +57,14 @@ class FuncExpWrapper : public messageqcpp::Serializeable
   void deserialize(messageqcpp::ByteStream&);
 
   bool evaluate(rowgroup::Row*);
+
+  /** @brief evaluate the filters and the returned columns on every row of rg column-at-a-time
+   *
+   * @param rg the rowgroup to evaluate
+   * @param passed set to the indexes of the rows that pass all the filters. The returned
+   *   columns are only evaluated on those.
+   */
+  void evaluate(rowgroup::RowGroup& rg, std::vector<uint32_t>& passed);
   inline bool evaluateFilter(uint32_t num, rowgroup::Row* r);
   inline uint32_t getFilterCount() const;
 
@@ -65,6 +75,10 @@ class FuncExpWrapper : public messageqcpp::Serializeable
   std::vector<boost::shared_ptr<execplan::ParseTree> > filters;
   std::vector<boost::shared_ptr<execplan::ReturnedColumn> > rcs;
   FuncExp* fe;
+
+  // built on first use from filters and rcs, and reset whenever those change
+  std::vector<std::unique_ptr<BatchEvaluator> > batchFilters;
+  std::vector<std::unique_ptr<BatchEvaluator> > batchRcs;
 };
 
 inline bool FuncExpWrapper::evaluateFilter(uint32_t num, rowgroup::Row* r)
@@ -0,0 +1,119 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <string>
+
+#include "utils/pcre2/jpcre2.hpp"
+
+namespace funcexp
+{
+/** @brief A small LRU of compiled PCRE2 patterns.
+ *
+ *  REGEXP functions get the pattern as a row value, so without a cache every row pays for a
+ *  pattern compilation. A constant pattern always hits the most recently used entry, other
+ *  patterns are kept up to fCapacity entries. A pattern is JIT compiled once it was reused
+ *  JitThreshold times: JIT compilation costs several plain compilations, which doesn't pay off
+ *  when the pattern column has more distinct values than the cache holds. Without JIT support
+ *  in PCRE2 the interpreter keeps running the same compiled code.
+ *
+ *  The cache is not thread safe: function objects are shared between all threads that evaluate
+ *  an expression, so use threadRegexCache() to get the instance of the calling thread.
+ */
+class RegexCache
+{
+ public:
+  using Regex = jpcre2::select<char>::Regex;
+
+  static constexpr size_t DefaultCapacity = 16;
+  static constexpr size_t JitThreshold = 2;
+
+  explicit RegexCache(size_t capacity = DefaultCapacity) : fCapacity(capacity > 0 ? capacity : 1)
+  {
+  }
+
+  /** @brief Returns the compiled pattern, compiling it on a miss.
+   *
+   *  The reference stays valid until fCapacity other patterns were requested.
+   */
+  Regex& get(const std::string& pattern, jpcre2::Uint flags)
+  {
+    for (auto it = fEntries.begin(); it != fEntries.end(); ++it)
+    {
+      if (it->flags == flags && it->pattern == pattern)
+      {
+        if (++it->hits == JitThreshold)
+          it->regex.addJpcre2Option(jpcre2::JIT_COMPILE).compile();
+
+        if (it != fEntries.begin())
+          fEntries.splice(fEntries.begin(), fEntries, it);
+
+        return fEntries.front().regex;
+      }
+    }
+
+    if (fEntries.size() >= fCapacity)
+      fEntries.pop_back();
+
+    fEntries.emplace_front(pattern, flags);
+    return fEntries.front().regex;
+  }
+
+  size_t size() const
+  {
+    return fEntries.size();
+  }
+
+  size_t capacity() const
+  {
+    return fCapacity;
+  }
+
+  void clear()
+  {
+    fEntries.clear();
+  }
+
+ private:
+  struct Entry
+  {
+    Entry(const std::string& p, jpcre2::Uint f) : pattern(p), flags(f), regex(p, f)
+    {
+    }
+
+    std::string pattern;
+    jpcre2::Uint flags;
+    Regex regex;
+    size_t hits = 0;
+  };
+
+  size_t fCapacity;
+  std::list<Entry> fEntries;  // most recently used first
+};
+
+inline RegexCache& threadRegexCache()
+{
+  static thread_local RegexCache cache;
+  return cache;
+}
+
+}  // namespace funcexp
@@ -191,6 +191,16 @@ class IDBDataFile
    */
   virtual int fallocate(int mode, off64_t offset, off64_t length) = 0;
 
+  /**
+   * The handle() method returns the kernel file descriptor behind the
+   * file, or -1 if the file isn't backed by one.  PrimProc uses it to
+   * submit reads to io_uring.  Only UnbufferedFile has one.
+   */
+  virtual int handle()
+  {
+    return -1;
+  }
+
   int colWidth()
   {
     return m_fColWidth;
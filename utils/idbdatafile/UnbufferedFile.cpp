@@ -235,4 +235,9 @@ int UnbufferedFile::fallocate(int mode, off64_t offset, off64_t length)
   return ret;
 }
 
+int UnbufferedFile::handle()
+{
+  return (m_fd == INVALID_HANDLE_VALUE ? -1 : m_fd);
+}
+
 }  // namespace idbdatafile
@@ -46,6 +46,7 @@ class UnbufferedFile : public IDBDataFile, boost::noncopyable
   /* virtual */ int flush();
   /* virtual */ time_t mtime();
   /* virtual */ int fallocate(int mode, off64_t offset, off64_t length);
+  /* virtual */ int handle();
 
  protected:
   /* virtual */
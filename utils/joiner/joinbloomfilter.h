@@ -0,0 +1,185 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "bytestream.h"
+
+namespace joiner
+{
+/** @brief Runtime join filter built from the small side keys of a hash join.
+ *
+ *  A min/max range plus a register-blocked bloom filter over 64-bit integer keys. Every key
+ *  sets 4 bits in a single 64-bit word, so a probe is one memory access. The filter is
+ *  sized for about 16 bits per key, which gives a false positive rate well under 1%.
+ *
+ *  Keys are normalized the same way the typed join keys are: signed columns as int64_t,
+ *  unsigned columns as uint64_t. The range check follows the signedness given at construction.
+ *
+ *  The UM builds it in TupleJoiner::doneInserting(), PrimProc receives it with the BPP and
+ *  drops the large side rows that can not match before the rest of the columns are projected.
+ */
+class JoinBloomFilter
+{
+ public:
+  /* Larger small sides aren't worth the bytes shipped to every PM with each BPP. */
+  static constexpr uint64_t MaxKeys = 4 * 1024 * 1024;
+
+  JoinBloomFilter() : fUnsigned(false), fShift(64), fMin(0), fMax(0), fEmpty(true)
+  {
+  }
+
+  JoinBloomFilter(uint64_t keyCount, bool isUnsigned) : fUnsigned(isUnsigned), fEmpty(true)
+  {
+    // 16 bits per key, at least one word
+    uint64_t words = 1;
+    uint32_t log2Words = 0;
+
+    while (words * 4 < keyCount)
+    {
+      words <<= 1;
+      log2Words++;
+    }
+
+    fShift = 64 - log2Words;
+    fBits.assign(words, 0);
+    fMin = (fUnsigned ? (int64_t)std::numeric_limits<uint64_t>::max() : std::numeric_limits<int64_t>::max());
+    fMax = (fUnsigned ? 0 : std::numeric_limits<int64_t>::min());
+  }
+
+  void insert(int64_t key)
+  {
+    uint64_t h = hash(key);
+    fBits[wordIndex(h)] |= wordMask(h);
+
+    if (lessThan(key, fMin))
+      fMin = key;
+
+    if (lessThan(fMax, key))
+      fMax = key;
+
+    fEmpty = false;
+  }
+
+  inline bool mayContain(int64_t key) const
+  {
+    if (fEmpty || lessThan(key, fMin) || lessThan(fMax, key))
+      return false;
+
+    uint64_t h = hash(key);
+    uint64_t mask = wordMask(h);
+    return (fBits[wordIndex(h)] & mask) == mask;
+  }
+
+  bool isUnsigned() const
+  {
+    return fUnsigned;
+  }
+  bool empty() const
+  {
+    return fEmpty;
+  }
+  int64_t getMin() const
+  {
+    return fMin;
+  }
+  int64_t getMax() const
+  {
+    return fMax;
+  }
+  uint64_t sizeInBytes() const
+  {
+    return fBits.size() * sizeof(uint64_t);
+  }
+
+  void serialize(messageqcpp::ByteStream& bs) const
+  {
+    bs << (uint8_t)fUnsigned;
+    bs << (uint8_t)fEmpty;
+    bs << (uint32_t)fShift;
+    bs << (uint64_t)fMin;
+    bs << (uint64_t)fMax;
+    bs << (uint64_t)fBits.size();
+    bs.append(reinterpret_cast<const uint8_t*>(fBits.data()), sizeInBytes());
+  }
+
+  void deserialize(messageqcpp::ByteStream& bs)
+  {
+    uint8_t tmp8;
+    uint32_t tmp32;
+    uint64_t tmp64, words;
+
+    bs >> tmp8;
+    fUnsigned = tmp8;
+    bs >> tmp8;
+    fEmpty = tmp8;
+    bs >> tmp32;
+    fShift = tmp32;
+    bs >> tmp64;
+    fMin = (int64_t)tmp64;
+    bs >> tmp64;
+    fMax = (int64_t)tmp64;
+    bs >> words;
+    fBits.resize(words);
+    memcpy(fBits.data(), bs.buf(), words * sizeof(uint64_t));
+    bs.advance(words * sizeof(uint64_t));
+  }
+
+ private:
+  static inline uint64_t hash(int64_t key)
+  {
+    // the murmur3 finalizer
+    uint64_t h = (uint64_t)key;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  // the top bits pick the word, the low 24 bits pick 4 bits in it
+  inline uint64_t wordIndex(uint64_t h) const
+  {
+    return (fShift == 64 ? 0 : h >> fShift);
+  }
+  static inline uint64_t wordMask(uint64_t h)
+  {
+    return (1ULL << (h & 63)) | (1ULL << ((h >> 6) & 63)) | (1ULL << ((h >> 12) & 63)) |
+           (1ULL << ((h >> 18) & 63));
+  }
+
+  inline bool lessThan(int64_t a, int64_t b) const
+  {
+    return (fUnsigned ? (uint64_t)a < (uint64_t)b : a < b);
+  }
+
+  bool fUnsigned;
+  uint32_t fShift;
+  int64_t fMin, fMax;
+  bool fEmpty;
+  std::vector<uint64_t> fBits;
+};
+
+}  // namespace joiner
@@ -0,0 +1,264 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace joiner
+{
+/** @brief Flat multimap for the UM hash join.
+ *
+ *  Open addressing with linear probing over an array of slots, one slot per distinct key.
+ *  A key with a single value keeps it in the slot, which is the common case for joins on a
+ *  primary key. Duplicates of a key are stored contiguously in fDups: the run of a key has a
+ *  power of 2 capacity and is moved to the end of fDups with twice the capacity when it fills
+ *  up, so equal_range() returns a plain array of values.
+ *
+ *  There is no erase, the joiner drops the whole table instead. Lookups on a table that is not
+ *  being modified are thread safe.
+ */
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+class JoinHashTable
+{
+  struct Slot
+  {
+    Key key;
+    Value value;      // the value if count == 1
+    uint32_t count;   // 0 marks an empty slot
+    uint32_t offset;  // start of the run in fDups if count > 1
+  };
+
+ public:
+  typedef std::pair<const Value*, const Value*> Range;
+
+  static constexpr size_t InitialCapacity = 16;
+
+  /** @brief Iterates all values of the table. */
+  class const_iterator
+  {
+   public:
+    const_iterator() : fTable(nullptr), fSlot(0), fPos(0)
+    {
+    }
+    const_iterator(const JoinHashTable* t, size_t slot) : fTable(t), fSlot(slot), fPos(0)
+    {
+      skipEmpty();
+    }
+    const Value& operator*() const
+    {
+      const Slot& s = fTable->fSlots[fSlot];
+      return (s.count == 1 ? s.value : fTable->fDups[s.offset + fPos]);
+    }
+    const Value* operator->() const
+    {
+      return &operator*();
+    }
+    const_iterator& operator++()
+    {
+      if (++fPos >= fTable->fSlots[fSlot].count)
+      {
+        fPos = 0;
+        ++fSlot;
+        skipEmpty();
+      }
+      return *this;
+    }
+    bool operator==(const const_iterator& it) const
+    {
+      return fSlot == it.fSlot && fPos == it.fPos;
+    }
+    bool operator!=(const const_iterator& it) const
+    {
+      return !operator==(it);
+    }
+
+   private:
+    void skipEmpty()
+    {
+      while (fSlot < fTable->fSlots.size() && fTable->fSlots[fSlot].count == 0)
+        ++fSlot;
+    }
+
+    const JoinHashTable* fTable;
+    size_t fSlot;
+    uint32_t fPos;
+  };
+
+  explicit JoinHashTable(const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual())
+   : fHash(hash), fEqual(eq), fSize(0), fKeys(0), fMask(0)
+  {
+  }
+
+  inline size_t hash(const Key& key) const
+  {
+    return fHash(key);
+  }
+
+  void insert(const Key& key, const Value& value)
+  {
+    insert(key, value, fHash(key));
+  }
+
+  void insert(const std::pair<Key, Value>& element)
+  {
+    insert(element.first, element.second, fHash(element.first));
+  }
+
+  void insert(const Key& key, const Value& value, size_t hashValue)
+  {
+    if ((fKeys + 1) * 4 > fSlots.size() * 3)
+      grow();
+
+    Slot& s = fSlots[findSlot(key, hashValue)];
+    if (s.count == 0)
+    {
+      s.key = key;
+      s.value = value;
+      s.count = 1;
+      ++fKeys;
+    }
+    else
+      appendDuplicate(s, value);
+
+    ++fSize;
+  }
+
+  /** @brief Returns the values of key as [first, second). */
+  inline Range equal_range(const Key& key) const
+  {
+    return equal_range(key, fHash(key));
+  }
+
+  Range equal_range(const Key& key, size_t hashValue) const
+  {
+    if (fKeys == 0)
+      return Range(nullptr, nullptr);
+
+    for (size_t i = hashValue & fMask;; i = (i + 1) & fMask)
+    {
+      const Slot& s = fSlots[i];
+      if (s.count == 0)
+        return Range(nullptr, nullptr);
+      if (fEqual(s.key, key))
+      {
+        const Value* first = (s.count == 1 ? &s.value : &fDups[s.offset]);
+        return Range(first, first + s.count);
+      }
+    }
+  }
+
+  /** @brief Hints the CPU to load the slot a lookup of hashValue starts from.
+   *
+   *  Issuing this for a batch of keys before probing them overlaps the cache misses.
+   */
+  inline void prefetch(size_t hashValue) const
+  {
+    if (fKeys != 0)
+      __builtin_prefetch(&fSlots[hashValue & fMask]);
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(this, 0);
+  }
+  const_iterator end() const
+  {
+    return const_iterator(this, fSlots.size());
+  }
+
+  /** @brief The number of values. */
+  size_t size() const
+  {
+    return fSize;
+  }
+  bool empty() const
+  {
+    return fSize == 0;
+  }
+  /** @brief The number of distinct keys. */
+  size_t keyCount() const
+  {
+    return fKeys;
+  }
+
+  uint64_t getMemUsage() const
+  {
+    return fSlots.capacity() * sizeof(Slot) + fDups.capacity() * sizeof(Value);
+  }
+
+ private:
+  inline size_t findSlot(const Key& key, size_t hashValue) const
+  {
+    size_t i = hashValue & fMask;
+    while (fSlots[i].count != 0 && !fEqual(fSlots[i].key, key))
+      i = (i + 1) & fMask;
+    return i;
+  }
+
+  void appendDuplicate(Slot& s, const Value& value)
+  {
+    if (s.count == 1)
+    {
+      s.offset = fDups.size();
+      fDups.push_back(s.value);
+      fDups.push_back(value);
+      s.count = 2;
+      return;
+    }
+
+    // A run is full when its length reaches a power of 2, move it to a run twice that long.
+    if ((s.count & (s.count - 1)) == 0)
+    {
+      size_t newOffset = fDups.size();
+      fDups.resize(newOffset + 2 * s.count);
+      std::copy(fDups.begin() + s.offset, fDups.begin() + s.offset + s.count, fDups.begin() + newOffset);
+      s.offset = newOffset;
+    }
+
+    fDups[s.offset + s.count++] = value;
+  }
+
+  void grow()
+  {
+    std::vector<Slot> old;
+    old.swap(fSlots);
+    size_t capacity = (old.empty() ? InitialCapacity : old.size() * 2);
+    fSlots.resize(capacity);  // value initialized, so every count is 0
+    fMask = capacity - 1;
+
+    for (const auto& s : old)
+      if (s.count != 0)
+        fSlots[findSlot(s.key, fHash(s.key))] = s;
+  }
+
+  Hash fHash;
+  KeyEqual fEqual;
+  std::vector<Slot> fSlots;
+  std::vector<Value> fDups;
+  size_t fSize;  // values
+  size_t fKeys;  // occupied slots
+  size_t fMask;
+};
+
+}  // namespace joiner
@@ -59,35 +59,20 @@ TupleJoiner::TupleJoiner(const rowgroup::RowGroup& smallInput, const rowgroup::R
   if (smallRG.getColTypes()[smallJoinColumn] == CalpontSystemCatalog::LONGDOUBLE)
   {
     ld.reset(new boost::scoped_ptr<ldhash_t>[bucketCount]);
-    _pool.reset(new boost::shared_ptr<PoolAllocator>[bucketCount]);
     for (i = 0; i < bucketCount; i++)
-    {
-      STLPoolAllocator<pair<const long double, Row::Pointer>> alloc;
-      _pool[i] = alloc.getPoolAllocator();
-      ld[i].reset(new ldhash_t(10, hasher(), ldhash_t::key_equal(), alloc));
-    }
+      ld[i].reset(new ldhash_t());
   }
   else if (smallRG.usesStringTable())
   {
     sth.reset(new boost::scoped_ptr<sthash_t>[bucketCount]);
-    _pool.reset(new boost::shared_ptr<PoolAllocator>[bucketCount]);
     for (i = 0; i < bucketCount; i++)
-    {
-      STLPoolAllocator<pair<const int64_t, Row::Pointer>> alloc;
-      _pool[i] = alloc.getPoolAllocator();
-      sth[i].reset(new sthash_t(10, hasher(), sthash_t::key_equal(), alloc));
-    }
+      sth[i].reset(new sthash_t());
   }
   else
   {
     h.reset(new boost::scoped_ptr<hash_t>[bucketCount]);
-    _pool.reset(new boost::shared_ptr<PoolAllocator>[bucketCount]);
     for (i = 0; i < bucketCount; i++)
-    {
-      STLPoolAllocator<pair<const int64_t, uint8_t*>> alloc;
-      _pool[i] = alloc.getPoolAllocator();
-      h[i].reset(new hash_t(10, hasher(), hash_t::key_equal(), alloc));
-    }
+      h[i].reset(new hash_t());
   }
 
   smallRG.initRow(&smallNullRow);
@@ -163,14 +148,9 @@ TupleJoiner::TupleJoiner(const rowgroup::RowGroup& smallInput, const rowgroup::R
 
   getBucketCount();
 
-  _pool.reset(new boost::shared_ptr<PoolAllocator>[bucketCount]);
   ht.reset(new boost::scoped_ptr<typelesshash_t>[bucketCount]);
   for (i = 0; i < bucketCount; i++)
-  {
-    STLPoolAllocator<pair<const TypelessData, Row::Pointer>> alloc;
-    _pool[i] = alloc.getPoolAllocator();
-    ht[i].reset(new typelesshash_t(10, hasher(), typelesshash_t::key_equal(), alloc));
-  }
+    ht[i].reset(new typelesshash_t());
   m_bucketLocks.reset(new boost::mutex[bucketCount]);
 
   smallRG.initRow(&smallNullRow);
@@ -499,8 +479,7 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
     if (UNLIKELY(typelessJoin))
     {
       TypelessData largeKey;
-      thIterator it;
-      pair<thIterator, thIterator> range;
+      typelesshash_t::Range range;
 
       largeKey = makeTypelessKey(largeSideRow, largeKeyColumns, keyLength, &tmpKeyAlloc[threadID], smallRG,
                                  smallKeyColumns);
@@ -514,15 +493,13 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
         return;
 
       for (; range.first != range.second; ++range.first)
-        matches->push_back(range.first->second);
+        matches->push_back(*range.first);
     }
     else if (largeSideRow.getColType(largeKeyColumns[0]) == CalpontSystemCatalog::LONGDOUBLE && ld)
     {
       // This is a compare of two long double
       long double largeKey;
-      ldIterator it;
-      pair<ldIterator, ldIterator> range;
-      Row r;
+      ldhash_t::Range range;
 
       largeKey = largeSideRow.getLongDoubleField(largeKeyColumns[0]);
       uint bucket = bucketPicker((char*)&largeKey, 10, bpSeed) & bucketMask;
@@ -532,7 +509,7 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
         return;
       for (; range.first != range.second; ++range.first)
       {
-        matches->push_back(range.first->second);
+        matches->push_back(*range.first);
       }
     }
     else if (!smallRG.usesStringTable())
@@ -563,7 +540,7 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
           return;
 
         for (; range.first != range.second; ++range.first)
-          matches->push_back(range.first->second);
+          matches->push_back(*range.first);
       }
       else
       {
@@ -574,7 +551,7 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
           return;
 
         for (; range.first != range.second; ++range.first)
-          matches->emplace_back(rowgroup::Row::Pointer(range.first->second));
+          matches->emplace_back(rowgroup::Row::Pointer(*range.first));
       }
     }
     else
@@ -587,7 +564,7 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
         return;
 
       for (; range.first != range.second; ++range.first)
-        matches->push_back(range.first->second);
+        matches->push_back(*range.first);
     }
   }
 
@@ -603,28 +580,28 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
     {
       uint bucket = bucketPicker((char*)&(joblist::LONGDOUBLENULL), sizeof(joblist::LONGDOUBLENULL), bpSeed) &
                     bucketMask;
-      pair<ldIterator, ldIterator> range = ld[bucket]->equal_range(joblist::LONGDOUBLENULL);
+      ldhash_t::Range range = ld[bucket]->equal_range(joblist::LONGDOUBLENULL);
 
       for (; range.first != range.second; ++range.first)
-        matches->push_back(range.first->second);
+        matches->push_back(*range.first);
     }
     else if (!largeRG.usesStringTable())
     {
       auto nullVal = getJoinNullValue();
       uint bucket = bucketPicker((char*)&nullVal, sizeof(nullVal), bpSeed) & bucketMask;
-      pair<iterator, iterator> range = h[bucket]->equal_range(nullVal);
+      hash_t::Range range = h[bucket]->equal_range(nullVal);
 
       for (; range.first != range.second; ++range.first)
-        matches->emplace_back(rowgroup::Row::Pointer(range.first->second));
+        matches->emplace_back(rowgroup::Row::Pointer(*range.first));
     }
     else
     {
       auto nullVal = getJoinNullValue();
       uint bucket = bucketPicker((char*)&nullVal, sizeof(nullVal), bpSeed) & bucketMask;
-      pair<sthash_t::iterator, sthash_t::iterator> range = sth[bucket]->equal_range(nullVal);
+      sthash_t::Range range = sth[bucket]->equal_range(nullVal);
 
       for (; range.first != range.second; ++range.first)
-        matches->push_back(range.first->second);
+        matches->push_back(*range.first);
     }
   }
 
@@ -636,76 +613,96 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
     {
       if (smallRG.getColType(smallKeyColumns[0]) == CalpontSystemCatalog::LONGDOUBLE)
       {
-        ldIterator it;
-
         for (uint i = 0; i < bucketCount; i++)
-          for (it = ld[i]->begin(); it != ld[i]->end(); ++it)
-            matches->push_back(it->second);
+          for (ldIterator it = ld[i]->begin(); it != ld[i]->end(); ++it)
+            matches->push_back(*it);
       }
       else if (!smallRG.usesStringTable())
       {
-        iterator it;
-
         for (uint i = 0; i < bucketCount; i++)
-          for (it = h[i]->begin(); it != h[i]->end(); ++it)
-            matches->emplace_back(rowgroup::Row::Pointer(it->second));
+          for (iterator it = h[i]->begin(); it != h[i]->end(); ++it)
+            matches->emplace_back(rowgroup::Row::Pointer(*it));
       }
       else
       {
-        sthash_t::iterator it;
-
         for (uint i = 0; i < bucketCount; i++)
-          for (it = sth[i]->begin(); it != sth[i]->end(); ++it)
-            matches->push_back(it->second);
+          for (sthash_t::const_iterator it = sth[i]->begin(); it != sth[i]->end(); ++it)
+            matches->push_back(*it);
       }
     }
     else
     {
-      thIterator it;
-
       for (uint i = 0; i < bucketCount; i++)
-        for (it = ht[i]->begin(); it != ht[i]->end(); ++it)
-          matches->push_back(it->second);
+        for (thIterator it = ht[i]->begin(); it != ht[i]->end(); ++it)
+          matches->push_back(*it);
     }
   }
 }
 
-void TupleJoiner::doneInserting()
+void TupleJoiner::prefetchMatches(const Row& largeSideRow, uint32_t count) const
 {
-  // a minor textual cleanup
-#ifdef TJ_DEBUG
-#define CHECKSIZE                         \
-  if (uniquer.size() > uniqueLimit)       \
-  {                                       \
-    cout << "too many discrete values\n"; \
-    return;                               \
-  }
-#else
-#define CHECKSIZE                   \
-  if (uniquer.size() > uniqueLimit) \
+  if (joinAlg != UM || typelessJoin || ld)
     return;
-#endif
 
+  // Derive the keys the same way match() does for the h and sth tables.
+  uint32_t largeKeyColumn = largeKeyColumns[0];
+  bool isLongDoubleKey = (largeSideRow.getColType(largeKeyColumn) == CalpontSystemCatalog::LONGDOUBLE);
+  bool isUnsignedKey = largeSideRow.isUnsigned(largeKeyColumn);
+  Row r(largeSideRow);
+
+  for (uint32_t i = 0; i < count; i++, r.nextRow())
+  {
+    int64_t largeKey;
+
+    if (!h)
+      largeKey = r.getIntField(largeKeyColumn);
+    else if (isLongDoubleKey)
+      largeKey = (int64_t)r.getLongDoubleField(largeKeyColumn);
+    else if (isUnsignedKey)
+      largeKey = (int64_t)r.getUintField(largeKeyColumn);
+    else
+      largeKey = r.getIntField(largeKeyColumn);
+
+    uint bucket = bucketPicker((char*)&largeKey, sizeof(largeKey), bpSeed) & bucketMask;
+    if (h)
+      h[bucket]->prefetch(h[bucket]->hash(largeKey));
+    else
+      sth[bucket]->prefetch(sth[bucket]->hash(largeKey));
+  }
+}
+
+void TupleJoiner::doneInserting()
+{
   uint32_t col;
 
   /* Put together the discrete values for the runtime casual partitioning restriction */
 
   finished = true;
 
+  /* The runtime join filter covers single integer key joins that drop the large side rows
+     without a match.  The large side key has to share the signedness so the values compare
+     the same way on the PM. */
+  bool buildBloomFilter = !typelessJoin && smallKeyColumns.size() == 1 && !antiJoin() &&
+                          !largeOuterJoin() && !scalar() && size() <= JoinBloomFilter::MaxKeys &&
+                          datatypes::sameSignednessInteger(smallRG.getColType(smallKeyColumns[0]),
+                                                           largeRG.getColType(largeKeyColumns[0]));
+
   for (col = 0; col < smallKeyColumns.size(); col++)
   {
     typedef std::tr1::unordered_set<int128_t, utils::Hash128, utils::Equal128> unordered_set_int128;
     unordered_set_int128 uniquer;
     unordered_set_int128::iterator uit;
-    sthash_t::iterator sthit;
-    hash_t::iterator hit;
-    ldhash_t::iterator ldit;
-    typelesshash_t::iterator thit;
+    sthash_t::const_iterator sthit;
+    iterator hit;
+    ldIterator ldit;
+    thIterator thit;
     uint32_t i, pmpos = 0, rowCount;
     Row smallRow;
     auto smallSideColIdx = smallKeyColumns[col];
     auto smallSideColType = smallRG.getColType(smallSideColIdx);
 
+    bool tooManyValues = false;
+
     smallRG.initRow(&smallRow);
 
     if (smallRow.isCharType(smallSideColIdx))
@@ -713,6 +710,9 @@ void TupleJoiner::doneInserting()
 
     rowCount = size();
 
+    if (col == 0 && buildBloomFilter)
+      bloomFilter.reset(new JoinBloomFilter(rowCount, smallRow.isUnsigned(smallSideColIdx)));
+
     uint bucket = 0;
     if (joinAlg == PM)
       pmpos = 0;
@@ -733,31 +733,42 @@ void TupleJoiner::doneInserting()
       {
         while (thit == ht[bucket]->end())
           thit = ht[++bucket]->begin();
-        smallRow.setPointer(thit->second);
+        smallRow.setPointer(*thit);
         ++thit;
       }
       else if (isLongDouble(smallSideColType))
       {
         while (ldit == ld[bucket]->end())
           ldit = ld[++bucket]->begin();
-        smallRow.setPointer(ldit->second);
+        smallRow.setPointer(*ldit);
         ++ldit;
       }
       else if (!smallRG.usesStringTable())
       {
         while (hit == h[bucket]->end())
           hit = h[++bucket]->begin();
-        smallRow.setPointer(rowgroup::Row::Pointer(hit->second));
+        smallRow.setPointer(rowgroup::Row::Pointer(*hit));
         ++hit;
       }
       else
       {
         while (sthit == sth[bucket]->end())
           sthit = sth[++bucket]->begin();
-        smallRow.setPointer(sthit->second);
+        smallRow.setPointer(*sthit);
         ++sthit;
       }
 
+      if (bloomFilter && col == 0)
+      {
+        if (smallRow.isUnsigned(smallSideColIdx))
+          bloomFilter->insert((int64_t)smallRow.getUintField(smallSideColIdx));
+        else
+          bloomFilter->insert(smallRow.getIntField(smallSideColIdx));
+      }
+
+      if (tooManyValues)
+        continue;
+
       if (isLongDouble(smallSideColType))
       {
         double dval = (double)roundl(smallRow.getLongDoubleField(smallSideColIdx));
@@ -790,9 +801,23 @@ void TupleJoiner::doneInserting()
         uniquer.insert(smallRow.getIntField(smallSideColIdx));
       }
 
-      CHECKSIZE;
+      if (uniquer.size() > uniqueLimit)
+      {
+#ifdef TJ_DEBUG
+        cout << "too many discrete values\n";
+#endif
+        // keep going only to finish the bloom filter
+        if (!bloomFilter || col != 0)
+          return;
+
+        tooManyValues = true;
+        uniquer.clear();
+      }
     }
 
+    if (tooManyValues)
+      return;
+
     discreteValues[col] = true;
     cpValues[col].clear();
 #ifdef TJ_DEBUG
@@ -1002,15 +1027,15 @@ void TupleJoiner::getUnmarkedRows(vector<Row::Pointer>* out)
   {
     if (typelessJoin)
     {
-      typelesshash_t::iterator it;
+      thIterator it;
 
       for (uint i = 0; i < bucketCount; i++)
         for (it = ht[i]->begin(); it != ht[i]->end(); ++it)
         {
-          smallR.setPointer(it->second);
+          smallR.setPointer(*it);
 
           if (!smallR.isMarked())
-            out->push_back(it->second);
+            out->push_back(*it);
         }
     }
     else if (smallRG.getColType(smallKeyColumns[0]) == CalpontSystemCatalog::LONGDOUBLE)
@@ -1020,10 +1045,10 @@ void TupleJoiner::getUnmarkedRows(vector<Row::Pointer>* out)
       for (uint i = 0; i < bucketCount; i++)
         for (it = ld[i]->begin(); it != ld[i]->end(); ++it)
         {
-          smallR.setPointer(it->second);
+          smallR.setPointer(*it);
 
           if (!smallR.isMarked())
-            out->push_back(it->second);
+            out->push_back(*it);
         }
     }
     else if (!smallRG.usesStringTable())
@@ -1033,23 +1058,23 @@ void TupleJoiner::getUnmarkedRows(vector<Row::Pointer>* out)
       for (uint i = 0; i < bucketCount; i++)
         for (it = h[i]->begin(); it != h[i]->end(); ++it)
         {
-          smallR.setPointer(rowgroup::Row::Pointer(it->second));
+          smallR.setPointer(rowgroup::Row::Pointer(*it));
 
           if (!smallR.isMarked())
-            out->emplace_back(rowgroup::Row::Pointer(it->second));
+            out->emplace_back(rowgroup::Row::Pointer(*it));
         }
     }
     else
     {
-      sthash_t::iterator it;
+      sthash_t::const_iterator it;
 
       for (uint i = 0; i < bucketCount; i++)
         for (it = sth[i]->begin(); it != sth[i]->end(); ++it)
         {
-          smallR.setPointer(it->second);
+          smallR.setPointer(*it);
 
           if (!smallR.isMarked())
-            out->push_back(it->second);
+            out->push_back(*it);
         }
     }
   }
@@ -1061,7 +1086,7 @@ uint64_t TupleJoiner::getMemUsage() const
   {
     size_t ret = 0;
     for (uint i = 0; i < bucketCount; i++)
-      ret += _pool[i]->getMemUsage();
+      ret += ht[i]->getMemUsage();
     for (int i = 0; i < numCores; i++)
       ret += storedKeyAlloc[i].getMemUsage();
     return ret;
@@ -1070,7 +1095,12 @@ uint64_t TupleJoiner::getMemUsage() const
   {
     size_t ret = 0;
     for (uint i = 0; i < bucketCount; i++)
-      ret += _pool[i]->getMemUsage();
+      if (ld)
+        ret += ld[i]->getMemUsage();
+      else if (h)
+        ret += h[i]->getMemUsage();
+      else
+        ret += sth[i]->getMemUsage();
     return ret;
   }
   else
@@ -1786,7 +1816,6 @@ void TupleJoiner::setTableName(const string& tname)
 
 void TupleJoiner::clearData()
 {
-  _pool.reset(new boost::shared_ptr<utils::PoolAllocator>[bucketCount]);
   if (typelessJoin)
     ht.reset(new boost::scoped_ptr<typelesshash_t>[bucketCount]);
   else if (smallRG.getColTypes()[smallKeyColumns[0]] == CalpontSystemCatalog::LONGDOUBLE)
@@ -1798,20 +1827,19 @@ void TupleJoiner::clearData()
 
   for (uint i = 0; i < bucketCount; i++)
   {
-    STLPoolAllocator<pair<const TypelessData, Row::Pointer>> alloc;
-    _pool[i] = alloc.getPoolAllocator();
     if (typelessJoin)
-      ht[i].reset(new typelesshash_t(10, hasher(), typelesshash_t::key_equal(), alloc));
+      ht[i].reset(new typelesshash_t());
     else if (smallRG.getColTypes()[smallKeyColumns[0]] == CalpontSystemCatalog::LONGDOUBLE)
-      ld[i].reset(new ldhash_t(10, hasher(), ldhash_t::key_equal(), alloc));
+      ld[i].reset(new ldhash_t());
     else if (smallRG.usesStringTable())
-      sth[i].reset(new sthash_t(10, hasher(), sthash_t::key_equal(), alloc));
+      sth[i].reset(new sthash_t());
     else
-      h[i].reset(new hash_t(10, hasher(), hash_t::key_equal(), alloc));
+      h[i].reset(new hash_t());
   }
 
   std::vector<rowgroup::Row::Pointer> empty;
   rows.swap(empty);
+  bloomFilter.reset();
   finished = false;
 }
 
@@ -33,6 +33,8 @@
 #include "../funcexp/funcexpwrapper.h"
 #include "stlpoolallocator.h"
 #include "hasher.h"
+#include "joinhashtable.h"
+#include "joinbloomfilter.h"
 #include "threadpool.h"
 #include "columnwidth.h"
 #include "mcs_string.h"
@@ -289,6 +291,13 @@ class TupleJoiner
   void match(rowgroup::Row& largeSideRow, uint32_t index, uint32_t threadID,
              std::vector<rowgroup::Row::Pointer>* matches);
 
+  /* Batched probing for UM joins on integer keys.  Hashes the keys of the next 'count'
+      large-side rows and prefetches the hash table slots they map to, so the cache misses
+      of the following match() calls overlap.  It's a no-op for the other join types.
+  */
+  void prefetchMatches(const rowgroup::Row& largeSideRow, uint32_t count) const;
+  static constexpr uint32_t PrefetchBatchSize = 16;
+
   /* On a PM left outer join + aggregation, the result is already complete.
       No need to match, just mark.
   */
@@ -409,6 +418,12 @@ class TupleJoiner
     uniqueLimit = limit;
   }
 
+  /* Runtime join filter, null if the join doesn't qualify.  Valid after doneInserting(). */
+  inline const std::shared_ptr<JoinBloomFilter>& getBloomFilter() const
+  {
+    return bloomFilter;
+  }
+
   /* Semi-join interface */
   inline bool semiJoin()
   {
@@ -464,26 +479,16 @@ class TupleJoiner
   void setConvertToDiskJoin();
 
  private:
-  typedef std::tr1::unordered_multimap<int64_t, uint8_t*, hasher, std::equal_to<int64_t>,
-                                       utils::STLPoolAllocator<std::pair<const int64_t, uint8_t*> > >
-      hash_t;
-  typedef std::tr1::unordered_multimap<
-      int64_t, rowgroup::Row::Pointer, hasher, std::equal_to<int64_t>,
-      utils::STLPoolAllocator<std::pair<const int64_t, rowgroup::Row::Pointer> > >
-      sthash_t;
-  typedef std::tr1::unordered_multimap<
-      TypelessData, rowgroup::Row::Pointer, hasher, std::equal_to<TypelessData>,
-      utils::STLPoolAllocator<std::pair<const TypelessData, rowgroup::Row::Pointer> > >
+  typedef JoinHashTable<int64_t, uint8_t*, hasher, std::equal_to<int64_t> > hash_t;
+  typedef JoinHashTable<int64_t, rowgroup::Row::Pointer, hasher, std::equal_to<int64_t> > sthash_t;
+  typedef JoinHashTable<TypelessData, rowgroup::Row::Pointer, hasher, std::equal_to<TypelessData> >
       typelesshash_t;
   // MCOL-1822 Add support for Long Double AVG/SUM small side
-  typedef std::tr1::unordered_multimap<
-      long double, rowgroup::Row::Pointer, hasher, LongDoubleEq,
-      utils::STLPoolAllocator<std::pair<const long double, rowgroup::Row::Pointer> > >
-      ldhash_t;
+  typedef JoinHashTable<long double, rowgroup::Row::Pointer, hasher, LongDoubleEq> ldhash_t;
 
-  typedef hash_t::iterator iterator;
-  typedef typelesshash_t::iterator thIterator;
-  typedef ldhash_t::iterator ldIterator;
+  typedef hash_t::const_iterator iterator;
+  typedef typelesshash_t::const_iterator thIterator;
+  typedef ldhash_t::const_iterator ldIterator;
 
   TupleJoiner();
   TupleJoiner(const TupleJoiner&);
@@ -517,7 +522,6 @@ class TupleJoiner
   };
   JoinAlg joinAlg;
   joblist::JoinType joinType;
-  std::shared_ptr<boost::shared_ptr<utils::PoolAllocator>[]> _pool;  // pools for the table and nodes
   uint32_t threadCount;
   std::string tableName;
 
@@ -544,6 +548,7 @@ class TupleJoiner
   boost::scoped_array<std::vector<int128_t> > cpValues;  // if !discreteValues, [0] has min, [1] has max
   uint32_t uniqueLimit;
   bool finished;
+  std::shared_ptr<JoinBloomFilter> bloomFilter;
 
   // multithreaded UM hash table construction
   int numCores;
@@ -602,6 +602,76 @@ void RowAggregation::addRowGroup(const RowGroup* pRows, vector<std::pair<Row::Po
   fRowAggStorage->dump();
 }
 
+//------------------------------------------------------------------------------
+// Merge the groups of a clone. The group by columns are at the same place in
+// the input and the output, so the rows find their target by the leading
+// columns like input rows do and initMapData() can copy the keys.
+//
+// pRows(in)  - output RowGroup of the clone.
+// inRows(in) - rows to be merged and the hashes of their keys.
+//------------------------------------------------------------------------------
+void RowAggregation::mergeRowGroup(const RowGroup* pRows, vector<std::pair<Row::Pointer, uint64_t>>& inRows)
+{
+  Row rowIn;
+  pRows->initRow(&rowIn);
+
+  for (const auto& inRow : inRows)
+  {
+    rowIn.setData(inRow.first);
+
+    if (fRowAggStorage->getTargetRow(rowIn, inRow.second, fRow))
+      initMapData(rowIn);
+
+    mergeEntries(rowIn);
+  }
+  fRowAggStorage->dump();
+}
+
+bool RowAggregation::canMergeRows() const
+{
+  if (fGroupByCols.empty() || fKeyOnHeap || fRollupFlag || !fRowGroupOut)
+    return false;
+
+  for (uint64_t i = 0; i < fGroupByCols.size(); i++)
+  {
+    uint32_t colIn = fGroupByCols[i]->fInputColumnIndex;
+
+    if (colIn != i || fGroupByCols[i]->fOutputColumnIndex != colIn ||
+        fRowGroupIn.getColTypes()[colIn] != fRowGroupOut->getColTypes()[colIn] ||
+        fRowGroupIn.getColumnWidth(colIn) != fRowGroupOut->getColumnWidth(colIn) ||
+        fRowGroupIn.getCharsetNumber(colIn) != fRowGroupOut->getCharsetNumber(colIn))
+      return false;
+  }
+
+  // the functions RowAggStorage merges across generations, UDAF, GROUP_CONCAT and
+  // JSON_ARRAYAGG keep state outside the row
+  for (const auto& fun : fFunctionCols)
+  {
+    switch (fun->fAggFunction)
+    {
+      case ROWAGG_COUNT_ASTERISK:
+      case ROWAGG_COUNT_COL_NAME:
+      case ROWAGG_MIN:
+      case ROWAGG_MAX:
+      case ROWAGG_SUM:
+      case ROWAGG_AVG:
+      case ROWAGG_STATS:
+      case ROWAGG_BIT_AND:
+      case ROWAGG_BIT_OR:
+      case ROWAGG_BIT_XOR:
+      case ROWAGG_COUNT_NO_OP:
+      case ROWAGG_DUP_FUNCT:
+      case ROWAGG_DUP_AVG:
+      case ROWAGG_DUP_STATS:
+      case ROWAGG_CONSTANT: break;
+
+      default: return false;
+    }
+  }
+
+  return true;
+}
+
 //------------------------------------------------------------------------------
 // Set join rowgroups and mappings
 //------------------------------------------------------------------------------
@@ -468,6 +468,31 @@ class RowAggregation : public messageqcpp::Serializeable
   virtual void addRowGroup(const RowGroup* pRowGroupIn,
                            std::vector<std::pair<Row::Pointer, uint64_t>>& inRows);
 
+  /** @brief Merge groups aggregated by a clone of this object into this one.
+   *
+   * The rows have the layout of the output RowGroup and are paired with the hash of their
+   * group by key. Only valid if canMergeRows() is true.
+   *
+   * @parm pRows(in) output RowGroup of the clone, used to read the rows.
+   * @parm inRows(in) rows to be merged and their hashes.
+   */
+  void mergeRowGroup(const RowGroup* pRows, std::vector<std::pair<Row::Pointer, uint64_t>>& inRows);
+
+  /** @brief Returns true if groups of clones can be merged with mergeRowGroup().
+   *
+   * That takes group by columns at the same place and of the same type in the input and the
+   * output, no rollup, and aggregate functions whose output mergeEntries() can combine.
+   * Must be called after setInputOutput().
+   */
+  bool canMergeRows() const;
+
+  /** @brief Returns the number of groups held in memory.
+   */
+  size_t groupCount() const
+  {
+    return fRowAggStorage ? fRowAggStorage->size() : 0;
+  }
+
   /** @brief Serialize RowAggregation object into a ByteStream.
    *
    * @parm bs(out) BytesStream that is to be written to.
@@ -542,6 +542,10 @@ class Row
 
   inline void copyBinaryField(Row& dest, uint32_t destIndex, uint32_t srcIndex) const;
 
+  // make colIndex hold the same value as it does in src, a row of the same RGData.
+  // A string in the string table is shared rather than stored again.
+  inline void shareField(const Row& src, uint32_t colIndex) const;
+
   std::string toString(uint32_t rownum = 0) const;
   std::string toCSV() const;
 
@@ -1358,6 +1362,12 @@ inline void Row::copyField(uint32_t destIndex, uint32_t srcIndex) const
   setNullMark(destIndex, getNullMark(srcIndex));
 }
 
+inline void Row::shareField(const Row& src, uint32_t colIndex) const
+{
+  memcpy(&data[offsets[colIndex]], &src.data[offsets[colIndex]], offsets[colIndex + 1] - offsets[colIndex]);
+  setNullMark(colIndex, src.getNullMark(colIndex));
+}
+
 inline void Row::copyField(Row& out, uint32_t destIndex, uint32_t srcIndex) const
 {
   if (UNLIKELY(types[srcIndex] == execplan::CalpontSystemCatalog::VARBINARY ||
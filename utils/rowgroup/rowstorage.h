@@ -42,6 +42,17 @@ using FgidTgid = std::pair<uint64_t, uint64_t>;
 
 uint64_t hashRow(const rowgroup::Row& r, std::size_t lastCol);
 
+/** @brief Map a row hash to one of numOfBuckets aggregation partitions.
+ *
+ *    Takes the partition from the high half of the hash (multiply-shift), so
+ *    there is no division per row and rows of one partition are still spread
+ *    over the whole RowAggStorage table of that partition.
+ */
+inline uint32_t hashToBucket(uint64_t hash, uint32_t numOfBuckets)
+{
+  return static_cast<uint32_t>(((hash >> 32) * numOfBuckets) >> 32);
+}
+
 constexpr const size_t MaxConstStrSize = 2048ULL;
 constexpr const size_t MaxConstStrBufSize = MaxConstStrSize << 1;
 constexpr const uint64_t HashMaskElements = 64ULL;
@@ -89,6 +100,13 @@ class RowAggStorage
    */
   void dump();
 
+  /** @brief Number of groups in the current generation.
+   */
+  size_t size() const
+  {
+    return fCurData ? fCurData->fSize : 0;
+  }
+
   /** @brief Append RGData from other RowAggStorage and clear it.
    *
    *    NB! Any operation except getNextRGData() or append() is UB!
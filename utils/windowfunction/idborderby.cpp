@@ -20,6 +20,7 @@
 
 #include <iostream>
 #include <cassert>
+#include <cstring>
 #include <string>
 #include <stack>
 using namespace std;
@@ -49,6 +50,19 @@ using namespace rowgroup;
 #include "joblisttypes.h"
 #include "mcs_decimal.h"
 
+namespace
+{
+// writes the low "width" bytes of v, the most significant one first
+inline void putBigEndian(uint8_t* p, uint64_t v, uint32_t width)
+{
+  for (uint32_t i = width; i > 0; i--)
+  {
+    p[i - 1] = static_cast<uint8_t>(v);
+    v >>= 8;
+  }
+}
+}  // namespace
+
 // See agg_arg_charsets in sql_type.h to see conversion rules for
 // items that have different char sets
 namespace ordering
@@ -706,13 +720,20 @@ void IdbCompare::setStringTable(bool b)
 }
 
 // OrderByData class implementation
-OrderByData::OrderByData(const std::vector<IdbSortSpec>& spec, const rowgroup::RowGroup& rg)
+OrderByData::OrderByData(const std::vector<IdbSortSpec>& spec, const rowgroup::RowGroup& rg) : fSpec(spec)
 {
   IdbCompare::initialize(rg);
   fRule.compileRules(spec, rg);
   fRule.fIdbCompare = this;
 }
 
+OrderByData::OrderByData(const OrderByData& rhs) : IdbCompare(), fSpec(rhs.fSpec)
+{
+  IdbCompare::initialize(rhs.fRowGroup);
+  fRule.compileRules(fSpec, fRowGroup);
+  fRule.fIdbCompare = this;
+}
+
 // OrderByData class dtor
 OrderByData::~OrderByData()
 {
@@ -730,6 +751,179 @@ OrderByData::~OrderByData()
   }
 }
 
+// SortKeyEncoder class implementation
+SortKeyEncoder::SortKeyEncoder(const std::vector<IdbSortSpec>& spec, const rowgroup::RowGroup& rg)
+ : fKeyLength(0), fEncodable(true)
+{
+  const vector<CalpontSystemCatalog::ColDataType>& types = rg.getColTypes();
+
+  for (vector<IdbSortSpec>::const_iterator i = spec.begin(); i != spec.end(); i++)
+  {
+    Column c;
+    c.spec = *i;
+    c.width = rg.getColumnWidth(i->fIndex);
+    c.weights = 0;
+    c.cs = NULL;
+
+    // the same types, widths and signedness CompareRule::compileRules() uses
+    switch (types[i->fIndex])
+    {
+      case CalpontSystemCatalog::TINYINT:
+      case CalpontSystemCatalog::SMALLINT:
+      case CalpontSystemCatalog::MEDINT:
+      case CalpontSystemCatalog::INT:
+      case CalpontSystemCatalog::BIGINT: c.kind = SIGNED; break;
+
+      case CalpontSystemCatalog::DECIMAL:
+      case CalpontSystemCatalog::UDECIMAL:
+        c.kind = (c.width == datatypes::MAXDECIMALWIDTH) ? WIDE_DECIMAL : SIGNED;
+        break;
+
+      case CalpontSystemCatalog::UTINYINT:
+      case CalpontSystemCatalog::USMALLINT:
+      case CalpontSystemCatalog::UMEDINT:
+      case CalpontSystemCatalog::UINT:
+      case CalpontSystemCatalog::UBIGINT:
+      case CalpontSystemCatalog::DATE:
+      case CalpontSystemCatalog::DATETIME:
+      case CalpontSystemCatalog::TIMESTAMP: c.kind = UNSIGNED; break;
+
+      case CalpontSystemCatalog::TIME: c.kind = TIME; break;
+
+      case CalpontSystemCatalog::FLOAT:
+      case CalpontSystemCatalog::UFLOAT: c.kind = FLOAT; break;
+
+      case CalpontSystemCatalog::DOUBLE:
+      case CalpontSystemCatalog::UDOUBLE: c.kind = DOUBLE; break;
+
+      case CalpontSystemCatalog::CHAR:
+      case CalpontSystemCatalog::VARCHAR:
+      case CalpontSystemCatalog::TEXT:
+      {
+        c.kind = STRING;
+        c.cs = rg.getCharset(i->fIndex);
+
+        // Without padding, "a" sorts before "a " and the key can't be fixed length
+        if (c.cs->state & MY_CS_NOPAD)
+          fEncodable = false;
+
+        // As filesort does, the weights are padded with spaces to the column width
+        c.weights = c.width;
+        c.width = datatypes::Charset(c.cs).strnxfrmlen(c.width);
+        break;
+      }
+
+      case CalpontSystemCatalog::LONGDOUBLE: fEncodable = false; continue;
+
+      // CompareRule doesn't compare the other types either
+      default: continue;
+    }
+
+    fKeyLength += 1 + c.width;
+    fColumns.push_back(c);
+  }
+
+  if (fKeyLength > fMaxKeyLength)
+    fEncodable = false;
+}
+
+void SortKeyEncoder::encode(const Row& row, uint8_t* key) const
+{
+  for (vector<Column>::const_iterator c = fColumns.begin(); c != fColumns.end(); c++)
+  {
+    uint32_t index = c->spec.fIndex;
+
+    // fNf > 0 puts NULL before the values, whatever the direction is
+    if (row.isNullValue(index))
+    {
+      *key++ = (c->spec.fNf > 0) ? 0x00 : 0x02;
+      memset(key, 0, c->width);
+      key += c->width;
+      continue;
+    }
+
+    *key++ = 0x01;
+
+    switch (c->kind)
+    {
+      case SIGNED:
+        putBigEndian(key, row.getIntField(index) ^ (1ULL << (c->width * 8 - 1)), c->width);
+        break;
+
+      case UNSIGNED: putBigEndian(key, row.getUintField(index), c->width); break;
+
+      case WIDE_DECIMAL:
+      {
+        int128_t v;
+        row.getInt128Field(index, v);
+        putBigEndian(key, static_cast<uint64_t>(v >> 64) ^ (1ULL << 63), 8);
+        putBigEndian(key + 8, static_cast<uint64_t>(v), 8);
+        break;
+      }
+
+      case FLOAT:
+      {
+        float f = row.getFloatField(index);
+
+        // -0.0 equals 0.0
+        if (f == 0)
+          f = 0;
+
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        bits = (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+        putBigEndian(key, bits, 4);
+        break;
+      }
+
+      case DOUBLE:
+      {
+        double d = row.getDoubleField(index);
+
+        if (d == 0)
+          d = 0;
+
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        bits = (bits & (1ULL << 63)) ? ~bits : (bits | (1ULL << 63));
+        putBigEndian(key, bits, 8);
+        break;
+      }
+
+      case TIME:
+      {
+        // Same order as TimeCompare: a negative TIME has the MSB set and
+        // sorts before the others, the bigger the rest the earlier.
+        uint64_t v = row.getIntField(index);
+        const uint64_t msb = 1ULL << 63;
+        putBigEndian(key, (v & msb) ? (~(v & ~msb) & ~msb) : (v | msb), 8);
+        break;
+      }
+
+      case STRING:
+      {
+        auto const str = row.getConstString(index);
+        const uchar* src = reinterpret_cast<const uchar*>(str.str() ? str.str() : "");
+        size_t len = datatypes::Charset(c->cs).strnxfrm(key, c->width, c->weights, src, str.length(),
+                                                        datatypes::Charset::getDefaultFlags());
+
+        if (len < c->width)
+          memset(key + len, 0, c->width - len);
+
+        break;
+      }
+    }
+
+    if (c->spec.fAsc < 0)
+    {
+      for (uint32_t i = 0; i < c->width; i++)
+        key[i] = ~key[i];
+    }
+
+    key += c->width;
+  }
+}
+
 // IdbOrderBy class implementation
 IdbOrderBy::IdbOrderBy()
  : fDistinct(false), fMemSize(0), fRowsPerRG(rowgroup::rgCommonSize), fErrorCode(0), fRm(NULL)
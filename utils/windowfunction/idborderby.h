@@ -381,6 +381,8 @@ class OrderByData : public IdbCompare
 {
  public:
   OrderByData(const std::vector<IdbSortSpec>&, const rowgroup::RowGroup&);
+  // the copy gets its own rows and compare objects, so it can be used on another thread
+  OrderByData(const OrderByData&);
   virtual ~OrderByData();
 
   bool operator()(rowgroup::Row::Pointer p1, rowgroup::Row::Pointer p2)
@@ -394,6 +396,60 @@ class OrderByData : public IdbCompare
 
  protected:
   CompareRule fRule;
+  std::vector<IdbSortSpec> fSpec;
+};
+
+// Encodes the sort columns of a row into a key that memcmp() orders the same
+// way CompareRule::less() orders the rows, so a sort can compare keys instead
+// of calling a Compare object per column.  Each column takes a byte that puts
+// NULL first or last, then a fixed number of bytes: the value in big-endian
+// order with the sign flipped, or the padded collation weight string for a
+// string.  The bytes are inverted for DESC.  Every key has the same length.
+class SortKeyEncoder
+{
+ public:
+  SortKeyEncoder(const std::vector<IdbSortSpec>&, const rowgroup::RowGroup&);
+
+  // false if a sort column has no such encoding (LONG DOUBLE, NO PAD
+  // collations) or the key would be too long, CompareRule has to be used then
+  bool encodable() const
+  {
+    return fEncodable;
+  }
+  uint32_t keyLength() const
+  {
+    return fKeyLength;
+  }
+
+  // writes keyLength() bytes to key
+  void encode(const rowgroup::Row& row, uint8_t* key) const;
+
+ private:
+  enum Kind
+  {
+    SIGNED,
+    UNSIGNED,
+    WIDE_DECIMAL,
+    FLOAT,
+    DOUBLE,
+    TIME,
+    STRING
+  };
+
+  struct Column
+  {
+    IdbSortSpec spec;
+    Kind kind;
+    uint32_t width;    // bytes the value takes in the key
+    uint32_t weights;  // STRING only, the number of weights it is padded to
+    CHARSET_INFO* cs;
+  };
+
+  static const uint32_t fMaxKeyLength = 256;
+
+  std::vector<Column> fColumns;
+  uint32_t fKeyLength;
+  bool fEncodable;
 };
 
 // base classs for order by clause used in IDB
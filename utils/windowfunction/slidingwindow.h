@@ -0,0 +1,81 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+namespace windowfunction
+{
+/** @brief MIN or MAX of a sliding frame
+ *
+ *  A monotonic queue of the frame's values in row order.  A value is dropped from the back
+ *  as soon as a later row has a value at least as good, because it can't be the result of
+ *  any frame from then on.  So the result is always at the front, and each row is added
+ *  and removed once, which makes a pass over a partition O(n) regardless of the frame size.
+ *  Rows must be added in increasing row order.
+ */
+template <typename T>
+class SlidingMinMax
+{
+ public:
+  explicit SlidingMinMax(bool max = false) : fMax(max)
+  {
+  }
+
+  void clear()
+  {
+    fQueue.clear();
+  }
+
+  void add(int64_t row, const T& value)
+  {
+    while (!fQueue.empty() && !better(fQueue.back().second, value))
+      fQueue.pop_back();
+    fQueue.emplace_back(row, value);
+  }
+
+  // removes the rows before row from the frame
+  void dropBefore(int64_t row)
+  {
+    while (!fQueue.empty() && fQueue.front().first < row)
+      fQueue.pop_front();
+  }
+
+  bool empty() const
+  {
+    return fQueue.empty();
+  }
+
+  const T& value() const
+  {
+    return fQueue.front().second;
+  }
+
+ private:
+  bool better(const T& a, const T& b) const
+  {
+    return fMax ? (b < a) : (a < b);
+  }
+
+  bool fMax;
+  std::deque<std::pair<int64_t, T> > fQueue;
+};
+
+}  // namespace windowfunction
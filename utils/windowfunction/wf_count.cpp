@@ -105,6 +105,40 @@ void WF_count<T>::resetData()
   WindowFunctionType::resetData();
 }
 
+template <typename T>
+bool WF_count<T>::dropValues(int64_t b, int64_t e)
+{
+  // COUNT(DISTINCT) would need to know how many rows have each value
+  if (fFunctionId == WF__COUNT_DISTINCT)
+    return false;
+
+  int64_t colIn = (fFunctionId == WF__COUNT_ASTERISK) ? 0 : fFieldIndex[1];
+
+  if (colIn == -1 || fFunctionId == WF__COUNT_ASTERISK)
+  {
+    // count(*) and count(constant) count every row, or none if the constant is NULL
+    if (fCount > 0)
+      fCount -= e - b;
+  }
+  else
+  {
+    for (int64_t i = b; i < e; i++)
+    {
+      if (i % 1000 == 0 && fStep->cancelled())
+        break;
+
+      fRow.setData(getPointer(fRowData->at(i)));
+
+      if (fRow.isNullValue(colIn) == false)
+        fCount--;
+    }
+  }
+
+  // the unbounded - current row handling in operator() doesn't apply to a moving frame
+  fPrev = -1;
+  return true;
+}
+
 template <typename T>
 void WF_count<T>::operator()(int64_t b, int64_t e, int64_t c)
 {
@@ -138,13 +138,76 @@ template <typename T>
 void WF_min_max<T>::resetData()
 {
   fCount = 0;
+  fSliding = false;
+  fFrameEnd = -1;
+  fWindow.clear();
 
   WindowFunctionType::resetData();
 }
 
+template <typename T>
+void WF_min_max<T>::addToWindow(int64_t b, int64_t e)
+{
+  uint64_t colIn = fFieldIndex[1];
+
+  for (int64_t i = b; i <= e; i++)
+  {
+    if (i % 1000 == 0 && fStep->cancelled())
+      break;
+
+    fRow.setData(getPointer(fRowData->at(i)));
+
+    if (fRow.isNullValue(colIn) == true)
+      continue;
+
+    T valIn;
+    getValue(colIn, valIn);
+    fWindow.add(i, valIn);
+  }
+}
+
+template <typename T>
+bool WF_min_max<T>::dropValues(int64_t b, int64_t e)
+{
+  // The first time the frame moves, queue up the rows of the current frame that stay in it.
+  // From then on, operator() only adds the rows entering the frame.
+  if (!fSliding)
+  {
+    fWindow.clear();
+    addToWindow(e, fFrameEnd);
+    fSliding = true;
+  }
+  else
+  {
+    fWindow.dropBefore(e);
+  }
+
+  // the unbounded - current row handling in operator() doesn't apply to a moving frame
+  fPrev = -1;
+  return true;
+}
+
 template <typename T>
 void WF_min_max<T>::operator()(int64_t b, int64_t e, int64_t c)
 {
+  if (fSliding)
+  {
+    addToWindow(b, e);
+
+    T* v = NULL;
+
+    if (!fWindow.empty())
+    {
+      fValue = fWindow.value();
+      v = &fValue;
+    }
+
+    setValue(fRow.getColType(fFieldIndex[0]), b, e, c, v);
+    fFrameEnd = e;
+    fPrev = c;
+    return;
+  }
+
   // for unbounded - current row special handling
   if (fPrev >= b && fPrev < c)
     b = c;
@@ -178,6 +241,7 @@ void WF_min_max<T>::operator()(int64_t b, int64_t e, int64_t c)
   T* v = ((fCount > 0) ? &fValue : NULL);
   setValue(fRow.getColType(fFieldIndex[0]), b, e, c, v);
 
+  fFrameEnd = e;
   fPrev = c;
 }
 
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "windowfunctiontype.h"
+#include "slidingwindow.h"
 
 namespace windowfunction
 {
@@ -27,7 +28,7 @@ template <typename T>
 class WF_min_max : public WindowFunctionType
 {
  public:
-  WF_min_max(int id, const std::string& name) : WindowFunctionType(id, name)
+  WF_min_max(int id, const std::string& name) : WindowFunctionType(id, name), fWindow(id == WF__MAX)
   {
     resetData();
   }
@@ -36,12 +37,19 @@ class WF_min_max : public WindowFunctionType
   void operator()(int64_t b, int64_t e, int64_t c);
   WindowFunctionType* clone() const;
   void resetData();
+  bool dropValues(int64_t, int64_t);
 
   static boost::shared_ptr<WindowFunctionType> makeFunction(int, const string&, int, WindowFunctionColumn*);
 
  protected:
   T fValue;
   uint64_t fCount;
+
+  // for moving frames, see dropValues()
+  void addToWindow(int64_t b, int64_t e);
+  bool fSliding;
+  int64_t fFrameEnd;
+  SlidingMinMax<T> fWindow;
 };
 
 }  // namespace windowfunction
@@ -23,6 +23,7 @@
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <type_traits>
 using namespace std;
 
 #include <boost/shared_ptr.hpp>
@@ -147,10 +148,55 @@ void WF_stats<T>::resetData()
   WindowFunctionType::resetData();
 }
 
+template <typename T>
+bool WF_stats<T>::dropValues(int64_t b, int64_t e)
+{
+  // Welford's update isn't exactly reversible on floating point input, recompute the frame
+  if (std::is_floating_point<T>::value)
+    return false;
+
+  uint64_t colIn = fFieldIndex[1];
+
+  for (int64_t i = b; i < e; i++)
+  {
+    if (i % 1000 == 0 && fStep->cancelled())
+      break;
+
+    fRow.setData(getPointer(fRowData->at(i)));
+
+    if (fRow.isNullValue(colIn) == true)
+      continue;
+
+    // Welford's update run backwards
+    T valIn;
+    getValue(colIn, valIn);
+    long double val = (long double)valIn;
+    count_--;
+
+    if (count_ == 0)
+    {
+      mean_ = 0;
+      scaledMomentum2_ = 0;
+      continue;
+    }
+
+    long double delta = val - mean_;
+    mean_ -= delta / count_;
+    scaledMomentum2_ -= delta * (val - mean_);
+  }
+
+  // rounding can take it slightly below 0 when the remaining values are all the same
+  if (scaledMomentum2_ < 0)
+    scaledMomentum2_ = 0;
+
+  // the unbounded - current row handling in operator() doesn't apply to a moving frame
+  fPrev = -1;
+  return true;
+}
+
 template <typename T>
 void WF_stats<T>::operator()(int64_t b, int64_t e, int64_t c)
 {
-  CDT cdt;
   if ((fFrameUnit == WF__FRAME_ROWS) || (fPrev == -1) ||
       (!fPeer->operator()(getPointer(fRowData->at(c)), getPointer(fRowData->at(fPrev)))))
   {
@@ -173,7 +219,7 @@ void WF_stats<T>::operator()(int64_t b, int64_t e, int64_t c)
         continue;
       // Welford's single-pass algorithm
       T valIn;
-      getValue(colIn, valIn, &cdt);
+      getValue(colIn, valIn);
       long double val = (long double)valIn;
       count_++;
       long double delta = val - mean_;
@@ -187,8 +233,8 @@ void WF_stats<T>::operator()(int64_t b, int64_t e, int64_t c)
       auto factor = datatypes::scaleDivisor<long double>(scale);
       long double stat = scaledMomentum2_;
 
-      // adjust the scale if necessary
-      if (scale != 0 && cdt != CalpontSystemCatalog::LONGDOUBLE)
+      // adjust the scale if necessary.  On a moving frame, this can run without reading a value.
+      if (scale != 0 && !std::is_same<T, long double>::value)
       {
         stat /= factor * factor;
       }
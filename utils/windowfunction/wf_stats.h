@@ -36,6 +36,7 @@ class WF_stats : public WindowFunctionType
   void operator()(int64_t b, int64_t e, int64_t c);
   WindowFunctionType* clone() const;
   void resetData();
+  bool dropValues(int64_t, int64_t);
 
   static boost::shared_ptr<WindowFunctionType> makeFunction(int, const string&, int, WindowFunctionColumn*);
 
@@ -23,6 +23,7 @@
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <type_traits>
 using namespace std;
 
 #include <boost/shared_ptr.hpp>
@@ -241,6 +242,41 @@ void WF_sum_avg<T_IN, T_OUT>::resetData()
   WindowFunctionType::resetData();
 }
 
+template <typename T_IN, typename T_OUT>
+bool WF_sum_avg<T_IN, T_OUT>::dropValues(int64_t b, int64_t e)
+{
+  // the DISTINCT versions would need to know how many rows have each value.
+  // Floating point sums don't give back the same result when the dropped values are
+  // subtracted again, so those frames are recomputed.
+  if (fDistinct || std::is_floating_point<T_IN>::value)
+    return false;
+
+  uint64_t colIn = fFieldIndex[1];
+
+  for (int64_t i = b; i < e; i++)
+  {
+    if (i % 1000 == 0 && fStep->cancelled())
+      break;
+
+    fRow.setData(getPointer(fRowData->at(i)));
+
+    if (fRow.isNullValue(colIn) == true)
+      continue;
+
+    getValue(colIn, fVal);
+    fSum -= (T_OUT)fVal;
+    fCount--;
+  }
+
+  // don't carry rounding errors over to the rows entering the frame
+  if (fCount == 0)
+    fSum = 0;
+
+  // the unbounded - current row handling in operator() doesn't apply to a moving frame
+  fPrev = -1;
+  return true;
+}
+
 template <typename T_IN, typename T_OUT>
 void WF_sum_avg<T_IN, T_OUT>::operator()(int64_t b, int64_t e, int64_t c)
 {
@@ -20,6 +20,8 @@
 
 //#define NDEBUG
 #include <cassert>
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <iomanip>
 using namespace std;
@@ -45,13 +47,19 @@ using namespace joblist;
 #include "windowframe.h"
 #include "windowfunction.h"
 
+namespace
+{
+// below this many rows per thread, the sort and the partitions aren't worth splitting up
+const uint64_t minRowsPerThread = 64 * 1024;
+}  // namespace
+
 namespace windowfunction
 {
 WindowFunction::WindowFunction(boost::shared_ptr<WindowFunctionType>& f,
                                boost::shared_ptr<ordering::EqualCompData>& p,
                                boost::shared_ptr<OrderByData>& o, boost::shared_ptr<WindowFrame>& w,
                                const RowGroup& g, const Row& r)
- : fFunctionType(f), fPartitionBy(p), fOrderBy(o), fFrame(w), fRowGroup(g), fRow(r)
+ : fFunctionType(f), fPartitionBy(p), fOrderBy(o), fFrame(w), fRowGroup(g), fRow(r), fThreadCount(1)
 {
 }
 
@@ -66,7 +74,17 @@ void WindowFunction::operator()()
     fRowData.reset(new vector<RowPosition>(fStep->getRowData()));
 
     if (fOrderBy->rule().fCompares.size() > 0)
-      sort(fRowData->begin(), fRowData->size());
+    {
+      if (fThreadCount > 1 && fRowData->size() >= 2 * minRowsPerThread)
+      {
+        parallelSort();
+      }
+      else
+      {
+        RowLess less(fOrderBy, this);
+        sort(fRowData->begin(), fRowData->size(), less);
+      }
+    }
 
     // get partitions
     if (fPartitionBy.get() != NULL && !fStep->cancelled())
@@ -91,125 +109,140 @@ void WindowFunction::operator()()
       fPartition.push_back(make_pair(0, fRowData->size()));
     }
 
-    // compute partition by partition
-    int64_t uft = fFrame->upper()->boundType();
-    int64_t lft = fFrame->lower()->boundType();
-    bool upperUbnd = (uft == WF__UNBOUNDED_PRECEDING || uft == WF__UNBOUNDED_FOLLOWING);
-    bool lowerUbnd = (lft == WF__UNBOUNDED_PRECEDING || lft == WF__UNBOUNDED_FOLLOWING);
-    bool upperCnrw = (uft == WF__CURRENT_ROW);
-    bool lowerCnrw = (lft == WF__CURRENT_ROW);
     fFunctionType->setRowData(fRowData);
     fFunctionType->setRowMetaData(fRowGroup, fRow);
     fFrame->setRowData(fRowData);
     fFrame->setRowMetaData(fRowGroup, fRow);
 
-    for (uint64_t k = 0; k < fPartition.size() && !fStep->cancelled(); k++)
-    {
-      fFunctionType->resetData();
-      fFunctionType->partition(fPartition[k]);
+    // compute partition by partition.  UDAnF functions may keep state outside the function
+    // object, so they stay on one thread.
+    if (fThreadCount > 1 && fPartition.size() > 1 && fRowData->size() >= 2 * minRowsPerThread &&
+        fFunctionType->functionId() != WF__UDAF)
+      parallelPartitions();
+    else
+      computePartitions(fFunctionType.get(), fFrame.get(), 0, fPartition.size());
+  }
+  catch (...)
+  {
+    fStep->handleException(std::current_exception(), logging::ERR_EXECUTE_WINDOW_FUNCTION,
+                           logging::ERR_WF_DATA_SET_TOO_BIG, "WindowFunction::operator()");
+  }
+}
+
+void WindowFunction::computePartitions(WindowFunctionType* func, WindowFrame* frame, uint64_t first,
+                                       uint64_t last)
+{
+  int64_t uft = frame->upper()->boundType();
+  int64_t lft = frame->lower()->boundType();
+  bool upperUbnd = (uft == WF__UNBOUNDED_PRECEDING || uft == WF__UNBOUNDED_FOLLOWING);
+  bool lowerUbnd = (lft == WF__UNBOUNDED_PRECEDING || lft == WF__UNBOUNDED_FOLLOWING);
+  bool upperCnrw = (uft == WF__CURRENT_ROW);
+  bool lowerCnrw = (lft == WF__CURRENT_ROW);
+
+  for (uint64_t k = first; k < last && !fStep->cancelled(); k++)
+  {
+    func->resetData();
+    func->partition(fPartition[k]);
 
-      int64_t begin = fPartition[k].first;
-      int64_t end = fPartition[k].second;
+    int64_t begin = fPartition[k].first;
+    int64_t end = fPartition[k].second;
 
-      if (upperUbnd && lowerUbnd)
-      {
-        fFunctionType->operator()(begin, end, WF__BOUND_ALL);
-      }
-      else if (upperUbnd && lowerCnrw)
+    if (upperUbnd && lowerUbnd)
+    {
+      func->operator()(begin, end, WF__BOUND_ALL);
+    }
+    else if (upperUbnd && lowerCnrw)
+    {
+      if (frame->unit() == WF__FRAME_ROWS)
       {
-        if (fFrame->unit() == WF__FRAME_ROWS)
+        for (int64_t i = begin; i <= end && !fStep->cancelled(); i++)
         {
-          for (int64_t i = begin; i <= end && !fStep->cancelled(); i++)
-          {
-            fFunctionType->operator()(begin, i, i);
-          }
+          func->operator()(begin, i, i);
         }
-        else
+      }
+      else
+      {
+        for (int64_t i = begin; i <= end && !fStep->cancelled(); i++)
         {
-          for (int64_t i = begin; i <= end && !fStep->cancelled(); i++)
-          {
-            pair<int64_t, int64_t> w = fFrame->getWindow(begin, end, i);
-            int64_t j = i;
+          pair<int64_t, int64_t> w = frame->getWindow(begin, end, i);
+          int64_t j = i;
 
-            if (w.second > i)
-              j = w.second;
+          if (w.second > i)
+            j = w.second;
 
-            fFunctionType->operator()(begin, j, i);
-          }
+          func->operator()(begin, j, i);
         }
       }
-      else if (upperCnrw && lowerUbnd)
+    }
+    else if (upperCnrw && lowerUbnd)
+    {
+      if (frame->unit() == WF__FRAME_ROWS)
       {
-        if (fFrame->unit() == WF__FRAME_ROWS)
+        for (int64_t i = end; i >= begin && !fStep->cancelled(); i--)
         {
-          for (int64_t i = end; i >= begin && !fStep->cancelled(); i--)
-          {
-            fFunctionType->operator()(i, end, i);
-          }
+          func->operator()(i, end, i);
         }
-        else
+      }
+      else
+      {
+        for (int64_t i = end; i >= begin && !fStep->cancelled(); i--)
         {
-          for (int64_t i = end; i >= begin && !fStep->cancelled(); i--)
-          {
-            pair<int64_t, int64_t> w = fFrame->getWindow(begin, end, i);
-            int64_t j = i;
+          pair<int64_t, int64_t> w = frame->getWindow(begin, end, i);
+          int64_t j = i;
 
-            if (w.first < i)
-              j = w.first;
+          if (w.first < i)
+            j = w.first;
 
-            fFunctionType->operator()(j, end, i);
-          }
+          func->operator()(j, end, i);
         }
       }
-      else
+    }
+    else
+    {
+      pair<int64_t, int64_t> w;
+      pair<int64_t, int64_t> prevFrame;
+      int64_t b, e;
+      bool firstTime = true;
+
+      for (int64_t i = begin; i <= end && !fStep->cancelled(); i++)
       {
-        pair<int64_t, int64_t> w;
-        pair<int64_t, int64_t> prevFrame;
-        int64_t b, e;
-        bool firstTime = true;
+        w = frame->getWindow(begin, end, i);
+        b = w.first;
+        e = w.second;
 
-        for (int64_t i = begin; i <= end && !fStep->cancelled(); i++)
+        if (firstTime)
         {
-          w = fFrame->getWindow(begin, end, i);
-          b = w.first;
-          e = w.second;
-
-          if (firstTime)
-          {
-            prevFrame = w;
-          }
-
-          // UDAnF functions may have a dropValue function implemented.
-          // If they do, we can optimize by calling dropValue() for those
-          // values leaving the window and nextValue for those entering, rather
-          // than a resetData() and then iterating over the entire window.
-          // Built-in functions may have this functionality added in the future.
-          // If b > e then the frame is entirely outside of the partition
-          // and there's no values to drop
-          if (!firstTime && (b <= e) && fFunctionType->dropValues(prevFrame.first, w.first))
-          {
-            // Adjust the beginning of the frame for nextValue
-            // to start where the previous frame left off.
-            b = prevFrame.second + 1;
-          }
-          else
-          {
-            // If dropValues failed or doesn't exist,
-            // calculate the entire frame.
-            fFunctionType->resetData();
-          }
-          fFunctionType->operator()(b, e, i);  // UDAnF: Calls nextValue and evaluate
           prevFrame = w;
-          firstTime = false;
         }
+
+        // COUNT, SUM, AVG, MIN, MAX, the statistical functions, and UDAnF
+        // functions with a dropValue function implemented can drop the values
+        // leaving the window and add those entering, rather than a resetData()
+        // and then iterating over the entire window.  That makes a moving
+        // frame O(n) instead of O(n * frame size).
+        // If b > e then the frame is entirely outside of the partition
+        // and there's no values to drop.  The previous frame also has to be
+        // non-empty and overlap or touch this one, otherwise the function
+        // doesn't hold the values that would be dropped.
+        if (!firstTime && (b <= e) && (prevFrame.first <= prevFrame.second) &&
+            (w.first <= prevFrame.second + 1) && func->dropValues(prevFrame.first, w.first))
+        {
+          // Adjust the beginning of the frame for nextValue
+          // to start where the previous frame left off.
+          b = prevFrame.second + 1;
+        }
+        else
+        {
+          // If dropValues failed or doesn't exist,
+          // calculate the entire frame.
+          func->resetData();
+        }
+        func->operator()(b, e, i);  // UDAnF: Calls nextValue and evaluate
+        prevFrame = w;
+        firstTime = false;
       }
     }
   }
-  catch (...)
-  {
-    fStep->handleException(std::current_exception(), logging::ERR_EXECUTE_WINDOW_FUNCTION,
-                           logging::ERR_WF_DATA_SET_TOO_BIG, "WindowFunction::operator()");
-  }
 }
 
 void WindowFunction::setCallback(joblist::WindowFunctionStep* step, int id)
@@ -225,7 +258,7 @@ const Row& WindowFunction::getRow() const
   return fRow;
 }
 
-void WindowFunction::sort(std::vector<RowPosition>::iterator v, uint64_t n)
+void WindowFunction::sort(std::vector<RowPosition>::iterator v, uint64_t n, RowLess& less)
 {
   // recursive function termination condition.
   if (n < 2 || fStep->cancelled())
@@ -238,11 +271,11 @@ void WindowFunction::sort(std::vector<RowPosition>::iterator v, uint64_t n)
   while (l <= h && !(fStep->cancelled()))
   {
     // Can use while here, but need check boundary and cancel status.
-    if (fOrderBy->operator()(getPointer(*l), getPointer(p)))
+    if (less(*l, p))
     {
       l++;
     }
-    else if (fOrderBy->operator()(getPointer(p), getPointer(*h)))
+    else if (less(p, *h))
     {
       h--;
     }
@@ -254,8 +287,149 @@ void WindowFunction::sort(std::vector<RowPosition>::iterator v, uint64_t n)
     }
   }
 
-  sort(v, std::distance(v, h) + 1);
-  sort(l, std::distance(l, v) + n);
+  sort(v, std::distance(v, h) + 1, less);
+  sort(l, std::distance(l, v) + n, less);
+}
+
+WindowFunction::RowLess::RowLess(const boost::shared_ptr<OrderByData>& o, const WindowFunction* wf)
+ : fOrderBy(o), fRowGroup(wf->fRowGroup), fRow(wf->fRow), fStep(wf->fStep)
+{
+}
+
+bool WindowFunction::RowLess::operator()(RowPosition a, RowPosition b)
+{
+  return fOrderBy->operator()(fStep->getPointer(a, fRowGroup, fRow), fStep->getPointer(b, fRowGroup, fRow));
+}
+
+void WindowFunction::parallelSort()
+{
+  // Each thread sorts a piece, then neighboring pieces are merged in pairs, also in parallel,
+  // until there is one.
+  uint64_t rowCnt = fRowData->size();
+  uint64_t pieces = min<uint64_t>(fThreadCount, rowCnt / minRowsPerThread);
+  vector<uint64_t> bounds;
+
+  for (uint64_t i = 0; i <= pieces; i++)
+    bounds.push_back(rowCnt * i / pieces);
+
+  vector<uint64_t> jobs;
+
+  for (uint64_t i = 0; i < pieces; i++)
+  {
+    jobs.push_back(joblist::JobStep::jobstepThreadPool.invoke(
+        [this, &bounds, i]
+        {
+          try
+          {
+            RowLess less(boost::shared_ptr<OrderByData>(new OrderByData(*fOrderBy)), this);
+            sort(fRowData->begin() + bounds[i], bounds[i + 1] - bounds[i], less);
+          }
+          catch (...)
+          {
+            fStep->handleException(std::current_exception(), logging::ERR_EXECUTE_WINDOW_FUNCTION,
+                                   logging::ERR_WF_DATA_SET_TOO_BIG, "WindowFunction::parallelSort()");
+          }
+        }));
+  }
+
+  joblist::JobStep::jobstepThreadPool.join(jobs);
+
+  for (uint64_t width = 1; width < pieces && !fStep->cancelled(); width *= 2)
+  {
+    jobs.clear();
+
+    for (uint64_t i = 0; i + width < pieces; i += 2 * width)
+    {
+      uint64_t first = bounds[i];
+      uint64_t middle = bounds[i + width];
+      uint64_t last = bounds[min(i + 2 * width, pieces)];
+      jobs.push_back(joblist::JobStep::jobstepThreadPool.invoke(
+          [this, first, middle, last]
+          {
+            try
+            {
+              RowLess less(boost::shared_ptr<OrderByData>(new OrderByData(*fOrderBy)), this);
+              std::inplace_merge(fRowData->begin() + first, fRowData->begin() + middle,
+                                 fRowData->begin() + last, less);
+            }
+            catch (...)
+            {
+              fStep->handleException(std::current_exception(), logging::ERR_EXECUTE_WINDOW_FUNCTION,
+                                     logging::ERR_WF_DATA_SET_TOO_BIG, "WindowFunction::parallelSort()");
+            }
+          }));
+    }
+
+    joblist::JobStep::jobstepThreadPool.join(jobs);
+  }
+}
+
+void WindowFunction::parallelPartitions()
+{
+  // Group the partitions into contiguous ranges of about the same number of rows.  There are
+  // more ranges than threads, so a few large partitions don't leave the other threads idle.
+  uint64_t target = max<uint64_t>(fRowData->size() / (fThreadCount * 4), 1);
+  vector<uint64_t> ranges(1, 0);
+  uint64_t rows = 0;
+
+  for (uint64_t k = 0; k < fPartition.size(); k++)
+  {
+    rows += fPartition[k].second - fPartition[k].first + 1;
+
+    if (rows >= target)
+    {
+      ranges.push_back(k + 1);
+      rows = 0;
+    }
+  }
+
+  if (ranges.back() != fPartition.size())
+    ranges.push_back(fPartition.size());
+
+  uint64_t rangeCnt = ranges.size() - 1;
+  std::atomic<uint64_t> nextRange(0);
+  vector<uint64_t> jobs;
+
+  for (uint64_t t = 0; t < min<uint64_t>(fThreadCount, rangeCnt) && !fStep->cancelled(); t++)
+  {
+    jobs.push_back(joblist::JobStep::jobstepThreadPool.invoke(
+        [this, &ranges, rangeCnt, &nextRange]
+        {
+          try
+          {
+            // The function and the frame keep per row state, and their peer functor isn't thread
+            // safe.  Each thread works on its own copies.  The rows of different partitions don't
+            // overlap, so the results can be written in place.
+            boost::shared_ptr<EqualCompData> peer;
+            const boost::shared_ptr<EqualCompData>& origPeer = fFunctionType->peer();
+
+            if (origPeer)
+              peer.reset(new EqualCompData(origPeer->fIndex, *origPeer->rowGroup()));
+
+            boost::shared_ptr<WindowFunctionType> func(fFunctionType->clone());
+            func->peer(peer);
+            boost::shared_ptr<WindowFrame> frame(fFrame->clone());
+
+            if (frame->upper()->peer())
+              frame->upper()->peer(peer);
+
+            if (frame->lower()->peer())
+              frame->lower()->peer(peer);
+
+            uint64_t i;
+
+            while ((i = nextRange++) < rangeCnt && !fStep->cancelled())
+              computePartitions(func.get(), frame.get(), ranges[i], ranges[i + 1]);
+          }
+          catch (...)
+          {
+            fStep->handleException(std::current_exception(), logging::ERR_EXECUTE_WINDOW_FUNCTION,
+                                   logging::ERR_WF_DATA_SET_TOO_BIG, "WindowFunction::parallelPartitions()");
+          }
+        }));
+  }
+
+  joblist::JobStep::jobstepThreadPool.join(jobs);
 }
 
 }  // namespace windowfunction
@@ -70,9 +70,39 @@ class WindowFunction
   void setCallback(joblist::WindowFunctionStep*, int);
   const rowgroup::Row& getRow() const;
 
+  // the number of threads the sort and the partitions may use
+  void threadCount(uint32_t t)
+  {
+    fThreadCount = t;
+  }
+
  protected:
+  // Compares rows by the window's sort order.  The compare functor and the row it reads through
+  // are not thread safe, so each sorting thread needs its own.
+  class RowLess
+  {
+   public:
+    RowLess(const boost::shared_ptr<ordering::OrderByData>& o, const WindowFunction* wf);
+    bool operator()(joblist::RowPosition a, joblist::RowPosition b);
+
+   private:
+    boost::shared_ptr<ordering::OrderByData> fOrderBy;
+    rowgroup::RowGroup fRowGroup;
+    rowgroup::Row fRow;
+    joblist::WindowFunctionStep* fStep;
+  };
+
   // cancellable sort function
-  void sort(std::vector<joblist::RowPosition>::iterator, uint64_t);
+  void sort(std::vector<joblist::RowPosition>::iterator, uint64_t, RowLess&);
+
+  // sorts fRowData in fThreadCount pieces, then merges them
+  void parallelSort();
+
+  // computes partitions [first, last) of fPartition
+  void computePartitions(WindowFunctionType*, WindowFrame*, uint64_t first, uint64_t last);
+
+  // spreads the partitions over fThreadCount threads, each with its own copy of the function
+  void parallelPartitions();
 
   // special window frames
   void processUnboundedWindowFrame1();
@@ -105,6 +135,7 @@ class WindowFunction
   // pointer back to step
   joblist::WindowFunctionStep* fStep;
   int fId;
+  uint32_t fThreadCount;
 
   friend class joblist::WindowFunctionStep;
 };
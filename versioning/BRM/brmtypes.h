@@ -110,6 +110,9 @@ typedef struct _SIDTIDEntry SIDTIDEntry;
 // @bug 1970 - Added CPInfo and CPMaxMin structs used by new interface that allows setting the max and min CP
 // data for multiple extents.
 
+// CP sequence numbers wrap around to 0 past this
+#define EM_MAX_SEQNUM 2000000000
+
 // Special seqNum field values.
 #define SEQNUM_MARK_INVALID (-1)
 #define SEQNUM_MARK_INVALID_SET_RANGE (-2)
@@ -537,6 +540,10 @@ const uint8_t FINISH_CPIMPORT_JOB = 104;
 const uint8_t START_READONLY = 105;
 const uint8_t FORCE_CLEAR_CPIMPORT_JOBS = 106;
 
+/* Extent bloom filter interface */
+const uint8_t SET_EXTENT_BLOOMS = 107;
+const uint8_t GET_EXTENT_BLOOMS = 108;
+
 /* Error codes returned by the DBRM functions. */
 /// The operation was successful
 const int8_t ERR_OK = 0;
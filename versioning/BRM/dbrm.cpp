@@ -46,6 +46,7 @@
 #include "blocksize.h"
 #define DBRM_DLLEXPORT
 #include "dbrm.h"
+#include "extentbloom.h"
 #undef DBRM_DLLEXPORT
 
 #ifdef BRM_DEBUG
@@ -4382,6 +4383,61 @@ bool DBRM::getTableLockInfo(uint64_t id, TableLockInfo* tli)
   return (bool)err;
 }
 
+int DBRM::setExtentBlooms(const vector<ExtentBloomEntry>& entries) DBRM_THROW
+{
+  ByteStream command, response;
+  uint8_t err;
+
+  command << SET_EXTENT_BLOOMS;
+  serializeVector<ExtentBloomEntry>(command, entries);
+  err = send_recv(command, response);
+
+  if (err != ERR_OK)
+    return err;
+
+  if (response.length() != 1)
+    return ERR_NETWORK;
+
+  response >> err;
+  CHECK_EMPTY(response);
+  return err;
+}
+
+int DBRM::getExtentBlooms(OID_t oid, ExtentBloomColumn& column) DBRM_THROW
+{
+  ByteStream command, response;
+  uint8_t err, changed;
+
+  command << GET_EXTENT_BLOOMS << (ByteStream::quadbyte)oid << column.generation;
+  err = send_recv(command, response);
+
+  if (err != ERR_OK)
+    return err;
+
+  if (response.length() == 0)
+    return ERR_NETWORK;
+
+  response >> err;
+
+  if (err != ERR_OK)
+    return err;
+
+  try
+  {
+    response >> changed;
+
+    if (changed)
+      column.deserialize(response);
+  }
+  catch (exception&)
+  {
+    return ERR_NETWORK;
+  }
+
+  CHECK_EMPTY(response);
+  return ERR_OK;
+}
+
 void DBRM::startAISequence(uint32_t OID, uint64_t firstNum, uint32_t colWidth,
                            execplan::CalpontSystemCatalog::ColDataType colDataType)
 {
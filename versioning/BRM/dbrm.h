@@ -57,6 +57,9 @@
 
 namespace BRM
 {
+struct ExtentBloomEntry;
+struct ExtentBloomColumn;
+
 /** @brief The interface to the Distributed BRM system.
  *
  * There are 3 components of the Distributed BRM (DBRM).
@@ -783,6 +786,21 @@ class DBRM
   EXPORT void releaseAllTableLocks();
   EXPORT bool getTableLockInfo(uint64_t id, TableLockInfo* out);
 
+  /* Extent bloom filter interface, see extentbloom.h */
+  /** @brief Save the bloom filters of some extents on the controller
+   *
+   * An entry with an empty filter drops the extent's filter.
+   */
+  EXPORT int setExtentBlooms(const std::vector<ExtentBloomEntry>& entries) DBRM_THROW;
+
+  /** @brief Get the bloom filters of a column
+   *
+   * column.generation is the generation of the filters the caller already has
+   * (0 for none).  If the controller's are the same, column is left as it is,
+   * else it's replaced by the controller's.
+   */
+  EXPORT int getExtentBlooms(OID_t oid, ExtentBloomColumn& column) DBRM_THROW;
+
   /** Casual partitioning support **/
   EXPORT int markExtentInvalid(const LBID_t lbid,
                                execplan::CalpontSystemCatalog::ColDataType colDataType) DBRM_THROW;
@@ -0,0 +1,503 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "extentbloom.h"
+#include "extentmap.h"
+#include "dbrm.h"
+#include "configcpp.h"
+#include "IDBDataFile.h"
+#include "IDBPolicy.h"
+#include "collation.h"
+#include "conststring.h"
+#include "hasher.h"
+
+using namespace std;
+using namespace idbdatafile;
+using namespace execplan;
+
+namespace
+{
+const uint32_t fileMagic = 0x4d4f4c42;  // "BLOM"
+const uint32_t fileVersion = 2;
+
+// columns kept by the per process cache of ExtentBloomStore::load()
+const size_t maxCachedColumns = 1024;
+
+std::map<BRM::OID_t, BRM::SP_ExtentBloomColumn> cache;
+boost::mutex cacheMutex;
+
+string dbRootPath(uint16_t dbRoot)
+{
+  ostringstream oss;
+  oss << "DBRoot" << dbRoot;
+  return config::Config::makeConfig()->getConfig("SystemConfig", oss.str());
+}
+
+}  // namespace
+
+namespace BRM
+{
+//------------------------------------------------------------------------------
+// ExtentBloom
+//------------------------------------------------------------------------------
+ExtentBloom::ExtentBloom(uint32_t bits)
+{
+  uint32_t size = minBits;
+
+  while (size < bits && size < (1U << 31))
+    size <<= 1;
+
+  fWords.resize(size / 64, 0);
+}
+
+bool ExtentBloom::supported(CalpontSystemCatalog::ColDataType type, int width, bool isDict)
+{
+  if (isDict)
+    return type == CalpontSystemCatalog::CHAR || type == CalpontSystemCatalog::VARCHAR ||
+           type == CalpontSystemCatalog::TEXT;
+
+  switch (type)
+  {
+    // -0.0 and 0.0 are equal with different bytes
+    case CalpontSystemCatalog::FLOAT:
+    case CalpontSystemCatalog::UFLOAT:
+    case CalpontSystemCatalog::DOUBLE:
+    case CalpontSystemCatalog::UDOUBLE:
+    case CalpontSystemCatalog::LONGDOUBLE:
+    case CalpontSystemCatalog::VARBINARY:
+    case CalpontSystemCatalog::BLOB:
+    case CalpontSystemCatalog::TEXT: return false;
+
+    default: break;
+  }
+
+  return width == 1 || width == 2 || width == 4 || width == 8 || width == 16;
+}
+
+uint64_t ExtentBloom::hash(const void* value, uint32_t width)
+{
+  utils::Hasher64_r hasher;
+  return hasher.finalize(hasher(value, width), width);
+}
+
+uint64_t ExtentBloom::hash(const struct charset_info_st* cs, const void* value, uint32_t length)
+{
+  utils::ConstString str((const char*)value, length);
+  str.rtrimZero();
+  uint32_t h = datatypes::Charset(cs).hash(str.str(), str.length());
+  return hash(&h, sizeof(h));
+}
+
+void ExtentBloom::add(uint64_t hash)
+{
+  uint64_t mask = bits() - 1;
+  uint64_t delta = (hash >> 32) | 1;
+
+  for (uint32_t i = 0; i < numHashes; i++, hash += delta)
+    fWords[(hash & mask) >> 6] |= 1ULL << (hash & 63);
+}
+
+bool ExtentBloom::mayContain(uint64_t hash) const
+{
+  if (fWords.empty())
+    return true;
+
+  uint64_t mask = bits() - 1;
+  uint64_t delta = (hash >> 32) | 1;
+
+  for (uint32_t i = 0; i < numHashes; i++, hash += delta)
+  {
+    if (!(fWords[(hash & mask) >> 6] & (1ULL << (hash & 63))))
+      return false;
+  }
+
+  return true;
+}
+
+void ExtentBloom::fold()
+{
+  size_t half = fWords.size() / 2;
+
+  for (size_t i = 0; i < half; i++)
+    fWords[i] |= fWords[i + half];
+
+  fWords.resize(half);
+}
+
+void ExtentBloom::shrink(double maxFill)
+{
+  while (bits() > minBits)
+  {
+    size_t half = fWords.size() / 2;
+    uint64_t set = 0;
+
+    for (size_t i = 0; i < half; i++)
+      set += __builtin_popcountll(fWords[i] | fWords[i + half]);
+
+    if (set > maxFill * half * 64)
+      break;
+
+    fold();
+  }
+}
+
+void ExtentBloom::merge(const ExtentBloom& other)
+{
+  if (other.empty())
+    return;
+
+  if (empty())
+  {
+    fWords = other.fWords;
+    return;
+  }
+
+  ExtentBloom folded(other);
+
+  while (folded.fWords.size() > fWords.size())
+    folded.fold();
+
+  while (fWords.size() > folded.fWords.size())
+    fold();
+
+  for (size_t i = 0; i < fWords.size(); i++)
+    fWords[i] |= folded.fWords[i];
+}
+
+double ExtentBloom::fill() const
+{
+  if (fWords.empty())
+    return 0.0;
+
+  uint64_t set = 0;
+
+  for (uint64_t word : fWords)
+    set += __builtin_popcountll(word);
+
+  return (double)set / bits();
+}
+
+void ExtentBloom::serialize(messageqcpp::ByteStream& bs) const
+{
+  bs << (uint32_t)fWords.size();
+  bs.append((const uint8_t*)fWords.data(), fWords.size() * sizeof(uint64_t));
+}
+
+void ExtentBloom::deserialize(messageqcpp::ByteStream& bs)
+{
+  uint32_t words;
+  bs >> words;
+
+  if (bs.length() < words * sizeof(uint64_t))
+    throw runtime_error("ExtentBloom::deserialize: truncated filter");
+
+  fWords.resize(words);
+  memcpy(fWords.data(), bs.buf(), words * sizeof(uint64_t));
+  bs.advance(words * sizeof(uint64_t));
+}
+
+//------------------------------------------------------------------------------
+// ExtentBloomEntry
+//------------------------------------------------------------------------------
+bool ExtentBloomEntry::describes(const EMEntry& extent) const
+{
+  if (bloom.empty() || partitionNum != extent.partitionNum || segmentNum != extent.segmentNum)
+    return false;
+
+  const EMCasualPartition_t& cp = extent.partition.cprange;
+
+  if (cp.sequenceNum == seqNum)
+    return cp.isValid == (cpValid ? CP_VALID : CP_INVALID);
+
+  // Setting the min/max of an invalid extent is the only way to the next
+  // sequence number with the CP info valid
+  int32_t nextSeqNum = (seqNum >= EM_MAX_SEQNUM) ? 0 : seqNum + 1;
+  return !cpValid && cp.isValid == CP_VALID && cp.sequenceNum == nextSeqNum;
+}
+
+void ExtentBloomEntry::serialize(messageqcpp::ByteStream& bs) const
+{
+  bs << (uint32_t)oid << (uint64_t)startLbid << partitionNum << segmentNum << lastBlock << (uint8_t)full
+     << seqNum << (uint8_t)cpValid;
+  bloom.serialize(bs);
+}
+
+void ExtentBloomEntry::deserialize(messageqcpp::ByteStream& bs)
+{
+  uint32_t tmp32;
+  uint64_t tmp64;
+  uint8_t fullFlag, cpValidFlag;
+
+  bs >> tmp32 >> tmp64 >> partitionNum >> segmentNum >> lastBlock >> fullFlag >> seqNum >> cpValidFlag;
+  oid = tmp32;
+  startLbid = tmp64;
+  full = fullFlag;
+  cpValid = cpValidFlag;
+  bloom.deserialize(bs);
+}
+
+//------------------------------------------------------------------------------
+// ExtentBloomColumn
+//------------------------------------------------------------------------------
+void ExtentBloomColumn::serialize(messageqcpp::ByteStream& bs) const
+{
+  bs << generation << (uint64_t)entries.size();
+
+  for (const auto& it : entries)
+    bs << it.second;
+}
+
+void ExtentBloomColumn::deserialize(messageqcpp::ByteStream& bs)
+{
+  uint64_t count;
+  bs >> generation >> count;
+  entries.clear();
+
+  for (uint64_t i = 0; i < count; i++)
+  {
+    ExtentBloomEntry entry;
+    bs >> entry;
+    entries[entry.startLbid] = entry;
+  }
+}
+
+bool ExtentBloomColumn::load(const string& name)
+{
+  boost::scoped_ptr<IDBDataFile> in(
+      IDBDataFile::open(IDBPolicy::getType(name.c_str(), IDBPolicy::WRITEENG), name.c_str(), "r", 0));
+
+  if (!in)
+    return false;
+
+  off64_t size = in->size();
+  messageqcpp::ByteStream bs;
+
+  if (size < (off64_t)(2 * sizeof(uint32_t)))
+    return false;
+
+  bs.needAtLeast(size);
+
+  if (in->pread(bs.getInputPtr(), 0, size) != size)
+    return false;
+
+  bs.advanceInputPtr(size);
+  uint32_t magic, version;
+  bs >> magic >> version;
+
+  if (magic != fileMagic || version != fileVersion)
+    return false;
+
+  try
+  {
+    deserialize(bs);
+  }
+  catch (std::exception&)
+  {
+    // a truncated file only loses its filters
+    generation = 0;
+    entries.clear();
+    return false;
+  }
+
+  return true;
+}
+
+int ExtentBloomColumn::save(const string& name) const
+{
+  messageqcpp::ByteStream bs;
+  bs << fileMagic << fileVersion;
+  serialize(bs);
+
+  string tmpName = name + ".tmp";
+  {
+    boost::scoped_ptr<IDBDataFile> out(IDBDataFile::open(
+        IDBPolicy::getType(tmpName.c_str(), IDBPolicy::WRITEENG), tmpName.c_str(), "wb", 0));
+
+    if (!out)
+      return ERR_FAILURE;
+
+    if (out->write(bs.buf(), bs.length()) != (ssize_t)bs.length() || out->flush() != 0)
+    {
+      out.reset();
+      IDBPolicy::remove(tmpName.c_str());
+      return ERR_FAILURE;
+    }
+  }
+
+  if (IDBPolicy::rename(tmpName.c_str(), name.c_str()) != 0)
+  {
+    IDBPolicy::remove(tmpName.c_str());
+    return ERR_FAILURE;
+  }
+
+  return ERR_OK;
+}
+
+//------------------------------------------------------------------------------
+// ExtentBloomStore
+//------------------------------------------------------------------------------
+string ExtentBloomStore::pendingFileName(OID_t tableOid, uint16_t dbRoot)
+{
+  // next to the bulk rollback meta file of the load
+  ostringstream oss;
+  oss << dbRootPath(dbRoot) << "/bulkRollback/" << tableOid << ".blm";
+  return oss.str();
+}
+
+SP_ExtentBloomColumn ExtentBloomStore::load(OID_t oid)
+{
+  SP_ExtentBloomColumn cached;
+  {
+    boost::mutex::scoped_lock lk(cacheMutex);
+    auto it = cache.find(oid);
+
+    if (it != cache.end())
+      cached = it->second;
+  }
+
+  // The controller only sends the filters if they changed since the cached copy
+  std::shared_ptr<ExtentBloomColumn> column(new ExtentBloomColumn());
+  column->generation = cached ? cached->generation : 0;
+  DBRM dbrm;
+
+  if (dbrm.getExtentBlooms(oid, *column) != ERR_OK)
+    return SP_ExtentBloomColumn();
+
+  if (cached && column->generation == cached->generation)
+    return cached;
+
+  boost::mutex::scoped_lock lk(cacheMutex);
+
+  if (column->entries.empty())
+  {
+    cache.erase(oid);
+    return SP_ExtentBloomColumn();
+  }
+
+  if (cache.size() >= maxCachedColumns && cache.count(oid) == 0)
+    cache.erase(cache.begin());
+
+  cache[oid] = column;
+  return column;
+}
+
+int ExtentBloomStore::writePending(OID_t tableOid, uint16_t dbRoot, const vector<ExtentBloomEntry>& entries)
+{
+  ExtentBloomColumn pending;
+
+  for (const ExtentBloomEntry& entry : entries)
+    pending.entries[entry.startLbid] = entry;
+
+  return pending.save(pendingFileName(tableOid, dbRoot));
+}
+
+void ExtentBloomStore::commitPending(OID_t tableOid, uint16_t dbRoot)
+{
+  string pendingName = pendingFileName(tableOid, dbRoot);
+
+  if (!IDBPolicy::exists(pendingName.c_str()))
+    return;
+
+  ExtentBloomColumn pending;
+  pending.load(pendingName);
+
+  map<OID_t, vector<const ExtentBloomEntry*> > byColumn;
+
+  for (const auto& it : pending.entries)
+    byColumn[it.second.oid].push_back(&it.second);
+
+  DBRM dbrm;
+  vector<ExtentBloomEntry> committed;
+
+  for (const auto& column : byColumn)
+  {
+    vector<EMEntry> extents;
+
+    if (dbrm.getExtents(column.first, extents, false, false) != 0)
+      continue;
+
+    unordered_map<LBID_t, const EMEntry*> extentByLbid;
+    map<pair<uint32_t, uint16_t>, HWM_t> segmentHWM;  // only the last extent of a segment file has one
+
+    for (const EMEntry& extent : extents)
+    {
+      extentByLbid[extent.range.start] = &extent;
+      HWM_t& hwm = segmentHWM[make_pair(extent.partitionNum, extent.segmentNum)];
+      hwm = max(hwm, extent.HWM);
+    }
+
+    for (const ExtentBloomEntry* entry : column.second)
+    {
+      auto extentIt = extentByLbid.find(entry->startLbid);
+
+      // gone, or being changed by DML
+      if (extentIt == extentByLbid.end() || extentIt->second->partition.cprange.isValid == CP_UPDATING)
+        continue;
+
+      const EMEntry& extent = *extentIt->second;
+      committed.push_back(*entry);
+      ExtentBloomEntry& stamped = committed.back();
+      stamped.partitionNum = extent.partitionNum;
+      stamped.segmentNum = extent.segmentNum;
+      stamped.lastBlock = extent.blockOffset + extent.range.size * 1024 - 1;
+      stamped.full = segmentHWM[make_pair(extent.partitionNum, extent.segmentNum)] > stamped.lastBlock;
+      stamped.seqNum = extent.partition.cprange.sequenceNum;
+      stamped.cpValid = extent.partition.cprange.isValid == CP_VALID;
+    }
+  }
+
+  if (!committed.empty() && dbrm.setExtentBlooms(committed) != ERR_OK)
+    cerr << "ExtentBloomStore: failed to save the extent bloom filters of table " << tableOid << endl;
+
+  IDBPolicy::remove(pendingName.c_str());
+}
+
+void ExtentBloomStore::discardPending(OID_t tableOid, uint16_t dbRoot)
+{
+  IDBPolicy::remove(pendingFileName(tableOid, dbRoot).c_str());
+}
+
+//------------------------------------------------------------------------------
+// ExtentBlooms
+//------------------------------------------------------------------------------
+const ExtentBloom* ExtentBlooms::find(const EMEntry& extent)
+{
+  if (!fLoaded)
+  {
+    fColumn = ExtentBloomStore::load(fOid);
+    fLoaded = true;
+  }
+
+  if (!fColumn)
+    return NULL;
+
+  auto it = fColumn->entries.find(extent.range.start);
+
+  if (it == fColumn->entries.end() || !it->second.describes(extent))
+    return NULL;
+
+  return &it->second.bloom;
+}
+
+}  // namespace BRM
@@ -0,0 +1,213 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file
+ * Per extent bloom filters, used next to casual partitioning to eliminate
+ * extents for equality and IN predicates whose value falls inside the
+ * extent's min/max range.
+ *
+ * The DBRM controller keeps the filters (see ExtentBloomServer) and serves
+ * them to every node, wherever the column's DBRoots are.  A filter describes
+ * the extent as of the CP sequence number it is stamped with.  DML marks the
+ * CP info of the extents it changes invalid, which moves that number on, so a
+ * filter is only used while the extent's CP info is valid and still carries
+ * that number, or the next one if the filter was stamped while the CP info was
+ * invalid (only a scan setting the min/max gets it there).  Loads into
+ * dictionary columns don't touch the CP info of their tokens, so on top of
+ * that the controller drops the filters of the extents a BRM command deletes
+ * or may add rows to.  DML inserts don't extend the filters, the extents they
+ * change just fall back to min/max elimination until their next load.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "brmtypes.h"
+#include "calpontsystemcatalog.h"
+
+struct charset_info_st;
+
+namespace BRM
+{
+struct EMEntry;
+
+/** @brief A bloom filter over the values of one extent
+ *
+ * The size is always a power of 2, so a filter can be folded in half (OR-ing
+ * the upper half onto the lower one) without losing any value.  cpimport
+ * builds a filter at its maximum size and folds it down as far as the number
+ * of distinct values allows.
+ */
+class ExtentBloom
+{
+ public:
+  static const uint32_t numHashes = 4;
+  static const uint32_t minBits = 512;
+
+  ExtentBloom() = default;
+  explicit ExtentBloom(uint32_t bits);
+
+  /** @brief Can values of this column type be looked up by their bytes
+   *
+   * For a dictionary column the filter is over the strings, not the tokens.
+   */
+  static bool supported(execplan::CalpontSystemCatalog::ColDataType type, int width, bool isDict);
+
+  /** @brief Hash of a fixed width value, in its column file representation */
+  static uint64_t hash(const void* value, uint32_t width);
+
+  /** @brief Hash of a string value, equal for strings the collation finds equal
+   *
+   * Trailing NUL bytes are ignored, so a short string can be hashed at its
+   * column width.
+   */
+  static uint64_t hash(const struct charset_info_st* cs, const void* value, uint32_t length);
+
+  void add(uint64_t hash);
+  bool mayContain(uint64_t hash) const;
+
+  /** @brief Fold the filter while the folded filter has at most maxFill of its bits set */
+  void shrink(double maxFill);
+
+  /** @brief Add the values of another filter, folding the larger of the two to the size of the other */
+  void merge(const ExtentBloom& other);
+
+  double fill() const;
+  uint32_t bits() const
+  {
+    return fWords.size() * 64;
+  }
+  bool empty() const
+  {
+    return fWords.empty();
+  }
+
+  void serialize(messageqcpp::ByteStream& bs) const;
+  void deserialize(messageqcpp::ByteStream& bs);
+
+ private:
+  void fold();
+
+  std::vector<uint64_t> fWords;
+};
+
+/** @brief The filter of one extent */
+struct ExtentBloomEntry : public messageqcpp::Serializeable
+{
+  ExtentBloomEntry()
+   : oid(0), startLbid(0), partitionNum(0), segmentNum(0), lastBlock(0), full(false), seqNum(0), cpValid(false)
+  {
+  }
+
+  OID_t oid;
+  LBID_t startLbid;
+  uint32_t partitionNum;
+  uint16_t segmentNum;
+  uint32_t lastBlock;  // last block of the extent in its segment file
+  bool full;           // were all its blocks below the segment file's HWM
+  int32_t seqNum;      // CP sequence number of the extent contents the filter describes
+  bool cpValid;        // was the extent's CP info valid at seqNum
+  ExtentBloom bloom;   // empty to drop the extent's filter
+
+  /** @brief Does the filter describe the current contents of the extent */
+  bool describes(const EMEntry& extent) const;
+
+  void serialize(messageqcpp::ByteStream& bs) const override;
+  void deserialize(messageqcpp::ByteStream& bs) override;
+};
+
+/** @brief The filters of one column */
+struct ExtentBloomColumn
+{
+  ExtentBloomColumn() : generation(0)
+  {
+  }
+
+  uint64_t generation;                                   // changes with every change to the filters
+  std::unordered_map<LBID_t, ExtentBloomEntry> entries;  // by the first LBID of their extent
+
+  void serialize(messageqcpp::ByteStream& bs) const;
+  void deserialize(messageqcpp::ByteStream& bs);
+
+  /** @brief Read a file written by save(); false if there's none or it can't be read */
+  bool load(const std::string& name);
+
+  /** @brief Write the filters to a file, through a tmp file so readers never see a partial one */
+  int save(const std::string& name) const;
+};
+
+typedef std::shared_ptr<const ExtentBloomColumn> SP_ExtentBloomColumn;
+
+/** @brief Hands the filters cpimport builds over to the controller, and
+ * the controller's filters over to the steps that use them
+ *
+ * Readers go through a per process cache, so the filters of an unchanged
+ * column only cross the network once.
+ */
+class ExtentBloomStore
+{
+ public:
+  /** @brief Name of the file where a load of a table keeps its filters until its BRM updates are in */
+  static std::string pendingFileName(OID_t tableOid, uint16_t dbRoot);
+
+  /** @brief The filters of a column, or null if it has none or the controller can't be reached */
+  static SP_ExtentBloomColumn load(OID_t oid);
+
+  /** @brief Save the filters a load built, for commitPending() to publish
+   *
+   * Only oid, startLbid and bloom of the entries are used, the rest is
+   * filled in from the extent map when they're committed.
+   */
+  static int writePending(OID_t tableOid, uint16_t dbRoot, const std::vector<ExtentBloomEntry>& entries);
+
+  /** @brief Publish the pending filters of a table
+   *
+   * Must be called after the load's BRM updates, while the table lock is still
+   * held.  Each filter is stamped with the current CP sequence number of its
+   * extent and sent to the controller.  Filters of extents that no longer
+   * exist are dropped.
+   */
+  static void commitPending(OID_t tableOid, uint16_t dbRoot);
+
+  /** @brief Drop the pending filters of a table, for a load being rolled back */
+  static void discardPending(OID_t tableOid, uint16_t dbRoot);
+};
+
+/** @brief The filters of the extents of one column, as seen by one query step */
+class ExtentBlooms
+{
+ public:
+  explicit ExtentBlooms(OID_t oid) : fOid(oid), fLoaded(false)
+  {
+  }
+
+  /** @brief The filter of an extent, or null if it has none that describes its current contents */
+  const ExtentBloom* find(const EMEntry& extent);
+
+ private:
+  OID_t fOid;
+  bool fLoaded;
+  SP_ExtentBloomColumn fColumn;
+};
+
+}  // namespace BRM
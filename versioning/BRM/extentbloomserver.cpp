@@ -0,0 +1,365 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <unistd.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <sstream>
+
+#include "configcpp.h"
+#include "IDBPolicy.h"
+#include "logicalpartition.h"
+
+#define BRMEXTENTBLOOMSVR_DLLEXPORT
+#include "extentbloomserver.h"
+#undef BRMEXTENTBLOOMSVR_DLLEXPORT
+
+using namespace std;
+using namespace idbdatafile;
+using namespace messageqcpp;
+
+namespace
+{
+// columns kept in memory
+const size_t maxColumns = 256;
+
+uint64_t newGeneration()
+{
+  uint64_t now = std::chrono::system_clock::now().time_since_epoch().count();
+  return (now ^ ((uint64_t)getpid() << 40)) | 1;
+}
+
+}  // namespace
+
+namespace BRM
+{
+ExtentBloomServer::ExtentBloomServer()
+{
+  boost::mutex::scoped_lock lk(mutex);
+  config::Config* config = config::Config::makeConfig();
+
+  dir = config->getConfig("SystemConfig", "ExtentBloomSaveDir");
+
+  if (dir.empty())
+  {
+    // next to the table locks
+    string tableLocks = config->getConfig("SystemConfig", "TableLockSaveFile");
+    string::size_type slash = tableLocks.rfind('/');
+
+    if (slash == string::npos)
+      throw invalid_argument(
+          "ExtentBloomServer: Need to define SystemConfig/ExtentBloomSaveDir in config file");
+
+    dir = tableLocks.substr(0, slash) + "/extentblooms";
+  }
+
+  if (!IDBPolicy::exists(dir.c_str()))
+    IDBPolicy::mkdir(dir.c_str());
+
+  list<string> files;
+  IDBPolicy::listDirectory(dir.c_str(), files);
+
+  for (const string& file : files)
+  {
+    char* end;
+    unsigned long oid = strtoul(file.c_str(), &end, 10);
+
+    if (end != file.c_str() && strcmp(end, ".blm") == 0)
+      saved.insert(oid);
+  }
+}
+
+ExtentBloomServer::~ExtentBloomServer()
+{
+}
+
+string ExtentBloomServer::fileName(OID_t oid) const
+{
+  ostringstream oss;
+  oss << dir << "/" << oid << ".blm";
+  return oss.str();
+}
+
+// call with lock held
+ExtentBloomServer::SP_Column ExtentBloomServer::column(OID_t oid)
+{
+  auto it = columns.find(oid);
+
+  if (it != columns.end())
+    return it->second;
+
+  if (saved.count(oid) == 0)
+    return SP_Column();
+
+  SP_Column col(new ExtentBloomColumn());
+
+  if (!col->load(fileName(oid)))
+  {
+    IDBPolicy::remove(fileName(oid).c_str());
+    saved.erase(oid);
+    return SP_Column();
+  }
+
+  if (columns.size() >= maxColumns)
+    columns.erase(columns.begin());
+
+  columns[oid] = col;
+  return col;
+}
+
+// call with lock held.  The column is a new copy, readers may still be
+// serializing the one it replaces.
+void ExtentBloomServer::save(OID_t oid, const SP_Column& col)
+{
+  string name = fileName(oid);
+
+  if (col->entries.empty())
+  {
+    IDBPolicy::remove(name.c_str());
+    saved.erase(oid);
+    columns.erase(oid);
+    return;
+  }
+
+  col->generation = newGeneration();
+
+  // if the file can't be written, its filters can't be trusted
+  if (col->save(name) != ERR_OK)
+  {
+    cerr << "ExtentBloomServer: failed to write " << name << endl;
+    IDBPolicy::remove(name.c_str());
+    saved.erase(oid);
+    columns.erase(oid);
+    return;
+  }
+
+  saved.insert(oid);
+
+  if (columns.size() >= maxColumns && columns.count(oid) == 0)
+    columns.erase(columns.begin());
+
+  columns[oid] = col;
+}
+
+void ExtentBloomServer::set(const vector<ExtentBloomEntry>& entries)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  map<OID_t, SP_Column> changed;
+
+  for (const ExtentBloomEntry& entry : entries)
+  {
+    SP_Column& col = changed[entry.oid];
+
+    if (!col)
+    {
+      SP_Column current = column(entry.oid);
+      col.reset(current ? new ExtentBloomColumn(*current) : new ExtentBloomColumn());
+    }
+
+    if (entry.bloom.empty())
+      col->entries.erase(entry.startLbid);
+    else
+      col->entries[entry.startLbid] = entry;
+  }
+
+  for (const auto& it : changed)
+    save(it.first, it.second);
+}
+
+SP_ExtentBloomColumn ExtentBloomServer::get(OID_t oid)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  SP_Column col = column(oid);
+
+  if (!col)
+    return SP_ExtentBloomColumn(new ExtentBloomColumn());
+
+  return col;
+}
+
+void ExtentBloomServer::dropColumn(OID_t oid)
+{
+  if (saved.count(oid) == 0)
+    return;
+
+  IDBPolicy::remove(fileName(oid).c_str());
+  saved.erase(oid);
+  columns.erase(oid);
+}
+
+void ExtentBloomServer::dropPartitions(OID_t oid, const set<uint32_t>& partitions)
+{
+  SP_Column current = column(oid);
+
+  if (!current)
+    return;
+
+  SP_Column col(new ExtentBloomColumn(*current));
+
+  for (auto it = col->entries.begin(); it != col->entries.end();)
+  {
+    if (partitions.count(it->second.partitionNum))
+      it = col->entries.erase(it);
+    else
+      ++it;
+  }
+
+  if (col->entries.size() != current->entries.size())
+    save(oid, col);
+}
+
+// Rows can only have been added to an extent that wasn't full, and a lower HWM
+// makes an extent not full, so only the filters of extents that were full and
+// stay full are kept
+void ExtentBloomServer::dropHWMChange(OID_t oid, uint32_t partitionNum, uint16_t segmentNum, HWM_t hwm)
+{
+  SP_Column current = column(oid);
+
+  if (!current)
+    return;
+
+  SP_Column col(new ExtentBloomColumn(*current));
+
+  for (auto it = col->entries.begin(); it != col->entries.end();)
+  {
+    const ExtentBloomEntry& entry = it->second;
+
+    if (entry.partitionNum == partitionNum && entry.segmentNum == segmentNum &&
+        (!entry.full || hwm <= entry.lastBlock))
+      it = col->entries.erase(it);
+    else
+      ++it;
+  }
+
+  if (col->entries.size() != current->entries.size())
+    save(oid, col);
+}
+
+void ExtentBloomServer::dropAll()
+{
+  for (OID_t oid : saved)
+    IDBPolicy::remove(fileName(oid).c_str());
+
+  saved.clear();
+  columns.clear();
+}
+
+void ExtentBloomServer::brmChanged(const ByteStream& cmdMsg)
+{
+  boost::mutex::scoped_lock lk(mutex);
+
+  if (saved.empty())
+    return;
+
+  ByteStream msg(cmdMsg);
+  uint8_t cmd;
+  uint32_t oid, size, partitionNum, hwm;
+  uint16_t segmentNum, dbRoot;
+
+  try
+  {
+    msg >> cmd;
+
+    switch (cmd)
+    {
+      case DELETE_OID:
+        msg >> oid;
+        dropColumn(oid);
+        break;
+
+      case DELETE_OIDS:
+        msg >> size;
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+          msg >> oid;
+          dropColumn(oid);
+        }
+
+        break;
+
+      case DELETE_PARTITION:
+      {
+        set<LogicalPartition> logicalPartitions;
+        set<uint32_t> partitions;
+        deserializeSet<LogicalPartition>(msg, logicalPartitions);
+
+        for (const LogicalPartition& lp : logicalPartitions)
+          partitions.insert(lp.pp);
+
+        msg >> size;
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+          msg >> oid;
+          dropPartitions(oid, partitions);
+        }
+
+        break;
+      }
+
+      // the rolled back extents aren't known by partition alone
+      case ROLLBACK_COLUMN_EXTENTS_DBROOT:
+        msg >> oid;
+        dropColumn(oid);
+        break;
+
+      case DELETE_EMPTY_COL_EXTENTS:
+        msg >> size;
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+          msg >> oid >> partitionNum >> segmentNum >> dbRoot >> hwm;
+          dropHWMChange(oid, partitionNum, segmentNum, 0);
+        }
+
+        break;
+
+      case SET_LOCAL_HWM:
+        msg >> oid >> partitionNum >> segmentNum >> hwm;
+        dropHWMChange(oid, partitionNum, segmentNum, hwm);
+        break;
+
+      case BULK_SET_HWM:
+      case BULK_SET_HWM_AND_CP:
+      {
+        vector<BulkSetHWMArg> args;
+        deserializeInlineVector(msg, args);
+
+        for (const BulkSetHWMArg& arg : args)
+          dropHWMChange(arg.oid, arg.partNum, arg.segNum, arg.hwm);
+
+        break;
+      }
+
+      case DELETE_DBROOT:
+      case BRM_CLEAR: dropAll(); break;
+
+      default: break;
+    }
+  }
+  catch (exception&)
+  {
+    // can't tell what changes, so nothing can be trusted
+    dropAll();
+  }
+}
+
+}  // namespace BRM
@@ -0,0 +1,82 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file
+ * The DBRM controller's copy of the extent bloom filters.
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+#include "brmtypes.h"
+#include "extentbloom.h"
+
+#define EXPORT
+
+namespace BRM
+{
+/** @brief Keeps the extent bloom filters of all columns, one file per column
+ *
+ * The files are in SystemConfig/ExtentBloomSaveDir.  Columns are read in when
+ * they're first asked for, and only a bounded number of them stay in memory.
+ */
+class ExtentBloomServer
+{
+ public:
+  EXPORT ExtentBloomServer();
+  virtual ~ExtentBloomServer();
+
+  /** @brief Replace the filters of some extents; an entry with an empty filter drops the extent's */
+  EXPORT void set(const std::vector<ExtentBloomEntry>& entries);
+
+  /** @brief The filters of a column; a generation of 0 and no entries if it has none */
+  EXPORT SP_ExtentBloomColumn get(OID_t oid);
+
+  /** @brief Drop the filters a BRM command is about to make stale
+   *
+   * Called with every command the controller distributes to the workers,
+   * before it does, so no filter outlives the extent contents it describes.
+   * Commands that delete extents drop their filters; commands that set a
+   * segment file's HWM drop the filters of its extents that could get rows.
+   */
+  EXPORT void brmChanged(const messageqcpp::ByteStream& msg);
+
+ private:
+  typedef std::shared_ptr<ExtentBloomColumn> SP_Column;
+
+  std::string fileName(OID_t oid) const;
+  SP_Column column(OID_t oid);  // call with lock held
+  void save(OID_t oid, const SP_Column& column);
+  void dropColumn(OID_t oid);
+  void dropPartitions(OID_t oid, const std::set<uint32_t>& partitions);
+  void dropHWMChange(OID_t oid, uint32_t partitionNum, uint16_t segmentNum, HWM_t hwm);
+  void dropAll();
+
+  boost::mutex mutex;
+  std::string dir;
+  std::set<OID_t> saved;               // the columns that have a file
+  std::map<OID_t, SP_Column> columns;  // the ones read in
+};
+
+}  // namespace BRM
+
+#undef EXPORT
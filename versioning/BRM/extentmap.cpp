@@ -65,7 +65,6 @@
 #include "extentmap.h"
 #undef EXTENTMAP_DLLEXPORT
 
-#define EM_MAX_SEQNUM 2000000000
 #define MAX_IO_RETRIES 10
 #define EM_MAGIC_V1 0x76f78b1c
 #define EM_MAGIC_V2 0x76f78b1d
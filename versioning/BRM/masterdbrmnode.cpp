@@ -96,6 +96,7 @@ MasterDBRMNode::MasterDBRMNode()
   halting = false;
 
   tableLockServer.reset(new TableLockServer(&sm));
+  extentBloomServer.reset(new ExtentBloomServer());
   initMsgQueues(config);
   rg = new LBIDResourceGraph();
   //@Bug 2325 DBRMTimeOut is default to 60 seconds
@@ -509,6 +510,14 @@ void MasterDBRMNode::msgProcessor()
       case OWNER_CHECK: doOwnerCheck(msg, p); continue;
     }
 
+    /* Process extent bloom filter calls */
+    switch (cmd)
+    {
+      case SET_EXTENT_BLOOMS: doSetExtentBlooms(msg, p); continue;
+
+      case GET_EXTENT_BLOOMS: doGetExtentBlooms(msg, p); continue;
+    }
+
     /* Process OIDManager calls */
     switch (cmd)
     {
@@ -664,6 +673,10 @@ void MasterDBRMNode::msgProcessor()
       }
     }
 
+    /* Drop the extent bloom filters the command makes stale before the
+       workers apply it, so no query sees the new extent map with an old filter */
+    extentBloomServer->brmChanged(msg);
+
     for (int retry = 0;; retry++)
     {
       try
@@ -2727,6 +2740,78 @@ void MasterDBRMNode::doOwnerCheck(ByteStream& msg, ThreadParams* p)
   }
 }
 
+void MasterDBRMNode::doSetExtentBlooms(ByteStream& msg, ThreadParams* p)
+{
+  uint8_t cmd;
+  vector<ExtentBloomEntry> entries;
+  ByteStream reply;
+
+  try
+  {
+    msg >> cmd;
+    deserializeVector<ExtentBloomEntry>(msg, entries);
+    idbassert(msg.length() == 0);
+    extentBloomServer->set(entries);
+    reply << (uint8_t)ERR_OK;
+    p->sock->write(reply);
+  }
+  catch (exception&)
+  {
+    reply.restart();
+    reply << (uint8_t)ERR_FAILURE;
+
+    try
+    {
+      p->sock->write(reply);
+    }
+    catch (...)
+    {
+    }
+  }
+}
+
+// The filters are only sent if their generation isn't the one the caller has
+void MasterDBRMNode::doGetExtentBlooms(ByteStream& msg, ThreadParams* p)
+{
+  uint8_t cmd;
+  uint32_t oid;
+  uint64_t generation;
+  ByteStream reply;
+
+  try
+  {
+    msg >> cmd >> oid >> generation;
+    idbassert(msg.length() == 0);
+    SP_ExtentBloomColumn column = extentBloomServer->get(oid);
+    reply << (uint8_t)ERR_OK;
+
+    if (column->generation == generation)
+    {
+      reply << (uint8_t)0;
+    }
+    else
+    {
+      reply << (uint8_t)1;
+      column->serialize(reply);
+    }
+
+    p->sock->write(reply);
+  }
+  catch (exception&)
+  {
+    reply.restart();
+    reply << (uint8_t)ERR_FAILURE;
+
+    try
+    {
+      p->sock->write(reply);
+    }
+    catch (...)
+    {
+    }
+  }
+}
+
 void MasterDBRMNode::doStartAISequence(ByteStream& msg, ThreadParams* p)
 {
   uint8_t cmd;
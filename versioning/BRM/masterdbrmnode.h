@@ -38,6 +38,7 @@
 #include "sessionmanagerserver.h"
 #include "oidserver.h"
 #include "tablelockserver.h"
+#include "extentbloomserver.h"
 #include "autoincrementmanager.h"
 
 namespace BRM
@@ -231,6 +232,11 @@ class MasterDBRMNode
   void doGetTableLockInfo(messageqcpp::ByteStream& msg, ThreadParams* p);
   void doOwnerCheck(messageqcpp::ByteStream& msg, ThreadParams* p);
 
+  /* Extent bloom filter interface */
+  boost::scoped_ptr<ExtentBloomServer> extentBloomServer;
+  void doSetExtentBlooms(messageqcpp::ByteStream& msg, ThreadParams* p);
+  void doGetExtentBlooms(messageqcpp::ByteStream& msg, ThreadParams* p);
+
   /* Autoincrement interface */
   AutoincrementManager aiManager;
   void doStartAISequence(messageqcpp::ByteStream& msg, ThreadParams* p);
@@ -153,7 +153,8 @@ void printUsage()
        << "        -n NullOption (0-treat the string NULL as data (default);" << endl
        << "                       1-treat the string NULL as a NULL value)" << endl
        << "        -p Path for XML job description file" << endl
-       << "        -r Number of readers" << endl
+       << "        -r Number of readers; readers beyond one per table" << endl
+       << "           tokenize each read buffer of a table in parallel" << endl
        << "        -s 'c' is the delimiter between column values" << endl
        << "        -w Number of parsers" << endl
        << "        -B I/O library read buffer size (in bytes)" << endl
@@ -25,6 +25,7 @@
 #include "we_bulkload.h"
 #undef WE_BULKLOAD_DLLEXPORT
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <climits>
@@ -147,6 +148,7 @@ BulkLoad::BulkLoad()
  , fMaxErrors(-1)
  , fNoOfParseThreads(3)
  , fNoOfReadThreads(1)
+ , fNoOfTokenizeThreads(1)
  , fKeepRbMetaFiles(false)
  , fNullStringMode(false)
  , fEnclosedByChar('\0')
@@ -471,13 +473,20 @@ void BulkLoad::spawnWorkers()
     cancelThread = boost::thread(cancelationThread);
   }
 
-  // Spawn read threads
-  for (int i = 0; i < fNoOfReadThreads; ++i)
+  // Spawn read threads.  The ones beyond one per table tokenize the read
+  // buffers of the tables instead, see processJob().
+  int noOfReadThreads = std::min(fNoOfReadThreads, std::max((int)fTableInfo.size(), 1));
+
+  for (int i = 0; i < noOfReadThreads; ++i)
   {
     fReadThreads.create_thread(boost::bind(&BulkLoad::read, this, (int)i));
   }
 
-  fLog.logMsg("No of Read Threads Spawned = " + Convertor::int2Str(fNoOfReadThreads), MSGLVL_INFO1);
+  fLog.logMsg("No of Read Threads Spawned = " + Convertor::int2Str(noOfReadThreads), MSGLVL_INFO1);
+
+  if (fNoOfTokenizeThreads > 1)
+    fLog.logMsg("No of Tokenize Threads per Table = " + Convertor::int2Str(fNoOfTokenizeThreads),
+                MSGLVL_INFO1);
 
   // Spawn parse threads
   for (int i = 0; i < fNoOfParseThreads; ++i)
@@ -536,6 +545,7 @@ int BulkLoad::preProcess(Job& job, int tableNo, TableInfo* tableInfo)
   tableInfo->setNullStringMode(fNullStringMode);
   tableInfo->setEnclosedByChar(fEnclosedByChar);
   tableInfo->setEscapeChar(fEscapeChar);
+  tableInfo->setTokenizeThreads(fNoOfTokenizeThreads);
   tableInfo->setImportDataMode(fImportDataMode);
   tableInfo->setTimeZone(fTimeZone);
   tableInfo->setJobUUID(fUUID);
@@ -1099,6 +1109,11 @@ int BulkLoad::processJob()
     }
   }
 
+  // A single input file is read by one thread, so the read threads beyond
+  // one per table split the tokenizing of each read buffer of a table.
+  if (curJob.jobTableList.size() > 0)
+    fNoOfTokenizeThreads = std::max(fNoOfReadThreads / (int)curJob.jobTableList.size(), 1);
+
   //--------------------------------------------------------------------------
   // Perform necessary preprocessing for each table
   //--------------------------------------------------------------------------
@@ -197,6 +197,7 @@ class BulkLoad : public FileOp
   static boost::ptr_vector<TableInfo> fTableInfo;  // Vector of Table information
   int fNoOfParseThreads;                           // Number of parse threads
   int fNoOfReadThreads;                            // Number of read threads
+  int fNoOfTokenizeThreads;                        // Threads tokenizing each read buffer
   boost::thread_group fReadThreads;                // Read thread group
   boost::thread_group fParseThreads;               // Parse thread group
   boost::mutex fReadMutex;                         // Manages table selection by each
@@ -20,6 +20,7 @@
  *
  ********************************************************************/
 
+#include <algorithm>
 #include <sys/time.h>
 #include <sstream>
 #include <string>
@@ -30,11 +31,13 @@
 #include <cmath>
 #include <ctype.h>
 #include <cfloat>
+#include <exception>
 
 #include "we_bulkload.h"
 #include "we_bulkloadbuffer.h"
 #include "we_brm.h"
 #include "we_convertor.h"
+#include "we_csvscanner.h"
 #include "we_log.h"
 #include "brmtypes.h"
 #include "dataconvert.h"
@@ -67,6 +70,9 @@ const char NULL_AUTO_INC_0 = '0';
 const unsigned long long NULL_AUTO_INC_0_BINARY = 0;
 const char NEWLINE_CHAR = '\n';
 
+// Smallest part of a read buffer worth handing to another tokenize thread
+const unsigned MIN_TOKENIZE_RANGE_SIZE = 128 * 1024;
+
 // Enumeration states related to parsing a column value
 enum FieldParsingState
 {
@@ -118,6 +124,7 @@ BulkLoadBuffer::BulkLoadBuffer(unsigned numberOfCols, unsigned bufferSize, Log*
  , fImportDataMode(IMPORT_DATA_TEXT)
  , fTimeZone(dataconvert::systemTimeZoneOffset())
  , fFixedBinaryRecLen(0)
+ , fTokenizeThreads(1)
 {
   // if it's non-parquet case, initialize the fData
   if (fImportDataMode != IMPORT_DATA_PARQUET)
@@ -209,6 +216,17 @@ BulkLoadBuffer::~BulkLoadBuffer()
     delete[] fTokens;
   }
 
+  for (unsigned i = 0; i < fTokenizedRanges.size(); i++)
+  {
+    TokenizedRange& range = fTokenizedRanges[i];
+
+    for (unsigned k = 0; k < range.capacity; k++)
+      delete[] range.tokens[k];
+
+    delete[] range.tokens;
+    range.clear();
+  }
+
   fRowStatus.clear();
   fErrRows.clear();
 }
@@ -1691,9 +1709,13 @@ int BulkLoadBuffer::parseColParquet(ColumnInfo& columnInfo)
       }
     }
 
+    RID firstLastInputRowInExtent = lastInputRowInExtent;
     convertParquet(columnData, buf, columnInfo.column, bufStats, lastInputRowInExtent, columnInfo,
                    updateCPInfoPendingFlag, section);
 
+    if (columnInfo.hasExtentBloom())
+      updateBloom(columnInfo, buf, firstLastInputRowInExtent);
+
     if (updateCPInfoPendingFlag)
     {
       if (columnInfo.column.width <= 8)
@@ -3142,6 +3164,25 @@ inline void BulkLoadBuffer::updateCPMinMax(ColumnInfo& columnInfo, RID& lastInpu
   }
 }
 
+//------------------------------------------------------------------------------
+// Add the fTotalReadRowsParser values parsed into buf to the bloom filters of
+// the extents they belong to.  lastInputRowInExtent is the last input Row of
+// the extent the first value goes to.
+//------------------------------------------------------------------------------
+void BulkLoadBuffer::updateBloom(ColumnInfo& columnInfo, const unsigned char* buf, RID lastInputRowInExtent)
+{
+  uint32_t row = 0;
+
+  while (row < fTotalReadRowsParser)
+  {
+    uint32_t count = std::min<RID>(lastInputRowInExtent - (fStartRowParser + row) + 1,
+                                   fTotalReadRowsParser - row);
+    columnInfo.updateBloom(lastInputRowInExtent, buf + row * columnInfo.column.width, count);
+    row += count;
+    lastInputRowInExtent += columnInfo.rowsPerExtent();
+  }
+}
+
 //------------------------------------------------------------------------------
 // Parse nonDictionary column Read buffer.  Parsed row values are added to
 // fColBufferMgr, which stores them into an output buffer before writing them
@@ -3205,6 +3246,7 @@ int BulkLoadBuffer::parseCol(ColumnInfo& columnInfo)
 
     int tokenLength = 0;
     bool tokenNullFlag = false;
+    RID firstLastInputRowInExtent = lastInputRowInExtent;
 
     for (uint32_t i = 0; i < fTotalReadRowsParser; ++i)
     {
@@ -3323,6 +3365,9 @@ int BulkLoadBuffer::parseCol(ColumnInfo& columnInfo)
       columnInfo.incSaturatedCnt(bufStats.satCount);
     }
 
+    if (columnInfo.hasExtentBloom())
+      updateBloom(columnInfo, buf, firstLastInputRowInExtent);
+
     delete[] field;
     section->write(buf, fTotalReadRowsParser);
     delete[] buf;
@@ -3563,22 +3608,31 @@ int BulkLoadBuffer::parseDictSection(ColumnInfo& columnInfo, int tokenPos, RID s
   {
     char* tokenBuf = new char[nRowsParsed * 8];
 
+    // The section ends at the extent boundary, so all the strings go to the
+    // bloom filter of one extent
+    std::vector<uint64_t> valueHashes;
+    std::vector<uint64_t>* pValueHashes = columnInfo.hasExtentBloom() ? &valueHashes : 0;
+
     if (fImportDataMode != IMPORT_DATA_PARQUET)
     {
       // Pass fDataParser data and fTokensParser meta data to dictionary
       // to be parsed and tokenized, with tokens returned in tokenBuf.
-      rc = columnInfo.updateDctnryStore(fDataParser, &fTokensParser[tokenPos], nRowsParsed, tokenBuf);
+      rc = columnInfo.updateDctnryStore(fDataParser, &fTokensParser[tokenPos], nRowsParsed, tokenBuf,
+                                        pValueHashes);
     }
     else
     {
       // Pass columnData and tokenPos data to dictionary to be parsed and tokenized
       // with tokens returned in tokenBuf.
       std::shared_ptr<arrow::Array> columnData = fParquetBatchParser->column(columnInfo.id);
-      rc = columnInfo.updateDctnryStoreParquet(columnData, tokenPos, nRowsParsed, tokenBuf);
+      rc = columnInfo.updateDctnryStoreParquet(columnData, tokenPos, nRowsParsed, tokenBuf, pValueHashes);
     }
 
     if (rc == NO_ERROR)
     {
+      if (pValueHashes)
+        columnInfo.updateDictBloom(lastInputRowInExtent, valueHashes);
+
 #if 0
             int64_t* tokenVals = reinterpret_cast<int64_t*>(tokenBuf);
 
@@ -3846,6 +3900,191 @@ int BulkLoadBuffer::fillFromFile(const BulkLoadBuffer& overFlowBufIn, FILE* hand
 // given call to tokenize() should exceed the value of "allowedErrCntThisCall",
 // then tokenize() will stop reading data and exit.
 //
+// A large enough buffer is split into ranges of whole records that are parsed
+// by fTokenizeThreads threads at the same time, see tokenizeParallel().
+//------------------------------------------------------------------------------
+void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
+                              unsigned int allowedErrCntThisCall)
+{
+  fTotalReadRows = fTotalReadRowsForLog = 0;
+  fAutoIncGenCount = 0;
+
+  if ((fTokenizeThreads > 1) && (fReadSize >= 2 * MIN_TOKENIZE_RANGE_SIZE))
+  {
+    tokenizeParallel(columnsInfo, allowedErrCntThisCall);
+    return;
+  }
+
+  TokenizedRange range;
+  range.tokens = fTokens;
+  range.capacity = fTotalRows;
+  tokenizeRange(fData, fData + fReadSize, columnsInfo, allowedErrCntThisCall, range);
+  fTokens = range.tokens;
+  fTotalRows = range.capacity;
+  range.tokens = 0;
+
+  addTokenizedRange(range);
+  fOverflowSize = range.overflowSize;
+  fOverflowBuf = range.overflow;
+}
+
+//------------------------------------------------------------------------------
+// Split fData into up to fTokenizeThreads ranges and tokenize them in parallel.
+//
+// Without an "enclosed by" char every newline ends a record, so the split
+// points are simply the first newline after each nominal split point.  With
+// one, the records have to be followed from the start of the buffer to know
+// which newlines are inside an enclosed field; CsvScanner does that, stopping
+// only at the structural characters.
+//
+// Each range but the last ends with a complete record, so only the last one
+// can leave an incomplete record behind for the next buffer.  The ranges are
+// added in order, so the rows, row numbers and rejected rows come out the same
+// as if the buffer had been tokenized in one go.
+//------------------------------------------------------------------------------
+void BulkLoadBuffer::tokenizeParallel(const boost::ptr_vector<ColumnInfo>& columnsInfo,
+                                      unsigned int allowedErrCntThisCall)
+{
+  const CsvScanner scanner(fColDelim, fEnclosedByChar, fEscapeChar);
+  char* const pEndOfData = fData + fReadSize;
+  const unsigned nRanges = std::min(fTokenizeThreads, fReadSize / MIN_TOKENIZE_RANGE_SIZE);
+
+  std::vector<char*> bounds(1, fData);
+
+  for (unsigned i = 1; i < nRanges; i++)
+  {
+    const char* from = std::max<const char*>(fData + (size_t)fReadSize * i / nRanges, bounds.back());
+    char* next = fData + (scanner.findRecordEnd(bounds.back(), from, pEndOfData) - fData);
+
+    if (next == pEndOfData)
+      break;
+
+    bounds.push_back(next);
+  }
+
+  bounds.push_back(pEndOfData);
+
+  // Range 0 is tokenized into fTokens by this thread, the others into their
+  // own token arrays, which are kept for the next buffer.
+  const unsigned nUsed = bounds.size() - 1;
+
+  if (fTokenizedRanges.size() < nUsed)
+    fTokenizedRanges.resize(nUsed);
+
+  fTokenizedRanges[0].tokens = fTokens;
+  fTokenizedRanges[0].capacity = fTotalRows;
+
+  std::vector<std::exception_ptr> errors(nUsed);
+  boost::thread_group threads;
+
+  for (unsigned i = 1; i < nUsed; i++)
+  {
+    threads.create_thread(
+        [&, i]()
+        {
+          try
+          {
+            tokenizeRange(bounds[i], bounds[i + 1], columnsInfo, allowedErrCntThisCall, fTokenizedRanges[i]);
+          }
+          catch (...)
+          {
+            errors[i] = std::current_exception();
+          }
+        });
+  }
+
+  try
+  {
+    tokenizeRange(bounds[0], bounds[1], columnsInfo, allowedErrCntThisCall, fTokenizedRanges[0]);
+  }
+  catch (...)
+  {
+    errors[0] = std::current_exception();
+  }
+
+  threads.join_all();
+  fTokens = fTokenizedRanges[0].tokens;
+  fTotalRows = fTokenizedRanges[0].capacity;
+  fTokenizedRanges[0].tokens = 0;
+  fTokenizedRanges[0].capacity = 0;
+
+  for (unsigned i = 0; i < nUsed; i++)
+  {
+    if (errors[i])
+    {
+      for (unsigned k = 0; k < nUsed; k++)
+        fTokenizedRanges[k].clear();
+
+      std::rethrow_exception(errors[i]);
+    }
+  }
+
+  // Once the error limit is exceeded, the rows after the failing one don't
+  // matter anymore; tokenizeRange() doesn't keep an overflow for them either.
+  unsigned errorCount = 0;
+
+  for (unsigned i = 0; i < nUsed; i++)
+  {
+    TokenizedRange& range = fTokenizedRanges[i];
+    addTokenizedRange(range);
+    errorCount += range.errorCount;
+
+    if ((errorCount > allowedErrCntThisCall) || (i == nUsed - 1))
+    {
+      fOverflowSize = range.overflowSize;
+      fOverflowBuf = range.overflow;
+      range.overflow = 0;
+
+      if (errorCount > allowedErrCntThisCall)
+      {
+        delete[] fOverflowBuf;
+        fOverflowBuf = 0;
+        fOverflowSize = 0;
+      }
+
+      break;
+    }
+  }
+
+  for (unsigned i = 0; i < nUsed; i++)
+    fTokenizedRanges[i].clear();
+}
+
+//------------------------------------------------------------------------------
+// Append the rows of a tokenized range to the ones already in fTokens.  The
+// token rows are swapped, not copied, so each array keeps owning as many rows
+// as it had allocated.
+//------------------------------------------------------------------------------
+void BulkLoadBuffer::addTokenizedRange(TokenizedRange& range)
+{
+  if (range.tokens)
+  {
+    while (fTotalRows < fTotalReadRows + range.validRows)
+      resizeTokenArray();
+
+    for (unsigned i = 0; i < range.validRows; i++)
+      std::swap(fTokens[fTotalReadRows + i], range.tokens[i]);
+  }
+
+  for (unsigned i = 0; i < range.rowStatus.size(); i++)
+  {
+    fRowStatus.push_back(std::pair<RID, std::string>(fStartRowForLogging + fTotalReadRowsForLog +
+                                                         range.rowStatus[i].first,
+                                                     range.rowStatus[i].second));
+  }
+
+  fErrRows.insert(fErrRows.end(), range.errRows.begin(), range.errRows.end());
+  fTotalReadRows += range.validRows;
+  fTotalReadRowsForLog += range.totalRows;
+  fAutoIncGenCount += range.autoIncGenCount;
+}
+
+//------------------------------------------------------------------------------
+// Parse the rows of data in [begin, end) of "fData", saving the meta
+// information that describes the parsed data, in "range".  If the number of
+// read parsing errors should exceed the value of "allowedErrCntThisCall",
+// then tokenizeRange() will stop reading data and exit.
+//
 // We parse the data using the following state machine-like table.
 // Enclosed by character ("), escaped by character (\), and field delimiter
 // (|) can all be overridden; but we show default values in the state table.
@@ -3872,14 +4111,14 @@ int BulkLoadBuffer::fillFromFile(const BulkLoadBuffer& overFlowBufIn, FILE* hand
 // The initial parsing state for each column is LEADING_CHAR or NORMAL,
 // depending on whether the user has enabled the "enclosed by" feature.
 //------------------------------------------------------------------------------
-void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
-                              unsigned int allowedErrCntThisCall)
+void BulkLoadBuffer::tokenizeRange(char* begin, char* end, const boost::ptr_vector<ColumnInfo>& columnsInfo,
+                                   unsigned int allowedErrCntThisCall, TokenizedRange& range)
 {
   unsigned offset = 0;           // length of field
   unsigned curCol = 0;           // dest db column counter within a row
   unsigned curFld = 0;           // src input field counter within a row
   unsigned curRowNum = 0;        // "total" number of rows read during this call
-  unsigned curRowNum1 = 0;       // number of "valid" rows inserted into fTokens
+  unsigned curRowNum1 = 0;       // number of "valid" rows inserted into tokens
   char* p;                       // iterates thru each byte in the input buffer
   char c;                        // value of byte at address "p".
   char* lastRowHead = 0;         // start of latest row being processed
@@ -3921,12 +4160,35 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
   memset(enclosedFieldFlags, 0, sizeof(unsigned) * fNumberOfColumns);
 #endif
 
-  p = lastRowHead = fData;
-  const char* pEndOfData = p + fReadSize;  //@bug3810 set an end-of-data marker
+  p = lastRowHead = begin;
+  const char* pEndOfData = end;  //@bug3810 set an end-of-data marker
+
+  const CsvScanner scanner(FIELD_DELIM_CHAR, STRING_ENCLOSED_CHAR, ESCAPE_CHAR);
+  ColPosPair**& tokens = range.tokens;
+
+  if (!tokens)
+    resizeTokenArray(range.tokens, range.capacity, begin, end - begin);
+
+  // Once we've started keeping the raw data of the row, the runs of bytes
+  // that are skipped over below have to be saved too.
+  auto saveRawData = [&](const char* from, unsigned len)
+  {
+    if ((rawDataRowLength == 0) || (len == 0))
+      return;
+
+    if (rawDataRowLength + len > rawDataRowCapacity)
+    {
+      rawDataRowCapacity = std::max(rawDataRowCapacity * 2, rawDataRowLength + len);
+      resizeRowDataArray(&pRawDataRow, rawDataRowLength, rawDataRowCapacity);
+    }
+
+    memcpy(pRawDataRow + rawDataRowLength, from, len);
+    rawDataRowLength += len;
+  };
 
   //--------------------------------------------------------------------------
   // Loop through all the bytes in the read buffer in order to construct
-  // the meta data stored in fTokens.
+  // the meta data stored in the range's tokens.
   //--------------------------------------------------------------------------
   while (p < pEndOfData)
   {
@@ -3968,8 +4230,11 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
         }
         else
         {
-          offset++;
-          p++;
+          // Skip the rest of the field up to the next delimiter or newline
+          unsigned len = scanner.findFieldEnd(p + 1, pEndOfData) - p;
+          saveRawData(p + 1, len - 1);
+          offset += len;
+          p += len;
           continue;  // process next byte
         }
 
@@ -4072,12 +4337,19 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
 
         else
         {
+          // Move the run of plain bytes up to the next enclosing or escape
+          // char in one go
+          unsigned len = scanner.findEnclosedSpecial(p + 1, pEndOfData) - p;
+          saveRawData(p + 1, len - 1);
+
           if (idxTo != idxFrom)
-            fData[idxTo] = fData[idxFrom];
+            memmove(fData + idxTo, fData + idxFrom, len);
 
-          idxFrom++;
-          idxTo++;
-          offset++;
+          idxFrom += len;
+          idxTo += len;
+          offset += len;
+          p += len;
+          continue;  // process next byte
         }
 
         p++;
@@ -4098,7 +4370,9 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
         }
         else
         {
-          p++;
+          unsigned len = scanner.findFieldEnd(p + 1, pEndOfData) - p;
+          saveRawData(p + 1, len - 1);
+          p += len;
           continue;  // process next byte
         }
 
@@ -4133,8 +4407,8 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
           }
         }
 
-        fTokens[curRowNum1][curCol].start = start;
-        fTokens[curRowNum1][curCol].offset = offset;
+        tokens[curRowNum1][curCol].start = start;
+        tokens[curRowNum1][curCol].offset = offset;
 #ifdef DEBUG_TOKEN_PARSING
         enclosedFieldFlags[curCol] = enclosedFieldFlag;
 #endif
@@ -4145,14 +4419,14 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
         // slows down the read thread by 10%.  So left code here.
         if (offset)
         {
-          switch (fTokens[curRowNum1][curCol].offset)
+          switch (tokens[curRowNum1][curCol].offset)
           {
             // Special auto-increment case; treat '0' as null value
             case 1:
             {
-              if ((jobCol.autoIncFlag) && (*(fData + fTokens[curRowNum1][curCol].start) == NULL_AUTO_INC_0))
+              if ((jobCol.autoIncFlag) && (*(fData + tokens[curRowNum1][curCol].start) == NULL_AUTO_INC_0))
               {
-                fTokens[curRowNum1][curCol].offset = COLPOSPAIR_NULL_TOKEN_OFFSET;
+                tokens[curRowNum1][curCol].offset = COLPOSPAIR_NULL_TOKEN_OFFSET;
                 bRowGenAutoInc = true;
               }
               else if (jobCol.dataType == CalpontSystemCatalog::VARBINARY && (bValidRow))
@@ -4170,10 +4444,10 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
 
             case 2:
             {
-              if ((*(fData + fTokens[curRowNum1][curCol].start) == ESCAPE_CHAR) &&
-                  (*(fData + fTokens[curRowNum1][curCol].start + 1) == NULL_CHAR))
+              if ((*(fData + tokens[curRowNum1][curCol].start) == ESCAPE_CHAR) &&
+                  (*(fData + tokens[curRowNum1][curCol].start + 1) == NULL_CHAR))
               {
-                fTokens[curRowNum1][curCol].offset = COLPOSPAIR_NULL_TOKEN_OFFSET;
+                tokens[curRowNum1][curCol].offset = COLPOSPAIR_NULL_TOKEN_OFFSET;
 
                 if (jobCol.autoIncFlag)
                   bRowGenAutoInc = true;
@@ -4188,12 +4462,12 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
             {
               if ((fNullStringMode) && (!enclosedFieldFlag))
               {
-                if ((*(fData + fTokens[curRowNum1][curCol].start) == NULL_VALUE_STRING[0]) &&
-                    (*(fData + fTokens[curRowNum1][curCol].start + 1) == NULL_VALUE_STRING[1]) &&
-                    (*(fData + fTokens[curRowNum1][curCol].start + 2) == NULL_VALUE_STRING[2]) &&
-                    (*(fData + fTokens[curRowNum1][curCol].start + 3) == NULL_VALUE_STRING[3]))
+                if ((*(fData + tokens[curRowNum1][curCol].start) == NULL_VALUE_STRING[0]) &&
+                    (*(fData + tokens[curRowNum1][curCol].start + 1) == NULL_VALUE_STRING[1]) &&
+                    (*(fData + tokens[curRowNum1][curCol].start + 2) == NULL_VALUE_STRING[2]) &&
+                    (*(fData + tokens[curRowNum1][curCol].start + 3) == NULL_VALUE_STRING[3]))
                 {
-                  fTokens[curRowNum1][curCol].offset = COLPOSPAIR_NULL_TOKEN_OFFSET;
+                  tokens[curRowNum1][curCol].offset = COLPOSPAIR_NULL_TOKEN_OFFSET;
 
                   if (jobCol.autoIncFlag)
                     bRowGenAutoInc = true;
@@ -4217,7 +4491,7 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
 
               // @bug 3478: Truncate instead of rejecting dctnry
               // strings>8000. Only reject numeric cols>1000 bytes
-              else if ((fTokens[curRowNum1][curCol].offset > MAX_FIELD_SIZE) &&
+              else if ((tokens[curRowNum1][curCol].offset > MAX_FIELD_SIZE) &&
                        (jobCol.colType != COL_TYPE_DICT) && (bValidRow))
               {
                 bValidRow = false;
@@ -4235,11 +4509,11 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
           // @bug 4037: When cmd line option set, treat char
           // and varchar fields that are too long as errors
           if (getTruncationAsError() && bValidRow &&
-              (fTokens[curRowNum1][curCol].offset != COLPOSPAIR_NULL_TOKEN_OFFSET))
+              (tokens[curRowNum1][curCol].offset != COLPOSPAIR_NULL_TOKEN_OFFSET))
           {
             if ((jobCol.dataType == CalpontSystemCatalog::VARCHAR ||
                  jobCol.dataType == CalpontSystemCatalog::CHAR) &&
-                (fTokens[curRowNum1][curCol].offset > jobCol.definedWidth))
+                (tokens[curRowNum1][curCol].offset > jobCol.definedWidth))
             {
               bValidRow = false;
 
@@ -4253,7 +4527,7 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
         }  // end of "if (offset)"
         else
         {
-          fTokens[curRowNum1][curCol].offset = COLPOSPAIR_NULL_TOKEN_OFFSET;
+          tokens[curRowNum1][curCol].offset = COLPOSPAIR_NULL_TOKEN_OFFSET;
 
           if (jobCol.autoIncFlag)
             bRowGenAutoInc = true;
@@ -4263,7 +4537,7 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
         // Validate a NotNull column is supplied a value or a default
         if (!bRowGenAutoInc)
         {
-          if ((jobCol.fNotNull) && (fTokens[curRowNum1][curCol].offset == COLPOSPAIR_NULL_TOKEN_OFFSET) &&
+          if ((jobCol.fNotNull) && (tokens[curRowNum1][curCol].offset == COLPOSPAIR_NULL_TOKEN_OFFSET) &&
               (!jobCol.fWithDefault) && (bValidRow))
           {
             bValidRow = false;
@@ -4287,7 +4561,7 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
     {
       // Debug: Dump next row that may or may not be accepted as
       // valid.  Not a typo, that we print "curRowNum" as the row
-      // number, but we use curRowNum1 as the index into fTokens.
+      // number, but we use curRowNum1 as the index into tokens.
 #ifdef DEBUG_TOKEN_PARSING
       std::cout << "Row " << curRowNum + 1 << ". fTokens: "
                 << "(start,offset,enclosed)" << std::endl;
@@ -4298,12 +4572,12 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
 
       for (unsigned int k = 0; k < kColCount; k++)
       {
-        std::cout << "  (" << fTokens[curRowNum1][k].start << "," << fTokens[curRowNum1][k].offset << ","
+        std::cout << "  (" << tokens[curRowNum1][k].start << "," << tokens[curRowNum1][k].offset << ","
                   << enclosedFieldFlags[k] << ") ";
 
-        if (fTokens[curRowNum1][k].offset != COLPOSPAIR_NULL_TOKEN_OFFSET)
+        if (tokens[curRowNum1][k].offset != COLPOSPAIR_NULL_TOKEN_OFFSET)
         {
-          std::string outField(fData + fTokens[curRowNum1][k].start, fTokens[curRowNum1][k].offset);
+          std::string outField(fData + tokens[curRowNum1][k].start, tokens[curRowNum1][k].offset);
           std::cout << "  " << outField << std::endl;
         }
         else
@@ -4337,13 +4611,13 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
 
       if (bValidRow)
       {
-        // Initialize fTokens for <DefaultColumn> tags not in input file
+        // Initialize tokens for <DefaultColumn> tags not in input file
         if (fNumColsInFile < fNumberOfColumns)
         {
           for (unsigned int n = fNumColsInFile; n < fNumberOfColumns; n++)
           {
-            fTokens[curRowNum1][n].start = 0;
-            fTokens[curRowNum1][n].offset = COLPOSPAIR_NULL_TOKEN_OFFSET;
+            tokens[curRowNum1][n].start = 0;
+            tokens[curRowNum1][n].offset = COLPOSPAIR_NULL_TOKEN_OFFSET;
 
             if (columnsInfo[n].column.autoIncFlag)
               bRowGenAutoInc = true;
@@ -4353,7 +4627,7 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
         curRowNum1++;  // increment valid row count
 
         if (bRowGenAutoInc)
-          fAutoIncGenCount++;  // update number of generated auto-incs
+          range.autoIncGenCount++;  // update number of generated auto-incs
       }
       else
       {
@@ -4361,21 +4635,21 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
         if (rawDataRowLength == 0)
         {
           string tmp(lastRowHead, rowLength);
-          fErrRows.push_back(tmp);
+          range.errRows.push_back(tmp);
         }
         else
         {
           string tmp(pRawDataRow, rawDataRowLength);
-          fErrRows.push_back(tmp);
+          range.errRows.push_back(tmp);
         }
 
-        fRowStatus.push_back(std::pair<RID, std::string>(fStartRowForLogging + curRowNum, validationErrMsg));
+        range.rowStatus.push_back(std::pair<RID, std::string>(curRowNum, validationErrMsg));
 
         errorCount++;
 
         // Quit if we exceed max allowable errors for this call.
         // We set lastRowHead = p, so that the code that follows this
-        // loop won't try to save any data in fOverflowBuf.
+        // loop won't try to save any data in the overflow.
         if (errorCount > allowedErrCntThisCall)
         {
           lastRowHead = p + 1;
@@ -4389,10 +4663,10 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
       lastRowHead = p + 1;
       rawDataRowLength = 0;
 
-      // Resize fTokens array if we are about to fill it up
-      if (curRowNum1 >= fTotalRows)
+      // Resize tokens array if we are about to fill it up
+      if (curRowNum1 >= range.capacity)
       {
-        resizeTokenArray();
+        resizeTokenArray(range.tokens, range.capacity, begin, end - begin);
       }
 
       bNewLine = false;
@@ -4413,26 +4687,22 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
     p++;
   }  // end of (p < pEndOfData) loop to step thru the read buffer
 
-  // Save any leftover data that we did not yet parse, into fOverflowBuf
+  // Save any leftover data that we did not yet parse, into the overflow
   if (p > lastRowHead)
   {
-    fOverflowSize = p - lastRowHead;
-    fOverflowBuf = new char[fOverflowSize];
+    range.overflowSize = p - lastRowHead;
+    range.overflow = new char[range.overflowSize];
 
     // If we stripped out any chars, be sure to preserve the original data
     if (rawDataRowLength == 0)
-      memcpy(fOverflowBuf, lastRowHead, fOverflowSize);
+      memcpy(range.overflow, lastRowHead, range.overflowSize);
     else
-      memcpy(fOverflowBuf, pRawDataRow, fOverflowSize);
-  }
-  else
-  {
-    fOverflowSize = 0;
-    fOverflowBuf = NULL;
+      memcpy(range.overflow, pRawDataRow, range.overflowSize);
   }
 
-  fTotalReadRows = curRowNum1;       // number of valid rows read
-  fTotalReadRowsForLog = curRowNum;  // total number of rows read
+  range.validRows = curRowNum1;  // number of valid rows read
+  range.totalRows = curRowNum;   // total number of rows read
+  range.errorCount = errorCount;
 
   if (pRawDataRow)
     delete[] pRawDataRow;
@@ -4443,41 +4713,55 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
 // Used for initial allocation as well.
 //------------------------------------------------------------------------------
 void BulkLoadBuffer::resizeTokenArray()
+{
+  resizeTokenArray(fTokens, fTotalRows, fData, fBufferSize - fOverflowSize);
+}
+
+//------------------------------------------------------------------------------
+// Resize a token array holding "capacity" rows.  For the initial allocation,
+// the number of rows is estimated from the length of the first record found
+// in the "dataSize" bytes at "data".
+//------------------------------------------------------------------------------
+void BulkLoadBuffer::resizeTokenArray(ColPosPair**& tokens, unsigned& capacity, const char* data,
+                                      unsigned dataSize)
 {
   unsigned tmpTotalRows = 0;
 
-  if (!fTokens)
+  if (!tokens)
   {
-    tmpTotalRows = fBufferSize / 100;
+    tmpTotalRows = dataSize / 100;
 
     // Estimate the number of rows we can store in
     // one buffer by getting length of first record
-    for (unsigned int k = 0; k < (fBufferSize - fOverflowSize); k++)
+    for (unsigned int k = 0; k < dataSize; k++)
     {
-      if (fData[k] == NEWLINE_CHAR)
+      if (data[k] == NEWLINE_CHAR)
       {
-        tmpTotalRows = fBufferSize / (k + 1);
+        tmpTotalRows = dataSize / (k + 1);
         break;
       }
     }
+
+    if (tmpTotalRows == 0)
+      tmpTotalRows = 1;
   }
   else
   {
-    tmpTotalRows = (unsigned int)(fTotalRows * 1.25);
+    tmpTotalRows = (unsigned int)(capacity * 1.25);
 
     // @bug 3478: Make sure token array is expanded.
-    // If rows are loooong, then fTotalRows may be small (< 4), in which
+    // If rows are loooong, then capacity may be small (< 4), in which
     // a 1.25 factor won't increase the row count.  So this check is here
     // to make sure we increase the row count in this case.
-    if (tmpTotalRows <= fTotalRows)
-      tmpTotalRows = fTotalRows * 2;
+    if (tmpTotalRows <= capacity)
+      tmpTotalRows = capacity * 2;
   }
 
   if (fLog->isDebug(DEBUG_1))
   {
     std::string allocLabel("Re-Allocating");
 
-    if (!fTokens)
+    if (!tokens)
       allocLabel = "Allocating";
 
     ostringstream oss;
@@ -4490,19 +4774,19 @@ void BulkLoadBuffer::resizeTokenArray()
   ColPosPair** tmp;
   tmp = new ColPosPair*[tmpTotalRows];
 
-  if (fTokens)
+  if (tokens)
   {
-    memcpy(tmp, fTokens, sizeof(ColPosPair*) * fTotalRows);
-    delete[] fTokens;
+    memcpy(tmp, tokens, sizeof(ColPosPair*) * capacity);
+    delete[] tokens;
   }
 
-  fTokens = tmp;
+  tokens = tmp;
 
   // Allocate a ColPosPair array for each new row
-  for (unsigned i = fTotalRows; i < tmpTotalRows; ++i)
-    fTokens[i] = new ColPosPair[fNumberOfColumns];
+  for (unsigned i = capacity; i < tmpTotalRows; ++i)
+    tokens[i] = new ColPosPair[fNumberOfColumns];
 
-  fTotalRows = tmpTotalRows;
+  capacity = tmpTotalRows;
 }
 
 //@bug 5027: Add tokenizeBinary() and isBinaryFieldNull() for binary imports
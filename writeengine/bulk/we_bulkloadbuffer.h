@@ -159,6 +159,42 @@ class BulkLoadBuffer
                                     // to use for TIMESTAMP data type. For example,
                                     // for EST which is UTC-5:00, offset will be -18000s.
   unsigned int fFixedBinaryRecLen;  // Fixed rec len used in binary mode
+  unsigned fTokenizeThreads;        // Threads tokenizing a text buffer
+
+  // What tokenizeRange() found in one range of fData
+  struct TokenizedRange
+  {
+    TokenizedRange()
+     : tokens(0), capacity(0), validRows(0), totalRows(0), autoIncGenCount(0), errorCount(0), overflow(0)
+     , overflowSize(0)
+    {
+    }
+
+    // Reset everything but the token array, which is reused
+    void clear()
+    {
+      validRows = totalRows = autoIncGenCount = errorCount = 0;
+      rowStatus.clear();
+      errRows.clear();
+      delete[] overflow;
+      overflow = 0;
+      overflowSize = 0;
+    }
+
+    ColPosPair** tokens;  // Start and offsets of the valid rows
+    unsigned capacity;    // Number of rows allocated in tokens
+    uint32_t validRows;
+    uint32_t totalRows;  // Including rejected rows
+    uint32_t autoIncGenCount;
+    unsigned errorCount;
+    std::vector<std::pair<RID, std::string> > rowStatus;  // Row numbers are relative to the range
+    std::vector<std::string> errRows;
+    char* overflow;  // Incomplete last record
+    unsigned overflowSize;
+  };
+
+  // Ranges of a buffer tokenized by other threads, see tokenizeParallel()
+  std::vector<TokenizedRange> fTokenizedRanges;
 
   //--------------------------------------------------------------------------
   // Private Functions
@@ -198,6 +234,11 @@ class BulkLoadBuffer
    */
   int parseCol(ColumnInfo& columnInfo);
 
+  /** @brief Add the values parsed into buf to the bloom filters of their extents
+   *  @param lastInputRowInExtent Last input Row of the extent of the 1st value
+   */
+  void updateBloom(ColumnInfo& columnInfo, const unsigned char* buf, RID lastInputRowInExtent);
+
   /** @brief Parse a Read buffer for a nonDictionary column
    */
   void parseColLogMinMax(std::ostringstream& oss, ColDataType colDataType, int64_t minBufferVal,
@@ -226,10 +267,28 @@ class BulkLoadBuffer
    */
   void resizeTokenArray();
 
+  /** @brief Expand the size of a token array of "capacity" rows
+   */
+  void resizeTokenArray(ColPosPair**& tokens, unsigned& capacity, const char* data, unsigned dataSize);
+
   /** @brief tokenize the buffer contents and fill up the token array.
    */
   void tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo, unsigned int allowedErrCntThisCall);
 
+  /** @brief tokenize the buffer contents with fTokenizeThreads threads.
+   */
+  void tokenizeParallel(const boost::ptr_vector<ColumnInfo>& columnsInfo,
+                        unsigned int allowedErrCntThisCall);
+
+  /** @brief tokenize the records in [begin, end) of fData.
+   */
+  void tokenizeRange(char* begin, char* end, const boost::ptr_vector<ColumnInfo>& columnsInfo,
+                     unsigned int allowedErrCntThisCall, TokenizedRange& range);
+
+  /** @brief Append the rows of a tokenized range to fTokens and the error lists
+   */
+  void addTokenizedRange(TokenizedRange& range);
+
   /** @brief Binary tokenization of the buffer, and fill up the token array.
    */
   int tokenizeBinary(const boost::ptr_vector<ColumnInfo>& columnsInfo, unsigned int allowedErrCntThisCall,
@@ -404,6 +463,13 @@ class BulkLoadBuffer
     return fbTruncationAsError;
   }
 
+  /** @brief Set the number of threads that tokenize a text buffer
+   */
+  void setTokenizeThreads(unsigned tokenizeThreads)
+  {
+    fTokenizeThreads = tokenizeThreads;
+  }
+
   /** @brief Set text vs binary import mode along with corresponding fixed
    *         record length that is used if the binary mode is set to TRUE.
    */
@@ -27,6 +27,7 @@
 
 #include "we_colbufcompressed.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <cstring>
@@ -46,6 +47,7 @@
 using namespace idbdatafile;
 
 #include "idbcompress.h"
+#include "columnencoding.h"
 using namespace compress;
 
 namespace WriteEngine
@@ -62,6 +64,7 @@ ColumnBufferCompressed::ColumnBufferCompressed(ColumnInfo* pColInfo, Log* logger
  , fFlushedStartHwmChunk(false)
 {
   fUserPaddingBytes = Config::getNumCompressedPadBlks() * BYTE_PER_BLOCK;
+  fEncodeValues = Config::getColumnEncoding();
   compress::initializeCompressorPool(fCompressorPool, fUserPaddingBytes);
 }
 
@@ -92,6 +95,10 @@ int ColumnBufferCompressed::setDbFile(IDBDataFile* f, HWM startHwm, const char*
     return ERR_COMP_PARSE_HDRS;
   }
 
+  size_t dictLen = 0;
+  const char* dict = compress::CompressInterface::getDictionary(hdrs, dictLen);
+  fDictionary.assign(dict ? dict : "", dictLen);
+
   // If we have any orphaned chunk pointers (ex: left over after a DML
   // rollback), that fall after the HWM, then drop those trailing ptrs.
   unsigned int chunkIndex = 0;
@@ -372,8 +379,21 @@ int ColumnBufferCompressed::compressAndFlush(bool bFinishingFile)
   Stats::startParseEvent(WE_STATS_COMPRESS_COL_COMPRESS);
 #endif
 
-  int rc = compressor->compressBlock(reinterpret_cast<char*>(fToBeCompressedBuffer), fToBeCompressedCapacity,
-                                     compressedOutBuf, outputLen);
+  // The first chunk of a file trains the dictionary. There are no chunks yet
+  // that could depend on an earlier one, so it is safe to (re)place it here.
+  if (fChunkPtrs.empty() && fDictionary.empty() && compressor->supportsDictionary())
+    trainDictionary(*compressor);
+
+  int rc;
+
+  if (fEncodeValues &&
+      compress::ColumnEncoding::isEncodable(fColInfo->column.dataType, fColInfo->column.width))
+    rc = compressor->compressEncodedBlock(reinterpret_cast<char*>(fToBeCompressedBuffer),
+                                          fToBeCompressedCapacity, fColInfo->column.width, compressedOutBuf,
+                                          outputLen, fDictionary.data(), fDictionary.size());
+  else
+    rc = compressor->compressBlock(reinterpret_cast<char*>(fToBeCompressedBuffer), fToBeCompressedCapacity,
+                                   compressedOutBuf, outputLen, fDictionary.data(), fDictionary.size());
 
   if (rc != 0)
   {
@@ -546,6 +566,38 @@ int ColumnBufferCompressed::finishFile(bool bTruncFile)
   return NO_ERROR;
 }
 
+//------------------------------------------------------------------------------
+// Train the compression dictionary of the current db file on the data waiting
+// to be compressed, cut into fixed size samples.  If there is too little data
+// or the training fails, the file is compressed without a dictionary.
+//------------------------------------------------------------------------------
+void ColumnBufferCompressed::trainDictionary(const compress::CompressInterface& compressor)
+{
+  const size_t SAMPLE_LEN = 8 * BYTE_PER_BLOCK;
+  const size_t MAX_TRAINING_LEN = 1024 * 1024;
+  const size_t MIN_SAMPLES = 16;
+
+  const size_t nSamples = std::min<size_t>(fNumBytes, MAX_TRAINING_LEN) / SAMPLE_LEN;
+
+  if (nSamples < MIN_SAMPLES)
+    return;
+
+  std::vector<size_t> sampleSizes(nSamples, SAMPLE_LEN);
+  fDictionary.resize(CompressInterface::MAX_DICTIONARY_LEN);
+  size_t dictLen = compressor.trainDictionary(reinterpret_cast<char*>(fToBeCompressedBuffer), &sampleSizes[0],
+                                              nSamples, &fDictionary[0], fDictionary.size());
+  fDictionary.resize(dictLen);
+
+  if (fLog->isDebug(DEBUG_2))
+  {
+    std::ostringstream oss;
+    oss << "Trained compression dictionary for: OID-" << fColInfo->curCol.dataFile.fid << "; DBRoot-"
+        << fColInfo->curCol.dataFile.fDbRoot << "; part-" << fColInfo->curCol.dataFile.fPartition << "; seg-"
+        << fColInfo->curCol.dataFile.fSegment << "; samples-" << nSamples << "; bytes-" << dictLen;
+    fLog->logMsg(oss.str(), MSGLVL_INFO2);
+  }
+}
+
 //------------------------------------------------------------------------------
 // Write out the updated compression headers.
 //------------------------------------------------------------------------------
@@ -559,6 +611,7 @@ int ColumnBufferCompressed::saveCompressionHeaders()
   compress::CompressInterface::initHdr(hdrBuf, fColInfo->column.width, fColInfo->column.dataType,
                                        fColInfo->column.compressionType);
   compress::CompressInterface::setBlockCount(hdrBuf, (fColInfo->getFileSize() / BYTE_PER_BLOCK));
+  compress::CompressInterface::setDictionary(hdrBuf, fDictionary.data(), fDictionary.size());
   // If lbid written in the header is not 0 and not equal to `lastupdatedlbid` - we are running
   // for the next extent for column segment file.
   const auto lastUpdatedLbid = fColInfo->getLastUpdatedLBID();
@@ -685,7 +738,8 @@ int ColumnBufferCompressed::initToBeCompressedBuffer(long long& startFileOffset)
     // Uncompress the chunk into our 4MB buffer
     size_t outLen = CompressInterface::UNCOMPRESSED_INBUF_LEN;
     int rc = compressor->uncompressBlock(compressedOutBuf, fChunkPtrs[chunkIndex].second,
-                                         fToBeCompressedBuffer, outLen);
+                                         fToBeCompressedBuffer, outLen, fDictionary.data(),
+                                         fDictionary.size());
 
     if (rc)
     {
@@ -29,6 +29,7 @@
 #include "we_colbuf.h"
 
 #include <cstdio>
+#include <string>
 #include <vector>
 
 #include "idbcompress.h"
@@ -96,6 +97,8 @@ class ColumnBufferCompressed : public ColumnBuffer
   int initToBeCompressedBuffer(long long& startFileOffset);
   // Initialize the to-be-compressed buffer
   int saveCompressionHeaders();  // Saves compression headers to the db file
+  // Trains the file's dictionary on the to-be-compressed buffer
+  void trainDictionary(const compress::CompressInterface& compressor);
 
   unsigned char* fToBeCompressedBuffer;  // data waiting to be compressed
   size_t fToBeCompressedCapacity;        // size of comp buffer;
@@ -108,6 +111,10 @@ class ColumnBufferCompressed : public ColumnBuffer
   unsigned int fUserPaddingBytes;            // compressed chunk padding
   bool fFlushedStartHwmChunk;                // have we rewritten the hdr
                                              //   for the starting HWM chunk
+  std::string fDictionary;                   // compression dictionary of the
+                                             //   current db file, if any
+  bool fEncodeValues;                        // store integer chunks with a
+                                             //   ColumnEncoding if it pays
 };
 
 }  // namespace WriteEngine
@@ -28,6 +28,7 @@
 #include "we_colextinf.h"
 #include "dataconvert.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -41,6 +42,11 @@ namespace
 {
 typedef std::tr1::unordered_map<WriteEngine::RID, WriteEngine::ColExtInfEntry, WriteEngine::uint64Hasher>
     RowExtMap;
+
+// A bloom filter is folded while at most this fraction of its bits stays set,
+// and not saved at all if more than maxBloomFill of its bits end up set.
+const double bloomShrinkFill = 0.4;
+const double maxBloomFill = 0.5;
 }
 
 namespace WriteEngine
@@ -195,6 +201,17 @@ void ColExtInf::getCPInfoForBRM(JobColumn column, BRMReporter& brmReporter)
 
   RowExtMap::const_iterator iter = fMap.begin();
 
+  // Token columns keep no min/max, only the filters of their strings
+  if (!fTrackCP)
+  {
+    for (; iter != fMap.end(); ++iter)
+      saveBloom(iter->first, iter->second.fLbid);
+
+    fMap.clear();
+    fBlooms.clear();
+    return;
+  }
+
   while (iter != fMap.end())
   {
     // If/when we support NULL values, we could have an extent with initial
@@ -280,12 +297,115 @@ void ColExtInf::getCPInfoForBRM(JobColumn column, BRMReporter& brmReporter)
       cpInfoMerge.newExtent = iter->second.fNewExtent;
       cpInfoMerge.colWidth = column.width;
       brmReporter.addToCPInfo(cpInfoMerge);
+      saveBloom(iter->first, iter->second.fLbid);
     }
 
     ++iter;
   }
 
   fMap.clear();  // don't need map anymore, so release memory
+  fBlooms.clear();
+}
+
+//------------------------------------------------------------------------------
+// Keep the bloom filter of an extent for getBloomInfo(), if it has one and the
+// filter is selective enough to be worth saving.  Call with fMapMutex held.
+//------------------------------------------------------------------------------
+void ColExtInf::saveBloom(RID lastInputRow, BRM::LBID_t lbid)
+{
+  std::map<RID, std::shared_ptr<BRM::ExtentBloom> >::iterator bloomIter = fBlooms.find(lastInputRow);
+
+  if ((bloomIter == fBlooms.end()) || !bloomIter->second || (lbid == (BRM::LBID_t)INVALID_LBID))
+    return;
+
+  bloomIter->second->shrink(bloomShrinkFill);
+
+  if (bloomIter->second->fill() <= maxBloomFill)
+  {
+    BRM::ExtentBloomEntry bloomEntry;
+    bloomEntry.oid = fColOid;
+    bloomEntry.startLbid = lbid;
+    bloomEntry.bloom = *bloomIter->second;
+    fBloomEntries.push_back(bloomEntry);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Start the bloom filter of the pre-existing extent that we start loading data
+// into.  The rows already in the extent must be in the filter too, so we start
+// from the extent's current filter; without one the extent gets no filter.
+//------------------------------------------------------------------------------
+void ColExtInf::addFirstBloom(RID lastInputRow, const BRM::ExtentBloom* bloom)
+{
+  boost::mutex::scoped_lock lock(fMapMutex);
+
+  std::shared_ptr<BRM::ExtentBloom> extentBloom;
+
+  if (bloom)
+  {
+    extentBloom.reset(new BRM::ExtentBloom(fBloomBits));
+    extentBloom->merge(*bloom);
+  }
+
+  fBlooms[lastInputRow] = extentBloom;
+}
+
+//------------------------------------------------------------------------------
+// Add the hashes of the values parsed for an extent to its bloom filter.
+//------------------------------------------------------------------------------
+void ColExtInf::addToBloom(RID lastInputRow, const std::vector<uint64_t>& hashes)
+{
+  boost::mutex::scoped_lock lock(fMapMutex);
+
+  std::map<RID, std::shared_ptr<BRM::ExtentBloom> >::iterator iter = fBlooms.find(lastInputRow);
+
+  // Nothing else adds the extents of a token column, and they still need
+  // their LBID from updateEntryLbid()
+  if (!fTrackCP && (fMap.find(lastInputRow) == fMap.end()))
+  {
+    fMap[lastInputRow] = ColExtInfEntry();
+    fPendingExtentRows.insert(lastInputRow);
+  }
+
+  if (iter == fBlooms.end())
+  {
+    iter = fBlooms.insert(std::make_pair(lastInputRow, std::make_shared<BRM::ExtentBloom>(fBloomBits))).first;
+
+    // Only the last 2 extents can still get rows from the Read buffers being
+    // parsed, so the filters of the ones before them are shrunk right away,
+    // instead of keeping a full size filter for every extent till EOJ.
+    if (fBlooms.size() > 2)
+    {
+      RID keepFrom = (++fBlooms.rbegin())->first;
+
+      for (std::map<RID, std::shared_ptr<BRM::ExtentBloom> >::iterator it =
+               fBlooms.lower_bound(fBloomsShrunkBelow);
+           (it != fBlooms.end()) && (it->first < keepFrom); ++it)
+      {
+        if (it->second)
+          it->second->shrink(bloomShrinkFill);
+      }
+
+      fBloomsShrunkBelow = std::max(fBloomsShrunkBelow, keepFrom);
+    }
+  }
+
+  if (!iter->second)
+    return;
+
+  for (uint64_t hash : hashes)
+    iter->second->add(hash);
+}
+
+//------------------------------------------------------------------------------
+// Get the bloom filters of the extents whose CP info getCPInfoForBRM() saved.
+//------------------------------------------------------------------------------
+void ColExtInf::getBloomInfo(std::vector<BRM::ExtentBloomEntry>& entries)
+{
+  boost::mutex::scoped_lock lock(fMapMutex);
+
+  entries.insert(entries.end(), fBloomEntries.begin(), fBloomEntries.end());
+  fBloomEntries.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -29,11 +29,15 @@
 
 #include <limits>
 #include <stdint.h>
+#include <map>
+#include <memory>
 #include <set>
+#include <vector>
 #include <tr1/unordered_map>
 #include <boost/thread/mutex.hpp>
 
 #include "brmtypes.h"
+#include "extentbloom.h"
 #include "we_type.h"
 #include "dataconvert.h"
 
@@ -167,6 +171,19 @@ class ColExtInfBase
   {
     return NO_ERROR;
   }
+  virtual bool hasBloom() const
+  {
+    return false;
+  }
+  virtual void addFirstBloom(RID lastInputRow, const BRM::ExtentBloom* bloom)
+  {
+  }
+  virtual void addToBloom(RID lastInputRow, const std::vector<uint64_t>& hashes)
+  {
+  }
+  virtual void getBloomInfo(std::vector<BRM::ExtentBloomEntry>& entries)
+  {
+  }
 };
 
 //------------------------------------------------------------------------------
@@ -188,8 +205,12 @@ class ColExtInf : public ColExtInfBase
  public:
   /** @brief Constructor
    *  @param logger Log object using for debug logging.
+   *  @param bloomBits Size of the bloom filter built per extent; 0 for none
+   *  @param trackCP   Send min/max to BRM; false for dictionary token columns,
+   *                   which only get bloom filters (of their strings)
    */
-  ColExtInf(OID oid, Log* logger) : fColOid(oid), fLog(logger)
+  ColExtInf(OID oid, Log* logger, uint32_t bloomBits = 0, bool trackCP = true)
+   : fColOid(oid), fLog(logger), fBloomBits(bloomBits), fTrackCP(trackCP), fBloomsShrunkBelow(0)
   {
   }
   virtual ~ColExtInf()
@@ -239,7 +260,35 @@ class ColExtInf : public ColExtInfBase
    */
   virtual int updateEntryLbid(BRM::LBID_t startLbid);
 
+  /** @brief Are bloom filters built for the extents of this column
+   */
+  virtual bool hasBloom() const
+  {
+    return fBloomBits != 0;
+  }
+
+  /** @brief Start the bloom filter of the pre-existing extent we add rows to.
+   *  @param lastInputRow Last input Row for old extent we are adding data to
+   *  @param bloom        Filter of the rows already in the extent; NULL if
+   *                      they are not all covered by a current filter, in
+   *                      which case no filter is built for the extent.
+   */
+  virtual void addFirstBloom(RID lastInputRow, const BRM::ExtentBloom* bloom);
+
+  /** @brief Add the hashes of some parsed values to an extent's bloom filter.
+   *  @param lastInputRow Last input Row of the extent the values belong to
+   *  @param hashes       ExtentBloom::hash() of each value
+   */
+  virtual void addToBloom(RID lastInputRow, const std::vector<uint64_t>& hashes);
+
+  /** @brief Get the bloom filters saved by getCPInfoForBRM(), for the extents
+   *  whose CP info was sent to BRM.
+   */
+  virtual void getBloomInfo(std::vector<BRM::ExtentBloomEntry>& entries);
+
  private:
+  void saveBloom(RID lastInputRow, BRM::LBID_t lbid);
+
   OID fColOid;                       // Column OID for the relevant extents
   Log* fLog;                         // Log used for debug logging
   boost::mutex fMapMutex;            // protects unordered map access
@@ -249,6 +298,13 @@ class ColExtInf : public ColExtInfBase
   // unordered map where we collect the min/max values per extent
   std::tr1::unordered_map<RID, ColExtInfEntry, uint64Hasher> fMap;
 
+  // bloom filter per extent, keyed like fMap; NULL if the extent gets none
+  uint32_t fBloomBits;
+  bool fTrackCP;  // min/max sent to BRM
+  std::map<RID, std::shared_ptr<BRM::ExtentBloom> > fBlooms;
+  RID fBloomsShrunkBelow;  // filters of extents before this row are shrunk
+  std::vector<BRM::ExtentBloomEntry> fBloomEntries;
+
   // disable copy constructor and assignment operator
   ColExtInf(const ColExtInf&);
   ColExtInf& operator=(const ColExtInf&);
@@ -179,14 +179,21 @@ ColumnInfo::ColumnInfo(Log* logger, int idIn, const JobColumn& columnIn, DBRootE
     }
 
     case WriteEngine::WR_CHAR:
+    case WriteEngine::WR_TEXT:
     {
+      // Dictionary columns get bloom filters of their strings, but no min/max
       if (column.colType == COL_TYPE_DICT)
       {
-        fColExtInf = new ColExtInfBase();
+        uint32_t bloomBits = extentBloomBits();
+
+        if (bloomBits)
+          fColExtInf = new ColExtInf(column.mapOid, logger, bloomBits, false);
+        else
+          fColExtInf = new ColExtInfBase();
       }
       else
       {
-        fColExtInf = new ColExtInf(column.mapOid, logger);
+        fColExtInf = new ColExtInf(column.mapOid, logger, extentBloomBits());
       }
 
       break;
@@ -205,7 +212,7 @@ ColumnInfo::ColumnInfo(Log* logger, int idIn, const JobColumn& columnIn, DBRootE
     case WriteEngine::WR_BINARY:
     default:
     {
-      fColExtInf = new ColExtInf(column.mapOid, logger);
+      fColExtInf = new ColExtInf(column.mapOid, logger, extentBloomBits());
       break;
     }
   }
@@ -1075,9 +1082,99 @@ void ColumnInfo::lastInputRowInExtentInit(bool bIsNewExtent)
   if (bRoomToAddToOriginalExtent)
   {
     fColExtInf->addFirstEntry(fLastInputRowInCurrentExtent, fSavedLbid, bIsNewExtent);
+
+    if (fColExtInf->hasBloom())
+      addFirstBloom((numRowsWritten % ROWS_PER_EXTENT) != 0);
   }
 }
 
+//------------------------------------------------------------------------------
+// Size of the bloom filter to build for each extent of this column; 0 if the
+// column's values can't be looked up in a bloom filter.
+//------------------------------------------------------------------------------
+uint32_t ColumnInfo::extentBloomBits() const
+{
+  if (!BRM::ExtentBloom::supported(column.dataType, column.width, column.colType == COL_TYPE_DICT))
+    return 0;
+
+  return Config::getExtentBloomBits();
+}
+
+//------------------------------------------------------------------------------
+// Start the bloom filter of the pre-existing extent we begin loading into.  If
+// the extent already has rows, its filter is only extended if it has a current
+// one; else no filter is built for the extent, as it would miss those rows.
+//------------------------------------------------------------------------------
+void ColumnInfo::addFirstBloom(bool bExtentHasRows)
+{
+  if (!bExtentHasRows)
+  {
+    BRM::ExtentBloom noRows;
+    fColExtInf->addFirstBloom(fLastInputRowInCurrentExtent, &noRows);
+    return;
+  }
+
+  std::vector<BRM::EMEntry> extents;
+  const BRM::ExtentBloom* bloom = 0;
+  BRM::ExtentBlooms blooms(column.mapOid);
+
+  if (BRMWrapper::getInstance()->getExtents_dbroot(column.mapOid, extents, curCol.dataFile.fDbRoot) ==
+      NO_ERROR)
+  {
+    for (unsigned i = 0; i < extents.size(); i++)
+    {
+      if (extents[i].range.start == fSavedLbid)
+      {
+        bloom = blooms.find(extents[i]);
+        break;
+      }
+    }
+  }
+
+  fColExtInf->addFirstBloom(fLastInputRowInCurrentExtent, bloom);
+}
+
+//------------------------------------------------------------------------------
+// Add the values parsed for an extent to the extent's bloom filter.
+// values points to count values in their column file representation.
+//------------------------------------------------------------------------------
+void ColumnInfo::updateBloom(RID lastInputRow, const unsigned char* values, uint32_t count)
+{
+  std::vector<uint64_t> hashes(count);
+  const uint32_t width = column.width;
+
+  if (column.weType == WriteEngine::WR_CHAR)
+  {
+    for (uint32_t i = 0; i < count; i++)
+      hashes[i] = BRM::ExtentBloom::hash(column.cs, values + i * width, width);
+  }
+  else
+  {
+    for (uint32_t i = 0; i < count; i++)
+      hashes[i] = BRM::ExtentBloom::hash(values + i * width, width);
+  }
+
+  fColExtInf->addToBloom(lastInputRow, hashes);
+}
+
+//------------------------------------------------------------------------------
+// Add the hashes of the strings stored for an extent of a dictionary column to
+// the extent's bloom filter.
+//------------------------------------------------------------------------------
+void ColumnInfo::updateDictBloom(RID lastInputRow, const std::vector<uint64_t>& hashes)
+{
+  fColExtInf->addToBloom(lastInputRow, hashes);
+}
+
+//------------------------------------------------------------------------------
+// Get the bloom filters of the extents whose CP info was sent to BRM.
+//------------------------------------------------------------------------------
+void ColumnInfo::getBloomInfo(std::vector<BRM::ExtentBloomEntry>& entries)
+{
+  boost::mutex::scoped_lock lock(fColMutex);
+  fColExtInf->getBloomInfo(entries);
+}
+
 //------------------------------------------------------------------------------
 // Increment fLastRIDInExtent to the end of the next extent.
 //------------------------------------------------------------------------------
@@ -1567,6 +1664,23 @@ int ColumnInfo::openDctnryStore(bool bMustExist)
       return rc;
     }
 
+    // Strings loaded before are tokenized from the cache, not stored again
+    rc = fStore->preLoadStringCacheFromFile();
+
+    if (rc != NO_ERROR)
+    {
+      WErrorCodes ec;
+      std::ostringstream oss;
+      oss << "openDctnryStore: error preloading strings of store file for "
+          << "OID-" << column.dctnry.dctnryOid << "; DBRoot-" << curCol.dataFile.fDbRoot << "; part-"
+          << curCol.dataFile.fPartition << "; seg-" << curCol.dataFile.fSegment << "; " << ec.errorString(rc);
+      fLog->logMsg(oss.str(), rc, MSGLVL_ERROR);
+
+      // Ignore return code from closing file; already in error state
+      closeDctnryStore(true);  // clean up loose ends
+      return rc;
+    }
+
     if (INVALID_LBID != fStore->getCurLbid())
       fDictBlocks.push_back(fStore->getCurLbid());
 
@@ -1662,7 +1776,7 @@ int ColumnInfo::closeDctnryStore(bool bAbort)
 // tokens (tokenbuf) to be stored in the corresponding column token file.
 //--------------------------------------------------------------------------------------
 int ColumnInfo::updateDctnryStoreParquet(std::shared_ptr<arrow::Array> columnData, int tokenPos,
-                                         const int totalRow, char* tokenBuf)
+                                         const int totalRow, char* tokenBuf, std::vector<uint64_t>* valueHashes)
 {
   long long truncCount = 0;
 
@@ -1674,7 +1788,9 @@ int ColumnInfo::updateDctnryStoreParquet(std::shared_ptr<arrow::Array> columnDat
   Stats::stopParseEvent(WE_STATS_WAIT_TO_PARSE_DCT);
 #endif
 
+  fStore->setValueHashes(valueHashes);
   int rc = fStore->insertDctnryParquet(columnData, tokenPos, totalRow, id, tokenBuf, truncCount, column.cs, column.weType);
+  fStore->setValueHashes(0);
 
   if (rc != NO_ERROR)
   {
@@ -1696,7 +1812,8 @@ int ColumnInfo::updateDctnryStoreParquet(std::shared_ptr<arrow::Array> columnDat
 // Update dictionary store file with specified strings, and return the assigned
 // tokens (tokenbuf) to be stored in the corresponding column token file.
 //------------------------------------------------------------------------------
-int ColumnInfo::updateDctnryStore(char* buf, ColPosPair** pos, const int totalRow, char* tokenBuf)
+int ColumnInfo::updateDctnryStore(char* buf, ColPosPair** pos, const int totalRow, char* tokenBuf,
+                                  std::vector<uint64_t>* valueHashes)
 {
   long long truncCount = 0;  // No. of rows with truncated values
 
@@ -1732,7 +1849,9 @@ int ColumnInfo::updateDctnryStore(char* buf, ColPosPair** pos, const int totalRo
   Stats::stopParseEvent(WE_STATS_WAIT_TO_PARSE_DCT);
 #endif
 
+  fStore->setValueHashes(valueHashes);
   int rc = fStore->insertDctnry(buf, pos, totalRow, id, tokenBuf, truncCount, column.cs, column.weType);
+  fStore->setValueHashes(0);
 
   if (rc != NO_ERROR)
   {
@@ -203,16 +203,20 @@ class ColumnInfo : public WeUIDGID
   /** @brief Update dictionary for arrow/parquet format
    *  Parse and store the parquet data into the store file, and
    *  returns the assigned tokens (tokenBuf) to be stored in the
-   *  corresponding column token file.
+   *  corresponding column token file.  The ExtentBloom::hash() of each
+   *  stored string is added to valueHashes, if not NULL.
    */
-  int updateDctnryStoreParquet(std::shared_ptr<arrow::Array> columnData, int tokenPos, const int totalRow, char* tokenBuf);
+  int updateDctnryStoreParquet(std::shared_ptr<arrow::Array> columnData, int tokenPos, const int totalRow,
+                               char* tokenBuf, std::vector<uint64_t>* valueHashes = 0);
 
   /** @brief Update dictionary method.
    *  Parses and stores specified strings into the store file, and
    *  returns the assigned tokens (tokenBuf) to be stored in the
-   *  corresponding column token file.
+   *  corresponding column token file.  The ExtentBloom::hash() of each
+   *  stored string is added to valueHashes, if not NULL.
    */
-  int updateDctnryStore(char* buf, ColPosPair** pos, const int totalRow, char* tokenBuf);
+  int updateDctnryStore(char* buf, ColPosPair** pos, const int totalRow, char* tokenBuf,
+                        std::vector<uint64_t>* valueHashes = 0);
 
   /** @brief Close the current Column file.
    *  @param bCompletedExtent are we completing an extent
@@ -302,6 +306,29 @@ class ColumnInfo : public WeUIDGID
   template <typename T>
   void updateCPInfo(RID lastInputRow, T minVal, T maxVal, ColDataType colDataType, int width);
 
+  /** @brief Add parsed values to the bloom filter of their extent
+   *  @param lastInputRow Last input Row of the extent the values belong to
+   *  @param values       Values in their column file representation
+   *  @param count        Number of values
+   */
+  void updateBloom(RID lastInputRow, const unsigned char* values, uint32_t count);
+
+  /** @brief Add the hashes of the strings stored for an extent of a
+   *  dictionary column to the extent's bloom filter.
+   *  @param lastInputRow Last input Row of the extent the strings belong to
+   *  @param hashes       ExtentBloom::hash() of each string
+   */
+  void updateDictBloom(RID lastInputRow, const std::vector<uint64_t>& hashes);
+
+  /** @brief Are bloom filters built for the extents of this column
+   */
+  bool hasExtentBloom() const;
+
+  /** @brief Get the bloom filters of the extents whose CP info was sent to
+   *  BRM by getBRMUpdateInfo().
+   */
+  void getBloomInfo(std::vector<BRM::ExtentBloomEntry>& entries);
+
   /** @brief Setup initial extent we will begin loading at start of import.
    *  @param dbRoot    DBRoot of starting extent
    *  @param partition Partition number of starting extent
@@ -409,6 +436,12 @@ class ColumnInfo : public WeUIDGID
   // bIsNewExtent indicates whether to treat as a new extent or not.
   void lastInputRowInExtentInit(bool bIsNewExtent);
 
+  // Bloom filter size for the extents of this column; 0 for no filters
+  uint32_t extentBloomBits() const;
+
+  // Start the bloom filter of the pre-existing extent we begin loading into
+  void addFirstBloom(bool bExtentHasRows);
+
   virtual int resetFileOffsetsNewExtent(const char* hdr);
   // Reset file; start new extent
   void setFileSize(HWM hwm, int abbrevFlag);  // Set fileSize data member
@@ -557,6 +590,11 @@ inline unsigned ColumnInfo::rowsPerExtent()
   return fRowsPerExtent;
 }
 
+inline bool ColumnInfo::hasExtentBloom() const
+{
+  return fColExtInf->hasBloom();
+}
+
 template <typename T>
 inline void ColumnInfo::updateCPInfo(RID lastInputRow, T minVal, T maxVal, ColDataType colDataType, int width)
 {
@@ -0,0 +1,131 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#endif
+
+#include "simd_dispatch.h"
+#include "we_csvscanner.h"
+
+namespace WriteEngine
+{
+#if defined(__x86_64__)
+// Defined in we_csvscanner_avx2.cpp
+const char* findAvx2(const char* p, const char* end, char c1, char c2);
+
+namespace
+{
+const char* findSse2(const char* p, const char* end, char c1, char c2)
+{
+  const __m128i v1 = _mm_set1_epi8(c1);
+  const __m128i v2 = _mm_set1_epi8(c2);
+
+  for (; end - p >= 16; p += 16)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, v1), _mm_cmpeq_epi8(v, v2)));
+
+    if (mask)
+      return p + __builtin_ctz(mask);
+  }
+
+  return CsvScanner::findScalar(p, end, c1, c2);
+}
+}  // namespace
+#endif
+
+CsvScanner::CsvScanner(char colDelim, char enclosedByChar, char escapeChar)
+ : fColDelim(colDelim), fEnclosedByChar(enclosedByChar), fEscapeChar(escapeChar), fFind(findScalar)
+{
+#if defined(__x86_64__)
+  fFind = (simd::getSimdLevel() >= simd::SimdLevel::SIMD256) ? findAvx2 : findSse2;
+#endif
+}
+
+const char* CsvScanner::findScalar(const char* p, const char* end, char c1, char c2)
+{
+  for (; p < end; p++)
+  {
+    if (*p == c1 || *p == c2)
+      return p;
+  }
+
+  return end;
+}
+
+const char* CsvScanner::findRecordEnd(const char* recordStart, const char* from, const char* end) const
+{
+  if (fEnclosedByChar == '\0')
+  {
+    const char* nl = static_cast<const char*>(memchr(from, '\n', end - from));
+    return nl ? nl + 1 : end;
+  }
+
+  // Follow the same states as tokenize(): a field that starts with the
+  // enclosing char runs to the next unescaped enclosing char, anything after
+  // that up to the delimiter is ignored, as is an enclosing char inside a
+  // field that didn't start with one.
+  const char* p = recordStart;
+
+  while (p < end)
+  {
+    if (*p == fEnclosedByChar)
+    {
+      for (p++;;)
+      {
+        const char* q = findEnclosedSpecial(p, end);
+
+        if (q == end)
+          return end;
+
+        if ((q + 1 < end) &&
+            (((*q == fEscapeChar) &&
+              ((q[1] == fEnclosedByChar) || (q[1] == fEscapeChar) || (q[1] == 0x0D) || (q[1] == 0x0A))) ||
+             ((*q == fEnclosedByChar) && (q[1] == fEnclosedByChar))))
+        {
+          p = q + 2;
+        }
+        else if (*q == fEnclosedByChar)
+        {
+          p = q + 1;
+          break;
+        }
+        else
+        {
+          p = q + 1;
+        }
+      }
+    }
+
+    p = findFieldEnd(p, end);
+
+    if (p == end)
+      return end;
+
+    if ((*p == '\n') && (p >= from))
+      return p + 1;
+
+    p++;
+  }
+
+  return end;
+}
+
+}  // namespace WriteEngine
@@ -0,0 +1,72 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+namespace WriteEngine
+{
+/** @brief Finds the structural characters of a text import buffer
+ *
+ * tokenize() only has to stop at field delimiters and newlines, or at the
+ * enclosing and escape characters inside an enclosed field.  The bytes in
+ * between are skipped 16 (SSE2) or 32 (AVX2) at a time; the width is picked
+ * at runtime from simd::getSimdLevel().
+ */
+class CsvScanner
+{
+ public:
+  typedef const char* (*FindFunc)(const char* p, const char* end, char c1, char c2);
+
+  CsvScanner(char colDelim, char enclosedByChar, char escapeChar);
+
+  /** @brief First field delimiter or newline in [p, end), or end
+   */
+  const char* findFieldEnd(const char* p, const char* end) const
+  {
+    return fFind(p, end, fColDelim, '\n');
+  }
+
+  /** @brief First enclosing or escape char in [p, end), or end
+   */
+  const char* findEnclosedSpecial(const char* p, const char* end) const
+  {
+    return fFind(p, end, fEnclosedByChar, fEscapeChar);
+  }
+
+  /** @brief Find where to split a buffer of records
+   *
+   * Returns the position just past the newline that ends the first record
+   * ending at or after "from", or end if no record ends in [from, end).
+   * Without an enclosing char every newline ends a record, and "recordStart"
+   * isn't looked at.  With one, newlines inside enclosed fields don't, so the
+   * fields are followed from "recordStart", which must be the start of a
+   * record, the same way tokenize() reads them.
+   */
+  const char* findRecordEnd(const char* recordStart, const char* from, const char* end) const;
+
+  /** @brief Plain byte at a time versions, used for the tails and by the tests
+   */
+  static const char* findScalar(const char* p, const char* end, char c1, char c2);
+
+ private:
+  char fColDelim;
+  char fEnclosedByChar;
+  char fEscapeChar;
+  FindFunc fFind;
+};
+
+}  // namespace WriteEngine
@@ -0,0 +1,49 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+// 256 bit structural character search. This file is compiled with AVX2 enabled
+// and must only be entered when simd::getSimdLevel() reports the support at runtime.
+
+#include <cstdint>
+
+#include "we_csvscanner.h"
+
+#if defined(__x86_64__) && defined(__AVX2__)
+#include <immintrin.h>
+
+namespace WriteEngine
+{
+const char* findAvx2(const char* p, const char* end, char c1, char c2)
+{
+  const __m256i v1 = _mm256_set1_epi8(c1);
+  const __m256i v2 = _mm256_set1_epi8(c2);
+
+  for (; end - p >= 32; p += 32)
+  {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const uint32_t mask =
+        _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, v1), _mm256_cmpeq_epi8(v, v2)));
+
+    if (mask)
+      return p + __builtin_ctz(mask);
+  }
+
+  return CsvScanner::findScalar(p, end, c1, c2);
+}
+
+}  // namespace WriteEngine
+#endif
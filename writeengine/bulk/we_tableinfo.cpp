@@ -147,6 +147,7 @@ TableInfo::TableInfo(Log* logger, const BRM::TxnID txnID, const string& processN
  , fNullStringMode(false)
  , fEnclosedByChar('\0')
  , fEscapeChar('\\')
+ , fTokenizeThreads(1)
  , fProcessingBegun(false)
  , fBulkMode(BULK_MODE_LOCAL)
  , fBRMReporter(logger, tableName)
@@ -1083,6 +1084,8 @@ int TableInfo::finishBRM()
     fColumns[i].getBRMUpdateInfo(fBRMReporter);
   }
 
+  saveExtentBlooms();
+
   // We use mutex not to synchronize contention among parallel threads,
   // because we should be the only thread accessing the fErrFiles and
   // fBadFiles at this point.  But we do use the mutex as a memory barrier
@@ -1101,6 +1104,40 @@ int TableInfo::finishBRM()
   return rc;
 }
 
+//------------------------------------------------------------------------------
+// Save the bloom filters built for the extents whose CP info is going to BRM.
+// They are only published once the BRM updates are in, when the bulk rollback
+// meta data file is deleted, as the extents' CP sequence numbers are needed.
+// A filter that can't be saved is just lost; the extent falls back to min/max.
+//------------------------------------------------------------------------------
+void TableInfo::saveExtentBlooms()
+{
+  std::vector<BRM::ExtentBloomEntry> blooms;
+
+  for (unsigned i = 0; i < fColumns.size(); ++i)
+  {
+    fColumns[i].getBloomInfo(blooms);
+  }
+
+  std::vector<uint16_t> dbRoots;
+  Config::getRootIdList(dbRoots);
+
+  if (dbRoots.empty())
+    return;
+
+  if (blooms.empty())
+  {
+    BRM::ExtentBloomStore::discardPending(fTableOID, dbRoots[0]);
+  }
+  else if (BRM::ExtentBloomStore::writePending(fTableOID, dbRoots[0], blooms) != BRM::ERR_OK)
+  {
+    ostringstream oss;
+    oss << "Unable to save extent bloom filters for table " << fTableName << "; OID-" << fTableOID;
+    fLog->logMsg(oss.str(), MSGLVL_WARNING);
+    BRM::ExtentBloomStore::discardPending(fTableOID, dbRoots[0]);
+  }
+}
+
 //------------------------------------------------------------------------------
 // Update status of table to reflect an error.
 // No need to update the buffer or column status, because we are not going to
@@ -1258,6 +1295,7 @@ int TableInfo::initializeBuffers(int noOfBuffers, const JobFieldRefList& jobFiel
     buffer->setNullStringMode(fNullStringMode);
     buffer->setEnclosedByChar(fEnclosedByChar);
     buffer->setEscapeChar(fEscapeChar);
+    buffer->setTokenizeThreads(fTokenizeThreads);
     buffer->setTruncationAsError(getTruncationAsError());
     buffer->setImportDataMode(fImportDataMode, fixedBinaryRecLen);
     buffer->setTimeZone(fTimeZone);
@@ -1911,6 +1949,13 @@ void TableInfo::deleteMetaDataRollbackFile()
     return;
   }
 
+  // The BRM updates are in, so the extents' bloom filters can be published
+  std::vector<uint16_t> dbRoots;
+  Config::getRootIdList(dbRoots);
+
+  if (!dbRoots.empty())
+    BRM::ExtentBloomStore::commitPending(fTableOID, dbRoots[0]);
+
   if (!fKeepRbMetaFile)
   {
     // Treat any error as non-fatal, though we log it.
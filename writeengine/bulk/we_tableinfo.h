@@ -150,6 +150,7 @@ class TableInfo : public WeUIDGID
   char fEnclosedByChar;  // Character to enclose col values
   char fEscapeChar;      // Escape character used in conjunc-
   //   tion with fEnclosedByChar
+  unsigned fTokenizeThreads;  // Threads tokenizing each read buffer
   bool fProcessingBegun;                 // Has processing begun on this tbl
   BulkModeType fBulkMode;                // Distributed bulk mode (1,2, or 3)
   std::string fBRMRptFileName;           // Name of distributed mode rpt file
@@ -186,6 +187,7 @@ class TableInfo : public WeUIDGID
   int confirmDBFileChanges();           // Confirm DB file changes (on HDFS)
   void deleteTempDBFileChanges();       // Delete DB temp swap files (on HDFS)
   int finishBRM();                      // Finish reporting updates for BRM
+  void saveExtentBlooms();              // Save extent bloom filters for BRM
   void freeProcessingBuffers();         // Free up Processing Buffers
   bool isBufferAvailable(bool report);  // Is tbl buffer available for reading
   int openTableFileParquet(
@@ -338,6 +340,10 @@ class TableInfo : public WeUIDGID
    */
   void setEscapeChar(char esChar);
 
+  /** @brief Set the number of threads that tokenize each read buffer.
+   */
+  void setTokenizeThreads(unsigned tokenizeThreads);
+
   /** @brief Has processing begun for this table.
    */
   bool hasProcessingBegun();
@@ -583,6 +589,11 @@ inline void TableInfo::setEscapeChar(char esChar)
   fEscapeChar = esChar;
 }
 
+inline void TableInfo::setTokenizeThreads(unsigned tokenizeThreads)
+{
+  fTokenizeThreads = tokenizeThreads;
+}
+
 inline void TableInfo::setFileBufferSize(const int fileBufSize)
 {
   fFileBufSize = fileBufSize;
@@ -29,7 +29,6 @@
 #include <cstdlib>
 #include <cstring>
 #include <vector>
-#include <set>
 #include <sstream>
 #include <inttypes.h>
 #include <iostream>
@@ -38,6 +37,7 @@ using namespace std;
 #include "bytestream.h"
 #include "brmtypes.h"
 #include "extentmap.h"  // for DICT_COL_WIDTH
+#include "extentbloom.h"
 #include "we_stats.h"
 #include "we_log.h"
 #include "we_dctnry.h"
@@ -84,7 +84,8 @@ int NUM_BLOCKS_PER_INITIAL_EXTENT = ((INITIAL_EXTENT_ROWS_TO_DISK / BYTE_PER_BLO
  * Dctnry constructor
  ******************************************************************************/
 Dctnry::Dctnry()
- : m_nextPtr(NOT_USED_PTR)
+ : m_stringCache(Config::getDctnryStringCacheSize())
+ , m_nextPtr(NOT_USED_PTR)
  , m_partition(0)
  , m_segment(0)
  , m_dbRoot(1)
@@ -96,6 +97,7 @@ Dctnry::Dctnry()
  , m_curOp(0)
  , m_colWidth(0)
  , m_importDataMode(IMPORT_DATA_TEXT)
+ , m_valueHashes(0)
 {
   memset(m_dctnryHeader, 0, sizeof(m_dctnryHeader));
   memset(m_curBlock.data, 0, sizeof(m_curBlock.data));
@@ -109,7 +111,6 @@ Dctnry::Dctnry()
   memcpy(m_dctnryHeader2 + HDR_UNIT_SIZE + NEXT_PTR_BYTES + HDR_UNIT_SIZE, &m_endHeader, HDR_UNIT_SIZE);
   m_curFbo = INVALID_NUM;
   m_curLbid = INVALID_LBID;
-  m_arraySize = 0;
 
   clear();  // files
 }
@@ -130,16 +131,7 @@ Dctnry::~Dctnry()
  ******************************************************************************/
 void Dctnry::freeStringCache()
 {
-  std::set<Signature, sig_compare>::iterator it;
-  for (it = m_sigArray.begin(); it != m_sigArray.end(); it++)
-  {
-    Signature sig = *it;
-    delete[] sig.signature;
-    sig.signature = 0;
-  }
-
-  m_arraySize = 0;
-  m_sigArray.clear();
+  m_stringCache.clear();
 }
 
 /*******************************************************************************
@@ -163,7 +155,6 @@ int Dctnry::init()
   m_curOp = 0;
   memset(m_curBlock.data, 0, sizeof(m_curBlock.data));
   m_curBlock.lbid = INVALID_LBID;
-  m_arraySize = 0;
 
   return NO_ERROR;
 }
@@ -598,7 +589,7 @@ int Dctnry::openDctnry(const OID& dctnryOID, const uint16_t dbRoot, const uint32
   // the string cache used to recognize duplicates during row insertion.
   if (m_hwm == 0)
   {
-    preLoadStringCache(m_curBlock);
+    preLoadStringCache(m_curBlock, m_curLbid, false);
   }
 
 #ifdef PROFILE
@@ -622,20 +613,7 @@ int Dctnry::openDctnry(const OID& dctnryOID, const uint16_t dbRoot, const uint32
  ******************************************************************************/
 bool Dctnry::getTokenFromArray(Signature& sig)
 {
-  std::set<Signature, sig_compare>::iterator it;
-  it = m_sigArray.find(sig);
-  if (it == m_sigArray.end())
-  {
-    return false;
-  }
-  else
-  {
-    Signature sigfound = *it;
-    sig.token = sigfound.token;
-    return true;
-  }
-
-  return false;
+  return m_stringCache.find(sig.signature, sig.size, sig.token);
 }
 
 /*******************************************************************************
@@ -794,6 +772,9 @@ int Dctnry::insertDctnry1(Signature& curSig, bool found, char* pOut, int& outOff
     }
   }
 
+  if (m_valueHashes)
+    m_valueHashes->push_back(BRM::ExtentBloom::hash(cs, curSig.signature, curSig.size));
+
   //...Search for the string in our string cache
   // if it fits into one block (< 8KB)
   if (curSig.size <= MAX_SIGNATURE_SIZE)
@@ -842,9 +823,9 @@ int Dctnry::insertDctnry1(Signature& curSig, bool found, char* pOut, int& outOff
       next = true;
     }
 
-    //...Add string to cache, if we have not exceeded cache limit
+    //...Add string to cache
     // Don't cache big blobs
-    if ((m_arraySize < MAX_STRING_CACHE_SIZE) && (curSig.size <= MAX_SIGNATURE_SIZE))
+    if (curSig.size <= MAX_SIGNATURE_SIZE)
     {
       addToStringCache(curSig);
     }
@@ -943,8 +924,8 @@ int Dctnry::insertDctnry1(Signature& curSig, bool found, char* pOut, int& outOff
       outOffset += 8;
       startPos++;
 
-      //...Add string to cache, if we have not exceeded cache limit
-      if ((m_arraySize < MAX_STRING_CACHE_SIZE) && (curSig.size <= MAX_SIGNATURE_SIZE))
+      //...Add string to cache
+      if (curSig.size <= MAX_SIGNATURE_SIZE)
       {
         addToStringCache(curSig);
       }
@@ -1449,76 +1430,132 @@ void Dctnry::getBlockOpCount(const DataBlock& fileBlock, int& op_count)
 
 /*******************************************************************************
  * Description:
- * Loads the string cache from the specified DataBlock, which should be
- * the first block in the applicable dictionary store file.
+ * Loads the string cache from the specified DataBlock of the applicable
+ * dictionary store file.  A string that didn't fit in a block is continued
+ * in the next block, leaving the block full, so the last string of a full
+ * block and, if skipFirst is set, the first string of a block are parts of
+ * a longer string and are not cached.
  * input
  *      DataBlock& fileBlock -- the file block
+ *      lbid                 -- LBID of the file block
+ *      skipFirst            -- the previous block was full
+ * return value
+ *      false if the cache is full
  ******************************************************************************/
-void Dctnry::preLoadStringCache(const DataBlock& fileBlock)
+bool Dctnry::preLoadStringCache(const DataBlock& fileBlock, LBID_t lbid, bool skipFirst)
 {
   int hdrOffsetBeg = HDR_UNIT_SIZE + NEXT_PTR_BYTES + HDR_UNIT_SIZE;
   int hdrOffsetEnd = HDR_UNIT_SIZE + NEXT_PTR_BYTES;
+  uint16_t freeSpace = 0;
   uint16_t offBeg = 0;
   uint16_t offEnd = 0;
+  memcpy(&freeSpace, &fileBlock.data[0], HDR_UNIT_SIZE);
   memcpy(&offBeg, &fileBlock.data[hdrOffsetBeg], HDR_UNIT_SIZE);
   memcpy(&offEnd, &fileBlock.data[hdrOffsetEnd], HDR_UNIT_SIZE);
 
   int op = 1;  // ordinal position of the string within the block
-  Signature aSig;
-  void* aSigPtr = static_cast<void*>(&aSig);
-  memset(aSigPtr, 0, sizeof(aSig));
+  WriteEngine::Token token;
+  token.fbo = lbid;
+  token.bc = 0;
 
-  while ((offBeg != DCTNRY_END_HEADER) && (op <= MAX_STRING_CACHE_SIZE))
+  while ((offBeg != DCTNRY_END_HEADER) && (op < MAX_OP_COUNT))
   {
-    unsigned int len = offEnd - offBeg;
-    aSig.size = len;
-    aSig.signature = new unsigned char[len];
-    memcpy(aSig.signature, &fileBlock.data[offBeg], len);
-    aSig.token.op = op;
-    aSig.token.fbo = m_curLbid;
-    m_sigArray.insert(aSig);
+    uint16_t nextOffBeg = 0;
+    memcpy(&nextOffBeg, &fileBlock.data[hdrOffsetBeg + HDR_UNIT_SIZE], HDR_UNIT_SIZE);
+    const bool isLast = (nextOffBeg == DCTNRY_END_HEADER);
+
+    if (!(op == 1 && skipFirst) && !(isLast && freeSpace == 0))
+    {
+      token.op = op;
+
+      if (!m_stringCache.insert(&fileBlock.data[offBeg], offEnd - offBeg, token))
+        return false;
+    }
 
     offEnd = offBeg;
+    offBeg = nextOffBeg;
     hdrOffsetBeg += HDR_UNIT_SIZE;
-    memcpy(&offBeg, &fileBlock.data[hdrOffsetBeg], HDR_UNIT_SIZE);
     op++;
   }
 
-  m_arraySize = op - 1;
-
-  // std::cout << "Preloading strings..." << std::endl;
-  // char strSig[1000];
-  // uint64_t tokenVal;
-  // for (int i=0; i<m_arraySize; i++)
-  //{
-  //  memcpy(strSig, m_sigArray[i].signature, m_sigArray[i].size );
-  //  memcpy(&tokenVal, &m_sigArray[i].token, sizeof(uint64_t));
-  //  strSig[m_sigArray[i].size] = '\0';
-  //  std::cout << "op-"      << m_sigArray[i].token.op  <<
-  //               "; fbo-"   << m_sigArray[i].token.fbo <<
-  //               "; sig-"   << strSig   <<
-  //               "; token-" << tokenVal << std::endl;
-  //}
+  return true;
+}
+
+/*******************************************************************************
+ * Description:
+ * Preloads the string cache with the strings of the blocks that precede the
+ * current block, so that cpimport finds the strings of earlier loads too.
+ * The cache is budgeted in bytes, so only the last blocks that can fit, about
+ * one block per 8K of the budget, are read.
+ *
+ * return value
+ *      NO_ERROR or the error of reading a block
+ ******************************************************************************/
+int Dctnry::preLoadStringCacheFromFile()
+{
+  // a store file of one block was preloaded when it was opened
+  if (!m_dFile || m_hwm == 0)
+    return NO_ERROR;
+
+  const HWM maxBlocks = m_stringCache.maxBytes() / BYTE_PER_BLOCK;
+  const HWM startFbo = (m_hwm > maxBlocks) ? m_hwm - maxBlocks : 0;
+  CommBlock cb;
+  cb.file.oid = m_dctnryOID;
+  cb.file.pFile = m_dFile;
+  DataBlock fileBlock;
+  bool prevFull = (startFbo > 0);  // not known, so don't trust the first string
+  int rc = NO_ERROR;
+
+  for (HWM fbo = startFbo; fbo <= m_hwm; fbo++)
+  {
+    LBID_t lbid = m_curLbid;
+
+    if (fbo != m_hwm)
+    {
+      RETURN_ON_ERROR(BRMWrapper::getInstance()->getBrmInfo(m_dctnryOID, m_partition, m_segment, fbo, lbid));
+      rc = readDBFile(cb, fileBlock.data, lbid);
+
+      if (rc != NO_ERROR)
+        break;
+    }
+    else
+    {
+      memcpy(fileBlock.data, m_curBlock.data, BYTE_PER_BLOCK);
+    }
+
+    if (!preLoadStringCache(fileBlock, lbid, prevFull))
+      break;
+
+    uint16_t freeSpace = 0;
+    memcpy(&freeSpace, &fileBlock.data[0], HDR_UNIT_SIZE);
+    prevFull = (freeSpace == 0);
+  }
+
+  //@Bug 5567  Don't seek for compressed file.
+  if (m_compressionType == 0)
+  {
+    // Position file back to the start of the current block
+    long long byteOffset = ((long long)m_curFbo) * (long)BYTE_PER_BLOCK;
+    RETURN_ON_ERROR(setFileOffset(m_dFile, byteOffset));
+  }
+
+  return rc;
 }
 
 /*******************************************************************************
  * Description:
- * Add the specified signature (string) to the string cache.
+ * Add the specified signature (string) to the string cache.  Once the cache
+ * is full it is emptied, so it holds the most recently added strings.
  * input
  *      newSig -- Signature string to be added to the string cache.
  ******************************************************************************/
 void Dctnry::addToStringCache(const Signature& newSig)
 {
-  // We better add constructors that sets everything to 0;
-  Signature asig;
-  void* aSigPtr = static_cast<void*>(&asig);
-  memset(aSigPtr, 0, sizeof(asig));
-  asig.signature = new unsigned char[newSig.size];
-  memcpy(asig.signature, newSig.signature, newSig.size);
-  asig.size = newSig.size;
-  asig.token = newSig.token;
-  m_sigArray.insert(asig);
-  m_arraySize++;
+  if (!m_stringCache.insert(newSig.signature, newSig.size, newSig.token))
+  {
+    m_stringCache.clear();
+    m_stringCache.insert(newSig.signature, newSig.size, newSig.token);
+  }
 }
 
 /*******************************************************************************
@@ -1596,15 +1633,10 @@ int Dctnry::updateDctnry(unsigned char* sigValue, int& sigSize, Token& token)
 
   // Add the new signature and token into cache
   // As long as the string is <= 8000 bytes
-  if ((m_arraySize < MAX_STRING_CACHE_SIZE) && (sigSize <= MAX_SIGNATURE_SIZE))
+  if ((rc == NO_ERROR) && (sigSize <= MAX_SIGNATURE_SIZE))
   {
-    Signature sig;
-    sig.size = sigSize;
-    sig.signature = new unsigned char[sigSize];
-    memcpy(sig.signature, sigValue, sigSize);
     sig.token = token;
-    m_sigArray.insert(sig);
-    m_arraySize++;
+    addToStringCache(sig);
   }
 
   return rc;
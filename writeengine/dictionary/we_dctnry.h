@@ -30,12 +30,14 @@
 #include <cstddef>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "we_dbfileop.h"
 #include "we_type.h"
 #include "we_brm.h"
 #include "bytestream.h"
 #include "nullstring.h"
+#include "we_dctnrystringcache.h"
 
 #define EXPORT
 
@@ -57,25 +59,6 @@ typedef struct Signature
   Token token;
 } Signature;
 
-struct sig_compare
-{
-  bool operator()(const Signature& a, const Signature& b) const
-  {
-    if (a.size == b.size)
-    {
-      return memcmp(a.signature, b.signature, a.size) < 0;
-    }
-    else if (a.size < b.size)
-    {
-      return true;
-    }
-    else
-    {
-      return false;
-    }
-  }
-};
-
 /**
  * @brief Class to interface with dictionary store files.
  */
@@ -211,6 +194,12 @@ class Dctnry : public DbFileOp
   EXPORT int openDctnry(const OID& dctnryOID, const uint16_t dbRoot, const uint32_t partition,
                         const uint16_t segment, const bool useTmpSuffix);
 
+  /**
+   * @brief Preload the string cache with the strings of the last blocks of
+   * the open store file, as many as fit in the cache (for Bulk use)
+   */
+  EXPORT int preLoadStringCacheFromFile();
+
   /**
    * @brief copy the dictionary header to buffer
    */
@@ -245,6 +234,15 @@ class Dctnry : public DbFileOp
     m_importDataMode = importMode;
   }
 
+  /**
+   * @brief Collect the ExtentBloom::hash() of each non NULL string the bulk
+   *        insert functions store, as stored (after truncation); NULL for none
+   */
+  void setValueHashes(std::vector<uint64_t>* valueHashes)
+  {
+    m_valueHashes = valueHashes;
+  }
+
   virtual int checkFixLastDictChunk()
   {
     return NO_ERROR;
@@ -307,10 +305,11 @@ class Dctnry : public DbFileOp
   void insertSgnture(unsigned char* blockBuf, const int& size, unsigned char* value);
 
   //
-  // Preloads the strings from the specified DataBlock.  Currently
-  // used to preload the first block, of a store file having only 1 block.
+  // Preloads the strings from the specified DataBlock, the block of lbid.
+  // skipFirst is set if the first string may be the end of a string that
+  // started in the previous block.  Returns false once the cache is full.
   //
-  void preLoadStringCache(const DataBlock& fileBlock);
+  bool preLoadStringCache(const DataBlock& fileBlock, BRM::LBID_t lbid, bool skipFirst);
 
   // methods to be overriden by compression classes
   // (width argument in createDctnryFile() is string width, not token width)
@@ -320,8 +319,7 @@ class Dctnry : public DbFileOp
   virtual void closeDctnryFile(bool doFlush, std::map<FID, FID>& oids);
   virtual int numOfBlocksInFile();
 
-  std::set<Signature, sig_compare> m_sigArray;
-  int m_arraySize;  // num strings in m_sigArray
+  DctnryStringCache m_stringCache;  // strings of the store file and their tokens
 
   // m_dctnryHeader  used for hdr when readSubBlockEntry is used to read a blk
   // m_dctnryHeader2 contains filled in template used to initialize new blocks
@@ -351,6 +349,7 @@ class Dctnry : public DbFileOp
   int m_colWidth;                   // width of this dictionary column
   utils::NullString m_defVal;             // optional default string value
   ImportDataMode m_importDataMode;  // Import data in text or binary mode
+  std::vector<uint64_t>* m_valueHashes;  // hashes of the inserted strings, if wanted
 
 };  // end of class
 
@@ -97,33 +97,24 @@ const int DctnryStore::updateDctnryStore(unsigned char* sigValue, int& sigSize,
   // if String cache is enabled then look for string in cache
   if (m_hashMapFlag)
   {
-    if (m_dctnry.m_arraySize < (int)m_hashMapSize)
+    bool found = false;
+    found = m_dctnry.getTokenFromArray(sig);
+
+    if (found)
     {
-      bool found = false;
-      found = m_dctnry.getTokenFromArray(sig);
-
-      if (found)
-      {
-        token = sig.token;
-        return NO_ERROR;
-      }
-    }  // end if use hash map and size >0
+      token = sig.token;
+      return NO_ERROR;
+    }
   }
 
   // Insert into Dictionary
   rc = m_dctnry.insertDctnry(sigSize, sigValue, token);
 
   // Add the new signature and token into cache if the hashmap flag is on
-  // (We currently use an array instead of a hashmap.)
-  if ((m_hashMapFlag) && (m_dctnry.m_arraySize < (int)m_hashMapSize))
+  if (m_hashMapFlag)
   {
-    Signature sig;
-    sig.size = sigSize;
-    sig.signature = new unsigned char[sigSize];
-    memcpy(sig.signature, sigValue, sigSize);
     sig.token = token;
-    m_dctnry.m_sigArray.insert(sig) = sig;
-    m_dctnry.m_arraySize++;
+    m_dctnry.addToStringCache(sig);
   }
 
   return rc;
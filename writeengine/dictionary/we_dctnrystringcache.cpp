@@ -0,0 +1,189 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file we_dctnrystringcache.cpp
+ *  Implements the DctnryStringCache class.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "hasher.h"
+#include "we_dctnrystringcache.h"
+
+namespace
+{
+// what an empty string points to, fStr is nullptr only for an empty slot
+const unsigned char EMPTY_STRING[1] = {0};
+}  // namespace
+
+namespace WriteEngine
+{
+/*******************************************************************************
+ * Description:
+ * DctnryStringCache constructor; nothing is allocated until the first insert
+ ******************************************************************************/
+DctnryStringCache::DctnryStringCache(size_t maxBytes)
+ : fCount(0), fArenaBytes(0), fArenaPos(nullptr), fArenaFree(0), fMaxBytes(maxBytes)
+{
+}
+
+/*******************************************************************************
+ * Description:
+ * Look up a string, and set token if the string is cached.
+ ******************************************************************************/
+bool DctnryStringCache::find(const unsigned char* str, uint32_t len, Token& token) const
+{
+  if (fCount == 0)
+    return false;
+
+  const uint32_t hash = utils::Hasher()(reinterpret_cast<const char*>(str), len);
+  const size_t mask = fSlots.size() - 1;
+
+  for (size_t i = hash & mask;; i = (i + 1) & mask)
+  {
+    const Entry& e = fSlots[i];
+
+    if (!e.fStr)
+      return false;
+
+    if (e.fHash == hash && e.fLen == len && memcmp(e.fStr, str, len) == 0)
+    {
+      token = e.fToken;
+      return true;
+    }
+  }
+}
+
+/*******************************************************************************
+ * Description:
+ * Add a string that is not cached yet.  Returns false, leaving the cache as
+ * it was, if the string and the table would exceed the budget.
+ ******************************************************************************/
+bool DctnryStringCache::insert(const unsigned char* str, uint32_t len, const Token& token)
+{
+  if ((fCount + 1) * 2 > fSlots.size() && !grow())
+    return false;
+
+  const unsigned char* copy = copyToArena(str, len);
+
+  if (!copy)
+    return false;
+
+  const uint32_t hash = utils::Hasher()(reinterpret_cast<const char*>(str), len);
+  const size_t mask = fSlots.size() - 1;
+  size_t i = hash & mask;
+
+  while (fSlots[i].fStr)
+    i = (i + 1) & mask;
+
+  fSlots[i].fStr = copy;
+  fSlots[i].fLen = len;
+  fSlots[i].fHash = hash;
+  fSlots[i].fToken = token;
+  fCount++;
+
+  return true;
+}
+
+/*******************************************************************************
+ * Description:
+ * Drop every string and release the memory.
+ ******************************************************************************/
+void DctnryStringCache::clear()
+{
+  std::vector<Entry>().swap(fSlots);
+  std::vector<std::unique_ptr<unsigned char[]>>().swap(fArena);
+  fCount = 0;
+  fArenaBytes = 0;
+  fArenaPos = nullptr;
+  fArenaFree = 0;
+}
+
+/*******************************************************************************
+ * Description:
+ * Change the budget of the cache; the cached strings are dropped.
+ ******************************************************************************/
+void DctnryStringCache::setMaxBytes(size_t maxBytes)
+{
+  clear();
+  fMaxBytes = maxBytes;
+}
+
+/*******************************************************************************
+ * Description:
+ * Copy a string into the arena, allocating a new chunk if the last one is
+ * full.  Returns nullptr if the new chunk would exceed the budget.
+ ******************************************************************************/
+const unsigned char* DctnryStringCache::copyToArena(const unsigned char* str, uint32_t len)
+{
+  if (len == 0)
+    return EMPTY_STRING;
+
+  if (len > fArenaFree)
+  {
+    const size_t chunkSize = std::max<size_t>(ARENA_CHUNK_SIZE, len);
+
+    if (bytesUsed() + chunkSize > fMaxBytes)
+      return nullptr;
+
+    fArena.emplace_back(new unsigned char[chunkSize]);
+    fArenaBytes += chunkSize;
+    fArenaPos = fArena.back().get();
+    fArenaFree = chunkSize;
+  }
+
+  unsigned char* copy = fArenaPos;
+  memcpy(copy, str, len);
+  fArenaPos += len;
+  fArenaFree -= len;
+
+  return copy;
+}
+
+/*******************************************************************************
+ * Description:
+ * Double the number of slots and rehash, if that fits in the budget.
+ ******************************************************************************/
+bool DctnryStringCache::grow()
+{
+  const size_t newSize = std::max(MIN_SLOTS, fSlots.size() * 2);
+
+  if (fArenaBytes + newSize * sizeof(Entry) > fMaxBytes)
+    return false;
+
+  std::vector<Entry> newSlots(newSize, Entry{nullptr, 0, 0, Token()});
+  const size_t mask = newSize - 1;
+
+  for (const Entry& e : fSlots)
+  {
+    if (!e.fStr)
+      continue;
+
+    size_t i = e.fHash & mask;
+
+    while (newSlots[i].fStr)
+      i = (i + 1) & mask;
+
+    newSlots[i] = e;
+  }
+
+  fSlots.swap(newSlots);
+  return true;
+}
+
+}  // namespace WriteEngine
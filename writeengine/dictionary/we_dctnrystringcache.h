@@ -0,0 +1,124 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file we_dctnrystringcache.h
+ *  Defines the DctnryStringCache class used by Dctnry to find the token
+ *  of a string that is already in the dictionary store file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "we_typeext.h"
+
+#define EXPORT
+
+/** Namespace WriteEngine */
+namespace WriteEngine
+{
+/**
+ * @brief Memory bounded string to token cache of a dictionary store file.
+ *
+ * An open addressing hash table of (string, token) entries, probed linearly
+ * and keyed by the MurmurHash3 hash of the string. The strings are copied
+ * into an arena of large chunks, so an insert is one copy and no per-string
+ * allocation. Everything the cache allocates, table and arena, counts
+ * against the byte budget given to the constructor; insert() refuses a
+ * string that doesn't fit and the owner decides what to drop.
+ */
+class DctnryStringCache
+{
+ public:
+  /**
+   * @brief Constructor
+   * @param maxBytes - budget for the table and the copied strings
+   */
+  EXPORT explicit DctnryStringCache(size_t maxBytes = DEFAULT_MAX_BYTES);
+
+  DctnryStringCache(const DctnryStringCache&) = delete;
+  DctnryStringCache& operator=(const DctnryStringCache&) = delete;
+
+  /**
+   * @brief Looks up a string, sets token if it is cached
+   */
+  EXPORT bool find(const unsigned char* str, uint32_t len, Token& token) const;
+
+  /**
+   * @brief Adds a string that isn't cached yet
+   * @return false if the string doesn't fit in the budget
+   */
+  EXPORT bool insert(const unsigned char* str, uint32_t len, const Token& token);
+
+  /**
+   * @brief Drops every string and releases the memory
+   */
+  EXPORT void clear();
+
+  /**
+   * @brief Changes the budget, clears the cache
+   */
+  EXPORT void setMaxBytes(size_t maxBytes);
+
+  size_t size() const
+  {
+    return fCount;
+  }
+  size_t bytesUsed() const
+  {
+    return fSlots.size() * sizeof(Entry) + fArenaBytes;
+  }
+  size_t maxBytes() const
+  {
+    return fMaxBytes;
+  }
+
+  static constexpr size_t DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+
+ private:
+  struct Entry
+  {
+    const unsigned char* fStr;  // nullptr for an empty slot
+    uint32_t fLen;
+    uint32_t fHash;
+    Token fToken;
+  };
+
+  static constexpr size_t MIN_SLOTS = 1024;
+  static constexpr size_t ARENA_CHUNK_SIZE = 256 * 1024;
+
+  // copies len bytes into the arena, nullptr if that breaks the budget
+  const unsigned char* copyToArena(const unsigned char* str, uint32_t len);
+  bool grow();
+
+  std::vector<Entry> fSlots;  // power of 2 slots, at most half full
+  size_t fCount;
+
+  std::vector<std::unique_ptr<unsigned char[]>> fArena;
+  size_t fArenaBytes;       // bytes allocated for the arena chunks
+  unsigned char* fArenaPos;  // first unused byte of the last chunk
+  size_t fArenaFree;         // unused bytes at the end of the last chunk
+
+  size_t fMaxBytes;
+};
+
+}  // namespace WriteEngine
+
+#undef EXPORT
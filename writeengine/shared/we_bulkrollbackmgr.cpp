@@ -45,6 +45,7 @@
 #include "we_rbmetawriter.h"
 #include "messageids.h"
 #include "cacheutils.h"
+#include "extentbloom.h"
 
 using namespace execplan;
 
@@ -132,6 +133,9 @@ int BulkRollbackMgr::rollback(bool keepMetaFile)
     // Loop through DBRoots for this PM
     for (unsigned m = 0; m < dbRoots.size(); m++)
     {
+      // The loaded extents' bloom filters were never published
+      BRM::ExtentBloomStore::discardPending(fTableOID, dbRoots[m]);
+
       std::istringstream metaDataStream;
       bool bPerformRollback = openMetaDataFile(dbRoots[m], metaDataStream);
 
@@ -1842,6 +1846,10 @@ void BulkRollbackMgr::deleteMetaFile(OID tableOID)
     std::string metaFileName = bulkRollbackPath;
     metaFileName += oss.str();
 
+    // The load is done (committed or rolled back) and its BRM updates are
+    // in; publish any bloom filters it built for its extents.
+    BRM::ExtentBloomStore::commitPending(tableOID, dbRoots[m]);
+
     // Delete the main bulk rollback file
     IDBPolicy::remove(metaFileName.c_str());
 
@@ -776,8 +776,13 @@ int ChunkManager::fetchChunkFromFile(IDBDataFile* pFile, int64_t id, ChunkData*&
       return ERR_COMP_WRONG_COMP_TYPE;
     }
 
+    size_t dictLen = 0;
+    const char* dict =
+        compress::CompressInterface::getDictionary(fileData->fFileHeader.fControlData, dictLen);
+
     if (fCompressor->uncompressBlock((char*)fBufCompressed, chunkSize,
-                                     (unsigned char*)chunkData->fBufUnCompressed, dataLen) != 0)
+                                     (unsigned char*)chunkData->fBufUnCompressed, dataLen, dict,
+                                     dictLen) != 0)
     {
       if (fIsFix)
       {
@@ -915,8 +920,12 @@ int ChunkManager::writeChunkToFile(CompFileData* fileData, ChunkData* chunkData)
       return ERR_COMP_WRONG_COMP_TYPE;
     }
 
+    size_t dictLen = 0;
+    const char* dict =
+        compress::CompressInterface::getDictionary(fileData->fFileHeader.fControlData, dictLen);
+
     if (fCompressor->compressBlock((char*)chunkData->fBufUnCompressed, chunkData->fLenUnCompressed,
-                                   (unsigned char*)fBufCompressed, fLenCompressed) != 0)
+                                   (unsigned char*)fBufCompressed, fLenCompressed, dict, dictLen) != 0)
     {
       logMessage(ERR_COMP_COMPRESS, logging::LOG_TYPE_ERROR, __LINE__);
       return ERR_COMP_COMPRESS;
@@ -1864,8 +1873,13 @@ int ChunkManager::reallocateChunks(CompFileData* fileData)
         return ERR_COMP_WRONG_COMP_TYPE;
       }
 
+      size_t dictLen = 0;
+      const char* dict =
+          compress::CompressInterface::getDictionary(fileData->fFileHeader.fControlData, dictLen);
+
       if ((rc = fCompressor->compressBlock((char*)chunkData->fBufUnCompressed, chunkData->fLenUnCompressed,
-                                           (unsigned char*)fBufCompressed, fLenCompressed)) != 0)
+                                           (unsigned char*)fBufCompressed, fLenCompressed, dict, dictLen)) !=
+          0)
       {
         ostringstream oss;
         oss << "Compress data failed @line:" << __LINE__ << "with retCode:" << rc
@@ -2247,6 +2261,9 @@ int ChunkManager::verifyChunksAfterRealloc(CompFileData* fileData)
     return ERR_COMP_WRONG_COMP_TYPE;
   }
 
+  size_t dictLen = 0;
+  const char* dict = compress::CompressInterface::getDictionary(fileData->fFileHeader.fControlData, dictLen);
+
   for (int i = 0; i < numOfChunks && rc == NO_ERROR; i++)
   {
     unsigned int chunkSize = ptrs[i].second;
@@ -2271,7 +2288,7 @@ int ChunkManager::verifyChunksAfterRealloc(CompFileData* fileData)
     size_t dataLen = sizeof(chunkData.fBufUnCompressed);
 
     if (fCompressor->uncompressBlock((char*)fBufCompressed, chunkSize,
-                                     (unsigned char*)chunkData.fBufUnCompressed, dataLen) != 0)
+                                     (unsigned char*)chunkData.fBufUnCompressed, dataLen, dict, dictLen) != 0)
     {
       ostringstream oss;
       oss << "Failed to uncompress chunk new " << fileData->fFileName << "@" << __LINE__;
@@ -2619,8 +2636,13 @@ int ChunkManager::checkFixLastDictChunk(const FID& fid, uint16_t root, uint32_t
       return ERR_COMP_WRONG_COMP_TYPE;
     }
 
+    size_t dictLen = 0;
+    const char* dict =
+        compress::CompressInterface::getDictionary(mit->second->fFileHeader.fControlData, dictLen);
+
     if (fCompressor->uncompressBlock((char*)fBufCompressed, chunkSize,
-                                     (unsigned char*)chunkData->fBufUnCompressed, dataLen) != 0)
+                                     (unsigned char*)chunkData->fBufUnCompressed, dataLen, dict,
+                                     dictLen) != 0)
     {
       mit->second->fChunkList.push_back(chunkData);
       fActiveChunks.push_back(make_pair(mit->second->fFileID, chunkData));
@@ -37,6 +37,8 @@ using namespace config;
 #include "IDBPolicy.h"
 using namespace idbdatafile;
 
+#include "idbcompress.h"
+
 #include <boost/algorithm/string.hpp>
 
 namespace WriteEngine
@@ -47,6 +49,8 @@ const unsigned DEFAULT_EXTENTS_PER_SEGMENT_FILE = 2;
 const int DEFAULT_BULK_PROCESS_PRIORITY = -1;
 const unsigned DEFAULT_MAX_FILESYSTEM_DISK_USAGE = 98;  // allow 98% full
 const unsigned DEFAULT_COMPRESSED_PADDING_BLKS = 1;
+const unsigned DEFAULT_DCTNRY_STRING_CACHE_MB = 16;
+const unsigned DEFAULT_EXTENT_BLOOM_BITS = 262144;
 const int DEFAULT_LOCAL_MODULE_ID = 1;
 const bool DEFAULT_PARENT_OAM = true;
 const char* DEFAULT_LOCAL_MODULE_TYPE = "pm";
@@ -71,6 +75,9 @@ string Config::m_BulkRollbackDir;
 bool Config::m_FastDelete;
 unsigned Config::m_MaxFileSystemDiskUsage = DEFAULT_MAX_FILESYSTEM_DISK_USAGE;
 unsigned Config::m_NumCompressedPadBlks = DEFAULT_COMPRESSED_PADDING_BLKS;
+bool Config::m_ColumnEncoding = false;
+unsigned Config::m_DctnryStringCacheMB = DEFAULT_DCTNRY_STRING_CACHE_MB;
+unsigned Config::m_ExtentBloomBits = DEFAULT_EXTENT_BLOOM_BITS;
 bool Config::m_ParentOAMModuleFlag = DEFAULT_PARENT_OAM;
 string Config::m_LocalModuleType;
 int Config::m_LocalModuleID = DEFAULT_LOCAL_MODULE_ID;
@@ -217,6 +224,41 @@ void Config::checkReload()
   if (ncpb.length() != 0)
     m_NumCompressedPadBlks = cf->uFromText(ncpb);
 
+  //--------------------------------------------------------------------------
+  // ZSTD compression level
+  //--------------------------------------------------------------------------
+  string zstdLevel = cf->getConfig("WriteEngine", "ZSTDCompressionLevel");
+
+  if (zstdLevel.length() != 0)
+    compress::CompressInterfaceZSTD::setCompressionLevel(cf->fromText(zstdLevel));
+  else
+    compress::CompressInterfaceZSTD::setCompressionLevel(
+        compress::CompressInterfaceZSTD::DEFAULT_COMPRESSION_LEVEL);
+
+  //--------------------------------------------------------------------------
+  // Lightweight encoding of integer chunks, older releases can't read them
+  //--------------------------------------------------------------------------
+  const std::string columnEncoding = cf->getConfig("WriteEngine", "ColumnEncoding");
+  m_ColumnEncoding = (columnEncoding == "y" || columnEncoding == "Y");
+
+  //--------------------------------------------------------------------------
+  // Memory for the string cache of each open dictionary store file
+  //--------------------------------------------------------------------------
+  m_DctnryStringCacheMB = DEFAULT_DCTNRY_STRING_CACHE_MB;
+  string dscs = cf->getConfig("WriteEngine", "DictionaryStringCacheMB");
+
+  if (dscs.length() != 0)
+    m_DctnryStringCacheMB = cf->uFromText(dscs);
+
+  //--------------------------------------------------------------------------
+  // Largest per extent bloom filter cpimport builds, 0 builds none
+  //--------------------------------------------------------------------------
+  m_ExtentBloomBits = DEFAULT_EXTENT_BLOOM_BITS;
+  string ebb = cf->getConfig("WriteEngine", "ExtentBloomBits");
+
+  if (ebb.length() != 0)
+    m_ExtentBloomBits = cf->uFromText(ebb);
+
   IDBPolicy::configIDBPolicy();
 
   //--------------------------------------------------------------------------
@@ -570,6 +612,49 @@ unsigned Config::getNumCompressedPadBlks()
   return m_NumCompressedPadBlks;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *    Get the option to encode integer column chunks before compressing them.
+ * PARAMETERS:
+ *    none
+ ******************************************************************************/
+bool Config::getColumnEncoding()
+{
+  boost::mutex::scoped_lock lk(fCacheLock);
+  checkReload();
+
+  return m_ColumnEncoding;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *    Get the size in bytes of the string cache of a dictionary store file.
+ * PARAMETERS:
+ *    none
+ ******************************************************************************/
+size_t Config::getDctnryStringCacheSize()
+{
+  boost::mutex::scoped_lock lk(fCacheLock);
+  checkReload();
+
+  return (size_t)m_DctnryStringCacheMB * 1024 * 1024;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *    Get the size in bits of the bloom filter cpimport builds for each extent
+ *    it loads; 0 if it builds none.
+ * PARAMETERS:
+ *    none
+ ******************************************************************************/
+unsigned Config::getExtentBloomBits()
+{
+  boost::mutex::scoped_lock lk(fCacheLock);
+  checkReload();
+
+  return m_ExtentBloomBits;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *    Get Parent OAM Module flag; are we running on active parent OAM node.
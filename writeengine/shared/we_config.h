@@ -136,6 +136,22 @@ class Config
    */
   EXPORT static unsigned getNumCompressedPadBlks();
 
+  /**
+   * @brief Does cpimport store integer column chunks with a lightweight
+   * encoding (FOR, delta or RLE) before compressing them.
+   */
+  EXPORT static bool getColumnEncoding();
+
+  /**
+   * @brief Bytes of memory for the string cache of a dictionary store file
+   */
+  EXPORT static size_t getDctnryStringCacheSize();
+
+  /**
+   * @brief Bits of the bloom filter built for each loaded extent (0 for none)
+   */
+  EXPORT static unsigned getExtentBloomBits();
+
   /**
    * @brief Parent OAM Module flag (is this the parent OAM node, ex: pm1)
    */
@@ -194,6 +210,9 @@ class Config
   static bool m_FastDelete;                   // fast delete option
   static unsigned m_MaxFileSystemDiskUsage;   // max file system % disk usage
   static unsigned m_NumCompressedPadBlks;     // num blks to pad comp chunks
+  static bool m_ColumnEncoding;               // encode integer chunks
+  static unsigned m_DctnryStringCacheMB;      // dctnry string cache size
+  static unsigned m_ExtentBloomBits;          // max bits of extent bloom
   static bool m_ParentOAMModuleFlag;          // are we running on parent PM
   static std::string m_LocalModuleType;       // local node type (ex: "pm")
   static int m_LocalModuleID;                 // local node id   (ex: 1   )
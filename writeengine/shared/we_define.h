@@ -57,7 +57,6 @@ const int HDR_UNIT_SIZE = 2;                // hdr unit size
 const int NEXT_PTR_BYTES = 8;               // const ptr size
 const int MAX_OP_COUNT = 1024;              // op max size
 const int DCTNRY_HEADER_SIZE = 14;          // header total size
-const int MAX_STRING_CACHE_SIZE = 1000;
 // End of Dictionary related constants
 
 const int COLPOSPAIR_NULL_TOKEN_OFFSET = -1;  // offset value denoting a null token
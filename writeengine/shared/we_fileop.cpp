@@ -1513,6 +1513,10 @@ int FileOp::expandAbbrevColumnChunk(IDBDataFile* pFile, const uint8_t* emptyVal,
   std::unique_ptr<CompressInterface> compressor(
       compress::getCompressInterfaceByType(realCompressionType, userPadBytes));
 
+  // The chunk stays compressed with the file's dictionary, if it has one
+  size_t dictLen = 0;
+  const char* dict = (hdrs ? compress::CompressInterface::getDictionary(hdrs, dictLen) : nullptr);
+
   const int IN_BUF_LEN = CompressInterface::UNCOMPRESSED_INBUF_LEN;
   const int OUT_BUF_LEN = compressor->maxCompressedSize(IN_BUF_LEN) + userPadBytes +
                           compress::CompressInterface::COMPRESSED_CHUNK_INCREMENT_SIZE;
@@ -1531,7 +1535,7 @@ int FileOp::expandAbbrevColumnChunk(IDBDataFile* pFile, const uint8_t* emptyVal,
   // Uncompress an "abbreviated" chunk into our 4MB buffer
   size_t outputLen = IN_BUF_LEN;
   int rc = compressor->uncompressBlock(compressedInBuf, chunkInPtr.second, (unsigned char*)toBeCompressedBuf,
-                                       outputLen);
+                                       outputLen, dict, dictLen);
 
   if (rc != 0)
   {
@@ -1548,7 +1552,7 @@ int FileOp::expandAbbrevColumnChunk(IDBDataFile* pFile, const uint8_t* emptyVal,
   // Compress the data we just read, as a "full" 4MB chunk
   outputLen = OUT_BUF_LEN;
   rc = compressor->compressBlock(reinterpret_cast<char*>(toBeCompressedBuf), IN_BUF_LEN, compressedOutBuf,
-                                 outputLen);
+                                 outputLen, dict, dictLen);
 
   if (rc != 0)
   {
@@ -541,7 +541,8 @@ void WECmdArgs::usage()
        << "\t-n\tNullOption (0-treat the string NULL as data (default);\n"
        << "\t\t\t1-treat the string NULL as a NULL value)\n"
        << "\t-p\tPath for XML job description file.\n"
-       << "\t-r\tNumber of readers.\n"
+       << "\t-r\tNumber of readers; readers beyond one per table tokenize\n"
+       << "\t\teach read buffer of a table in parallel.\n"
        << "\t-s\t'c' is the delimiter between column values.\n"
        << "\t-B\tI/O library read buffer size (in bytes)\n"
        << "\t-w\tNumber of parsers.\n"
@@ -98,6 +98,9 @@ WriteEngineWrapper::WriteEngineWrapper() : m_opType(NOOP)
 
   m_colOp[COMPRESSED_OP_2] = new ColumnOpCompress1(/*comressionType=*/3);
   m_dctnry[COMPRESSED_OP_2] = new DctnryCompress1(/*compressionType=*/3);
+
+  m_colOp[COMPRESSED_OP_3] = new ColumnOpCompress1(/*compressionType=*/4);
+  m_dctnry[COMPRESSED_OP_3] = new DctnryCompress1(/*compressionType=*/4);
 }
 
 WriteEngineWrapper::WriteEngineWrapper(const WriteEngineWrapper& rhs) : m_opType(rhs.m_opType)
@@ -110,6 +113,9 @@ WriteEngineWrapper::WriteEngineWrapper(const WriteEngineWrapper& rhs) : m_opType
 
   m_colOp[COMPRESSED_OP_2] = new ColumnOpCompress1(/*compressionType=*/3);
   m_dctnry[COMPRESSED_OP_2] = new DctnryCompress1(/*compressionType=*/3);
+
+  m_colOp[COMPRESSED_OP_3] = new ColumnOpCompress1(/*compressionType=*/4);
+  m_dctnry[COMPRESSED_OP_3] = new DctnryCompress1(/*compressionType=*/4);
 }
 
 /**@brief WriteEngineWrapper Constructor
@@ -124,6 +130,9 @@ WriteEngineWrapper::~WriteEngineWrapper()
 
   delete m_colOp[COMPRESSED_OP_2];
   delete m_dctnry[COMPRESSED_OP_2];
+
+  delete m_colOp[COMPRESSED_OP_3];
+  delete m_dctnry[COMPRESSED_OP_3];
 }
 
 /**@brief Perform upfront initialization